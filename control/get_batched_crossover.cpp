@@ -10,6 +10,7 @@
 */
 
 #include "magma_internal.h"
+#include "magma_tune.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,11 @@ extern "C" {
 *******************************************************************************/
 void magma_get_zpotrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_t *recnb)
 {
+    if ( magma_tune_get( "potrf_batched_nb", 'z', n, n, nb ) &&
+         magma_tune_get( "potrf_batched_recnb", 'z', n, n, recnb )) {
+        return;
+    }
+
     if (n <= ZPOTRF_SWITCH)
     {
         *nb    = ZPOTRF_SWITCH;
@@ -51,6 +57,11 @@ void magma_get_zpotrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_
 /// @see magma_get_zpotrf_batched_nbparam
 void magma_get_cpotrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_t *recnb)
 {
+    if ( magma_tune_get( "potrf_batched_nb", 'c', n, n, nb ) &&
+         magma_tune_get( "potrf_batched_recnb", 'c', n, n, recnb )) {
+        return;
+    }
+
     if (n <= CPOTRF_SWITCH)
     {
         *nb    = CPOTRF_SWITCH;
@@ -73,6 +84,11 @@ void magma_get_cpotrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_
 /// @see magma_get_zpotrf_batched_nbparam
 void magma_get_dpotrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_t *recnb)
 {
+    if ( magma_tune_get( "potrf_batched_nb", 'd', n, n, nb ) &&
+         magma_tune_get( "potrf_batched_recnb", 'd', n, n, recnb )) {
+        return;
+    }
+
     if (n <= DPOTRF_SWITCH)
     {
         *nb    = DPOTRF_SWITCH;
@@ -94,6 +110,11 @@ void magma_get_dpotrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_
 /// @see magma_get_zpotrf_batched_nbparam
 void magma_get_spotrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_t *recnb)
 {
+    if ( magma_tune_get( "potrf_batched_nb", 's', n, n, nb ) &&
+         magma_tune_get( "potrf_batched_recnb", 's', n, n, recnb )) {
+        return;
+    }
+
     if (n <= SPOTRF_SWITCH)
     {
         *nb    = SPOTRF_SWITCH;
@@ -118,6 +139,11 @@ void magma_get_spotrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_
 *******************************************************************************/
 void magma_get_zgetrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_t *recnb)
 {
+    if ( magma_tune_get( "getrf_batched_nb", 'z', n, n, nb ) &&
+         magma_tune_get( "getrf_batched_recnb", 'z', n, n, recnb )) {
+        return;
+    }
+
     *nb    = 64;
     *recnb = 32;
     return;
@@ -126,6 +152,11 @@ void magma_get_zgetrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_
 /// @see magma_get_zgetrf_batched_nbparam
 void magma_get_cgetrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_t *recnb)
 {
+    if ( magma_tune_get( "getrf_batched_nb", 'c', n, n, nb ) &&
+         magma_tune_get( "getrf_batched_recnb", 'c', n, n, recnb )) {
+        return;
+    }
+
     *nb    = 128;
     *recnb =  32;
     return;
@@ -134,6 +165,11 @@ void magma_get_cgetrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_
 /// @see magma_get_zgetrf_batched_nbparam
 void magma_get_dgetrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_t *recnb)
 {
+    if ( magma_tune_get( "getrf_batched_nb", 'd', n, n, nb ) &&
+         magma_tune_get( "getrf_batched_recnb", 'd', n, n, recnb )) {
+        return;
+    }
+
     *nb    = 128;
     *recnb =  32;
     return;
@@ -142,6 +178,11 @@ void magma_get_dgetrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_
 /// @see magma_get_zgetrf_batched_nbparam
 void magma_get_sgetrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_t *recnb)
 {
+    if ( magma_tune_get( "getrf_batched_nb", 's', n, n, nb ) &&
+         magma_tune_get( "getrf_batched_recnb", 's', n, n, recnb )) {
+        return;
+    }
+
     *nb    = 128;
     *recnb =  32;
     return;
@@ -154,24 +195,32 @@ void magma_get_sgetrf_batched_nbparam(magma_int_t n, magma_int_t *nb, magma_int_
 // TODO: get_geqrf_nb takes (m,n); this should do likewise
 magma_int_t magma_get_zgeqrf_batched_nb(magma_int_t m)
 {
+    MAGMA_TUNE_RETURN( "geqrf_batched_nb", 'z', m, m );
+
     return 32;
 }
 
 /// @see magma_get_zgeqrf_batched_nb
 magma_int_t magma_get_cgeqrf_batched_nb(magma_int_t m)
 {
+    MAGMA_TUNE_RETURN( "geqrf_batched_nb", 'c', m, m );
+
     return 32;
 }
 
 /// @see magma_get_zgeqrf_batched_nb
 magma_int_t magma_get_dgeqrf_batched_nb(magma_int_t m)
 {
+    MAGMA_TUNE_RETURN( "geqrf_batched_nb", 'd', m, m );
+
     return 32;
 }
 
 /// @see magma_get_zgeqrf_batched_nb
 magma_int_t magma_get_sgeqrf_batched_nb(magma_int_t m)
 {
+    MAGMA_TUNE_RETURN( "geqrf_batched_nb", 's', m, m );
+
     return 32;
 }
 
@@ -181,6 +230,8 @@ magma_int_t magma_get_sgeqrf_batched_nb(magma_int_t m)
 *******************************************************************************/
 magma_int_t magma_get_zpotrf_batched_crossover()
 {
+    MAGMA_TUNE_RETURN( "potrf_batched_crossover", 'z', -1, -1 );
+
     magma_int_t arch = magma_getdevice_arch();
     if(arch >= 700){
         return 352;
@@ -196,6 +247,8 @@ magma_int_t magma_get_zpotrf_batched_crossover()
 /// @see magma_get_zpotrf_batched_crossover
 magma_int_t magma_get_cpotrf_batched_crossover()
 {
+    MAGMA_TUNE_RETURN( "potrf_batched_crossover", 'c', -1, -1 );
+
     magma_int_t arch = magma_getdevice_arch();
     if(arch >= 700){
         return 576;
@@ -211,6 +264,8 @@ magma_int_t magma_get_cpotrf_batched_crossover()
 /// @see magma_get_zpotrf_batched_crossover
 magma_int_t magma_get_dpotrf_batched_crossover()
 {
+    MAGMA_TUNE_RETURN( "potrf_batched_crossover", 'd', -1, -1 );
+
     magma_int_t arch = magma_getdevice_arch();
     if(arch >= 700){
         return 640;
@@ -226,6 +281,8 @@ magma_int_t magma_get_dpotrf_batched_crossover()
 /// @see magma_get_zpotrf_batched_crossover
 magma_int_t magma_get_spotrf_batched_crossover()
 {
+    MAGMA_TUNE_RETURN( "potrf_batched_crossover", 's', -1, -1 );
+
     magma_int_t arch = magma_getdevice_arch();
     if(arch >= 700){
         return 608;
@@ -242,24 +299,32 @@ magma_int_t magma_get_spotrf_batched_crossover()
 *******************************************************************************/
 magma_int_t magma_get_zpotrf_vbatched_crossover()
 {
+    MAGMA_TUNE_RETURN( "potrf_vbatched_crossover", 'z', -1, -1 );
+
     return ZPOTRF_VBATCHED_SWITCH;
 }
 
 /// @see magma_get_zpotrf_vbatched_crossover
 magma_int_t magma_get_cpotrf_vbatched_crossover()
 {
+    MAGMA_TUNE_RETURN( "potrf_vbatched_crossover", 'c', -1, -1 );
+
     return CPOTRF_VBATCHED_SWITCH;
 }
 
 /// @see magma_get_zpotrf_vbatched_crossover
 magma_int_t magma_get_dpotrf_vbatched_crossover()
 {
+    MAGMA_TUNE_RETURN( "potrf_vbatched_crossover", 'd', -1, -1 );
+
     return DPOTRF_VBATCHED_SWITCH;
 }
 
 /// @see magma_get_zpotrf_vbatched_crossover
 magma_int_t magma_get_spotrf_vbatched_crossover()
 {
+    MAGMA_TUNE_RETURN( "potrf_vbatched_crossover", 's', -1, -1 );
+
     return SPOTRF_VBATCHED_SWITCH;
 }
 
@@ -269,6 +334,8 @@ magma_int_t magma_get_spotrf_vbatched_crossover()
 *******************************************************************************/
 magma_int_t magma_get_zgetri_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "getri_batched_ntcol", 'z', m, n );
+
     magma_int_t ntcol = 1;
     
     // TODO: conduct tuning experiment for ntcol in z precision
@@ -284,6 +351,8 @@ magma_int_t magma_get_zgetri_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgetri_batched_ntcol
 magma_int_t magma_get_cgetri_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "getri_batched_ntcol", 'c', m, n );
+
     magma_int_t ntcol = 1;
     
     // TODO: conduct tuning experiment for ntcol in z precision
@@ -299,6 +368,7 @@ magma_int_t magma_get_cgetri_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgetri_batched_ntcol
 magma_int_t magma_get_dgetri_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "getri_batched_ntcol", 'd', m, n );
     
     // TODO: conduct tuning experiment for ntcol on Kepler
     magma_int_t arch = magma_getdevice_arch();
@@ -346,6 +416,8 @@ magma_int_t magma_get_dgetri_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgetri_batched_ntcol
 magma_int_t magma_get_sgetri_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "getri_batched_ntcol", 's', m, n );
+
     // TODO: conduct tuning experiment for ntcol on Kepler
     magma_int_t arch = magma_getdevice_arch();
     magma_int_t ntcol = 1;
@@ -394,6 +466,10 @@ magma_int_t magma_get_sgetri_batched_ntcol(magma_int_t m, magma_int_t n)
 *******************************************************************************/
 magma_int_t magma_get_ztrsm_batched_stop_nb(magma_side_t side, magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( (side == MagmaLeft ? "trsm_batched_stop_nb_left"
+                                          : "trsm_batched_stop_nb_right"),
+                       'z', m, n );
+
     if(side == MagmaLeft){
          if     (m <= 2) return 2; 
          else if(m <= 4) return 4;
@@ -411,6 +487,10 @@ magma_int_t magma_get_ztrsm_batched_stop_nb(magma_side_t side, magma_int_t m, ma
 /// @see magma_get_ztrsm_batched_stop_nb
 magma_int_t magma_get_ctrsm_batched_stop_nb(magma_side_t side, magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( (side == MagmaLeft ? "trsm_batched_stop_nb_left"
+                                          : "trsm_batched_stop_nb_right"),
+                       'c', m, n );
+
     if(side == MagmaLeft){
         if(m <= 8) return 8;
         else return 16;
@@ -423,6 +503,10 @@ magma_int_t magma_get_ctrsm_batched_stop_nb(magma_side_t side, magma_int_t m, ma
 /// @see magma_get_ztrsm_batched_stop_nb
 magma_int_t magma_get_dtrsm_batched_stop_nb(magma_side_t side, magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( (side == MagmaLeft ? "trsm_batched_stop_nb_left"
+                                          : "trsm_batched_stop_nb_right"),
+                       'd', m, n );
+
     if(side == MagmaLeft){
         if     (m <= 2) return 8;
         else if(m <= 4) return 16;
@@ -436,6 +520,10 @@ magma_int_t magma_get_dtrsm_batched_stop_nb(magma_side_t side, magma_int_t m, ma
 /// @see magma_get_ztrsm_batched_stop_nb
 magma_int_t magma_get_strsm_batched_stop_nb(magma_side_t side, magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( (side == MagmaLeft ? "trsm_batched_stop_nb_left"
+                                          : "trsm_batched_stop_nb_right"),
+                       's', m, n );
+
     if(side == MagmaLeft){
         return 16;
     }else{    // side = MagmaRight
@@ -11,6 +11,7 @@
 */
 
 #include "magma_internal.h"
+#include "magma_tune.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,8 @@ extern "C" {
 /// @return nb for spotrf based on n
 magma_int_t magma_get_spotrf_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "potrf_nb", 's', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler
@@ -53,6 +56,8 @@ magma_int_t magma_get_spotrf_nb( magma_int_t n )
 /// @return nb for dpotrf based on n
 magma_int_t magma_get_dpotrf_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "potrf_nb", 'd', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler
@@ -73,6 +78,8 @@ magma_int_t magma_get_dpotrf_nb( magma_int_t n )
 /// @return nb for cpotrf based on n
 magma_int_t magma_get_cpotrf_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "potrf_nb", 'c', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler
@@ -91,6 +98,8 @@ magma_int_t magma_get_cpotrf_nb( magma_int_t n )
 /// @return nb for zpotrf based on n
 magma_int_t magma_get_zpotrf_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "potrf_nb", 'z', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler
@@ -111,24 +120,32 @@ magma_int_t magma_get_zpotrf_nb( magma_int_t n )
 /// @return nb for zpotrf_right based on n
 magma_int_t magma_get_zpotrf_right_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "potrf_right_nb", 'z', n, n );
+
     return 128;
 }
 
 /// @return nb for cpotrf_right based on n
 magma_int_t magma_get_cpotrf_right_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "potrf_right_nb", 'c', n, n );
+
     return 128;
 }
 
 /// @return nb for dpotrf_right based on n
 magma_int_t magma_get_dpotrf_right_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "potrf_right_nb", 'd', n, n );
+
     return 320;
 }
 
 /// @return nb for spotrf_right based on n
 magma_int_t magma_get_spotrf_right_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "potrf_right_nb", 's', n, n );
+
     return 128;
 }
 
@@ -137,24 +154,32 @@ magma_int_t magma_get_spotrf_right_nb( magma_int_t n )
 /// @return nb for sgeqp3 based on m, n
 magma_int_t magma_get_sgeqp3_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqp3_nb", 's', m, n );
+
     return 32;
 }
 
 /// @return nb for dgeqp3 based on m, n
 magma_int_t magma_get_dgeqp3_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqp3_nb", 'd', m, n );
+
     return 32;
 }
 
 /// @return nb for cgeqp3 based on m, n
 magma_int_t magma_get_cgeqp3_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqp3_nb", 'c', m, n );
+
     return 32;
 }
 
 /// @return nb for zgeqp3 based on m, n
 magma_int_t magma_get_zgeqp3_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqp3_nb", 'z', m, n );
+
     return 32;
 }
 
@@ -163,6 +188,8 @@ magma_int_t magma_get_zgeqp3_nb( magma_int_t m, magma_int_t n )
 /// @return nb for sgeqrf based on m, n
 magma_int_t magma_get_sgeqrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqrf_nb", 's', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -188,6 +215,8 @@ magma_int_t magma_get_sgeqrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for dgeqrf based on m, n
 magma_int_t magma_get_dgeqrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqrf_nb", 'd', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -206,6 +235,8 @@ magma_int_t magma_get_dgeqrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for cgeqrf based on m, n
 magma_int_t magma_get_cgeqrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqrf_nb", 'c', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -224,6 +255,8 @@ magma_int_t magma_get_cgeqrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for zgeqrf based on m, n
 magma_int_t magma_get_zgeqrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqrf_nb", 'z', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -248,6 +281,8 @@ magma_int_t magma_get_zgeqrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for sgeqlf based on m, n
 magma_int_t magma_get_sgeqlf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqlf_nb", 's', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -265,6 +300,8 @@ magma_int_t magma_get_sgeqlf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for dgeqlf based on m, n
 magma_int_t magma_get_dgeqlf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqlf_nb", 'd', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -282,6 +319,8 @@ magma_int_t magma_get_dgeqlf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for cgeqlf based on m, n
 magma_int_t magma_get_cgeqlf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqlf_nb", 'c', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     if      (minmn <  2048) nb = 32;
@@ -293,6 +332,8 @@ magma_int_t magma_get_cgeqlf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for zgeqlf based on m, n
 magma_int_t magma_get_zgeqlf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "geqlf_nb", 'z', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     if      (minmn <  1024) nb = 64;
@@ -305,12 +346,16 @@ magma_int_t magma_get_zgeqlf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for sgelqf based on m, n
 magma_int_t magma_get_sgelqf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gelqf_nb", 's', m, n );
+
     return magma_get_sgeqrf_nb( m, n );
 }
 
 /// @return nb for dgelqf based on m, n
 magma_int_t magma_get_dgelqf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gelqf_nb", 'd', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -328,6 +373,8 @@ magma_int_t magma_get_dgelqf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for cgelqf based on m, n
 magma_int_t magma_get_cgelqf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gelqf_nb", 'c', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     if      (minmn <  2048) nb = 32;
@@ -339,6 +386,8 @@ magma_int_t magma_get_cgelqf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for zgelqf based on m, n
 magma_int_t magma_get_zgelqf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gelqf_nb", 'z', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     if      (minmn <  1024) nb = 64;
@@ -563,6 +612,8 @@ magma_int_t magma_get_xgetrf_nb(
 //-------------------------------------------------------------------------------
 magma_int_t magma_get_hgetrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_nb", 'h', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     //magma_int_t arch = magma_getdevice_arch();
@@ -628,6 +679,8 @@ magma_int_t magma_get_hgetrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for sgetrf based on m, n
 magma_int_t magma_get_sgetrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_nb", 's', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -651,6 +704,8 @@ magma_int_t magma_get_sgetrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for dgetrf based on m, n
 magma_int_t magma_get_dgetrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_nb", 'd', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -674,6 +729,8 @@ magma_int_t magma_get_dgetrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for cgetrf based on m, n
 magma_int_t magma_get_cgetrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_nb", 'c', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -696,6 +753,8 @@ magma_int_t magma_get_cgetrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for zgetrf based on m, n
 magma_int_t magma_get_zgetrf_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_nb", 'z', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -719,6 +778,8 @@ magma_int_t magma_get_zgetrf_nb( magma_int_t m, magma_int_t n )
 /// @return nb for native sgetrf based on m, n
 magma_int_t magma_get_sgetrf_native_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_native_nb", 's', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -743,6 +804,8 @@ magma_int_t magma_get_sgetrf_native_nb( magma_int_t m, magma_int_t n )
 /// @return nb for native dgetrf based on m, n
 magma_int_t magma_get_dgetrf_native_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_native_nb", 'd', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -767,6 +830,8 @@ magma_int_t magma_get_dgetrf_native_nb( magma_int_t m, magma_int_t n )
 /// @return nb for native cgetrf based on m, n
 magma_int_t magma_get_cgetrf_native_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_native_nb", 'c', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -789,6 +854,8 @@ magma_int_t magma_get_cgetrf_native_nb( magma_int_t m, magma_int_t n )
 /// @return nb for native zgetrf based on m, n
 magma_int_t magma_get_zgetrf_native_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getrf_native_nb", 'z', m, n );
+
     magma_int_t nb;
     magma_int_t minmn = min( m, n );
     magma_int_t arch = magma_getdevice_arch();
@@ -814,6 +881,8 @@ magma_int_t magma_get_zgetrf_native_nb( magma_int_t m, magma_int_t n )
 /// @return nb for sgehrd based on n
 magma_int_t magma_get_sgehrd_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gehrd_nb", 's', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 200 ) {       // 2.x Fermi
@@ -830,6 +899,8 @@ magma_int_t magma_get_sgehrd_nb( magma_int_t n )
 /// @return nb for dgehrd based on n
 magma_int_t magma_get_dgehrd_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gehrd_nb", 'd', n, n );
+
     magma_int_t nb;
     if      (n <  2048) nb = 32;
     else                nb = 64;
@@ -839,6 +910,8 @@ magma_int_t magma_get_dgehrd_nb( magma_int_t n )
 /// @return nb for cgehrd based on n
 magma_int_t magma_get_cgehrd_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gehrd_nb", 'c', n, n );
+
     magma_int_t nb;
     if      (n <  1024) nb = 32;
     else                nb = 64;
@@ -848,6 +921,8 @@ magma_int_t magma_get_cgehrd_nb( magma_int_t n )
 /// @return nb for zgehrd based on n
 magma_int_t magma_get_zgehrd_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gehrd_nb", 'z', n, n );
+
     magma_int_t nb;
     if      (n <  2048) nb = 32;
     else                nb = 64;
@@ -861,24 +936,32 @@ magma_int_t magma_get_zgehrd_nb( magma_int_t n )
 /// @return nb for ssytrd based on n
 magma_int_t magma_get_ssytrd_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sytrd_nb", 's', n, n );
+
     return 64;
 }
 
 /// @return nb for dsytrd based on n
 magma_int_t magma_get_dsytrd_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sytrd_nb", 'd', n, n );
+
     return 64;
 }
 
 /// @return nb for chetrd based on n
 magma_int_t magma_get_chetrd_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hetrd_nb", 'c', n, n );
+
     return 64;
 }
 
 /// @return nb for zhetrd based on n
 magma_int_t magma_get_zhetrd_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hetrd_nb", 'z', n, n );
+
     return 64;
 }
 
@@ -887,24 +970,32 @@ magma_int_t magma_get_zhetrd_nb( magma_int_t n )
 /// @return nb for zhetrf based on n
 magma_int_t magma_get_zhetrf_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hetrf_nb", 'z', n, n );
+
     return 256;
 }
 
 /// @return nb for chetrf based on n
 magma_int_t magma_get_chetrf_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hetrf_nb", 'c', n, n );
+
     return 256;
 }
 
 /// @return nb for dsytrf based on n
 magma_int_t magma_get_dsytrf_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sytrf_nb", 'd', n, n );
+
     return 96;
 }
 
 /// @return nb for ssytrf based on n
 magma_int_t magma_get_ssytrf_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sytrf_nb", 's', n, n );
+
     return 256;
 }
 
@@ -913,24 +1004,32 @@ magma_int_t magma_get_ssytrf_nb( magma_int_t n )
 /// @return nb for zhetrf_aasen based on n
 magma_int_t magma_get_zhetrf_aasen_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hetrf_aasen_nb", 'z', n, n );
+
     return 256;
 }
 
 /// @return nb for chetrf_aasen based on n
 magma_int_t magma_get_chetrf_aasen_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hetrf_aasen_nb", 'c', n, n );
+
     return 256;
 }
 
 /// @return nb for dsytrf_aasen based on n
 magma_int_t magma_get_dsytrf_aasen_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sytrf_aasen_nb", 'd', n, n );
+
     return 256;
 }
 
 /// @return nb for ssytrf_aasen based on n
 magma_int_t magma_get_ssytrf_aasen_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sytrf_aasen_nb", 's', n, n );
+
     return 256;
 }
 
@@ -939,24 +1038,32 @@ magma_int_t magma_get_ssytrf_aasen_nb( magma_int_t n )
 /// @return nb for zhetrf_nopiv based on n
 magma_int_t magma_get_zhetrf_nopiv_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hetrf_nopiv_nb", 'z', n, n );
+
     return 320;
 }
 
 /// @return nb for chetrf_nopiv based on n
 magma_int_t magma_get_chetrf_nopiv_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hetrf_nopiv_nb", 'c', n, n );
+
     return 320;
 }
 
 /// @return nb for dsytrf_nopiv based on n
 magma_int_t magma_get_dsytrf_nopiv_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sytrf_nopiv_nb", 'd', n, n );
+
     return 320;
 }
 
 /// @return nb for ssytrf_nopiv based on n
 magma_int_t magma_get_ssytrf_nopiv_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sytrf_nopiv_nb", 's', n, n );
+
     return 320;
 }
 
@@ -965,24 +1072,32 @@ magma_int_t magma_get_ssytrf_nopiv_nb( magma_int_t n )
 /// @return nb for sgebrd based on m, n
 magma_int_t magma_get_sgebrd_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gebrd_nb", 's', m, n );
+
     return 32;
 }
 
 /// @return nb for dgebrd based on m, n
 magma_int_t magma_get_dgebrd_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gebrd_nb", 'd', m, n );
+
     return 32;
 }
 
 /// @return nb for cgebrd based on m, n
 magma_int_t magma_get_cgebrd_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gebrd_nb", 'c', m, n );
+
     return 32;
 }
 
 /// @return nb for zgebrd based on m, n
 magma_int_t magma_get_zgebrd_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gebrd_nb", 'z', m, n );
+
     return 32;
 }
 
@@ -991,6 +1106,8 @@ magma_int_t magma_get_zgebrd_nb( magma_int_t m, magma_int_t n )
 /// @return nb for ssygst based on n
 magma_int_t magma_get_ssygst_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sygst_nb", 's', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler
@@ -1010,6 +1127,8 @@ magma_int_t magma_get_ssygst_nb( magma_int_t n )
 /// @return nb for dsygst based on n
 magma_int_t magma_get_dsygst_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sygst_nb", 'd', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler
@@ -1028,6 +1147,8 @@ magma_int_t magma_get_dsygst_nb( magma_int_t n )
 /// @return nb for chegst based on n
 magma_int_t magma_get_chegst_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hegst_nb", 'c', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler
@@ -1046,6 +1167,8 @@ magma_int_t magma_get_chegst_nb( magma_int_t n )
 /// @return nb for zhegst based on n
 magma_int_t magma_get_zhegst_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hegst_nb", 'z', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler
@@ -1065,24 +1188,32 @@ magma_int_t magma_get_zhegst_nb( magma_int_t n )
 /// @return nb for sgetri based on n
 magma_int_t magma_get_sgetri_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getri_nb", 's', n, n );
+
     return 64;
 }
 
 /// @return nb for dgetri based on n
 magma_int_t magma_get_dgetri_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getri_nb", 'd', n, n );
+
     return 64;
 }
 
 /// @return nb for cgetri based on n
 magma_int_t magma_get_cgetri_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getri_nb", 'c', n, n );
+
     return 64;
 }
 
 /// @return nb for zgetri based on n
 magma_int_t magma_get_zgetri_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "getri_nb", 'z', n, n );
+
     return 64;
 }
 
@@ -1091,24 +1222,32 @@ magma_int_t magma_get_zgetri_nb( magma_int_t n )
 /// @return nb for sgesvd based on m, n
 magma_int_t magma_get_sgesvd_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gesvd_nb", 's', m, n );
+
     return magma_get_sgebrd_nb( m, n );
 }
 
 /// @return nb for dgesvd based on m, n
 magma_int_t magma_get_dgesvd_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gesvd_nb", 'd', m, n );
+
     return magma_get_dgebrd_nb( m, n );
 }
 
 /// @return nb for cgesvd based on m, n
 magma_int_t magma_get_cgesvd_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gesvd_nb", 'c', m, n );
+
     return magma_get_cgebrd_nb( m, n );
 }
 
 /// @return nb for zgesvd based on m, n
 magma_int_t magma_get_zgesvd_nb( magma_int_t m, magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "gesvd_nb", 'z', m, n );
+
     return magma_get_zgebrd_nb( m, n );
 }
 
@@ -1117,6 +1256,8 @@ magma_int_t magma_get_zgesvd_nb( magma_int_t m, magma_int_t n )
 /// @return nb for ssygst_m based on n
 magma_int_t magma_get_ssygst_m_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sygst_m_nb", 's', n, n );
+
     return 256; //to be updated
 
     /*
@@ -1140,6 +1281,8 @@ magma_int_t magma_get_ssygst_m_nb( magma_int_t n )
 /// @return nb for dsygst_m based on n
 magma_int_t magma_get_dsygst_m_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "sygst_m_nb", 'd', n, n );
+
     return 256; //to be updated
 
     /*
@@ -1162,6 +1305,8 @@ magma_int_t magma_get_dsygst_m_nb( magma_int_t n )
 /// @return nb for chegst_m based on n
 magma_int_t magma_get_chegst_m_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hegst_m_nb", 'c', n, n );
+
     return 256; //to be updated
 
     /*
@@ -1184,6 +1329,8 @@ magma_int_t magma_get_chegst_m_nb( magma_int_t n )
 /// @return nb for zhegst_m based on n
 magma_int_t magma_get_zhegst_m_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "hegst_m_nb", 'z', n, n );
+
     return 256; //to be updated
 
     /*
@@ -1210,6 +1357,8 @@ magma_int_t magma_get_zhegst_m_nb( magma_int_t n )
 /// @return gpu over cpu performance for 2 stage TRD
 magma_int_t magma_get_sbulge_gcperf( )
 {
+    MAGMA_TUNE_RETURN( "bulge_gcperf", 's', -1, -1 );
+
     magma_int_t perf;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1227,6 +1376,8 @@ magma_int_t magma_get_sbulge_gcperf( )
 /// @return gpu over cpu performance for 2 stage TRD
 magma_int_t magma_get_dbulge_gcperf( )
 {
+    MAGMA_TUNE_RETURN( "bulge_gcperf", 'd', -1, -1 );
+
     magma_int_t perf;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1244,6 +1395,8 @@ magma_int_t magma_get_dbulge_gcperf( )
 /// @return gpu over cpu performance for 2 stage TRD
 magma_int_t magma_get_cbulge_gcperf( )
 {
+    MAGMA_TUNE_RETURN( "bulge_gcperf", 'c', -1, -1 );
+
     magma_int_t perf;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1261,6 +1414,8 @@ magma_int_t magma_get_cbulge_gcperf( )
 /// @return gpu over cpu performance for 2 stage TRD
 magma_int_t magma_get_zbulge_gcperf( )
 {
+    MAGMA_TUNE_RETURN( "bulge_gcperf", 'z', -1, -1 );
+
     magma_int_t perf;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1280,6 +1435,8 @@ magma_int_t magma_get_zbulge_gcperf( )
 /// @return smlsiz for the divide and conquewr routine dlaex0 dstedx zstedx
 magma_int_t magma_get_smlsize_divideconquer()
 {
+    MAGMA_TUNE_RETURN( "smlsize_divideconquer", '*', -1, -1 );
+
     return 128;
 }
 
@@ -1289,6 +1446,8 @@ magma_int_t magma_get_smlsize_divideconquer()
 /// @return nb for 2 stage TRD
 magma_int_t magma_get_sbulge_nb( magma_int_t n, magma_int_t nbthreads  )
 {
+    MAGMA_TUNE_RETURN( "bulge_nb", 's', n, nbthreads );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1306,6 +1465,8 @@ magma_int_t magma_get_sbulge_nb( magma_int_t n, magma_int_t nbthreads  )
 /// @return nb for 2 stage TRD
 magma_int_t magma_get_dbulge_nb( magma_int_t n, magma_int_t nbthreads  )
 {
+    MAGMA_TUNE_RETURN( "bulge_nb", 'd', n, nbthreads );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1323,6 +1484,8 @@ magma_int_t magma_get_dbulge_nb( magma_int_t n, magma_int_t nbthreads  )
 /// @return nb for 2 stage TRD
 magma_int_t magma_get_cbulge_nb( magma_int_t n, magma_int_t nbthreads  )
 {
+    MAGMA_TUNE_RETURN( "bulge_nb", 'c', n, nbthreads );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1343,6 +1506,8 @@ magma_int_t magma_get_cbulge_nb( magma_int_t n, magma_int_t nbthreads  )
 /// @return nb for 2 stage TRD
 magma_int_t magma_get_zbulge_nb( magma_int_t n, magma_int_t nbthreads )
 {
+    MAGMA_TUNE_RETURN( "bulge_nb", 'z', n, nbthreads );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1366,6 +1531,10 @@ magma_int_t magma_get_zbulge_nb( magma_int_t n, magma_int_t nbthreads )
 magma_int_t magma_get_sbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads  )
 {
     magma_int_t size;
+    if ( magma_tune_get( "bulge_vblksiz", 's', n, nb, &size )) {
+        return min( nb, size );
+    }
+
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
         size = min(nb, 128);
@@ -1380,6 +1549,10 @@ magma_int_t magma_get_sbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t
 magma_int_t magma_get_dbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads  )
 {
     magma_int_t size;
+    if ( magma_tune_get( "bulge_vblksiz", 'd', n, nb, &size )) {
+        return min( nb, size );
+    }
+
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
         size = min(nb, 64);
@@ -1394,6 +1567,10 @@ magma_int_t magma_get_dbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t
 magma_int_t magma_get_cbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads )
 {
     magma_int_t size;
+    if ( magma_tune_get( "bulge_vblksiz", 'c', n, nb, &size )) {
+        return min( nb, size );
+    }
+
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
         if ( nbthreads > 14 )
@@ -1411,6 +1588,10 @@ magma_int_t magma_get_cbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t
 magma_int_t magma_get_zbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads )
 {
     magma_int_t size;
+    if ( magma_tune_get( "bulge_vblksiz", 'z', n, nb, &size )) {
+        return min( nb, size );
+    }
+
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
         if ( nbthreads > 14 )
@@ -1425,10 +1606,46 @@ magma_int_t magma_get_zbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t
 }
 
 
+/******************************************************************************/
+/// @return grsiz, the number of sweeps a thread chases together, for 2 stage TRD
+magma_int_t magma_get_sbulge_grsiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads )
+{
+    MAGMA_TUNE_RETURN( "bulge_grsiz", 's', n, nb );
+
+    return 1;
+}
+
+/// @return grsiz, the number of sweeps a thread chases together, for 2 stage TRD
+magma_int_t magma_get_dbulge_grsiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads )
+{
+    MAGMA_TUNE_RETURN( "bulge_grsiz", 'd', n, nb );
+
+    return 1;
+}
+
+/// @return grsiz, the number of sweeps a thread chases together, for 2 stage TRD
+magma_int_t magma_get_cbulge_grsiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads )
+{
+    MAGMA_TUNE_RETURN( "bulge_grsiz", 'c', n, nb );
+
+    return 1;
+}
+
+/// @return grsiz, the number of sweeps a thread chases together, for 2 stage TRD
+magma_int_t magma_get_zbulge_grsiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads )
+{
+    MAGMA_TUNE_RETURN( "bulge_grsiz", 'z', n, nb );
+
+    return 1;
+}
+
+
 /******************************************************************************/
 /// @return nb for 2 stage TRD_MGPU
 magma_int_t magma_get_sbulge_mgpu_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "bulge_mgpu_nb", 's', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1446,6 +1663,8 @@ magma_int_t magma_get_sbulge_mgpu_nb( magma_int_t n )
 /// @return nb for 2 stage TRD_MGPU
 magma_int_t magma_get_dbulge_mgpu_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "bulge_mgpu_nb", 'd', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1463,6 +1682,8 @@ magma_int_t magma_get_dbulge_mgpu_nb( magma_int_t n )
 /// @return nb for 2 stage TRD_MGPU
 magma_int_t magma_get_cbulge_mgpu_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "bulge_mgpu_nb", 'c', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
@@ -1480,6 +1701,8 @@ magma_int_t magma_get_cbulge_mgpu_nb( magma_int_t n )
 /// @return nb for 2 stage TRD_MGPU
 magma_int_t magma_get_zbulge_mgpu_nb( magma_int_t n )
 {
+    MAGMA_TUNE_RETURN( "bulge_mgpu_nb", 'z', n, n );
+
     magma_int_t nb;
     magma_int_t arch = magma_getdevice_arch();
     if ( arch >= 300 ) {       // 3.x Kepler + SB
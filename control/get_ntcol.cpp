@@ -12,6 +12,7 @@
 */
 
 #include "magma_internal.h"
+#include "magma_tune.h"
 
 // for every size [1:32], how many 1D configs can a warp hold?
 #define NTCOL_1D_DEFAULT 32, 16, 10, 8, 6, 5, 4, 4, 3, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
@@ -98,6 +99,8 @@ extern "C" {
 *******************************************************************************/
 magma_int_t magma_get_zgemm_batched_ntcol(magma_int_t m)
 {
+    MAGMA_TUNE_RETURN( "gemm_batched_ntcol", 'z', m, m );
+
     magma_int_t* ntcol_array; 
 
     if(m < 0 || m > 32) return 1;
@@ -114,6 +117,8 @@ magma_int_t magma_get_zgemm_batched_ntcol(magma_int_t m)
 /// @see magma_get_zgemm_batched_ntcol
 magma_int_t magma_get_cgemm_batched_ntcol(magma_int_t m)
 {
+    MAGMA_TUNE_RETURN( "gemm_batched_ntcol", 'c', m, m );
+
     magma_int_t* ntcol_array; 
 
     if(m < 0 || m > 32) return 1;
@@ -130,6 +135,8 @@ magma_int_t magma_get_cgemm_batched_ntcol(magma_int_t m)
 /// @see magma_get_zgemm_batched_ntcol
 magma_int_t magma_get_dgemm_batched_ntcol(magma_int_t m)
 {
+    MAGMA_TUNE_RETURN( "gemm_batched_ntcol", 'd', m, m );
+
     magma_int_t* ntcol_array; 
 
     if(m < 0 || m > 32) return 1;
@@ -146,6 +153,8 @@ magma_int_t magma_get_dgemm_batched_ntcol(magma_int_t m)
 /// @see magma_get_zgemm_batched_ntcol
 magma_int_t magma_get_sgemm_batched_ntcol(magma_int_t m)
 {
+    MAGMA_TUNE_RETURN( "gemm_batched_ntcol", 's', m, m );
+
     magma_int_t* ntcol_array; 
 
     if(m < 0 || m > 32) return 1;
@@ -164,6 +173,8 @@ magma_int_t magma_get_sgemm_batched_ntcol(magma_int_t m)
 *******************************************************************************/
 magma_int_t magma_get_zgetrf_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "getrf_batched_ntcol", 'z', m, n );
+
     magma_int_t* ntcol_array; 
 
     if(m != n || m < 0 || m > 32) return 1;
@@ -180,6 +191,8 @@ magma_int_t magma_get_zgetrf_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgetrf_batched_ntcol
 magma_int_t magma_get_cgetrf_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "getrf_batched_ntcol", 'c', m, n );
+
     magma_int_t* ntcol_array; 
 
     if(m != n || m < 0 || m > 32) return 1;
@@ -196,6 +209,8 @@ magma_int_t magma_get_cgetrf_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgetrf_batched_ntcol
 magma_int_t magma_get_dgetrf_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "getrf_batched_ntcol", 'd', m, n );
+
     magma_int_t* ntcol_array; 
 
     if(m != n || m < 0 || m > 32) return 1;
@@ -212,6 +227,8 @@ magma_int_t magma_get_dgetrf_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgetrf_batched_ntcol
 magma_int_t magma_get_sgetrf_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "getrf_batched_ntcol", 's', m, n );
+
     magma_int_t* ntcol_array; 
 
     if(m != n || m < 0 || m > 32) return 1;
@@ -230,6 +247,8 @@ magma_int_t magma_get_sgetrf_batched_ntcol(magma_int_t m, magma_int_t n)
 *******************************************************************************/
 magma_int_t magma_get_zgeqrf_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "geqrf_batched_ntcol", 'z', m, n );
+
     magma_int_t* ntcol_array; 
 
     if(m != n || m < 0 || m > 32) return 1;
@@ -246,6 +265,8 @@ magma_int_t magma_get_zgeqrf_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgeqrf_batched_ntcol
 magma_int_t magma_get_cgeqrf_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "geqrf_batched_ntcol", 'c', m, n );
+
     magma_int_t* ntcol_array; 
 
     if(m != n || m < 0 || m > 32) return 1;
@@ -262,6 +283,8 @@ magma_int_t magma_get_cgeqrf_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgeqrf_batched_ntcol
 magma_int_t magma_get_dgeqrf_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "geqrf_batched_ntcol", 'd', m, n );
+
     magma_int_t* ntcol_array; 
 
     if(m != n || m < 0 || m > 32) return 1;
@@ -278,6 +301,8 @@ magma_int_t magma_get_dgeqrf_batched_ntcol(magma_int_t m, magma_int_t n)
 /// @see magma_get_zgeqrf_batched_ntcol
 magma_int_t magma_get_sgeqrf_batched_ntcol(magma_int_t m, magma_int_t n)
 {
+    MAGMA_TUNE_RETURN( "geqrf_batched_ntcol", 's', m, n );
+
     magma_int_t* ntcol_array; 
 
     if(m != n || m < 0 || m > 32) return 1;
@@ -0,0 +1,451 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "magma_internal.h"
+#include "magma_thread_budget.h"
+#include "trace.h"
+
+
+/*
+    CPU queues run CPU stages, e.g., magma_zhetrd_hb2st or magma_zstedx,
+    asynchronously from the thread that submits them, as a device queue
+    runs kernels. Each queue has a thread that runs its tasks in order; tasks
+    in different queues run concurrently, ordered only by their dependencies.
+    A queue reserves its CPUs from the thread budget when it is created, so
+    stages in concurrent queues use disjoint CPUs.
+*/
+
+struct magma_cpu_task
+{
+    magma_cpu_func_t                func;   // NULL to wait for event
+    void*                           arg;
+    magma_event_t                   event;
+    std::vector< magma_cpu_task* >  deps;   // released when task starts
+    magma_int_t                     info;
+    bool                            done;
+    std::mutex                      mutex;  // for done, info
+    std::condition_variable         cv;     // signaled when done
+    std::atomic< int >              refs;   // queue, handle, dependents
+};
+
+struct magma_cpu_queue
+{
+    std::thread                     thread;
+    std::mutex                      mutex;
+    std::condition_variable         cv_task;  // signaled when a task is queued
+    std::condition_variable         cv_done;  // signaled when a task finishes
+    std::deque< magma_cpu_task* >   tasks;
+    long long                       submitted;
+    long long                       completed;
+    bool                            quit;
+    magma_thread_region*            region;   // NULL if no CPUs reserved
+};
+
+
+/******************************************************************************/
+static void cpu_task_release( magma_cpu_task* task )
+{
+    if ( task->refs.fetch_sub( 1 ) == 1 ) {
+        delete task;
+    }
+}
+
+
+/******************************************************************************/
+// waits for the task's dependencies, runs it, and marks it done
+static void cpu_task_run( magma_cpu_task* task )
+{
+    for( size_t i = 0; i < task->deps.size(); ++i ) {
+        magma_cpu_task_wait( task->deps[i] );
+        cpu_task_release( task->deps[i] );
+    }
+    task->deps.clear();
+
+    magma_int_t info = 0;
+    if ( task->func != NULL ) {
+        magma_trace_begin( "cpu_task", "cpu task" );
+        info = task->func( task->arg );
+        magma_trace_end();
+    }
+    else {
+        magma_event_sync( task->event );
+    }
+
+    std::lock_guard< std::mutex > lock( task->mutex );
+    task->info = info;
+    task->done = true;
+    task->cv.notify_all();
+}
+
+
+/******************************************************************************/
+// main routine of a queue's thread; returns after quit, once the queue is empty
+static void cpu_queue_main( magma_cpu_queue* queue )
+{
+    // stages get the queue's CPUs; else they share the application's CPUs
+    magma_thread_owner* owner = NULL;
+    if ( queue->region != NULL ) {
+        owner = new magma_thread_owner( *queue->region );
+    }
+
+    while ( true ) {
+        magma_cpu_task* task;
+        {
+            std::unique_lock< std::mutex > lock( queue->mutex );
+            queue->cv_task.wait( lock, [queue] {
+                return ! queue->tasks.empty() || queue->quit;
+            });
+            if ( queue->tasks.empty() ) {
+                break;  // quit
+            }
+            task = queue->tasks.front();
+            queue->tasks.pop_front();
+        }
+
+        cpu_task_run( task );
+        cpu_task_release( task );
+
+        std::lock_guard< std::mutex > lock( queue->mutex );
+        queue->completed += 1;
+        queue->cv_done.notify_all();
+    }
+
+    delete owner;
+}
+
+
+/******************************************************************************/
+static magma_int_t cpu_queue_push( magma_cpu_queue_t queue, magma_cpu_task* task )
+{
+    std::lock_guard< std::mutex > lock( queue->mutex );
+    if ( queue->quit ) {
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    queue->tasks.push_back( task );
+    queue->submitted += 1;
+    queue->cv_task.notify_one();
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Creates a CPU queue, which runs CPU stages asynchronously from the
+    calling thread. Its tasks run in order, in the queue's own thread;
+    tasks in different queues run concurrently, subject to dependencies.
+    This lets independent stages overlap, e.g., the tridiagonal solve of
+    one eigenproblem with the band reduction of the next.
+
+    Example, overlapping two eigenproblems on two queues, each with half
+    the CPUs:
+
+    @code
+    magma_int_t nthreads = magma_get_parallel_numthreads();
+    magma_cpu_queue_t q1, q2;
+    magma_cpu_task_t  t1, t2, t3;
+    magma_cpu_queue_create( nthreads/2, &q1 );
+    magma_cpu_queue_create( nthreads/2, &q2 );
+    // stage functions take a struct of the stage's arguments
+    magma_cpu_task_submit( q1, hb2st_stage, &problem1, 0, NULL, &t1 );
+    magma_cpu_task_submit( q2, hb2st_stage, &problem2, 0, NULL, &t2 );
+    magma_cpu_task_submit( q1, stedx_stage, &problem1, 0, NULL, NULL );
+    // t3 waits for q2's previous tasks, and for t1
+    magma_cpu_task_submit( q2, stedx_stage, &problem2, 1, &t1, &t3 );
+    info = magma_cpu_task_wait( t3 );
+    magma_cpu_task_destroy( t1 );
+    magma_cpu_task_destroy( t2 );
+    magma_cpu_task_destroy( t3 );
+    magma_cpu_queue_destroy( q1 );  // syncs q1
+    magma_cpu_queue_destroy( q2 );
+    @endcode
+
+    @param[in]
+    nthreads    Number of CPUs to reserve for the queue's tasks, from the
+                calling thread's budget (see magma_thread_budget_available);
+                the queue may get fewer. Parallel regions in the tasks, e.g.,
+                the threads of magma_zhetrd_hb2st, divide these CPUs, and the
+                tasks' BLAS use this many threads.
+                If nthreads <= 0, no CPUs are reserved, and tasks share the
+                CPUs of application threads.
+
+    @param[out]
+    queue_ptr   On output, the new queue.
+
+    @return MAGMA_SUCCESS, or MAGMA_ERR_HOST_ALLOC if the queue or its
+    thread could not be created.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" magma_int_t
+magma_cpu_queue_create( magma_int_t nthreads, magma_cpu_queue_t* queue_ptr )
+{
+    *queue_ptr = NULL;
+    magma_cpu_queue* queue = new (std::nothrow) magma_cpu_queue;
+    if ( queue == NULL ) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    queue->submitted = 0;
+    queue->completed = 0;
+    queue->quit      = false;
+    queue->region    = NULL;
+    if ( nthreads > 0 ) {
+        queue->region = new magma_thread_region( "cpu_queue", nthreads );
+    }
+    try {
+        queue->thread = std::thread( cpu_queue_main, queue );
+    }
+    catch (...) {
+        delete queue->region;
+        delete queue;
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    *queue_ptr = queue;
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Waits for all tasks in the queue to finish, then destroys the queue and
+    releases its CPUs. Task handles remain valid until destroyed.
+
+    @param[in]
+    queue       Queue to destroy; may be NULL.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_cpu_queue_destroy( magma_cpu_queue_t queue )
+{
+    if ( queue == NULL ) {
+        return;
+    }
+    {
+        std::lock_guard< std::mutex > lock( queue->mutex );
+        queue->quit = true;
+        queue->cv_task.notify_one();
+    }
+    queue->thread.join();
+    delete queue->region;
+    delete queue;
+}
+
+
+/***************************************************************************//**
+    Waits for all tasks submitted to the queue to finish.
+
+    @param[in]
+    queue       Queue to synchronize.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_cpu_queue_sync( magma_cpu_queue_t queue )
+{
+    std::unique_lock< std::mutex > lock( queue->mutex );
+    long long ticket = queue->submitted;
+    queue->cv_done.wait( lock, [queue, ticket] {
+        return queue->completed >= ticket;
+    });
+}
+
+
+/***************************************************************************//**
+    Makes later tasks in the CPU queue wait for a device event, e.g., for
+    a device queue to finish computing a stage's input. The calling thread
+    does not block.
+    Unlike magma_queue_wait_event, the event is waited on when the queue
+    reaches it, so it must not be recorded again until previous tasks in the
+    queue finish.
+
+    @param[in]
+    queue       CPU queue.
+
+    @param[in]
+    event       Event recorded on a device queue, with magma_event_record.
+
+    @return MAGMA_SUCCESS, or MAGMA_ERR_HOST_ALLOC.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" magma_int_t
+magma_cpu_queue_wait_event( magma_cpu_queue_t queue, magma_event_t event )
+{
+    magma_cpu_task* task = new (std::nothrow) magma_cpu_task;
+    if ( task == NULL ) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    task->func  = NULL;
+    task->arg   = NULL;
+    task->event = event;
+    task->info  = 0;
+    task->done  = false;
+    task->refs  = 1;  // queue
+    magma_int_t info = cpu_queue_push( queue, task );
+    if ( info != 0 ) {
+        delete task;
+    }
+    return info;
+}
+
+
+/***************************************************************************//**
+    Submits a task to a CPU queue. It runs after previous tasks in the
+    queue, and after the tasks in deps, which may be in other queues.
+    It runs even if a dependency returned nonzero info; a task can check
+    that with magma_cpu_task_wait.
+
+    For device work that depends on a CPU task, submit a task that queues
+    the device work, with the CPU task as a dependency. For a CPU task that
+    depends on device work, see magma_cpu_queue_wait_event.
+
+    @param[in]
+    queue       CPU queue.
+
+    @param[in]
+    func        Function to run; its return value is the task's info.
+
+    @param[in]
+    arg         Argument passed to func.
+
+    @param[in]
+    ndeps       Number of dependencies. ndeps >= 0.
+
+    @param[in]
+    deps        Array of ndeps tasks, already submitted, that this task
+                waits for. May be NULL if ndeps = 0.
+
+    @param[out]
+    task_ptr    On output, a handle to the task, to wait on or use as a
+                dependency; destroy it with magma_cpu_task_destroy.
+                If NULL, no handle is returned.
+
+    @return
+      -     = 0:  successful exit
+      -     < 0:  if -i, the i-th argument had an illegal value,
+                  or MAGMA_ERR_HOST_ALLOC,
+                  or MAGMA_ERR_ILLEGAL_VALUE if the queue is being destroyed.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" magma_int_t
+magma_cpu_task_submit(
+    magma_cpu_queue_t queue, magma_cpu_func_t func, void* arg,
+    magma_int_t ndeps, const magma_cpu_task_t* deps,
+    magma_cpu_task_t* task_ptr )
+{
+    magma_int_t info = 0;
+    if ( queue == NULL )
+        info = -1;
+    else if ( func == NULL )
+        info = -2;
+    else if ( ndeps < 0 )
+        info = -4;
+    else if ( ndeps > 0 && deps == NULL )
+        info = -5;
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    if ( task_ptr != NULL ) {
+        *task_ptr = NULL;
+    }
+    magma_cpu_task* task = new (std::nothrow) magma_cpu_task;
+    if ( task == NULL ) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    task->func  = func;
+    task->arg   = arg;
+    task->event = magma_event_t();
+    task->info  = 0;
+    task->done  = false;
+    task->refs  = (task_ptr != NULL ? 2 : 1);  // queue and handle
+    try {
+        task->deps.assign( deps, deps + ndeps );
+    }
+    catch (...) {
+        delete task;
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    for( magma_int_t i = 0; i < ndeps; ++i ) {
+        deps[i]->refs += 1;
+    }
+
+    info = cpu_queue_push( queue, task );
+    if ( info != 0 ) {
+        for( magma_int_t i = 0; i < ndeps; ++i ) {
+            cpu_task_release( deps[i] );
+        }
+        delete task;
+        return info;
+    }
+    if ( task_ptr != NULL ) {
+        *task_ptr = task;
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    @return 1 if the task has finished, 0 if it is queued or running.
+    Does not block.
+
+    @param[in]
+    task        Task handle from magma_cpu_task_submit.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" magma_int_t
+magma_cpu_task_query( magma_cpu_task_t task )
+{
+    std::lock_guard< std::mutex > lock( task->mutex );
+    return task->done;
+}
+
+
+/***************************************************************************//**
+    Waits for the task to finish.
+
+    @param[in]
+    task        Task handle from magma_cpu_task_submit.
+
+    @return The task's info, returned by its function.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" magma_int_t
+magma_cpu_task_wait( magma_cpu_task_t task )
+{
+    std::unique_lock< std::mutex > lock( task->mutex );
+    task->cv.wait( lock, [task] { return task->done; });
+    return task->info;
+}
+
+
+/***************************************************************************//**
+    Destroys a task handle. If the task hasn't finished, it still runs, and
+    tasks that depend on it still wait for it.
+
+    @param[in]
+    task        Task handle from magma_cpu_task_submit; may be NULL.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_cpu_task_destroy( magma_cpu_task_t task )
+{
+    if ( task != NULL ) {
+        cpu_task_release( task );
+    }
+}
@@ -0,0 +1,724 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if ! defined( _WIN32 ) && ! defined( _WIN64 )
+#define HOST_POOL_SUPPORTED
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "magma_host_pool.h"
+
+
+/*
+    Pooled host allocator behind magma_malloc_cpu.
+
+    Small requests (<= 256 KiB) are rounded up to one of 44 size classes,
+    multiples of 64 bytes with 4 classes per power of 2. Their blocks are
+    carved from 2 MiB aligned spans, each span holding one class. Each thread
+    caches a few free blocks per class, so most magma_malloc_cpu and
+    magma_free_cpu pairs take no lock; the caches refill from, and spill to,
+    a central free list per class and NUMA node.
+
+    Large requests get their own 2 MiB aligned mapping. Freed mappings are
+    cached, per NUMA node, up to a limit and reused for requests that need
+    at least half of the mapping, which avoids page faults on every reuse.
+
+    Memory is not touched when mapped, so the kernel places each page on the
+    node of the thread that first touches it. With the NUMA option, blocks
+    are reused only by threads on the node they were allocated on.
+
+    The pool owns whole 2 MiB chunks, recorded in a radix map, so
+    magma_free_cpu can tell pooled pointers from malloc'ed ones without a
+    header or a lock, and pointers allocated before the pool was enabled
+    (or after it was disabled) are still freed correctly.
+*/
+
+int magma_host_pool_on   = 0;
+int magma_host_pool_used = 0;
+
+#ifdef HOST_POOL_SUPPORTED
+
+const size_t span_shift    = 21;
+const size_t span_size     = size_t(1) << span_shift;
+const size_t header_size   = 64;                  // also the alignment
+const size_t max_small     = size_t(256) * 1024;
+const int    nclasses      = 44;
+const int    max_nodes     = 8;
+const size_t default_cache = size_t(256) * 1024 * 1024;
+const uint32_t span_magic  = 0x6d61676d;          // "magm"
+
+// the radix map covers 47-bit addresses in 2 MiB chunks
+const int    radix_bits    = 13;
+const size_t radix_size    = size_t(1) << radix_bits;
+const size_t radix_max     = size_t(1) << (2*radix_bits);
+
+enum { ChunkNone = 0, ChunkSmall = 1, ChunkLarge = 2 };
+
+// at the start of each span or large mapping
+struct span_header
+{
+    uint32_t magic;
+    int32_t  cls;       // size class, or -1 for a large mapping
+    int32_t  node;
+    size_t   size;      // bytes mapped
+};
+
+// free blocks of one class on one node
+struct central_list
+{
+    std::mutex mutex;
+    void*      free;    // linked through the first word of each block
+    char*      bump;    // rest of the current span
+    char*      bump_end;
+};
+
+struct site_stats
+{
+    uint64_t calls;
+    uint64_t bytes;
+};
+
+static int    g_options    = 0;
+static bool   g_configured = false;  // by magma_host_pool_enable
+static size_t g_max_cached = default_cache;
+
+static std::atomic< std::atomic< uint8_t >* > g_radix[ radix_size ];
+static central_list g_central[ max_nodes ][ nclasses ];
+
+static std::mutex g_large_mutex[ max_nodes ];
+static std::multimap< size_t, char* >* g_large_cache[ max_nodes ];
+
+static std::atomic< int64_t  > g_live;
+static std::atomic< int64_t  > g_peak;
+static std::atomic< int64_t  > g_mapped;
+static std::atomic< int64_t  > g_cached;
+static std::atomic< uint64_t > g_calls;
+static std::atomic< uint64_t > g_maps;
+
+// never destroyed, so they can be used at exit
+static std::mutex& sites_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+static std::unordered_map< void*, site_stats >& sites()
+{
+    static std::unordered_map< void*, site_stats >* map
+        = new std::unordered_map< void*, site_stats >;
+    return *map;
+}
+
+
+/******************************************************************************/
+// class of size in (0, max_small]
+static inline int size_class( size_t size )
+{
+    size = (size + header_size - 1) & ~(header_size - 1);
+    if ( size <= 512 ) {
+        return int( size/64 - 1 );
+    }
+    int p = 63 - __builtin_clzll( (unsigned long long) (size - 1) );  // 2^p < size <= 2^(p+1)
+    return 8 + (p - 9)*4 + int( (size - 1 - (size_t(1) << p)) >> (p - 2) );
+}
+
+// size of blocks in class cls
+static inline size_t class_size( int cls )
+{
+    if ( cls < 8 ) {
+        return (cls + 1)*64;
+    }
+    int p   = 9 + (cls - 8)/4;
+    int sub = (cls - 8) % 4;
+    return (size_t(1) << p) + (sub + 1)*(size_t(1) << (p - 2));
+}
+
+// most blocks of class cls a thread caches; half that moves at a time
+static inline int cache_limit( int cls )
+{
+    size_t n = (512*1024) / class_size( cls );
+    return int( n < 4 ? 4 : (n > 64 ? 64 : n) );
+}
+
+
+/******************************************************************************/
+static void radix_set( void* chunk, uint8_t kind )
+{
+    size_t key = uintptr_t( chunk ) >> span_shift;
+    std::atomic< uint8_t >* leaf = g_radix[ key >> radix_bits ].load( std::memory_order_acquire );
+    if ( leaf == NULL ) {
+        std::atomic< uint8_t >* fresh = new std::atomic< uint8_t >[ radix_size ];
+        for( size_t i = 0; i < radix_size; ++i ) {
+            fresh[i].store( ChunkNone, std::memory_order_relaxed );
+        }
+        if ( g_radix[ key >> radix_bits ].compare_exchange_strong( leaf, fresh ) ) {
+            leaf = fresh;
+        }
+        else {
+            delete[] fresh;  // another thread won; leaf is its array
+        }
+    }
+    leaf[ key & (radix_size - 1) ].store( kind, std::memory_order_release );
+}
+
+static inline uint8_t radix_get( const void* ptr )
+{
+    size_t key = uintptr_t( ptr ) >> span_shift;
+    if ( key >= radix_max ) {
+        return ChunkNone;
+    }
+    std::atomic< uint8_t >* leaf = g_radix[ key >> radix_bits ].load( std::memory_order_acquire );
+    if ( leaf == NULL ) {
+        return ChunkNone;
+    }
+    return leaf[ key & (radix_size - 1) ].load( std::memory_order_acquire );
+}
+
+
+/******************************************************************************/
+// NUMA node of the calling thread, if the NUMA option is set
+static int current_node()
+{
+    #ifdef SYS_getcpu
+    if ( g_options & MagmaHostPoolNuma ) {
+        unsigned cpu = 0, node = 0;
+        if ( syscall( SYS_getcpu, &cpu, &node, NULL ) == 0 ) {
+            return int( node % max_nodes );
+        }
+    }
+    #endif
+    return 0;
+}
+
+// maps size bytes (a multiple of span_size), aligned to span_size, untouched
+static char* map_aligned( size_t size )
+{
+    void* ptr = mmap( NULL, size + span_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if ( ptr == MAP_FAILED ) {
+        return NULL;
+    }
+    uintptr_t addr = uintptr_t( ptr );
+    uintptr_t base = (addr + span_size - 1) & ~uintptr_t( span_size - 1 );
+    if ( base > addr ) {
+        munmap( ptr, base - addr );
+    }
+    if ( addr + span_size > base ) {
+        munmap( (void*) (base + size), addr + span_size - base );
+    }
+    if ( ((base + size - 1) >> span_shift) >= radix_max ) {
+        munmap( (void*) base, size );  // outside the radix map
+        return NULL;
+    }
+    #ifdef MADV_HUGEPAGE
+    if ( g_options & MagmaHostPoolHugePages ) {
+        madvise( (void*) base, size, MADV_HUGEPAGE );
+    }
+    #endif
+    g_mapped += size;
+    g_maps   += 1;
+    magma_host_pool_used = 1;
+    return (char*) base;
+}
+
+
+/******************************************************************************/
+// free blocks cached by a thread, given back when the thread exits
+struct thread_cache
+{
+    void* free [ nclasses ];
+    int   count[ nclasses ];
+    int   node;
+
+    thread_cache(): node( -1 )
+    {
+        memset( free,  0, sizeof(free)  );
+        memset( count, 0, sizeof(count) );
+    }
+
+    ~thread_cache()
+    {
+        for( int cls = 0; cls < nclasses; ++cls ) {
+            spill( cls, count[cls] );
+        }
+    }
+
+    // moves n blocks of class cls to the central list
+    void spill( int cls, int n )
+    {
+        if ( n <= 0 ) {
+            return;
+        }
+        void* first = free[cls];
+        void* last  = first;
+        for( int i = 1; i < n; ++i ) {
+            last = *(void**) last;
+        }
+        free[cls]   = *(void**) last;
+        count[cls] -= n;
+
+        central_list& c = g_central[ node ][ cls ];
+        std::lock_guard< std::mutex > lock( c.mutex );
+        *(void**) last = c.free;
+        c.free = first;
+    }
+};
+
+static thread_local thread_cache t_cache;
+
+
+/******************************************************************************/
+// refills the calling thread's cache of class cls; returns one block
+static void* refill( thread_cache& tc, int cls )
+{
+    central_list& c = g_central[ tc.node ][ cls ];
+    size_t bsize = class_size( cls );
+    int want = cache_limit( cls ) / 2;
+    void* ptr = NULL;
+
+    std::lock_guard< std::mutex > lock( c.mutex );
+    while ( want > 0 && c.free != NULL ) {
+        void* block = c.free;
+        c.free = *(void**) block;
+        *(void**) block = ptr;
+        ptr = block;
+        --want;
+    }
+    while ( want > 0 ) {
+        if ( c.bump + bsize > c.bump_end ) {
+            if ( ptr != NULL ) {
+                break;  // don't map a new span just to fill the cache
+            }
+            char* span = map_aligned( span_size );
+            if ( span == NULL ) {
+                return NULL;
+            }
+            span_header* hdr = (span_header*) span;
+            hdr->magic = span_magic;
+            hdr->cls   = cls;
+            hdr->node  = tc.node;
+            hdr->size  = span_size;
+            radix_set( span, ChunkSmall );
+            c.bump     = span + header_size;
+            c.bump_end = span + span_size;
+        }
+        void* block = c.bump;
+        c.bump += bsize;
+        *(void**) block = ptr;
+        ptr = block;
+        --want;
+    }
+    // first block is returned, the rest go to the thread's cache
+    void* rest = *(void**) ptr;
+    int n = 0;
+    for( void* p = rest; p != NULL; p = *(void**) p ) {
+        ++n;
+    }
+    tc.free[cls]  = rest;
+    tc.count[cls] = n;
+    return ptr;
+}
+
+
+/******************************************************************************/
+static void* large_malloc( size_t size )
+{
+    size_t mapped = (size + header_size + span_size - 1) & ~(span_size - 1);
+    int node = current_node();
+    char* base = NULL;
+    {
+        // reuse a cached mapping of at most twice the size
+        std::lock_guard< std::mutex > lock( g_large_mutex[ node ] );
+        std::multimap< size_t, char* >* cache = g_large_cache[ node ];
+        if ( cache != NULL ) {
+            std::multimap< size_t, char* >::iterator it = cache->lower_bound( mapped );
+            if ( it != cache->end() && it->first <= 2*mapped ) {
+                base = it->second;
+                g_cached -= it->first;
+                cache->erase( it );
+            }
+        }
+    }
+    if ( base == NULL ) {
+        base = map_aligned( mapped );
+        if ( base == NULL ) {
+            return NULL;
+        }
+        span_header* hdr = (span_header*) base;
+        hdr->magic = span_magic;
+        hdr->cls   = -1;
+        hdr->node  = node;
+        hdr->size  = mapped;
+        radix_set( base, ChunkLarge );
+    }
+    return base + header_size;
+}
+
+
+/******************************************************************************/
+static void large_free( char* base )
+{
+    span_header* hdr = (span_header*) base;
+    size_t size = hdr->size;
+    int node = hdr->node;
+    {
+        std::lock_guard< std::mutex > lock( g_large_mutex[ node ] );
+        if ( size_t( g_cached.load() ) + size <= g_max_cached ) {
+            if ( g_large_cache[ node ] == NULL ) {
+                g_large_cache[ node ] = new std::multimap< size_t, char* >;
+            }
+            g_large_cache[ node ]->insert( std::make_pair( size, base ) );
+            g_cached += size;
+            return;
+        }
+    }
+    radix_set( base, ChunkNone );
+    munmap( base, size );
+    g_mapped -= size;
+}
+
+
+/******************************************************************************/
+static inline void count_alloc( int64_t bytes )
+{
+    int64_t live = (g_live += bytes);
+    int64_t peak = g_peak.load( std::memory_order_relaxed );
+    while ( live > peak && ! g_peak.compare_exchange_weak( peak, live ) ) {
+    }
+}
+
+
+/******************************************************************************/
+void* magma_host_pool_malloc( size_t size, void* site )
+{
+    g_calls += 1;
+    if ( g_options & MagmaHostPoolSites ) {
+        std::lock_guard< std::mutex > lock( sites_mutex() );
+        site_stats& s = sites()[ site ];
+        s.calls += 1;
+        s.bytes += size;
+    }
+
+    void* ptr;
+    if ( size > max_small ) {
+        ptr = large_malloc( size );
+        if ( ptr != NULL ) {
+            count_alloc( ((span_header*) ((char*) ptr - header_size))->size );
+        }
+        return ptr;
+    }
+
+    int cls = size_class( size );
+    thread_cache& tc = t_cache;
+    if ( tc.node < 0 ) {
+        tc.node = current_node();
+    }
+    ptr = tc.free[cls];
+    if ( ptr != NULL ) {
+        tc.free[cls] = *(void**) ptr;
+        tc.count[cls] -= 1;
+    }
+    else {
+        ptr = refill( tc, cls );
+    }
+    if ( ptr != NULL ) {
+        count_alloc( class_size( cls ) );
+    }
+    return ptr;
+}
+
+
+/******************************************************************************/
+bool magma_host_pool_free( void* ptr )
+{
+    uint8_t kind = radix_get( ptr );
+    if ( kind == ChunkNone ) {
+        return false;
+    }
+    char* base = (char*) (uintptr_t( ptr ) & ~uintptr_t( span_size - 1 ));
+    span_header* hdr = (span_header*) base;
+    if ( kind == ChunkLarge ) {
+        g_live -= hdr->size;
+        large_free( base );
+        return true;
+    }
+
+    int cls = hdr->cls;
+    g_live -= class_size( cls );
+    thread_cache& tc = t_cache;
+    if ( tc.node < 0 ) {
+        tc.node = current_node();
+    }
+    if ( hdr->node != tc.node ) {
+        // keep blocks on their node
+        central_list& c = g_central[ hdr->node ][ cls ];
+        std::lock_guard< std::mutex > lock( c.mutex );
+        *(void**) ptr = c.free;
+        c.free = ptr;
+        return true;
+    }
+    *(void**) ptr = tc.free[cls];
+    tc.free[cls] = ptr;
+    tc.count[cls] += 1;
+    int limit = cache_limit( cls );
+    if ( tc.count[cls] > limit ) {
+        tc.spill( cls, limit / 2 );
+    }
+    return true;
+}
+
+#else  // not HOST_POOL_SUPPORTED
+
+void* magma_host_pool_malloc( size_t size, void* site )
+{
+    return NULL;
+}
+
+bool magma_host_pool_free( void* ptr )
+{
+    return false;
+}
+
+#endif // not HOST_POOL_SUPPORTED
+
+
+/***************************************************************************//**
+    Enables or disables the pooled host allocator behind magma_malloc_cpu.
+    The pool caches freed memory for reuse by later allocations, avoiding
+    the cost of posix_memalign, free, and page faults when host arrays are
+    allocated and freed repeatedly, as in iterative sparse solvers.
+    Memory allocated while the pool is enabled can be freed while it is
+    disabled, and vice versa.
+
+    Also set by the environment variable $MAGMA_HOST_POOL at the first
+    magma_init, unless this function was called before; see
+    magma_host_pool_init.
+
+    Not supported on Windows.
+
+    @param[in]
+    options     Bitwise or of magma_host_pool_option_t:
+      -         MagmaHostPoolEnable:    use the pool; if not set, the pool
+                                        is disabled and other options ignored.
+      -         MagmaHostPoolHugePages: advise transparent huge pages.
+      -         MagmaHostPoolNuma:      reuse memory only on the NUMA node of
+                                        the thread that allocated it.
+      -         MagmaHostPoolSites:     count calls and bytes per call site.
+      -         MagmaHostPoolStats:     print statistics at magma_finalize.
+
+    @param[in]
+    max_cached  Most bytes of large (> 256 KiB) freed blocks kept for reuse;
+                0 for the default, 256 MiB.
+
+    @return MAGMA_SUCCESS
+    @return MAGMA_ERR_NOT_SUPPORTED if the pool is not available.
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" magma_int_t
+magma_host_pool_enable( magma_int_t options, size_t max_cached )
+{
+    #ifdef HOST_POOL_SUPPORTED
+    g_configured = true;
+    g_options = int( options );
+    g_max_cached = (max_cached == 0 ? default_cache : max_cached);
+    magma_host_pool_on = ((options & MagmaHostPoolEnable) != 0);
+    return MAGMA_SUCCESS;
+    #else
+    return MAGMA_ERR_NOT_SUPPORTED;
+    #endif
+}
+
+
+/***************************************************************************//**
+    Returns large freed blocks cached by the pooled host allocator to the
+    operating system, and the calling thread's cached small blocks to the
+    pool. Memory of small blocks is kept by the pool for reuse.
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" void
+magma_host_pool_trim( void )
+{
+    #ifdef HOST_POOL_SUPPORTED
+    thread_cache& tc = t_cache;
+    if ( tc.node >= 0 ) {
+        for( int cls = 0; cls < nclasses; ++cls ) {
+            tc.spill( cls, tc.count[cls] );
+        }
+    }
+    for( int node = 0; node < max_nodes; ++node ) {
+        std::vector< std::pair< size_t, char* > > blocks;
+        {
+            std::lock_guard< std::mutex > lock( g_large_mutex[ node ] );
+            if ( g_large_cache[ node ] != NULL ) {
+                blocks.assign( g_large_cache[ node ]->begin(), g_large_cache[ node ]->end() );
+                g_large_cache[ node ]->clear();
+            }
+        }
+        for( size_t i = 0; i < blocks.size(); ++i ) {
+            g_cached -= blocks[i].first;
+            radix_set( blocks[i].second, ChunkNone );
+            munmap( blocks[i].second, blocks[i].first );
+            g_mapped -= blocks[i].first;
+        }
+    }
+    #endif
+}
+
+
+/***************************************************************************//**
+    Gets statistics of the pooled host allocator. Sizes count whole blocks,
+    i.e., requests rounded up to their size class.
+
+    @param[out]
+    live        If not NULL, bytes currently allocated from the pool.
+
+    @param[out]
+    peak        If not NULL, most bytes allocated from the pool at once.
+
+    @param[out]
+    mapped      If not NULL, bytes the pool holds from the operating system,
+                including free and cached blocks.
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" void
+magma_host_pool_stats( size_t* live, size_t* peak, size_t* mapped )
+{
+    #ifdef HOST_POOL_SUPPORTED
+    if ( live   != NULL ) *live   = size_t( g_live.load() );
+    if ( peak   != NULL ) *peak   = size_t( g_peak.load() );
+    if ( mapped != NULL ) *mapped = size_t( g_mapped.load() );
+    #else
+    if ( live   != NULL ) *live   = 0;
+    if ( peak   != NULL ) *peak   = 0;
+    if ( mapped != NULL ) *mapped = 0;
+    #endif
+}
+
+
+/***************************************************************************//**
+    Prints statistics of the pooled host allocator to stdout, including the
+    call sites of magma_malloc_cpu with the most bytes requested if
+    MagmaHostPoolSites is set.
+
+    @ingroup magma_malloc_cpu
+*******************************************************************************/
+extern "C" void
+magma_host_pool_print( void )
+{
+    #ifdef HOST_POOL_SUPPORTED
+    printf( "%% MAGMA host pool: %s, live %.1f MiB, peak %.1f MiB, mapped %.1f MiB"
+            " (%.1f MiB cached large blocks), %llu allocations, %llu mappings\n",
+            (magma_host_pool_on ? "enabled" : "disabled"),
+            g_live.load()   / 1048576.,
+            g_peak.load()   / 1048576.,
+            g_mapped.load() / 1048576.,
+            g_cached.load() / 1048576.,
+            (unsigned long long) g_calls.load(),
+            (unsigned long long) g_maps.load() );
+
+    std::vector< std::pair< void*, site_stats > > list;
+    {
+        std::lock_guard< std::mutex > lock( sites_mutex() );
+        list.assign( sites().begin(), sites().end() );
+    }
+    // most bytes first
+    std::sort( list.begin(), list.end(),
+        []( const std::pair< void*, site_stats >& a, const std::pair< void*, site_stats >& b ) {
+            return a.second.bytes > b.second.bytes;
+        });
+    size_t n = (list.size() < 20 ? list.size() : 20);
+    for( size_t i = 0; i < n; ++i ) {
+        void* site = list[i].first;
+        const char* name = "";
+        #ifdef __GLIBC__
+        char** symbols = backtrace_symbols( &site, 1 );
+        if ( symbols != NULL ) {
+            name = symbols[0];
+        }
+        #endif
+        printf( "%%   %10llu calls %14llu bytes  %s\n",
+                (unsigned long long) list[i].second.calls,
+                (unsigned long long) list[i].second.bytes, name );
+        #ifdef __GLIBC__
+        ::free( symbols );
+        #endif
+    }
+    #else
+    printf( "%% MAGMA host pool: not supported\n" );
+    #endif
+}
+
+
+/***************************************************************************//**
+    Called by the first magma_init. Unless magma_host_pool_enable was called
+    before, sets the pool options from the environment variable
+    $MAGMA_HOST_POOL, a comma-separated list of:
+        1 or on         enable the pool
+        thp             also advise transparent huge pages
+        numa            also keep memory on its NUMA node
+        sites           also count calls and bytes per call site
+        stats           also print statistics at the last magma_finalize
+        cache=<MiB>     keep at most this many MiB of large freed blocks
+    E.g., MAGMA_HOST_POOL=thp,numa,stats. Any option enables the pool.
+*******************************************************************************/
+void magma_host_pool_init()
+{
+    const char* env = getenv( "MAGMA_HOST_POOL" );
+    if ( g_configured || env == NULL || env[0] == '\0' || strcmp( env, "0" ) == 0 ) {
+        return;
+    }
+    magma_int_t options = MagmaHostPoolEnable;
+    size_t max_cached = 0;
+    char buf[ 256 ];
+    strncpy( buf, env, sizeof(buf)-1 );
+    buf[ sizeof(buf)-1 ] = '\0';
+    for( char* tok = strtok( buf, "," ); tok != NULL; tok = strtok( NULL, "," )) {
+        if      ( strcmp( tok, "thp"   ) == 0 ) { options |= MagmaHostPoolHugePages; }
+        else if ( strcmp( tok, "numa"  ) == 0 ) { options |= MagmaHostPoolNuma;      }
+        else if ( strcmp( tok, "sites" ) == 0 ) { options |= MagmaHostPoolSites;     }
+        else if ( strcmp( tok, "stats" ) == 0 ) { options |= MagmaHostPoolStats;     }
+        else if ( strncmp( tok, "cache=", 6 ) == 0 ) {
+            max_cached = size_t( atol( tok + 6 ) ) * 1024 * 1024;
+        }
+        else if ( strcmp( tok, "1" ) != 0 && strcmp( tok, "on" ) != 0 ) {
+            fprintf( stderr, "MAGMA_HOST_POOL: unknown option '%s'\n", tok );
+        }
+    }
+    magma_host_pool_enable( options, max_cached );
+}
+
+
+/******************************************************************************/
+void magma_host_pool_finalize()
+{
+    #ifdef HOST_POOL_SUPPORTED
+    if ( g_options & MagmaHostPoolStats ) {
+        magma_host_pool_print();
+    }
+    #endif
+}
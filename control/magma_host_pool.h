@@ -0,0 +1,44 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_HOST_POOL_H
+#define MAGMA_HOST_POOL_H
+
+#include "magma_v2.h"
+
+// =============================================================================
+// Internal interface of the pooled host allocator used by magma_malloc_cpu
+// and magma_free_cpu; the public interface (magma_host_pool_enable, ...) is
+// in magma_auxiliary.h.
+
+extern int magma_host_pool_on;   // new allocations come from the pool
+extern int magma_host_pool_used; // the pool owns some memory
+
+// returns 64-byte aligned memory of at least size bytes, or NULL;
+// site is the caller, used for per-call-site statistics
+void* magma_host_pool_malloc( size_t size, void* site );
+
+// caller of the current function, for call-site statistics
+#ifdef __GNUC__
+#define magma_host_pool_caller() __builtin_return_address(0)
+#else
+#define magma_host_pool_caller() NULL
+#endif
+
+// returns true and releases ptr if the pool owns it;
+// returns false, without touching ptr, otherwise
+bool  magma_host_pool_free( void* ptr );
+
+// at the first magma_init, enables the pool as set in $MAGMA_HOST_POOL,
+// unless magma_host_pool_enable was already called
+void  magma_host_pool_init();
+
+// at the last magma_finalize, prints statistics if requested
+void  magma_host_pool_finalize();
+
+#endif        //  #ifndef MAGMA_HOST_POOL_H
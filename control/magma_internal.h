@@ -87,6 +87,10 @@
     @ingroup magma_queue
 *******************************************************************************/
 
+#ifdef HAVE_HOST
+struct magma_host_worker;
+#endif
+
 struct magma_queue
 {
 #ifdef __cplusplus
@@ -129,6 +133,11 @@ public:
 
     #endif
 
+    #ifdef HAVE_HOST
+    /// @return worker thread executing this queue; requires the host backend.
+    magma_host_worker* host_worker()   { return worker__;   }
+    #endif
+
 
     /// @return the pointer array dAarray__.
     void** get_dAarray() {
@@ -209,6 +218,10 @@ protected:
     hipsparseHandle_t hipsparse__;
 
     #endif
+
+    #ifdef HAVE_HOST
+    struct magma_host_worker* worker__;  // associated worker thread; see interface_host
+    #endif
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,386 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "magma_metrics.h"
+
+
+/*
+    Registry of performance metrics: per routine (and so per precision) the
+    number of calls, the cumulative wall time and flops, plus bytes allocated
+    and transferred between host and device, and the utilization of the
+    magma_thread_queue thread pools.
+
+    Enabled by magma_metrics_enable or the environment variable MAGMA_METRICS:
+        MAGMA_METRICS=0 or unset   disabled
+        MAGMA_METRICS=1            enabled
+        MAGMA_METRICS=file         enabled, text dump written to file at exit
+        MAGMA_METRICS=file.json    enabled, JSON dump written to file at exit
+*/
+
+int magma_metrics_on = 0;
+
+static std::atomic< uint64_t > g_alloc_count[ 3 ];
+static std::atomic< uint64_t > g_alloc_bytes[ 3 ];
+static std::atomic< uint64_t > g_transfer_count[ 3 ];
+static std::atomic< uint64_t > g_transfer_bytes[ 3 ];
+static std::atomic< uint64_t > g_pool_tasks;
+static std::atomic< uint64_t > g_pool_busy_nsec;
+static std::atomic< uint64_t > g_pool_thread_nsec;
+static std::atomic< uint64_t > g_start_nsec;
+static char g_filename[ 1024 ] = "";
+
+static const char* g_memory_names[ 3 ]   = { "device", "host", "pinned" };
+static const char* g_transfer_names[ 3 ] = { "host_to_device", "device_to_host", "device_to_device" };
+
+// never destroyed, so they can be used at exit and from any thread
+static std::mutex& metrics_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+static std::vector< magma_metrics_entry* >& metrics_entries()
+{
+    static std::vector< magma_metrics_entry* >* entries = new std::vector< magma_metrics_entry* >;
+    return *entries;
+}
+
+
+/******************************************************************************/
+uint64_t magma_metrics_nsec()
+{
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+/******************************************************************************/
+magma_metrics_entry* magma_metrics_register( const char* name )
+{
+    std::lock_guard< std::mutex > lock( metrics_mutex() );
+    std::vector< magma_metrics_entry* >& entries = metrics_entries();
+    for( size_t i = 0; i < entries.size(); ++i ) {
+        if ( strcmp( entries[i]->name, name ) == 0 ) {
+            return entries[i];
+        }
+    }
+    magma_metrics_entry* entry = new magma_metrics_entry;
+    entry->name  = name;
+    entry->calls = 0;
+    entry->nsec  = 0;
+    entry->flops = 0;
+    entries.push_back( entry );
+    return entry;
+}
+
+
+/******************************************************************************/
+void magma_metrics_alloc_( int kind, uint64_t bytes )
+{
+    g_alloc_count[ kind ].fetch_add( 1,     std::memory_order_relaxed );
+    g_alloc_bytes[ kind ].fetch_add( bytes, std::memory_order_relaxed );
+}
+
+
+/******************************************************************************/
+void magma_metrics_transfer_( int kind, uint64_t bytes )
+{
+    g_transfer_count[ kind ].fetch_add( 1,     std::memory_order_relaxed );
+    g_transfer_bytes[ kind ].fetch_add( bytes, std::memory_order_relaxed );
+}
+
+
+/******************************************************************************/
+// a pool thread ran a task for nsec
+void magma_metrics_pool_task_( uint64_t nsec )
+{
+    g_pool_tasks.fetch_add( 1, std::memory_order_relaxed );
+    g_pool_busy_nsec.fetch_add( nsec, std::memory_order_relaxed );
+}
+
+
+/******************************************************************************/
+// a pool thread existed for nsec
+void magma_metrics_pool_thread_( uint64_t nsec )
+{
+    g_pool_thread_nsec.fetch_add( nsec, std::memory_order_relaxed );
+}
+
+
+/******************************************************************************/
+// all counters as text or JSON
+static std::string metrics_format( bool json )
+{
+    char buf[ 1024 ];
+    std::string str;
+    double uptime = (magma_metrics_nsec() - g_start_nsec.load()) * 1e-9;
+
+    std::vector< magma_metrics_entry* > entries;
+    {
+        std::lock_guard< std::mutex > lock( metrics_mutex() );
+        entries = metrics_entries();
+    }
+    // most time first
+    std::stable_sort( entries.begin(), entries.end(),
+        []( const magma_metrics_entry* a, const magma_metrics_entry* b ) {
+            return a->nsec.load() > b->nsec.load();
+        });
+
+    if ( json ) {
+        snprintf( buf, sizeof(buf), "{\n\"enabled\": %s,\n\"time\": %.6f,\n\"routines\": [",
+                  (magma_metrics_on ? "true" : "false"), uptime );
+        str += buf;
+        const char* sep = "\n";
+        for( size_t i = 0; i < entries.size(); ++i ) {
+            uint64_t calls = entries[i]->calls.load();
+            if ( calls == 0 ) {
+                continue;
+            }
+            // precision is the letter after "magma_", if any
+            const char* name = entries[i]->name;
+            char prec = '-';
+            if ( strncmp( name, "magma_", 6 ) == 0 && strchr( "sdczh", name[6] ) != NULL ) {
+                prec = name[6];
+            }
+            snprintf( buf, sizeof(buf),
+                      "%s  {\"name\": \"%s\", \"precision\": \"%c\", \"calls\": %llu, "
+                      "\"time\": %.6f, \"flops\": %llu}",
+                      sep, name, prec, (unsigned long long) calls,
+                      entries[i]->nsec.load() * 1e-9,
+                      (unsigned long long) entries[i]->flops.load() );
+            str += buf;
+            sep = ",\n";
+        }
+        str += "\n],\n\"alloc\": {";
+        for( int k = 0; k < 3; ++k ) {
+            snprintf( buf, sizeof(buf), "%s\"%s\": {\"count\": %llu, \"bytes\": %llu}",
+                      (k > 0 ? ", " : ""), g_memory_names[k],
+                      (unsigned long long) g_alloc_count[k].load(),
+                      (unsigned long long) g_alloc_bytes[k].load() );
+            str += buf;
+        }
+        str += "},\n\"transfer\": {";
+        for( int k = 0; k < 3; ++k ) {
+            snprintf( buf, sizeof(buf), "%s\"%s\": {\"count\": %llu, \"bytes\": %llu}",
+                      (k > 0 ? ", " : ""), g_transfer_names[k],
+                      (unsigned long long) g_transfer_count[k].load(),
+                      (unsigned long long) g_transfer_bytes[k].load() );
+            str += buf;
+        }
+        snprintf( buf, sizeof(buf),
+                  "},\n\"thread_pool\": {\"tasks\": %llu, \"busy\": %.6f, \"thread_time\": %.6f}\n}\n",
+                  (unsigned long long) g_pool_tasks.load(),
+                  g_pool_busy_nsec.load() * 1e-9,
+                  g_pool_thread_nsec.load() * 1e-9 );
+        str += buf;
+    }
+    else {
+        snprintf( buf, sizeof(buf), "%% MAGMA metrics after %.3f s%s\n"
+                  "%% %-30s %10s %12s %12s %10s\n",
+                  uptime, (magma_metrics_on ? "" : " (disabled)"),
+                  "routine", "calls", "time (s)", "Gflop", "Gflop/s" );
+        str += buf;
+        for( size_t i = 0; i < entries.size(); ++i ) {
+            uint64_t calls = entries[i]->calls.load();
+            if ( calls == 0 ) {
+                continue;
+            }
+            double time  = entries[i]->nsec.load() * 1e-9;
+            double gflop = entries[i]->flops.load() * 1e-9;
+            snprintf( buf, sizeof(buf), "  %-30s %10llu %12.4f %12.3f %10.2f\n",
+                      entries[i]->name, (unsigned long long) calls, time, gflop,
+                      (time > 0 ? gflop / time : 0.) );
+            str += buf;
+        }
+        for( int k = 0; k < 3; ++k ) {
+            snprintf( buf, sizeof(buf), "%% alloc %-16s %10llu calls %16llu bytes\n",
+                      g_memory_names[k],
+                      (unsigned long long) g_alloc_count[k].load(),
+                      (unsigned long long) g_alloc_bytes[k].load() );
+            str += buf;
+        }
+        for( int k = 0; k < 3; ++k ) {
+            snprintf( buf, sizeof(buf), "%% copy  %-16s %10llu calls %16llu bytes\n",
+                      g_transfer_names[k],
+                      (unsigned long long) g_transfer_count[k].load(),
+                      (unsigned long long) g_transfer_bytes[k].load() );
+            str += buf;
+        }
+        double busy   = g_pool_busy_nsec.load() * 1e-9;
+        double thread = g_pool_thread_nsec.load() * 1e-9;
+        snprintf( buf, sizeof(buf), "%% thread pool: %llu tasks, busy %.3f s of %.3f s thread time (%.1f%%)\n",
+                  (unsigned long long) g_pool_tasks.load(), busy, thread,
+                  (thread > 0 ? 100. * busy / thread : 0.) );
+        str += buf;
+    }
+    return str;
+}
+
+
+/***************************************************************************//**
+    Enables or disables collecting performance metrics: per routine the
+    number of calls, wall time, and flops; bytes allocated and transferred
+    between host and device; and thread pool utilization.
+    Also enabled by setting the environment variable $MAGMA_METRICS.
+
+    @param[in]
+    enable  nonzero to enable, 0 to disable.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" void
+magma_metrics_enable( magma_int_t enable )
+{
+    magma_metrics_on = (enable != 0);
+}
+
+
+/***************************************************************************//**
+    @return nonzero if performance metrics are collected.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" magma_int_t
+magma_metrics_enabled( void )
+{
+    return magma_metrics_on;
+}
+
+
+/***************************************************************************//**
+    Sets all performance metrics to zero.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" void
+magma_metrics_reset( void )
+{
+    std::lock_guard< std::mutex > lock( metrics_mutex() );
+    std::vector< magma_metrics_entry* >& entries = metrics_entries();
+    for( size_t i = 0; i < entries.size(); ++i ) {
+        entries[i]->calls = 0;
+        entries[i]->nsec  = 0;
+        entries[i]->flops = 0;
+    }
+    for( int k = 0; k < 3; ++k ) {
+        g_alloc_count[k]    = 0;
+        g_alloc_bytes[k]    = 0;
+        g_transfer_count[k] = 0;
+        g_transfer_bytes[k] = 0;
+    }
+    g_pool_tasks       = 0;
+    g_pool_busy_nsec   = 0;
+    g_pool_thread_nsec = 0;
+    g_start_nsec       = magma_metrics_nsec();
+}
+
+
+/***************************************************************************//**
+    Writes a snapshot of the performance metrics into a buffer, e.g., for a
+    service to export them. Routines are sorted by time; times are inclusive
+    of nested MAGMA calls.
+
+    @param[out]
+    buffer  Array of dimension size. On output, the null-terminated
+            snapshot, truncated if it does not fit. May be NULL if size = 0.
+
+    @param[in]
+    size    Size of buffer in bytes.
+
+    @param[in]
+    json    0 for plain text, nonzero for JSON.
+
+    @return Length of the full snapshot, excluding the terminating null;
+            if >= size, the snapshot was truncated.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" magma_int_t
+magma_metrics_snapshot( char* buffer, size_t size, magma_int_t json )
+{
+    std::string str = metrics_format( json != 0 );
+    if ( size > 0 ) {
+        size_t len = std::min( size-1, str.size() );
+        memcpy( buffer, str.c_str(), len );
+        buffer[ len ] = '\0';
+    }
+    return str.size();
+}
+
+
+/***************************************************************************//**
+    Writes the performance metrics to a file.
+
+    @param[in]
+    filename    File to write; NULL for stdout.
+
+    @param[in]
+    json        0 for plain text, nonzero for JSON.
+
+    @return MAGMA_SUCCESS, or MAGMA_ERR if the file can't be opened.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" magma_int_t
+magma_metrics_dump( const char* filename, magma_int_t json )
+{
+    FILE* file = stdout;
+    if ( filename != NULL ) {
+        file = fopen( filename, "w" );
+        if ( file == NULL ) {
+            fprintf( stderr, "Can't open file '%s' for metrics\n", filename );
+            return MAGMA_ERR;
+        }
+    }
+    fputs( metrics_format( json != 0 ).c_str(), file );
+    if ( filename != NULL ) {
+        fclose( file );
+    }
+    else {
+        fflush( file );
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/******************************************************************************/
+static void metrics_atexit()
+{
+    size_t len = strlen( g_filename );
+    bool json = (len >= 5 && strcmp( g_filename + len - 5, ".json" ) == 0);
+    magma_metrics_dump( g_filename, json );
+}
+
+
+/******************************************************************************/
+// reads MAGMA_METRICS when the library is loaded
+static int metrics_setup()
+{
+    g_start_nsec = magma_metrics_nsec();
+    const char* env = getenv( "MAGMA_METRICS" );
+    if ( env != NULL && env[0] != '\0' && strcmp( env, "0" ) != 0 ) {
+        magma_metrics_on = 1;
+        if ( strcmp( env, "1" ) != 0 ) {
+            strncpy( g_filename, env, sizeof(g_filename)-1 );
+            g_filename[ sizeof(g_filename)-1 ] = '\0';
+            atexit( metrics_atexit );
+        }
+    }
+    return 0;
+}
+
+static int g_metrics_setup = metrics_setup();
@@ -0,0 +1,117 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_METRICS_H
+#define MAGMA_METRICS_H
+
+#include <stdint.h>
+
+// no <chrono> here: it breaks with the min and max macros of magma_internal.h
+#include <atomic>
+
+#include "magma_v2.h"
+#include "magma_flops.h"
+
+// =============================================================================
+// Internal interface of the performance metrics registry; the public
+// interface (magma_metrics_enable, _snapshot, _dump, ...) is in
+// magma_auxiliary.h. Updates are relaxed atomic adds, so they are safe from
+// any thread; when metrics are disabled each update costs one load and branch.
+
+extern int magma_metrics_on;
+
+// counters of one routine; times include nested MAGMA calls
+struct magma_metrics_entry
+{
+    const char*             name;
+    std::atomic< uint64_t > calls;
+    std::atomic< uint64_t > nsec;
+    std::atomic< uint64_t > flops;
+};
+
+// returns the entry of name, registering it on first use; name must be a
+// string literal (it is not copied)
+magma_metrics_entry* magma_metrics_register( const char* name );
+
+// kinds of memory for allocations and transfers
+enum {
+    MagmaMetricsDevice = 0,
+    MagmaMetricsHost   = 1,
+    MagmaMetricsPinned = 2
+};
+
+// kinds of transfers
+enum {
+    MagmaMetricsHostToDevice   = 0,
+    MagmaMetricsDeviceToHost   = 1,
+    MagmaMetricsDeviceToDevice = 2
+};
+
+void magma_metrics_alloc_   ( int kind, uint64_t bytes );
+void magma_metrics_transfer_( int kind, uint64_t bytes );
+void magma_metrics_pool_task_  ( uint64_t nsec );
+void magma_metrics_pool_thread_( uint64_t nsec );
+
+// monotonic time in nanoseconds
+uint64_t magma_metrics_nsec();
+
+static inline void magma_metrics_alloc( int kind, uint64_t bytes )
+{
+    if ( magma_metrics_on ) {
+        magma_metrics_alloc_( kind, bytes );
+    }
+}
+
+static inline void magma_metrics_transfer( int kind, uint64_t bytes )
+{
+    if ( magma_metrics_on ) {
+        magma_metrics_transfer_( kind, bytes );
+    }
+}
+
+
+/***************************************************************************//**
+    Counts a call of a routine, its wall time until the end of the scope,
+    and its flops. Use the MAGMA_METRICS macro, which registers the routine
+    once per call site.
+*******************************************************************************/
+class magma_metrics_scope
+{
+public:
+    magma_metrics_scope( magma_metrics_entry* entry, double flops ):
+        m_entry( magma_metrics_on ? entry : NULL ),
+        m_start( 0 )
+    {
+        if ( m_entry != NULL ) {
+            m_entry->calls.fetch_add( 1, std::memory_order_relaxed );
+            if ( flops > 0 ) {
+                m_entry->flops.fetch_add( (uint64_t) flops, std::memory_order_relaxed );
+            }
+            m_start = magma_metrics_nsec();
+        }
+    }
+
+    ~magma_metrics_scope()
+    {
+        if ( m_entry != NULL ) {
+            m_entry->nsec.fetch_add( magma_metrics_nsec() - m_start,
+                                     std::memory_order_relaxed );
+        }
+    }
+
+private:
+    magma_metrics_entry* m_entry;
+    uint64_t             m_start;
+};
+
+// e.g., MAGMA_METRICS( "magma_zgetrf", FLOPS_ZGETRF( m, n ) );
+#define MAGMA_METRICS( name, flops ) \
+    static magma_metrics_entry* magma_metrics_entry_ = magma_metrics_register( name ); \
+    magma_metrics_scope magma_metrics_scope_( magma_metrics_entry_, flops )
+
+#endif        //  #ifndef MAGMA_METRICS_H
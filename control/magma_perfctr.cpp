@@ -0,0 +1,434 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define MAGMA_PERFCTR_LINUX
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define MAGMA_PERFCTR_CPUID
+#endif
+
+#include <atomic>
+#include <mutex>
+
+#include "magma_perfctr.h"
+
+
+/*
+    Hardware counters of the calling thread, read with Linux perf_event_open,
+    so neither PAPI nor root is needed (perf_event_paranoid <= 2 suffices, as
+    only user-space events are counted). Each thread opens its counters on
+    its first read, as two groups:
+        cycles, instructions, LLC misses    generic hardware events
+        FP ops                              Intel FP_ARITH_INST_RETIRED
+                                            (Broadwell and later big cores),
+                                            weighted by flops per instruction;
+                                            -1 on other CPUs, or unless all
+                                            of its events open
+    Counts of worker threads (magma_thread_worker) are added to the thread
+    that created their region when each worker finishes, so a region timed
+    around a parallel section counts all of its threads.
+    Memory traffic is estimated as LLC misses times the cache line size;
+    it omits write-backs and hardware prefetches.
+    Counters that can't be opened, e.g., in containers, VMs without a
+    virtual PMU, or with perf_event_paranoid = 3, read as -1; a warning is
+    printed once. When the PMU multiplexes groups, values are scaled by the
+    fraction of time each group was counting.
+
+    Enabled by magma_perfctr_enable or the environment variable MAGMA_PERFCTR:
+        MAGMA_PERFCTR=0 or unset   disabled
+        MAGMA_PERFCTR=1            enabled
+*/
+
+int magma_perfctr_on = 0;
+
+static long long g_line_size = 64;
+
+
+/******************************************************************************/
+struct magma_perfctr_sum
+{
+    magma_perfctr_sum()
+    {
+        c.cycles       = 0;
+        c.instructions = 0;
+        c.llc_misses   = 0;
+        c.mem_bytes    = 0;
+        c.fp_ops       = 0;
+    }
+
+    std::mutex      mutex;
+    magma_perfctr_t c;
+};
+
+static thread_local magma_perfctr_sum t_perfctr_sum;
+
+magma_perfctr_sum* magma_perfctr_sum_current()
+{
+    return &t_perfctr_sum;
+}
+
+// sum += c; a counter unavailable in either is -1
+static void perfctr_add_counts( magma_perfctr_t& sum, const magma_perfctr_t& c )
+{
+    sum.cycles       = (sum.cycles       < 0 || c.cycles       < 0 ? -1 : sum.cycles       + c.cycles      );
+    sum.instructions = (sum.instructions < 0 || c.instructions < 0 ? -1 : sum.instructions + c.instructions);
+    sum.llc_misses   = (sum.llc_misses   < 0 || c.llc_misses   < 0 ? -1 : sum.llc_misses   + c.llc_misses  );
+    sum.mem_bytes    = (sum.mem_bytes    < 0 || c.mem_bytes    < 0 ? -1 : sum.mem_bytes    + c.mem_bytes   );
+    sum.fp_ops       = (sum.fp_ops       < 0 || c.fp_ops       < 0 ? -1 : sum.fp_ops       + c.fp_ops      );
+}
+
+void magma_perfctr_sum_add( magma_perfctr_sum* sum, const magma_perfctr_t& c )
+{
+    std::lock_guard< std::mutex > lock( sum->mutex );
+    perfctr_add_counts( sum->c, c );
+}
+
+
+/******************************************************************************/
+#if defined(MAGMA_PERFCTR_LINUX)
+
+const int MAX_GROUP_EVENTS = 8;
+
+enum {
+    CTR_CYCLES       = 0,
+    CTR_INSTRUCTIONS = 1,
+    CTR_LLC_MISSES   = 2
+};
+
+// FP_ARITH_INST_RETIRED (event 0xC7), umasks grouped by flops per
+// instruction: scalar; 128-bit double; 128-bit single and 256-bit double;
+// 256-bit single and 512-bit double; 512-bit single. FMA counts twice.
+static const struct {
+    uint64_t umask;
+    int      flops;
+} g_fp_events[] = {
+    { 0x03,  1 },
+    { 0x04,  2 },
+    { 0x18,  4 },
+    { 0x60,  8 },
+    { 0x80, 16 },
+};
+
+// events read together with one read() of the leader
+struct perfctr_group
+{
+    int fd;                              // leader; -1 if no event opened
+    int nevents;
+    int fds   [ MAX_GROUP_EVENTS ];
+    int target[ MAX_GROUP_EVENTS ];      // CTR_* index, or flops per event
+};
+
+// counters of one thread, closed when the thread exits
+class perfctr_thread
+{
+public:
+    perfctr_thread():
+        opened( false )
+    {
+        main.fd = fp.fd = -1;
+        main.nevents = fp.nevents = 0;
+    }
+
+    ~perfctr_thread()
+    {
+        for( int i = 0; i < main.nevents; ++i ) {
+            close( main.fds[i] );
+        }
+        for( int i = 0; i < fp.nevents; ++i ) {
+            close( fp.fds[i] );
+        }
+    }
+
+    bool          opened;
+    perfctr_group main;
+    perfctr_group fp;
+};
+
+static thread_local perfctr_thread t_perfctr;
+
+static std::atomic< int > g_warned( 0 );
+
+
+/******************************************************************************/
+// adds an event to group, making it the leader if it is the first;
+// returns 0 or errno
+static int perfctr_add( perfctr_group& group, uint32_t type, uint64_t config, int target )
+{
+    struct perf_event_attr attr;
+    memset( &attr, 0, sizeof(attr) );
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = (group.fd < 0);  // leader starts the group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP
+                        | PERF_FORMAT_TOTAL_TIME_ENABLED
+                        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    unsigned long flags = 0;
+    #ifdef PERF_FLAG_FD_CLOEXEC
+    flags = PERF_FLAG_FD_CLOEXEC;
+    #endif
+    int fd = (int) syscall( __NR_perf_event_open, &attr, 0, -1, group.fd, flags );
+    if ( fd < 0 ) {
+        return errno;
+    }
+    if ( group.fd < 0 ) {
+        group.fd = fd;
+    }
+    group.fds   [ group.nevents ] = fd;
+    group.target[ group.nevents ] = target;
+    group.nevents += 1;
+    return 0;
+}
+
+
+/******************************************************************************/
+static void perfctr_start( perfctr_group& group )
+{
+    if ( group.fd >= 0 ) {
+        ioctl( group.fd, PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP );
+        ioctl( group.fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+    }
+}
+
+
+/******************************************************************************/
+// FP_ARITH_INST_RETIRED exists only on Intel family 6 big cores from
+// Broadwell on; elsewhere raw event 0xC7 counts something else (or, on Atom
+// cores, has different umasks), so FP ops are left at -1.
+static bool perfctr_fp_arith()
+{
+    #if defined(MAGMA_PERFCTR_CPUID)
+    static const unsigned int models[] = {
+        0x3D, 0x47, 0x4F, 0x56,              // Broadwell
+        0x4E, 0x5E, 0x55,                    // Skylake, Skylake-X, Cascade Lake
+        0x8E, 0x9E, 0xA5, 0xA6,              // Kaby, Coffee, Comet Lake
+        0x66,                                // Cannon Lake
+        0x6A, 0x6C, 0x7D, 0x7E, 0xA7,        // Ice Lake, Rocket Lake
+        0x8C, 0x8D,                          // Tiger Lake
+        0x8F, 0xCF, 0xAD, 0xAE,              // Sapphire, Emerald, Granite Rapids
+        0x97, 0x9A, 0xB7, 0xBA, 0xBF,        // Alder, Raptor Lake
+        0xAA, 0xAC, 0xC5, 0xC6, 0xBD,        // Meteor, Arrow, Lunar Lake
+    };
+    unsigned int eax, ebx, ecx, edx;
+    if ( ! __get_cpuid( 0, &eax, &ebx, &ecx, &edx )
+         || memcmp( &ebx, "Genu", 4 ) != 0
+         || memcmp( &edx, "ineI", 4 ) != 0
+         || memcmp( &ecx, "ntel", 4 ) != 0
+         || ! __get_cpuid( 1, &eax, &ebx, &ecx, &edx ))
+    {
+        return false;
+    }
+    unsigned int family = (eax >> 8) & 0xf;
+    unsigned int model  = ((eax >> 4) & 0xf) | ((eax >> 12) & 0xf0);
+    if ( family != 6 ) {
+        return false;
+    }
+    for( size_t i = 0; i < sizeof(models)/sizeof(models[0]); ++i ) {
+        if ( model == models[i] ) {
+            return true;
+        }
+    }
+    #endif
+    return false;
+}
+
+
+/******************************************************************************/
+static void perfctr_open( perfctr_thread& t )
+{
+    t.opened = true;
+    static const uint64_t events[] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+    int err = 0;  // first error
+    for( int i = 0; i < 3; ++i ) {
+        int e = perfctr_add( t.main, PERF_TYPE_HARDWARE, events[i], i );  // i is CTR_*
+        if ( err == 0 ) {
+            err = e;
+        }
+    }
+    perfctr_start( t.main );
+
+    // FP ops are a sum over all the events, so either all open or none
+    if ( perfctr_fp_arith() ) {
+        int fp_err = 0;
+        for( size_t i = 0; i < sizeof(g_fp_events)/sizeof(g_fp_events[0]) && fp_err == 0; ++i ) {
+            fp_err = perfctr_add( t.fp, PERF_TYPE_RAW, 0xC7 | (g_fp_events[i].umask << 8),
+                                  g_fp_events[i].flops );
+        }
+        if ( fp_err != 0 ) {
+            for( int i = 0; i < t.fp.nevents; ++i ) {
+                close( t.fp.fds[i] );
+            }
+            t.fp.fd = -1;
+            t.fp.nevents = 0;
+            if ( err == 0 ) {
+                err = fp_err;
+            }
+        }
+        perfctr_start( t.fp );
+    }
+
+    if ( err != 0 && g_warned.exchange( 1 ) == 0 ) {
+        fprintf( stderr, "Warning: some hardware counters are unavailable, so they read as -1: %s (%d).%s\n",
+                 strerror( err ), err,
+                 (err == EACCES || err == EPERM
+                     ? " Check /proc/sys/kernel/perf_event_paranoid."
+                     : "") );
+    }
+}
+
+
+/******************************************************************************/
+// reads group's values, scaled for multiplexing; returns false on failure,
+// or if the group hasn't been counting yet, e.g., when the PMU has no room
+static bool perfctr_read_group( const perfctr_group& group, double* values )
+{
+    if ( group.fd < 0 ) {
+        return false;
+    }
+    uint64_t buf[ 3 + MAX_GROUP_EVENTS ];  // nr, time_enabled, time_running, values
+    ssize_t len = read( group.fd, buf, sizeof(buf) );
+    if ( len < (ssize_t) ((3 + group.nevents) * sizeof(uint64_t))
+         || buf[0] != (uint64_t) group.nevents
+         || buf[2] == 0 )
+    {
+        return false;
+    }
+    double scale = (double) buf[1] / (double) buf[2];
+    for( int i = 0; i < group.nevents; ++i ) {
+        values[i] = (double) buf[ 3+i ] * scale;
+    }
+    return true;
+}
+
+#endif  // MAGMA_PERFCTR_LINUX
+
+
+/***************************************************************************//**
+    Enables or disables reading hardware counters: magma_perfctr_read, and
+    the counters recorded with trace regions and timer regions.
+    Initially set by the environment variable $MAGMA_PERFCTR.
+
+    @param[in]
+    enable  nonzero to enable, 0 to disable.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" void
+magma_perfctr_enable( magma_int_t enable )
+{
+    magma_perfctr_on = (enable != 0);
+}
+
+
+/***************************************************************************//**
+    @return nonzero if hardware counters are read.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" magma_int_t
+magma_perfctr_enabled( void )
+{
+    return magma_perfctr_on;
+}
+
+
+/***************************************************************************//**
+    Reads the hardware counters of the calling thread, counting since the
+    thread's first read. Subtract two reads to get the counts of a region.
+    Includes the counts of MAGMA's worker threads in parallel regions the
+    calling thread created, once the workers finish; other threads it
+    launches, e.g., OpenMP threads in BLAS, are not counted.
+
+    @param[out]
+    counters    On output, the counter values; -1 for counters that are
+                unavailable, and all -1 if counters are disabled.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" void
+magma_perfctr_read( magma_perfctr_t* counters )
+{
+    counters->cycles       = -1;
+    counters->instructions = -1;
+    counters->llc_misses   = -1;
+    counters->mem_bytes    = -1;
+    counters->fp_ops       = -1;
+    if ( ! magma_perfctr_on ) {
+        return;
+    }
+
+    #if defined(MAGMA_PERFCTR_LINUX)
+    perfctr_thread& t = t_perfctr;
+    if ( ! t.opened ) {
+        perfctr_open( t );
+    }
+
+    double values[ MAX_GROUP_EVENTS ];
+    if ( perfctr_read_group( t.main, values )) {
+        for( int i = 0; i < t.main.nevents; ++i ) {
+            long long value = (long long) values[i];
+            switch ( t.main.target[i] ) {
+                case CTR_CYCLES:       counters->cycles       = value; break;
+                case CTR_INSTRUCTIONS: counters->instructions = value; break;
+                case CTR_LLC_MISSES:
+                    counters->llc_misses = value;
+                    counters->mem_bytes  = value * g_line_size;
+                    break;
+            }
+        }
+    }
+    if ( perfctr_read_group( t.fp, values )) {
+        double flops = 0;
+        for( int i = 0; i < t.fp.nevents; ++i ) {
+            flops += t.fp.target[i] * values[i];
+        }
+        counters->fp_ops = (long long) flops;
+    }
+    #endif
+
+    std::lock_guard< std::mutex > lock( t_perfctr_sum.mutex );
+    perfctr_add_counts( *counters, t_perfctr_sum.c );
+}
+
+
+/******************************************************************************/
+// reads MAGMA_PERFCTR when the library is loaded
+static int perfctr_setup()
+{
+    #if defined(_SC_LEVEL3_CACHE_LINESIZE)
+    long line = sysconf( _SC_LEVEL3_CACHE_LINESIZE );
+    if ( line > 0 ) {
+        g_line_size = line;
+    }
+    #endif
+    const char* env = getenv( "MAGMA_PERFCTR" );
+    if ( env != NULL && env[0] != '\0' && strcmp( env, "0" ) != 0 ) {
+        magma_perfctr_on = 1;
+    }
+    return 0;
+}
+
+static int g_perfctr_setup = perfctr_setup();
@@ -0,0 +1,42 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_PERFCTR_H
+#define MAGMA_PERFCTR_H
+
+#include "magma_v2.h"
+
+// =============================================================================
+// Internal interface of the hardware counters; the public interface
+// (magma_perfctr_enable, _enabled, _read) is in magma_auxiliary.h.
+// When counters are disabled, each check costs one load and branch.
+
+extern int magma_perfctr_on;
+
+// c = end - start, per counter; unavailable counters (-1) stay -1
+static inline void magma_perfctr_diff(
+    const magma_perfctr_t& start, const magma_perfctr_t& end, magma_perfctr_t& c )
+{
+    c.cycles       = (start.cycles       < 0 || end.cycles       < 0 ? -1 : end.cycles       - start.cycles      );
+    c.instructions = (start.instructions < 0 || end.instructions < 0 ? -1 : end.instructions - start.instructions);
+    c.llc_misses   = (start.llc_misses   < 0 || end.llc_misses   < 0 ? -1 : end.llc_misses   - start.llc_misses  );
+    c.mem_bytes    = (start.mem_bytes    < 0 || end.mem_bytes    < 0 ? -1 : end.mem_bytes    - start.mem_bytes   );
+    c.fp_ops       = (start.fp_ops       < 0 || end.fp_ops       < 0 ? -1 : end.fp_ops       - start.fp_ops      );
+}
+
+// Counts of finished worker threads (see magma_thread_worker), added to the
+// thread that created their region, so that thread's reads include them.
+struct magma_perfctr_sum;
+
+// the calling thread's sum
+magma_perfctr_sum* magma_perfctr_sum_current();
+
+// adds counts c of a worker to sum; unavailable counters (-1) make the sum -1
+void magma_perfctr_sum_add( magma_perfctr_sum* sum, const magma_perfctr_t& c );
+
+#endif        //  #ifndef MAGMA_PERFCTR_H
@@ -0,0 +1,477 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) && ! defined(MAGMA_NOAFFINITY)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#include <unistd.h>
+#define MAGMA_BUDGET_AFFINITY
+#elif defined(_MSC_VER)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "magma_internal.h"
+#include "magma_thread_budget.h"
+#include "magma_perfctr.h"
+
+
+/*
+    Thread budget manager. Every thread has a budget of CPUs: application
+    threads share the root budget, the CPUs in the process's affinity mask;
+    a MAGMA worker thread's budget is the one CPU it is bound to, and a CPU
+    queue's thread's budget is the CPUs reserved for the queue.
+    A magma_thread_region reserves free CPUs of its creator's budget, within
+    the creator's own affinity mask, and releases them when it ends. So
+    concurrent regions, e.g., from several application threads, get disjoint
+    CPUs, and nested regions, e.g., OpenMP or a multithreaded BLAS inside a
+    bulge-chasing thread, get only their worker's CPU instead of all cores.
+
+    Decisions are reported to the callback set by magma_thread_budget_set_log,
+    or, with the environment variable MAGMA_THREAD_LOG:
+        MAGMA_THREAD_LOG=0 or unset   no log
+        MAGMA_THREAD_LOG=1            log to stderr
+        MAGMA_THREAD_LOG=file         log to file
+*/
+
+struct magma_thread_budget
+{
+    std::vector< int >    cpus;
+    std::vector< char >   taken;         // cpus[i] is reserved by a nested region
+    magma_thread_budget*  parent;
+    std::vector< size_t > parent_index;  // indices in parent->cpus reserved by this
+};
+
+static thread_local magma_thread_budget* t_budget = NULL;
+
+static magma_thread_log_t g_log_callback  = NULL;
+static void*              g_log_user_data = NULL;
+
+// never destroyed, so they can be used at exit and from any thread
+static std::mutex& budget_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+
+/******************************************************************************/
+static void budget_log_file( const char* message, void* user_data )
+{
+    FILE* file = (FILE*) user_data;
+    fprintf( file, "%% magma thread budget: %s\n", message );
+    fflush( file );
+}
+
+
+/******************************************************************************/
+// root budget: the CPUs of the process's affinity mask
+static magma_thread_budget* budget_root()
+{
+    static magma_thread_budget* root = NULL;
+    static std::once_flag once;
+    std::call_once( once, [] {
+        root = new magma_thread_budget;
+        root->parent = NULL;
+        #if defined(MAGMA_BUDGET_AFFINITY)
+        cpu_set_t mask;
+        CPU_ZERO( &mask );
+        if ( sched_getaffinity( getpid(), sizeof(mask), &mask ) == 0 ) {
+            for( int cpu = 0; cpu < CPU_SETSIZE; ++cpu ) {
+                if ( CPU_ISSET( cpu, &mask )) {
+                    root->cpus.push_back( cpu );
+                }
+            }
+        }
+        #endif
+        if ( root->cpus.empty() ) {
+            #if defined(_MSC_VER)
+            SYSTEM_INFO sysinfo;
+            GetSystemInfo( &sysinfo );
+            long ncores = sysinfo.dwNumberOfProcessors;
+            #else
+            long ncores = sysconf( _SC_NPROCESSORS_ONLN );
+            #endif
+            for( int cpu = 0; cpu < max( 1L, ncores ); ++cpu ) {
+                root->cpus.push_back( cpu );
+            }
+        }
+        root->taken.assign( root->cpus.size(), 0 );
+
+        const char* env = getenv( "MAGMA_THREAD_LOG" );
+        if ( g_log_callback == NULL && env != NULL && env[0] != '\0'
+             && strcmp( env, "0" ) != 0 )
+        {
+            FILE* file = stderr;
+            if ( strcmp( env, "1" ) != 0 ) {
+                file = fopen( env, "a" );
+                if ( file == NULL ) {
+                    fprintf( stderr, "Error: can't open $MAGMA_THREAD_LOG file '%s'\n", env );
+                }
+            }
+            if ( file != NULL ) {
+                g_log_callback  = budget_log_file;
+                g_log_user_data = file;
+            }
+        }
+    });
+    return root;
+}
+
+
+/******************************************************************************/
+// formats cpus as ranges, e.g., "0-7,16-23"
+static std::string budget_cpu_list( const std::vector< int >& cpus )
+{
+    std::string str;
+    char buf[ 32 ];
+    for( size_t i = 0; i < cpus.size(); ) {
+        size_t j = i;
+        while ( j+1 < cpus.size() && cpus[j+1] == cpus[j] + 1 ) {
+            ++j;
+        }
+        if ( j > i )
+            snprintf( buf, sizeof(buf), "%s%d-%d", (i > 0 ? "," : ""), cpus[i], cpus[j] );
+        else
+            snprintf( buf, sizeof(buf), "%s%d", (i > 0 ? "," : ""), cpus[i] );
+        str += buf;
+        i = j + 1;
+    }
+    return str;
+}
+
+
+/******************************************************************************/
+// Caller holds the mutex.
+static void budget_log( const char* format, ... )
+{
+    if ( g_log_callback == NULL ) {
+        return;
+    }
+    char message[ 1024 ];
+    va_list args;
+    va_start( args, format );
+    vsnprintf( message, sizeof(message), format, args );
+    va_end( args );
+    g_log_callback( message, g_log_user_data );
+}
+
+
+/******************************************************************************/
+// budget of the calling thread
+static magma_thread_budget* budget_current()
+{
+    magma_thread_budget* root = budget_root();
+    return (t_budget != NULL ? t_budget : root);
+}
+
+
+/******************************************************************************/
+magma_blas_threads_scope::magma_blas_threads_scope( magma_int_t threads ):
+    m_omp_save( 0 ),
+    m_mkl_save( 0 ),
+    m_set( threads >= 1 )
+{
+    if ( m_set ) {
+        // the OpenMP ICV and MKL's local setting are per thread
+        #if defined(MAGMA_WITH_MKL)
+        m_mkl_save = mkl_set_num_threads_local( int(threads) );
+        #endif
+        #if defined(_OPENMP)
+        m_omp_save = omp_get_max_threads();
+        omp_set_num_threads( int(threads) );
+        #endif
+    }
+}
+
+magma_blas_threads_scope::~magma_blas_threads_scope()
+{
+    if ( m_set ) {
+        #if defined(MAGMA_WITH_MKL)
+        mkl_set_num_threads_local( m_mkl_save );  // 0 reverts to global setting
+        #endif
+        #if defined(_OPENMP)
+        omp_set_num_threads( m_omp_save );
+        #endif
+    }
+}
+
+
+/******************************************************************************/
+magma_thread_region::magma_thread_region( const char* name, magma_int_t nthreads ):
+    m_name( name ),
+    m_nthreads( 1 ),
+    m_parent( NULL ),
+    m_budget( NULL ),
+    m_perfctr_sum( magma_perfctr_on ? magma_perfctr_sum_current() : NULL )
+{
+    // application threads may be restricted to some of the process's CPUs
+    #if defined(MAGMA_BUDGET_AFFINITY)
+    cpu_set_t mask;
+    CPU_ZERO( &mask );
+    bool have_mask = (t_budget == NULL
+                      && sched_getaffinity( 0, sizeof(mask), &mask ) == 0);
+    #endif
+
+    std::lock_guard< std::mutex > lock( budget_mutex() );
+    m_parent = budget_current();
+
+    magma_thread_budget* budget = new magma_thread_budget;
+    budget->parent = m_parent;
+    size_t nfree = 0;
+    for( size_t i = 0; i < m_parent->cpus.size(); ++i ) {
+        if ( m_parent->taken[i] ) {
+            continue;
+        }
+        #if defined(MAGMA_BUDGET_AFFINITY)
+        if ( have_mask && ! CPU_ISSET( m_parent->cpus[i], &mask )) {
+            continue;
+        }
+        #endif
+        nfree += 1;
+        if ( magma_int_t( budget->cpus.size() ) < nthreads ) {
+            budget->cpus.push_back( m_parent->cpus[i] );
+            budget->parent_index.push_back( i );
+            m_parent->taken[i] = 1;
+        }
+    }
+
+    if ( budget->cpus.empty() ) {
+        delete budget;
+        budget_log( "%s: wants %lld threads, gets 1 unbound thread; "
+                    "no free CPUs in budget of %lld",
+                    m_name, (long long) nthreads, (long long) m_parent->cpus.size() );
+    }
+    else {
+        budget->taken.assign( budget->cpus.size(), 0 );
+        m_budget   = budget;
+        m_nthreads = budget->cpus.size();
+        budget_log( "%s: wants %lld threads, gets %lld, CPUs %s; %lld of %lld free",
+                    m_name, (long long) nthreads, (long long) m_nthreads,
+                    budget_cpu_list( budget->cpus ).c_str(),
+                    (long long) nfree, (long long) m_parent->cpus.size() );
+    }
+}
+
+magma_thread_region::~magma_thread_region()
+{
+    std::lock_guard< std::mutex > lock( budget_mutex() );
+    if ( m_budget != NULL ) {
+        for( size_t i = 0; i < m_budget->parent_index.size(); ++i ) {
+            m_parent->taken[ m_budget->parent_index[i] ] = 0;
+        }
+        budget_log( "%s: releases CPUs %s", m_name,
+                    budget_cpu_list( m_budget->cpus ).c_str() );
+        delete m_budget;
+    }
+}
+
+int magma_thread_region::cpu( magma_int_t id ) const
+{
+    #if defined(MAGMA_BUDGET_AFFINITY)
+    if ( m_budget != NULL && id >= 0 && id < magma_int_t( m_budget->cpus.size() )) {
+        return m_budget->cpus[ id ];
+    }
+    #endif
+    return -1;
+}
+
+
+/******************************************************************************/
+magma_thread_worker::magma_thread_worker( const magma_thread_region& region, magma_int_t id ):
+    m_blas( 1 ),
+    m_budget_save( t_budget ),
+    m_budget( new magma_thread_budget ),
+    m_affinity_save( NULL ),
+    m_perfctr_sum( NULL )
+{
+    // the creating thread's own counters already include worker id 0
+    if ( magma_perfctr_on && region.m_perfctr_sum != NULL
+         && region.m_perfctr_sum != magma_perfctr_sum_current() )
+    {
+        m_perfctr_sum = region.m_perfctr_sum;
+        magma_perfctr_read( &m_perfctr );
+    }
+
+    // nested regions get only this worker's CPU, or none if it isn't bound
+    m_budget->parent = region.m_budget;
+    int cpu = region.cpu( id );
+    if ( cpu >= 0 ) {
+        m_budget->cpus.push_back( cpu );
+        m_budget->taken.push_back( 0 );
+    }
+    t_budget = m_budget;
+
+    #if defined(MAGMA_BUDGET_AFFINITY)
+    if ( cpu >= 0 ) {
+        cpu_set_t* save = new cpu_set_t;
+        cpu_set_t mask;
+        if ( sched_getaffinity( 0, sizeof(*save), save ) == 0 ) {
+            CPU_ZERO( &mask );
+            CPU_SET( cpu, &mask );
+            if ( sched_setaffinity( 0, sizeof(mask), &mask ) == 0 ) {
+                m_affinity_save = save;
+                save = NULL;
+            }
+            else {
+                std::lock_guard< std::mutex > lock( budget_mutex() );
+                budget_log( "%s: worker %lld can't bind to CPU %d",
+                            region.m_name, (long long) id, cpu );
+            }
+        }
+        delete save;
+    }
+    #endif
+}
+
+magma_thread_worker::~magma_thread_worker()
+{
+    if ( m_perfctr_sum != NULL && magma_perfctr_on ) {
+        magma_perfctr_t end;
+        magma_perfctr_read( &end );
+        magma_perfctr_diff( m_perfctr, end, m_perfctr );
+        magma_perfctr_sum_add( m_perfctr_sum, m_perfctr );
+    }
+    #if defined(MAGMA_BUDGET_AFFINITY)
+    if ( m_affinity_save != NULL ) {
+        cpu_set_t* save = (cpu_set_t*) m_affinity_save;
+        sched_setaffinity( 0, sizeof(*save), save );
+        delete save;
+    }
+    #endif
+    t_budget = m_budget_save;
+    delete m_budget;
+}
+
+
+/******************************************************************************/
+magma_thread_owner::magma_thread_owner( const magma_thread_region& region ):
+    m_blas( region.num_threads() ),
+    m_budget_save( t_budget ),
+    m_budget( NULL ),
+    m_affinity_save( NULL )
+{
+    // without CPUs, nested regions get 1 unbound thread, as in an unbound worker
+    if ( region.m_budget != NULL ) {
+        t_budget = region.m_budget;
+    }
+    else {
+        m_budget = new magma_thread_budget;
+        m_budget->parent = NULL;
+        t_budget = m_budget;
+    }
+
+    #if defined(MAGMA_BUDGET_AFFINITY)
+    if ( region.m_budget != NULL ) {
+        cpu_set_t* save = new cpu_set_t;
+        cpu_set_t mask;
+        if ( sched_getaffinity( 0, sizeof(*save), save ) == 0 ) {
+            CPU_ZERO( &mask );
+            for( size_t i = 0; i < region.m_budget->cpus.size(); ++i ) {
+                CPU_SET( region.m_budget->cpus[i], &mask );
+            }
+            if ( sched_setaffinity( 0, sizeof(mask), &mask ) == 0 ) {
+                m_affinity_save = save;
+                save = NULL;
+            }
+            else {
+                std::lock_guard< std::mutex > lock( budget_mutex() );
+                budget_log( "%s: owner can't bind to CPUs %s", region.m_name,
+                            budget_cpu_list( region.m_budget->cpus ).c_str() );
+            }
+        }
+        delete save;
+    }
+    #endif
+}
+
+magma_thread_owner::~magma_thread_owner()
+{
+    #if defined(MAGMA_BUDGET_AFFINITY)
+    if ( m_affinity_save != NULL ) {
+        cpu_set_t* save = (cpu_set_t*) m_affinity_save;
+        sched_setaffinity( 0, sizeof(*save), save );
+        delete save;
+    }
+    #endif
+    t_budget = m_budget_save;
+    delete m_budget;
+}
+
+
+/***************************************************************************//**
+    Sets a callback that receives the thread budget manager's decisions:
+    how many threads and which CPUs each parallel region gets, and when it
+    releases them. Replaces logging set by $MAGMA_THREAD_LOG.
+
+    @param[in]
+    callback    Function called with each message; NULL to disable logging.
+                Calls are serialized.
+
+    @param[in]
+    user_data   Passed to callback.
+
+    @ingroup magma_thread
+*******************************************************************************/
+extern "C" void
+magma_thread_budget_set_log( magma_thread_log_t callback, void* user_data )
+{
+    budget_root();  // reads $MAGMA_THREAD_LOG first, so it doesn't override this
+    std::lock_guard< std::mutex > lock( budget_mutex() );
+    g_log_callback  = callback;
+    g_log_user_data = user_data;
+}
+
+
+/***************************************************************************//**
+    @return Number of CPUs in the calling thread's budget that no parallel
+    region has reserved; at least 1. For application threads, the budget is
+    the process's affinity mask; for MAGMA worker threads, the CPU the worker
+    is bound to.
+
+    @ingroup magma_thread
+*******************************************************************************/
+extern "C" magma_int_t
+magma_thread_budget_available( void )
+{
+    std::lock_guard< std::mutex > lock( budget_mutex() );
+    magma_thread_budget* budget = budget_current();
+    magma_int_t nfree = 0;
+    for( size_t i = 0; i < budget->taken.size(); ++i ) {
+        nfree += ! budget->taken[i];
+    }
+    return max( 1, nfree );
+}
+
+
+/******************************************************************************/
+// Number of CPUs in the calling thread's budget, reserved or not; at least 1.
+magma_int_t magma_thread_budget_size()
+{
+    std::lock_guard< std::mutex > lock( budget_mutex() );
+    return max( 1, magma_int_t( budget_current()->cpus.size() ));
+}
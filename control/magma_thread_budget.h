@@ -0,0 +1,130 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_THREAD_BUDGET_H
+#define MAGMA_THREAD_BUDGET_H
+
+#include "magma_v2.h"
+
+// =============================================================================
+// Internal interface of the thread budget manager; the public interface
+// (magma_thread_budget_set_log, _available) is in magma_auxiliary.h.
+// Uses no STL, so it can be included after magma_internal.h.
+//
+// A parallel region reserves CPUs from the budget of the thread creating it:
+// the process's affinity mask for application threads, or the CPU a worker
+// is bound to for MAGMA worker threads. Concurrent regions get disjoint CPUs,
+// so nested and concurrent MAGMA calls don't oversubscribe cores.
+// Example:
+//
+//     magma_thread_region region( "hetrd_hb2st", magma_get_parallel_numthreads() );
+//     nthread = region.num_threads();  // may be fewer than requested
+//     ... launch nthread-1 pthreads; each, and the caller as id 0, does:
+//         magma_thread_worker worker( region, id );  // bind, BLAS single-threaded
+//         ... work ...
+//     ... join pthreads; region's CPUs are released at end of its scope
+
+struct magma_thread_budget;
+struct magma_perfctr_sum;
+
+// number of CPUs in the calling thread's budget, reserved or not; at least 1
+magma_int_t magma_thread_budget_size();
+
+
+/***************************************************************************//**
+    Sets the number of BLAS and OpenMP threads of the calling thread only,
+    restoring them at the end of the scope. Unlike magma_set_lapack_numthreads,
+    this doesn't change the setting of other threads, so it is safe when
+    several threads call MAGMA concurrently.
+*******************************************************************************/
+class magma_blas_threads_scope
+{
+public:
+    explicit magma_blas_threads_scope( magma_int_t threads );
+    ~magma_blas_threads_scope();
+
+private:
+    int m_omp_save;
+    int m_mkl_save;
+    bool m_set;
+};
+
+
+/***************************************************************************//**
+    Reserves up to nthreads CPUs, disjoint from the CPUs of other active
+    regions, for the duration of its scope. Gets at least 1 thread.
+*******************************************************************************/
+class magma_thread_region
+{
+public:
+    magma_thread_region( const char* name, magma_int_t nthreads );
+    ~magma_thread_region();
+
+    magma_int_t num_threads() const { return m_nthreads; }
+
+    // CPU worker id is bound to, or -1 if it isn't bound
+    int cpu( magma_int_t id ) const;
+
+private:
+    friend class magma_thread_worker;
+    friend class magma_thread_owner;
+
+    const char*          m_name;
+    magma_int_t          m_nthreads;
+    magma_thread_budget* m_parent;
+    magma_thread_budget* m_budget;  // CPUs reserved; NULL if none
+    magma_perfctr_sum*   m_perfctr_sum;  // creating thread's; NULL if counters disabled
+};
+
+
+/***************************************************************************//**
+    In worker thread id of region (the thread creating the region is
+    usually id 0), binds the thread to its CPU and makes its BLAS
+    single-threaded; nested regions get their CPUs from the worker's CPU.
+    Restores the thread's affinity, BLAS threads, and budget at the end of
+    the scope. If hardware counters are enabled, adds the worker's counts to
+    the thread that created the region, unless that is the calling thread.
+*******************************************************************************/
+class magma_thread_worker
+{
+public:
+    magma_thread_worker( const magma_thread_region& region, magma_int_t id );
+    ~magma_thread_worker();
+
+private:
+    magma_blas_threads_scope m_blas;
+    magma_thread_budget*     m_budget_save;
+    magma_thread_budget*     m_budget;
+    void*                    m_affinity_save;  // cpu_set_t; NULL if not bound
+    magma_perfctr_sum*       m_perfctr_sum;    // NULL if not counted
+    magma_perfctr_t          m_perfctr;        // counters at start
+};
+
+
+/***************************************************************************//**
+    In a thread that runs whole stages on the region's CPUs, e.g., the thread
+    of a CPU queue, makes all of the region's CPUs the thread's budget, so
+    parallel regions in the stages divide them, restricts the thread's
+    affinity to them, and sets its BLAS threads to their number.
+    Restores the thread's affinity, BLAS threads, and budget at the end of
+    the scope.
+*******************************************************************************/
+class magma_thread_owner
+{
+public:
+    explicit magma_thread_owner( const magma_thread_region& region );
+    ~magma_thread_owner();
+
+private:
+    magma_blas_threads_scope m_blas;
+    magma_thread_budget*     m_budget_save;
+    magma_thread_budget*     m_budget;         // NULL if region has CPUs
+    void*                    m_affinity_save;  // cpu_set_t; NULL if not bound
+};
+
+#endif        //  #ifndef MAGMA_THREAD_BUDGET_H
@@ -9,6 +9,7 @@
        @author Mark Gates
 */
 #include "magma_internal.h"
+#include "magma_thread_budget.h"
 
 #if defined(_OPENMP)
 #include <omp.h>
@@ -32,12 +33,17 @@
 
     If MAGMA_NUM_THREADS is set, this returns
         min( num_cores, MAGMA_NUM_THREADS );
+    else if the tuning database has "num_threads" (see magma_tune_get),
+    this returns min( num_cores, num_threads );
     else if MAGMA is compiled with OpenMP, this queries OpenMP and returns
         min( num_cores, OMP_NUM_THREADS );
     else this returns num_cores.
 
     For the number of cores, if MAGMA is compiled with hwloc, this queries hwloc;
     else it queries sysconf (on Unix) or GetSystemInfo (on Windows).
+    It is further limited to the calling thread's thread budget: the CPUs in
+    the process's affinity mask, or 1 inside a MAGMA worker thread, so nested
+    parallel sections don't oversubscribe cores.
 
     @sa magma_get_lapack_numthreads
     @sa magma_set_lapack_numthreads
@@ -71,8 +77,9 @@ magma_int_t magma_get_parallel_numthreads()
         ncores = sysconf( _SC_NPROCESSORS_ONLN );
         #endif
     }
+    ncores = min( ncores, magma_thread_budget_size() );
 
-    // query MAGMA_NUM_THREADS or OpenMP
+    // query MAGMA_NUM_THREADS, tuning database, or OpenMP
     const char *threads_str = getenv("MAGMA_NUM_THREADS");
     magma_int_t threads = 0;
     if ( threads_str != NULL ) {
@@ -84,12 +91,12 @@ magma_int_t magma_get_parallel_numthreads()
                      threads_str, (long long) threads );
         }
     }
+    else if ( magma_tune_get( "num_threads", '*', -1, -1, &threads )) {
+        // threads set from tuning database
+    }
     else {
         #if defined(_OPENMP)
-        #pragma omp parallel
-        {
-            threads = omp_get_num_threads();
-        }
+        threads = omp_get_max_threads();
         #else
             threads = ncores;
         #endif
@@ -14,6 +14,7 @@
 #include <stdio.h>
 
 #include "magma_v2.h"
+#include "magma_perfctr.h"
 
 typedef double    magma_timer_t;
 typedef long long magma_flops_t;
@@ -139,11 +140,14 @@ static inline magma_timer_t timer_sync_stop( magma_timer_t &t, magma_queue_t que
     @param[out]
     flops   On output, set to current flop counter.
     
-    Requires global gPAPI_flops_set to be setup by testing/magma_util.cpp
-    Note that newer CPUs may not support flop counts; see
+    With HAVE_PAPI, requires global gPAPI_flops_set to be setup by
+    testing/magma_util.cpp. Note that newer CPUs may not support flop counts; see
     https://icl.cs.utk.edu/projects/papi/wiki/PAPITopics:SandyFlops
     
-    If ENABLE_TIMER and HAVE_PAPI are not both defined, does nothing.
+    Without HAVE_PAPI, reads the calling thread's fp_ops hardware counter,
+    if enabled by $MAGMA_PERFCTR (see magma_perfctr_read).
+    
+    If ENABLE_TIMER is not defined, does nothing.
     
     @ingroup magma_timer
 *******************************************************************************/
@@ -151,6 +155,10 @@ static inline void flops_start( magma_flops_t &flops )
 {
     #if defined(ENABLE_TIMER) && defined(HAVE_PAPI)
     PAPI_read( gPAPI_flops_set, &flops );
+    #elif defined(ENABLE_TIMER)
+    magma_perfctr_t c;
+    magma_perfctr_read( &c );
+    flops = c.fp_ops;
     #endif
 }
 
@@ -162,7 +170,7 @@ static inline void flops_start( magma_flops_t &flops )
     
     @return flops, so you can sum up; see timer_stop().
     
-    If ENABLE_TIMER and HAVE_PAPI are not both defined, returns 0.
+    If ENABLE_TIMER is not defined, or flops aren't counted, returns 0.
     
     @ingroup magma_timer
 *******************************************************************************/
@@ -173,12 +181,92 @@ static inline magma_flops_t flops_stop( magma_flops_t &flops )
     PAPI_read( gPAPI_flops_set, &end );
     flops = end - flops;
     return flops;
+    #elif defined(ENABLE_TIMER)
+    magma_perfctr_t c;
+    magma_perfctr_read( &c );
+    flops = (flops < 0 || c.fp_ops < 0 ? 0 : c.fp_ops - flops);
+    return flops;
     #else
     return 0;
     #endif
 }
 
 
+/***************************************************************************//**
+    @param[out]
+    c       On output, set to the calling thread's hardware counters.
+    
+    If ENABLE_TIMER is not defined, does nothing.
+    
+    @ingroup magma_timer
+*******************************************************************************/
+static inline void perfctr_start( magma_perfctr_t &c )
+{
+    #if defined(ENABLE_TIMER)
+    magma_perfctr_read( &c );
+    #endif
+}
+
+
+/***************************************************************************//**
+    @param[in,out]
+    c       On input, counters when perfctr_start() was called.
+            On output, set to (current counters - start counters);
+            -1 for unavailable counters.
+    
+    Counts the calling thread and the MAGMA worker threads of parallel
+    regions it creates (see magma_perfctr_read), not BLAS or OpenMP threads;
+    to see each thread's share, enable tracing as well (see trace.h), which
+    records counters with each thread's regions.
+    
+    If ENABLE_TIMER is not defined, does nothing.
+    
+    @ingroup magma_timer
+*******************************************************************************/
+static inline void perfctr_stop( magma_perfctr_t &c )
+{
+    #if defined(ENABLE_TIMER)
+    magma_perfctr_t end;
+    magma_perfctr_read( &end );
+    magma_perfctr_diff( c, end, c );
+    #endif
+}
+
+
+/***************************************************************************//**
+    If ENABLE_TIMER is defined and hardware counters are enabled, prints
+    counters c of a region that took time t seconds, e.g.,
+    
+        magma_perfctr_t ctr;
+        timer_start( time );
+        perfctr_start( ctr );
+        ...do timed operations...
+        perfctr_stop( ctr );
+        timer_stop( time );
+        perfctr_printf( "zhetrd_hb2st", ctr, time );
+    
+    else does nothing (returns 0).
+    
+    @ingroup magma_timer
+*******************************************************************************/
+static inline int perfctr_printf( const char* label, const magma_perfctr_t &c, magma_timer_t t )
+{
+    int len = 0;
+    #if defined(ENABLE_TIMER)
+    if ( magma_perfctr_on ) {
+        len = printf( "  %s counters: cycles %lld, IPC %.2f, LLC misses %lld, "
+                      "%.2f GB/s, %.2f Gflop/s\n",
+                      label, c.cycles,
+                      (c.cycles > 0 && c.instructions >= 0 ? double(c.instructions) / c.cycles : -1.),
+                      c.llc_misses,
+                      (t > 0 && c.mem_bytes >= 0 ? c.mem_bytes / t * 1e-9 : -1.),
+                      (t > 0 && c.fp_ops    >= 0 ? c.fp_ops    / t * 1e-9 : -1.) );
+    }
+    #endif
+    return len;
+}
+
+
 /***************************************************************************//**
     If ENABLE_TIMER is defined, same as printf;
     else does nothing (returns 0).
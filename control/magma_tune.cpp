@@ -0,0 +1,499 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "magma_tune.h"
+
+
+/*
+    Tuning database: values of tuning parameters (block sizes, crossover
+    points, thread counts, ...) measured on a particular machine, which the
+    magma_get_* getters return instead of their built-in tables.
+
+    Each entry is keyed on the parameter, precision, shape bucket (m, n),
+    device architecture, number of CPU cores, and CPU model; any key may be
+    the wildcard '*'. Sizes m and n are rounded up to a power of 2, so an
+    entry for n = 1024 applies to 512 < n <= 1024. Of the entries that match
+    a lookup, the one with the most non-wildcard keys wins; among equals,
+    the last one set or loaded.
+
+    File format (see magma_tune_save): a version line, then one entry per
+    line; '#' starts a comment.
+
+        magma-tune 1
+        # param      prec  m     n     arch  cores  cpu                 value
+        getrf_nb     d     4096  4096  800   32     AMD_EPYC_7502_...   256
+        bulge_grsiz  *     *     *     *     *      *                   2
+
+    The file named by the environment variable MAGMA_TUNE_FILE is loaded by
+    the first lookup; testing/testing_tune writes such files.
+*/
+
+static const int tune_version = 1;
+
+// -1 is the wildcard for numeric keys, "*" for strings, '*' for precision
+struct tune_entry
+{
+    std::string param;
+    char        precision;
+    long long   m;
+    long long   n;
+    long long   arch;
+    long long   cores;
+    std::string cpu;
+    magma_int_t value;
+};
+
+static std::atomic< int > g_tune_count( 0 );
+
+// never destroyed, so they can be used at exit and from any thread
+static std::mutex& tune_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+static std::vector< tune_entry >& tune_entries()
+{
+    static std::vector< tune_entry >* entries = new std::vector< tune_entry >;
+    return *entries;
+}
+
+
+/******************************************************************************/
+// rounds x up to a power of 2; -1 (wildcard) if x < 0
+static long long tune_bucket( long long x )
+{
+    if ( x < 0 ) {
+        return -1;
+    }
+    long long b = 1;
+    while ( b < x ) {
+        b *= 2;
+    }
+    return b;
+}
+
+
+/******************************************************************************/
+// number of online CPU cores (hyperthreads included)
+static long long tune_cores()
+{
+    #ifdef _MSC_VER  // Windows
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo( &sysinfo );
+    return sysinfo.dwNumberOfProcessors;
+    #else
+    return sysconf( _SC_NPROCESSORS_ONLN );
+    #endif
+}
+
+
+/******************************************************************************/
+// CPU model name, with whitespace replaced by '_' so it is one field
+static const std::string& tune_cpu()
+{
+    static std::string* cpu = NULL;
+    static std::once_flag once;
+    std::call_once( once, [] {
+        std::string name;
+        #if defined(__APPLE__)
+        char buf[ 256 ];
+        size_t len = sizeof(buf);
+        if ( sysctlbyname( "machdep.cpu.brand_string", buf, &len, NULL, 0 ) == 0 ) {
+            name.assign( buf, strnlen( buf, len ));
+        }
+        #elif defined(__linux__)
+        FILE* file = fopen( "/proc/cpuinfo", "r" );
+        if ( file != NULL ) {
+            char line[ 1024 ];
+            while ( fgets( line, sizeof(line), file ) != NULL ) {
+                if ( strncmp( line, "model name", 10 ) == 0 ) {
+                    const char* colon = strchr( line, ':' );
+                    if ( colon != NULL ) {
+                        name = colon + 1;
+                    }
+                    break;
+                }
+            }
+            fclose( file );
+        }
+        #endif
+        // trim, and replace inner whitespace
+        std::string* s = new std::string;
+        for( size_t i = 0; i < name.size(); ++i ) {
+            if ( isspace( (unsigned char) name[i] )) {
+                if ( ! s->empty() && (*s)[ s->size()-1 ] != '_' ) {
+                    *s += '_';
+                }
+            }
+            else {
+                *s += name[i];
+            }
+        }
+        while ( ! s->empty() && (*s)[ s->size()-1 ] == '_' ) {
+            s->erase( s->size()-1 );
+        }
+        if ( s->empty() ) {
+            *s = "unknown";
+        }
+        cpu = s;
+    });
+    return *cpu;
+}
+
+
+/******************************************************************************/
+// adds entry, replacing any entry with the same keys. Caller holds the mutex.
+static void tune_insert( const tune_entry& entry )
+{
+    std::vector< tune_entry >& entries = tune_entries();
+    for( size_t i = 0; i < entries.size(); ++i ) {
+        tune_entry& e = entries[i];
+        if ( e.param == entry.param && e.precision == entry.precision
+             && e.m == entry.m && e.n == entry.n && e.arch == entry.arch
+             && e.cores == entry.cores && e.cpu == entry.cpu )
+        {
+            // move to end, so it wins ties as the latest entry
+            entries.erase( entries.begin() + i );
+            break;
+        }
+    }
+    entries.push_back( entry );
+    g_tune_count.store( (int) entries.size() );
+}
+
+
+/******************************************************************************/
+// parses a numeric key; '*' is the wildcard
+static bool tune_parse_key( const char* str, long long* value )
+{
+    if ( strcmp( str, "*" ) == 0 ) {
+        *value = -1;
+        return true;
+    }
+    char* endptr;
+    *value = strtoll( str, &endptr, 10 );
+    return *endptr == '\0' && *value >= 0;
+}
+
+
+/******************************************************************************/
+// loads filename. Caller holds the mutex.
+static magma_int_t tune_load( const char* filename )
+{
+    FILE* file = fopen( filename, "r" );
+    if ( file == NULL ) {
+        fprintf( stderr, "Error in %s: can't open tuning file '%s'\n",
+                 __func__, filename );
+        return MAGMA_ERR_NOT_FOUND;
+    }
+
+    magma_int_t info = 0;
+    bool have_version = false;
+    char line[ 1024 ];
+    int lineno = 0;
+    while ( fgets( line, sizeof(line), file ) != NULL ) {
+        ++lineno;
+        char* comment = strchr( line, '#' );
+        if ( comment != NULL ) {
+            *comment = '\0';
+        }
+        char param[ 256 ], prec[ 256 ], m[ 256 ], n[ 256 ], arch[ 256 ],
+             cores[ 256 ], cpu[ 256 ], value[ 256 ];
+        int cnt = sscanf( line, "%255s %255s %255s %255s %255s %255s %255s %255s",
+                          param, prec, m, n, arch, cores, cpu, value );
+        if ( cnt <= 0 ) {
+            continue;  // blank line
+        }
+        if ( ! have_version ) {
+            int version;
+            if ( cnt != 2 || strcmp( param, "magma-tune" ) != 0
+                 || sscanf( prec, "%d", &version ) != 1 )
+            {
+                fprintf( stderr, "Error in %s: '%s' is not a MAGMA tuning file\n",
+                         __func__, filename );
+                info = MAGMA_ERR_ILLEGAL_VALUE;
+                break;
+            }
+            if ( version > tune_version ) {
+                fprintf( stderr, "Error in %s: '%s' has version %d; this MAGMA reads version %d\n",
+                         __func__, filename, version, tune_version );
+                info = MAGMA_ERR_NOT_SUPPORTED;
+                break;
+            }
+            have_version = true;
+            continue;
+        }
+
+        tune_entry entry;
+        long long val;
+        if ( cnt != 8 || strlen( prec ) != 1
+             || ! tune_parse_key( m,     &entry.m )
+             || ! tune_parse_key( n,     &entry.n )
+             || ! tune_parse_key( arch,  &entry.arch )
+             || ! tune_parse_key( cores, &entry.cores )
+             || ! tune_parse_key( value, &val ) || val < 0 )
+        {
+            fprintf( stderr, "Error in %s: %s:%d: invalid entry, skipping it\n",
+                     __func__, filename, lineno );
+            info = MAGMA_ERR_ILLEGAL_VALUE;
+            continue;
+        }
+        entry.param     = param;
+        entry.precision = prec[0];
+        entry.m         = tune_bucket( entry.m );
+        entry.n         = tune_bucket( entry.n );
+        entry.cpu       = cpu;
+        entry.value     = (magma_int_t) val;
+        tune_insert( entry );
+    }
+    fclose( file );
+    return info;
+}
+
+
+/******************************************************************************/
+// loads $MAGMA_TUNE_FILE, once, before any other use of the database
+static void tune_setup()
+{
+    static std::once_flag once;
+    std::call_once( once, [] {
+        const char* env = getenv( "MAGMA_TUNE_FILE" );
+        if ( env != NULL && env[0] != '\0' ) {
+            std::lock_guard< std::mutex > lock( tune_mutex() );
+            tune_load( env );
+        }
+    });
+}
+
+
+/***************************************************************************//**
+    Loads entries of a tuning database file, as written by magma_tune_save
+    or testing_tune, adding them to entries already loaded or set.
+    Entries with the same keys replace existing ones.
+    The file named by $MAGMA_TUNE_FILE is loaded automatically.
+
+    @param[in]
+    filename    File to read.
+
+    @return MAGMA_SUCCESS;
+            MAGMA_ERR_NOT_FOUND if the file can't be opened;
+            MAGMA_ERR_NOT_SUPPORTED if it is a newer version;
+            MAGMA_ERR_ILLEGAL_VALUE if it has invalid entries, which are skipped.
+
+    @ingroup magma_tuning
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tune_load( const char* filename )
+{
+    tune_setup();
+    std::lock_guard< std::mutex > lock( tune_mutex() );
+    return tune_load( filename );
+}
+
+
+/***************************************************************************//**
+    Writes all entries of the tuning database to a file,
+    in the format read by magma_tune_load.
+
+    @param[in]
+    filename    File to write; NULL for stdout.
+
+    @return MAGMA_SUCCESS, or MAGMA_ERR_NOT_FOUND if the file can't be opened.
+
+    @ingroup magma_tuning
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tune_save( const char* filename )
+{
+    tune_setup();
+    FILE* file = stdout;
+    if ( filename != NULL ) {
+        file = fopen( filename, "w" );
+        if ( file == NULL ) {
+            fprintf( stderr, "Error in %s: can't open tuning file '%s'\n",
+                     __func__, filename );
+            return MAGMA_ERR_NOT_FOUND;
+        }
+    }
+
+    std::lock_guard< std::mutex > lock( tune_mutex() );
+    const std::vector< tune_entry >& entries = tune_entries();
+    fprintf( file, "magma-tune %d\n", tune_version );
+    fprintf( file, "# %-22s %4s %7s %7s %5s %5s %-40s %7s\n",
+             "param", "prec", "m", "n", "arch", "cores", "cpu", "value" );
+    for( size_t i = 0; i < entries.size(); ++i ) {
+        const tune_entry& e = entries[i];
+        char m[ 32 ] = "*", n[ 32 ] = "*", arch[ 32 ] = "*", cores[ 32 ] = "*";
+        if ( e.m     >= 0 ) snprintf( m,     sizeof(m),     "%lld", e.m     );
+        if ( e.n     >= 0 ) snprintf( n,     sizeof(n),     "%lld", e.n     );
+        if ( e.arch  >= 0 ) snprintf( arch,  sizeof(arch),  "%lld", e.arch  );
+        if ( e.cores >= 0 ) snprintf( cores, sizeof(cores), "%lld", e.cores );
+        fprintf( file, "  %-22s %4c %7s %7s %5s %5s %-40s %7lld\n",
+                 e.param.c_str(), e.precision, m, n, arch, cores,
+                 e.cpu.c_str(), (long long) e.value );
+    }
+
+    if ( filename != NULL ) {
+        fclose( file );
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Looks up a tuning parameter in the tuning database.
+    The magma_get_*_nb getters, and others, use this before their built-in
+    tables, with param being the getter's name without the "magma_get_"
+    prefix and precision letter, e.g., "getrf_nb" for magma_get_dgetrf_nb.
+
+    @param[in]
+    param       Name of the parameter, e.g., "getrf_nb".
+
+    @param[in]
+    precision   Precision: 's', 'd', 'c', 'z', or '*' if it doesn't apply.
+
+    @param[in]
+    m           Number of rows, or size; < 0 matches only wildcard entries.
+
+    @param[in]
+    n           Number of columns, or second size; < 0 as for m.
+
+    @param[out]
+    value       On success, the value of the most specific matching entry.
+                Unchanged if there is none.
+
+    @return true (1) if a matching entry was found, false (0) otherwise.
+
+    @ingroup magma_tuning
+*******************************************************************************/
+extern "C" magma_int_t
+magma_tune_get(
+    const char* param, char precision, magma_int_t m, magma_int_t n,
+    magma_int_t* value )
+{
+    tune_setup();
+    if ( g_tune_count.load( std::memory_order_relaxed ) == 0 ) {
+        return false;
+    }
+
+    long long mb = tune_bucket( m );
+    long long nb = tune_bucket( n );
+    long long cores = tune_cores();
+    long long arch = -2;  // queried only if an entry needs it
+
+    std::lock_guard< std::mutex > lock( tune_mutex() );
+    const std::vector< tune_entry >& entries = tune_entries();
+    int best = -1;
+    for( size_t i = 0; i < entries.size(); ++i ) {
+        const tune_entry& e = entries[i];
+        if ( e.param != param
+             || (e.precision != '*' && e.precision != precision)
+             || (e.m     >= 0 && e.m     != mb)
+             || (e.n     >= 0 && e.n     != nb)
+             || (e.cores >= 0 && e.cores != cores)
+             || (e.cpu != "*" && e.cpu != tune_cpu()) )
+        {
+            continue;
+        }
+        if ( e.arch >= 0 ) {
+            if ( arch == -2 ) {
+                arch = magma_getdevice_arch();
+            }
+            if ( e.arch != arch ) {
+                continue;
+            }
+        }
+        int score = (e.precision != '*') + (e.m >= 0) + (e.n >= 0)
+                  + (e.arch >= 0) + (e.cores >= 0) + (e.cpu != "*");
+        if ( score >= best ) {
+            best = score;
+            *value = e.value;
+        }
+    }
+    return best >= 0;
+}
+
+
+/***************************************************************************//**
+    Sets a tuning parameter in the tuning database, for the current machine:
+    its device architecture, number of CPU cores, and CPU model.
+    Use magma_tune_save to write it to a file.
+
+    @param[in]
+    param       Name of the parameter, e.g., "getrf_nb"; see magma_tune_get.
+
+    @param[in]
+    precision   Precision: 's', 'd', 'c', 'z', or '*' for all precisions.
+
+    @param[in]
+    m           Number of rows, or size, rounded up to a power of 2;
+                < 0 for all sizes.
+
+    @param[in]
+    n           Number of columns, or second size, as for m.
+
+    @param[in]
+    value       Value of the parameter.
+
+    @ingroup magma_tuning
+*******************************************************************************/
+extern "C" void
+magma_tune_set(
+    const char* param, char precision, magma_int_t m, magma_int_t n,
+    magma_int_t value )
+{
+    tune_setup();
+    tune_entry entry;
+    entry.param     = param;
+    entry.precision = (precision == '\0' ? '*' : precision);
+    entry.m         = tune_bucket( m );
+    entry.n         = tune_bucket( n );
+    entry.arch      = magma_getdevice_arch();
+    entry.cores     = tune_cores();
+    entry.cpu       = tune_cpu();
+    entry.value     = value;
+
+    std::lock_guard< std::mutex > lock( tune_mutex() );
+    tune_insert( entry );
+}
+
+
+/***************************************************************************//**
+    Removes all entries from the tuning database, so getters use their
+    built-in tables.
+
+    @ingroup magma_tuning
+*******************************************************************************/
+extern "C" void
+magma_tune_clear( void )
+{
+    tune_setup();
+    std::lock_guard< std::mutex > lock( tune_mutex() );
+    tune_entries().clear();
+    g_tune_count.store( 0 );
+}
@@ -0,0 +1,30 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_TUNE_H
+#define MAGMA_TUNE_H
+
+#include "magma_v2.h"
+
+// =============================================================================
+// Internal interface of the tuning database; the public interface
+// (magma_tune_load, _save, _get, _set, _clear) is in magma_auxiliary.h.
+// Getters call MAGMA_TUNE_RETURN first, then fall back to their tables.
+// With an empty database, a lookup costs one load and branch.
+
+// e.g., MAGMA_TUNE_RETURN( "potrf_nb", 'z', n, n );
+// returns from the calling getter the database's value of param, if any.
+#define MAGMA_TUNE_RETURN( param, precision, m, n ) \
+    do { \
+        magma_int_t magma_tune_value_; \
+        if ( magma_tune_get( param, precision, m, n, &magma_tune_value_ )) { \
+            return magma_tune_value_; \
+        } \
+    } while (0)
+
+#endif        //  #ifndef MAGMA_TUNE_H
@@ -9,6 +9,7 @@
 */
 
 #include "thread_queue.hpp"
+#include "magma_metrics.h"
 
 // If err, prints error and throws exception.
 static void check( int err )
@@ -97,6 +98,10 @@ void* magma_thread_main( void* arg )
 {
     magma_thread_queue* queue = (magma_thread_queue*) arg;
     magma_task* task;
+    uint64_t thread_start = magma_metrics_nsec();
+    
+    // bind to one of the queue's CPUs, with single-threaded BLAS
+    magma_thread_worker worker( *queue->region, queue->start_worker() );
     
     while( true ) {
         task = queue->pop_task();
@@ -104,12 +109,23 @@ void* magma_thread_main( void* arg )
             break;
         }
         
-        task->run();
+        if ( magma_metrics_on ) {
+            uint64_t task_start = magma_metrics_nsec();
+            task->run();
+            magma_metrics_pool_task_( magma_metrics_nsec() - task_start );
+        }
+        else {
+            task->run();
+        }
         queue->task_done();
         delete task;
         task = NULL;
     }
     
+    // utilization is busy time over lifetime of pool threads
+    if ( magma_metrics_on ) {
+        magma_metrics_pool_thread_( magma_metrics_nsec() - thread_start );
+    }
     return NULL;  // implicitly does pthread_exit
 }
 
@@ -122,7 +138,9 @@ magma_thread_queue::magma_thread_queue():
     quit_flag( false ),
     ntask    ( 0     ),
     threads  ( NULL  ),
-    nthread  ( 0     )
+    nthread  ( 0     ),
+    nstarted ( 0     ),
+    region   ( NULL  )
 {
     check( pthread_mutex_init( &mutex,      NULL ));
     check( pthread_cond_init(  &cond,       NULL ));
@@ -143,16 +161,16 @@ magma_thread_queue::~magma_thread_queue()
 
 
 /***************************************************************************//**
-    Creates threads.
+    Creates threads. Each thread is bound to its own CPU, reserved from the
+    calling thread's budget (see magma_thread_region), so fewer threads may
+    be launched than requested if other parallel regions are active.
     @param[in] in_nthread    Number of threads to launch.
 *******************************************************************************/
 void magma_thread_queue::launch( magma_int_t in_nthread )
 {
     assert( threads == NULL );  // else launch was called previously
-    nthread = in_nthread;
-    if ( nthread < 1 ) {
-        nthread = 1;
-    }
+    region  = new magma_thread_region( "thread_queue", in_nthread );
+    nthread = region->num_threads();
     threads = new pthread_t[ nthread ];
     for( magma_int_t i=0; i < nthread; ++i ) {
         check( pthread_create( &threads[i], NULL, magma_thread_main, this ));
@@ -222,6 +240,20 @@ void magma_thread_queue::task_done()
 }
 
 
+/***************************************************************************//**
+    Called by each thread as it starts.
+    @return thread's worker id in range 0, ..., nthread-1.
+*******************************************************************************/
+magma_int_t magma_thread_queue::start_worker()
+{
+    check( pthread_mutex_lock( &mutex ));
+    magma_int_t id = nstarted;
+    nstarted += 1;
+    check( pthread_mutex_unlock( &mutex ));
+    return id;
+}
+
+
 /***************************************************************************//**
     Block until all outstanding tasks have been finished.
     Threads continue to be alive; more tasks can be pushed after sync.
@@ -272,6 +304,8 @@ void magma_thread_queue::quit()
         }
         delete[] threads;
         threads = NULL;
+        delete region;
+        region = NULL;
     }
 }
 
@@ -14,6 +14,7 @@
 #include <queue>
 
 #include "magma_internal.h"
+#include "magma_thread_budget.h"
 
 
 /******************************************************************************/
@@ -48,10 +49,13 @@ public:
     void sync();
     void quit();
     
+    magma_int_t num_threads() const { return nthread; }
+    
 protected:
     friend void* magma_thread_main( void* arg );
     magma_task* pop_task();
     void task_done();
+    magma_int_t start_worker();
     
     magma_int_t get_thread_index( pthread_t thread ) const;
     
@@ -64,6 +68,8 @@ private:
     pthread_cond_t  cond_ntask;   ///<  condition variable for changes to ntask (see sync, task_done)
     pthread_t*      threads;      ///<  array of threads
     magma_int_t     nthread;      ///<  number of threads
+    magma_int_t     nstarted;     ///<  number of threads started; gives each its worker id
+    magma_thread_region* region;  ///<  CPUs reserved for threads, from launch until quit
 };
 
 #endif        //  #ifndef MAGMA_THREAD_HPP
@@ -1,17 +1,31 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <errno.h>
+#include <stdint.h>
 #include <string.h>      // strerror_r
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <new>
 #include <set>
 #include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>      // __rdtsc
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>   // __rdtsc
+#endif
 
 #include "trace.h"
+#include "magma_perfctr.h"
 
-// define TRACING to compile these functions, e.g.,
+// define TRACING to compile the GPU tracing functions and to enable
+// tracing by default, e.g.,
 // gcc -DTRACING -c trace.cpp
 #ifdef TRACING
-
 #include <cuda_runtime.h>
 #include "magma_internal.h"
 #include "magmablas_v1.h"
@@ -20,175 +34,573 @@
 // later of CPU time and previous event's end time.
 // set TRACE_METHOD = 1 to record start time using CUDA event.
 #define TRACE_METHOD 2
+#endif
 
 
 /******************************************************************************/
-struct event_log
-{
-    int    ncore;
-    int    cpu_id   [ MAX_CORES ];
-    double cpu_first;
-    double cpu_start[ MAX_CORES ][ MAX_EVENTS ];
-    double cpu_end  [ MAX_CORES ][ MAX_EVENTS ];
-    char   cpu_tag  [ MAX_CORES ][ MAX_EVENTS ][ MAX_LABEL_LEN ];
-    char   cpu_label[ MAX_CORES ][ MAX_EVENTS ][ MAX_LABEL_LEN ];
-    
-    int           ngpu;
-    int           nqueue;
-    magma_queue_t queues   [ MAX_GPU_QUEUES ];
-    int           gpu_id   [ MAX_GPU_QUEUES ];
-    magma_event_t gpu_first[ MAX_GPU_QUEUES ];
-#if TRACE_METHOD == 2
-    double        gpu_start[ MAX_GPU_QUEUES ][ MAX_EVENTS ];
+// Time stamps: TSC ticks on x86 (invariant TSC, synchronized across cores
+// on all current CPUs), nanoseconds of the monotonic clock otherwise.
+// Ticks are converted to seconds when the trace is written, calibrated
+// against the monotonic clock over the whole traced interval.
+static inline uint64_t trace_ticks()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
 #else
-    magma_event_t gpu_start[ MAX_GPU_QUEUES ][ MAX_EVENTS ];
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
 #endif
-    magma_event_t gpu_end  [ MAX_GPU_QUEUES ][ MAX_EVENTS ];
-    char          gpu_tag  [ MAX_GPU_QUEUES ][ MAX_EVENTS ][ MAX_LABEL_LEN ];
-    char          gpu_label[ MAX_GPU_QUEUES ][ MAX_EVENTS ][ MAX_LABEL_LEN ];
+}
+
+static inline double trace_seconds()
+{
+    return std::chrono::duration< double >(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+/******************************************************************************/
+// one completed region (depth >= 0) or counter value (depth < 0);
+// with hardware counters enabled, regions have the thread's counts in ctr
+struct trace_record
+{
+    uint64_t        start;
+    uint64_t        end;
+    double          value;
+    int             depth;
+    bool            has_ctr;
+    magma_perfctr_t ctr;
+    char            tag  [ MAX_LABEL_LEN ];
+    char            label[ MAX_LABEL_LEN ];
 };
 
-// global log object
-struct event_log glog;
+// Ring buffer of one thread. Only the owning thread writes records and
+// head; readers take head with acquire semantics. Regions are kept in
+// open[] until they end, so the ring holds only completed events.
+struct trace_buffer
+{
+    int                     tid;
+    size_t                  capacity;
+    trace_record*           records;
+    std::atomic< uint64_t > head;       // number of records written
+    std::atomic< uint64_t > cleared;    // head at the last magma_trace_clear
+    int                     depth;
+    trace_record            open[ MAX_TRACE_DEPTH ];
+};
+
+static size_t   g_capacity = MAX_EVENTS;
+static uint64_t g_tick0    = 0;
+static double   g_sec0     = 0;
+static char     g_filename[ 1024 ] = "";
+
+// never destroyed, so threads and the atexit handler can use them at any time
+static std::mutex& trace_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+static std::vector< trace_buffer* >& trace_buffers()
+{
+    static std::vector< trace_buffer* >* buffers = new std::vector< trace_buffer* >;
+    return *buffers;
+}
+
+// buffers of exited threads, reused by new threads; see trace_thread_slot
+static std::vector< trace_buffer* >& trace_free_buffers()
+{
+    static std::vector< trace_buffer* >* buffers = new std::vector< trace_buffer* >;
+    return *buffers;
+}
+
+static thread_local trace_buffer* tls_buffer  = NULL;
+static thread_local bool          tls_exiting = false;
 
 
 /******************************************************************************/
-void trace_init( int ncore, int ngpu, int nqueue, magma_queue_t* queues )
+static inline void trace_strcpy( char* dst, const char* src )
 {
-    if ( ncore > MAX_CORES ) {
-        fprintf( stderr, "Error in trace_init: ncore %d > MAX_CORES %d\n",
-                 ncore, MAX_CORES );
-        exit(1);
-    }
-    if ( ngpu*nqueue > MAX_GPU_QUEUES ) {
-        fprintf( stderr, "Error in trace_init: (ngpu=%d)*(nqueue=%d) > MAX_GPU_QUEUES=%d\n",
-                 ngpu, nqueue, MAX_GPU_QUEUES );
-        exit(1);
-    }
-    
-    glog.ncore  = ncore;
-    glog.ngpu   = ngpu;
-    glog.nqueue = nqueue;
-    
-    // initialize ID = 0
-    for( int core = 0; core < ncore; ++core ) {
-        glog.cpu_id[core] = 0;
+    if ( src == NULL ) {
+        src = "";
     }
-    for( int dev = 0; dev < ngpu; ++dev ) {
-        for( int s = 0; s < nqueue; ++s ) {
-            int t = dev*glog.nqueue + s;
-            glog.gpu_id[t] = 0;
-            glog.queues[t] = queues[t];
+    strncpy( dst, src, MAX_LABEL_LEN-1 );
+    dst[ MAX_LABEL_LEN-1 ] = '\0';
+}
+
+
+/******************************************************************************/
+// Returns the buffer of an exiting thread to the free list. The buffer stays
+// registered, so its events are still written, and the next new thread
+// appends to it; memory is bounded by the number of concurrent threads,
+// not by the number of threads ever created.
+struct trace_thread_slot
+{
+    ~trace_thread_slot()
+    {
+        trace_buffer* buf = tls_buffer;
+        tls_exiting = true;
+        tls_buffer  = NULL;
+        if ( buf != NULL ) {
+            buf->depth = 0;
+            std::lock_guard< std::mutex > lock( trace_mutex() );
+            trace_free_buffers().push_back( buf );
         }
-        magma_setdevice( dev );
-        magma_device_sync();
     }
-    // now that all GPUs are sync'd, record start time
-    for( int dev = 0; dev < ngpu; ++dev ) {
-        magma_setdevice( dev );
-        for( int s = 0; s < nqueue; ++s ) {
-            int t = dev*glog.nqueue + s;
-            magma_event_create( &glog.gpu_first[t] );
-            magma_event_record(  glog.gpu_first[t], glog.queues[t] );
+};
+
+static thread_local trace_thread_slot tls_slot;
+
+
+/******************************************************************************/
+// buffer of the calling thread, taken from the free list or allocated and
+// registered on first use
+static trace_buffer* trace_thread_buffer()
+{
+    trace_buffer* buf = tls_buffer;
+    if ( buf == NULL ) {
+        if ( tls_exiting ) {
+            return NULL;
         }
+        {
+            std::lock_guard< std::mutex > lock( trace_mutex() );
+            std::vector< trace_buffer* >& free_buffers = trace_free_buffers();
+            if ( ! free_buffers.empty() ) {
+                buf = free_buffers.back();
+                free_buffers.pop_back();
+            }
+        }
+        if ( buf == NULL ) {
+            buf = new (std::nothrow) trace_buffer;
+            if ( buf == NULL ) {
+                return NULL;
+            }
+            buf->capacity = g_capacity;
+            buf->records  = new (std::nothrow) trace_record[ buf->capacity ];
+            if ( buf->records == NULL ) {
+                fprintf( stderr, "Error in %s: can't allocate %lld trace events.\n",
+                         __func__, (long long) buf->capacity );
+                delete buf;
+                return NULL;
+            }
+            buf->head    = 0;
+            buf->cleared = 0;
+            buf->depth   = 0;
+            std::lock_guard< std::mutex > lock( trace_mutex() );
+            buf->tid = (int) trace_buffers().size();
+            trace_buffers().push_back( buf );
+        }
+        (void) &tls_slot;  // odr-use, so the slot's destructor runs at thread exit
+        tls_buffer = buf;
     }
-    // sync again
-    for( int dev = 0; dev < ngpu; ++dev ) {
-        magma_setdevice( dev );
-        magma_device_sync();
+    return buf;
+}
+
+
+/******************************************************************************/
+static inline void trace_push( trace_buffer* buf, const trace_record& rec )
+{
+    uint64_t h = buf->head.load( std::memory_order_relaxed );
+    buf->records[ h % buf->capacity ] = rec;
+    buf->head.store( h+1, std::memory_order_release );
+}
+
+
+/******************************************************************************/
+void magma_trace_begin_( const char* tag, const char* label )
+{
+    trace_buffer* buf = trace_thread_buffer();
+    if ( buf == NULL ) {
+        return;
     }
-    glog.cpu_first = magma_wtime();
+    if ( buf->depth < MAX_TRACE_DEPTH ) {
+        trace_record& rec = buf->open[ buf->depth ];
+        trace_strcpy( rec.tag,   tag   );
+        trace_strcpy( rec.label, label );
+        rec.depth = buf->depth;
+        rec.value = 0;
+        // read counters before the start time, so the read isn't timed
+        rec.has_ctr = (magma_perfctr_on != 0);
+        if ( rec.has_ctr ) {
+            magma_perfctr_read( &rec.ctr );
+        }
+        rec.start = trace_ticks();
+    }
+    buf->depth += 1;
 }
 
 
 /******************************************************************************/
-void trace_cpu_start( int core, const char* tag, const char* lbl )
+void magma_trace_end_()
 {
-    int id = glog.cpu_id[core];
-    glog.cpu_start[core][id] = magma_wtime();
-    magma_strlcpy( glog.cpu_tag  [core][id], tag, MAX_LABEL_LEN );
-    magma_strlcpy( glog.cpu_label[core][id], lbl, MAX_LABEL_LEN );
+    uint64_t end = trace_ticks();
+    trace_buffer* buf = tls_buffer;
+    if ( buf == NULL || buf->depth == 0 ) {
+        return;
+    }
+    buf->depth -= 1;
+    if ( buf->depth < MAX_TRACE_DEPTH ) {
+        trace_record& rec = buf->open[ buf->depth ];
+        rec.end = end;
+        if ( rec.has_ctr ) {
+            magma_perfctr_t ctr;
+            magma_perfctr_read( &ctr );
+            magma_perfctr_diff( rec.ctr, ctr, rec.ctr );
+        }
+        trace_push( buf, rec );
+    }
 }
 
 
 /******************************************************************************/
-void trace_cpu_end( int core )
+void magma_trace_counter_( const char* name, double value )
 {
-    int id = glog.cpu_id[core];
-    glog.cpu_end[core][id] = magma_wtime();
-    if ( id+1 < MAX_EVENTS ) {
-        glog.cpu_id[core] = id+1;
+    trace_buffer* buf = trace_thread_buffer();
+    if ( buf == NULL ) {
+        return;
     }
-    else {
-        fprintf( stderr, "Error in %s: not enough CPU events.\n", __func__ );
+    trace_record rec;
+    trace_strcpy( rec.tag,   "counter" );
+    trace_strcpy( rec.label, name );
+    rec.depth = -1;
+    rec.value = value;
+    rec.has_ctr = false;
+    rec.start = rec.end = trace_ticks();
+    trace_push( buf, rec );
+}
+
+
+/******************************************************************************/
+void magma_trace_clear()
+{
+    std::lock_guard< std::mutex > lock( trace_mutex() );
+    std::vector< trace_buffer* >& buffers = trace_buffers();
+    for( size_t t = 0; t < buffers.size(); ++t ) {
+        buffers[t]->cleared.store( buffers[t]->head.load( std::memory_order_acquire ) );
     }
 }
 
 
 /******************************************************************************/
-void trace_gpu_start( int dev, int s, const char* tag, const char* lbl )
+// GPU event log, one per queue
+#ifdef TRACING
+
+struct gpu_record
 {
-    int t = dev*glog.nqueue + s;
-    int id = glog.gpu_id[t];
 #if TRACE_METHOD == 2
-    glog.gpu_start[t][id] = magma_wtime();
+    double        start;
 #else
-    magma_event_create( &glog.gpu_start[t][id] );
-    magma_event_record(  glog.gpu_start[t][id], glog.queues[t] );
+    magma_event_t start;
+#endif
+    magma_event_t end;
+    char          tag  [ MAX_LABEL_LEN ];
+    char          label[ MAX_LABEL_LEN ];
+};
+
+struct gpu_log
+{
+    int                       dev;
+    int                       queue_num;
+    magma_queue_t             queue;
+    magma_event_t             first;
+    std::vector< gpu_record > events;
+};
+
+static std::vector< gpu_log > g_gpu;
+static int    g_nqueue    = 0;
+static double g_gpu_first = 0;   // seconds at the first GPU event
+
+static void trace_gpu_clear();
+
 #endif
-    magma_strlcpy( glog.gpu_tag  [t][id], tag, MAX_LABEL_LEN );
-    magma_strlcpy( glog.gpu_label[t][id], lbl, MAX_LABEL_LEN );
+
+
+/******************************************************************************/
+// events of one row of the trace, times in seconds since tracing started
+struct trace_event
+{
+    double          start;
+    double          end;
+    double          value;
+    int             depth;
+    bool            has_ctr;
+    magma_perfctr_t ctr;
+    std::string     tag;
+    std::string     label;
+};
+
+struct trace_track
+{
+    int                        pid;     // 0: CPU threads, 1: GPU queues
+    int                        tid;
+    std::string                name;
+    long long                  dropped;
+    std::vector< trace_event > events;
+};
+
+
+/******************************************************************************/
+static void trace_collect( std::vector< trace_track >& tracks, double& time )
+{
+    // calibrate ticks against the monotonic clock
+    uint64_t tick1 = trace_ticks();
+    double   sec1  = trace_seconds();
+    while ( sec1 - g_sec0 < 1e-3 ) {
+        tick1 = trace_ticks();
+        sec1  = trace_seconds();
+    }
+    double spt = (sec1 - g_sec0) / (double) (tick1 - g_tick0);  // seconds per tick
+    time = sec1 - g_sec0;
+
+    std::lock_guard< std::mutex > lock( trace_mutex() );
+    std::vector< trace_buffer* >& buffers = trace_buffers();
+    for( size_t t = 0; t < buffers.size(); ++t ) {
+        trace_buffer* buf = buffers[t];
+        uint64_t head  = buf->head.load( std::memory_order_acquire );
+        uint64_t first = buf->cleared.load();
+        if ( head - first > buf->capacity ) {
+            first = head - buf->capacity;
+        }
+        char name[ 64 ];
+        snprintf( name, sizeof(name), "CPU thread %d", buf->tid );
+        trace_track track;
+        track.pid     = 0;
+        track.tid     = buf->tid;
+        track.name    = name;
+        track.dropped = (long long) (first - buf->cleared.load());
+        for( uint64_t i = first; i < head; ++i ) {
+            const trace_record& rec = buf->records[ i % buf->capacity ];
+            trace_event ev;
+            ev.start   = (double) (int64_t) (rec.start - g_tick0) * spt;
+            ev.end     = (double) (int64_t) (rec.end   - g_tick0) * spt;
+            ev.value   = rec.value;
+            ev.depth   = rec.depth;
+            ev.has_ctr = rec.has_ctr;
+            ev.ctr     = rec.ctr;
+            ev.tag     = rec.tag;
+            ev.label   = rec.label;
+            track.events.push_back( ev );
+        }
+        tracks.push_back( track );
+    }
+
+    #ifdef TRACING
+    for( size_t t = 0; t < g_gpu.size(); ++t ) {
+        gpu_log& log = g_gpu[t];
+        char name[ 64 ];
+        snprintf( name, sizeof(name), "GPU %d queue %d", log.dev, log.queue_num );
+        trace_track track;
+        track.pid     = 1;
+        track.tid     = (int) t;
+        track.name    = name;
+        track.dropped = 0;
+        magma_setdevice( log.dev );
+        double offset = g_gpu_first - g_sec0;
+        float start, end = 0;
+        for( size_t i = 0; i < log.events.size(); ++i ) {
+            gpu_record& rec = log.events[i];
+            #if TRACE_METHOD == 2
+                start = rec.start - g_gpu_first;
+                if ( i > 0 ) {
+                    // later of task's CPU start time and previous task's end time
+                    start = max( start, end );
+                }
+            #else
+                cudaEventElapsedTime( &start, log.first, rec.start );
+                start *= 1e-3;  // ms to seconds
+            #endif
+            cudaEventElapsedTime( &end, log.first, rec.end );
+            end   *= 1e-3;  // ms to seconds
+            trace_event ev;
+            ev.start   = offset + start;
+            ev.end     = offset + end;
+            ev.value   = 0;
+            ev.depth   = 0;
+            ev.has_ctr = false;
+            ev.tag     = rec.tag;
+            ev.label   = rec.label;
+            track.events.push_back( ev );
+        }
+        tracks.push_back( track );
+    }
+    #endif
 }
 
 
 /******************************************************************************/
-void trace_gpu_end( int dev, int s )
+static void trace_json_string( FILE* file, const std::string& str )
 {
-    int t = dev*glog.nqueue + s;
-    int id = glog.gpu_id[t];
-    magma_event_create( &glog.gpu_end[t][id] );
-    magma_event_record(  glog.gpu_end[t][id], glog.queues[t] );
-    if ( id+1 < MAX_EVENTS ) {
-        glog.gpu_id[t] = id+1;
+    fputc( '"', file );
+    for( size_t i = 0; i < str.size(); ++i ) {
+        unsigned char c = str[i];
+        if ( c == '"' || c == '\\' ) {
+            fputc( '\\', file );
+            fputc( c, file );
+        }
+        else if ( c < 0x20 ) {
+            fprintf( file, "\\u%04x", c );
+        }
+        else {
+            fputc( c, file );
+        }
     }
-    else {
-        fprintf( stderr, "Error in %s: not enough GPU events (dev %d, queue %d).\n", __func__, dev, s );
+    fputc( '"', file );
+}
+
+
+/******************************************************************************/
+// hardware counters of a region as its args; unavailable counters are omitted
+static void trace_json_counters( FILE* file, const magma_perfctr_t& ctr )
+{
+    const char* names [] = { "cycles", "instructions", "llc_misses", "mem_bytes", "fp_ops" };
+    long long   values[] = { ctr.cycles, ctr.instructions, ctr.llc_misses, ctr.mem_bytes, ctr.fp_ops };
+    bool any = false;
+    for( int i = 0; i < 5; ++i ) {
+        if ( values[i] >= 0 ) {
+            fprintf( file, "%s\"%s\": %lld", (any ? ", " : ", \"args\": {"),
+                     names[i], values[i] );
+            any = true;
+        }
+    }
+    if ( any ) {
+        fprintf( file, "}" );
     }
 }
 
 
 /******************************************************************************/
-void trace_finalize( const char* filename, const char* cssfile )
+static std::string trace_xml_string( const std::string& str )
+{
+    std::string xml;
+    for( size_t i = 0; i < str.size(); ++i ) {
+        switch ( str[i] ) {
+            case '"': xml += "&quot;"; break;
+            case '&': xml += "&amp;";  break;
+            case '<': xml += "&lt;";   break;
+            case '>': xml += "&gt;";   break;
+            default:  xml += str[i];   break;
+        }
+    }
+    return xml;
+}
+
+
+/******************************************************************************/
+static FILE* trace_open( const char* filename )
+{
+    char buf[ 1024 ];
+    FILE* file = fopen( filename, "w" );
+    if ( file == NULL ) {
+        strerror_r( errno, buf, sizeof(buf) );
+        fprintf( stderr, "Can't open file '%s': %s (%d)\n", filename, buf, errno );
+        return NULL;
+    }
+    fprintf( stderr, "writing trace to '%s'\n", filename );
+    return file;
+}
+
+
+/******************************************************************************/
+static void trace_warn_dropped( const std::vector< trace_track >& tracks )
 {
+    for( size_t t = 0; t < tracks.size(); ++t ) {
+        if ( tracks[t].dropped > 0 ) {
+            fprintf( stderr, "WARNING: trace of %s dropped its %lld oldest events; "
+                     "increase MAGMA_TRACE_EVENTS.\n",
+                     tracks[t].name.c_str(), tracks[t].dropped );
+        }
+    }
+}
+
+
+/******************************************************************************/
+// Chrome trace-event format: complete events ("X") for regions, counter
+// events ("C"), metadata ("M") naming the rows; times in microseconds.
+int magma_trace_write_json( const char* filename )
+{
+    std::vector< trace_track > tracks;
+    double time;
+    trace_collect( tracks, time );
+
+    FILE* trace_file = trace_open( filename );
+    if ( trace_file == NULL ) {
+        return -1;
+    }
+    trace_warn_dropped( tracks );
+
+    fprintf( trace_file, "{\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [\n" );
+    fprintf( trace_file, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"CPU\"}}" );
+    #ifdef TRACING
+    fprintf( trace_file, ",\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"GPU\"}}" );
+    #endif
+    for( size_t t = 0; t < tracks.size(); ++t ) {
+        const trace_track& track = tracks[t];
+        fprintf( trace_file, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": ",
+                 track.pid, track.tid );
+        trace_json_string( trace_file, track.name );
+        fprintf( trace_file, "}}" );
+        for( size_t i = 0; i < track.events.size(); ++i ) {
+            const trace_event& ev = track.events[i];
+            fprintf( trace_file, ",\n{\"name\": " );
+            trace_json_string( trace_file, ev.label );
+            if ( ev.depth < 0 ) {
+                fprintf( trace_file, ", \"ph\": \"C\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f, \"args\": {\"value\": %.17g}}",
+                         track.pid, track.tid, ev.start*1e6, ev.value );
+            }
+            else {
+                fprintf( trace_file, ", \"cat\": " );
+                trace_json_string( trace_file, ev.tag );
+                fprintf( trace_file, ", \"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+                         track.pid, track.tid, ev.start*1e6, (ev.end - ev.start)*1e6 );
+                if ( ev.has_ctr ) {
+                    trace_json_counters( trace_file, ev.ctr );
+                }
+                fprintf( trace_file, "}" );
+            }
+        }
+    }
+    fprintf( trace_file, "\n]}\n" );
+    fclose( trace_file );
+    return 0;
+}
+
+
+/******************************************************************************/
+// one row per CPU thread and GPU queue; nested regions are drawn inset
+int magma_trace_write_svg( const char* filename, const char* cssfile )
+{
+    std::vector< trace_track > tracks;
+    double time;
+    trace_collect( tracks, time );
+
     // these are all in SVG "pixels"
     double xscale = 200.; // pixels per second
     double height = 20.;  // of each row
     double margin =  5.;  // page margin and between some elements
     double space  =  2.;  // between rows
     double pad    =  5.;  // around text
+    double inset  =  3.;  // per nesting level
     double label  = 75.;  // width of "CPU:", "GPU:" labels
     double left   = 2*margin + label;
     double xtick  = 0.5;  // interval of xticks (in seconds)
     char buf[ 1024 ];
-    
-    // sync devices
-    for( int dev = 0; dev < glog.ngpu; ++dev ) {
-        magma_setdevice( dev );
-        magma_device_sync();
+
+    // at least 1000 pixels wide, and ticks every 100 pixels or more
+    if ( time*xscale < 1000. && time > 0 ) {
+        xscale = 1000. / time;
     }
-    double time = magma_wtime() - glog.cpu_first;
-    
-    FILE* trace_file = fopen( filename, "w" );
+    while ( xtick*xscale > 200. ) {
+        xtick *= 0.5;
+    }
+
+    FILE* trace_file = trace_open( filename );
     if ( trace_file == NULL ) {
-        strerror_r( errno, buf, sizeof(buf) );
-        fprintf( stderr, "Can't open file '%s': %s (%d)\n", filename, buf, errno );
-        return;
+        return -1;
     }
-    fprintf( stderr, "writing trace to '%s'\n", filename );
-    
-    // row for each CPU and GPU/queue (with space between), time scale, legend
+    trace_warn_dropped( tracks );
+
+    // row for each CPU thread and GPU/queue (with space between), time scale, legend
     // 4 margins: at top, above time scale, above legend, at bottom
-    int h = (int)( (glog.ncore + glog.ngpu*glog.nqueue)*(height + space) - space + 2*height + 4*margin );
+    int h = (int)( tracks.size()*(height + space) - space + 2*height + 4*margin );
     int w = (int)( left + time*xscale + margin );
     fprintf( trace_file,
              "<?xml version=\"1.0\" standalone=\"no\"?>\n"
@@ -199,14 +611,16 @@ void trace_finalize( const char* filename, const char* cssfile )
              "    xmlns:inkscape=\"http://www.inkscape.org/namespaces/inkscape\"\n"
              "    viewBox=\"0 0 %d %d\" width=\"%d\" height=\"%d\" preserveAspectRatio=\"none\">\n\n",
              w, h, w, h );
-    
+
     // Inkscape does not currently (Jan 2012) support external CSS;
     // see http://wiki.inkscape.org/wiki/index.php/CSS_Support
     // So embed CSS file here
-    FILE* css_file = fopen( cssfile, "r" );
+    FILE* css_file = (cssfile != NULL ? fopen( cssfile, "r" ) : NULL);
     if ( css_file == NULL ) {
-        strerror_r( errno, buf, sizeof(buf) );
-        fprintf( stderr, "Can't open file '%s': %s; skipping CSS\n", cssfile, buf );
+        if ( cssfile != NULL ) {
+            strerror_r( errno, buf, sizeof(buf) );
+            fprintf( stderr, "Can't open file '%s': %s; skipping CSS\n", cssfile, buf );
+        }
     }
     else {
         fprintf( trace_file, "<style type=\"text/css\">\n" );
@@ -216,90 +630,49 @@ void trace_finalize( const char* filename, const char* cssfile )
         fclose( css_file );
         fprintf( trace_file, "</style>\n\n" );
     }
-    
+
     // format takes: x, y, width, height, class (tag), id (label)
     const char* format =
-        "<rect x=\"%8.3f\" y=\"%4.0f\" width=\"%8.3f\" height=\"%2.0f\" class=\"%-8s\" inkscape:label=\"%s\"/>\n";
-    
+        "<rect x=\"%8.3f\" y=\"%6.1f\" width=\"%8.3f\" height=\"%4.1f\" class=\"%-8s\" inkscape:label=\"%s\"/>\n";
+
     // accumulate unique legend entries
     std::set< std::string > legend;
-    
-    // output CPU events
+
+    // output events
     double top = margin;
-    for( int core = 0; core < glog.ncore; ++core ) {
-        if ( glog.cpu_id[core] > MAX_EVENTS ) {
-            glog.cpu_id[core] += 1;  // count last event
-            fprintf( stderr, "WARNING: trace on core %d, reached limit of %d events; output will be truncated.\n",
-                     core, glog.cpu_id[core] );
-        }
-        fprintf( trace_file, "<!-- core %d, nevents %d -->\n", core, glog.cpu_id[core] );
-        fprintf( trace_file, "<g inkscape:groupmode=\"layer\" inkscape:label=\"core %d\">\n", core );
-        fprintf( trace_file, "<text x=\"%8.3f\" y=\"%4.0f\" width=\"%4.0f\" height=\"%2.0f\">CPU %d:</text>\n",
+    for( size_t t = 0; t < tracks.size(); ++t ) {
+        const trace_track& track = tracks[t];
+        fprintf( trace_file, "<!-- %s, nevents %lld -->\n",
+                 track.name.c_str(), (long long) track.events.size() );
+        fprintf( trace_file, "<g inkscape:groupmode=\"layer\" inkscape:label=\"%s\">\n",
+                 track.name.c_str() );
+        fprintf( trace_file, "<text x=\"%8.3f\" y=\"%4.0f\" width=\"%4.0f\" height=\"%2.0f\">%s %d:</text>\n",
                  margin,
                  top + height - pad,
                  label, height,
-                 core );
-        for( int i = 0; i < glog.cpu_id[core]; ++i ) {
-            double start  = glog.cpu_start[core][i] - glog.cpu_first;
-            double end    = glog.cpu_end  [core][i] - glog.cpu_first;
+                 (track.pid == 0 ? "CPU" : "GPU"), track.tid );
+        for( size_t i = 0; i < track.events.size(); ++i ) {
+            const trace_event& ev = track.events[i];
+            if ( ev.depth < 0 ) {
+                continue;  // counters are only in the JSON trace
+            }
+            double d = inset * ev.depth;
+            if ( 2*d > height - 2 ) {
+                d = (height - 2) / 2;
+            }
             fprintf( trace_file, format,
-                     left + start*xscale,
-                     top,
-                     (end - start)*xscale,
-                     height,
-                     glog.cpu_tag[core][i],
-                     glog.cpu_label[core][i] );
-            legend.insert( glog.cpu_tag[core][i] );
+                     left + ev.start*xscale,
+                     top + d,
+                     (ev.end - ev.start)*xscale,
+                     height - 2*d,
+                     ev.tag.c_str(),
+                     trace_xml_string( ev.label ).c_str() );
+            legend.insert( ev.tag );
         }
         top += (height + space);
         fprintf( trace_file, "</g>\n\n" );
     }
-    
-    // output GPU events
-    for( int dev = 0; dev < glog.ngpu; ++dev ) {
-        for( int s = 0; s < glog.nqueue; ++s ) {
-            int t = dev*glog.nqueue + s;
-            if ( glog.gpu_id[t] >= MAX_EVENTS-1 ) {
-                glog.gpu_id[t] += 1;  // count last event
-                fprintf( stderr, "WARNING: trace on gpu %d/queue %d reached limit of %d events; output will be truncated.\n",
-                         dev, s, glog.gpu_id[t] );
-            }
-            fprintf( trace_file, "<!-- gpu %d, queue %d (t %d), nevents %d -->\n", dev, s, t, glog.gpu_id[t] );
-            fprintf( trace_file, "<g inkscape:groupmode=\"layer\" inkscape:label=\"gpu %d queue %d\">\n", dev, s );
-            fprintf( trace_file, "<text x=\"%8.3f\" y=\"%4.0f\" width=\"%4.0f\" height=\"%2.0f\">GPU %d (s%d):</text>\n",
-                     margin,
-                     margin + (dev*glog.nqueue + s + glog.ncore)*(height + space) + height - pad,
-                     label, height,
-                     dev, s );
-            magma_setdevice( dev );
-            float start, end;
-            for( int i = 0; i < glog.gpu_id[t]; ++i ) {
-                #if TRACE_METHOD == 2
-                    start = glog.gpu_start[t][i] - glog.cpu_first;
-                    if ( i > 0 ) {
-                        // later of task's CPU start time and previous task's end time
-                        start = max( start, end );
-                    }
-                #else
-                    cudaEventElapsedTime( &start, glog.gpu_first[t], glog.gpu_start[t][i] );
-                    start *= 1e-3;  // ms to seconds
-                #endif
-                cudaEventElapsedTime( &end, glog.gpu_first[t], glog.gpu_end  [t][i] );
-                end   *= 1e-3;  // ms to seconds
-                fprintf( trace_file, format,
-                         left + start*xscale,
-                         top,
-                         (end - start)*xscale,
-                         height,
-                         glog.gpu_tag[t][i],
-                         glog.gpu_label[t][i] );
-                legend.insert( glog.gpu_tag[t][i] );
-            }
-            top += (height + space);
-            fprintf( trace_file, "</g>\n\n" );
-        }
-    }
-    
+
     // output time scale
     top += (-space + margin);
     fprintf( trace_file, "<g inkscape:groupmode=\"layer\" inkscape:label=\"scale\">\n" );
@@ -308,7 +681,7 @@ void trace_finalize( const char* filename, const char* cssfile )
     for( double s=0; s < time; s += xtick ) {
         fprintf( trace_file,
             "<line x1=\"%8.1f\" y1=\"0\" x2=\"%8.1f\" y2=\"%4.0f\"/>"
-            "<text x=\"%8.1f\" y=\"%4.0f\">%4.1f</text>\n",
+            "<text x=\"%8.1f\" y=\"%4.0f\">%.4g</text>\n",
             left + s*xscale,
             left + s*xscale,
             top,
@@ -318,7 +691,7 @@ void trace_finalize( const char* filename, const char* cssfile )
     }
     fprintf( trace_file, "</g>\n\n" );
     top += (height + margin);
-    
+
     // output legend
     fprintf( trace_file, "<g inkscape:groupmode=\"layer\" inkscape:label=\"legend\">\n" );
     fprintf( trace_file, "<text x=\"%8.1f\" y=\"%4.0f\" width=\"%2.0f\" height=\"%2.0f\">Legend:</text>\n",
@@ -333,10 +706,186 @@ void trace_finalize( const char* filename, const char* cssfile )
         x += label + margin;
     }
     fprintf( trace_file, "</g>\n\n" );
-    
+
     fprintf( trace_file, "</svg>\n" );
-    
+
     fclose( trace_file );
+    return 0;
+}
+
+
+/******************************************************************************/
+static bool trace_is_json( const char* filename )
+{
+    size_t len = strlen( filename );
+    return len >= 5 && strcmp( filename + len - 5, ".json" ) == 0;
+}
+
+
+/******************************************************************************/
+static void trace_atexit()
+{
+    if ( trace_is_json( g_filename )) {
+        magma_trace_write_json( g_filename );
+    }
+    else {
+        const char* css = getenv( "MAGMA_TRACE_CSS" );
+        magma_trace_write_svg( g_filename, (css != NULL ? css : "trace.css") );
+    }
+}
+
+
+/******************************************************************************/
+// reads MAGMA_TRACE and MAGMA_TRACE_EVENTS when the library is loaded
+static int trace_setup()
+{
+    int on = 0;
+    #ifdef TRACING
+    on = 1;
+    #endif
+
+    const char* env = getenv( "MAGMA_TRACE" );
+    if ( env != NULL && env[0] != '\0' ) {
+        on = (strcmp( env, "0" ) != 0);
+        if ( on && strcmp( env, "1" ) != 0 ) {
+            strncpy( g_filename, env, sizeof(g_filename)-1 );
+            g_filename[ sizeof(g_filename)-1 ] = '\0';
+            atexit( trace_atexit );
+        }
+    }
+    const char* events = getenv( "MAGMA_TRACE_EVENTS" );
+    if ( events != NULL && atol( events ) > 0 ) {
+        g_capacity = (size_t) atol( events );
+    }
+    g_tick0 = trace_ticks();
+    g_sec0  = trace_seconds();
+    return on;
+}
+
+int magma_trace_on = trace_setup();
+
+
+/******************************************************************************/
+// GPU tracing and the original interface
+#ifdef TRACING
+
+/******************************************************************************/
+static void trace_gpu_clear()
+{
+    for( size_t t = 0; t < g_gpu.size(); ++t ) {
+        magma_setdevice( g_gpu[t].dev );
+        for( size_t i = 0; i < g_gpu[t].events.size(); ++i ) {
+            #if TRACE_METHOD != 2
+            magma_event_destroy( g_gpu[t].events[i].start );
+            #endif
+            magma_event_destroy( g_gpu[t].events[i].end );
+        }
+        magma_event_destroy( g_gpu[t].first );
+    }
+    g_gpu.clear();
+}
+
+
+/******************************************************************************/
+// ncore is ignored: every thread that records events gets its own row
+void trace_init( int ncore, int ngpu, int nqueue, magma_queue_t* queues )
+{
+    trace_gpu_clear();
+    g_nqueue = nqueue;
+
+    for( int dev = 0; dev < ngpu; ++dev ) {
+        magma_setdevice( dev );
+        magma_device_sync();
+    }
+    // now that all GPUs are sync'd, record start time
+    g_gpu.resize( ngpu*nqueue );
+    for( int dev = 0; dev < ngpu; ++dev ) {
+        magma_setdevice( dev );
+        for( int s = 0; s < nqueue; ++s ) {
+            int t = dev*nqueue + s;
+            g_gpu[t].dev       = dev;
+            g_gpu[t].queue_num = s;
+            g_gpu[t].queue     = queues[t];
+            magma_event_create( &g_gpu[t].first );
+            magma_event_record(  g_gpu[t].first, g_gpu[t].queue );
+        }
+    }
+    // sync again
+    for( int dev = 0; dev < ngpu; ++dev ) {
+        magma_setdevice( dev );
+        magma_device_sync();
+    }
+    g_gpu_first = trace_seconds();
+}
+
+
+/******************************************************************************/
+void trace_cpu_start( int core, const char* tag, const char* lbl )
+{
+    magma_trace_begin( tag, lbl );
+}
+
+
+/******************************************************************************/
+void trace_cpu_end( int core )
+{
+    magma_trace_end();
+}
+
+
+/******************************************************************************/
+void trace_gpu_start( int dev, int s, const char* tag, const char* lbl )
+{
+    if ( ! magma_trace_on ) {
+        return;
+    }
+    gpu_log& log = g_gpu[ dev*g_nqueue + s ];
+    gpu_record rec;
+#if TRACE_METHOD == 2
+    rec.start = trace_seconds();
+#else
+    magma_event_create( &rec.start );
+    magma_event_record(  rec.start, log.queue );
+#endif
+    rec.end = NULL;
+    trace_strcpy( rec.tag,   tag );
+    trace_strcpy( rec.label, lbl );
+    log.events.push_back( rec );
+}
+
+
+/******************************************************************************/
+void trace_gpu_end( int dev, int s )
+{
+    if ( ! magma_trace_on ) {
+        return;
+    }
+    gpu_log& log = g_gpu[ dev*g_nqueue + s ];
+    if ( log.events.empty() ) {
+        return;
+    }
+    gpu_record& rec = log.events.back();
+    magma_event_create( &rec.end );
+    magma_event_record(  rec.end, log.queue );
+}
+
+
+/******************************************************************************/
+void trace_finalize( const char* filename, const char* cssfile )
+{
+    // sync devices
+    for( size_t t = 0; t < g_gpu.size(); ++t ) {
+        magma_setdevice( g_gpu[t].dev );
+        magma_device_sync();
+    }
+    if ( trace_is_json( filename )) {
+        magma_trace_write_json( filename );
+    }
+    else {
+        magma_trace_write_svg( filename, cssfile );
+    }
+    trace_gpu_clear();
+    magma_trace_clear();
 }
 
 #endif // TRACING
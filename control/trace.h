@@ -17,13 +17,98 @@
 #endif
 
 // =============================================================================
-const magma_int_t MAX_CORES       = 1;                 // CPU cores
-const magma_int_t MAX_GPU_QUEUES  = MagmaMaxGPUs * 4;  // #devices * #queues per device
-const magma_int_t MAX_EVENTS      = 20000;
-const magma_int_t MAX_LABEL_LEN   = 16;
+const magma_int_t MAX_EVENTS      = 65536;  // default per-thread ring size, see MAGMA_TRACE_EVENTS
+const magma_int_t MAX_LABEL_LEN   = 48;
+const magma_int_t MAX_TRACE_DEPTH = 32;     // deeper nested regions are not recorded
 
 
 // =============================================================================
+// Runtime tracing of CPU regions and counters.
+//
+// Always compiled; enabled by the environment variable MAGMA_TRACE, or by
+// compiling with -DTRACING:
+//     MAGMA_TRACE=0 or unset   disabled (enabled by default with -DTRACING)
+//     MAGMA_TRACE=1            enabled, written by trace_finalize or
+//                              magma_trace_write_{json,svg}
+//     MAGMA_TRACE=file.json    enabled, Chrome trace-event JSON written to file
+//                              at exit (view in Perfetto or chrome://tracing)
+//     MAGMA_TRACE=file.svg     enabled, SVG written to file at exit
+//     MAGMA_TRACE_EVENTS=n     per-thread ring size (default 65536); the
+//                              oldest events are overwritten
+//
+// Each thread records into its own lock-free ring buffer, so any number of
+// threads (pthreads, OpenMP) can record concurrently. The buffer of an
+// exited thread is reused by the next new thread, which continues its track,
+// so memory grows with the number of concurrent threads, not with the number
+// of threads ever created. Regions nest; the timestamps are TSC ticks on x86
+// and CLOCK_MONOTONIC otherwise. When disabled, each call costs one load and
+// branch.
+//
+// With hardware counters also enabled (MAGMA_PERFCTR=1), each region records
+// its thread's counters (see magma_perfctr_read), written as the args of
+// its JSON event; reading them adds about a microsecond per region.
+
+extern int magma_trace_on;
+
+void magma_trace_begin_  ( const char* tag, const char* label );
+void magma_trace_end_    ();
+void magma_trace_counter_( const char* name, double value );
+
+static inline bool magma_trace_enabled()
+{
+    return magma_trace_on != 0;
+}
+
+// starts a region on the calling thread; tag selects the color (CSS class)
+static inline void magma_trace_begin( const char* tag, const char* label )
+{
+    if ( magma_trace_on ) {
+        magma_trace_begin_( tag, label );
+    }
+}
+
+// ends the innermost region of the calling thread
+static inline void magma_trace_end()
+{
+    if ( magma_trace_on ) {
+        magma_trace_end_();
+    }
+}
+
+// records the current value of a counter
+static inline void magma_trace_counter( const char* name, double value )
+{
+    if ( magma_trace_on ) {
+        magma_trace_counter_( name, value );
+    }
+}
+
+// region of a scope
+class magma_trace_region
+{
+public:
+    magma_trace_region( const char* tag, const char* label )
+    {
+        magma_trace_begin( tag, label );
+    }
+    ~magma_trace_region()
+    {
+        magma_trace_end();
+    }
+};
+
+// write all recorded events; return 0 on success, -1 if the file can't be opened.
+// Events recorded while writing may be missing or, if the ring wraps, torn.
+int  magma_trace_write_json( const char* filename );
+int  magma_trace_write_svg ( const char* filename, const char* cssfile );  // cssfile may be NULL
+
+// discard all recorded events
+void magma_trace_clear();
+
+
+// =============================================================================
+// Tracing of GPU queues, compiled only with -DTRACING.
+// trace_cpu_start/end record regions of the calling thread (core is ignored).
 #ifdef TRACING
 
 void trace_init     ( magma_int_t ncore, magma_int_t ngpu, magma_int_t nqueue, magma_queue_t *queues );
@@ -36,6 +121,7 @@ magma_event_t*
 void trace_gpu_start( magma_int_t dev, magma_int_t queue_num, const char* tag, const char* label );
 void trace_gpu_end  ( magma_int_t dev, magma_int_t queue_num );
 
+// writes Chrome JSON if filename ends in .json, else SVG; then clears the trace
 void trace_finalize ( const char* filename, const char* cssfile );
 
 #else
@@ -49,6 +49,61 @@ real_Double_t magma_wtime( void );
 real_Double_t magma_sync_wtime( magma_queue_t queue );
 
 
+// =============================================================================
+// performance metrics, see also $MAGMA_METRICS
+
+void        magma_metrics_enable( magma_int_t enable );
+magma_int_t magma_metrics_enabled( void );
+void        magma_metrics_reset( void );
+
+magma_int_t magma_metrics_snapshot( char* buffer, size_t size, magma_int_t json );
+magma_int_t magma_metrics_dump( const char* filename, magma_int_t json );
+
+
+// =============================================================================
+// tuning database, see also $MAGMA_TUNE_FILE
+
+magma_int_t magma_tune_load( const char* filename );
+magma_int_t magma_tune_save( const char* filename );
+
+magma_int_t magma_tune_get(
+    const char* param, char precision, magma_int_t m, magma_int_t n,
+    magma_int_t* value );
+
+void        magma_tune_set(
+    const char* param, char precision, magma_int_t m, magma_int_t n,
+    magma_int_t value );
+
+void        magma_tune_clear( void );
+
+
+// =============================================================================
+// hardware counters, see also $MAGMA_PERFCTR
+
+// counts of the calling thread; -1 if unavailable
+typedef struct magma_perfctr_t
+{
+    long long cycles;
+    long long instructions;
+    long long llc_misses;
+    long long mem_bytes;      // estimated as llc_misses * cache line size
+    long long fp_ops;
+} magma_perfctr_t;
+
+void        magma_perfctr_enable( magma_int_t enable );
+magma_int_t magma_perfctr_enabled( void );
+void        magma_perfctr_read( magma_perfctr_t* counters );
+
+
+// =============================================================================
+// thread budget, see also $MAGMA_THREAD_LOG
+
+typedef void (*magma_thread_log_t)( const char* message, void* user_data );
+
+void        magma_thread_budget_set_log( magma_thread_log_t callback, void* user_data );
+magma_int_t magma_thread_budget_available( void );
+
+
 // =============================================================================
 // misc. functions
 
@@ -90,6 +145,27 @@ magma_malloc_pinned( void **ptr_ptr, size_t bytes );
 magma_int_t
 magma_free_cpu( void *ptr );
 
+// pooled host allocator behind magma_malloc_cpu, see also $MAGMA_HOST_POOL
+typedef enum {
+    MagmaHostPoolEnable    = 0x01,
+    MagmaHostPoolHugePages = 0x02,
+    MagmaHostPoolNuma      = 0x04,
+    MagmaHostPoolSites     = 0x08,
+    MagmaHostPoolStats     = 0x10
+} magma_host_pool_option_t;
+
+magma_int_t
+magma_host_pool_enable( magma_int_t options, size_t max_cached );
+
+void
+magma_host_pool_trim( void );
+
+void
+magma_host_pool_stats( size_t *live, size_t *peak, size_t *mapped );
+
+void
+magma_host_pool_print( void );
+
 #define magma_free( ptr ) \
         magma_free_internal( ptr, __func__, __FILE__, __LINE__ )
 
@@ -342,6 +418,45 @@ void
 magma_queue_wait_event( magma_queue_t queue, magma_event_t event );
 
 
+// =============================================================================
+// CPU queues, for asynchronous CPU stages
+
+struct magma_cpu_queue;
+struct magma_cpu_task;
+typedef struct magma_cpu_queue* magma_cpu_queue_t;
+typedef struct magma_cpu_task*  magma_cpu_task_t;
+
+// returns info, e.g., of the stage it runs; returned by magma_cpu_task_wait
+typedef magma_int_t (*magma_cpu_func_t)( void* arg );
+
+magma_int_t
+magma_cpu_queue_create( magma_int_t nthreads, magma_cpu_queue_t* queue_ptr );
+
+void
+magma_cpu_queue_destroy( magma_cpu_queue_t queue );
+
+void
+magma_cpu_queue_sync( magma_cpu_queue_t queue );
+
+magma_int_t
+magma_cpu_queue_wait_event( magma_cpu_queue_t queue, magma_event_t event );
+
+magma_int_t
+magma_cpu_task_submit(
+    magma_cpu_queue_t queue, magma_cpu_func_t func, void* arg,
+    magma_int_t ndeps, const magma_cpu_task_t* deps,
+    magma_cpu_task_t* task_ptr );
+
+magma_int_t
+magma_cpu_task_query( magma_cpu_task_t task );
+
+magma_int_t
+magma_cpu_task_wait( magma_cpu_task_t task );
+
+void
+magma_cpu_task_destroy( magma_cpu_task_t task );
+
+
 // =============================================================================
 // error handler
 
@@ -20,7 +20,7 @@
 
 
 // each implementation of MAGMA defines HAVE_* appropriately.
-#if ! defined(HAVE_CUBLAS) && ! defined(HAVE_clBLAS) && ! defined(HAVE_MIC) && ! defined(HAVE_HIP)
+#if ! defined(HAVE_CUBLAS) && ! defined(HAVE_clBLAS) && ! defined(HAVE_MIC) && ! defined(HAVE_HIP) && ! defined(HAVE_HOST)
 // Pytorch requires that the error commented out below is not produced and that HAVE_CUBLAS is defined:
 // #error No 'HAVE_*' macros were set! (defaulting to CUBLAS)
 #define HAVE_CUBLAS
@@ -464,11 +464,115 @@ typedef double real_Double_t;
     #define MAGMA_C_ABS1(a)       (fabs((a).real()) + fabs((a).imag()))
     #define MAGMA_C_CONJ(a)       conj(a)
 
+    #ifdef __cplusplus
+    }
+    #endif
+#elif defined(HAVE_HOST)
+    // host-emulated devices: device memory is host memory, and each queue is
+    // a worker thread running its operations in order on the host BLAS;
+    // see interface_host/interface.cpp
+
+    // no device code; shared host/device helpers are plain host functions
+    #ifndef __host__
+    #define __host__
+    #endif
+    #ifndef __device__
+    #define __device__
+    #endif
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+    // opaque queue and event structures
+    struct magma_queue;
+    struct magma_event;
+    typedef struct magma_queue* magma_queue_t;
+    typedef struct magma_event* magma_event_t;
+    typedef int                 magma_device_t;
+
+    typedef short            magmaHalf;    // placeholder, no half precision on host
+
+    // same layout as std::complex and Fortran complex, as on the GPU backends
+    typedef struct { double x, y; } magmaDoubleComplex;
+    typedef struct { float  x, y; } magmaFloatComplex;
+
+    static inline magmaDoubleComplex magma_host_zmake( double r, double i ) {
+        magmaDoubleComplex z;  z.x = r;  z.y = i;  return z;
+    }
+    static inline magmaFloatComplex magma_host_cmake( float r, float i ) {
+        magmaFloatComplex c;  c.x = r;  c.y = i;  return c;
+    }
+
+    #define MAGMA_Z_MAKE(r, i)    magma_host_zmake( (double)(r), (double)(i) )
+    #define MAGMA_Z_REAL(a)       (a).x
+    #define MAGMA_Z_IMAG(a)       (a).y
+    #define MAGMA_Z_ADD(a, b)     magmaCadd(a, b)
+    #define MAGMA_Z_SUB(a, b)     magmaCsub(a, b)
+    #define MAGMA_Z_MUL(a, b)     magmaCmul(a, b)
+    #define MAGMA_Z_DIV(a, b)     magmaCdiv(a, b)
+    #define MAGMA_Z_ABS(a)        (hypot(MAGMA_Z_REAL(a), MAGMA_Z_IMAG(a)))
+    #define MAGMA_Z_ABS1(a)       (fabs(MAGMA_Z_REAL(a)) + fabs(MAGMA_Z_IMAG(a)))
+    #define MAGMA_Z_CONJ(a)       magmaConj(a)
+
+    #define MAGMA_C_MAKE(r, i)    magma_host_cmake( (float)(r), (float)(i) )
+    #define MAGMA_C_REAL(a)       (a).x
+    #define MAGMA_C_IMAG(a)       (a).y
+    #define MAGMA_C_ADD(a, b)     magmaCaddf(a, b)
+    #define MAGMA_C_SUB(a, b)     magmaCsubf(a, b)
+    #define MAGMA_C_MUL(a, b)     magmaCmulf(a, b)
+    #define MAGMA_C_DIV(a, b)     magmaCdivf(a, b)
+    #define MAGMA_C_ABS(a)        (hypotf(MAGMA_C_REAL(a), MAGMA_C_IMAG(a)))
+    #define MAGMA_C_ABS1(a)       (fabsf(MAGMA_C_REAL(a)) + fabsf(MAGMA_C_IMAG(a)))
+    #define MAGMA_C_CONJ(a)       magmaConjf(a)
+
+    static inline magmaDoubleComplex magmaCadd( magmaDoubleComplex a, magmaDoubleComplex b ) {
+        return MAGMA_Z_MAKE( a.x + b.x, a.y + b.y );
+    }
+    static inline magmaDoubleComplex magmaCsub( magmaDoubleComplex a, magmaDoubleComplex b ) {
+        return MAGMA_Z_MAKE( a.x - b.x, a.y - b.y );
+    }
+    static inline magmaDoubleComplex magmaCmul( magmaDoubleComplex a, magmaDoubleComplex b ) {
+        return MAGMA_Z_MAKE( a.x*b.x - a.y*b.y, a.x*b.y + a.y*b.x );
+    }
+    static inline magmaDoubleComplex magmaCdiv( magmaDoubleComplex a, magmaDoubleComplex b ) {
+        double sqabs = b.x*b.x + b.y*b.y;
+        return MAGMA_Z_MAKE( (a.x*b.x + a.y*b.y) / sqabs,
+                             (a.y*b.x - a.x*b.y) / sqabs );
+    }
+    static inline magmaDoubleComplex magmaConj( magmaDoubleComplex a ) {
+        return MAGMA_Z_MAKE( a.x, -a.y );
+    }
+    static inline magmaDoubleComplex magmaCfma( magmaDoubleComplex a, magmaDoubleComplex b, magmaDoubleComplex c ) {
+        return magmaCadd( magmaCmul( a, b ), c );
+    }
+
+    static inline magmaFloatComplex magmaCaddf( magmaFloatComplex a, magmaFloatComplex b ) {
+        return MAGMA_C_MAKE( a.x + b.x, a.y + b.y );
+    }
+    static inline magmaFloatComplex magmaCsubf( magmaFloatComplex a, magmaFloatComplex b ) {
+        return MAGMA_C_MAKE( a.x - b.x, a.y - b.y );
+    }
+    static inline magmaFloatComplex magmaCmulf( magmaFloatComplex a, magmaFloatComplex b ) {
+        return MAGMA_C_MAKE( a.x*b.x - a.y*b.y, a.x*b.y + a.y*b.x );
+    }
+    static inline magmaFloatComplex magmaCdivf( magmaFloatComplex a, magmaFloatComplex b ) {
+        float sqabs = b.x*b.x + b.y*b.y;
+        return MAGMA_C_MAKE( (a.x*b.x + a.y*b.y) / sqabs,
+                             (a.y*b.x - a.x*b.y) / sqabs );
+    }
+    static inline magmaFloatComplex magmaConjf( magmaFloatComplex a ) {
+        return MAGMA_C_MAKE( a.x, -a.y );
+    }
+    static inline magmaFloatComplex magmaCfmaf( magmaFloatComplex a, magmaFloatComplex b, magmaFloatComplex c ) {
+        return magmaCaddf( magmaCmulf( a, b ), c );
+    }
+
     #ifdef __cplusplus
     }
     #endif
 #else
-    #error "One of HAVE_CUBLAS, HAVE_HIP, HAVE_clBLAS, or HAVE_MIC must be defined. For example, add -DHAVE_CUBLAS to CFLAGS, or #define HAVE_CUBLAS before #include <magma.h>. In MAGMA, this happens in Makefile."
+    #error "One of HAVE_CUBLAS, HAVE_HIP, HAVE_clBLAS, HAVE_MIC, or HAVE_HOST must be defined. For example, add -DHAVE_CUBLAS to CFLAGS, or #define HAVE_CUBLAS before #include <magma.h>. In MAGMA, this happens in Makefile."
 #endif
 
 #ifdef __cplusplus
@@ -850,7 +954,14 @@ typedef enum {
     Magma_VBJACOBI     = 508,
     Magma_PARDISO      = 509,
     Magma_SYNCFREESOLVE= 510,
-    Magma_ILUT         = 511
+    Magma_ILUT         = 511,
+    Magma_LEVELSOLVE   = 512,
+    Magma_BLOCKLEVELSOLVE  = 513,
+    Magma_CPUSYNCFREESOLVE = 514,
+    Magma_BLOCKJACOBI  = 515,
+    Magma_SSOR         = 516,
+    Magma_AMG          = 517,
+    Magma_RAS          = 518
 } magma_solver_type;
 
 typedef enum {
@@ -880,7 +991,8 @@ typedef enum {
     Magma_DCOMPLEX     = 501,
     Magma_FCOMPLEX     = 502,
     Magma_DOUBLE       = 503,
-    Magma_FLOAT        = 504
+    Magma_FLOAT        = 504,
+    Magma_BFLOAT16     = 505
 } magma_precision;
 
 typedef enum {
@@ -890,8 +1002,17 @@ typedef enum {
     Magma_UNITCOL      = 514,
     Magma_UNITROWCOL   = 515, // to be deprecated
     Magma_UNITDIAGCOL  = 516, // to be deprecated
+    Magma_MAXNORM      = 517,
+    Magma_RUIZ         = 518
 } magma_scale_t;
 
+typedef enum {
+    Magma_NOREORDER    = 521,
+    Magma_RCM          = 522,
+    Magma_AMD          = 523,
+    Magma_MULTICOLOR   = 524
+} magma_reorder_t;
+
 
 typedef enum {
     Magma_SOLVE        = 801,
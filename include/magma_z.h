@@ -56,6 +56,7 @@ magma_int_t magma_get_zgesvd_nb( magma_int_t m, magma_int_t n );
 magma_int_t magma_get_zbulge_nb( magma_int_t n, magma_int_t nbthreads );
 magma_int_t magma_get_zbulge_nb_mgpu( magma_int_t n );
 magma_int_t magma_get_zbulge_vblksiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads );
+magma_int_t magma_get_zbulge_grsiz( magma_int_t n, magma_int_t nb, magma_int_t nbthreads );
 magma_int_t magma_get_zbulge_gcperf();
 
 
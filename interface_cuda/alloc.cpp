@@ -21,6 +21,8 @@
 #include "magma_v2.h"
 #include "magma_internal.h"
 #include "error.h"
+#include "magma_metrics.h"
+#include "magma_host_pool.h"
 
 //#ifdef HAVE_CUBLAS
 
@@ -73,6 +75,7 @@ magma_malloc( magma_ptr* ptrPtr, size_t size )
     g_pointers_mutex.unlock();
     #endif
 
+    magma_metrics_alloc( MagmaMetricsDevice, size );
     return MAGMA_SUCCESS;
 }
 
@@ -120,6 +123,8 @@ magma_free_internal( magma_ptr ptr,
     for vector (SSE, AVX) instructions. The default implementation uses
     posix_memalign (on Linux, MacOS, etc.) or _aligned_malloc (on Windows)
     to align memory to a 64 byte boundary (typical cache line size).
+    If enabled by magma_host_pool_enable or $MAGMA_HOST_POOL, memory comes
+    from a pool that caches freed memory instead.
     Use magma_free_cpu() to free this memory.
 
     @param[out]
@@ -148,25 +153,33 @@ magma_malloc_cpu( void** ptrPtr, size_t size )
     // malloc and free sometimes don't work for size=0, so allocate some minimal size
     if ( size == 0 )
         size = sizeof(magmaDoubleComplex);
+    if ( magma_host_pool_on ) {
+        *ptrPtr = magma_host_pool_malloc( size, magma_host_pool_caller() );
+        if ( *ptrPtr == NULL ) {
+            return MAGMA_ERR_HOST_ALLOC;
+        }
+    }
+    else {
 #if 1
 #if defined( _WIN32 ) || defined( _WIN64 )
-    *ptrPtr = _aligned_malloc( size, 64 );
-    if ( *ptrPtr == NULL ) {
-        return MAGMA_ERR_HOST_ALLOC;
-    }
+        *ptrPtr = _aligned_malloc( size, 64 );
+        if ( *ptrPtr == NULL ) {
+            return MAGMA_ERR_HOST_ALLOC;
+        }
 #else
-    int err = posix_memalign( ptrPtr, 64, size );
-    if ( err != 0 ) {
-        *ptrPtr = NULL;
-        return MAGMA_ERR_HOST_ALLOC;
-    }
+        int err = posix_memalign( ptrPtr, 64, size );
+        if ( err != 0 ) {
+            *ptrPtr = NULL;
+            return MAGMA_ERR_HOST_ALLOC;
+        }
 #endif
 #else
-    *ptrPtr = malloc( size );
-    if ( *ptrPtr == NULL ) {
-        return MAGMA_ERR_HOST_ALLOC;
-    }
+        *ptrPtr = malloc( size );
+        if ( *ptrPtr == NULL ) {
+            return MAGMA_ERR_HOST_ALLOC;
+        }
 #endif
+    }
 
     #ifdef DEBUG_MEMORY
     g_pointers_mutex.lock();
@@ -174,6 +187,7 @@ magma_malloc_cpu( void** ptrPtr, size_t size )
     g_pointers_mutex.unlock();
     #endif
 
+    magma_metrics_alloc( MagmaMetricsHost, size );
     return MAGMA_SUCCESS;
 }
 
@@ -206,6 +220,10 @@ magma_free_cpu( void* ptr )
     g_pointers_mutex.unlock();
     #endif
 
+    // pointers from the pool, even if it has since been disabled
+    if ( magma_host_pool_used && magma_host_pool_free( ptr ) ) {
+        return MAGMA_SUCCESS;
+    }
 #if defined( _WIN32 ) || defined( _WIN64 )
     _aligned_free( ptr );
 #else
@@ -256,6 +274,7 @@ magma_malloc_pinned( void** ptrPtr, size_t size )
     g_pointers_mutex.unlock();
     #endif
 
+    magma_metrics_alloc( MagmaMetricsPinned, size );
     return MAGMA_SUCCESS;
 }
 
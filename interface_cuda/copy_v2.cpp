@@ -9,6 +9,7 @@
 */
 #include "magma_internal.h"
 #include "error.h"
+#include "magma_metrics.h"
 
 #include <cuda_runtime.h>
 
@@ -59,6 +60,7 @@ magma_setvector_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsHostToDevice, uint64_t(n)*elemSize );
     assert( queue != NULL );
     cublasStatus_t status;
     status = cublasSetVectorAsync(
@@ -113,6 +115,7 @@ magma_setvector_async_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsHostToDevice, uint64_t(n)*elemSize );
     // for backwards compatability, accepts NULL queue to mean NULL stream.
     cudaStream_t stream = NULL;
     if ( queue != NULL ) {
@@ -172,6 +175,7 @@ magma_getvector_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsDeviceToHost, uint64_t(n)*elemSize );
     cublasStatus_t status;
     status = cublasGetVectorAsync(
         int(n), int(elemSize),
@@ -225,6 +229,7 @@ magma_getvector_async_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsDeviceToHost, uint64_t(n)*elemSize );
     // for backwards compatability, accepts NULL queue to mean NULL stream.
     cudaStream_t stream = NULL;
     if ( queue != NULL ) {
@@ -289,6 +294,7 @@ magma_copyvector_internal(
 {
     assert( queue != NULL );
     if ( incx == 1 && incy == 1 ) {
+        magma_metrics_transfer( MagmaMetricsDeviceToDevice, uint64_t(n)*elemSize );
         cudaError_t status;
         status = cudaMemcpyAsync(
             dy_dst,
@@ -356,6 +362,7 @@ magma_copyvector_async_internal(
         fprintf( stderr, "Warning: %s got NULL queue\n", __func__ );
     }
     if ( incx == 1 && incy == 1 ) {
+        magma_metrics_transfer( MagmaMetricsDeviceToDevice, uint64_t(n)*elemSize );
         cudaError_t status;
         status = cudaMemcpyAsync(
             dy_dst,
@@ -415,6 +422,7 @@ magma_setmatrix_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsHostToDevice, uint64_t(m)*n*elemSize );
     assert( queue != NULL );
     cublasStatus_t status;
     status = cublasSetMatrixAsync(
@@ -472,6 +480,7 @@ magma_setmatrix_async_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsHostToDevice, uint64_t(m)*n*elemSize );
     // for backwards compatability, accepts NULL queue to mean NULL stream.
     cudaStream_t stream = NULL;
     if ( queue != NULL ) {
@@ -534,6 +543,7 @@ magma_getmatrix_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsDeviceToHost, uint64_t(m)*n*elemSize );
     assert( queue != NULL );
     cublasStatus_t status;
     status = cublasGetMatrixAsync(
@@ -591,6 +601,7 @@ magma_getmatrix_async_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsDeviceToHost, uint64_t(m)*n*elemSize );
     cudaStream_t stream = NULL;
     if ( queue != NULL ) {
         stream = queue->cuda_stream();
@@ -653,6 +664,7 @@ magma_copymatrix_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsDeviceToDevice, uint64_t(m)*n*elemSize );
     assert( queue != NULL );
     cudaError_t status;
     status = cudaMemcpy2DAsync(
@@ -710,6 +722,7 @@ magma_copymatrix_async_internal(
     magma_queue_t queue,
     const char* func, const char* file, int line )
 {
+    magma_metrics_transfer( MagmaMetricsDeviceToDevice, uint64_t(m)*n*elemSize );
     // for backwards compatability, accepts NULL queue to mean NULL stream.
     cudaStream_t stream = NULL;
     if ( queue != NULL ) {
@@ -39,6 +39,7 @@
 
 #include "magma_internal.h"
 #include "error.h"
+#include "magma_host_pool.h"
 
 #define MAX_BATCHCOUNT    (65534)
 
@@ -180,6 +181,9 @@ magma_init()
     g_mutex.lock();
     {
         if ( g_init == 0 ) {
+            // before any magma_malloc_cpu
+            magma_host_pool_init();
+
             // query number of devices
             cudaError_t err;
             g_magma_devices_cnt = 0;
@@ -295,6 +299,8 @@ magma_finalize()
                 #endif
                 #endif // MAGMA_NO_V1
 
+                magma_host_pool_finalize();
+
                 #ifdef DEBUG_MEMORY
                 magma_warn_leaks( g_pointers_dev, "device" );
                 magma_warn_leaks( g_pointers_cpu, "CPU" );
@@ -0,0 +1,829 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+#include "error.h"
+
+#define COMPLEX
+
+#define PRECISION_z
+
+#ifdef HAVE_HOST
+
+// BLAS on host-emulated devices: each routine is queued on the queue's worker
+// thread and runs the host BLAS there, asynchronously, as cuBLAS runs on the
+// queue's stream. Routines that return a result synchronize, as cuBLAS does
+// with results in host memory. Arguments are as in interface_cuda/blas_z_v2.cpp.
+
+#ifdef REAL
+// modified Givens rotations exist only in real precisions,
+// so are not in magma_zlapack.h
+#define blasf77_zrotm      FORTRAN_NAME( zrotm,  ZROTM  )
+#define blasf77_zrotmg     FORTRAN_NAME( zrotmg, ZROTMG )
+
+extern "C" {
+void blasf77_zrotm(  const magma_int_t *n,
+                     double *x, const magma_int_t *incx,
+                     double *y, const magma_int_t *incy,
+                     const double *param );
+
+void blasf77_zrotmg( double *d1, double *d2,
+                     double *x1, const double *y1,
+                     double *param );
+}
+#endif // REAL
+
+
+// =============================================================================
+// Level 1 BLAS
+
+/***************************************************************************//**
+    @return Index of element of vector x having max. absolute value.
+    @ingroup magma_iamax
+*******************************************************************************/
+extern "C" magma_int_t
+magma_izamax(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_int_t result = 0;
+    magma_host_enqueue_sync( queue, [=, &result] {
+        result = blasf77_izamax( &n, dx, &incx );
+    });
+    return result;
+}
+
+
+/***************************************************************************//**
+    @return Index of element of vector x having min. absolute value.
+    @ingroup magma_iamin
+*******************************************************************************/
+extern "C" magma_int_t
+magma_izamin(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    // no izamin in reference BLAS
+    magma_int_t result = 0;
+    magma_host_enqueue_sync( queue, [=, &result] {
+        double amin = 0;
+        for( magma_int_t i = 0; i < n; ++i ) {
+            double a = MAGMA_Z_ABS1( dx[ i*incx ] );
+            if ( i == 0 || a < amin ) {
+                amin   = a;
+                result = i + 1;
+            }
+        }
+    });
+    return result;
+}
+
+
+/***************************************************************************//**
+    @return Sum of absolute values of vector x.
+    @ingroup magma_asum
+*******************************************************************************/
+extern "C" double
+magma_dzasum(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    double result = 0;
+    magma_host_enqueue_sync( queue, [=, &result] {
+        result = magma_cblas_dzasum( n, dx, incx );
+    });
+    return result;
+}
+
+
+/***************************************************************************//**
+    Constant times a vector plus a vector; \f$ y = \alpha x + y \f$.
+    @ingroup magma_axpy
+*******************************************************************************/
+extern "C" void
+magma_zaxpy(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zaxpy( &n, &alpha, dx, &incx, dy, &incy );
+    });
+}
+
+
+/***************************************************************************//**
+    Copy vector x to vector y; \f$ y = x \f$.
+    @ingroup magma_copy
+*******************************************************************************/
+extern "C" void
+magma_zcopy(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zcopy( &n, dx, &incx, dy, &incy );
+    });
+}
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    @return Dot product of vectors x and y; \f$ x^H y \f$.
+    @ingroup magma__dot
+*******************************************************************************/
+extern "C"
+magmaDoubleComplex magma_zdotc(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magmaDoubleComplex result = MAGMA_Z_ZERO;
+    magma_host_enqueue_sync( queue, [=, &result] {
+        result = magma_cblas_zdotc( n, dx, incx, dy, incy );
+    });
+    return result;
+}
+#endif // COMPLEX
+
+
+/***************************************************************************//**
+    @return Dot product (unconjugated) of vectors x and y; \f$ x^T y \f$.
+    @ingroup magma__dot
+*******************************************************************************/
+extern "C"
+magmaDoubleComplex magma_zdotu(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magmaDoubleComplex result = MAGMA_Z_ZERO;
+    magma_host_enqueue_sync( queue, [=, &result] {
+        result = magma_cblas_zdotu( n, dx, incx, dy, incy );
+    });
+    return result;
+}
+
+
+/***************************************************************************//**
+    @return 2-norm of vector x; \f$ \text{sqrt}( x^H x ) \f$.
+    @ingroup magma_nrm2
+*******************************************************************************/
+extern "C" double
+magma_dznrm2(
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    double result = 0;
+    magma_host_enqueue_sync( queue, [=, &result] {
+        result = magma_cblas_dznrm2( n, dx, incx );
+    });
+    return result;
+}
+
+
+/***************************************************************************//**
+    Apply Givens plane rotation.
+    @ingroup magma_rot
+*******************************************************************************/
+extern "C" void
+magma_zrot(
+    magma_int_t n,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr dy, magma_int_t incy,
+    double c, magmaDoubleComplex s,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zrot( &n, dx, &incx, dy, &incy, &c, &s );
+    });
+}
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Apply Givens plane rotation, with real cosine and sine.
+    @ingroup magma_rot
+*******************************************************************************/
+extern "C" void
+magma_zdrot(
+    magma_int_t n,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr dy, magma_int_t incy,
+    double c, double s,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zdrot( &n, dx, &incx, dy, &incy, &c, &s );
+    });
+}
+#endif // COMPLEX
+
+
+/***************************************************************************//**
+    Construct Givens plane rotation. Arguments are in host memory,
+    so this runs immediately.
+    @ingroup magma_rotg
+*******************************************************************************/
+extern "C" void
+magma_zrotg(
+    magmaDoubleComplex *a, magmaDoubleComplex *b,
+    double             *c, magmaDoubleComplex *s,
+    magma_queue_t queue )
+{
+    blasf77_zrotg( a, b, c, s );
+}
+
+
+#ifdef REAL
+/***************************************************************************//**
+    Apply modified plane rotation.
+    @ingroup magma_rotm
+*******************************************************************************/
+extern "C" void
+magma_zrotm(
+    magma_int_t n,
+    double *dx, magma_int_t incx,
+    double *dy, magma_int_t incy,
+    const double *param,
+    magma_queue_t queue )
+{
+    // param is in host memory, so copy it now
+    double p[5] = { param[0], param[1], param[2], param[3], param[4] };
+    magma_host_enqueue( queue, [=] {
+        blasf77_zrotm( &n, dx, &incx, dy, &incy, p );
+    });
+}
+#endif // REAL
+
+
+#ifdef REAL
+/***************************************************************************//**
+    Construct modified plane rotation. Arguments are in host memory,
+    so this runs immediately.
+    @ingroup magma_rotmg
+*******************************************************************************/
+extern "C" void
+magma_zrotmg(
+    double *d1, double       *d2,
+    double *x1, const double *y1,
+    double *param,
+    magma_queue_t queue )
+{
+    blasf77_zrotmg( d1, d2, x1, y1, param );
+}
+#endif // REAL
+
+
+/***************************************************************************//**
+    Scales a vector by a constant; \f$ x = \alpha x \f$.
+    @ingroup magma_scal
+*******************************************************************************/
+extern "C" void
+magma_zscal(
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zscal( &n, &alpha, dx, &incx );
+    });
+}
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Scales a vector by a real constant; \f$ x = \alpha x \f$.
+    @ingroup magma_scal
+*******************************************************************************/
+extern "C" void
+magma_zdscal(
+    magma_int_t n,
+    double alpha,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zdscal( &n, &alpha, dx, &incx );
+    });
+}
+#endif // COMPLEX
+
+
+/***************************************************************************//**
+    Swap vector x and y; \f$ x <-> y \f$.
+    @ingroup magma_swap
+*******************************************************************************/
+extern "C" void
+magma_zswap(
+    magma_int_t n,
+    magmaDoubleComplex_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zswap( &n, dx, &incx, dy, &incy );
+    });
+}
+
+
+// =============================================================================
+// Level 2 BLAS
+
+/***************************************************************************//**
+    Perform matrix-vector product.
+    @ingroup magma_gemv
+*******************************************************************************/
+extern "C" void
+magma_zgemv(
+    magma_trans_t transA,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zgemv( lapack_trans_const( transA ), &m, &n,
+                       &alpha, dA, &ldda, dx, &incx,
+                       &beta,  dy, &incy );
+    });
+}
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Perform rank-1 update, \f$ A = \alpha x y^H + A \f$.
+    @ingroup magma_ger
+*******************************************************************************/
+extern "C" void
+magma_zgerc(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zgerc( &m, &n, &alpha, dx, &incx, dy, &incy, dA, &ldda );
+    });
+}
+#endif // COMPLEX
+
+
+/***************************************************************************//**
+    Perform rank-1 update (unconjugated), \f$ A = \alpha x y^T + A \f$.
+    @ingroup magma_ger
+*******************************************************************************/
+extern "C" void
+magma_zgeru(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zgeru( &m, &n, &alpha, dx, &incx, dy, &incy, dA, &ldda );
+    });
+}
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Perform Hermitian matrix-vector product, \f$ y = \alpha A x + \beta y \f$.
+    @ingroup magma_hemv
+*******************************************************************************/
+extern "C" void
+magma_zhemv(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zhemv( lapack_uplo_const( uplo ), &n,
+                       &alpha, dA, &ldda, dx, &incx,
+                       &beta,  dy, &incy );
+    });
+}
+#endif // COMPLEX
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Perform Hermitian rank-1 update, \f$ A = \alpha x x^H + A \f$.
+    @ingroup magma_her
+*******************************************************************************/
+extern "C" void
+magma_zher(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    double alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zher( lapack_uplo_const( uplo ), &n,
+                      &alpha, dx, &incx, dA, &ldda );
+    });
+}
+#endif // COMPLEX
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Perform Hermitian rank-2 update, \f$ A = \alpha x y^H + conj(\alpha) y x^H + A \f$.
+    @ingroup magma_her2
+*******************************************************************************/
+extern "C" void
+magma_zher2(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zher2( lapack_uplo_const( uplo ), &n,
+                       &alpha, dx, &incx, dy, &incy, dA, &ldda );
+    });
+}
+#endif // COMPLEX
+
+
+/***************************************************************************//**
+    Perform symmetric matrix-vector product, \f$ y = \alpha A x + \beta y \f$.
+    @ingroup magma_symv
+*******************************************************************************/
+extern "C" void
+magma_zsymv(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        #ifdef COMPLEX
+        lapackf77_zsymv( lapack_uplo_const( uplo ), &n,
+                         &alpha, dA, &ldda, dx, &incx,
+                         &beta,  dy, &incy );
+        #else
+        blasf77_zsymv( lapack_uplo_const( uplo ), &n,
+                       &alpha, dA, &ldda, dx, &incx,
+                       &beta,  dy, &incy );
+        #endif
+    });
+}
+
+
+/***************************************************************************//**
+    Perform symmetric rank-1 update, \f$ A = \alpha x x^T + A \f$.
+    @ingroup magma_syr
+*******************************************************************************/
+extern "C" void
+magma_zsyr(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        #ifdef COMPLEX
+        lapackf77_zsyr( lapack_uplo_const( uplo ), &n,
+                        &alpha, dx, &incx, dA, &ldda );
+        #else
+        blasf77_zsyr( lapack_uplo_const( uplo ), &n,
+                      &alpha, dx, &incx, dA, &ldda );
+        #endif
+    });
+}
+
+
+/***************************************************************************//**
+    Perform symmetric rank-2 update, \f$ A = \alpha x y^T + \alpha y x^T + A \f$.
+    @ingroup magma_syr2
+*******************************************************************************/
+extern "C" void
+magma_zsyr2(
+    magma_uplo_t uplo,
+    magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex_const_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr       dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        #ifdef COMPLEX
+        // no complex symmetric rank-2 update in BLAS or LAPACK
+        for( magma_int_t j = 0; j < n; ++j ) {
+            magmaDoubleComplex ax = alpha * dx[ j*incx ];
+            magmaDoubleComplex ay = alpha * dy[ j*incy ];
+            magma_int_t i0 = (uplo == MagmaLower ? j : 0);
+            magma_int_t i1 = (uplo == MagmaLower ? n : j+1);
+            for( magma_int_t i = i0; i < i1; ++i ) {
+                dA[ i + j*ldda ] += dx[ i*incx ]*ay + dy[ i*incy ]*ax;
+            }
+        }
+        #else
+        blasf77_zsyr2( lapack_uplo_const( uplo ), &n,
+                       &alpha, dx, &incx, dy, &incy, dA, &ldda );
+        #endif
+    });
+}
+
+
+/***************************************************************************//**
+    Perform triangular matrix-vector product, \f$ x = A x \f$.
+    @ingroup magma_trmv
+*******************************************************************************/
+extern "C" void
+magma_ztrmv(
+    magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_ztrmv( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                       lapack_diag_const( diag ), &n, dA, &ldda, dx, &incx );
+    });
+}
+
+
+/***************************************************************************//**
+    Solve triangular matrix-vector system (one right-hand side), \f$ A x = b \f$.
+    @ingroup magma_trsv
+*******************************************************************************/
+extern "C" void
+magma_ztrsv(
+    magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t n,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dx, magma_int_t incx,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_ztrsv( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                       lapack_diag_const( diag ), &n, dA, &ldda, dx, &incx );
+    });
+}
+
+
+// =============================================================================
+// Level 3 BLAS
+
+/***************************************************************************//**
+    Perform matrix-matrix product, \f$ C = \alpha op(A) op(B) + \beta C \f$.
+    @ingroup magma_gemm
+*******************************************************************************/
+extern "C" void
+magma_zgemm(
+    magma_trans_t transA, magma_trans_t transB,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zgemm( lapack_trans_const( transA ), lapack_trans_const( transB ),
+                       &m, &n, &k,
+                       &alpha, dA, &ldda, dB, &lddb,
+                       &beta,  dC, &lddc );
+    });
+}
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Perform Hermitian matrix-matrix product.
+    @ingroup magma_hemm
+*******************************************************************************/
+extern "C" void
+magma_zhemm(
+    magma_side_t side, magma_uplo_t uplo,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zhemm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                       &m, &n,
+                       &alpha, dA, &ldda, dB, &lddb,
+                       &beta,  dC, &lddc );
+    });
+}
+#endif // COMPLEX
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Perform Hermitian rank-k update, \f$ C = \alpha A A^H + \beta C \f$.
+    @ingroup magma_herk
+*******************************************************************************/
+extern "C" void
+magma_zherk(
+    magma_uplo_t uplo, magma_trans_t trans,
+    magma_int_t n, magma_int_t k,
+    double alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    double beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zherk( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                       &n, &k,
+                       &alpha, dA, &ldda,
+                       &beta,  dC, &lddc );
+    });
+}
+#endif // COMPLEX
+
+
+#ifdef COMPLEX
+/***************************************************************************//**
+    Perform Hermitian rank-2k update,
+    \f$ C = \alpha A B^H + conj(\alpha) B A^H + \beta C \f$.
+    @ingroup magma_her2k
+*******************************************************************************/
+extern "C" void
+magma_zher2k(
+    magma_uplo_t uplo, magma_trans_t trans,
+    magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    double beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zher2k( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                        &n, &k,
+                        &alpha, dA, &ldda, dB, &lddb,
+                        &beta,  dC, &lddc );
+    });
+}
+#endif // COMPLEX
+
+
+/***************************************************************************//**
+    Perform symmetric matrix-matrix product.
+    @ingroup magma_symm
+*******************************************************************************/
+extern "C" void
+magma_zsymm(
+    magma_side_t side, magma_uplo_t uplo,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zsymm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                       &m, &n,
+                       &alpha, dA, &ldda, dB, &lddb,
+                       &beta,  dC, &lddc );
+    });
+}
+
+
+/***************************************************************************//**
+    Perform symmetric rank-k update, \f$ C = \alpha A A^T + \beta C \f$.
+    @ingroup magma_syrk
+*******************************************************************************/
+extern "C" void
+magma_zsyrk(
+    magma_uplo_t uplo, magma_trans_t trans,
+    magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zsyrk( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                       &n, &k,
+                       &alpha, dA, &ldda,
+                       &beta,  dC, &lddc );
+    });
+}
+
+
+/***************************************************************************//**
+    Perform symmetric rank-2k update, \f$ C = \alpha A B^T + \alpha B A^T + \beta C \f$.
+    @ingroup magma_syr2k
+*******************************************************************************/
+extern "C" void
+magma_zsyr2k(
+    magma_uplo_t uplo, magma_trans_t trans,
+    magma_int_t n, magma_int_t k,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dB, magma_int_t lddb,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr       dC, magma_int_t lddc,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_zsyr2k( lapack_uplo_const( uplo ), lapack_trans_const( trans ),
+                        &n, &k,
+                        &alpha, dA, &ldda, dB, &lddb,
+                        &beta,  dC, &lddc );
+    });
+}
+
+
+/***************************************************************************//**
+    Perform triangular matrix-matrix product, \f$ B = \alpha op(A) B \f$.
+    @ingroup magma_trmm
+*******************************************************************************/
+extern "C" void
+magma_ztrmm(
+    magma_side_t side, magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dB, magma_int_t lddb,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_ztrmm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                       lapack_trans_const( trans ), lapack_diag_const( diag ),
+                       &m, &n,
+                       &alpha, dA, &ldda, dB, &lddb );
+    });
+}
+
+
+/***************************************************************************//**
+    Solve triangular matrix-matrix system (multiple right-hand sides),
+    \f$ op(A) X = \alpha B \f$.
+    @ingroup magma_trsm
+*******************************************************************************/
+extern "C" void
+magma_ztrsm(
+    magma_side_t side, magma_uplo_t uplo, magma_trans_t trans, magma_diag_t diag,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dB, magma_int_t lddb,
+    magma_queue_t queue )
+{
+    magma_host_enqueue( queue, [=] {
+        blasf77_ztrsm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                       lapack_trans_const( trans ), lapack_diag_const( diag ),
+                       &m, &n,
+                       &alpha, dA, &ldda, dB, &lddb );
+    });
+}
+
+#endif // HAVE_HOST
@@ -0,0 +1,367 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include "host_queue.h"
+#include "error.h"
+#include "magma_metrics.h"
+
+#ifdef HAVE_HOST
+
+// Generic, type-independent routines to copy data between the host and
+// host-emulated devices. Device memory is host memory, so all copies are
+// memcpy, run on the queue's worker thread in order with its other operations.
+// Arguments are as in interface_cuda/copy_v2.cpp.
+
+// -----------------------------------------------------------------------------
+// Copies n elements of x, with stride incx, to y, with stride incy.
+static void
+copy_vector(
+    magma_int_t n, magma_int_t elemSize,
+    void const* x_src, magma_int_t incx,
+    void*       y_dst, magma_int_t incy )
+{
+    const char* x = (const char*) x_src;
+    char*       y = (char*)       y_dst;
+    if ( incx == 1 && incy == 1 ) {
+        memcpy( y, x, size_t(n)*elemSize );
+    }
+    else {
+        for( magma_int_t i = 0; i < n; ++i ) {
+            memcpy( y + size_t(i)*incy*elemSize,
+                    x + size_t(i)*incx*elemSize, elemSize );
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// Copies m-by-n matrix A, with leading dimension lda, to B, with ldb.
+static void
+copy_matrix(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    void const* A_src, magma_int_t lda,
+    void*       B_dst, magma_int_t ldb )
+{
+    const char* A = (const char*) A_src;
+    char*       B = (char*)       B_dst;
+    if ( m <= 0 || n <= 0 ) {
+        return;
+    }
+    if ( lda == m && ldb == m ) {
+        memcpy( B, A, size_t(m)*n*elemSize );
+    }
+    else {
+        for( magma_int_t j = 0; j < n; ++j ) {
+            memcpy( B + size_t(j)*ldb*elemSize,
+                    A + size_t(j)*lda*elemSize, size_t(m)*elemSize );
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// for backwards compatability, async versions accept NULL queue to mean
+// NULL stream, which here runs synchronously.
+static void
+check_queue( magma_queue_t queue, const char* func )
+{
+    if ( queue == NULL ) {
+        fprintf( stderr, "Warning: %s got NULL queue\n", func );
+    }
+}
+
+
+/***************************************************************************//**
+    @fn magma_setvector( n, elemSize, hx_src, incx, dy_dst, incy, queue )
+
+    Copy vector hx_src on CPU host to dy_dst on the device.
+    This version synchronizes the queue after the transfer.
+
+    @ingroup magma_setvector
+*******************************************************************************/
+extern "C" void
+magma_setvector_internal(
+    magma_int_t n, magma_int_t elemSize,
+    void const* hx_src, magma_int_t incx,
+    magma_ptr   dy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsHostToDevice, uint64_t(n)*elemSize );
+    assert( queue != NULL );
+    magma_host_enqueue_sync( queue, [=] {
+        copy_vector( n, elemSize, hx_src, incx, dy_dst, incy );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_setvector_async( n, elemSize, hx_src, incx, dy_dst, incy, queue )
+
+    Copy vector hx_src on CPU host to dy_dst on the device.
+    This version is asynchronous: it returns before the transfer finishes.
+
+    @ingroup magma_setvector
+*******************************************************************************/
+extern "C" void
+magma_setvector_async_internal(
+    magma_int_t n, magma_int_t elemSize,
+    void const* hx_src, magma_int_t incx,
+    magma_ptr   dy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsHostToDevice, uint64_t(n)*elemSize );
+    check_queue( queue, __func__ );
+    magma_host_enqueue( queue, [=] {
+        copy_vector( n, elemSize, hx_src, incx, dy_dst, incy );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_getvector( n, elemSize, dx_src, incx, hy_dst, incy, queue )
+
+    Copy vector dx_src on the device to hy_dst on CPU host.
+    This version synchronizes the queue after the transfer.
+
+    @ingroup magma_getvector
+*******************************************************************************/
+extern "C" void
+magma_getvector_internal(
+    magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dx_src, magma_int_t incx,
+    void*           hy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsDeviceToHost, uint64_t(n)*elemSize );
+    assert( queue != NULL );
+    magma_host_enqueue_sync( queue, [=] {
+        copy_vector( n, elemSize, dx_src, incx, hy_dst, incy );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_getvector_async( n, elemSize, dx_src, incx, hy_dst, incy, queue )
+
+    Copy vector dx_src on the device to hy_dst on CPU host.
+    This version is asynchronous: it returns before the transfer finishes.
+
+    @ingroup magma_getvector
+*******************************************************************************/
+extern "C" void
+magma_getvector_async_internal(
+    magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dx_src, magma_int_t incx,
+    void*           hy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsDeviceToHost, uint64_t(n)*elemSize );
+    check_queue( queue, __func__ );
+    magma_host_enqueue( queue, [=] {
+        copy_vector( n, elemSize, dx_src, incx, hy_dst, incy );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_copyvector( n, elemSize, dx_src, incx, dy_dst, incy, queue )
+
+    Copy vector dx_src on the device to dy_dst on the device.
+    This version synchronizes the queue after the transfer.
+
+    @ingroup magma_copyvector
+*******************************************************************************/
+extern "C" void
+magma_copyvector_internal(
+    magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dx_src, magma_int_t incx,
+    magma_ptr       dy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsDeviceToDevice, uint64_t(n)*elemSize );
+    assert( queue != NULL );
+    magma_host_enqueue_sync( queue, [=] {
+        copy_vector( n, elemSize, dx_src, incx, dy_dst, incy );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_copyvector_async( n, elemSize, dx_src, incx, dy_dst, incy, queue )
+
+    Copy vector dx_src on the device to dy_dst on the device.
+    This version is asynchronous: it returns before the transfer finishes.
+
+    @ingroup magma_copyvector
+*******************************************************************************/
+extern "C" void
+magma_copyvector_async_internal(
+    magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dx_src, magma_int_t incx,
+    magma_ptr       dy_dst, magma_int_t incy,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsDeviceToDevice, uint64_t(n)*elemSize );
+    check_queue( queue, __func__ );
+    magma_host_enqueue( queue, [=] {
+        copy_vector( n, elemSize, dx_src, incx, dy_dst, incy );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_setmatrix( m, n, elemSize, hA_src, lda, dB_dst, lddb, queue )
+
+    Copy all or part of matrix hA_src on CPU host to dB_dst on the device.
+    This version synchronizes the queue after the transfer.
+
+    @ingroup magma_setmatrix
+*******************************************************************************/
+extern "C" void
+magma_setmatrix_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    void const* hA_src, magma_int_t lda,
+    magma_ptr   dB_dst, magma_int_t lddb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsHostToDevice, uint64_t(m)*n*elemSize );
+    assert( queue != NULL );
+    magma_host_enqueue_sync( queue, [=] {
+        copy_matrix( m, n, elemSize, hA_src, lda, dB_dst, lddb );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_setmatrix_async( m, n, elemSize, hA_src, lda, dB_dst, lddb, queue )
+
+    Copy all or part of matrix hA_src on CPU host to dB_dst on the device.
+    This version is asynchronous: it returns before the transfer finishes.
+
+    @ingroup magma_setmatrix
+*******************************************************************************/
+extern "C" void
+magma_setmatrix_async_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    void const* hA_src, magma_int_t lda,
+    magma_ptr   dB_dst, magma_int_t lddb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsHostToDevice, uint64_t(m)*n*elemSize );
+    check_queue( queue, __func__ );
+    magma_host_enqueue( queue, [=] {
+        copy_matrix( m, n, elemSize, hA_src, lda, dB_dst, lddb );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_getmatrix( m, n, elemSize, dA_src, ldda, hB_dst, ldb, queue )
+
+    Copy all or part of matrix dA_src on the device to hB_dst on CPU host.
+    This version synchronizes the queue after the transfer.
+
+    @ingroup magma_getmatrix
+*******************************************************************************/
+extern "C" void
+magma_getmatrix_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dA_src, magma_int_t ldda,
+    void*           hB_dst, magma_int_t ldb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsDeviceToHost, uint64_t(m)*n*elemSize );
+    assert( queue != NULL );
+    magma_host_enqueue_sync( queue, [=] {
+        copy_matrix( m, n, elemSize, dA_src, ldda, hB_dst, ldb );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_getmatrix_async( m, n, elemSize, dA_src, ldda, hB_dst, ldb, queue )
+
+    Copy all or part of matrix dA_src on the device to hB_dst on CPU host.
+    This version is asynchronous: it returns before the transfer finishes.
+
+    @ingroup magma_getmatrix
+*******************************************************************************/
+extern "C" void
+magma_getmatrix_async_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dA_src, magma_int_t ldda,
+    void*           hB_dst, magma_int_t ldb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsDeviceToHost, uint64_t(m)*n*elemSize );
+    check_queue( queue, __func__ );
+    magma_host_enqueue( queue, [=] {
+        copy_matrix( m, n, elemSize, dA_src, ldda, hB_dst, ldb );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_copymatrix( m, n, elemSize, dA_src, ldda, dB_dst, lddb, queue )
+
+    Copy all or part of matrix dA_src on the device to dB_dst on the device.
+    dA and dB may be on different devices.
+    This version synchronizes the queue after the transfer.
+
+    @ingroup magma_copymatrix
+*******************************************************************************/
+extern "C" void
+magma_copymatrix_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dA_src, magma_int_t ldda,
+    magma_ptr       dB_dst, magma_int_t lddb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsDeviceToDevice, uint64_t(m)*n*elemSize );
+    assert( queue != NULL );
+    magma_host_enqueue_sync( queue, [=] {
+        copy_matrix( m, n, elemSize, dA_src, ldda, dB_dst, lddb );
+    });
+}
+
+
+/***************************************************************************//**
+    @fn magma_copymatrix_async( m, n, elemSize, dA_src, ldda, dB_dst, lddb, queue )
+
+    Copy all or part of matrix dA_src on the device to dB_dst on the device.
+    dA and dB may be on different devices.
+    This version is asynchronous: it returns before the transfer finishes.
+
+    @ingroup magma_copymatrix
+*******************************************************************************/
+extern "C" void
+magma_copymatrix_async_internal(
+    magma_int_t m, magma_int_t n, magma_int_t elemSize,
+    magma_const_ptr dA_src, magma_int_t ldda,
+    magma_ptr       dB_dst, magma_int_t lddb,
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    magma_metrics_transfer( MagmaMetricsDeviceToDevice, uint64_t(m)*n*elemSize );
+    check_queue( queue, __func__ );
+    magma_host_enqueue( queue, [=] {
+        copy_matrix( m, n, elemSize, dA_src, ldda, dB_dst, lddb );
+    });
+}
+
+#endif // HAVE_HOST
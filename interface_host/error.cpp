@@ -0,0 +1,14 @@
+#include "magma_internal.h"
+#include "error.h"
+
+
+/******************************************************************************/
+/// @see magma_xerror
+/// @ingroup magma_error_internal
+void magma_xerror( magma_int_t err, const char* func, const char* file, int line )
+{
+    if ( err != MAGMA_SUCCESS ) {
+        fprintf( stderr, "MAGMA error: %s (%lld) in %s at %s:%d\n",
+                 magma_strerror( err ), (long long) err, func, file, line );
+    }
+}
@@ -0,0 +1,59 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#ifndef MAGMA_HOST_QUEUE_H
+#define MAGMA_HOST_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "magma_internal.h"
+
+// =============================================================================
+// Internal interface of the host-emulated devices.
+// Each queue owns a worker thread that runs its operations, in order,
+// asynchronously from the thread that submitted them, as a CUDA stream does.
+
+/******************************************************************************/
+struct magma_host_worker
+{
+    std::thread                          thread;
+    std::mutex                           mutex;
+    std::condition_variable              cv_task;  // signaled when a task is queued
+    std::condition_variable              cv_done;  // signaled when a task finishes
+    std::deque< std::function<void()> >  tasks;
+    long long                            submitted;
+    long long                            completed;
+    bool                                 quit;
+};
+
+
+/******************************************************************************/
+// Tasks recorded on an event are numbered; the event triggers when the task
+// numbered "recorded" completes. A never-recorded event is triggered.
+struct magma_event
+{
+    std::mutex                           mutex;
+    std::condition_variable              cv;
+    long long                            recorded;
+    long long                            completed;
+};
+
+
+/******************************************************************************/
+// Queues task to run on queue's worker thread. With a NULL queue, runs task
+// immediately in the calling thread, like CUDA's synchronous default stream.
+void magma_host_enqueue( magma_queue_t queue, std::function<void()> task );
+
+// Queues task and waits for it, and everything queued before it, to finish.
+void magma_host_enqueue_sync( magma_queue_t queue, std::function<void()> task );
+
+#endif        //  #ifndef MAGMA_HOST_QUEUE_H
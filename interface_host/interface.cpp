@@ -0,0 +1,897 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+#include <mkl_service.h>
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+// defining MAGMA_LAPACK_H is a hack to NOT include magma_lapack.h
+// via magma_internal.h here; see interface_cuda/interface.cpp
+#define MAGMA_LAPACK_H
+
+#include "host_queue.h"
+#include "error.h"
+#include "magma_host_pool.h"
+
+#ifdef HAVE_HOST
+
+#ifdef DEBUG_MEMORY
+// defined in alloc.cpp
+extern std::map< void*, size_t > g_pointers_dev;
+extern std::map< void*, size_t > g_pointers_cpu;
+extern std::map< void*, size_t > g_pointers_pin;
+#endif
+
+// -----------------------------------------------------------------------------
+// prototypes
+extern "C" void
+magma_warn_leaks( const std::map< void*, size_t >& pointers, const char* type );
+
+
+// -----------------------------------------------------------------------------
+// constants
+
+#define MAX_BATCHCOUNT    (65534)
+
+// nominal shared memory sizes, for code that sizes its blocking by them
+#define HOST_SHMEM_BLOCK     (48*1024)
+#define HOST_SHMEM_MULTIPROC (64*1024)
+
+
+// -----------------------------------------------------------------------------
+// globals
+static std::mutex g_mutex;
+
+// count of (init - finalize) calls
+static int g_init = 0;
+
+// current device of each thread
+static thread_local magma_device_t g_device = 0;
+
+
+// -----------------------------------------------------------------------------
+// emulated device properties, set by magma_init()
+struct magma_device_info
+{
+    size_t memory;
+    magma_int_t multiproc_count;    // number of CPUs in the device
+    int threads;                    // BLAS threads of each queue; 0 is default
+    #if defined(__linux__)
+    cpu_set_t cpus;                 // CPUs the queues run on; empty is any
+    #endif
+};
+
+int g_magma_devices_cnt = 0;
+struct magma_device_info* g_magma_devices = NULL;
+
+
+// -----------------------------------------------------------------------------
+// Parses a CPU list such as "0-7,16-23" into cpus.
+// @return true on success.
+#if defined(__linux__)
+static bool
+parse_cpus( const char* str, cpu_set_t* cpus )
+{
+    CPU_ZERO( cpus );
+    while ( *str != '\0' ) {
+        char* end;
+        long first = strtol( str, &end, 10 );
+        long last  = first;
+        if ( end == str || first < 0 ) {
+            return false;
+        }
+        if ( *end == '-' ) {
+            str = end + 1;
+            last = strtol( str, &end, 10 );
+            if ( end == str || last < first ) {
+                return false;
+            }
+        }
+        for( long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu ) {
+            CPU_SET( cpu, cpus );
+        }
+        str = end;
+        if ( *str == ',' ) {
+            ++str;
+        }
+        else if ( *str != '\0' ) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+
+// =============================================================================
+// initialization
+
+/***************************************************************************//**
+    Initializes the MAGMA library.
+    Sets up the host-emulated devices:
+    $MAGMA_HOST_DEVICES sets the number of devices (default 1);
+    $MAGMA_HOST_DEVICE_CPUS sets, for each device, the CPUs its queues run on,
+    as colon-separated CPU lists, e.g., "0-15:16-31" for one device per socket;
+    $MAGMA_HOST_DEVICE_THREADS sets the BLAS threads of each queue.
+
+    Every magma_init call must be paired with a magma_finalize call.
+    Only one thread needs to call magma_init and magma_finalize,
+    but every thread may call it. If n threads call magma_init,
+    the n-th call to magma_finalize will release resources.
+
+    @retval MAGMA_SUCCESS
+    @retval MAGMA_ERR_ILLEGAL_VALUE
+    @retval MAGMA_ERR_HOST_ALLOC
+
+    @see magma_finalize
+
+    @ingroup magma_init
+*******************************************************************************/
+extern "C" magma_int_t
+magma_init()
+{
+    magma_int_t info = 0;
+
+    g_mutex.lock();
+    {
+        if ( g_init == 0 ) {
+            // before any magma_malloc_cpu
+            magma_host_pool_init();
+
+            const char* cpus_env    = getenv( "MAGMA_HOST_DEVICE_CPUS" );
+            const char* devices_env = getenv( "MAGMA_HOST_DEVICES" );
+            const char* threads_env = getenv( "MAGMA_HOST_DEVICE_THREADS" );
+            size_t size;
+            long pages, page_size, ncpus;
+            int threads;
+
+            // number of devices: as given, else one per CPU list, else 1
+            g_magma_devices_cnt = 1;
+            if ( devices_env != NULL ) {
+                g_magma_devices_cnt = atoi( devices_env );
+            }
+            else if ( cpus_env != NULL ) {
+                for( const char* s = cpus_env; *s != '\0'; ++s ) {
+                    g_magma_devices_cnt += (*s == ':');
+                }
+            }
+            if ( g_magma_devices_cnt < 1 ) {
+                fprintf( stderr, "Error in %s: invalid $MAGMA_HOST_DEVICES\n", __func__ );
+                g_magma_devices_cnt = 0;
+                info = MAGMA_ERR_ILLEGAL_VALUE;
+                goto cleanup;
+            }
+
+            // allocate list of devices
+            size = g_magma_devices_cnt * sizeof(struct magma_device_info);
+            magma_malloc_cpu( (void**) &g_magma_devices, size );
+            if ( g_magma_devices == NULL ) {
+                info = MAGMA_ERR_HOST_ALLOC;
+                goto cleanup;
+            }
+            memset( g_magma_devices, 0, size );
+
+            // devices share the host memory and CPUs
+            pages     = sysconf( _SC_PHYS_PAGES );
+            page_size = sysconf( _SC_PAGESIZE );
+            ncpus     = sysconf( _SC_NPROCESSORS_ONLN );
+            threads   = (threads_env != NULL ? atoi( threads_env ) : 0);
+            for( int dev=0; dev < g_magma_devices_cnt; ++dev ) {
+                g_magma_devices[dev].memory  = size_t(pages) * page_size / g_magma_devices_cnt;
+                g_magma_devices[dev].threads = max( 0, threads );
+                g_magma_devices[dev].multiproc_count = max( 1L, ncpus / g_magma_devices_cnt );
+            }
+
+            #if defined(__linux__)
+            // device dev gets the dev-th CPU list, wrapping around
+            if ( cpus_env != NULL ) {
+                std::vector< std::string > lists;
+                std::string str( cpus_env );
+                size_t begin = 0, end;
+                do {
+                    end = str.find( ':', begin );
+                    lists.push_back( str.substr( begin, end - begin ));
+                    begin = end + 1;
+                } while ( end != std::string::npos );
+
+                for( int dev=0; dev < g_magma_devices_cnt; ++dev ) {
+                    cpu_set_t* cpus = &g_magma_devices[dev].cpus;
+                    if ( ! parse_cpus( lists[ dev % lists.size() ].c_str(), cpus )) {
+                        fprintf( stderr, "Error in %s: invalid $MAGMA_HOST_DEVICE_CPUS\n", __func__ );
+                        info = MAGMA_ERR_ILLEGAL_VALUE;
+                        goto cleanup;
+                    }
+                    g_magma_devices[dev].multiproc_count = max( 1, CPU_COUNT( cpus ));
+                }
+            }
+            #endif
+        }
+cleanup:
+        g_init += 1;  // increment (init - finalize) count
+    }
+    g_mutex.unlock();
+
+    return info;
+}
+
+
+/***************************************************************************//**
+    Frees information used by the MAGMA library.
+    @see magma_init
+
+    @ingroup magma_init
+*******************************************************************************/
+extern "C" magma_int_t
+magma_finalize()
+{
+    magma_int_t info = 0;
+
+    g_mutex.lock();
+    {
+        if ( g_init <= 0 ) {
+            info = MAGMA_ERR_NOT_INITIALIZED;
+        }
+        else {
+            g_init -= 1;  // decrement (init - finalize) count
+            if ( g_init == 0 ) {
+                info = 0;
+
+                if ( g_magma_devices != NULL ) {
+                    magma_free_cpu( g_magma_devices );
+                    g_magma_devices = NULL;
+                }
+
+                magma_host_pool_finalize();
+
+                #ifdef DEBUG_MEMORY
+                magma_warn_leaks( g_pointers_dev, "device" );
+                magma_warn_leaks( g_pointers_cpu, "CPU" );
+                magma_warn_leaks( g_pointers_pin, "CPU pinned" );
+                #endif
+            }
+        }
+    }
+    g_mutex.unlock();
+
+    return info;
+}
+
+
+// =============================================================================
+// testing and debugging support
+
+#ifdef DEBUG_MEMORY
+/***************************************************************************//**
+    If DEBUG_MEMORY is defined at compile time, prints warnings when
+    magma_finalize() is called for any device, CPU, or CPU pinned
+    allocations that were not freed.
+
+    @param[in]
+    pointers    Hash table mapping allocated pointers to size.
+
+    @param[in]
+    type        String describing type of pointers (device, CPU, etc.)
+
+    @ingroup magma_testing
+*******************************************************************************/
+extern "C" void
+magma_warn_leaks( const std::map< void*, size_t >& pointers, const char* type )
+{
+    if ( pointers.size() > 0 ) {
+        fprintf( stderr, "Warning: MAGMA detected memory leak of %llu %s pointers:\n",
+                 (long long unsigned) pointers.size(), type );
+        std::map< void*, size_t >::const_iterator iter;
+        for( iter = pointers.begin(); iter != pointers.end(); ++iter ) {
+            fprintf( stderr, "    pointer %p, size %lu\n", iter->first, iter->second );
+        }
+    }
+}
+#endif
+
+
+/***************************************************************************//**
+    Print MAGMA version, LAPACK/BLAS library version,
+    host-emulated devices, number of threads, date, etc.
+    Used in testing.
+    @ingroup magma_testing
+*******************************************************************************/
+extern "C" void
+magma_print_environment()
+{
+    magma_int_t major, minor, micro;
+    magma_version( &major, &minor, &micro );
+
+    printf( "%% MAGMA %lld.%lld.%lld %s %lld-bit magma_int_t, %lld-bit pointer.\n",
+            (long long) major, (long long) minor, (long long) micro,
+            MAGMA_VERSION_STAGE,
+            (long long) (8*sizeof(magma_int_t)),
+            (long long) (8*sizeof(void*)) );
+
+    printf( "%% Host-emulated devices. " );
+
+#if defined(_OPENMP)
+    int omp_threads = 0;
+    #pragma omp parallel
+    {
+        omp_threads = omp_get_num_threads();
+    }
+    printf( "OpenMP threads %d. ", omp_threads );
+#else
+    printf( "MAGMA not compiled with OpenMP. " );
+#endif
+
+#if defined(MAGMA_WITH_MKL)
+    MKLVersion mkl_version;
+    mkl_get_version( &mkl_version );
+    printf( "MKL %d.%d.%d, MKL threads %d. ",
+            mkl_version.MajorVersion,
+            mkl_version.MinorVersion,
+            mkl_version.UpdateVersion,
+            mkl_get_max_threads() );
+#endif
+
+    printf( "\n" );
+
+    // print devices
+    for( int dev = 0; dev < g_magma_devices_cnt && g_magma_devices != NULL; ++dev ) {
+        printf( "%% device %d: host, %lld CPUs, %.1f MiB memory",
+                dev,
+                (long long) g_magma_devices[dev].multiproc_count,
+                g_magma_devices[dev].memory / (1024.*1024.) );
+        if ( g_magma_devices[dev].threads > 0 ) {
+            printf( ", %d BLAS threads per queue", g_magma_devices[dev].threads );
+        }
+        printf( "\n" );
+    }
+
+    time_t t = time( NULL );
+    printf( "%% %s", ctime( &t ));
+}
+
+
+/***************************************************************************//**
+    For debugging purposes, determines whether a pointer points to CPU or GPU memory.
+
+    With host-emulated devices, device memory is host memory,
+    so this cannot tell them apart.
+
+    @param[in] A    pointer to test
+
+    @return -1:  unknown.
+
+    @ingroup magma_util
+*******************************************************************************/
+extern "C" magma_int_t
+magma_is_devptr( const void* A )
+{
+    MAGMA_UNUSED( A );
+    return -1;
+}
+
+
+// =============================================================================
+// device support
+
+/***************************************************************************//**
+    Returns CUDA architecture capability for the current device.
+    Host-emulated devices have no CUDA architecture, so this returns 0,
+    which selects the generic tuning parameters.
+
+    @return 0.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" magma_int_t
+magma_getdevice_arch()
+{
+    return 0;
+}
+
+
+/***************************************************************************//**
+    Fills in devices array with the available devices.
+
+    @param[out]
+    devices     Array of dimension (size).
+                On output, devices[0, ..., num_dev-1] contain device IDs.
+                Entries >= num_dev are not touched.
+
+    @param[in]
+    size        Dimension of the array devices.
+
+    @param[out]
+    num_dev     Number of devices, limited to size.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" void
+magma_getdevices(
+    magma_device_t* devices,
+    magma_int_t  size,
+    magma_int_t* num_dev )
+{
+    int cnt = min( g_magma_devices_cnt, int(size) );
+    for( int i = 0; i < cnt; ++i ) {
+        devices[i] = i;
+    }
+    *num_dev = cnt;
+}
+
+
+/***************************************************************************//**
+    Get the current device.
+
+    @param[out]
+    device      On output, device ID of the current device.
+                Each thread has its own current device.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" void
+magma_getdevice( magma_device_t* device )
+{
+    *device = g_device;
+}
+
+
+/***************************************************************************//**
+    Set the current device.
+
+    @param[in]
+    device      Device ID to set as the current device.
+                Each thread has its own current device.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" void
+magma_setdevice( magma_device_t device )
+{
+    if ( device < 0 || device >= g_magma_devices_cnt ) {
+        check_error( MAGMA_ERR_ILLEGAL_VALUE );
+        return;
+    }
+    g_device = device;
+}
+
+
+/***************************************************************************//**
+    Returns the number of CPUs of the current device.
+    This requires magma_init() to be called first to cache the information.
+
+    @return the multiprocessor count for the current device.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" magma_int_t
+magma_getdevice_multiprocessor_count()
+{
+    int dev = g_device;
+    if ( g_magma_devices == NULL || dev < 0 || dev >= g_magma_devices_cnt ) {
+        fprintf( stderr, "Error in %s: MAGMA not initialized (call magma_init() first) or bad device\n", __func__ );
+        return 0;
+    }
+    return g_magma_devices[dev].multiproc_count;
+}
+
+
+/***************************************************************************//**
+    Returns the nominal shared memory per block (in bytes) of a device.
+
+    @return the shared memory per block (in bytes) for the current device.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" size_t
+magma_getdevice_shmem_block()
+{
+    return HOST_SHMEM_BLOCK;
+}
+
+
+/***************************************************************************//**
+    Returns the nominal shared memory per multiprocessor (in bytes) of a device.
+
+    @return the shared memory per multiprocessor (in bytes) for the current device.
+
+    @ingroup magma_device
+*******************************************************************************/
+extern "C" size_t
+magma_getdevice_shmem_multiprocessor()
+{
+    return HOST_SHMEM_MULTIPROC;
+}
+
+
+/***************************************************************************//**
+    @param[in]
+    queue           Queue to query.
+
+    @return         Amount of free memory in bytes available on the device
+                    associated with the queue: its share of the
+                    available host memory.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" size_t
+magma_mem_size( magma_queue_t queue )
+{
+    MAGMA_UNUSED( queue );
+    long pages     = sysconf( _SC_AVPHYS_PAGES );
+    long page_size = sysconf( _SC_PAGESIZE );
+    return size_t(pages) * page_size / max( 1, g_magma_devices_cnt );
+}
+
+
+// =============================================================================
+// queue support
+
+/***************************************************************************//**
+    Runs the tasks of a queue, in order, until the queue is destroyed.
+    Binds the thread to the device's CPUs and sets its BLAS threads.
+*******************************************************************************/
+static void
+magma_host_worker_main( magma_host_worker* worker, magma_device_t device )
+{
+    g_device = device;
+    if ( g_magma_devices != NULL && device < g_magma_devices_cnt ) {
+        #if defined(__linux__)
+        cpu_set_t* cpus = &g_magma_devices[device].cpus;
+        if ( CPU_COUNT( cpus ) > 0 ) {
+            pthread_setaffinity_np( pthread_self(), sizeof(cpu_set_t), cpus );
+        }
+        #endif
+
+        // the OpenMP ICV and MKL's local setting are per thread
+        int threads = g_magma_devices[device].threads;
+        if ( threads > 0 ) {
+            #if defined(MAGMA_WITH_MKL)
+            mkl_set_num_threads_local( threads );
+            #endif
+            #if defined(_OPENMP)
+            omp_set_num_threads( threads );
+            #endif
+        }
+    }
+
+    std::unique_lock< std::mutex > lock( worker->mutex );
+    while (true) {
+        worker->cv_task.wait( lock, [worker] {
+            return worker->quit || ! worker->tasks.empty();
+        });
+        // finish queued tasks before quitting
+        if ( worker->tasks.empty() ) {
+            break;
+        }
+        std::function<void()> task = std::move( worker->tasks.front() );
+        worker->tasks.pop_front();
+        lock.unlock();
+
+        task();
+
+        lock.lock();
+        worker->completed += 1;
+        worker->cv_done.notify_all();
+    }
+}
+
+
+/******************************************************************************/
+void
+magma_host_enqueue( magma_queue_t queue, std::function<void()> task )
+{
+    if ( queue == NULL ) {
+        task();
+        return;
+    }
+    magma_host_worker* worker = queue->host_worker();
+    {
+        std::lock_guard< std::mutex > guard( worker->mutex );
+        worker->tasks.push_back( std::move( task ));
+        worker->submitted += 1;
+    }
+    worker->cv_task.notify_one();
+}
+
+
+/******************************************************************************/
+void
+magma_host_enqueue_sync( magma_queue_t queue, std::function<void()> task )
+{
+    magma_host_enqueue( queue, std::move( task ));
+    magma_queue_sync( queue );
+}
+
+
+/******************************************************************************/
+/// @return Device ID associated with the MAGMA queue.
+/// @ingroup magma_queue
+extern "C"
+magma_int_t
+magma_queue_get_device( magma_queue_t queue )
+{
+    return queue->device();
+}
+
+
+/***************************************************************************//**
+    @fn magma_queue_create( device, queue_ptr )
+
+    magma_queue_create( device, queue_ptr ) is the preferred alias to this
+    function.
+
+    Creates a new MAGMA queue, with a worker thread that runs its operations,
+    in order, on the host-emulated device.
+
+    @param[in]
+    device          Device to create queue on.
+
+    @param[out]
+    queue_ptr       On output, the newly created queue.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_queue_create_internal(
+    magma_device_t device, magma_queue_t* queue_ptr,
+    const char* func, const char* file, int line )
+{
+    magma_queue_t queue;
+    magma_malloc_cpu( (void**)&queue, sizeof(*queue) );
+    assert( queue != NULL );
+    *queue_ptr = queue;
+
+    queue->own__      = 0;
+    queue->device__   = device;
+
+    queue->ptrArray__ = NULL;
+    queue->dAarray__  = NULL;
+    queue->dBarray__  = NULL;
+    queue->dCarray__  = NULL;
+    queue->maxbatch__ = MAX_BATCHCOUNT;
+
+    if ( device < 0 || device >= g_magma_devices_cnt ) {
+        check_xerror( MAGMA_ERR_ILLEGAL_VALUE, func, file, line );
+    }
+    magma_setdevice( device );
+
+    magma_host_worker* worker = new magma_host_worker;
+    worker->submitted = 0;
+    worker->completed = 0;
+    worker->quit      = false;
+    worker->thread    = std::thread( magma_host_worker_main, worker, device );
+    queue->worker__   = worker;
+}
+
+
+/***************************************************************************//**
+    @fn magma_queue_destroy( queue )
+
+    Destroys a queue, freeing its resources.
+    Operations already queued finish first.
+
+    @param[in]
+    queue           Queue to destroy.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_queue_destroy_internal(
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    if ( queue != NULL ) {
+        magma_host_worker* worker = queue->worker__;
+        if ( worker != NULL ) {
+            {
+                std::lock_guard< std::mutex > guard( worker->mutex );
+                worker->quit = true;
+            }
+            worker->cv_task.notify_one();
+            worker->thread.join();
+            delete worker;
+        }
+
+        if( queue->ptrArray__ != NULL ) magma_free( queue->ptrArray__ );
+
+        queue->own__      = 0;
+        queue->device__   = -1;
+        queue->worker__   = NULL;
+
+        queue->ptrArray__ = NULL;
+        queue->dAarray__  = NULL;
+        queue->dBarray__  = NULL;
+        queue->dCarray__  = NULL;
+
+        magma_free_cpu( queue );
+    }
+    MAGMA_UNUSED( func );
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+}
+
+
+/***************************************************************************//**
+    @fn magma_queue_sync( queue )
+
+    Synchronizes with a queue. The CPU blocks until all operations on the queue
+    are finished.
+
+    @param[in]
+    queue           Queue to synchronize.
+
+    @ingroup magma_queue
+*******************************************************************************/
+extern "C" void
+magma_queue_sync_internal(
+    magma_queue_t queue,
+    const char* func, const char* file, int line )
+{
+    // operations on the NULL queue run synchronously
+    if ( queue != NULL ) {
+        magma_host_worker* worker = queue->host_worker();
+        std::unique_lock< std::mutex > lock( worker->mutex );
+        long long submitted = worker->submitted;
+        worker->cv_done.wait( lock, [worker, submitted] {
+            return worker->completed >= submitted;
+        });
+    }
+    MAGMA_UNUSED( func );
+    MAGMA_UNUSED( file );
+    MAGMA_UNUSED( line );
+}
+
+
+// =============================================================================
+// event support
+
+/***************************************************************************//**
+    Creates an event.
+
+    @param[in]
+    event           On output, the newly created event.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_create( magma_event_t* event )
+{
+    magma_event_t ev = new magma_event;
+    ev->recorded  = 0;
+    ev->completed = 0;
+    *event = ev;
+}
+
+
+/***************************************************************************//**
+    Creates an event, without timing support. The same as magma_event_create
+    for host-emulated devices.
+
+    @param[in]
+    event           On output, the newly created event.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_create_untimed( magma_event_t* event )
+{
+    magma_event_create( event );
+}
+
+
+/***************************************************************************//*
+    Destroys an event, freeing its resources.
+    Waits for the event to trigger, since queued operations refer to it.
+
+    @param[in]
+    event           Event to destroy.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_destroy( magma_event_t event )
+{
+    if ( event != NULL ) {
+        magma_event_sync( event );
+        delete event;
+    }
+}
+
+
+/***************************************************************************//**
+    Records an event into the queue's execution stream.
+    The event will trigger when all previous operations on this queue finish.
+
+    @param[in]
+    event           Event to record.
+
+    @param[in]
+    queue           Queue to execute in.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_record( magma_event_t event, magma_queue_t queue )
+{
+    long long ticket;
+    {
+        std::lock_guard< std::mutex > guard( event->mutex );
+        ticket = ++event->recorded;
+    }
+    magma_host_enqueue( queue, [event, ticket] {
+        std::lock_guard< std::mutex > guard( event->mutex );
+        event->completed = max( event->completed, ticket );
+        event->cv.notify_all();
+    });
+}
+
+
+/***************************************************************************//**
+    Synchronizes with an event. The CPU blocks until the event triggers.
+
+    @param[in]
+    event           Event to synchronize with.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_event_sync( magma_event_t event )
+{
+    std::unique_lock< std::mutex > lock( event->mutex );
+    long long ticket = event->recorded;
+    event->cv.wait( lock, [event, ticket] {
+        return event->completed >= ticket;
+    });
+}
+
+
+/***************************************************************************//**
+    Synchronizes a queue with an event. The queue blocks until the event
+    triggers. The CPU does not block.
+
+    @param[in]
+    event           Event to synchronize with.
+
+    @param[in]
+    queue           Queue to synchronize.
+
+    @ingroup magma_event
+*******************************************************************************/
+extern "C" void
+magma_queue_wait_event( magma_queue_t queue, magma_event_t event )
+{
+    long long ticket;
+    {
+        std::lock_guard< std::mutex > guard( event->mutex );
+        ticket = event->recorded;
+    }
+    magma_host_enqueue( queue, [event, ticket] {
+        std::unique_lock< std::mutex > lock( event->mutex );
+        event->cv.wait( lock, [event, ticket] {
+            return event->completed >= ticket;
+        });
+    });
+}
+
+#endif // HAVE_HOST
@@ -16,7 +16,7 @@
 
 #if defined(_OPENMP)
 #include <omp.h>
-#include "magma_threadsetting.h"
+#include "magma_thread_budget.h"
 #endif
 
 /*******************************************************************************/
@@ -27,21 +27,23 @@ blas_zlacpy_batched(
     magmaDoubleComplex               **hB_array, magma_int_t ldb,
     magma_int_t batchCount )
 {
+    // each OpenMP thread is bound to its own CPU, with single-threaded BLAS
     #if defined(_OPENMP)
-    magma_int_t nthreads = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
-    magma_set_omp_numthreads(nthreads);
-    #pragma omp parallel for schedule(dynamic)
+    magma_thread_region region( "zlacpy_batched", magma_get_lapack_numthreads() );
+    #pragma omp parallel num_threads( region.num_threads() )
     #endif
-    for (int i=0; i < batchCount; i++) {
-        lapackf77_zlacpy( lapack_uplo_const(uplo),
-                          &m, &n,
-                          hA_array[i], &lda,
-                          hB_array[i], &ldb );
+    {
+        #if defined(_OPENMP)
+        magma_thread_worker worker( region, omp_get_thread_num() );
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (int i=0; i < batchCount; i++) {
+            lapackf77_zlacpy( lapack_uplo_const(uplo),
+                              &m, &n,
+                              hA_array[i], &lda,
+                              hB_array[i], &ldb );
+        }
     }
-    #if defined(_OPENMP)
-    magma_set_lapack_numthreads(nthreads);
-    #endif
 }
 
 /*******************************************************************************/
@@ -56,23 +58,25 @@ blas_zgemm_batched(
         magmaDoubleComplex **hC_array, magma_int_t ldc,
         magma_int_t batchCount )
 {
+    // each OpenMP thread is bound to its own CPU, with single-threaded BLAS
     #if defined(_OPENMP)
-    magma_int_t nthreads = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
-    magma_set_omp_numthreads(nthreads);
-    #pragma omp parallel for schedule(dynamic)
+    magma_thread_region region( "zgemm_batched", magma_get_lapack_numthreads() );
+    #pragma omp parallel num_threads( region.num_threads() )
     #endif
-    for (int i=0; i < batchCount; i++) {
-        blasf77_zgemm( lapack_trans_const(transA),
-                       lapack_trans_const(transB),
-                       &m, &n, &k,
-                       &alpha, hA_array[i], &lda,
-                               hB_array[i], &ldb,
-                       &beta,  hC_array[i], &ldc );
+    {
+        #if defined(_OPENMP)
+        magma_thread_worker worker( region, omp_get_thread_num() );
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (int i=0; i < batchCount; i++) {
+            blasf77_zgemm( lapack_trans_const(transA),
+                           lapack_trans_const(transB),
+                           &m, &n, &k,
+                           &alpha, hA_array[i], &lda,
+                                   hB_array[i], &ldb,
+                           &beta,  hC_array[i], &ldc );
+        }
     }
-    #if defined(_OPENMP)
-    magma_set_lapack_numthreads(nthreads);
-    #endif
 }
 
 /*******************************************************************************/
@@ -85,23 +89,25 @@ blas_ztrsm_batched(
         magmaDoubleComplex **hB_array, magma_int_t ldb,
         magma_int_t batchCount )
 {
+    // each OpenMP thread is bound to its own CPU, with single-threaded BLAS
     #if defined(_OPENMP)
-    magma_int_t nthreads = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
-    magma_set_omp_numthreads(nthreads);
-    #pragma omp parallel for schedule(dynamic)
+    magma_thread_region region( "ztrsm_batched", magma_get_lapack_numthreads() );
+    #pragma omp parallel num_threads( region.num_threads() )
     #endif
-    for (int s=0; s < batchCount; s++) {
-        blasf77_ztrsm(
-            lapack_side_const(side), lapack_uplo_const(uplo),
-            lapack_trans_const(transA), lapack_diag_const(diag),
-            &m, &n, &alpha,
-            hA_array[s], &lda,
-            hB_array[s], &ldb );
+    {
+        #if defined(_OPENMP)
+        magma_thread_worker worker( region, omp_get_thread_num() );
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (int s=0; s < batchCount; s++) {
+            blasf77_ztrsm(
+                lapack_side_const(side), lapack_uplo_const(uplo),
+                lapack_trans_const(transA), lapack_diag_const(diag),
+                &m, &n, &alpha,
+                hA_array[s], &lda,
+                hB_array[s], &ldb );
+        }
     }
-    #if defined(_OPENMP)
-    magma_set_lapack_numthreads(nthreads);
-    #endif
 }
 
 /*******************************************************************************/
@@ -114,23 +120,25 @@ blas_ztrmm_batched(
         magmaDoubleComplex **hB_array, magma_int_t ldb,
         magma_int_t batchCount )
 {
+    // each OpenMP thread is bound to its own CPU, with single-threaded BLAS
     #if defined(_OPENMP)
-    magma_int_t nthreads = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
-    magma_set_omp_numthreads(nthreads);
-    #pragma omp parallel for schedule(dynamic)
+    magma_thread_region region( "ztrmm_batched", magma_get_lapack_numthreads() );
+    #pragma omp parallel num_threads( region.num_threads() )
     #endif
-    for (int s=0; s < batchCount; s++) {
-        blasf77_ztrmm(
-            lapack_side_const(side), lapack_uplo_const(uplo),
-            lapack_trans_const(transA), lapack_diag_const(diag),
-            &m, &n, &alpha,
-            hA_array[s], &lda,
-            hB_array[s], &ldb );
+    {
+        #if defined(_OPENMP)
+        magma_thread_worker worker( region, omp_get_thread_num() );
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (int s=0; s < batchCount; s++) {
+            blasf77_ztrmm(
+                lapack_side_const(side), lapack_uplo_const(uplo),
+                lapack_trans_const(transA), lapack_diag_const(diag),
+                &m, &n, &alpha,
+                hA_array[s], &lda,
+                hB_array[s], &ldb );
+        }
     }
-    #if defined(_OPENMP)
-    magma_set_lapack_numthreads(nthreads);
-    #endif
 }
 
 /*******************************************************************************/
@@ -145,23 +153,25 @@ blas_zhemm_batched(
         magmaDoubleComplex **hC_array, magma_int_t ldc,
         magma_int_t batchCount )
 {
+    // each OpenMP thread is bound to its own CPU, with single-threaded BLAS
     #if defined(_OPENMP)
-    magma_int_t nthreads = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
-    magma_set_omp_numthreads(nthreads);
-    #pragma omp parallel for schedule(dynamic)
+    magma_thread_region region( "zhemm_batched", magma_get_lapack_numthreads() );
+    #pragma omp parallel num_threads( region.num_threads() )
     #endif
-    for (int i=0; i < batchCount; i++) {
-        blasf77_zhemm( lapack_side_const(side),
-                       lapack_uplo_const(uplo),
-                       &m, &n,
-                       &alpha, hA_array[i], &lda,
-                               hB_array[i], &ldb,
-                       &beta,  hC_array[i], &ldc );
+    {
+        #if defined(_OPENMP)
+        magma_thread_worker worker( region, omp_get_thread_num() );
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (int i=0; i < batchCount; i++) {
+            blasf77_zhemm( lapack_side_const(side),
+                           lapack_uplo_const(uplo),
+                           &m, &n,
+                           &alpha, hA_array[i], &lda,
+                                   hB_array[i], &ldb,
+                           &beta,  hC_array[i], &ldc );
+        }
     }
-    #if defined(_OPENMP)
-    magma_set_lapack_numthreads(nthreads);
-    #endif
 }
 
 /*******************************************************************************/
@@ -173,22 +183,24 @@ blas_zherk_batched(
     double beta,  magmaDoubleComplex               **hC_array, magma_int_t ldc,
     magma_int_t batchCount )
 {
+    // each OpenMP thread is bound to its own CPU, with single-threaded BLAS
     #if defined(_OPENMP)
-    magma_int_t nthreads = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
-    magma_set_omp_numthreads(nthreads);
-    #pragma omp parallel for schedule(dynamic)
+    magma_thread_region region( "zherk_batched", magma_get_lapack_numthreads() );
+    #pragma omp parallel num_threads( region.num_threads() )
     #endif
-    for (int s=0; s < batchCount; s++) {
-        blasf77_zherk( lapack_uplo_const(uplo),
-                       lapack_trans_const(trans),
-                       &n, &k,
-                       &alpha, hA_array[s], &lda,
-                       &beta,  hC_array[s], &ldc );
+    {
+        #if defined(_OPENMP)
+        magma_thread_worker worker( region, omp_get_thread_num() );
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (int s=0; s < batchCount; s++) {
+            blasf77_zherk( lapack_uplo_const(uplo),
+                           lapack_trans_const(trans),
+                           &n, &k,
+                           &alpha, hA_array[s], &lda,
+                           &beta,  hC_array[s], &ldc );
+        }
     }
-    #if defined(_OPENMP)
-    magma_set_lapack_numthreads(nthreads);
-    #endif
 }
 
 /*******************************************************************************/
@@ -201,22 +213,24 @@ blas_zher2k_batched(
     double beta,              magmaDoubleComplex               **hC_array, magma_int_t ldc,
     magma_int_t batchCount )
 {
+    // each OpenMP thread is bound to its own CPU, with single-threaded BLAS
     #if defined(_OPENMP)
-    magma_int_t nthreads = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
-    magma_set_omp_numthreads(nthreads);
-    #pragma omp parallel for schedule(dynamic)
+    magma_thread_region region( "zher2k_batched", magma_get_lapack_numthreads() );
+    #pragma omp parallel num_threads( region.num_threads() )
     #endif
-    for (int i=0; i < batchCount; i++) {
-        blasf77_zher2k( lapack_uplo_const(uplo),
-                        lapack_trans_const(trans),
-                        &n, &k,
-                        &alpha, hA_array[i], &lda,
-                                hB_array[i], &ldb,
-                        &beta,  hC_array[i], &ldc );
+    {
+        #if defined(_OPENMP)
+        magma_thread_worker worker( region, omp_get_thread_num() );
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (int i=0; i < batchCount; i++) {
+            blasf77_zher2k( lapack_uplo_const(uplo),
+                            lapack_trans_const(trans),
+                            &n, &k,
+                            &alpha, hA_array[i], &lda,
+                                    hB_array[i], &ldb,
+                            &beta,  hC_array[i], &ldc );
+        }
     }
-    #if defined(_OPENMP)
-    magma_set_lapack_numthreads(nthreads);
-    #endif
 }
 
@@ -0,0 +1,30 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+/***************************************************************************//**
+    Adds offset to the m pivots in ipiv, which is on the device.
+    Host-emulated version of magmablas/getrf_setup_pivinfo.cu.
+*******************************************************************************/
+extern "C" void
+adjust_ipiv( magma_int_t *ipiv,
+                 magma_int_t m, magma_int_t offset,
+                 magma_queue_t queue)
+{
+    if (offset == 0 ) return;
+
+    magma_host_enqueue( queue, [=] {
+        for( magma_int_t i = 0; i < m; ++i ) {
+            ipiv[ i ] += offset;
+        }
+    });
+}
+
+#endif // HAVE_HOST
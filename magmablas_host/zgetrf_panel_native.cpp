@@ -0,0 +1,50 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+/***************************************************************************//**
+    ZGETRF_PANEL computes an LU factorization of a general M-by-N panel dA
+    using partial pivoting with row interchanges.
+
+    Host-emulated version of src/zgetrf_panel_native.cpp: rather than
+    recursing over device kernels, the whole panel is factored by the host
+    LAPACK zgetrf on the queue's worker thread. Arguments are the same;
+    dipivinfo and update_queue are not used.
+
+    The pivots in dipiv are relative to the panel, and dinfo, if still 0,
+    is set to gbstep + i when U(i,i) is exactly zero.
+
+    @ingroup magma_getrf_batched
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zgetrf_recpanel_native(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex_ptr dA, magma_int_t ldda,
+    magma_int_t* dipiv, magma_int_t* dipivinfo,
+    magma_int_t *dinfo, magma_int_t gbstep,
+    magma_queue_t queue, magma_queue_t update_queue)
+{
+    if (m == 0 || n == 0) {
+        return 0;
+    }
+
+    magma_host_enqueue( queue, [=] {
+        magma_int_t iinfo = 0;
+        lapackf77_zgetrf( &m, &n, dA, &ldda, dipiv, &iinfo );
+        if ( *dinfo == 0 && iinfo > 0 ) {
+            *dinfo = iinfo + gbstep;
+        }
+    });
+    return 0;
+}
+
+#endif // HAVE_HOST
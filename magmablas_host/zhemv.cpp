@@ -0,0 +1,98 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+// Host-emulated versions of magmablas/zhemv.cu, using the host BLAS.
+// Arguments are the same; the workspace dwork is not used.
+
+/***************************************************************************//**
+    magmablas_zhemv_work performs the matrix-vector operation:
+
+        y := alpha*A*x + beta*y,
+
+    where alpha and beta are scalars, x and y are n element vectors and
+    A is an n by n Hermitian matrix.
+    @see magmablas/zhemv.cu
+    @ingroup magma_hemv
+*******************************************************************************/
+extern "C"
+magma_int_t
+magmablas_zhemv_work(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr dy, magma_int_t incy,
+    magmaDoubleComplex_ptr dwork, magma_int_t lwork,
+    magma_queue_t queue )
+{
+    bool upper = (uplo == MagmaUpper);
+
+    /*
+     * Test the input parameters.
+     */
+    magma_int_t info = 0;
+    if ((! upper) && (uplo != MagmaLower)) {
+        info = -1;
+    } else if ( n < 0 ) {
+        info = -2;
+    } else if ( ldda < max(1, n) ) {
+        info = -5;
+    } else if ( incx == 0 ) {
+        info = -7;
+    } else if ( incy == 0 ) {
+        info = -10;
+    }
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return info;
+    }
+
+    /*
+     * Quick return if possible.
+     */
+    if ( (n == 0) || ( MAGMA_Z_EQUAL(alpha, MAGMA_Z_ZERO) && MAGMA_Z_EQUAL(beta, MAGMA_Z_ONE) ) )
+        return info;
+
+    magma_host_enqueue( queue, [=] {
+        blasf77_zhemv( lapack_uplo_const( uplo ), &n,
+                       &alpha, dA, &ldda, dx, &incx,
+                       &beta,  dy, &incy );
+    });
+
+    return info;
+}
+
+
+/***************************************************************************//**
+    Same as magmablas_zhemv_work, without a workspace.
+    @see magmablas/zhemv.cu
+    @ingroup magma_hemv
+*******************************************************************************/
+extern "C"
+magma_int_t
+magmablas_zhemv(
+    magma_uplo_t uplo, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_const_ptr dx, magma_int_t incx,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex_ptr dy, magma_int_t incy,
+    magma_queue_t queue )
+{
+    return magmablas_zhemv_work( uplo, n, alpha, dA, ldda, dx, incx,
+                                 beta, dy, incy, NULL, 0, queue );
+}
+
+#endif // HAVE_HOST
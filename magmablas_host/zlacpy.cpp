@@ -0,0 +1,54 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+/***************************************************************************//**
+    ZLACPY copies all or part of a two-dimensional matrix dA to another
+    matrix dB.
+    Host-emulated version of magmablas/zlacpy.cu, using LAPACK's zlacpy.
+    @see magmablas/zlacpy.cu
+    @ingroup magma_lacpy
+*******************************************************************************/
+extern "C" void
+magmablas_zlacpy(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dB, magma_int_t lddb,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    if ( uplo != MagmaLower && uplo != MagmaUpper && uplo != MagmaFull )
+        info = -1;
+    else if ( m < 0 )
+        info = -2;
+    else if ( n < 0 )
+        info = -3;
+    else if ( ldda < max(1,m))
+        info = -5;
+    else if ( lddb < max(1,m))
+        info = -7;
+
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return;  //info;
+    }
+
+    if ( m == 0 || n == 0 ) {
+        return;
+    }
+
+    magma_host_enqueue( queue, [=] {
+        lapackf77_zlacpy( lapack_uplo_const( uplo ), &m, &n, dA, &ldda, dB, &lddb );
+    });
+}
+
+#endif // HAVE_HOST
@@ -0,0 +1,53 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+/***************************************************************************//**
+    ZLASET initializes a 2-D array A to DIAG on the diagonal and
+    OFFDIAG on the off-diagonals.
+    Host-emulated version of magmablas/zlaset.cu, using LAPACK's zlaset.
+    @see magmablas/zlaset.cu
+    @ingroup magma_laset
+*******************************************************************************/
+extern "C"
+void magmablas_zlaset(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n,
+    magmaDoubleComplex offdiag, magmaDoubleComplex diag,
+    magmaDoubleComplex_ptr dA, magma_int_t ldda,
+    magma_queue_t queue)
+{
+    magma_int_t info = 0;
+    if ( uplo != MagmaLower && uplo != MagmaUpper && uplo != MagmaFull )
+        info = -1;
+    else if ( m < 0 )
+        info = -2;
+    else if ( n < 0 )
+        info = -3;
+    else if ( ldda < max(1,m) )
+        info = -7;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return;  //info;
+    }
+
+    if ( m == 0 || n == 0 ) {
+        return;
+    }
+
+    magma_host_enqueue( queue, [=] {
+        lapackf77_zlaset( lapack_uplo_const( uplo ), &m, &n,
+                          &offdiag, &diag, dA, &ldda );
+    });
+}
+
+#endif // HAVE_HOST
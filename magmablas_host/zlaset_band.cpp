@@ -0,0 +1,67 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+/***************************************************************************//**
+    ZLASET_BAND initializes the main diagonal of dA to DIAG,
+    and the K-1 sub- or super-diagonals to OFFDIAG.
+    Host-emulated version of magmablas/zlaset_band.cu. Arguments are the same.
+    @see magmablas/zlaset_band.cu
+    @ingroup magma_laset_band
+*******************************************************************************/
+extern "C" void
+magmablas_zlaset_band(
+    magma_uplo_t uplo, magma_int_t m, magma_int_t n, magma_int_t k,
+    magmaDoubleComplex offdiag, magmaDoubleComplex diag,
+    magmaDoubleComplex_ptr dA, magma_int_t ldda,
+    magma_queue_t queue)
+{
+    #define dA(i_, j_) (dA + (i_) + (j_)*ldda)
+
+    magma_int_t info = 0;
+    if ( uplo != MagmaLower && uplo != MagmaUpper )
+        info = -1;
+    else if ( m < 0 )
+        info = -2;
+    else if ( n < 0 )
+        info = -3;
+    else if ( k < 0 || k > 1024 )
+        info = -4;
+    else if ( ldda < max(1,m) )
+        info = -6;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return;  //info;
+    }
+
+    magma_host_enqueue( queue, [=] {
+        for( magma_int_t j = 0; j < n; ++j ) {
+            magma_int_t ibegin, iend;
+            if (uplo == MagmaUpper) {
+                ibegin = max( 0, j-k+1 );
+                iend   = min( j+1, m );
+            }
+            else {
+                ibegin = j;
+                iend   = min( j+k, m );
+            }
+            for( magma_int_t i = ibegin; i < iend; ++i ) {
+                *dA(i,j) = (i == j ? diag : offdiag);
+            }
+        }
+    });
+
+    #undef dA
+}
+
+#endif // HAVE_HOST
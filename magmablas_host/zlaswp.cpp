@@ -0,0 +1,95 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include <vector>
+
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+// Host-emulated versions of magmablas/zlaswp.cu and magmablas/zlaswp_batched.cu.
+// Arguments are the same.
+
+/***************************************************************************//**
+    ZLASWP performs a series of row interchanges on the matrix A,
+    stored row-wise in dAT.
+    As in the CUDA version, the pivots in ipiv, which is on the CPU,
+    are read when the routine is called, not when it runs.
+    @see magmablas/zlaswp.cu
+    @ingroup magma_laswp
+*******************************************************************************/
+extern "C" void
+magmablas_zlaswp(
+    magma_int_t n,
+    magmaDoubleComplex_ptr dAT, magma_int_t ldda,
+    magma_int_t k1, magma_int_t k2,
+    const magma_int_t *ipiv, magma_int_t inci,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    if ( n < 0 )
+        info = -1;
+    else if ( n > ldda )
+        info = -3;
+    else if ( k1 < 1 )
+        info = -4;
+    else if ( k2 < 1 )
+        info = -5;
+    else if ( inci <= 0 )
+        info = -7;
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return;  //info;
+    }
+
+    std::vector< magma_int_t > pivots;
+    for( magma_int_t k = k1-1; k < k2; ++k ) {
+        pivots.push_back( ipiv[ k*inci ] - 1 );
+    }
+
+    magma_host_enqueue( queue, [=] {
+        const magma_int_t ione = 1;
+        for( magma_int_t k = 0; k < (magma_int_t) pivots.size(); ++k ) {
+            magma_int_t i1 = k1-1 + k;
+            magma_int_t i2 = pivots[k];
+            if ( i2 != i1 ) {
+                blasf77_zswap( &n, dAT + i1*ldda, &ione, dAT + i2*ldda, &ione );
+            }
+        }
+    });
+}
+
+
+/******************************************************************************/
+// serial swap that does swapping one column by one column
+// K1, K2 are in Fortran indexing; dipiv is on the device
+extern "C" void
+magma_zlaswp_columnserial(
+    magma_int_t n, magmaDoubleComplex_ptr dA, magma_int_t lda,
+    magma_int_t k1, magma_int_t k2,
+    magma_int_t *dipiv, magma_queue_t queue)
+{
+    if (n == 0 ) return;
+
+    magma_host_enqueue( queue, [=] {
+        const magma_int_t ione = 1;
+        if ( k1 < 1 || k2 < 1 ) return;
+
+        magma_int_t step = (k1 <= k2 ? 1 : -1);
+        for( magma_int_t i1 = k1-1; i1 != k2-1 + step; i1 += step ) {
+            magma_int_t i2 = dipiv[ i1 ] - 1;  // Fortran index, switch i1 and i2
+            if ( i2 != i1 ) {
+                blasf77_zswap( &n, dA + i1*lda, &ione, dA + i2*lda, &ione );
+            }
+        }
+    });
+}
+
+#endif // HAVE_HOST
@@ -0,0 +1,64 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+/***************************************************************************//**
+    ZPOTRF_RECTILE computes the Cholesky factorization of a complex Hermitian
+    positive definite tile dA.
+
+    Host-emulated version of src/zpotrf_panel_native.cpp: the tile is
+    factored by the host LAPACK zpotrf on the queue's worker thread, so
+    recnb is not used and both MagmaLower and MagmaUpper are supported.
+
+    dinfo, on the device, is set to gbstep + i if it is still 0 and the
+    leading minor of order i is not positive definite. info, on the CPU,
+    reports only argument errors, as the factorization is asynchronous.
+
+    @ingroup magma_potrf
+*******************************************************************************/
+extern "C" magma_int_t
+magma_zpotrf_rectile_native(
+    magma_uplo_t uplo, magma_int_t n, magma_int_t recnb,
+    magmaDoubleComplex* dA,    magma_int_t ldda, magma_int_t gbstep,
+    magma_int_t *dinfo,  magma_int_t *info, magma_queue_t queue)
+{
+    *info = 0;
+    // check arguments
+    if ( uplo != MagmaLower && uplo != MagmaUpper ) {
+        *info = -1;
+    } else if (n < 0) {
+        *info = -2;
+    } else if (ldda < max(1,n)) {
+        *info = -5;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return *info;
+    }
+
+    // Quick return if possible
+    if ( n == 0 ) {
+        return *info;
+    }
+
+    magma_host_enqueue( queue, [=] {
+        magma_int_t iinfo = 0;
+        lapackf77_zpotrf( lapack_uplo_const( uplo ), &n, dA, &ldda, &iinfo );
+        if ( *dinfo == 0 && iinfo > 0 ) {
+            *dinfo = iinfo + gbstep;
+        }
+    });
+
+    return *info;
+}
+
+#endif // HAVE_HOST
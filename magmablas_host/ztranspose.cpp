@@ -0,0 +1,89 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+// Host-emulated versions of magmablas/ztranspose.cu and
+// magmablas/ztranspose_inplace.cu. Arguments are the same.
+
+/***************************************************************************//**
+    ztranspose copies and transposes a matrix dA to matrix dAT.
+    @see magmablas/ztranspose.cu
+    @ingroup magma_transpose
+*******************************************************************************/
+extern "C" void
+magmablas_ztranspose(
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex_const_ptr dA,  magma_int_t ldda,
+    magmaDoubleComplex_ptr       dAT, magma_int_t lddat,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    if ( m < 0 )
+        info = -1;
+    else if ( n < 0 )
+        info = -2;
+    else if ( ldda < m )
+        info = -4;
+    else if ( lddat < n )
+        info = -6;
+
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return;  //info;
+    }
+
+    /* Quick return */
+    if ( (m == 0) || (n == 0) )
+        return;
+
+    magma_host_enqueue( queue, [=] {
+        for( magma_int_t j = 0; j < n; ++j ) {
+            for( magma_int_t i = 0; i < m; ++i ) {
+                dAT[ j + i*lddat ] = dA[ i + j*ldda ];
+            }
+        }
+    });
+}
+
+
+/***************************************************************************//**
+    ztranspose_inplace transposes a square N-by-N matrix in-place.
+    @see magmablas/ztranspose_inplace.cu
+    @ingroup magma_transpose
+*******************************************************************************/
+extern "C" void
+magmablas_ztranspose_inplace(
+    magma_int_t n,
+    magmaDoubleComplex_ptr dA, magma_int_t ldda,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    if ( n < 0 )
+        info = -1;
+    else if ( ldda < n )
+        info = -3;
+
+    if ( info != 0 ) {
+        magma_xerbla( __func__, -(info) );
+        return;  //info;
+    }
+
+    magma_host_enqueue( queue, [=] {
+        for( magma_int_t j = 0; j < n; ++j ) {
+            for( magma_int_t i = j+1; i < n; ++i ) {
+                std::swap( dA[ i + j*ldda ], dA[ j + i*ldda ] );
+            }
+        }
+    });
+}
+
+#endif // HAVE_HOST
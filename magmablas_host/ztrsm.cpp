@@ -0,0 +1,82 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "host_queue.h"
+
+#ifdef HAVE_HOST
+
+/***************************************************************************//**
+    ztrsm solves one of the matrix equations on the device
+
+        op(A)*X = alpha*B,   or
+        X*op(A) = alpha*B,
+
+    where alpha is a scalar, X and B are m by n matrices, A is a unit, or
+    non-unit, upper or lower triangular matrix and op(A) is one of
+
+        op(A) = A,   or
+        op(A) = A^T, or
+        op(A) = A^H.
+
+    The matrix X is overwritten on B.
+    Host-emulated version of magmablas/ztrsm.cu, using the host BLAS.
+    @see magmablas/ztrsm.cu
+    @ingroup magma_trsm
+*******************************************************************************/
+extern "C"
+void magmablas_ztrsm(
+    magma_side_t side, magma_uplo_t uplo, magma_trans_t transA, magma_diag_t diag,
+    magma_int_t m, magma_int_t n,
+    magmaDoubleComplex alpha,
+    magmaDoubleComplex_const_ptr dA, magma_int_t ldda,
+    magmaDoubleComplex_ptr       dB, magma_int_t lddb,
+    magma_queue_t queue )
+{
+    magma_int_t nrowA = (side == MagmaLeft ? m : n);
+
+    magma_int_t info = 0;
+    if ( side != MagmaLeft && side != MagmaRight ) {
+        info = -1;
+    } else if ( uplo != MagmaUpper && uplo != MagmaLower ) {
+        info = -2;
+    } else if ( transA != MagmaNoTrans && transA != MagmaTrans && transA != MagmaConjTrans ) {
+        info = -3;
+    } else if ( diag != MagmaUnit && diag != MagmaNonUnit ) {
+        info = -4;
+    } else if (m < 0) {
+        info = -5;
+    } else if (n < 0) {
+        info = -6;
+    } else if (dA == NULL) {
+        info = -8;
+    } else if (ldda < max(1,nrowA)) {
+        info = -9;
+    } else if (dB == NULL) {
+        info = -10;
+    } else if (lddb < max(1,m)) {
+        info = -11;
+    }
+
+    if (info != 0) {
+        magma_xerbla( __func__, -(info) );
+        return;
+    }
+
+    // quick return if possible.
+    if (m == 0 || n == 0)
+        return;
+
+    magma_host_enqueue( queue, [=] {
+        blasf77_ztrsm( lapack_side_const( side ), lapack_uplo_const( uplo ),
+                       lapack_trans_const( transA ), lapack_diag_const( diag ),
+                       &m, &n, &alpha, dA, &ldda, dB, &lddb );
+    });
+}
+
+#endif // HAVE_HOST
@@ -10,6 +10,7 @@
 
 */
 #include "magmasparse_internal.h"
+#include "magma_metrics.h"
 
 #define PRECISION_z
 
@@ -132,6 +133,8 @@ magma_z_spmv(
     magma_z_matrix y,
     magma_queue_t queue )
 {
+    // one multiply-add per nonzero
+    MAGMA_METRICS( "magma_z_spmv", FLOPS_ZAXPY( A.nnz ) );
     magma_int_t info = 0;
 
     magma_z_matrix x2={Magma_CSR};
@@ -322,6 +325,10 @@ magma_z_spmv(
             }
         }
     }
+    // host SpMV from the reduced-precision copy (magma_zmlowprec_cpu)
+    else if ( A.col_base != NULL && x.num_cols == 1 ) {
+        CHECK( magma_zspmv_lowprec_cpu( alpha, A, x, beta, y, queue ));
+    }
     // CPU case missing!
     else {
         CHECK( magma_zmtransfer( x, &dx, x.memory_location, Magma_DEV, queue ));
@@ -0,0 +1,883 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// strength of connection threshold on the finest level, halved on every
+// coarser level: a_ij is strong if |a_ij|^2 > theta^2 |a_ii| |a_jj|
+#define AMG_THETA        0.08
+// levels with at most this many rows are solved with dense LU
+#define AMG_COARSE_SIZE  256
+// the coarsest level is never factorized beyond this size
+#define AMG_COARSE_MAX   4096
+#define AMG_MAX_LEVELS   10
+// degree of the Chebyshev polynomial per smoothing step and the ratio of
+// the largest to the smallest eigenvalue it targets
+#define AMG_CHEB_DEGREE  3
+#define AMG_CHEB_RATIO   30.0
+#define AMG_POWER_ITERS  15
+
+/*
+    Host smoothed-aggregation AMG.
+
+    Aggregates are formed in parallel from a distance-2 maximal independent
+    set of the strength graph: every MIS node is the root of an aggregate,
+    the remaining nodes join a strongly connected aggregate at distance one
+    and then two. The tentative prolongator T interpolates the constant
+    vector, it is smoothed with one damped Jacobi step,
+        P = ( I - 4/(3 lambda) D^{-1} A ) T,
+    and the coarse operator is the Galerkin product P^H A P computed with
+    magma_zspgemm_cpu. The V-cycle uses a Chebyshev smoother on D^{-1} A
+    (damped Jacobi if precond->trisolver is Magma_JACOBI) with
+    precond->maxiter smoothing steps and a dense LU solve on the coarsest
+    level.
+*/
+
+
+// y = A x
+static void
+magma_zamg_spmv(
+    magma_z_matrix A,
+    const magmaDoubleComplex *x,
+    magmaDoubleComplex *y )
+{
+    #pragma omp parallel for schedule(dynamic,256)
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magmaDoubleComplex s = MAGMA_Z_ZERO;
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            s = s + A.val[j] * x[ A.col[j] ];
+        }
+        y[i] = s;
+    }
+}
+
+
+// r = D^{-1} ( b - A x ) if dinv != NULL, else r = b - A x
+static void
+magma_zamg_residual(
+    magma_z_matrix A,
+    const magmaDoubleComplex *dinv,
+    const magmaDoubleComplex *b,
+    const magmaDoubleComplex *x,
+    magmaDoubleComplex *r )
+{
+    #pragma omp parallel for schedule(dynamic,256)
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magmaDoubleComplex s = b[i];
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            s = s - A.val[j] * x[ A.col[j] ];
+        }
+        r[i] = ( dinv != NULL ) ? dinv[i] * s : s;
+    }
+}
+
+
+// deterministic pseudo-random priority of node i
+static inline magma_int_t
+magma_zamg_hash( magma_int_t i )
+{
+    unsigned int h = (unsigned int) i * 2654435761u;
+    h ^= h >> 16;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    return (magma_int_t) ( h & 0x3fffffff );
+}
+
+
+// parallel aggregation based on a distance-2 maximal independent set of the
+// strength graph; agg[i] is the aggregate of node i
+static magma_int_t
+magma_zamg_aggregate(
+    magma_z_matrix A,
+    double theta,
+    magma_index_t *agg,
+    magma_int_t *num_agg,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_int_t n = A.num_rows, undecided = n, nagg = 0;
+    double *dabs = NULL;
+    unsigned long long *t0 = NULL, *t1 = NULL, *t2 = NULL;
+    magma_index_t *agg2 = NULL;
+    const double theta2 = theta * theta;
+
+    CHECK( magma_dmalloc_cpu( &dabs, n+1 ));
+    CHECK( magma_malloc_cpu( (void**) &t0, (n+1) * sizeof(unsigned long long) ));
+    CHECK( magma_malloc_cpu( (void**) &t1, (n+1) * sizeof(unsigned long long) ));
+    CHECK( magma_malloc_cpu( (void**) &t2, (n+1) * sizeof(unsigned long long) ));
+    CHECK( magma_index_malloc_cpu( &agg2, n+1 ));
+
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        dabs[i] = 0.0;
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            if( A.col[j] == i ){
+                dabs[i] = MAGMA_Z_ABS( A.val[j] );
+            }
+        }
+        // key: state (0 out, 1 undecided, 2 in), priority, index
+        t0[i] = ( 1ULL << 62 ) | ( (unsigned long long) magma_zamg_hash( i ) << 32 )
+                               | (unsigned long long) i;
+    }
+
+    #define AMG_STRONG( i, j, a ) \
+        ( (j) != (i) && MAGMA_Z_ABS( a ) * MAGMA_Z_ABS( a ) > theta2 * dabs[i] * dabs[j] )
+
+    while( undecided > 0 ){
+        // propagate the maximal key twice along strong connections
+        #pragma omp parallel for schedule(dynamic,256)
+        for( magma_int_t i=0; i<n; i++ ){
+            unsigned long long t = t0[i];
+            for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+                magma_index_t c = A.col[j];
+                if( AMG_STRONG( i, c, A.val[j] ) && t0[c] > t ){
+                    t = t0[c];
+                }
+            }
+            t1[i] = t;
+        }
+        #pragma omp parallel for schedule(dynamic,256)
+        for( magma_int_t i=0; i<n; i++ ){
+            unsigned long long t = t1[i];
+            for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+                magma_index_t c = A.col[j];
+                if( AMG_STRONG( i, c, A.val[j] ) && t1[c] > t ){
+                    t = t1[c];
+                }
+            }
+            t2[i] = t;
+        }
+        undecided = 0;
+        #pragma omp parallel for reduction(+:undecided)
+        for( magma_int_t i=0; i<n; i++ ){
+            if( ( t0[i] >> 62 ) == 1 ){
+                if( t2[i] == t0[i] ){
+                    t0[i] = ( 2ULL << 62 ) | ( t0[i] & ~( 3ULL << 62 ));
+                } else if( ( t2[i] >> 62 ) == 2 ){
+                    t0[i] = t0[i] & ~( 3ULL << 62 );
+                } else {
+                    undecided++;
+                }
+            }
+        }
+    }
+
+    // roots
+    for( magma_int_t i=0; i<n; i++ ){
+        agg[i] = ( ( t0[i] >> 62 ) == 2 ) ? nagg++ : -1;
+    }
+    // distance one, then distance two
+    #pragma omp parallel for schedule(dynamic,256)
+    for( magma_int_t i=0; i<n; i++ ){
+        agg2[i] = agg[i];
+        for( magma_int_t j=A.row[i]; j<A.row[i+1] && agg2[i] < 0; j++ ){
+            magma_index_t c = A.col[j];
+            if( AMG_STRONG( i, c, A.val[j] ) && agg[c] >= 0 ){
+                agg2[i] = agg[c];
+            }
+        }
+    }
+    #pragma omp parallel for schedule(dynamic,256)
+    for( magma_int_t i=0; i<n; i++ ){
+        agg[i] = agg2[i];
+        for( magma_int_t j=A.row[i]; j<A.row[i+1] && agg[i] < 0; j++ ){
+            magma_index_t c = A.col[j];
+            if( AMG_STRONG( i, c, A.val[j] ) && agg2[c] >= 0 ){
+                agg[i] = agg2[c];
+            }
+        }
+    }
+    #undef AMG_STRONG
+    // nodes left over by a nonsymmetric strength graph become singletons
+    for( magma_int_t i=0; i<n; i++ ){
+        if( agg[i] < 0 ){
+            agg[i] = nagg++;
+        }
+    }
+    *num_agg = nagg;
+
+cleanup:
+    magma_free_cpu( dabs );
+    magma_free_cpu( t0 );
+    magma_free_cpu( t1 );
+    magma_free_cpu( t2 );
+    magma_free_cpu( agg2 );
+    return info;
+}
+
+
+// smoothed prolongator P = ( I - omega D^{-1} A ) T for the aggregates agg
+static magma_int_t
+magma_zamg_prolongator(
+    magma_z_amg_level *lev,
+    magma_index_t *agg,
+    magma_int_t num_agg,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix A = lev->A;
+    magma_z_matrix T={Magma_CSR}, J={Magma_CSR};
+    magma_index_t *size = NULL;
+    magma_int_t n = A.num_rows;
+    magmaDoubleComplex omega = MAGMA_Z_MAKE( 4.0 / ( 3.0 * lev->lambda ), 0.0 );
+
+    // tentative prolongator: normalized piecewise constant
+    CHECK( magma_index_malloc_cpu( &size, num_agg+1 ));
+    for( magma_int_t a=0; a<num_agg; a++ ){
+        size[a] = 0;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        size[ agg[i] ]++;
+    }
+    T.storage_type = Magma_CSR;
+    T.memory_location = Magma_CPU;
+    T.ownership = MagmaTrue;
+    T.num_rows = n;
+    T.num_cols = num_agg;
+    T.nnz = n;
+    T.true_nnz = n;
+    CHECK( magma_index_malloc_cpu( &T.row, n+1 ));
+    CHECK( magma_index_malloc_cpu( &T.col, n+1 ));
+    CHECK( magma_zmalloc_cpu( &T.val, n+1 ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n+1; i++ ){
+        T.row[i] = i;
+    }
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        T.col[i] = agg[i];
+        T.val[i] = MAGMA_Z_MAKE( 1.0 / sqrt( (double) size[ agg[i] ] ), 0.0 );
+    }
+
+    // Jacobi smoother J = I - omega D^{-1} A, one extra slot per row in
+    // case the diagonal is not stored
+    J.storage_type = Magma_CSR;
+    J.memory_location = Magma_CPU;
+    J.ownership = MagmaTrue;
+    J.num_rows = n;
+    J.num_cols = n;
+    CHECK( magma_index_malloc_cpu( &J.row, n+1 ));
+    J.row[0] = 0;
+    for( magma_int_t i=0; i<n; i++ ){
+        J.row[i+1] = J.row[i] + A.row[i+1] - A.row[i] + 1;
+    }
+    CHECK( magma_index_malloc_cpu( &J.col, J.row[n]+1 ));
+    CHECK( magma_zmalloc_cpu( &J.val, J.row[n]+1 ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_index_t nz = J.row[i];
+        magma_int_t has_diag = 0;
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            J.col[nz] = A.col[j];
+            J.val[nz] = MAGMA_Z_ZERO - omega * lev->dinv[i] * A.val[j];
+            if( A.col[j] == i ){
+                J.val[nz] = J.val[nz] + MAGMA_Z_ONE;
+                has_diag = 1;
+            }
+            nz++;
+        }
+        // pad the row with an explicit diagonal (zero if already stored)
+        J.col[nz] = i;
+        J.val[nz] = has_diag ? MAGMA_Z_ZERO : MAGMA_Z_ONE;
+    }
+    J.nnz = J.row[n];
+    J.true_nnz = J.nnz;
+
+    CHECK( magma_zspgemm_cpu( J, T, &lev->P, queue ));
+
+cleanup:
+    magma_free_cpu( size );
+    magma_zmfree( &T, queue );
+    magma_zmfree( &J, queue );
+    return info;
+}
+
+
+// inverse diagonal and estimate of the largest eigenvalue of D^{-1} A
+static magma_int_t
+magma_zamg_spectrum(
+    magma_z_amg_level *lev,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix A = lev->A;
+    magma_int_t n = A.num_rows;
+    magmaDoubleComplex *v = NULL, *w = NULL;
+    double gersh = 0.0, est = 0.0;
+
+    CHECK( magma_zmalloc_cpu( &lev->dinv, n+1 ));
+    CHECK( magma_zmalloc_cpu( &v, n+1 ));
+    CHECK( magma_zmalloc_cpu( &w, n+1 ));
+
+    #pragma omp parallel for reduction(max:gersh)
+    for( magma_int_t i=0; i<n; i++ ){
+        magmaDoubleComplex d = MAGMA_Z_ZERO;
+        double rowsum = 0.0;
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            rowsum += MAGMA_Z_ABS( A.val[j] );
+            if( A.col[j] == i ){
+                d = A.val[j];
+            }
+        }
+        lev->dinv[i] = ( MAGMA_Z_ABS( d ) > 0.0 ) ? MAGMA_Z_ONE / d : MAGMA_Z_ONE;
+        gersh = max( gersh, rowsum * MAGMA_Z_ABS( lev->dinv[i] ));
+        v[i] = MAGMA_Z_MAKE( 0.5 + magma_zamg_hash( i ) / (double) 0x3fffffff, 0.0 );
+    }
+
+    // power iteration on D^{-1} A
+    for( magma_int_t k=0; k<AMG_POWER_ITERS; k++ ){
+        double nv = 0.0, nw = 0.0;
+        magma_zamg_spmv( A, v, w );
+        #pragma omp parallel for reduction(+:nv,nw)
+        for( magma_int_t i=0; i<n; i++ ){
+            w[i] = lev->dinv[i] * w[i];
+            nv += MAGMA_Z_ABS( v[i] ) * MAGMA_Z_ABS( v[i] );
+            nw += MAGMA_Z_ABS( w[i] ) * MAGMA_Z_ABS( w[i] );
+        }
+        if( nw == 0.0 ){
+            break;
+        }
+        est = sqrt( nw / nv );
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            v[i] = w[i] * MAGMA_Z_MAKE( 1.0 / sqrt( nw ), 0.0 );
+        }
+    }
+    lev->lambda = min( 1.1 * est, gersh );
+    if( lev->lambda <= 0.0 ){
+        lev->lambda = 1.0;
+    }
+
+cleanup:
+    magma_free_cpu( v );
+    magma_free_cpu( w );
+    return info;
+}
+
+
+// nonzero if A equals its conjugate transpose up to rounding
+static magma_int_t
+magma_zamg_hermitian(
+    magma_z_matrix A )
+{
+    magma_int_t hermitian = 1;
+    double eps = 100 * lapackf77_dlamch( "E" );
+
+    #pragma omp parallel for reduction(min:hermitian) schedule(dynamic,256)
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            magma_index_t c = A.col[j];
+            magmaDoubleComplex t = MAGMA_Z_ZERO;
+            for( magma_int_t k=A.row[c]; k<A.row[c+1]; k++ ){
+                if( A.col[k] == i ){
+                    t = A.val[k];
+                    break;
+                }
+            }
+            if( MAGMA_Z_ABS( A.val[j] - MAGMA_Z_CONJ( t )) > eps * MAGMA_Z_ABS( A.val[j] )){
+                hermitian = 0;
+            }
+        }
+    }
+    return hermitian;
+}
+
+
+// R = P^H for the rectangular prolongator P, the columns of R are sorted
+static magma_int_t
+magma_zamg_restriction(
+    magma_z_matrix P,
+    magma_z_matrix *R,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    R->storage_type = Magma_CSR;
+    R->memory_location = Magma_CPU;
+    R->ownership = MagmaTrue;
+    R->num_rows = P.num_cols;
+    R->num_cols = P.num_rows;
+    R->nnz = P.nnz;
+    R->true_nnz = P.nnz;
+    CHECK( magma_index_malloc_cpu( &R->row, R->num_rows+2 ));
+    CHECK( magma_index_malloc_cpu( &R->col, P.nnz+1 ));
+    CHECK( magma_zmalloc_cpu( &R->val, P.nnz+1 ));
+
+    for( magma_int_t i=0; i<R->num_rows+2; i++ ){
+        R->row[i] = 0;
+    }
+    for( magma_int_t j=0; j<P.nnz; j++ ){
+        R->row[ P.col[j]+2 ]++;
+    }
+    for( magma_int_t i=2; i<R->num_rows+2; i++ ){
+        R->row[i] += R->row[i-1];
+    }
+    // R->row[c+1] is the insertion point of column c of P
+    for( magma_int_t i=0; i<P.num_rows; i++ ){
+        for( magma_int_t j=P.row[i]; j<P.row[i+1]; j++ ){
+            magma_index_t nz = R->row[ P.col[j]+1 ]++;
+            R->col[nz] = i;
+            R->val[nz] = MAGMA_Z_CONJ( P.val[j] );
+        }
+    }
+
+cleanup:
+    return info;
+}
+
+
+// dense LU factorization of the coarsest operator
+static magma_int_t
+magma_zamg_coarse(
+    magma_z_amg_level *lev,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix A = lev->A;
+    magma_int_t n = A.num_rows, linfo = 0;
+
+    if( n > AMG_COARSE_MAX ){
+        // too large for a dense solve, the level is only smoothed
+        goto cleanup;
+    }
+    CHECK( magma_zmalloc_cpu( &lev->lu, n*n+1 ));
+    CHECK( magma_imalloc_cpu( &lev->ipiv, n+1 ));
+    for( magma_int_t i=0; i<n*n; i++ ){
+        lev->lu[i] = MAGMA_Z_ZERO;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            lev->lu[ i + A.col[j]*n ] = A.val[j];
+        }
+    }
+    lapackf77_zgetrf( &n, &n, lev->lu, &n, lev->ipiv, &linfo );
+    if( linfo != 0 ){
+        printf("%% warning: singular AMG coarse level, using the smoother.\n");
+        magma_free_cpu( lev->lu );
+        magma_free_cpu( lev->ipiv );
+        lev->lu = NULL;
+        lev->ipiv = NULL;
+    }
+
+cleanup:
+    return info;
+}
+
+
+// sweeps smoothing steps on lev->A x = b
+static void
+magma_zamg_smooth(
+    magma_z_amg_level *lev,
+    magma_int_t sweeps,
+    magma_int_t jacobi )
+{
+    magma_z_matrix A = lev->A;
+    magma_int_t n = A.num_rows;
+    magmaDoubleComplex *x = lev->x, *b = lev->b, *r = lev->r;
+
+    if( jacobi ){
+        magmaDoubleComplex omega = MAGMA_Z_MAKE( 4.0 / ( 3.0 * lev->lambda ), 0.0 );
+        for( magma_int_t k=0; k<sweeps; k++ ){
+            magma_zamg_residual( A, lev->dinv, b, x, r );
+            #pragma omp parallel for
+            for( magma_int_t i=0; i<n; i++ ){
+                x[i] = x[i] + omega * r[i];
+            }
+        }
+        return;
+    }
+
+    // Chebyshev iteration on [ lambda / ratio, lambda ], r holds the update
+    double upper = lev->lambda, lower = lev->lambda / AMG_CHEB_RATIO;
+    double theta = 0.5 * ( upper + lower ), delta = 0.5 * ( upper - lower );
+    double sigma = theta / delta;
+    for( magma_int_t k=0; k<sweeps; k++ ){
+        double rho = 1.0 / sigma;
+        magma_zamg_residual( A, lev->dinv, b, x, r );
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            r[i] = r[i] * MAGMA_Z_MAKE( 1.0 / theta, 0.0 );
+            x[i] = x[i] + r[i];
+        }
+        for( magma_int_t p=1; p<AMG_CHEB_DEGREE; p++ ){
+            double rho_new = 1.0 / ( 2.0 * sigma - rho );
+            magmaDoubleComplex c1 = MAGMA_Z_MAKE( rho_new * rho, 0.0 );
+            magmaDoubleComplex c2 = MAGMA_Z_MAKE( 2.0 * rho_new / delta, 0.0 );
+            // r holds the previous update d; d = c1 d + c2 D^{-1}( b - A x )
+            #pragma omp parallel for schedule(dynamic,256)
+            for( magma_int_t i=0; i<n; i++ ){
+                magmaDoubleComplex s = b[i];
+                for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+                    s = s - A.val[j] * x[ A.col[j] ];
+                }
+                r[i] = c1 * r[i] + c2 * lev->dinv[i] * s;
+            }
+            #pragma omp parallel for
+            for( magma_int_t i=0; i<n; i++ ){
+                x[i] = x[i] + r[i];
+            }
+            rho = rho_new;
+        }
+    }
+}
+
+
+// V-cycle on level l with zero initial guess
+static void
+magma_zamg_vcycle(
+    magma_z_preconditioner *precond,
+    magma_int_t l )
+{
+    magma_z_amg_level *lev = precond->amg_levels + l;
+    magma_int_t n = lev->A.num_rows, ione = 1, linfo = 0;
+    magma_int_t sweeps = max( precond->maxiter, 1 );
+    magma_int_t jacobi = ( precond->trisolver == Magma_JACOBI );
+
+    if( l == precond->amg_num_levels-1 && lev->lu != NULL ){
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            lev->x[i] = lev->b[i];
+        }
+        lapackf77_zgetrs( "N", &n, &ione, lev->lu, &n, lev->ipiv, lev->x, &n, &linfo );
+        return;
+    }
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        lev->x[i] = MAGMA_Z_ZERO;
+    }
+    magma_zamg_smooth( lev, sweeps, jacobi );
+    if( l == precond->amg_num_levels-1 ){
+        return;
+    }
+    // restrict the residual, correct with the coarse solution
+    magma_zamg_residual( lev->A, NULL, lev->b, lev->x, lev->r );
+    magma_zamg_spmv( lev->R, lev->r, lev[1].b );
+    magma_zamg_vcycle( precond, l+1 );
+    magma_zamg_spmv( lev->P, lev[1].x, lev->r );
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        lev->x[i] = lev->x[i] + lev->r[i];
+    }
+    magma_zamg_smooth( lev, sweeps, jacobi );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Frees the host AMG hierarchy of the preconditioner.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zamgfree_cpu(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    if( precond->amg_levels != NULL ){
+        for( magma_int_t l=0; l<precond->amg_num_levels; l++ ){
+            magma_z_amg_level *lev = precond->amg_levels + l;
+            magma_zmfree( &lev->A, queue );
+            magma_zmfree( &lev->P, queue );
+            magma_zmfree( &lev->R, queue );
+            magma_free_cpu( lev->dinv );
+            magma_free_cpu( lev->x );
+            magma_free_cpu( lev->b );
+            magma_free_cpu( lev->r );
+            magma_free_cpu( lev->lu );
+            magma_free_cpu( lev->ipiv );
+        }
+        magma_free_cpu( precond->amg_levels );
+    }
+    precond->amg_levels = NULL;
+    precond->amg_num_levels = 0;
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Builds the host smoothed-aggregation AMG hierarchy for A. The number of
+    levels is bounded by precond->levels (default 10); levels with at most
+    256 rows are solved directly.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zamgsetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, AP={Magma_CSR};
+    magma_index_t *agg = NULL;
+    magma_int_t max_levels, num_agg = 0;
+    double theta = AMG_THETA;
+
+    max_levels = ( precond->levels > 0 ) ? precond->levels : AMG_MAX_LEVELS;
+
+    CHECK( magma_zamgfree_cpu( precond, queue ));
+    CHECK( magma_malloc_cpu( (void**) &precond->amg_levels,
+                             max_levels * sizeof(magma_z_amg_level) ));
+    for( magma_int_t l=0; l<max_levels; l++ ){
+        magma_z_amg_level *lev = precond->amg_levels + l;
+        magma_z_matrix empty={Magma_CSR};
+        lev->A = empty;
+        lev->P = empty;
+        lev->R = empty;
+        lev->dinv = NULL;
+        lev->x = NULL;
+        lev->b = NULL;
+        lev->r = NULL;
+        lev->lu = NULL;
+        lev->ipiv = NULL;
+        lev->lambda = 1.0;
+        lev->hermitian = 0;
+    }
+
+    CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmconvert( hA, &precond->amg_levels[0].A, hA.storage_type,
+                            Magma_CSR, queue ));
+    precond->amg_levels[0].hermitian = magma_zamg_hermitian( precond->amg_levels[0].A );
+
+    for( magma_int_t l=0; l<max_levels; l++ ){
+        magma_z_amg_level *lev = precond->amg_levels + l;
+        magma_int_t n = lev->A.num_rows;
+        precond->amg_num_levels = l+1;
+
+        CHECK( magma_zmalloc_cpu( &lev->x, n+1 ));
+        CHECK( magma_zmalloc_cpu( &lev->b, n+1 ));
+        CHECK( magma_zmalloc_cpu( &lev->r, n+1 ));
+        CHECK( magma_zamg_spectrum( lev, queue ));
+
+        if( n <= AMG_COARSE_SIZE || l == max_levels-1 ){
+            CHECK( magma_zamg_coarse( lev, queue ));
+            break;
+        }
+        CHECK( magma_index_malloc_cpu( &agg, n+1 ));
+        CHECK( magma_zamg_aggregate( lev->A, theta, agg, &num_agg, queue ));
+        theta *= 0.5;
+        if( num_agg >= n || num_agg == 0 ){
+            // coarsening stagnates
+            CHECK( magma_zamg_coarse( lev, queue ));
+            break;
+        }
+        CHECK( magma_zamg_prolongator( lev, agg, num_agg, queue ));
+        magma_free_cpu( agg );
+        agg = NULL;
+        CHECK( magma_zamg_restriction( lev->P, &lev->R, queue ));
+        CHECK( magma_zspgemm_cpu( lev->A, lev->P, &AP, queue ));
+        CHECK( magma_zspgemm_cpu( lev->R, AP, &lev[1].A, queue ));
+        magma_zmfree( &AP, queue );
+    }
+
+    // host work vectors for staging device vectors
+    magma_zmfree( &precond->work1, queue );
+    magma_zmfree( &precond->work2, queue );
+    CHECK( magma_zvinit( &precond->work1, Magma_CPU, A.num_rows, 1, MAGMA_Z_ZERO, queue ));
+    CHECK( magma_zvinit( &precond->work2, Magma_CPU, A.num_rows, 1, MAGMA_Z_ZERO, queue ));
+
+cleanup:
+    if( info != 0 ){
+        magma_zamgfree_cpu( precond, queue );
+    }
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &AP, queue );
+    magma_free_cpu( agg );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Applies one V-cycle of the host AMG preconditioner, x = M^{-1} b.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[out]
+    x           magma_z_matrix*
+                preconditioned vector
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyamg_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_amg_level *lev = precond->amg_levels;
+    magma_int_t n = b.num_rows;
+
+    if( lev == NULL ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if( b.memory_location == Magma_CPU ){
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            lev->b[i] = b.val[i];
+        }
+    } else {
+        magma_zgetvector( n, b.dval, 1, lev->b, 1, queue );
+    }
+
+    magma_zamg_vcycle( precond, 0 );
+
+    if( x->memory_location == Magma_CPU ){
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            x->val[i] = lev->x[i];
+        }
+    } else {
+        magma_zsetvector( n, lev->x, 1, x->dval, 1, queue );
+    }
+
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Applies the transpose of one V-cycle of the host AMG preconditioner,
+    x = M^{-T} b. The smoothers are real polynomials in D^{-1} A, the same
+    before and after the coarse correction, and the coarse operators are
+    Galerkin products with R = P^H, so for Hermitian A the V-cycle is
+    Hermitian and M^{-T} b = conj( M^{-1} conj( b )). Other matrices return
+    MAGMA_ERR_NOT_SUPPORTED.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[out]
+    x           magma_z_matrix*
+                preconditioned vector
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyamg_transpose_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_amg_level *lev = precond->amg_levels;
+    magma_int_t n = b.num_rows;
+
+    if( lev == NULL || ! lev->hermitian ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if( b.memory_location == Magma_CPU ){
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            lev->b[i] = MAGMA_Z_CONJ( b.val[i] );
+        }
+    } else {
+        magma_zgetvector( n, b.dval, 1, lev->b, 1, queue );
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            lev->b[i] = MAGMA_Z_CONJ( lev->b[i] );
+        }
+    }
+
+    magma_zamg_vcycle( precond, 0 );
+
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        lev->x[i] = MAGMA_Z_CONJ( lev->x[i] );
+    }
+    if( x->memory_location == Magma_CPU ){
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            x->val[i] = lev->x[i];
+        }
+    } else {
+        magma_zsetvector( n, lev->x, 1, x->dval, 1, queue );
+    }
+
+cleanup:
+    return info;
+}
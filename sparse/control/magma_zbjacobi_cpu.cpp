@@ -0,0 +1,455 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define COMPLEX
+
+// default bound for the size of the diagonal blocks
+#define BJACOBI_MAX_BS 32
+// blocks up to this size are inverted with the Gauss-Jordan kernels,
+// larger ones with LAPACK LU
+#define BJACOBI_GJ_MAX 32
+
+#ifdef COMPLEX
+    #define BJACOBI_COMPONENTS 2
+#else
+    #define BJACOBI_COMPONENTS 1
+#endif
+
+
+/*
+    Host block-Jacobi preconditioner.
+
+    The diagonal blocks follow the supernodal structure of the matrix:
+    consecutive rows with identical pattern form a supernode, and
+    consecutive supernodes are merged into blocks of at most precond->bsize
+    rows (like magma_zmsupernodal). Each block is extracted as dense
+    column-major matrix and inverted in place, blocks of up to 8 rows with
+    size-specialized Gauss-Jordan kernels, larger ones with the generic
+    kernel or LAPACK. The preconditioner is then applied as dense
+    block-diagonal SpMV. If precond->format is Magma_FLOAT or Magma_FCOMPLEX,
+    the inverted blocks are stored in single precision and converted on the
+    fly, which halves the memory traffic of the application.
+*/
+
+
+// in-place inversion of the column-major n-by-n matrix A by Gauss-Jordan
+// elimination with partial pivoting; N > 0 fixes the size at compile time
+template <int N>
+static magma_int_t
+magma_zbjacobi_gj(
+    magma_int_t size,
+    magmaDoubleComplex *A,
+    magma_int_t *ipiv )
+{
+    const magma_int_t n = ( N > 0 ) ? N : size;
+
+    for( magma_int_t k=0; k<n; k++ ){
+        magma_int_t p = k;
+        double maxv = MAGMA_Z_ABS( A[ k + k*n ] );
+        for( magma_int_t i=k+1; i<n; i++ ){
+            if( MAGMA_Z_ABS( A[ i + k*n ] ) > maxv ){
+                maxv = MAGMA_Z_ABS( A[ i + k*n ] );
+                p = i;
+            }
+        }
+        if( maxv == 0.0 ){
+            return k+1;
+        }
+        ipiv[k] = p;
+        if( p != k ){
+            for( magma_int_t j=0; j<n; j++ ){
+                magmaDoubleComplex t = A[ k + j*n ];
+                A[ k + j*n ] = A[ p + j*n ];
+                A[ p + j*n ] = t;
+            }
+        }
+        magmaDoubleComplex piv = MAGMA_Z_ONE / A[ k + k*n ];
+        A[ k + k*n ] = MAGMA_Z_ONE;
+        for( magma_int_t j=0; j<n; j++ ){
+            A[ k + j*n ] = A[ k + j*n ] * piv;
+        }
+        for( magma_int_t i=0; i<n; i++ ){
+            if( i != k ){
+                magmaDoubleComplex f = A[ i + k*n ];
+                A[ i + k*n ] = MAGMA_Z_ZERO;
+                for( magma_int_t j=0; j<n; j++ ){
+                    A[ i + j*n ] = A[ i + j*n ] - f * A[ k + j*n ];
+                }
+            }
+        }
+    }
+    // the row interchanges turn into column interchanges of the inverse
+    for( magma_int_t k=n-1; k>=0; k-- ){
+        magma_int_t p = ipiv[k];
+        if( p != k ){
+            for( magma_int_t i=0; i<n; i++ ){
+                magmaDoubleComplex t = A[ i + k*n ];
+                A[ i + k*n ] = A[ i + p*n ];
+                A[ i + p*n ] = t;
+            }
+        }
+    }
+    return 0;
+}
+
+
+// inverts one block, returns nonzero if the block is singular
+static magma_int_t
+magma_zbjacobi_invert(
+    magma_int_t n,
+    magmaDoubleComplex *A,
+    magma_int_t *ipiv,
+    magmaDoubleComplex *work,
+    magma_int_t lwork )
+{
+    magma_int_t linfo = 0;
+    switch( n ){
+        case 1: return magma_zbjacobi_gj<1>( n, A, ipiv );
+        case 2: return magma_zbjacobi_gj<2>( n, A, ipiv );
+        case 3: return magma_zbjacobi_gj<3>( n, A, ipiv );
+        case 4: return magma_zbjacobi_gj<4>( n, A, ipiv );
+        case 5: return magma_zbjacobi_gj<5>( n, A, ipiv );
+        case 6: return magma_zbjacobi_gj<6>( n, A, ipiv );
+        case 7: return magma_zbjacobi_gj<7>( n, A, ipiv );
+        case 8: return magma_zbjacobi_gj<8>( n, A, ipiv );
+        default:
+            if( n <= BJACOBI_GJ_MAX ){
+                return magma_zbjacobi_gj<0>( n, A, ipiv );
+            }
+            lapackf77_zgetrf( &n, &n, A, &n, ipiv, &linfo );
+            if( linfo == 0 ){
+                lapackf77_zgetri( &n, A, &n, ipiv, work, &lwork, &linfo );
+            }
+            return linfo;
+    }
+}
+
+
+// copies the diagonal block of A covering rows/columns [s, s+n) into the
+// column-major array B
+static void
+magma_zbjacobi_extract(
+    magma_z_matrix A,
+    magma_int_t s,
+    magma_int_t n,
+    magmaDoubleComplex *B )
+{
+    for( magma_int_t e=0; e<n*n; e++ ){
+        B[e] = MAGMA_Z_ZERO;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t j=A.row[s+i]; j<A.row[s+i+1]; j++ ){
+            magma_int_t c = A.col[j] - s;
+            if( c >= 0 && c < n ){
+                B[ i + c*n ] = A.val[j];
+            }
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Prepares the host block-Jacobi preconditioner: detects the diagonal
+    blocks, extracts them in parallel and inverts them. The maximal block
+    size is precond->bsize (default 32). Singular blocks are replaced by
+    their diagonal.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zbjacobisetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, hACSR={Magma_CSR};
+    magma_index_t *start = NULL;
+    magma_int_t *ipiv = NULL;
+    magmaDoubleComplex *work = NULL;
+    magma_int_t n, num_starts = 0, max_bs, nnz_blocks, num_threads = 1;
+    magma_int_t num_singular = 0, lwork;
+
+    max_bs = ( precond->bsize > 0 ) ? precond->bsize : BJACOBI_MAX_BS;
+    lwork = 64 * max_bs;
+
+    CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmconvert( hA, &hACSR, hA.storage_type, Magma_CSR, queue ));
+    n = hACSR.num_rows;
+
+    magma_free_cpu( precond->block_ptr );
+    magma_free_cpu( precond->block_val_ptr );
+    magma_free_cpu( precond->block_val );
+    magma_free_cpu( precond->block_val_low );
+    precond->block_ptr = NULL;
+    precond->block_val_ptr = NULL;
+    precond->block_val = NULL;
+    precond->block_val_low = NULL;
+
+    // supernodes: a row starts a new one if its pattern differs from the
+    // pattern of the previous row
+    CHECK( magma_index_malloc_cpu( &start, n+1 ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t len = hACSR.row[i+1] - hACSR.row[i];
+        magma_int_t match = ( i > 0 && len == hACSR.row[i] - hACSR.row[i-1] );
+        for( magma_int_t j=0; match && j<len; j++ ){
+            match = ( hACSR.col[ hACSR.row[i]+j ] == hACSR.col[ hACSR.row[i-1]+j ] );
+        }
+        start[i] = !match;
+    }
+    // blocks: split supernodes larger than max_bs, merge consecutive ones
+    // as long as they fit
+    {
+        magma_int_t block = 0, i = 0;
+        while( i < n ){
+            magma_int_t len = 1;
+            while( i+len < n && !start[i+len] && len < max_bs ){
+                len++;
+            }
+            // start[] is compacted in place, entries < i+len are not read again
+            if( i == 0 || i + len - block > max_bs ){
+                block = i;
+                start[ num_starts++ ] = i;
+            }
+            i += len;
+        }
+        start[ num_starts ] = n;
+    }
+    precond->num_blocks = num_starts;
+
+    CHECK( magma_index_malloc_cpu( &precond->block_ptr, num_starts+1 ));
+    CHECK( magma_index_malloc_cpu( &precond->block_val_ptr, num_starts+1 ));
+    precond->block_val_ptr[0] = 0;
+    for( magma_int_t b=0; b<num_starts+1; b++ ){
+        precond->block_ptr[b] = start[b];
+    }
+    for( magma_int_t b=0; b<num_starts; b++ ){
+        magma_int_t bs = start[b+1] - start[b];
+        precond->block_val_ptr[b+1] = precond->block_val_ptr[b] + bs*bs;
+    }
+    nnz_blocks = precond->block_val_ptr[num_starts];
+    CHECK( magma_zmalloc_cpu( &precond->block_val, max(nnz_blocks,1) ));
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    CHECK( magma_imalloc_cpu( &ipiv, num_threads * max_bs ));
+    CHECK( magma_zmalloc_cpu( &work, num_threads * lwork ));
+
+    #pragma omp parallel
+    {
+        magma_int_t id = 0;
+        #ifdef _OPENMP
+        id = omp_get_thread_num();
+        #endif
+        #pragma omp for schedule(dynamic,16) reduction(+:num_singular)
+        for( magma_int_t b=0; b<num_starts; b++ ){
+            magma_int_t s = precond->block_ptr[b];
+            magma_int_t bs = precond->block_ptr[b+1] - s;
+            magmaDoubleComplex *B = precond->block_val + precond->block_val_ptr[b];
+            magma_zbjacobi_extract( hACSR, s, bs, B );
+            if( magma_zbjacobi_invert( bs, B, ipiv + id*max_bs,
+                                       work + id*lwork, lwork ) != 0 ){
+                // fall back to the diagonal for this block
+                num_singular++;
+                magma_zbjacobi_extract( hACSR, s, bs, B );
+                for( magma_int_t i=0; i<bs; i++ ){
+                    magmaDoubleComplex d = B[ i + i*bs ];
+                    for( magma_int_t j=0; j<bs; j++ ){
+                        B[ i + j*bs ] = MAGMA_Z_ZERO;
+                    }
+                    B[ i + i*bs ] = ( MAGMA_Z_ABS( d ) > 0.0 ) ?
+                                            MAGMA_Z_ONE / d : MAGMA_Z_ONE;
+                }
+            }
+        }
+    }
+    if( num_singular > 0 ){
+        printf("%% warning: %lld singular diagonal blocks, using their diagonal.\n",
+               (long long) num_singular );
+    }
+
+    // reduced precision storage
+    if( precond->format == Magma_FLOAT || precond->format == Magma_FCOMPLEX ){
+        CHECK( magma_smalloc_cpu( &precond->block_val_low,
+                            max(nnz_blocks,1) * BJACOBI_COMPONENTS ));
+        #pragma omp parallel for
+        for( magma_int_t e=0; e<nnz_blocks; e++ ){
+            precond->block_val_low[ BJACOBI_COMPONENTS*e ] =
+                                    (float) MAGMA_Z_REAL( precond->block_val[e] );
+            #ifdef COMPLEX
+            precond->block_val_low[ BJACOBI_COMPONENTS*e+1 ] =
+                                    (float) MAGMA_Z_IMAG( precond->block_val[e] );
+            #endif
+        }
+        magma_free_cpu( precond->block_val );
+        precond->block_val = NULL;
+    }
+
+    // host work vectors for staging device vectors
+    magma_zmfree( &precond->work1, queue );
+    magma_zmfree( &precond->work2, queue );
+    CHECK( magma_zvinit( &precond->work1, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+    CHECK( magma_zvinit( &precond->work2, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hACSR, queue );
+    magma_free_cpu( start );
+    magma_free_cpu( ipiv );
+    magma_free_cpu( work );
+    return info;
+}
+
+
+// entry e of the inverted blocks
+static inline magmaDoubleComplex
+magma_zbjacobi_val(
+    const magmaDoubleComplex *val,
+    const float *val_low,
+    magma_int_t e )
+{
+    if( val != NULL ){
+        return val[e];
+    }
+    #ifdef COMPLEX
+    return MAGMA_Z_MAKE( val_low[ 2*e ], val_low[ 2*e+1 ] );
+    #else
+    return MAGMA_Z_MAKE( val_low[ e ], 0.0 );
+    #endif
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Applies the host block-Jacobi preconditioner, x = op(D^{-1}) b, as dense
+    block-diagonal SpMV. Vectors on the device are staged through the host
+    work vectors of the preconditioner. x and b must be different vectors.
+    Only single vectors matching the size of the preconditioner are
+    supported, blocks of vectors return MAGMA_ERR_NOT_SUPPORTED.
+
+    Arguments
+    ---------
+
+    @param[in]
+    trans       magma_trans_t
+                apply the inverse or its (conjugate) transpose
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[in,out]
+    x           magma_z_matrix*
+                vector to precondition
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplybjacobi_cpu(
+    magma_trans_t trans,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    const magmaDoubleComplex *bv = b.val;
+    magmaDoubleComplex *xv = x->val;
+    const magmaDoubleComplex *val = precond->block_val;
+    const float *val_low = precond->block_val_low;
+
+    if( precond->block_ptr == NULL || b.num_cols != 1 || x->num_cols != 1
+        || b.num_rows != precond->block_ptr[ precond->num_blocks ] ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if( b.memory_location != Magma_CPU ){
+        magma_zgetvector( b.num_rows, b.dval, 1, precond->work1.val, 1, queue );
+        bv = precond->work1.val;
+        xv = precond->work2.val;
+    }
+
+    #pragma omp parallel for schedule(dynamic,64)
+    for( magma_int_t k=0; k<precond->num_blocks; k++ ){
+        magma_int_t s = precond->block_ptr[k];
+        magma_int_t bs = precond->block_ptr[k+1] - s;
+        magma_int_t off = precond->block_val_ptr[k];
+        if( trans == MagmaNoTrans ){
+            for( magma_int_t i=0; i<bs; i++ ){
+                xv[ s+i ] = MAGMA_Z_ZERO;
+            }
+            for( magma_int_t j=0; j<bs; j++ ){
+                magmaDoubleComplex bj = bv[ s+j ];
+                for( magma_int_t i=0; i<bs; i++ ){
+                    xv[ s+i ] = xv[ s+i ] +
+                        magma_zbjacobi_val( val, val_low, off + i + j*bs ) * bj;
+                }
+            }
+        } else {
+            for( magma_int_t i=0; i<bs; i++ ){
+                magmaDoubleComplex sum = MAGMA_Z_ZERO;
+                for( magma_int_t j=0; j<bs; j++ ){
+                    magmaDoubleComplex v = magma_zbjacobi_val( val, val_low, off + j + i*bs );
+                    if( trans == MagmaConjTrans ){
+                        v = MAGMA_Z_CONJ( v );
+                    }
+                    sum = sum + v * bv[ s+j ];
+                }
+                xv[ s+i ] = sum;
+            }
+        }
+    }
+
+    if( b.memory_location != Magma_CPU ){
+        magma_zsetvector( b.num_rows, precond->work2.val, 1, x->dval, 1, queue );
+    }
+
+cleanup:
+    return info;
+}
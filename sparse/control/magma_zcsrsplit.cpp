@@ -72,6 +72,10 @@ magma_zcsrsplit(
     D->row = NULL;
     D->rowidx = NULL;
     D->blockinfo = NULL;
+    D->val_low = NULL;
+    D->col_low = NULL;
+    D->col_base = NULL;
+    D->storage_precision = Magma_DCOMPLEX;
     D->diag = NULL;
     D->dval = NULL;
     D->dcol = NULL;
@@ -83,6 +87,10 @@ magma_zcsrsplit(
     R->row = NULL;
     R->rowidx = NULL;
     R->blockinfo = NULL;
+    R->val_low = NULL;
+    R->col_low = NULL;
+    R->col_base = NULL;
+    R->storage_precision = Magma_DCOMPLEX;
     R->diag = NULL;
     R->dval = NULL;
     R->dcol = NULL;
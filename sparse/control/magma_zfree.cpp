@@ -123,6 +123,7 @@ magma_zmfree(
                 magma_free_cpu( A->val );
                 magma_free_cpu( A->col );
                 magma_free_cpu( A->row );
+                magma_zmlowprec_free( A, queue );
             }
             A->num_rows = 0;
             A->num_cols = 0;
@@ -164,6 +165,10 @@ magma_zmfree(
         A->row = NULL;
         A->rowidx = NULL;
         A->blockinfo = NULL;
+        A->val_low = NULL;
+        A->col_low = NULL;
+        A->col_base = NULL;
+        A->storage_precision = Magma_DCOMPLEX;
         A->diag = NULL;
         A->dval = NULL;
         A->dcol = NULL;
@@ -406,6 +411,10 @@ magma_zmfree(
         A->row = NULL;
         A->rowidx = NULL;
         A->blockinfo = NULL;
+        A->val_low = NULL;
+        A->col_low = NULL;
+        A->col_base = NULL;
+        A->storage_precision = Magma_DCOMPLEX;
         A->diag = NULL;
         A->dval = NULL;
         A->dcol = NULL;
@@ -472,11 +481,17 @@ magma_zprecondfree(
         precond_par->d2.val = NULL;
     }
     if ( precond_par->work1.val != NULL ) {
-        magma_free( precond_par->work1.val );
+        if ( precond_par->work1.memory_location == Magma_CPU )
+            magma_free_cpu( precond_par->work1.val );
+        else
+            magma_free( precond_par->work1.dval );
         precond_par->work1.val = NULL;
     }
     if ( precond_par->work2.val != NULL ) {
-        magma_free( precond_par->work2.val );
+        if ( precond_par->work2.memory_location == Magma_CPU )
+            magma_free_cpu( precond_par->work2.val );
+        else
+            magma_free( precond_par->work2.dval );
         precond_par->work2.val = NULL;
     }
     if ( precond_par->M.val != NULL ) {
@@ -529,6 +544,9 @@ magma_zprecondfree(
         magma_free_cpu( precond_par->L.blockinfo );
         precond_par->L.blockinfo = NULL;
     }
+    if ( precond_par->L.col_base != NULL ) {
+        magma_zmlowprec_free( &precond_par->L, queue );
+    }
     if ( precond_par->LT.val != NULL ) {
         if ( precond_par->LT.memory_location == Magma_DEV )
             magma_free( precond_par->LT.dval );
@@ -579,6 +597,9 @@ magma_zprecondfree(
         magma_free_cpu( precond_par->U.blockinfo );
         precond_par->U.blockinfo = NULL;
     }
+    if ( precond_par->U.col_base != NULL ) {
+        magma_zmlowprec_free( &precond_par->U, queue );
+    }
     if ( precond_par->UT.val != NULL ) {
         if ( precond_par->UT.memory_location == Magma_DEV )
             magma_free( precond_par->UT.dval );
@@ -738,6 +759,28 @@ magma_zprecondfree(
         magma_free( precond_par->U_dgraphindegree_bak );
         precond_par->U_dgraphindegree_bak = NULL;
     }
+    magma_ztrisolve_cpu_free( &precond_par->Lsched, queue );
+    magma_ztrisolve_cpu_free( &precond_par->Usched, queue );
+    magma_free_cpu( precond_par->block_ptr );
+    magma_free_cpu( precond_par->block_val_ptr );
+    magma_free_cpu( precond_par->block_val );
+    magma_free_cpu( precond_par->block_val_low );
+    precond_par->block_ptr = NULL;
+    precond_par->block_val_ptr = NULL;
+    precond_par->block_val = NULL;
+    precond_par->block_val_low = NULL;
+    precond_par->num_blocks = 0;
+    magma_free_cpu( precond_par->color_ptr );
+    magma_free_cpu( precond_par->color_perm );
+    magma_free_cpu( precond_par->color_dinv );
+    magma_free_cpu( precond_par->color_work );
+    precond_par->color_ptr = NULL;
+    precond_par->color_perm = NULL;
+    precond_par->color_dinv = NULL;
+    precond_par->color_work = NULL;
+    precond_par->num_colors = 0;
+    magma_zamgfree_cpu( precond_par, queue );
+    magma_zschwarzfree_cpu( precond_par, queue );
 
     precond_par->solver = Magma_NONE;
     
@@ -10,7 +10,12 @@
 
 */
 
+#include <algorithm>
+#include <vector>
 #include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define WARP_SIZE 32
 
@@ -435,6 +440,10 @@ magma_zmisai_blockstruct(
     A->row = NULL;
     A->rowidx = NULL;
     A->blockinfo = NULL;
+    A->val_low = NULL;
+    A->col_low = NULL;
+    A->col_base = NULL;
+    A->storage_precision = Magma_DCOMPLEX;
     A->diag = NULL;
     A->dval = NULL;
     A->dcol = NULL;
@@ -555,3 +564,459 @@ magma_zmisai_blockstruct(
 cleanup:
     return info;
 }
+
+
+// the local systems of ISAI_BATCH rows of equal size are stored interleaved,
+// entry (i,j) of the system in lane b at T[ (i*n+j)*ISAI_BATCH + b ], so the
+// innermost loops of the solve run over the lanes
+#define ISAI_BATCH 8
+
+
+// solves the ISAI_BATCH interleaved n-by-n triangular systems T x = e_p[b],
+// lanes with p[b] < 0 get x = 0
+static void
+magma_zisai_trsv_batch(
+    magma_int_t n,
+    magma_int_t lower,
+    magma_diag_t diagtype,
+    const magmaDoubleComplex *T,
+    const magma_index_t *p,
+    magmaDoubleComplex *x )
+{
+    magmaDoubleComplex sum[ ISAI_BATCH ];
+
+    for( magma_int_t s=0; s<n; s++ ){
+        magma_int_t i = lower ? s : n-1-s;
+        for( int b=0; b<ISAI_BATCH; b++ ){
+            sum[b] = ( p[b] == i ) ? MAGMA_Z_ONE : MAGMA_Z_ZERO;
+        }
+        magma_int_t jstart = lower ? 0 : i+1;
+        magma_int_t jend = lower ? i : n;
+        for( magma_int_t j=jstart; j<jend; j++ ){
+            const magmaDoubleComplex *t = T + (i*n+j)*ISAI_BATCH;
+            const magmaDoubleComplex *xj = x + j*ISAI_BATCH;
+            #pragma omp simd
+            for( int b=0; b<ISAI_BATCH; b++ ){
+                sum[b] = sum[b] - t[b] * xj[b];
+            }
+        }
+        const magmaDoubleComplex *d = T + (i*n+i)*ISAI_BATCH;
+        for( int b=0; b<ISAI_BATCH; b++ ){
+            x[ i*ISAI_BATCH+b ] = ( diagtype == MagmaUnit ) ? sum[b] : sum[b] / d[b];
+        }
+    }
+}
+
+
+// gathers op(L(J,J)) for J = pattern of row r of M into a dense system,
+// entry (i,j) goes to T[ i*rs + j*cs ]; returns the position of r in J
+static magma_int_t
+magma_zisai_gather(
+    magma_trans_t transtype,
+    magma_z_matrix L,
+    magma_z_matrix *M,
+    magma_int_t r,
+    magma_int_t rs,
+    magma_int_t cs,
+    magmaDoubleComplex *T )
+{
+    const magma_index_t *J = M->col + M->row[r];
+    magma_int_t n = M->row[r+1] - M->row[r];
+    magma_int_t p = -1;
+
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t t = J[i];
+        magma_int_t k = L.row[t];
+        magma_int_t l = 0;
+        if( t == r ){
+            p = i;
+        }
+        while( k < L.row[t+1] && l < n ){
+            if( L.col[k] == J[l] ){
+                magmaDoubleComplex v = ( transtype == MagmaConjTrans ) ?
+                                            MAGMA_Z_CONJ( L.val[k] ) : L.val[k];
+                if( transtype == MagmaNoTrans ){
+                    T[ i*rs + l*cs ] = v;
+                } else {
+                    T[ l*rs + i*cs ] = v;
+                }
+                k++;
+                l++;
+            } else if( L.col[k] < J[l] ){
+                k++;
+            } else {
+                l++;
+            }
+        }
+    }
+    return p;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Generates the ISAI for a triangular factor on the host. The pattern is
+    given in transposed fashion: row i of M holds the pattern of column i of
+    the ISAI, and for each row the local system op(L(J,J)) m = e_i is solved
+    for the entries m on the pattern J.
+
+    Contrary to the batched routines above, the workspace is not padded to
+    32x32 per row. The rows are grouped by system size, systems of the same
+    size are solved in batches of interleaved small dense systems, and rows
+    with more than 32 entries are solved one by one with a dense trsv. The
+    memory needed besides M is proportional to the number of rows plus a
+    small workspace per thread.
+
+    Arguments
+    ---------
+
+    @param[in]
+    uplotype    magma_uplo_t
+                lower or upper triangular
+
+    @param[in]
+    transtype   magma_trans_t
+                possibility for transposed matrix
+
+    @param[in]
+    diagtype    magma_diag_t
+                unit diagonal or not
+
+    @param[in]
+    L           magma_z_matrix
+                triangular factor in CSR on the host, sorted rows
+
+    @param[in,out]
+    M           magma_z_matrix*
+                transposed ISAI pattern in CSR on the host, sorted rows;
+                on output the values of the transposed ISAI
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zisai_generator_cpu(
+    magma_uplo_t uplotype,
+    magma_trans_t transtype,
+    magma_diag_t diagtype,
+    magma_z_matrix L,
+    magma_z_matrix *M,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_int_t warpsize = WARP_SIZE;
+    magma_int_t n = M->num_rows;
+    magma_int_t num_threads = 1;
+    magma_int_t num_batches = 0, num_large = 0, maxlarge = 0;
+    // op(L) is lower triangular
+    magma_int_t lower = ( uplotype == MagmaLower ) == ( transtype == MagmaNoTrans );
+    magma_index_t *size_ptr = NULL, *rows = NULL, *batch_ptr = NULL;
+    magmaDoubleComplex *work = NULL, *dense = NULL;
+
+    if( L.memory_location != Magma_CPU || M->memory_location != Magma_CPU ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+
+    // bucket the rows by system size, sizes above warpsize share one bucket
+    CHECK( magma_index_malloc_cpu( &size_ptr, warpsize+2 ) );
+    CHECK( magma_index_malloc_cpu( &rows, max(n,1) ) );
+    for( magma_int_t s=0; s<warpsize+2; s++ ){
+        size_ptr[s] = 0;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t s = min( M->row[i+1] - M->row[i], warpsize+1 );
+        size_ptr[s]++;
+        if( s > warpsize ){
+            maxlarge = max( maxlarge, M->row[i+1] - M->row[i] );
+        }
+    }
+    for( magma_int_t s=warpsize+1; s>0; s-- ){
+        size_ptr[s] = size_ptr[s-1];
+    }
+    size_ptr[0] = 0;
+    for( magma_int_t s=1; s<warpsize+2; s++ ){
+        size_ptr[s] += size_ptr[s-1];
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t s = min( M->row[i+1] - M->row[i], warpsize+1 );
+        rows[ size_ptr[s]++ ] = i;
+    }
+    for( magma_int_t s=warpsize+1; s>0; s-- ){
+        size_ptr[s] = size_ptr[s-1];
+    }
+    size_ptr[0] = 0;
+    num_large = n - size_ptr[warpsize+1];
+
+    // batches: first row of every batch in rows, batches never mix sizes
+    CHECK( magma_index_malloc_cpu( &batch_ptr, n/ISAI_BATCH + warpsize + 2 ) );
+    for( magma_int_t s=1; s<=warpsize; s++ ){
+        for( magma_int_t k=size_ptr[s]; k<size_ptr[s+1]; k+=ISAI_BATCH ){
+            batch_ptr[ num_batches++ ] = k;
+        }
+    }
+
+    CHECK( magma_zmalloc_cpu( &work, num_threads * ISAI_BATCH * (warpsize+1) * warpsize ) );
+    if( num_large > 0 ){
+        CHECK( magma_zmalloc_cpu( &dense, num_threads * maxlarge * (maxlarge+1) ) );
+    }
+
+    #pragma omp parallel
+    {
+        magma_int_t id = 0;
+        #ifdef _OPENMP
+        id = omp_get_thread_num();
+        #endif
+        magmaDoubleComplex *T = work + id * ISAI_BATCH * (warpsize+1) * warpsize;
+        magma_index_t p[ ISAI_BATCH ];
+
+        #pragma omp for schedule(dynamic)
+        for( magma_int_t q=0; q<num_batches; q++ ){
+            magma_int_t k = batch_ptr[q];
+            magma_int_t r0 = rows[k];
+            magma_int_t s = M->row[r0+1] - M->row[r0];
+            magma_int_t count = min( (magma_int_t) ISAI_BATCH,
+                                     size_ptr[s+1] - k );
+            magmaDoubleComplex *x = T + ISAI_BATCH * s * s;
+            for( magma_int_t e=0; e<ISAI_BATCH*s*s; e++ ){
+                T[e] = MAGMA_Z_ZERO;
+            }
+            for( int b=0; b<ISAI_BATCH; b++ ){
+                if( b < count ){
+                    p[b] = magma_zisai_gather( transtype, L, M, rows[k+b],
+                                               s*ISAI_BATCH, ISAI_BATCH, T+b );
+                } else {
+                    // padding lanes solve the identity
+                    p[b] = -1;
+                    for( magma_int_t i=0; i<s; i++ ){
+                        T[ (i*s+i)*ISAI_BATCH+b ] = MAGMA_Z_ONE;
+                    }
+                }
+            }
+            magma_zisai_trsv_batch( s, lower, diagtype, T, p, x );
+            for( magma_int_t b=0; b<count; b++ ){
+                magma_int_t r = rows[k+b];
+                for( magma_int_t i=0; i<s; i++ ){
+                    M->val[ M->row[r]+i ] = x[ i*ISAI_BATCH+b ];
+                }
+            }
+        }
+
+        // rows with large patterns: one dense column-major trsv each
+        if( num_large > 0 ){
+            magmaDoubleComplex *D = dense + id * maxlarge * (maxlarge+1);
+            magma_int_t ione = 1;
+            #pragma omp for schedule(dynamic)
+            for( magma_int_t k=size_ptr[warpsize+1]; k<n; k++ ){
+                magma_int_t r = rows[k];
+                magma_int_t s = M->row[r+1] - M->row[r];
+                magmaDoubleComplex *x = D + s * s;
+                for( magma_int_t e=0; e<s*s; e++ ){
+                    D[e] = MAGMA_Z_ZERO;
+                }
+                magma_int_t pr = magma_zisai_gather( transtype, L, M, r, 1, s, D );
+                for( magma_int_t i=0; i<s; i++ ){
+                    x[i] = ( i == pr ) ? MAGMA_Z_ONE : MAGMA_Z_ZERO;
+                }
+                blasf77_ztrsv( lower ? "L" : "U", "N",
+                               lapack_diag_const(diagtype),
+                               &s, D, &s, x, &ione );
+                for( magma_int_t i=0; i<s; i++ ){
+                    M->val[ M->row[r]+i ] = x[i];
+                }
+            }
+        }
+    }
+
+cleanup:
+    magma_free_cpu( size_ptr );
+    magma_free_cpu( rows );
+    magma_free_cpu( batch_ptr );
+    magma_free_cpu( work );
+    magma_free_cpu( dense );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes on the host the sparsity pattern of L^k, the usual pattern for
+    an ISAI of higher accuracy. The rows of S are sorted, the values are one.
+
+    Arguments
+    ---------
+
+    @param[in]
+    L           magma_z_matrix
+                matrix in CSR on the host
+
+    @param[in]
+    k           magma_int_t
+                power, values below 2 give the pattern of L
+
+    @param[out]
+    S           magma_z_matrix*
+                pattern of L^k in CSR on the host
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zisai_pattern_cpu(
+    magma_z_matrix L,
+    magma_int_t k,
+    magma_z_matrix *S,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix P={Magma_CSR}, Q={Magma_CSR};
+
+    CHECK( magma_zmtransfer( L, &P, Magma_CPU, Magma_CPU, queue ) );
+
+    for( magma_int_t z=1; z<k; z++ ){
+        // Q = pattern( P * L ): row i of Q is the union of the rows of L
+        // selected by row i of P; count first, then fill
+        Q.num_rows = P.num_rows;
+        Q.num_cols = P.num_cols;
+        Q.memory_location = Magma_CPU;
+        Q.storage_type = Magma_CSR;
+        Q.ownership = MagmaTrue;
+        CHECK( magma_index_malloc_cpu( &Q.row, P.num_rows+1 ) );
+        for( magma_int_t pass=0; pass<2; pass++ ){
+            #pragma omp parallel
+            {
+                std::vector<magma_index_t> cols;
+                #pragma omp for schedule(dynamic,64)
+                for( magma_int_t i=0; i<P.num_rows; i++ ){
+                    cols.clear();
+                    for( magma_int_t j=P.row[i]; j<P.row[i+1]; j++ ){
+                        magma_int_t c = P.col[j];
+                        cols.insert( cols.end(), L.col + L.row[c],
+                                                 L.col + L.row[c+1] );
+                    }
+                    std::sort( cols.begin(), cols.end() );
+                    magma_int_t len = std::unique( cols.begin(), cols.end() )
+                                                            - cols.begin();
+                    if( pass == 0 ){
+                        Q.row[i+1] = len;
+                    } else {
+                        for( magma_int_t l=0; l<len; l++ ){
+                            Q.col[ Q.row[i]+l ] = cols[l];
+                            Q.val[ Q.row[i]+l ] = MAGMA_Z_ONE;
+                        }
+                    }
+                }
+            }
+            if( pass == 0 ){
+                Q.row[0] = 0;
+                for( magma_int_t i=0; i<Q.num_rows; i++ ){
+                    Q.row[i+1] += Q.row[i];
+                }
+                Q.nnz = Q.row[Q.num_rows];
+                Q.true_nnz = Q.nnz;
+                CHECK( magma_index_malloc_cpu( &Q.col, Q.nnz ) );
+                CHECK( magma_zmalloc_cpu( &Q.val, Q.nnz ) );
+            }
+        }
+        magma_zmfree( &P, queue );
+        P = Q;
+        Q.val = NULL;
+        Q.col = NULL;
+        Q.row = NULL;
+    }
+
+    #pragma omp parallel for
+    for( magma_int_t j=0; j<P.nnz; j++ ){
+        P.val[j] = MAGMA_Z_ONE;
+    }
+    *S = P;
+    P.val = NULL;
+    P.col = NULL;
+    P.row = NULL;
+
+cleanup:
+    magma_zmfree( &P, queue );
+    magma_zmfree( &Q, queue );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Generates on the host the ISAI of a triangular factor for the pattern
+    of S^k, usually with S = L, see magma_zisai_pattern_cpu and
+    magma_zisai_generator_cpu.
+
+    Arguments
+    ---------
+
+    @param[in]
+    uplotype    magma_uplo_t
+                lower or upper triangular
+
+    @param[in]
+    L           magma_z_matrix
+                triangular factor in CSR on the host, sorted rows
+
+    @param[in]
+    S           magma_z_matrix
+                pattern in CSR on the host, with the triangular structure
+                of L
+
+    @param[in]
+    k           magma_int_t
+                pattern power
+
+    @param[out]
+    ISAI        magma_z_matrix*
+                ISAI of L in CSR on the host
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zisaisetup_cpu(
+    magma_uplo_t uplotype,
+    magma_z_matrix L,
+    magma_z_matrix S,
+    magma_int_t k,
+    magma_z_matrix *ISAI,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix P={Magma_CSR}, MT={Magma_CSR};
+
+    CHECK( magma_zisai_pattern_cpu( S, k, &P, queue ) );
+    // the ISAI is generated in transpose fashion
+    CHECK( magma_zmtranspose( P, &MT, queue ) );
+    CHECK( magma_zisai_generator_cpu( uplotype, MagmaNoTrans, MagmaNonUnit,
+                                      L, &MT, queue ) );
+    CHECK( magma_zmtranspose( MT, ISAI, queue ) );
+
+cleanup:
+    magma_zmfree( &P, queue );
+    magma_zmfree( &MT, queue );
+    return info;
+}
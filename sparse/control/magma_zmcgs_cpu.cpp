@@ -0,0 +1,405 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/*
+    Host multicolor Gauss-Seidel / SSOR.
+
+    The matrix is reordered with magma_zmreorder_multicolor and stored
+    color-blocked in precond->M: the rows of every color are contiguous and
+    the diagonal is kept separately as its inverse in precond->color_dinv.
+    Rows of the same color are not coupled, so every color is relaxed in
+    parallel; a sweep visits the colors in ascending order (Magma_GS) or in
+    ascending and then descending order (Magma_SSOR). precond->omega is the
+    relaxation weight (SOR for omega != 1).
+*/
+
+
+// one relaxation sweep over all colors on the permuted vectors
+static void
+magma_zmcgs_sweep(
+    magma_z_preconditioner *precond,
+    const magmaDoubleComplex *bp,
+    magmaDoubleComplex *xp,
+    magma_int_t forward )
+{
+    const magma_index_t *row = precond->M.row;
+    const magma_index_t *col = precond->M.col;
+    const magmaDoubleComplex *val = precond->M.val;
+    const magmaDoubleComplex *dinv = precond->color_dinv;
+    const magma_index_t *color_ptr = precond->color_ptr;
+    magma_int_t num_colors = precond->num_colors;
+    magmaDoubleComplex omega = MAGMA_Z_MAKE( precond->omega, 0.0 );
+
+    #pragma omp parallel
+    for( magma_int_t k=0; k<num_colors; k++ ){
+        magma_int_t c = forward ? k : num_colors-1-k;
+        #pragma omp for schedule(static)
+        for( magma_int_t i=color_ptr[c]; i<color_ptr[c+1]; i++ ){
+            magmaDoubleComplex s = bp[i];
+            for( magma_int_t j=row[i]; j<row[i+1]; j++ ){
+                s = s - val[j] * xp[ col[j] ];
+            }
+            xp[i] = xp[i] + omega * ( s * dinv[i] - xp[i] );
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Prepares the host multicolor Gauss-Seidel / SSOR preconditioner for
+    precond->solver = Magma_GS or Magma_SSOR: colors A, stores it
+    color-blocked without diagonal in precond->M and the inverse diagonal in
+    precond->color_dinv.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmcgssetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, hACSR={Magma_CSR}, M={Magma_CSR};
+    magma_int_t n, num_zero = 0;
+
+    CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmconvert( hA, &hACSR, hA.storage_type, Magma_CSR, queue ));
+    n = hACSR.num_rows;
+
+    magma_free_cpu( precond->color_ptr );
+    magma_free_cpu( precond->color_perm );
+    magma_free_cpu( precond->color_dinv );
+    magma_free_cpu( precond->color_work );
+    precond->color_ptr = NULL;
+    precond->color_perm = NULL;
+    precond->color_dinv = NULL;
+    precond->color_work = NULL;
+    if( precond->omega <= 0.0 || precond->omega >= 2.0 ){
+        precond->omega = 1.0;
+    }
+
+    CHECK( magma_zmreorder_multicolor( hACSR, &precond->num_colors,
+                    &precond->color_ptr, &precond->color_perm, queue ));
+    CHECK( magma_zmpermute( precond->color_perm, &hACSR, queue ));
+
+    // split off the diagonal
+    M.storage_type = Magma_CSR;
+    M.memory_location = Magma_CPU;
+    M.ownership = MagmaTrue;
+    M.num_rows = n;
+    M.num_cols = n;
+    CHECK( magma_index_malloc_cpu( &M.row, n+1 ));
+    CHECK( magma_zmalloc_cpu( &precond->color_dinv, n+1 ));
+    CHECK( magma_zmalloc_cpu( &precond->color_work, 2*n+1 ));
+    M.row[0] = 0;
+    #pragma omp parallel for reduction(+:num_zero)
+    for( magma_int_t i=0; i<n; i++ ){
+        magmaDoubleComplex d = MAGMA_Z_ZERO;
+        magma_int_t nz = 0;
+        for( magma_int_t j=hACSR.row[i]; j<hACSR.row[i+1]; j++ ){
+            if( hACSR.col[j] == i ){
+                d = hACSR.val[j];
+            } else {
+                nz++;
+            }
+        }
+        M.row[i+1] = nz;
+        if( MAGMA_Z_ABS( d ) == 0.0 ){
+            num_zero++;
+            precond->color_dinv[i] = MAGMA_Z_ONE;
+        } else {
+            precond->color_dinv[i] = MAGMA_Z_ONE / d;
+        }
+    }
+    if( num_zero > 0 ){
+        printf("%% warning: %lld zero diagonal elements, using 1.\n",
+               (long long) num_zero );
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        M.row[i+1] += M.row[i];
+    }
+    M.nnz = M.row[n];
+    M.true_nnz = M.nnz;
+    CHECK( magma_index_malloc_cpu( &M.col, M.nnz+1 ));
+    CHECK( magma_zmalloc_cpu( &M.val, M.nnz+1 ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t nz = M.row[i];
+        for( magma_int_t j=hACSR.row[i]; j<hACSR.row[i+1]; j++ ){
+            if( hACSR.col[j] != i ){
+                M.col[nz] = hACSR.col[j];
+                M.val[nz] = hACSR.val[j];
+                nz++;
+            }
+        }
+    }
+    magma_zmfree( &precond->M, queue );
+    precond->M = M;
+    M.row = NULL;
+    M.col = NULL;
+    M.val = NULL;
+
+    // host work vectors for staging device vectors
+    magma_zmfree( &precond->work1, queue );
+    magma_zmfree( &precond->work2, queue );
+    CHECK( magma_zvinit( &precond->work1, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+    CHECK( magma_zvinit( &precond->work2, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hACSR, queue );
+    magma_zmfree( &M, queue );
+    return info;
+}
+
+
+// sweeps on A x = b; with transpose, Magma_GS visits the colors in
+// descending order, see magma_zapplymcgs_transpose_cpu
+static magma_int_t
+magma_zmcgs_sweeps(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_int_t sweeps,
+    magma_int_t zero_init,
+    magma_int_t transpose,
+    double *res,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_int_t n = b.num_rows;
+    const magmaDoubleComplex *hb = b.val;
+    magmaDoubleComplex *hx = x->val;
+    magmaDoubleComplex *bp = precond->color_work;
+    magmaDoubleComplex *xp = precond->color_work + n;
+    const magma_index_t *perm = precond->color_perm;
+
+    if( precond->color_perm == NULL ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if( b.memory_location != Magma_CPU ){
+        magma_zgetvector( n, b.dval, 1, precond->work1.val, 1, queue );
+        hb = precond->work1.val;
+        hx = precond->work2.val;
+        if( ! zero_init ){
+            magma_zgetvector( n, x->dval, 1, precond->work2.val, 1, queue );
+        }
+    }
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        bp[i] = hb[ perm[i] ];
+        xp[i] = zero_init ? MAGMA_Z_ZERO : hx[ perm[i] ];
+    }
+
+    for( magma_int_t k=0; k<sweeps; k++ ){
+        if( precond->solver == Magma_SSOR ){
+            magma_zmcgs_sweep( precond, bp, xp, 1 );
+            magma_zmcgs_sweep( precond, bp, xp, 0 );
+        } else {
+            magma_zmcgs_sweep( precond, bp, xp, ! transpose );
+        }
+    }
+
+    if( res != NULL ){
+        const magma_index_t *row = precond->M.row;
+        const magma_index_t *col = precond->M.col;
+        const magmaDoubleComplex *val = precond->M.val;
+        const magmaDoubleComplex *dinv = precond->color_dinv;
+        double nrm = 0.0;
+        #pragma omp parallel for reduction(+:nrm)
+        for( magma_int_t i=0; i<n; i++ ){
+            magmaDoubleComplex r = bp[i] - xp[i] / dinv[i];
+            for( magma_int_t j=row[i]; j<row[i+1]; j++ ){
+                r = r - val[j] * xp[ col[j] ];
+            }
+            nrm += MAGMA_Z_REAL( r * MAGMA_Z_CONJ( r ) );
+        }
+        *res = sqrt( nrm );
+    }
+
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        hx[ perm[i] ] = xp[i];
+    }
+    if( b.memory_location != Magma_CPU ){
+        magma_zsetvector( n, precond->work2.val, 1, x->dval, 1, queue );
+    }
+
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Performs sweeps of the host multicolor Gauss-Seidel / SSOR iteration
+    prepared by magma_zmcgssetup_cpu on A x = b. Vectors on the device are
+    staged through the host work vectors of the preconditioner.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation
+
+    @param[in]
+    sweeps      magma_int_t
+                number of sweeps
+
+    @param[in]
+    zero_init   magma_int_t
+                if nonzero, the initial guess is 0 and x is not read
+
+    @param[out]
+    res         double*
+                if not NULL, returns the residual norm ||b - A x|| after
+                the sweeps
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmcgs_sweeps_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_int_t sweeps,
+    magma_int_t zero_init,
+    double *res,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return magma_zmcgs_sweeps( b, x, sweeps, zero_init, 0, res, precond, queue );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Applies the host multicolor Gauss-Seidel / SSOR preconditioner:
+    precond->maxiter sweeps (at least one) starting from x = 0.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[out]
+    x           magma_z_matrix*
+                preconditioned vector
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplymcgs_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return magma_zmcgs_sweeps( b, x, max( precond->maxiter, 1 ), 1, 0, NULL,
+                               precond, queue );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Applies the transpose of the host multicolor Gauss-Seidel / SSOR
+    preconditioner, for A = A^T: the Magma_GS sweeps visit the colors in
+    descending order, the backward Gauss-Seidel iteration with A^T. The
+    Magma_SSOR preconditioner is symmetric and applied as is.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[out]
+    x           magma_z_matrix*
+                preconditioned vector
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplymcgs_transpose_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return magma_zmcgs_sweeps( b, x, max( precond->maxiter, 1 ), 1, 1, NULL,
+                               precond, queue );
+}
@@ -206,6 +206,10 @@ magma_zmconvert(
     B->rowidx = NULL;
     B->list = NULL;
     B->blockinfo = NULL;
+    B->val_low = NULL;
+    B->col_low = NULL;
+    B->col_base = NULL;
+    B->storage_precision = Magma_DCOMPLEX;
     B->diag = NULL;
     B->dval = NULL;
     B->dcol = NULL;
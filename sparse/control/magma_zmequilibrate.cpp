@@ -0,0 +1,347 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// default number of Ruiz sweeps
+#define EQUIL_RUIZ_ITERS 10
+// Ruiz stops once all row and column max-norms are within this of 1
+#define EQUIL_RUIZ_TOL 1e-2
+
+
+/*
+    Host equilibration of sparse matrices.
+
+    magma_zmequilibrate computes diagonal scalings Dr, Dc and replaces A in
+    place by Dr A Dc. A x = b is then solved as (Dr A Dc) y = Dr b with
+    x = Dc y; magma_zmequilibrate_vector applies Dr to b and Dc to y in place.
+    All passes over the matrix are parallel over the rows; column norms are
+    accumulated with an array reduction, so no transpose is built.
+        Magma_UNITDIAG  Dr = Dc = |diag(A)|^(-1/2)
+        Magma_MAXNORM   Dr = 1 / row max-norms of A, then
+                        Dc = 1 / column max-norms of Dr A (as LAPACK zgeequ)
+        Magma_RUIZ      iterative scaling by the square roots of the row and
+                        column max-norms (Ruiz); every sweep scales A and
+                        computes the norms of the result in one pass
+*/
+
+
+// row max-norms r and column max-norms c of Dr A Dc, A scaled in place if
+// sr / sc are given
+static void
+magma_zmequilibrate_sweep(
+    magma_z_matrix *A,
+    const double *sr,
+    const double *sc,
+    double *r,
+    double *c )
+{
+    magma_int_t m = A->num_rows, n = A->num_cols;
+    magma_index_t *row = A->row, *col = A->col;
+    magmaDoubleComplex *val = A->val;
+
+    for( magma_int_t j=0; j<n; j++ ){
+        c[j] = 0.0;
+    }
+    #pragma omp parallel for schedule(dynamic,256) reduction(max:c[:n])
+    for( magma_int_t i=0; i<m; i++ ){
+        double rmax = 0.0;
+        double s = ( sr != NULL ) ? sr[i] : 1.0;
+        for( magma_int_t k=row[i]; k<row[i+1]; k++ ){
+            if( sr != NULL || sc != NULL ){
+                double t = s * ( ( sc != NULL ) ? sc[ col[k] ] : 1.0 );
+                val[k] = val[k] * MAGMA_Z_MAKE( t, 0.0 );
+            }
+            double a = MAGMA_Z_ABS( val[k] );
+            rmax = max( rmax, a );
+            c[ col[k] ] = max( c[ col[k] ], a );
+        }
+        if( r != NULL ){
+            r[i] = rmax;
+        }
+    }
+}
+
+
+// 1/sqrt(x) (root) or 1/x, 1 for empty rows / columns
+static inline double
+magma_zmequilibrate_inv( double x, magma_int_t root )
+{
+    if( x == 0.0 ){
+        return 1.0;
+    }
+    return root ? 1.0 / sqrt( x ) : 1.0 / x;
+}
+
+
+// makes v a host vector of length n, reusing its memory if possible
+static magma_int_t
+magma_zmequilibrate_vinit(
+    magma_z_matrix *v,
+    magma_int_t n,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    if( v->val == NULL || v->memory_location != Magma_CPU ||
+        v->num_rows != n || v->num_cols != 1 ){
+        magma_zmfree( v, queue );
+        CHECK( magma_zvinit( v, Magma_CPU, n, 1, MAGMA_Z_ONE, queue ));
+    }
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Equilibrates a sparse matrix in place: computes diagonal scaling
+    matrices Dr (rows) and Dc (columns) and overwrites A with Dr A Dc.
+    The solution x of A x = b is obtained from the solution y of the
+    equilibrated system (Dr A Dc) y = Dr b as x = Dc y, see
+    magma_zmequilibrate_vector.
+
+    Matrices in CSR or CSRCOO on the host are scaled without conversion,
+    all other matrices are converted on the host and back.
+
+    Arguments
+    ---------
+
+    @param[in]
+    scaling     magma_scale_t
+                Magma_UNITDIAG: symmetric scaling to unit diagonal
+                Magma_MAXNORM:  row and column max-norm scaling
+                Magma_RUIZ:     iterative Ruiz row and column scaling
+
+    @param[in]
+    maxiter     magma_int_t
+                maximum number of sweeps for Magma_RUIZ, default if <= 0
+
+    @param[in,out]
+    A           magma_z_matrix*
+                input matrix, on output Dr A Dc
+
+    @param[in,out]
+    dr          magma_z_matrix*
+                row scaling factors (host vector); reused if it already has
+                the right size
+
+    @param[in,out]
+    dc          magma_z_matrix*
+                column scaling factors (host vector); reused if it already
+                has the right size
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmequilibrate(
+    magma_scale_t scaling,
+    magma_int_t maxiter,
+    magma_z_matrix *A,
+    magma_z_matrix *dr,
+    magma_z_matrix *dc,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+    double *r = NULL, *c = NULL, *sc = NULL;
+    magma_int_t m = A->num_rows, n = A->num_cols;
+
+    if( A->memory_location != Magma_CPU ||
+        ( A->storage_type != Magma_CSR && A->storage_type != Magma_CSRCOO )){
+        magma_storage_t A_storage = A->storage_type;
+        magma_location_t A_location = A->memory_location;
+        CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+
+        CHECK( magma_zmequilibrate( scaling, maxiter, &CSRA, dr, dc, queue ));
+
+        magma_zmfree( &hA, queue );
+        magma_zmfree( A, queue );
+        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSR, A_storage, queue ));
+        CHECK( magma_zmtransfer( hA, A, Magma_CPU, A_location, queue ));
+        goto cleanup;
+    }
+
+    // the values are rewritten, drop the reduced-precision copy
+    magma_zmlowprec_free( A, queue );
+    CHECK( magma_zmequilibrate_vinit( dr, m, queue ));
+    CHECK( magma_zmequilibrate_vinit( dc, n, queue ));
+    CHECK( magma_dmalloc_cpu( &r, m+1 ));
+    CHECK( magma_dmalloc_cpu( &c, n+1 ));
+
+    if( scaling == Magma_UNITDIAG ){
+        magma_int_t num_zero = 0;
+        if( m != n ){
+            printf("%% error: symmetric scaling of non-square matrix.\n");
+            info = MAGMA_ERR_NOT_SUPPORTED;
+            goto cleanup;
+        }
+        #pragma omp parallel for reduction(+:num_zero)
+        for( magma_int_t i=0; i<m; i++ ){
+            double d = 0.0;
+            for( magma_int_t k=A->row[i]; k<A->row[i+1]; k++ ){
+                if( A->col[k] == i ){
+                    d = MAGMA_Z_ABS( A->val[k] );
+                }
+            }
+            if( d == 0.0 ){
+                num_zero++;
+            }
+            r[i] = magma_zmequilibrate_inv( d, 1 );
+            dr->val[i] = MAGMA_Z_MAKE( r[i], 0.0 );
+            dc->val[i] = dr->val[i];
+        }
+        if( num_zero > 0 ){
+            printf("%% warning: %lld zero diagonal elements, not scaled.\n",
+                   (long long) num_zero );
+        }
+        magma_zmequilibrate_sweep( A, r, r, NULL, c );
+    }
+    else if( scaling == Magma_MAXNORM ){
+        CHECK( magma_dmalloc_cpu( &sc, n+1 ));
+        // row norms, then the column norms of the row-scaled matrix
+        magma_zmequilibrate_sweep( A, NULL, NULL, r, c );
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<m; i++ ){
+            r[i] = magma_zmequilibrate_inv( r[i], 0 );
+            dr->val[i] = MAGMA_Z_MAKE( r[i], 0.0 );
+        }
+        magma_zmequilibrate_sweep( A, r, NULL, NULL, sc );
+        #pragma omp parallel for
+        for( magma_int_t j=0; j<n; j++ ){
+            sc[j] = magma_zmequilibrate_inv( sc[j], 0 );
+            dc->val[j] = MAGMA_Z_MAKE( sc[j], 0.0 );
+        }
+        magma_zmequilibrate_sweep( A, NULL, sc, NULL, c );
+    }
+    else if( scaling == Magma_RUIZ ){
+        CHECK( magma_dmalloc_cpu( &sc, n+1 ));
+        maxiter = ( maxiter > 0 ) ? maxiter : EQUIL_RUIZ_ITERS;
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<m; i++ ){
+            dr->val[i] = MAGMA_Z_ONE;
+        }
+        #pragma omp parallel for
+        for( magma_int_t j=0; j<n; j++ ){
+            dc->val[j] = MAGMA_Z_ONE;
+        }
+        magma_zmequilibrate_sweep( A, NULL, NULL, r, c );
+        for( magma_int_t iter=0; iter<maxiter; iter++ ){
+            double dev = 0.0;
+            #pragma omp parallel for reduction(max:dev)
+            for( magma_int_t i=0; i<m; i++ ){
+                if( r[i] > 0.0 ){
+                    dev = max( dev, fabs( 1.0 - r[i] ));
+                }
+            }
+            #pragma omp parallel for reduction(max:dev)
+            for( magma_int_t j=0; j<n; j++ ){
+                if( c[j] > 0.0 ){
+                    dev = max( dev, fabs( 1.0 - c[j] ));
+                }
+            }
+            if( dev <= EQUIL_RUIZ_TOL ){
+                break;
+            }
+            #pragma omp parallel for
+            for( magma_int_t i=0; i<m; i++ ){
+                r[i] = magma_zmequilibrate_inv( r[i], 1 );
+                dr->val[i] = dr->val[i] * MAGMA_Z_MAKE( r[i], 0.0 );
+            }
+            #pragma omp parallel for
+            for( magma_int_t j=0; j<n; j++ ){
+                sc[j] = magma_zmequilibrate_inv( c[j], 1 );
+                dc->val[j] = dc->val[j] * MAGMA_Z_MAKE( sc[j], 0.0 );
+            }
+            // scales A and computes the norms for the next sweep
+            magma_zmequilibrate_sweep( A, r, sc, r, c );
+        }
+    }
+    else {
+        printf( "%%error: scaling %d not supported.\n", scaling );
+        info = MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+cleanup:
+    magma_free_cpu( r );
+    magma_free_cpu( c );
+    magma_free_cpu( sc );
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Scales a (block) vector in place by a diagonal matrix: x = D x.
+    Used with the factors of magma_zmequilibrate to scale the right-hand
+    side (b = Dr b) and to recover the solution (x = Dc y). d and x have to
+    be located in the same memory; the factors can be moved to the device
+    once and reused for all vectors.
+
+    Arguments
+    ---------
+
+    @param[in]
+    d           magma_z_matrix
+                diagonal of D
+
+    @param[in,out]
+    x           magma_z_matrix*
+                vector(s) to scale
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmequilibrate_vector(
+    magma_z_matrix d,
+    magma_z_matrix *x,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_int_t n = x->num_rows;
+
+    if( d.num_rows != n || d.memory_location != x->memory_location ){
+        printf("%% error: scaling factors and vector do not match.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if( x->memory_location == Magma_CPU ){
+        magma_int_t len = n * x->num_cols;
+        #pragma omp parallel for
+        for( magma_int_t k=0; k<len; k++ ){
+            x->val[k] = x->val[k] * d.val[ k % n ];
+        }
+    } else {
+        CHECK( magma_zjacobi_diagscal( n, d, *x, x, queue ));
+    }
+
+cleanup:
+    return info;
+}
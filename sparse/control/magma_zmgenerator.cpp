@@ -67,6 +67,10 @@ magma_zmgenerator(
     B.row = NULL;
     B.rowidx = NULL;
     B.blockinfo = NULL;
+    B.val_low = NULL;
+    B.col_low = NULL;
+    B.col_base = NULL;
+    B.storage_precision = Magma_DCOMPLEX;
     B.diag = NULL;
     B.dval = NULL;
     B.dcol = NULL;
@@ -238,6 +238,432 @@ cleanup:
 
 
 
+/******************************************************************************
+ * Parallel symbolic ILU(k) via level-limited path searches.
+ *
+ * E. Hysom and A. Pothen: "A scalable parallel algorithm for incomplete
+ * factor preconditioning", SIAM J. Sci. Comput. 22(6), 2194-2215 (2001).
+ *
+ * Entry (i,j) is in the ILU(k) pattern iff the graph of A contains a path
+ * i -> h_1 -> ... -> h_m -> j of at most k+1 edges with all h_l < min(i,j)
+ * (fill-path theorem); its level is the length of the shortest such path
+ * minus one. This only depends on A, so every row is searched independently.
+ *
+ * For row i the candidate vertices are visited in increasing order. When
+ * vertex t is reached, all intermediates that may be used for the target t
+ * (vertices < t) have already been released, so the current distance of t
+ * is final and t goes into L. Then t itself is released as intermediate and
+ * the distances are updated through t. The vertices >= i left at the end
+ * form U. The search state lives in a per-thread hash table, so the
+ * workspace is proportional to the fill of one row and not to n.
+ *****************************************************************************/
+
+#define ZILUKROW_HEAP 1
+#define ZILUKROW_WORK 2
+
+typedef struct magma_zilukrow_ws
+{
+    magma_int_t     capacity;   // size of the hash table (power of 2)
+    magma_int_t     size;       // occupied slots
+    magma_index_t   *key;       // vertex stored in slot, -1 for empty
+    magma_index_t   *dist;      // path length from the row vertex
+    magma_index_t   *queued;    // ZILUKROW_HEAP / ZILUKROW_WORK flags
+    magma_index_t   *slots;     // list of occupied slots for fast reset
+    magma_int_t     heap_size;
+    magma_index_t   *heap;      // min-heap of vertices not yet visited
+    magma_int_t     work_size;
+    magma_index_t   *work;      // released vertices to propagate from
+} magma_zilukrow_ws;
+
+
+static void
+magma_zilukrow_ws_free( magma_zilukrow_ws *ws )
+{
+    magma_free_cpu( ws->key );
+    magma_free_cpu( ws->dist );
+    magma_free_cpu( ws->queued );
+    magma_free_cpu( ws->slots );
+    magma_free_cpu( ws->heap );
+    magma_free_cpu( ws->work );
+    ws->key = ws->dist = ws->queued = ws->slots = ws->heap = ws->work = NULL;
+}
+
+
+static magma_int_t
+magma_zilukrow_ws_alloc( magma_zilukrow_ws *ws, magma_int_t capacity )
+{
+    magma_int_t info = 0;
+    ws->capacity = capacity;
+    ws->size = 0;
+    ws->key = ws->dist = ws->queued = ws->slots = ws->heap = ws->work = NULL;
+    ws->heap_size = 0;
+    ws->work_size = 0;
+    CHECK( magma_index_malloc_cpu( &ws->key, capacity ));
+    CHECK( magma_index_malloc_cpu( &ws->dist, capacity ));
+    CHECK( magma_index_malloc_cpu( &ws->queued, capacity ));
+    CHECK( magma_index_malloc_cpu( &ws->slots, capacity ));
+    CHECK( magma_index_malloc_cpu( &ws->heap, capacity ));
+    CHECK( magma_index_malloc_cpu( &ws->work, capacity ));
+    for (magma_int_t s=0; s < capacity; s++) {
+        ws->key[s] = -1;
+    }
+cleanup:
+    if (info != 0) {
+        magma_zilukrow_ws_free( ws );
+    }
+    return info;
+}
+
+
+static inline magma_int_t
+magma_zilukrow_hash( magma_index_t v, magma_int_t capacity )
+{
+    return ( (magma_int_t) ( (unsigned int) v * 2654435761u ) ) & ( capacity-1 );
+}
+
+
+// returns the slot of vertex v, inserting it with infinite distance if absent
+static magma_int_t
+magma_zilukrow_slot( magma_zilukrow_ws *ws, magma_index_t v, magma_index_t inf, 
+                     magma_int_t *info )
+{
+    magma_int_t s;
+    
+    if ( 2*(ws->size+1) > ws->capacity ) {
+        // grow: rehash into a table of twice the size
+        magma_zilukrow_ws old = *ws;
+        if ( magma_zilukrow_ws_alloc( ws, 2*old.capacity ) != 0 ) {
+            *ws = old;
+            *info = MAGMA_ERR_HOST_ALLOC;
+            return -1;
+        }
+        for (magma_int_t l=0; l < old.size; l++) {
+            magma_int_t os = old.slots[l];
+            s = magma_zilukrow_hash( old.key[os], ws->capacity );
+            while (ws->key[s] != -1) {
+                s = (s+1) & (ws->capacity-1);
+            }
+            ws->key[s] = old.key[os];
+            ws->dist[s] = old.dist[os];
+            ws->queued[s] = old.queued[os];
+            ws->slots[ws->size++] = s;
+        }
+        for (magma_int_t l=0; l < old.heap_size; l++) {
+            ws->heap[l] = old.heap[l];
+        }
+        ws->heap_size = old.heap_size;
+        for (magma_int_t l=0; l < old.work_size; l++) {
+            ws->work[l] = old.work[l];
+        }
+        ws->work_size = old.work_size;
+        magma_zilukrow_ws_free( &old );
+    }
+    
+    s = magma_zilukrow_hash( v, ws->capacity );
+    while (ws->key[s] != -1 && ws->key[s] != v) {
+        s = (s+1) & (ws->capacity-1);
+    }
+    if (ws->key[s] == -1) {
+        ws->key[s] = v;
+        ws->dist[s] = inf;
+        ws->queued[s] = 0;
+        ws->slots[ws->size++] = s;
+    }
+    return s;
+}
+
+
+// slot of a vertex known to be in the table
+static magma_int_t
+magma_zilukrow_find( magma_zilukrow_ws *ws, magma_index_t v )
+{
+    magma_int_t s = magma_zilukrow_hash( v, ws->capacity );
+    while (ws->key[s] != v) {
+        s = (s+1) & (ws->capacity-1);
+    }
+    return s;
+}
+
+
+// every vertex is at most once on the heap and at most once on the work
+// list, so neither holds more entries than the hash table
+static void
+magma_zilukrow_heap_push( magma_zilukrow_ws *ws, magma_index_t v )
+{
+    magma_int_t c = ws->heap_size++;
+    while (c > 0) {
+        magma_int_t p = (c-1)/2;
+        if (ws->heap[p] <= v) {
+            break;
+        }
+        ws->heap[c] = ws->heap[p];
+        c = p;
+    }
+    ws->heap[c] = v;
+}
+
+
+static magma_index_t
+magma_zilukrow_heap_pop( magma_zilukrow_ws *ws )
+{
+    magma_index_t top = ws->heap[0];
+    magma_index_t v = ws->heap[--ws->heap_size];
+    magma_int_t p = 0;
+    while (2*p+1 < ws->heap_size) {
+        magma_int_t c = 2*p+1;
+        if (c+1 < ws->heap_size && ws->heap[c+1] < ws->heap[c]) {
+            c++;
+        }
+        if (v <= ws->heap[c]) {
+            break;
+        }
+        ws->heap[p] = ws->heap[c];
+        p = c;
+    }
+    ws->heap[p] = v;
+    return top;
+}
+
+
+// relax vertex v to distance d; t is the last visited vertex of row i
+static void
+magma_zilukrow_relax(
+    magma_zilukrow_ws *ws, magma_index_t v, magma_index_t d,
+    magma_index_t i, magma_index_t t, magma_index_t inf, magma_int_t *info )
+{
+    magma_int_t s = magma_zilukrow_slot( ws, v, inf, info );
+    if (s < 0 || d >= ws->dist[s]) {
+        return;
+    }
+    ws->dist[s] = d;
+    if (v <= t && v < i) {
+        // already released as intermediate: propagate the improvement
+        if ((ws->queued[s] & ZILUKROW_WORK) == 0) {
+            ws->queued[s] |= ZILUKROW_WORK;
+            ws->work[ws->work_size++] = v;
+        }
+    } else if ((ws->queued[s] & ZILUKROW_HEAP) == 0) {
+        ws->queued[s] |= ZILUKROW_HEAP;
+        magma_zilukrow_heap_push( ws, v );
+    }
+}
+
+
+// symbolic ILU(k) of row i; counts the entries or writes them if jl, ju != NULL
+static magma_int_t
+magma_zilukrow(
+    magma_zilukrow_ws *ws,
+    const magma_int_t levfill,
+    const magma_index_t i,
+    const magma_index_t *ia,
+    const magma_index_t *ja,
+    magma_int_t *nl,
+    magma_int_t *nu,
+    magma_index_t *jl,
+    magma_index_t *ju )
+{
+    magma_int_t info = 0;
+    const magma_index_t inf = levfill+2;    // paths may have levfill+1 edges
+    magma_index_t t = -1;
+    magma_int_t kl = 0, ku = 0;
+    
+    // reset the table
+    for (magma_int_t l=0; l < ws->size; l++) {
+        ws->key[ws->slots[l]] = -1;
+    }
+    ws->size = 0;
+    ws->heap_size = 0;
+    ws->work_size = 0;
+    
+    for (magma_index_t p=ia[i]; p < ia[i+1]; p++) {
+        magma_zilukrow_relax( ws, ja[p], 1, i, t, inf, &info );
+    }
+    
+    while (ws->heap_size > 0 && ws->heap[0] < i && info == 0) {
+        t = magma_zilukrow_heap_pop( ws );
+        if (jl != NULL) {
+            jl[kl] = t;
+        }
+        kl++;
+        // release t as intermediate and propagate
+        ws->queued[magma_zilukrow_find( ws, t )] |= ZILUKROW_WORK;
+        ws->work[ws->work_size++] = t;
+        while (ws->work_size > 0 && info == 0) {
+            magma_index_t h = ws->work[--ws->work_size];
+            magma_int_t sh = magma_zilukrow_find( ws, h );
+            magma_index_t dh = ws->dist[sh];
+            ws->queued[sh] &= ~ZILUKROW_WORK;
+            if (dh > levfill) {
+                continue;
+            }
+            for (magma_index_t p=ia[h]; p < ia[h+1]; p++) {
+                magma_zilukrow_relax( ws, ja[p], dh+1, i, t, inf, &info );
+            }
+        }
+    }
+    
+    while (ws->heap_size > 0) {
+        magma_index_t v = magma_zilukrow_heap_pop( ws );
+        if (ju != NULL) {
+            ju[ku] = v;
+        }
+        ku++;
+    }
+    
+    *nl = kl;
+    *nu = ku;
+    return info;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Multithreaded symbolic ILU(k) factorization. Computes the same L and U
+    structure as magma_zsymbolic_ilu (L strictly lower, U upper including the
+    diagonal, both sorted), but every row is handled by an independent
+    level-limited path search in the graph of A. A first parallel pass counts
+    the exact fill of every row, a second parallel pass writes the column
+    indices, so no storage estimate is needed.
+
+    Arguments
+    ---------
+
+    @param[in]
+    levfill     magma_int_t
+                level of fill
+
+    @param[in]
+    n           magma_int_t
+                order of the matrix
+
+    @param[out]
+    nzl         magma_int_t*
+                number of nonzeros in L
+
+    @param[out]
+    nzu         magma_int_t*
+                number of nonzeros in U
+
+    @param[in]
+    ia          const magma_index_t*
+                row pointer of A
+
+    @param[in]
+    ja          const magma_index_t*
+                column indices of A
+
+    @param[out]
+    ial         magma_index_t*
+                row pointer of L, size n+1, allocated by the caller
+
+    @param[out]
+    jal         magma_index_t**
+                column indices of L, allocated here
+
+    @param[out]
+    iau         magma_index_t*
+                row pointer of U, size n+1, allocated by the caller
+
+    @param[out]
+    jau         magma_index_t**
+                column indices of U, allocated here
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zsymbolic_ilu_mt(
+    const magma_int_t levfill,
+    const magma_int_t n,
+    magma_int_t *nzl,
+    magma_int_t *nzu,
+    const magma_index_t *ia,
+    const magma_index_t *ja,
+    magma_index_t *ial,
+    magma_index_t **jal,
+    magma_index_t *iau,
+    magma_index_t **jau,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t max_nnz_row = 0;
+    
+    *jal = NULL;
+    *jau = NULL;
+    
+    #pragma omp parallel for reduction(max:max_nnz_row)
+    for (magma_int_t i=0; i < n; i++) {
+        max_nnz_row = max( max_nnz_row, (magma_int_t) (ia[i+1]-ia[i]) );
+    }
+    
+    // pass 1: count, pass 2: fill
+    for (magma_int_t pass=0; pass < 2 && info == 0; pass++) {
+        if (pass == 1) {
+            ial[0] = 0;
+            iau[0] = 0;
+            CHECK( magma_zmatrix_createrowptr( n, ial, queue ));
+            CHECK( magma_zmatrix_createrowptr( n, iau, queue ));
+            *nzl = ial[n];
+            *nzu = iau[n];
+            CHECK( magma_index_malloc_cpu( jal, max( *nzl, 1 ) ));
+            CHECK( magma_index_malloc_cpu( jau, max( *nzu, 1 ) ));
+        }
+        #pragma omp parallel
+        {
+            magma_zilukrow_ws ws;
+            magma_int_t loc_info = 0;
+            magma_int_t capacity = 64;
+            while (capacity < 4*(max_nnz_row+1)) {
+                capacity *= 2;
+            }
+            loc_info = magma_zilukrow_ws_alloc( &ws, capacity );
+            
+            #pragma omp for schedule(dynamic, 64)
+            for (magma_int_t i=0; i < n; i++) {
+                magma_int_t nl, nu;
+                if (loc_info != 0) {
+                    continue;
+                }
+                if (pass == 0) {
+                    loc_info = magma_zilukrow( &ws, levfill, i, ia, ja,
+                                               &nl, &nu, NULL, NULL );
+                    ial[i+1] = nl;
+                    iau[i+1] = nu;
+                } else {
+                    loc_info = magma_zilukrow( &ws, levfill, i, ia, ja, &nl, &nu,
+                                               *jal + ial[i], *jau + iau[i] );
+                }
+            }
+            
+            if (loc_info != 0) {
+                #pragma omp critical
+                info = loc_info;
+            }
+            if (ws.key != NULL) {
+                magma_zilukrow_ws_free( &ws );
+            }
+        }
+    }
+    
+cleanup:
+    if (info != 0) {
+        magma_free_cpu( *jal );
+        magma_free_cpu( *jau );
+        *jal = NULL;
+        *jau = NULL;
+    }
+    return info;
+}
+
+
+
 /******************************************************************************
  *
  * MEX function
@@ -276,7 +702,9 @@ void magma_zmexFunction(magma_int_t nlhs, magma_int_t n, magmaDoubleComplex omeg
     -------
 
     This routine performs a symbolic ILU factorization.
-    The algorithm is taken from an implementation written by Edmond Chow.
+    The structure is computed in parallel by magma_zsymbolic_ilu_mt, the
+    serial reference implementation magma_zsymbolic_ilu is taken from an 
+    implementation written by Edmond Chow.
 
     Arguments
     ---------
@@ -334,16 +762,16 @@ magma_zsymbilu(
         CHECK( magma_zmconvert( B, L, Magma_CSR, Magma_CSR , queue));
         CHECK( magma_zmconvert( B, U, Magma_CSR, Magma_CSR, queue ));
 
-        magma_int_t num_lnnz = (levels > 0 ) ? B.nnz/2*(2*levels+50) : B.nnz;
-        magma_int_t num_unnz = (levels > 0 ) ? B.nnz/2*(2*levels+50) : B.nnz;
+        magma_int_t num_lnnz = 0;
+        magma_int_t num_unnz = 0;
 
         magma_free_cpu( L->col );
         magma_free_cpu( U->col );
-        CHECK( magma_index_malloc_cpu( &L->col, num_lnnz ));
-        CHECK( magma_index_malloc_cpu( &U->col, num_unnz ));
+        L->col = NULL;
+        U->col = NULL;
 
-        magma_zsymbolic_ilu( levels, A->num_rows, &num_lnnz, &num_unnz, B.row, B.col,
-                                            L->row, L->col, U->row, U->col );
+        CHECK( magma_zsymbolic_ilu_mt( levels, A->num_rows, &num_lnnz, &num_unnz, 
+                    B.row, B.col, L->row, &L->col, U->row, &U->col, queue ));
         L->nnz = num_lnnz;
         U->nnz = num_unnz;
         magma_free_cpu( L->val );
@@ -0,0 +1,365 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include <string.h>
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define COMPLEX
+
+// rows per block sharing one base for the 16-bit column offsets
+#define LOWPREC_ROWS 32
+// largest column offset representable in 16 bits
+#define LOWPREC_SPAN 65535
+
+#ifdef COMPLEX
+    #define LOWPREC_COMPONENTS 2
+#else
+    #define LOWPREC_COMPONENTS 1
+#endif
+
+
+/*
+    Reduced-precision host storage for CSR matrices.
+
+    magma_zmlowprec_cpu adds a second copy of a CPU CSR matrix that is only
+    read by the host SpMV (and the host trisolves for ILU factors): the
+    values in single precision or bfloat16, and the column indices as 16-bit
+    offsets to a per-block base for blocks of LOWPREC_ROWS rows whose column
+    span fits (other blocks keep the 32-bit indices). The arithmetic is done
+    in working precision. SpMV on the host is bandwidth bound, so going from
+    8+4 to 4+2 bytes per nonzero (real double) roughly doubles its speed.
+
+    The working precision arrays are kept, all other routines use them.
+*/
+
+
+// bfloat16: the upper half of an IEEE single, rounded to nearest even
+static inline unsigned short
+magma_zfloat2bf16( float f )
+{
+    unsigned int u;
+    memcpy( &u, &f, sizeof(u) );
+    if( ( u & 0x7fffffff ) > 0x7f800000 ){
+        return (unsigned short) ( ( u >> 16 ) | 0x40 );    // quiet NaN
+    }
+    u += 0x7fff + ( ( u >> 16 ) & 1 );
+    return (unsigned short) ( u >> 16 );
+}
+
+
+static inline float
+magma_zbf162float( unsigned short h )
+{
+    unsigned int u = (unsigned int) h << 16;
+    float f;
+    memcpy( &f, &u, sizeof(f) );
+    return f;
+}
+
+
+// value j of values stored in precision P, in working precision
+// (Magma_DCOMPLEX: the working precision itself)
+template< magma_precision P >
+static inline magmaDoubleComplex
+magma_zlowprec_val( const void *v, magma_int_t j );
+
+template<>
+inline magmaDoubleComplex
+magma_zlowprec_val< Magma_DCOMPLEX >( const void *v, magma_int_t j )
+{
+    return ((const magmaDoubleComplex*) v)[j];
+}
+
+template<>
+inline magmaDoubleComplex
+magma_zlowprec_val< Magma_FLOAT >( const void *v, magma_int_t j )
+{
+    const float *sv = (const float*) v;
+    #ifdef COMPLEX
+    return MAGMA_Z_MAKE( (double) sv[2*j], (double) sv[2*j+1] );
+    #else
+    return (double) sv[j];
+    #endif
+}
+
+template<>
+inline magmaDoubleComplex
+magma_zlowprec_val< Magma_BFLOAT16 >( const void *v, magma_int_t j )
+{
+    const unsigned short *hv = (const unsigned short*) v;
+    #ifdef COMPLEX
+    return MAGMA_Z_MAKE( (double) magma_zbf162float( hv[2*j] ),
+                         (double) magma_zbf162float( hv[2*j+1] ));
+    #else
+    return (double) magma_zbf162float( hv[j] );
+    #endif
+}
+
+
+// y = alpha * A * x + beta * y from the reduced-precision copy
+template< magma_precision P >
+static void
+magma_zspmv_lowprec_kernel(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    const void *v,
+    const magmaDoubleComplex *x,
+    magmaDoubleComplex beta,
+    magmaDoubleComplex *y )
+{
+    magma_int_t num_blocks = magma_ceildiv( A.num_rows, LOWPREC_ROWS );
+    magma_int_t beta_zero = ( MAGMA_Z_EQUAL( beta, MAGMA_Z_ZERO ) );
+
+    #pragma omp parallel for schedule(dynamic,4)
+    for( magma_int_t b=0; b<num_blocks; b++ ){
+        magma_int_t end = min( (b+1)*LOWPREC_ROWS, A.num_rows );
+        magma_index_t base = A.col_base[b];
+        for( magma_int_t i=b*LOWPREC_ROWS; i<end; i++ ){
+            magmaDoubleComplex s = MAGMA_Z_ZERO;
+            if( base >= 0 ){
+                const magmaDoubleComplex *xb = x + base;
+                for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+                    s = s + magma_zlowprec_val<P>( v, j ) * xb[ A.col_low[j] ];
+                }
+            } else {
+                for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+                    s = s + magma_zlowprec_val<P>( v, j ) * x[ A.col[j] ];
+                }
+            }
+            y[i] = beta_zero ? alpha * s : alpha * s + beta * y[i];
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Releases the reduced-precision copy of a CPU matrix created by
+    magma_zmlowprec_cpu.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    A           magma_z_matrix*
+                matrix
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmlowprec_free(
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_free_cpu( A->val_low );
+    magma_free_cpu( A->col_low );
+    magma_free_cpu( A->col_base );
+    A->val_low = NULL;
+    A->col_low = NULL;
+    A->col_base = NULL;
+    A->storage_precision = Magma_DCOMPLEX;
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Sets the storage precision of the host SpMV of a CPU CSR matrix: creates
+    a copy of the values in single precision (Magma_FLOAT / Magma_FCOMPLEX)
+    or bfloat16 (Magma_BFLOAT16) and of the column indices as 16-bit offsets
+    within row blocks where the column span allows. Magma_DOUBLE /
+    Magma_DCOMPLEX keeps the values in working precision and only compresses
+    the column indices. magma_z_spmv and the host trisolves use the copy
+    once it exists; it is released by magma_zmfree.
+
+    Arguments
+    ---------
+
+    @param[in]
+    precision   magma_precision
+                storage precision of the values
+
+    @param[in,out]
+    A           magma_z_matrix*
+                CSR (CSRL/CSRU/CSRD) matrix on the CPU
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmlowprec_cpu(
+    magma_precision precision,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_int_t num_blocks, nnz = A->nnz;
+    float *sval = NULL;
+    unsigned short *hval = NULL;
+
+    if( A->memory_location != Magma_CPU ||
+        ( A->storage_type != Magma_CSR  && A->storage_type != Magma_CSRL &&
+          A->storage_type != Magma_CSRU && A->storage_type != Magma_CSRD )){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    CHECK( magma_zmlowprec_free( A, queue ));
+
+    // 16-bit column offsets for blocks with a narrow column span
+    num_blocks = magma_ceildiv( A->num_rows, LOWPREC_ROWS );
+    CHECK( magma_index_malloc_cpu( &A->col_base, num_blocks+1 ));
+    CHECK( magma_malloc_cpu( (void**) &A->col_low, (nnz+1) * sizeof(unsigned short) ));
+    #pragma omp parallel for schedule(dynamic,16)
+    for( magma_int_t b=0; b<num_blocks; b++ ){
+        magma_int_t start = A->row[ b*LOWPREC_ROWS ];
+        magma_int_t end = A->row[ min( (b+1)*LOWPREC_ROWS, A->num_rows ) ];
+        magma_index_t lo = A->num_cols, hi = 0;
+        for( magma_int_t j=start; j<end; j++ ){
+            lo = min( lo, A->col[j] );
+            hi = max( hi, A->col[j] );
+        }
+        if( start == end ){
+            lo = 0;
+            hi = 0;
+        }
+        if( hi - lo <= LOWPREC_SPAN ){
+            A->col_base[b] = lo;
+            for( magma_int_t j=start; j<end; j++ ){
+                A->col_low[j] = (unsigned short) ( A->col[j] - lo );
+            }
+        } else {
+            A->col_base[b] = -1;
+        }
+    }
+
+    if( precision == Magma_FLOAT || precision == Magma_FCOMPLEX ){
+        CHECK( magma_smalloc_cpu( &sval, (nnz+1) * LOWPREC_COMPONENTS ));
+        #pragma omp parallel for
+        for( magma_int_t j=0; j<nnz; j++ ){
+            sval[ LOWPREC_COMPONENTS*j ] = (float) MAGMA_Z_REAL( A->val[j] );
+            #ifdef COMPLEX
+            sval[ LOWPREC_COMPONENTS*j+1 ] = (float) MAGMA_Z_IMAG( A->val[j] );
+            #endif
+        }
+        A->val_low = sval;
+        sval = NULL;
+    } else if( precision == Magma_BFLOAT16 ){
+        CHECK( magma_malloc_cpu( (void**) &hval,
+                    (nnz+1) * LOWPREC_COMPONENTS * sizeof(unsigned short) ));
+        #pragma omp parallel for
+        for( magma_int_t j=0; j<nnz; j++ ){
+            hval[ LOWPREC_COMPONENTS*j ] =
+                        magma_zfloat2bf16( (float) MAGMA_Z_REAL( A->val[j] ));
+            #ifdef COMPLEX
+            hval[ LOWPREC_COMPONENTS*j+1 ] =
+                        magma_zfloat2bf16( (float) MAGMA_Z_IMAG( A->val[j] ));
+            #endif
+        }
+        A->val_low = hval;
+        hval = NULL;
+    } else {
+        precision = Magma_DCOMPLEX;
+    }
+    A->storage_precision = precision;
+
+cleanup:
+    if( info != 0 && info != MAGMA_ERR_NOT_SUPPORTED ){
+        magma_zmlowprec_free( A, queue );
+    }
+    magma_free_cpu( sval );
+    magma_free_cpu( hval );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes y = alpha * A * x + beta * y on the CPU from the reduced-precision
+    copy of A created by magma_zmlowprec_cpu, accumulating in working
+    precision.
+
+    Arguments
+    ---------
+
+    @param[in]
+    alpha       magmaDoubleComplex
+                scalar alpha
+
+    @param[in]
+    A           magma_z_matrix
+                CSR matrix on the CPU with reduced-precision copy
+
+    @param[in]
+    x           magma_z_matrix
+                input vector x on the CPU
+
+    @param[in]
+    beta        magmaDoubleComplex
+                scalar beta
+
+    @param[in,out]
+    y           magma_z_matrix
+                output vector y on the CPU
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zspmv_lowprec_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix x,
+    magmaDoubleComplex beta,
+    magma_z_matrix y,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    if( A.col_base == NULL || A.num_cols != x.num_rows ||
+        x.memory_location != Magma_CPU || y.memory_location != Magma_CPU ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if( A.storage_precision == Magma_FLOAT || A.storage_precision == Magma_FCOMPLEX ){
+        magma_zspmv_lowprec_kernel<Magma_FLOAT>( alpha, A, A.val_low,
+                                    x.val, beta, y.val );
+    } else if( A.storage_precision == Magma_BFLOAT16 ){
+        magma_zspmv_lowprec_kernel<Magma_BFLOAT16>( alpha, A, A.val_low,
+                                    x.val, beta, y.val );
+    } else {
+        magma_zspmv_lowprec_kernel<Magma_DCOMPLEX>( alpha, A, A.val,
+                                    x.val, beta, y.val );
+    }
+
+cleanup:
+    return info;
+}
@@ -0,0 +1,980 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include <algorithm>
+#include <new>
+#include <set>
+#include <utility>
+#include <vector>
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+    Reorderings for sparse matrices.
+
+    All permutations use the convention perm[ new ] = old, i.e. the permuted
+    matrix is B( i, j ) = A( perm[i], perm[j] ) and the permuted vector is
+    y[ i ] = x[ perm[i] ]. The orderings are computed on the symmetrized
+    pattern of A + A^T without the diagonal.
+*/
+
+
+// symmetric adjacency graph of the CPU CSR matrix A: pattern of A + A^T
+// without diagonal, every row sorted and free of duplicates
+static magma_int_t
+magma_zmreorder_graph(
+    magma_z_matrix A,
+    magma_index_t **gptr,
+    magma_index_t **gidx,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = A.num_rows;
+    magma_index_t *ptr = NULL, *idx = NULL, *fill = NULL, *len = NULL;
+
+    CHECK( magma_index_malloc_cpu( &ptr, n+1 ));
+    CHECK( magma_index_malloc_cpu( &fill, n+1 ));
+    CHECK( magma_index_malloc_cpu( &len, n+1 ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n+1; i++ ){
+        fill[i] = 0;
+    }
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            magma_index_t c = A.col[j];
+            if( c != i ){
+                #pragma omp atomic
+                fill[i+1]++;
+                #pragma omp atomic
+                fill[c+1]++;
+            }
+        }
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        fill[i+1] += fill[i];
+    }
+    CHECK( magma_index_malloc_cpu( &idx, fill[n]+1 ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n+1; i++ ){
+        ptr[i] = fill[i];
+    }
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            magma_index_t c = A.col[j], pi, pc;
+            if( c != i ){
+                #pragma omp atomic capture
+                pi = fill[i]++;
+                #pragma omp atomic capture
+                pc = fill[c]++;
+                idx[pi] = c;
+                idx[pc] = i;
+            }
+        }
+    }
+    // sort and remove duplicates, then compact
+    #pragma omp parallel for schedule(dynamic,256)
+    for( magma_int_t i=0; i<n; i++ ){
+        std::sort( idx+ptr[i], idx+ptr[i+1] );
+        len[i] = std::unique( idx+ptr[i], idx+ptr[i+1] ) - (idx+ptr[i]);
+    }
+    {
+        magma_index_t nz = 0;
+        for( magma_int_t i=0; i<n; i++ ){
+            magma_index_t start = ptr[i];
+            ptr[i] = nz;
+            for( magma_int_t j=0; j<len[i]; j++ ){
+                idx[nz+j] = idx[start+j];
+            }
+            nz += len[i];
+        }
+        ptr[n] = nz;
+    }
+    *gptr = ptr;
+    *gidx = idx;
+    ptr = NULL;
+    idx = NULL;
+
+cleanup:
+    magma_free_cpu( ptr );
+    magma_free_cpu( idx );
+    magma_free_cpu( fill );
+    magma_free_cpu( len );
+    return info;
+}
+
+
+// provides the CPU CSR version of A in B, copying only if necessary; the
+// copies are held in hA and hACSR
+static magma_int_t
+magma_zmreorder_hostcsr(
+    magma_z_matrix A,
+    magma_z_matrix *hA,
+    magma_z_matrix *hACSR,
+    magma_z_matrix *B,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    if( A.memory_location == Magma_CPU && A.storage_type == Magma_CSR ){
+        *B = A;
+    } else {
+        CHECK( magma_zmtransfer( A, hA, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( *hA, hACSR, hA->storage_type, Magma_CSR, queue ));
+        *B = *hACSR;
+    }
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes a reverse Cuthill-McKee ordering reducing the bandwidth of A.
+    Every connected component starts at a pseudo-peripheral node. The
+    level sets are expanded in parallel; the children of each node are
+    sorted by degree, giving the same ordering as the serial algorithm.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                square input matrix
+
+    @param[out]
+    perm        magma_index_t**
+                permutation, perm[ new ] = old, allocated on the CPU
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmreorder_rcm(
+    magma_z_matrix A,
+    magma_index_t **perm,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, hACSR={Magma_CSR}, B={Magma_CSR};
+    magma_index_t *gptr = NULL, *gidx = NULL, *order = NULL, *pos = NULL;
+    magma_index_t *owner = NULL, *parent = NULL, *cnt = NULL, *level = NULL;
+    magma_int_t n, numbered = 0;
+
+    *perm = NULL;
+    if( A.num_rows != A.num_cols ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    CHECK( magma_zmreorder_hostcsr( A, &hA, &hACSR, &B, queue ));
+    n = B.num_rows;
+    CHECK( magma_zmreorder_graph( B, &gptr, &gidx, queue ));
+
+    CHECK( magma_index_malloc_cpu( &order, n+1 ));
+    CHECK( magma_index_malloc_cpu( &pos, n+1 ));
+    CHECK( magma_index_malloc_cpu( &owner, n+1 ));
+    CHECK( magma_index_malloc_cpu( &parent, n+1 ));
+    CHECK( magma_index_malloc_cpu( &cnt, n+2 ));
+    CHECK( magma_index_malloc_cpu( &level, n+1 ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        pos[i] = -1;
+        level[i] = -1;
+    }
+
+    for( magma_int_t s=0; s<n; s++ ){
+        if( pos[s] != -1 ){
+            continue;
+        }
+        // pseudo-peripheral node (George-Liu): BFS from the current root,
+        // restart from a minimum degree node of the last level as long as
+        // the eccentricity grows
+        magma_index_t root = s, ecc = -1;
+        for( magma_int_t sweep=0; sweep<8; sweep++ ){
+            magma_index_t head = numbered, tail = numbered, lev = 0;
+            order[tail++] = root;
+            level[root] = 0;
+            while( head < tail ){
+                magma_index_t v = order[head++];
+                lev = level[v];
+                for( magma_int_t j=gptr[v]; j<gptr[v+1]; j++ ){
+                    magma_index_t u = gidx[j];
+                    if( level[u] == -1 ){
+                        level[u] = level[v] + 1;
+                        order[tail++] = u;
+                    }
+                }
+            }
+            magma_index_t cand = root;
+            for( magma_int_t k=tail-1; k>=numbered && level[order[k]] == lev; k-- ){
+                magma_index_t u = order[k];
+                if( cand == root || gptr[u+1]-gptr[u] < gptr[cand+1]-gptr[cand] ){
+                    cand = u;
+                }
+            }
+            for( magma_int_t k=numbered; k<tail; k++ ){
+                level[ order[k] ] = -1;
+            }
+            if( lev <= ecc ){
+                break;
+            }
+            ecc = lev;
+            root = cand;
+        }
+
+        // Cuthill-McKee from root, one level set at a time
+        magma_index_t lb = numbered, le = numbered+1;
+        order[numbered] = root;
+        pos[root] = numbered;
+        numbered++;
+        while( lb < le ){
+            // any frontier node claims each unnumbered neighbor, the claim
+            // owner then determines the first frontier node adjacent to it
+            #pragma omp parallel for schedule(dynamic,64)
+            for( magma_int_t k=lb; k<le; k++ ){
+                magma_index_t v = order[k];
+                for( magma_int_t j=gptr[v]; j<gptr[v+1]; j++ ){
+                    magma_index_t u = gidx[j];
+                    if( pos[u] == -1 ){
+                        #pragma omp atomic write
+                        owner[u] = k;
+                    }
+                }
+            }
+            #pragma omp parallel for schedule(dynamic,64)
+            for( magma_int_t k=lb; k<le; k++ ){
+                magma_index_t v = order[k];
+                for( magma_int_t j=gptr[v]; j<gptr[v+1]; j++ ){
+                    magma_index_t u = gidx[j];
+                    if( pos[u] == -1 && owner[u] == k ){
+                        magma_index_t p = k;
+                        for( magma_int_t l=gptr[u]; l<gptr[u+1]; l++ ){
+                            magma_index_t w = pos[ gidx[l] ];
+                            if( w >= lb && w < p ){
+                                p = w;
+                            }
+                        }
+                        parent[u] = p;
+                    }
+                }
+            }
+            #pragma omp parallel for schedule(dynamic,64)
+            for( magma_int_t k=lb; k<le; k++ ){
+                magma_index_t v = order[k], c = 0;
+                for( magma_int_t j=gptr[v]; j<gptr[v+1]; j++ ){
+                    magma_index_t u = gidx[j];
+                    if( pos[u] == -1 && parent[u] == k ){
+                        c++;
+                    }
+                }
+                cnt[k-lb+1] = c;
+            }
+            cnt[0] = 0;
+            for( magma_int_t k=0; k<le-lb; k++ ){
+                cnt[k+1] += cnt[k];
+            }
+            #pragma omp parallel for schedule(dynamic,64)
+            for( magma_int_t k=lb; k<le; k++ ){
+                magma_index_t v = order[k], c = le + cnt[k-lb];
+                for( magma_int_t j=gptr[v]; j<gptr[v+1]; j++ ){
+                    magma_index_t u = gidx[j];
+                    if( pos[u] == -1 && parent[u] == k ){
+                        order[c++] = u;
+                    }
+                }
+                std::sort( order + le + cnt[k-lb], order + c,
+                    [gptr]( magma_index_t a, magma_index_t b ){
+                        magma_index_t da = gptr[a+1]-gptr[a], db = gptr[b+1]-gptr[b];
+                        return da < db || ( da == db && a < b );
+                    });
+            }
+            magma_index_t next = le + cnt[le-lb];
+            #pragma omp parallel for
+            for( magma_int_t k=le; k<next; k++ ){
+                pos[ order[k] ] = k;
+            }
+            numbered = next;
+            lb = le;
+            le = next;
+        }
+    }
+
+    // reverse
+    CHECK( magma_index_malloc_cpu( perm, n+1 ));
+    #pragma omp parallel for
+    for( magma_int_t k=0; k<n; k++ ){
+        (*perm)[k] = order[n-1-k];
+    }
+
+cleanup:
+    magma_free_cpu( gptr );
+    magma_free_cpu( gidx );
+    magma_free_cpu( order );
+    magma_free_cpu( pos );
+    magma_free_cpu( owner );
+    magma_free_cpu( parent );
+    magma_free_cpu( cnt );
+    magma_free_cpu( level );
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hACSR, queue );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes a fill-reducing approximate minimum degree ordering of A.
+    The elimination is carried out on the quotient graph: eliminated nodes
+    become elements, elements adjacent to the pivot are absorbed, and the
+    degree of every node adjacent to the new element is replaced by the
+    upper bound
+        min( n - k, d_old + |Lp|, |Ai| + |Lp| + sum_e |Le| )
+    as in the AMD algorithm. Supervariable detection and aggressive
+    absorption are not performed.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                square input matrix
+
+    @param[out]
+    perm        magma_index_t**
+                permutation, perm[ new ] = old, allocated on the CPU
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmreorder_amd(
+    magma_z_matrix A,
+    magma_index_t **perm,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, hACSR={Magma_CSR}, B={Magma_CSR};
+    magma_index_t *gptr = NULL, *gidx = NULL;
+    magma_int_t n;
+
+    *perm = NULL;
+    if( A.num_rows != A.num_cols ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    CHECK( magma_zmreorder_hostcsr( A, &hA, &hACSR, &B, queue ));
+    n = B.num_rows;
+    CHECK( magma_zmreorder_graph( B, &gptr, &gidx, queue ));
+    CHECK( magma_index_malloc_cpu( perm, n+1 ));
+
+    try {
+        // variable adjacency, element adjacency and element member lists
+        std::vector< std::vector<magma_index_t> > adjv( n ), adje( n ), elem( n );
+        std::vector<magma_index_t> deg( n ), mark( n, -1 );
+        std::vector<char> eliminated( n, 0 );
+        std::set< std::pair<magma_index_t, magma_index_t> > queue_deg;
+
+        for( magma_int_t i=0; i<n; i++ ){
+            adjv[i].assign( gidx+gptr[i], gidx+gptr[i+1] );
+            deg[i] = gptr[i+1] - gptr[i];
+            queue_deg.insert( std::make_pair( deg[i], (magma_index_t) i ));
+        }
+
+        for( magma_int_t k=0; k<n; k++ ){
+            magma_index_t p = queue_deg.begin()->second;
+            queue_deg.erase( queue_deg.begin() );
+            (*perm)[k] = p;
+            eliminated[p] = 1;
+            mark[p] = p;
+
+            // new element Lp: variable neighbors of p plus the members of
+            // all elements adjacent to p, which are absorbed
+            std::vector<magma_index_t> &lp = elem[p];
+            for( magma_index_t v : adjv[p] ){
+                if( !eliminated[v] && mark[v] != p ){
+                    mark[v] = p;
+                    lp.push_back( v );
+                }
+            }
+            for( magma_index_t e : adje[p] ){
+                for( magma_index_t v : elem[e] ){
+                    if( !eliminated[v] && mark[v] != p ){
+                        mark[v] = p;
+                        lp.push_back( v );
+                    }
+                }
+                std::vector<magma_index_t>().swap( elem[e] );
+            }
+            std::vector<magma_index_t>().swap( adjv[p] );
+            std::vector<magma_index_t>().swap( adje[p] );
+
+            magma_index_t lsize = lp.size();
+            for( magma_index_t i : lp ){
+                // element lists: drop absorbed elements, add p
+                std::vector<magma_index_t> &ei = adje[i];
+                magma_index_t m = 0, ext = 0;
+                for( magma_index_t e : ei ){
+                    if( !elem[e].empty() && e != p ){
+                        ei[m++] = e;
+                        ext += elem[e].size() - 1;
+                    }
+                }
+                ei.resize( m );
+                ei.push_back( p );
+                // variable lists: drop eliminated nodes and nodes of Lp,
+                // they are now represented by the element p
+                std::vector<magma_index_t> &vi = adjv[i];
+                m = 0;
+                for( magma_index_t v : vi ){
+                    if( !eliminated[v] && mark[v] != p ){
+                        vi[m++] = v;
+                    }
+                }
+                vi.resize( m );
+                magma_index_t d = min( (magma_index_t) (n - k - 1),
+                                  min( (magma_index_t) (deg[i] + lsize),
+                                       (magma_index_t) (m + lsize - 1 + ext) ));
+                if( d != deg[i] ){
+                    queue_deg.erase( std::make_pair( deg[i], i ));
+                    deg[i] = d;
+                    queue_deg.insert( std::make_pair( deg[i], i ));
+                }
+            }
+        }
+    }
+    catch( std::bad_alloc& ) {
+        info = MAGMA_ERR_HOST_ALLOC;
+    }
+
+cleanup:
+    if( info != 0 ){
+        magma_free_cpu( *perm );
+        *perm = NULL;
+    }
+    magma_free_cpu( gptr );
+    magma_free_cpu( gidx );
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hACSR, queue );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes a multicolor ordering of A: the nodes are colored with a
+    parallel speculative greedy coloring (conflicting nodes are recolored
+    until the coloring is valid) and then grouped by color. Nodes of the
+    same color are not coupled, so they can be relaxed in parallel.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                square input matrix
+
+    @param[out]
+    num_colors  magma_int_t*
+                number of colors
+
+    @param[out]
+    color_ptr   magma_index_t**
+                nodes of color c are perm[ color_ptr[c] : color_ptr[c+1] ),
+                allocated on the CPU
+
+    @param[out]
+    perm        magma_index_t**
+                permutation, perm[ new ] = old, allocated on the CPU
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmreorder_multicolor(
+    magma_z_matrix A,
+    magma_int_t *num_colors,
+    magma_index_t **color_ptr,
+    magma_index_t **perm,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, hACSR={Magma_CSR}, B={Magma_CSR};
+    magma_index_t *gptr = NULL, *gidx = NULL, *color = NULL;
+    magma_index_t *work = NULL, *conflict = NULL, *forbidden = NULL;
+    magma_int_t n, nwork, ncolors = 0, maxdeg = 0, num_threads = 1;
+
+    *color_ptr = NULL;
+    *perm = NULL;
+    if( A.num_rows != A.num_cols ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    CHECK( magma_zmreorder_hostcsr( A, &hA, &hACSR, &B, queue ));
+    n = B.num_rows;
+    CHECK( magma_zmreorder_graph( B, &gptr, &gidx, queue ));
+
+    for( magma_int_t i=0; i<n; i++ ){
+        maxdeg = max( maxdeg, gptr[i+1]-gptr[i] );
+    }
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    CHECK( magma_index_malloc_cpu( &color, n+1 ));
+    CHECK( magma_index_malloc_cpu( &work, n+1 ));
+    CHECK( magma_index_malloc_cpu( &conflict, n+1 ));
+    CHECK( magma_index_malloc_cpu( &forbidden, num_threads * (maxdeg+2) ));
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        color[i] = -1;
+        work[i] = i;
+    }
+    for( magma_int_t i=0; i<num_threads * (maxdeg+2); i++ ){
+        forbidden[i] = -1;
+    }
+
+    nwork = n;
+    while( nwork > 0 ){
+        // speculative coloring: smallest color not used by a neighbor
+        #pragma omp parallel
+        {
+            magma_int_t id = 0;
+            #ifdef _OPENMP
+            id = omp_get_thread_num();
+            #endif
+            magma_index_t *f = forbidden + id * (maxdeg+2);
+            #pragma omp for schedule(dynamic,256)
+            for( magma_int_t k=0; k<nwork; k++ ){
+                magma_index_t v = work[k], c;
+                for( magma_int_t j=gptr[v]; j<gptr[v+1]; j++ ){
+                    #pragma omp atomic read
+                    c = color[ gidx[j] ];
+                    if( c >= 0 && c <= maxdeg ){
+                        f[c] = v;
+                    }
+                }
+                c = 0;
+                while( f[c] == v ){
+                    c++;
+                }
+                #pragma omp atomic write
+                color[v] = c;
+            }
+        }
+        // conflicts: the node with the larger index is recolored
+        #pragma omp parallel for schedule(dynamic,256)
+        for( magma_int_t k=0; k<nwork; k++ ){
+            magma_index_t v = work[k];
+            conflict[k] = 0;
+            for( magma_int_t j=gptr[v]; j<gptr[v+1]; j++ ){
+                magma_index_t u = gidx[j];
+                if( u < v && color[u] == color[v] ){
+                    conflict[k] = 1;
+                    break;
+                }
+            }
+        }
+        magma_int_t m = 0;
+        for( magma_int_t k=0; k<nwork; k++ ){
+            if( conflict[k] ){
+                work[m++] = work[k];
+            }
+        }
+        // reset the forbidden marks, nodes are reused as markers
+        for( magma_int_t i=0; i<num_threads * (maxdeg+2); i++ ){
+            forbidden[i] = -1;
+        }
+        nwork = m;
+    }
+
+    for( magma_int_t i=0; i<n; i++ ){
+        ncolors = max( ncolors, color[i]+1 );
+    }
+    CHECK( magma_index_malloc_cpu( color_ptr, ncolors+1 ));
+    CHECK( magma_index_malloc_cpu( perm, n+1 ));
+    for( magma_int_t c=0; c<ncolors+1; c++ ){
+        (*color_ptr)[c] = 0;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        (*color_ptr)[ color[i]+1 ]++;
+    }
+    for( magma_int_t c=0; c<ncolors; c++ ){
+        (*color_ptr)[c+1] += (*color_ptr)[c];
+    }
+    for( magma_int_t c=0; c<ncolors; c++ ){
+        work[c] = (*color_ptr)[c];
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        (*perm)[ work[ color[i] ]++ ] = i;
+    }
+    *num_colors = ncolors;
+
+cleanup:
+    if( info != 0 ){
+        magma_free_cpu( *color_ptr );
+        magma_free_cpu( *perm );
+        *color_ptr = NULL;
+        *perm = NULL;
+    }
+    magma_free_cpu( gptr );
+    magma_free_cpu( gidx );
+    magma_free_cpu( color );
+    magma_free_cpu( work );
+    magma_free_cpu( conflict );
+    magma_free_cpu( forbidden );
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hACSR, queue );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Applies the symmetric permutation B = P A P^T to A in place, i.e.
+    B( i, j ) = A( perm[i], perm[j] ). The column indices of every row
+    remain sorted. Arrays A does not own (see magma_zcsrset) are
+    overwritten, not freed. Matrices in other formats or on the device are
+    converted and transferred back.
+
+    Arguments
+    ---------
+
+    @param[in]
+    perm        magma_index_t*
+                permutation, perm[ new ] = old
+
+    @param[in,out]
+    A           magma_z_matrix*
+                square matrix to permute
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmpermute(
+    magma_index_t *perm,
+    magma_z_matrix *A,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
+    magma_index_t *iperm = NULL, *row = NULL, *col = NULL;
+    magmaDoubleComplex *val = NULL;
+    magma_int_t n = A->num_rows;
+
+    if( A->num_rows != A->num_cols ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if( A->memory_location == Magma_CPU && A->storage_type == Magma_CSR ){
+        CHECK( magma_index_malloc_cpu( &iperm, n+1 ));
+        CHECK( magma_index_malloc_cpu( &row, n+1 ));
+        CHECK( magma_index_malloc_cpu( &col, A->nnz+1 ));
+        CHECK( magma_zmalloc_cpu( &val, A->nnz+1 ));
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            iperm[ perm[i] ] = i;
+        }
+        row[0] = 0;
+        for( magma_int_t i=0; i<n; i++ ){
+            row[i+1] = row[i] + A->row[ perm[i]+1 ] - A->row[ perm[i] ];
+        }
+        #pragma omp parallel
+        {
+            std::vector< std::pair<magma_index_t, magmaDoubleComplex> > tmp;
+            #pragma omp for schedule(dynamic,256)
+            for( magma_int_t i=0; i<n; i++ ){
+                magma_index_t o = perm[i];
+                tmp.clear();
+                for( magma_int_t j=A->row[o]; j<A->row[o+1]; j++ ){
+                    tmp.push_back( std::make_pair( iperm[ A->col[j] ], A->val[j] ));
+                }
+                std::sort( tmp.begin(), tmp.end(),
+                    []( const std::pair<magma_index_t, magmaDoubleComplex> &a,
+                        const std::pair<magma_index_t, magmaDoubleComplex> &b ){
+                        return a.first < b.first;
+                    });
+                for( magma_int_t j=0; j<(magma_int_t) tmp.size(); j++ ){
+                    col[ row[i]+j ] = tmp[j].first;
+                    val[ row[i]+j ] = tmp[j].second;
+                }
+            }
+        }
+        if( A->ownership ){
+            magma_free_cpu( A->row );
+            magma_free_cpu( A->col );
+            magma_free_cpu( A->val );
+            A->row = row;
+            A->col = col;
+            A->val = val;
+            row = NULL;
+            col = NULL;
+            val = NULL;
+        }
+        else {
+            // the arrays belong to the caller: overwrite them
+            memcpy( A->row, row, (n+1) * sizeof(magma_index_t) );
+            memcpy( A->col, col, A->nnz * sizeof(magma_index_t) );
+            memcpy( A->val, val, A->nnz * sizeof(magmaDoubleComplex) );
+        }
+    }
+    else {
+        magma_storage_t A_storage = A->storage_type;
+        magma_location_t A_location = A->memory_location;
+        CHECK( magma_zmtransfer( *A, &hA, A->memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+
+        CHECK( magma_zmpermute( perm, &CSRA, queue ));
+
+        magma_zmfree( &hA, queue );
+        magma_zmfree( A, queue );
+        CHECK( magma_zmconvert( CSRA, &hA, Magma_CSR, A_storage, queue ));
+        CHECK( magma_zmtransfer( hA, A, Magma_CPU, A_location, queue ));
+    }
+
+cleanup:
+    magma_free_cpu( iperm );
+    magma_free_cpu( row );
+    magma_free_cpu( col );
+    magma_free_cpu( val );
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    return info;
+}
+
+
+// y[ i ] = x[ perm[i] ] (forward) or y[ perm[i] ] = x[ i ] (backward),
+// applied to every column of x
+static magma_int_t
+magma_zvpermute_dir(
+    magma_index_t *perm,
+    magma_z_matrix *x,
+    magma_int_t forward,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magmaDoubleComplex *hx = NULL, *tmp = NULL;
+    magma_int_t n = x->num_rows, ncols = x->num_cols;
+    magma_int_t rs, cs;
+
+    if( x->major == MagmaRowMajor ){
+        rs = ncols;
+        cs = 1;
+    } else {
+        rs = 1;
+        cs = n;
+    }
+    CHECK( magma_zmalloc_cpu( &tmp, n*ncols+1 ));
+    if( x->memory_location == Magma_CPU ){
+        hx = x->val;
+    } else {
+        CHECK( magma_zmalloc_cpu( &hx, n*ncols+1 ));
+        magma_zgetvector( n*ncols, x->dval, 1, hx, 1, queue );
+    }
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t c=0; c<ncols; c++ ){
+            if( forward ){
+                tmp[ i*rs + c*cs ] = hx[ perm[i]*rs + c*cs ];
+            } else {
+                tmp[ perm[i]*rs + c*cs ] = hx[ i*rs + c*cs ];
+            }
+        }
+    }
+    if( x->memory_location == Magma_CPU && x->ownership ){
+        magma_free_cpu( x->val );
+        x->val = tmp;
+        tmp = NULL;
+    } else if( x->memory_location == Magma_CPU ){
+        // the values belong to the caller: overwrite them
+        memcpy( x->val, tmp, n*ncols * sizeof(magmaDoubleComplex) );
+    } else {
+        magma_zsetvector( n*ncols, tmp, 1, x->dval, 1, queue );
+    }
+
+cleanup:
+    if( x->memory_location != Magma_CPU ){
+        magma_free_cpu( hx );
+    }
+    magma_free_cpu( tmp );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Permutes a vector in place: x_new[ i ] = x[ perm[i] ].
+
+    Arguments
+    ---------
+
+    @param[in]
+    perm        magma_index_t*
+                permutation, perm[ new ] = old
+
+    @param[in,out]
+    x           magma_z_matrix*
+                vector (CPU or device)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zvpermute(
+    magma_index_t *perm,
+    magma_z_matrix *x,
+    magma_queue_t queue )
+{
+    return magma_zvpermute_dir( perm, x, 1, queue );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Reverts magma_zvpermute in place: x_new[ perm[i] ] = x[ i ].
+
+    Arguments
+    ---------
+
+    @param[in]
+    perm        magma_index_t*
+                permutation, perm[ new ] = old
+
+    @param[in,out]
+    x           magma_z_matrix*
+                vector (CPU or device)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zvunpermute(
+    magma_index_t *perm,
+    magma_z_matrix *x,
+    magma_queue_t queue )
+{
+    return magma_zvpermute_dir( perm, x, 0, queue );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes the requested reordering of A and applies it to A in place.
+    The permutation is returned so right-hand sides and solutions can be
+    permuted with magma_zvpermute / magma_zvunpermute.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    A           magma_z_matrix*
+                square matrix to reorder
+
+    @param[in]
+    reordering  magma_reorder_t
+                Magma_NOREORDER, Magma_RCM, Magma_AMD or Magma_MULTICOLOR
+
+    @param[out]
+    perm        magma_index_t**
+                permutation, perm[ new ] = old, allocated on the CPU;
+                NULL for Magma_NOREORDER
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmreorder(
+    magma_z_matrix *A,
+    magma_reorder_t reordering,
+    magma_index_t **perm,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_index_t *color_ptr = NULL;
+    magma_int_t num_colors = 0;
+
+    *perm = NULL;
+    if( reordering == Magma_NOREORDER ){
+        goto cleanup;
+    }
+    if( A->num_rows != A->num_cols ){
+        printf("%% warning: non-square matrix.\n");
+        printf("%% Fallback: no reordering.\n");
+        goto cleanup;
+    }
+
+    if( reordering == Magma_RCM ){
+        CHECK( magma_zmreorder_rcm( *A, perm, queue ));
+    }
+    else if( reordering == Magma_AMD ){
+        CHECK( magma_zmreorder_amd( *A, perm, queue ));
+    }
+    else if( reordering == Magma_MULTICOLOR ){
+        CHECK( magma_zmreorder_multicolor( *A, &num_colors, &color_ptr, perm, queue ));
+    }
+    else {
+        printf( "%%error: reordering not supported.\n" );
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    CHECK( magma_zmpermute( *perm, A, queue ));
+
+cleanup:
+    if( info != 0 ){
+        magma_free_cpu( *perm );
+        *perm = NULL;
+    }
+    magma_free_cpu( color_ptr );
+    return info;
+}
@@ -11,10 +11,128 @@
 
 */
 #include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define RTOLERANCE     lapackf77_dlamch( "E" )
 #define ATOLERANCE     lapackf77_dlamch( "E" )
 
+// CSR and CSRCOO matrices on the host are scaled in place, all others are
+// converted to CSRCOO on the host first
+#define MSCALE_IN_PLACE( A ) ( (A)->memory_location == Magma_CPU &&    \
+                               ( (A)->storage_type == Magma_CSRCOO ||  \
+                                 (A)->storage_type == Magma_CSR ))
+
+
+// f[i] = 1 / sqrt( sum_j real(a_ij)^2 )
+static void
+magma_zmscale_rownorm(
+    magma_z_matrix *A,
+    magmaDoubleComplex *f )
+{
+    #pragma omp parallel for
+    for( magma_int_t z=0; z<A->num_rows; z++ ) {
+        double s = 0.0;
+        for( magma_int_t k=A->row[z]; k<A->row[z+1]; k++ )
+            s += MAGMA_Z_REAL(A->val[k])*MAGMA_Z_REAL(A->val[k]);
+        f[z] = MAGMA_Z_MAKE( 1.0/sqrt( s ), 0.0 );
+    }
+}
+
+
+// f[j] = 1 / sqrt( sum_i real(a_ij)^2 ), accumulated without transpose
+static magma_int_t
+magma_zmscale_colnorm(
+    magma_z_matrix *A,
+    magmaDoubleComplex *f )
+{
+    magma_int_t info = 0;
+    magma_int_t n = A->num_cols;
+    double *s = NULL;
+
+    CHECK( magma_dmalloc_cpu( &s, n+1 ));
+    for( magma_int_t j=0; j<n; j++ ) {
+        s[j] = 0.0;
+    }
+    #pragma omp parallel for reduction(+:s[:n])
+    for( magma_int_t z=0; z<A->num_rows; z++ ) {
+        for( magma_int_t k=A->row[z]; k<A->row[z+1]; k++ )
+            s[ A->col[k] ] += MAGMA_Z_REAL(A->val[k])*MAGMA_Z_REAL(A->val[k]);
+    }
+    #pragma omp parallel for
+    for( magma_int_t j=0; j<n; j++ ) {
+        f[j] = MAGMA_Z_MAKE( 1.0/sqrt( s[j] ), 0.0 );
+    }
+
+cleanup:
+    magma_free_cpu( s );
+    return info;
+}
+
+
+// f[i] = 1 / sqrt( real(a_ii) ) (root) or 1 / real(a_ii),
+// returns MAGMA_ERR for zero diagonal elements
+static magma_int_t
+magma_zmscale_diag(
+    magma_z_matrix *A,
+    magma_int_t root,
+    magmaDoubleComplex *f )
+{
+    magma_int_t num_zero = 0;
+    #pragma omp parallel for reduction(+:num_zero)
+    for( magma_int_t z=0; z<A->num_rows; z++ ) {
+        magmaDoubleComplex s = MAGMA_Z_ZERO;
+        for( magma_int_t k=A->row[z]; k<A->row[z+1]; k++ ) {
+            if ( A->col[k] == z ) {
+                s = A->val[k];
+            }
+        }
+        if ( MAGMA_Z_EQUAL( s, MAGMA_Z_ZERO ) ) {
+            num_zero++;
+        }
+        f[z] = root ? MAGMA_Z_MAKE( 1.0/sqrt( MAGMA_Z_REAL( s ) ), 0.0 )
+                    : MAGMA_Z_MAKE( 1.0/MAGMA_Z_REAL( s ), 0.0 );
+    }
+    if ( num_zero > 0 ) {
+        printf("%%error: zero diagonal element.\n");
+        return MAGMA_ERR;
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+// A = diag(r) * A * diag(c) in place, r or c may be NULL
+static void
+magma_zmscale_rowcol(
+    magma_z_matrix *A,
+    const magmaDoubleComplex *r,
+    const magmaDoubleComplex *c )
+{
+    #pragma omp parallel for schedule(dynamic,256)
+    for( magma_int_t z=0; z<A->num_rows; z++ ) {
+        magmaDoubleComplex rz = ( r != NULL ) ? r[z] : MAGMA_Z_ONE;
+        for( magma_int_t k=A->row[z]; k<A->row[z+1]; k++ ) {
+            A->val[k] = ( c != NULL ) ? A->val[k] * rz * c[ A->col[k] ]
+                                      : A->val[k] * rz;
+        }
+    }
+}
+
+
+// b = diag(f) * b on the host
+static void
+magma_zmscale_vector(
+    magma_int_t n,
+    const magmaDoubleComplex *f,
+    magmaDoubleComplex *b )
+{
+    #pragma omp parallel for
+    for( magma_int_t i=0; i<n; i++ ) {
+        b[i] = b[i] * f[i];
+    }
+}
+
 
 /**
     Purpose
@@ -31,7 +149,11 @@
 
     @param[in]
     scaling     magma_scale_t
-                scaling type (unit rownorm / unit diagonal)
+                scaling type (unit rownorm / unit diagonal).
+                Magma_MAXNORM and Magma_RUIZ are not supported: they scale
+                rows and columns differently, so the factors are needed to
+                scale b and recover x, see magma_zmequilibrate and
+                magma_zmequilibrate_vector.
 
     @param[in]
     queue       magma_queue_t
@@ -51,6 +173,13 @@ magma_zmscale(
     
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
+    if ( scaling == Magma_MAXNORM || scaling == Magma_RUIZ ) {
+        printf( "%%error: row and column equilibration needs the scaling factors,"
+                " use magma_zmequilibrate and magma_zmequilibrate_vector.\n" );
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
     if( A->num_rows != A->num_cols && scaling != Magma_NOSCALE ){
         printf("%% warning: non-square matrix.\n");
         printf("%% Fallback: no scaling.\n");
@@ -58,51 +187,26 @@ magma_zmscale(
     } 
         
    
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+    if ( MSCALE_IN_PLACE( A ) ) {
+        // the values are rewritten, drop the reduced-precision copy
+        if ( scaling != Magma_NOSCALE ) {
+            magma_zmlowprec_free( A, queue );
+        }
         if ( scaling == Magma_NOSCALE ) {
             // no scale
             ;
         }
-        else if( A->num_rows == A->num_cols ){
-            if ( scaling == Magma_UNITROW ) {
-                // scale to unit rownorm
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                        s+= MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]);
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }        
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->col[z]] * tmp[A->rowidx[z]];
-                }
-            }
-            else if (scaling == Magma_UNITDIAG ) {
-                // scale to unit diagonal
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                        if ( A->col[f]== z ) {
-                            // add some identity matrix
-                            //A->val[f] = A->val[f] +  MAGMA_Z_MAKE( 100000.0, 0.0 );
-                            s = A->val[f];
-                        }
-                    }
-                    if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                        printf("%%error: zero diagonal element.\n");
-                        info = MAGMA_ERR;
-                    }
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->col[z]] * tmp[A->rowidx[z]];
-                }
-            }
-            else {
-                printf( "%%error: scaling not supported.\n" );
-                info = MAGMA_ERR_NOT_SUPPORTED;
-            }
+        else if ( scaling == Magma_UNITROW ) {
+            // scale to unit rownorm
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            magma_zmscale_rownorm( A, tmp );
+            magma_zmscale_rowcol( A, tmp, tmp );
+        }
+        else if ( scaling == Magma_UNITDIAG ) {
+            // scale to unit diagonal
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
+            info = magma_zmscale_diag( A, 1, tmp );
+            magma_zmscale_rowcol( A, tmp, tmp );
         }
         else {
             printf( "%%error: scaling not supported.\n" );
@@ -184,113 +288,46 @@ magma_zmscale_matrix_rhs(
     } 
         
    
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+    if ( MSCALE_IN_PLACE( A ) ) {
+        // the values are rewritten, drop the reduced-precision copy
+        if ( scaling != Magma_NOSCALE ) {
+            magma_zmlowprec_free( A, queue );
+        }
         if ( scaling == Magma_NOSCALE ) {
             // no scale
             ;
         }
-        else if( A->num_rows == A->num_cols ){
+        else if ( scaling == Magma_UNITROW || scaling == Magma_UNITDIAG ) {
+            // scale to unit rownorm / unit diagonal by rows
+            CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
             if ( scaling == Magma_UNITROW ) {
-                // scale to unit rownorm by rows
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                        s+= MAGMA_Z_MAKE( MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]), 0.0 );
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }        
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->rowidx[z]];
-                }
-                for ( int i=0; i<A->num_rows; i++ ) {
-                  b->val[i] = b->val[i] * tmp[i];
-                }
-            }
-            else if (scaling == Magma_UNITDIAG ) {
-                // scale to unit diagonal by rows
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                        if ( A->col[f]== z ) {
-                            s = A->val[f];
-                        }
-                    }
-                    if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                        printf("%%error: zero diagonal element.\n");
-                        info = MAGMA_ERR;
-                    }
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/MAGMA_Z_REAL( s ), 0.0 );
-                }
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->rowidx[z]];
-                }
-                for ( int i=0; i<A->num_rows; i++ ) {
-                  b->val[i] = b->val[i] * tmp[i];
-                }
+                magma_zmscale_rownorm( A, tmp );
+            } else {
+                info = magma_zmscale_diag( A, 0, tmp );
             }
-            else if ( scaling == Magma_UNITROWCOL ) {
-                // scale to unit rownorm by rows and columns
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                        s+= MAGMA_Z_MAKE( MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]), 0.0 );
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }        
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->col[z]] * tmp[A->rowidx[z]];
-                }
-                scaling_factors->num_rows = A->num_rows;
-                scaling_factors->num_cols = 1;
-                scaling_factors->ld = 1;
-                scaling_factors->nnz = A->num_rows;
-                scaling_factors->val = NULL;
-                CHECK( magma_zmalloc_cpu( &scaling_factors->val, A->num_rows ));
-                for ( int i=0; i<A->num_rows; i++ ) {
-                  scaling_factors->val[i] = tmp[i];
-                  b->val[i] = b->val[i] * tmp[i];
-                }
-            }
-            else if (scaling == Magma_UNITDIAGCOL ) {
-                // scale to unit diagonal by rows and columns
-                CHECK( magma_zmalloc_cpu( &tmp, A->num_rows ));
-                for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                    magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                    for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                        if ( A->col[f]== z ) {
-                            s = A->val[f];
-                        }
-                    }
-                    if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                        printf("%%error: zero diagonal element.\n");
-                        info = MAGMA_ERR;
-                    }
-                    tmp[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                }
-                for( magma_int_t z=0; z<A->nnz; z++ ) {
-                    A->val[z] = A->val[z] * tmp[A->col[z]] * tmp[A->rowidx[z]];
-                }
-                scaling_factors->num_rows = A->num_rows;
-                scaling_factors->num_cols = 1;
-                scaling_factors->ld = 1;
-                scaling_factors->nnz = A->num_rows;
-                scaling_factors->val = NULL;
-                CHECK( magma_zmalloc_cpu( &scaling_factors->val, A->num_rows ));
-                for ( int i=0; i<A->num_rows; i++ ) {
-                  scaling_factors->val[i] = tmp[i];
-                  b->val[i] = b->val[i] * tmp[i];
-                }
-            }
-            else {
-                printf( "%%error: scaling %d not supported line = %d.\n", 
-                  scaling, __LINE__ );
-                info = MAGMA_ERR_NOT_SUPPORTED;
+            magma_zmscale_rowcol( A, tmp, NULL );
+            magma_zmscale_vector( A->num_rows, tmp, b->val );
+        }
+        else if ( scaling == Magma_UNITROWCOL || scaling == Magma_UNITDIAGCOL ) {
+            // scale to unit rownorm / unit diagonal by rows and columns,
+            // the factors are returned and used in place
+            scaling_factors->num_rows = A->num_rows;
+            scaling_factors->num_cols = 1;
+            scaling_factors->ld = 1;
+            scaling_factors->nnz = A->num_rows;
+            scaling_factors->val = NULL;
+            CHECK( magma_zmalloc_cpu( &scaling_factors->val, A->num_rows ));
+            if ( scaling == Magma_UNITROWCOL ) {
+                magma_zmscale_rownorm( A, scaling_factors->val );
+            } else {
+                info = magma_zmscale_diag( A, 1, scaling_factors->val );
             }
+            magma_zmscale_rowcol( A, scaling_factors->val, scaling_factors->val );
+            magma_zmscale_vector( A->num_rows, scaling_factors->val, b->val );
         }
         else {
             printf( "%%error: scaling %d not supported line = %d.\n", 
-                  scaling, __LINE__ );
+              scaling, __LINE__ );
             info = MAGMA_ERR_NOT_SUPPORTED;
         }
     }
@@ -347,11 +384,16 @@ magma_zmdiagadd(
     
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
-        for( magma_int_t z=0; z<A->nnz; z++ ) {
-            if ( A->col[z]== A->rowidx[z] ) {
-                // add some identity matrix
-                A->val[z] = A->val[z] +  add;
+    if ( MSCALE_IN_PLACE( A ) ) {
+        // the values are rewritten, drop the reduced-precision copy
+        magma_zmlowprec_free( A, queue );
+        #pragma omp parallel for
+        for( magma_int_t z=0; z<A->num_rows; z++ ) {
+            for( magma_int_t k=A->row[z]; k<A->row[z+1]; k++ ) {
+                if ( A->col[k] == z ) {
+                    // add some identity matrix
+                    A->val[k] = A->val[k] +  add;
+                }
             }
         }
     }
@@ -424,8 +466,6 @@ magma_zmscale_generate(
     magma_queue_t queue  ){
     magma_int_t info = 0;
     
-    magmaDoubleComplex *tmp=NULL;
-    
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
     
@@ -436,7 +476,7 @@ magma_zmscale_generate(
     } 
         
    
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+    if ( MSCALE_IN_PLACE( A ) ) {
         for ( magma_int_t j=0; j<n; j++ ) {
         // printf("%% scaling[%d] = %d\n", j, scaling[j]);
             if ( scaling[j] == Magma_NOSCALE ) {
@@ -444,69 +484,18 @@ magma_zmscale_generate(
             
             }
             else if( A->num_rows == A->num_cols ) {
-                if ( scaling[j] == Magma_UNITROW && side[j] != MagmaBothSides ) {
-                // scale to unit rownorm
-                    for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                        magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                        for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                            s+= MAGMA_Z_MAKE( MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]), 0.0 );
-                        scaling_factors[j].val[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                    }        
-                }
-                else if (scaling[j] == Magma_UNITDIAG && side[j] != MagmaBothSides ) {
-                // scale to unit diagonal
-                    for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                        magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                        for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                            if ( A->col[f]== z ) {
-                                s = A->val[f];
-                            }
-                        }
-                        if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                            printf("%%error: zero diagonal element.\n");
-                            info = MAGMA_ERR;
-                        }
-                        scaling_factors[j].val[z] = MAGMA_Z_MAKE( 1.0/MAGMA_Z_REAL( s ), 0.0 );
-                    }
-                }
-                else if ( scaling[j] == Magma_UNITCOL && side[j] != MagmaBothSides ) {
-                // scale to unit column norm
-                    CHECK( magma_zmtranspose( *A, &CSRA, queue ) );
-                    magma_scale_t tscale = Magma_UNITROW;
-                    magma_zmscale_generate( 1, &tscale, &side[j], &CSRA, 
-                            &scaling_factors[j], queue );
-                }
-                else if ( scaling[j] == Magma_UNITROW && side[j] == MagmaBothSides ) {
-                    // scale to unit rownorm by rows and columns
-                    for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                        magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                        for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ )
-                            s+= MAGMA_Z_MAKE( MAGMA_Z_REAL(A->val[f])*MAGMA_Z_REAL(A->val[f]), 0.0 );
-                        scaling_factors[j].val[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                    } 
+                if ( scaling[j] == Magma_UNITROW ) {
+                    // scale to unit rownorm
+                    magma_zmscale_rownorm( A, scaling_factors[j].val );
                 }
-                else if (scaling[j] == Magma_UNITDIAG && side[j] == MagmaBothSides ) {
-                    // scale to unit diagonal by rows and columns
-                    for( magma_int_t z=0; z<A->num_rows; z++ ) {
-                        magmaDoubleComplex s = MAGMA_Z_MAKE( 0.0, 0.0 );
-                        for( magma_int_t f=A->row[z]; f<A->row[z+1]; f++ ) {
-                            if ( A->col[f]== z ) {
-                                s = A->val[f];
-                            }
-                        }
-                        if ( s == MAGMA_Z_MAKE( 0.0, 0.0 ) ){
-                            printf("%%error: zero diagonal element.\n");
-                            info = MAGMA_ERR;
-                        }
-                        scaling_factors[j].val[z] = MAGMA_Z_MAKE( 1.0/sqrt(  MAGMA_Z_REAL( s )  ), 0.0 );
-                    }
+                else if ( scaling[j] == Magma_UNITDIAG ) {
+                    // scale to unit diagonal, symmetric for both sides
+                    info = magma_zmscale_diag( A, side[j] == MagmaBothSides,
+                                               scaling_factors[j].val );
                 }
-                else if ( scaling[j] == Magma_UNITCOL && side[j] == MagmaBothSides ) {
+                else if ( scaling[j] == Magma_UNITCOL ) {
                     // scale to unit column norm
-                    CHECK( magma_zmtranspose( *A, &CSRA, queue ) );
-                    magma_scale_t tscale = Magma_UNITROW;
-                    magma_zmscale_generate( 1, &tscale, &side[j], &CSRA, 
-                      &scaling_factors[j], queue );
+                    CHECK( magma_zmscale_colnorm( A, scaling_factors[j].val ));
                 }
                 else {
                     printf( "%%error: scaling %d not supported line = %d.\n", 
@@ -537,13 +526,11 @@ magma_zmscale_generate(
     
     
 cleanup:
-    magma_free_cpu( tmp );
     magma_zmfree( &hA, queue );
     magma_zmfree( &CSRA, queue );
     return info;
 }
 
-
 /**
     Purpose
     -------
@@ -585,35 +572,27 @@ magma_zmscale_apply(
       magma_z_matrix* A,
       magma_queue_t queue ){
     magma_int_t info = 0;
-      
-    magmaDoubleComplex *tmp=NULL;
     
     magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR};
     
-    if ( A->memory_location == Magma_CPU && A->storage_type == Magma_CSRCOO ) {
+    if ( MSCALE_IN_PLACE( A ) ) {
+        // the values are rewritten, drop the reduced-precision copy
+        magma_zmlowprec_free( A, queue );
         for ( magma_int_t j=0; j<n; j++ ) {
             
             if( A->num_rows == A->num_cols ) {
                 if ( side[j] == MagmaLeft ) {
-                    // scale by rows       
-                    for( magma_int_t z=0; z<A->nnz; z++ ) {
-                        A->val[z] = A->val[z] * scaling_factors[j].val[A->rowidx[z]];
-                    }
+                    // scale by rows
+                    magma_zmscale_rowcol( A, scaling_factors[j].val, NULL );
                 }
                 else if ( side[j] == MagmaBothSides ) {
-                    // scale by rows and columns       
-                    for( magma_int_t z=0; z<A->nnz; z++ ) {
-                        A->val[z] = A->val[z] 
-                            * scaling_factors[j].val[A->col[z]] 
-                            * scaling_factors[j].val[A->rowidx[z]];
-                    }
+                    // scale by rows and columns
+                    magma_zmscale_rowcol( A, scaling_factors[j].val,
+                                          scaling_factors[j].val );
                 }
                 else if ( side[j] == MagmaRight ) {
                     // scale by columns
-                    for( magma_int_t z=0; z<A->nnz; z++ ) {
-                        A->val[z] = A->val[z] * scaling_factors[j].val[A->rowidx[z]];
-                    }
-                    
+                    magma_zmscale_rowcol( A, NULL, scaling_factors[j].val );
                 }
             }
         }
@@ -634,7 +613,6 @@ magma_zmscale_apply(
     
     
 cleanup:
-    magma_free_cpu( tmp );
     magma_zmfree( &hA, queue );
     magma_zmfree( &CSRA, queue );
   
@@ -642,7 +620,6 @@ cleanup:
     return info;
 }
 
-
 /**
     Purpose
     -------
@@ -218,6 +218,10 @@ magma_zmvarsizeblockstruct(
     A->row = NULL;
     A->rowidx = NULL;
     A->blockinfo = NULL;
+    A->val_low = NULL;
+    A->col_low = NULL;
+    A->col_base = NULL;
+    A->storage_precision = Magma_DCOMPLEX;
     A->diag = NULL;
     A->dval = NULL;
     A->dcol = NULL;
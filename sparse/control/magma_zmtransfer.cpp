@@ -67,6 +67,10 @@ magma_zmtransfer(
     B->rowidx = NULL;
     B->col = NULL;
     B->blockinfo = NULL;
+    B->val_low = NULL;
+    B->col_low = NULL;
+    B->col_base = NULL;
+    B->storage_precision = Magma_DCOMPLEX;
     B->dval = NULL;
     B->ddiag = NULL;
     B->drow = NULL;
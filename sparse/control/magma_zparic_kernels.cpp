@@ -51,6 +51,10 @@ magma_zparic_sweep(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
+
+    // the values are rewritten, drop the reduced-precision copy
+    magma_zmlowprec_free( L, queue );
+
     int i, j;
 
 
@@ -128,6 +132,10 @@ magma_zparic_sweep_sync(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
+
+    // the values are rewritten, drop the reduced-precision copy
+    magma_zmlowprec_free( L, queue );
+
     int i, j;
     int il, iu, jl, ju;
     magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
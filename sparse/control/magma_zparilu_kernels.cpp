@@ -56,16 +56,18 @@ magma_zparilu_sweep(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
-    int i, j;
 
+    // the values are rewritten, drop the reduced-precision copies
+    magma_zmlowprec_free( L, queue );
+    magma_zmlowprec_free( U, queue );
 
     magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
-    int il, iu, jl, ju;
 
     #pragma omp parallel for
     for (int k=0; k < A.nnz; k++) {
-        i = A.rowidx[k];
-        j = A.col[k];
+        int i = A.rowidx[k];
+        int j = A.col[k];
+        int il, iu, jl, ju;
 
         magmaDoubleComplex s, sp;
         s =  A.val[k];
@@ -139,13 +141,13 @@ magma_zparilu_sweep_sync(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
-    int i, j;
 
+    // the values are rewritten, drop the reduced-precision copies
+    magma_zmlowprec_free( L, queue );
+    magma_zmlowprec_free( U, queue );
 
     magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
     
-    int il, iu, jl, ju;
-    
     magmaDoubleComplex *L_new_val = NULL, *U_new_val = NULL, *val_swap = NULL;
     
     CHECK( magma_zmalloc_cpu( &L_new_val, L->nnz ));
@@ -159,8 +161,9 @@ magma_zparilu_sweep_sync(
     
     #pragma omp parallel for
     for (int k=0; k < A.nnz; k++) {
-        i = A.rowidx[k];
-        j = A.col[k];
+        int i = A.rowidx[k];
+        int j = A.col[k];
+        int il, iu, jl, ju;
         
         magmaDoubleComplex s, sp;
         s =  A.val[k];
@@ -201,3 +204,110 @@ cleanup:
     
     return info;
 }
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    This function does one asynchronous ParILU sweep and monitors the
+    convergence of the fixed-point iteration at the same time.
+    Every thread compares the value it writes with the value it overwrites,
+    so the relative change of the factors
+    
+        change = || (L,U)_new - (L,U)_old ||_F / || (L,U)_new ||_F
+    
+    comes for free with the sweep. Input and output array are identical.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                System matrix in COO.
+
+    @param[in,out]
+    L           magma_z_matrix*
+                Current approximation for the lower triangular factor
+                The format is sorted CSR.
+
+    @param[in,out]
+    U           magma_z_matrix*
+                Current approximation for the upper triangular factor
+                The format is sorted CSC (U^T in CSR).
+                
+    @param[out]
+    change      double*
+                Relative Frobenius norm of the update of the factors.
+                
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+
+extern "C" magma_int_t
+magma_zparilu_sweep_monitor(
+    magma_z_matrix A,
+    magma_z_matrix *L,
+    magma_z_matrix *U,
+    double *change,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    // the values are rewritten, drop the reduced-precision copies
+    magma_zmlowprec_free( L, queue );
+    magma_zmlowprec_free( U, queue );
+
+    magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
+    double diffnrm = 0.0, valnrm = 0.0;
+
+    #pragma omp parallel for reduction(+:diffnrm, valnrm)
+    for (int k=0; k < A.nnz; k++) {
+        int i = A.rowidx[k];
+        int j = A.col[k];
+        int il, iu, jl, ju;
+
+        magmaDoubleComplex s, sp, oldval;
+        double d, v;
+        s =  A.val[k];
+        sp = zero;
+
+        il = L->row[i];
+        iu = U->row[j];
+
+        while (il < L->row[i+1] && iu < U->row[j+1])
+        {
+            sp = zero;
+            jl = L->col[il];
+            ju = U->col[iu];
+
+            // avoid branching
+            sp = ( jl == ju ) ? L->val[il] * U->val[iu] : sp;
+            s = ( jl == ju ) ? s-sp : s;
+            il = ( jl <= ju ) ? il+1 : il;
+            iu = ( jl >= ju ) ? iu+1 : iu;
+        }
+        // undo the last operation (it must be the last)
+        s += sp;
+        
+        if ( i > j ) {    // modify l entry
+            oldval = L->val[il-1];
+            s = s / U->val[U->row[j+1]-1];
+            L->val[il-1] = s;
+        } else {          // modify u entry
+            oldval = U->val[iu-1];
+            U->val[iu-1] = s;
+        }
+        d = MAGMA_Z_ABS( s - oldval );
+        v = MAGMA_Z_ABS( s );
+        diffnrm += d * d;
+        valnrm += v * v;
+    }
+    
+    *change = ( valnrm > 0.0 ) ? sqrt( diffnrm / valnrm ) : sqrt( diffnrm );
+    
+    return info;
+}
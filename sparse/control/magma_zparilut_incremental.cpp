@@ -0,0 +1,1079 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include <algorithm>
+#include "magmasparse_internal.h"
+#include "trace.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// arrays of a magma_z_parilut_factor besides start, len, col
+#define INC_VAL   1
+#define INC_WORK  2
+#define INC_POS   4
+
+
+/*
+    Incremental factor update for the CPU ParILUT.
+
+    The factors live in a magma_z_parilut_factors structure for the whole
+    ParILUT iteration:
+        L   by rows, sorted, the diagonal last,
+        U   by columns, sorted, the diagonal last,
+        UT  the pattern of U by rows, sorted, the diagonal first.
+    Every row (column) keeps slack space behind its entries. The candidates
+    are merged into the slack of their rows in place, and the removal
+    compacts every row in place. A factor is only repacked, with new slack,
+    if a row overflows. U.pos and UT.pos hold the position of every entry of
+    U in UT and vice versa; moving an entry updates the position stored in
+    the other structure, so UT follows U without a transpose.
+    The synchronous sweep computes the new values in the work arrays and
+    swaps them with the values. The candidates are collected in the
+    workspace C (by rows) and CU (U candidates by columns), which, like the
+    per-thread buffers, are only reallocated when they grow.
+*/
+
+
+// slack behind a row with len entries when a factor is (re)packed
+static inline magma_int_t
+magma_zparilut_inc_slack( magma_int_t len )
+{
+    return len/4 + 4;
+}
+
+
+// makes sure the entry arrays of X hold capacity entries; the content is lost
+static magma_int_t
+magma_zparilut_inc_reserve(
+    magma_z_parilut_factor *X,
+    magma_int_t capacity,
+    magma_int_t arrays )
+{
+    magma_int_t info = 0;
+
+    if (X->capacity >= capacity && X->col != NULL) {
+        goto cleanup;
+    }
+    capacity = max( capacity + capacity/8, (magma_int_t) 1 );
+    magma_free_cpu( X->col );
+    magma_free_cpu( X->val );
+    magma_free_cpu( X->work );
+    magma_free_cpu( X->pos );
+    X->col = NULL;
+    X->val = NULL;
+    X->work = NULL;
+    X->pos = NULL;
+    X->capacity = 0;
+    CHECK( magma_index_malloc_cpu( &X->col, capacity ));
+    if (arrays & INC_VAL) {
+        CHECK( magma_zmalloc_cpu( &X->val, capacity ));
+    }
+    if (arrays & INC_WORK) {
+        CHECK( magma_zmalloc_cpu( &X->work, capacity ));
+    }
+    if (arrays & INC_POS) {
+        CHECK( magma_index_malloc_cpu( &X->pos, capacity ));
+    }
+    X->capacity = capacity;
+
+cleanup:
+    return info;
+}
+
+
+// allocates the row arrays of X for n empty rows, and the given entry arrays
+static magma_int_t
+magma_zparilut_inc_alloc(
+    magma_z_parilut_factor *X,
+    magma_int_t n,
+    magma_int_t arrays )
+{
+    magma_int_t info = 0;
+
+    X->num_rows = n;
+    X->nnz = 0;
+    X->capacity = 0;
+    CHECK( magma_index_malloc_cpu( &X->start, n+1 ));
+    CHECK( magma_index_malloc_cpu( &X->len, max( n, (magma_int_t) 1 )));
+    #pragma omp parallel for
+    for (magma_int_t i=0; i < n; i++) {
+        X->start[i+1] = 0;
+        X->len[i] = 0;
+    }
+    X->start[0] = 0;
+    CHECK( magma_zparilut_inc_reserve( X, 0, arrays ));
+
+cleanup:
+    return info;
+}
+
+
+// makes sure every row i of X has room for extra[i] more entries. If a row
+// is too small, X is repacked with new slack behind every row; the moved
+// entries of X are updated in other->pos.
+static magma_int_t
+magma_zparilut_inc_grow(
+    magma_z_parilut_factor *X,
+    const magma_index_t *extra,
+    magma_z_parilut_factor *other,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = X->num_rows;
+    magma_int_t overflow = 0;
+    magma_z_parilut_factor Y = *X;
+
+    #pragma omp parallel for reduction(+:overflow)
+    for (magma_int_t i=0; i < n; i++) {
+        if (X->len[i] + extra[i] > X->start[i+1] - X->start[i]) {
+            overflow++;
+        }
+    }
+    if (overflow == 0) {
+        goto cleanup;
+    }
+
+    // Y gets new entry arrays; the old ones of X are freed below
+    Y.start = NULL;
+    Y.col = NULL;
+    Y.val = NULL;
+    Y.work = NULL;
+    Y.pos = NULL;
+    Y.capacity = 0;
+    CHECK( magma_index_malloc_cpu( &Y.start, n+1 ));
+    Y.start[0] = 0;
+    #pragma omp parallel for
+    for (magma_int_t i=0; i < n; i++) {
+        magma_int_t need = X->len[i] + extra[i];
+        Y.start[i+1] = need + magma_zparilut_inc_slack( need );
+    }
+    CHECK( magma_zmatrix_createrowptr( n, Y.start, queue ));
+    CHECK( magma_zparilut_inc_reserve( &Y, Y.start[n],
+        ( X->val  != NULL ? INC_VAL  : 0 ) |
+        ( X->work != NULL ? INC_WORK : 0 ) |
+        ( X->pos  != NULL ? INC_POS  : 0 )));
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (magma_int_t i=0; i < n; i++) {
+        magma_int_t from = X->start[i], to = Y.start[i];
+        for (magma_int_t k=0; k < X->len[i]; k++) {
+            Y.col[ to+k ] = X->col[ from+k ];
+            if (X->val != NULL) {
+                Y.val[ to+k ] = X->val[ from+k ];
+            }
+            if (X->pos != NULL) {
+                Y.pos[ to+k ] = X->pos[ from+k ];
+                other->pos[ Y.pos[ to+k ] ] = to+k;
+            }
+        }
+    }
+    std::swap( *X, Y );
+
+cleanup:
+    if (Y.start != X->start) {
+        magma_free_cpu( Y.start );
+        magma_free_cpu( Y.col );
+        magma_free_cpu( Y.val );
+        magma_free_cpu( Y.work );
+        magma_free_cpu( Y.pos );
+    }
+    return info;
+}
+
+
+// ILU residual a_ij - sum_{k<min(i,j)} l_ik u_kj in a location outside the
+// pattern of L and U
+static inline magmaDoubleComplex
+magma_zparilut_inc_residual(
+    magma_z_matrix *A,
+    magma_z_parilut_factor *L,
+    magma_z_parilut_factor *U,
+    magma_index_t row,
+    magma_index_t col )
+{
+    magmaDoubleComplex sum = MAGMA_Z_ZERO;
+    magmaDoubleComplex A_e = MAGMA_Z_ZERO;
+    for (magma_int_t i = A->row[row]; i < A->row[row+1]; i++) {
+        if (A->col[i] == col) {
+            A_e = A->val[i];
+            break;
+        }
+    }
+    magma_int_t i = L->start[ row ];
+    magma_int_t j = U->start[ col ];
+    magma_int_t endi = i + L->len[ row ];
+    magma_int_t endj = j + U->len[ col ];
+    while (i < endi && j < endj) {
+        magma_index_t icol = L->col[i];
+        magma_index_t jcol = U->col[j];
+        if (icol == jcol) {
+            sum = sum + L->val[i] * U->val[j];
+            i++;
+            j++;
+        } else if (icol < jcol) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    return A_e - sum;
+}
+
+
+// upper bound for the number of candidates in row i
+static inline magma_int_t
+magma_zparilut_inc_bound(
+    magma_z_matrix *L0,
+    magma_z_matrix *U0,
+    magma_z_parilut_factors *F,
+    magma_index_t row )
+{
+    magma_int_t bound = L0->row[row+1] - L0->row[row]
+                      + U0->row[row+1] - U0->row[row];
+    magma_int_t el1 = F->L.start[row], end1 = el1 + F->L.len[row] - 1;
+    for (; el1 < end1; el1++) {
+        bound += F->UT.len[ F->L.col[el1] ];
+    }
+    return bound;
+}
+
+
+// sorted list of the candidate columns of row i: the pattern of A and the
+// ILU(1) fill-in of the current factors, including the entries already in
+// L or U
+static inline magma_int_t
+magma_zparilut_inc_gather(
+    magma_z_matrix *L0,
+    magma_z_matrix *U0,
+    magma_z_parilut_factors *F,
+    magma_index_t row,
+    magma_index_t *buf )
+{
+    magma_z_parilut_factor *L = &F->L, *UT = &F->UT;
+    magma_int_t len = 0;
+    for (magma_int_t k = L0->row[row]; k < L0->row[row+1]; k++) {
+        buf[len++] = L0->col[k];
+    }
+    for (magma_int_t k = U0->row[row]; k < U0->row[row+1]; k++) {
+        buf[len++] = U0->col[k];
+    }
+    // the diagonal is the last element of a row in L and the first in UT
+    magma_int_t el1 = L->start[row], end1 = el1 + L->len[row] - 1;
+    for (; el1 < end1; el1++) {
+        magma_index_t col1 = L->col[el1];
+        magma_int_t el2 = UT->start[col1] + 1, end2 = UT->start[col1] + UT->len[col1];
+        for (; el2 < end2; el2++) {
+            buf[len++] = UT->col[el2];
+        }
+    }
+    std::sort( buf, buf+len );
+    return (magma_int_t) ( std::unique( buf, buf+len ) - buf );
+}
+
+
+// the columns of the sorted list buf[0:len] that are not in row i of X;
+// writes them to out unless out is NULL, returns their number
+static inline magma_int_t
+magma_zparilut_inc_new(
+    magma_z_parilut_factor *X,
+    magma_index_t row,
+    const magma_index_t *buf,
+    magma_int_t len,
+    magma_index_t *out )
+{
+    magma_int_t num_new = 0;
+    magma_int_t a = X->start[row], enda = a + X->len[row];
+    for (magma_int_t c=0; c < len; c++) {
+        while (a < enda && X->col[a] < buf[c]) {
+            a++;
+        }
+        if (a == enda || X->col[a] != buf[c]) {
+            if (out != NULL) {
+                out[ num_new ] = buf[c];
+            }
+            num_new++;
+        }
+    }
+    return num_new;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Sets up the factors of the incremental ParILUT from L and U: L by rows,
+    U by columns, and UT, the pattern of U by rows, with the positions of
+    the entries of U in UT and vice versa. Every row gets slack space for
+    the entries added by magma_zparilut_inc_add.
+
+    Arguments
+    ---------
+
+    @param[in]
+    L           magma_z_matrix
+                Lower triangular factor in sorted CSR, unit diagonal last.
+
+    @param[in]
+    U           magma_z_matrix
+                Upper triangular factor in sorted CSC, i.e., U^T in sorted
+                CSR, diagonal last.
+
+    @param[out]
+    F           magma_z_parilut_factors*
+                Factors, free with magma_zparilut_inc_free.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparilut_inc_init(
+    magma_z_matrix L,
+    magma_z_matrix U,
+    magma_z_parilut_factors *F,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = L.num_rows;
+    magma_z_parilut_factor *Lf = &F->L, *Uf = &F->U, *UT = &F->UT;
+
+    memset( F, 0, sizeof(magma_z_parilut_factors) );
+    F->n = n;
+    CHECK( magma_zparilut_inc_alloc( Lf, n, INC_VAL | INC_WORK ));
+    CHECK( magma_zparilut_inc_alloc( Uf, n, INC_VAL | INC_WORK | INC_POS ));
+    CHECK( magma_zparilut_inc_alloc( UT, n, INC_POS ));
+    CHECK( magma_zparilut_inc_alloc( &F->C, n, INC_VAL | INC_POS ));
+    CHECK( magma_zparilut_inc_alloc( &F->CU, n, INC_POS ));
+    CHECK( magma_index_malloc_cpu( &F->cnt, max( n, (magma_int_t) 1 )));
+
+    // L and U: copy the rows into the slack layout
+    #pragma omp parallel for
+    for (magma_int_t i=0; i < n; i++) {
+        F->cnt[i] = L.row[i+1] - L.row[i];
+    }
+    CHECK( magma_zparilut_inc_grow( Lf, F->cnt, NULL, queue ));
+    #pragma omp parallel for
+    for (magma_int_t i=0; i < n; i++) {
+        F->cnt[i] = U.row[i+1] - U.row[i];
+    }
+    CHECK( magma_zparilut_inc_grow( Uf, F->cnt, UT, queue ));
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (magma_int_t i=0; i < n; i++) {
+        magma_int_t len = L.row[i+1] - L.row[i];
+        for (magma_int_t k=0; k < len; k++) {
+            Lf->col[ Lf->start[i]+k ] = L.col[ L.row[i]+k ];
+            Lf->val[ Lf->start[i]+k ] = L.val[ L.row[i]+k ];
+        }
+        Lf->len[i] = len;
+        len = U.row[i+1] - U.row[i];
+        for (magma_int_t k=0; k < len; k++) {
+            Uf->col[ Uf->start[i]+k ] = U.col[ U.row[i]+k ];
+            Uf->val[ Uf->start[i]+k ] = U.val[ U.row[i]+k ];
+        }
+        Uf->len[i] = len;
+    }
+    Lf->nnz = L.nnz;
+    Uf->nnz = U.nnz;
+
+    // UT: columns in increasing order give sorted rows
+    #pragma omp parallel for
+    for (magma_int_t i=0; i < n; i++) {
+        F->cnt[i] = 0;
+    }
+    for (magma_int_t p=0; p < U.nnz; p++) {
+        F->cnt[ U.col[p] ]++;
+    }
+    CHECK( magma_zparilut_inc_grow( UT, F->cnt, Uf, queue ));
+    for (magma_int_t j=0; j < n; j++) {
+        for (magma_int_t p=Uf->start[j]; p < Uf->start[j] + Uf->len[j]; p++) {
+            magma_index_t row = Uf->col[p];
+            magma_index_t q = UT->start[row] + UT->len[row]++;
+            UT->col[q] = j;
+            UT->pos[q] = p;
+            Uf->pos[p] = q;
+        }
+    }
+    UT->nnz = U.nnz;
+
+cleanup:
+    if (info != 0) {
+        magma_zparilut_inc_free( F, queue );
+    }
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Adds the ParILUT candidates to the factors in place. The candidates are
+    the locations of the pattern of A and of the ILU(1) fill-in of L*U that
+    are not yet in the factors; they are initialized with the ILU residual.
+    Every row collects its sorted candidates in the workspace F->C, then
+    they are merged into the slack of the rows of L and UT from the back;
+    the U candidates, ordered by column in F->CU, are merged into the
+    columns of U the same way. Moved entries of U and UT update their
+    position in the other structure. A factor is repacked only if a row
+    has not enough slack.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix*
+                System matrix in sorted CSR.
+
+    @param[in]
+    L0          magma_z_matrix*
+                tril( A ) in sorted CSR.
+
+    @param[in]
+    U0          magma_z_matrix*
+                triu( A ) in sorted CSR.
+
+    @param[in,out]
+    F           magma_z_parilut_factors*
+                Factors, see magma_zparilut_inc_init.
+
+    @param[out]
+    sum         double*
+                Sum of the absolute values of the candidate residuals.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparilut_inc_add(
+    magma_z_matrix *A,
+    magma_z_matrix *L0,
+    magma_z_matrix *U0,
+    magma_z_parilut_factors *F,
+    double *sum,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = F->n;
+    magma_z_parilut_factor *L = &F->L, *U = &F->U, *UT = &F->UT;
+    magma_z_parilut_factor *C = &F->C, *CU = &F->CU;
+    magma_int_t num_threads = 1, bound = 0, num_L = 0, num_U = 0;
+    double res_sum = 0.0;
+
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+    // a buffer of the largest bound for every thread
+    #pragma omp parallel for reduction(max:bound)
+    for (magma_int_t row=0; row < n; row++) {
+        bound = max( bound, magma_zparilut_inc_bound( L0, U0, F, row ));
+    }
+    if (num_threads * bound > F->buf_size) {
+        magma_free_cpu( F->buf );
+        F->buf = NULL;
+        F->buf_size = 0;
+        CHECK( magma_index_malloc_cpu( &F->buf, max( num_threads * bound, (magma_int_t) 1 )));
+        F->buf_size = num_threads * bound;
+    }
+
+    // pass 1: count the new entries of every row
+    // pass 2: store them and their residuals in C, the L candidates first
+    for (magma_int_t pass=0; pass < 2; pass++) {
+        if (pass == 1) {
+            C->start[0] = 0;
+            CHECK( magma_zmatrix_createrowptr( n, C->start, queue ));
+            CHECK( magma_zparilut_inc_reserve( C, C->start[n], INC_VAL | INC_POS ));
+        }
+        // per thread, the gaps show the load imbalance
+        #pragma omp parallel num_threads(num_threads) reduction(+:res_sum)
+        {
+#ifdef _OPENMP
+            magma_index_t *buf = F->buf + omp_get_thread_num() * bound;
+#else
+            magma_index_t *buf = F->buf;
+#endif
+            magma_trace_begin( "parilut", ( pass == 0 ) ? "count candidates" : "candidates" );
+            #pragma omp for schedule(dynamic, 64) nowait
+            for (magma_int_t row=0; row < n; row++) {
+                magma_int_t len = magma_zparilut_inc_gather( L0, U0, F, row, buf );
+                // candidates with col < row go to L, the others to U
+                magma_int_t split = (magma_int_t)
+                    ( std::lower_bound( buf, buf+len, row ) - buf );
+                if (pass == 0) {
+                    C->len[row] = magma_zparilut_inc_new( L, row, buf, split, NULL );
+                    C->start[row+1] = C->len[row]
+                        + magma_zparilut_inc_new( UT, row, buf+split, len-split, NULL );
+                } else {
+                    magma_int_t c = C->start[row];
+                    magma_zparilut_inc_new( L, row, buf, split, C->col + c );
+                    magma_zparilut_inc_new( UT, row, buf+split, len-split, C->col + c + C->len[row] );
+                    for (; c < C->start[row+1]; c++) {
+                        C->val[c] = magma_zparilut_inc_residual( A, L, U, row, C->col[c] );
+                        res_sum += MAGMA_Z_ABS( C->val[c] );
+                    }
+                }
+            }
+            magma_trace_end();
+        }
+    }
+
+    // order the U candidates by column in CU; the candidates are stored by
+    // increasing row, so the rows of every column come out sorted
+    #pragma omp parallel for
+    for (magma_int_t j=0; j < n; j++) {
+        CU->len[j] = 0;
+    }
+    for (magma_int_t row=0; row < n; row++) {
+        for (magma_int_t c = C->start[row] + C->len[row]; c < C->start[row+1]; c++) {
+            CU->len[ C->col[c] ]++;
+        }
+    }
+    CU->start[0] = 0;
+    #pragma omp parallel for
+    for (magma_int_t j=0; j < n; j++) {
+        CU->start[j+1] = CU->len[j];
+        CU->len[j] = 0;
+    }
+    CHECK( magma_zmatrix_createrowptr( n, CU->start, queue ));
+    CHECK( magma_zparilut_inc_reserve( CU, CU->start[n], INC_POS ));
+    for (magma_int_t row=0; row < n; row++) {
+        for (magma_int_t c = C->start[row] + C->len[row]; c < C->start[row+1]; c++) {
+            magma_index_t j = C->col[c];
+            magma_index_t p = CU->start[j] + CU->len[j]++;
+            CU->col[p] = row;
+            CU->pos[p] = c;
+        }
+    }
+
+    // room for the new entries
+    CHECK( magma_zparilut_inc_grow( L, C->len, NULL, queue ));
+    #pragma omp parallel for
+    for (magma_int_t row=0; row < n; row++) {
+        F->cnt[row] = C->start[row+1] - C->start[row] - C->len[row];
+    }
+    CHECK( magma_zparilut_inc_grow( UT, F->cnt, U, queue ));
+    CHECK( magma_zparilut_inc_grow( U, CU->len, UT, queue ));
+
+    // merge the candidates into the rows of L and UT from the back, so every
+    // entry moves at most once; new UT entries get their U position below
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:num_L, num_U)
+    for (magma_int_t row=0; row < n; row++) {
+        magma_int_t c0 = C->start[row], c = c0 + C->len[row] - 1;
+        magma_int_t a = L->start[row] + L->len[row] - 1;
+        magma_int_t out = a + C->len[row];
+        for (; c >= c0; out--) {
+            if (a >= L->start[row] && L->col[a] > C->col[c]) {
+                L->col[out] = L->col[a];
+                L->val[out] = L->val[a];
+                a--;
+            } else {
+                L->col[out] = C->col[c];
+                L->val[out] = C->val[c];
+                c--;
+            }
+        }
+        L->len[row] += C->len[row];
+        num_L += C->len[row];
+
+        c0 = C->start[row] + C->len[row];
+        c = C->start[row+1] - 1;
+        a = UT->start[row] + UT->len[row] - 1;
+        out = a + C->start[row+1] - c0;
+        for (; c >= c0; out--) {
+            if (a >= UT->start[row] && UT->col[a] > C->col[c]) {
+                UT->col[out] = UT->col[a];
+                UT->pos[out] = UT->pos[a];
+                U->pos[ UT->pos[out] ] = out;
+                a--;
+            } else {
+                UT->col[out] = C->col[c];
+                C->pos[c] = out;
+                c--;
+            }
+        }
+        UT->len[row] += C->start[row+1] - c0;
+        num_U += C->start[row+1] - c0;
+    }
+
+    // merge the U candidates into the columns of U
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (magma_int_t j=0; j < n; j++) {
+        magma_int_t c0 = CU->start[j], c = CU->start[j+1] - 1;
+        magma_int_t a = U->start[j] + U->len[j] - 1;
+        magma_int_t out = a + CU->len[j];
+        for (; c >= c0; out--) {
+            if (a >= U->start[j] && U->col[a] > CU->col[c]) {
+                U->col[out] = U->col[a];
+                U->val[out] = U->val[a];
+                U->pos[out] = U->pos[a];
+                UT->pos[ U->pos[out] ] = out;
+                a--;
+            } else {
+                magma_index_t cand = CU->pos[c];
+                U->col[out] = CU->col[c];
+                U->val[out] = C->val[cand];
+                U->pos[out] = C->pos[cand];
+                UT->pos[ U->pos[out] ] = out;
+                c--;
+            }
+        }
+        U->len[j] += CU->len[j];
+    }
+
+    L->nnz += num_L;
+    U->nnz += num_U;
+    UT->nnz += num_U;
+    *sum = res_sum;
+
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Synchronous ParILUT sweep like magma_zparilut_sweep_sync on the factors
+    of the incremental ParILUT. The new values are computed in the work
+    arrays, which are then swapped with the values.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix*
+                System matrix in sorted CSR.
+
+    @param[in,out]
+    F           magma_z_parilut_factors*
+                Factors, see magma_zparilut_inc_init.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparilut_inc_sweep(
+    magma_z_matrix *A,
+    magma_z_parilut_factors *F,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = F->n;
+    magma_z_parilut_factor *L = &F->L, *U = &F->U;
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (magma_int_t col=0; col < n; col++) {
+        for (magma_int_t e = U->start[col]; e < U->start[col] + U->len[col]; e++) {
+            magma_index_t row = U->col[ e ];
+            magmaDoubleComplex A_e = MAGMA_Z_ZERO;
+            for (magma_int_t i = A->row[row]; i < A->row[row+1]; i++) {
+                if (A->col[i] == col) {
+                    A_e = A->val[i];
+                    break;
+                }
+            }
+            magma_int_t i = L->start[ row ];
+            magma_int_t j = U->start[ col ];
+            magma_int_t endi = i + L->len[ row ];
+            magma_int_t endj = j + U->len[ col ];
+            magmaDoubleComplex sum = MAGMA_Z_ZERO;
+            magmaDoubleComplex lsum = MAGMA_Z_ZERO;
+            do {
+                lsum = MAGMA_Z_ZERO;
+                magma_index_t icol = L->col[i];
+                magma_index_t jcol = U->col[j];
+                if (icol == jcol) {
+                    lsum = L->val[i] * U->val[j];
+                    sum = sum + lsum;
+                    i++;
+                    j++;
+                } else if (icol < jcol) {
+                    i++;
+                } else {
+                    j++;
+                }
+            } while (i < endi && j < endj);
+            // the last product is l_ii * u_ij
+            sum = sum - lsum;
+            U->work[ e ] = A_e - sum;
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (magma_int_t row=0; row < n; row++) {
+        for (magma_int_t e = L->start[row]; e < L->start[row] + L->len[row]; e++) {
+            magma_index_t col = L->col[ e ];
+            if (row == col) {
+                L->work[ e ] = MAGMA_Z_ONE;
+                continue;
+            }
+            magmaDoubleComplex A_e = MAGMA_Z_ZERO;
+            for (magma_int_t i = A->row[row]; i < A->row[row+1]; i++) {
+                if (A->col[i] == col) {
+                    A_e = A->val[i];
+                    break;
+                }
+            }
+            magma_int_t i = L->start[ row ];
+            magma_int_t j = U->start[ col ];
+            magma_int_t jold = j;
+            magma_int_t endi = i + L->len[ row ];
+            magma_int_t endj = j + U->len[ col ];
+            magmaDoubleComplex sum = MAGMA_Z_ZERO;
+            magmaDoubleComplex lsum = MAGMA_Z_ZERO;
+            do {
+                lsum = MAGMA_Z_ZERO;
+                jold = j;
+                magma_index_t icol = L->col[i];
+                magma_index_t jcol = U->col[j];
+                if (icol == jcol) {
+                    lsum = L->val[i] * U->work[j];
+                    sum = sum + lsum;
+                    i++;
+                    j++;
+                } else if (icol < jcol) {
+                    i++;
+                } else {
+                    j++;
+                }
+            } while (i < endi && j < endj);
+            // the last product is l_ij * u_jj
+            sum = sum - lsum;
+            L->work[ e ] = ( A_e - sum ) / U->val[ jold ];
+        }
+    }
+
+    std::swap( L->val, L->work );
+    std::swap( U->val, U->work );
+
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes the thresholds for removing num_rmL off-diagonal elements of L
+    and num_rmU of U, see magma_zparilut_set_thrs_randomselect_approx. The
+    off-diagonal elements are gathered in the work arrays of the factors,
+    which are free between the sweeps.
+
+    Arguments
+    ---------
+
+    @param[in]
+    num_rmL     magma_int_t
+                Number of elements to remove from L; thrsL = 0 if <= 0.
+
+    @param[in]
+    num_rmU     magma_int_t
+                Number of elements to remove from U; thrsU = 0 if <= 0.
+
+    @param[in,out]
+    F           magma_z_parilut_factors*
+                Factors, see magma_zparilut_inc_init.
+
+    @param[out]
+    thrsL       double*
+                Threshold for L.
+
+    @param[out]
+    thrsU       double*
+                Threshold for U.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparilut_inc_thrs(
+    magma_int_t num_rmL,
+    magma_int_t num_rmU,
+    magma_z_parilut_factors *F,
+    double *thrsL,
+    double *thrsU,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = F->n;
+    magma_index_t *off = F->CU.start;    // workspace
+    magma_z_parilut_factor *X[2] = { &F->L, &F->U };
+    magma_int_t num_rm[2] = { num_rmL, num_rmU };
+    double *thrs[2] = { thrsL, thrsU };
+
+    for (int k=0; k < 2; k++) {
+        magma_z_parilut_factor *Y = X[k];
+        magma_z_matrix oneY={Magma_CSR};
+        *thrs[k] = 0.0;
+        if (num_rm[k] <= 0) {
+            continue;
+        }
+        // the diagonal is the last entry of the rows of L and the columns of U
+        off[0] = 0;
+        #pragma omp parallel for
+        for (magma_int_t i=0; i < n; i++) {
+            off[i+1] = Y->len[i] - 1;
+        }
+        CHECK( magma_zmatrix_createrowptr( n, off, queue ));
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (magma_int_t i=0; i < n; i++) {
+            for (magma_int_t e=0; e < Y->len[i] - 1; e++) {
+                Y->work[ off[i] + e ] = Y->val[ Y->start[i] + e ];
+            }
+        }
+        oneY.num_rows = n;
+        oneY.num_cols = n;
+        oneY.nnz = off[n];
+        oneY.val = Y->work;
+        oneY.memory_location = Magma_CPU;
+        CHECK( magma_zparilut_set_thrs_randomselect_approx( num_rm[k], &oneY, 0,
+            thrs[k], queue ));
+    }
+
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Removes the off-diagonal elements with absolute value smaller or equal
+    the thresholds from the factors. Every row of L, every column of U and
+    every row of UT is compacted in place; removed and moved entries of U
+    update their position in UT and vice versa.
+
+    Arguments
+    ---------
+
+    @param[in]
+    thrsL       double
+                Threshold for L.
+
+    @param[in]
+    thrsU       double
+                Threshold for U.
+
+    @param[in,out]
+    F           magma_z_parilut_factors*
+                Factors, see magma_zparilut_inc_init.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparilut_inc_rm(
+    double thrsL,
+    double thrsU,
+    magma_z_parilut_factors *F,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = F->n;
+    magma_z_parilut_factor *L = &F->L, *U = &F->U, *UT = &F->UT;
+    magma_int_t nnzL = 0, nnzU = 0;
+
+    // L and U; a removed entry of U is marked by position -1 in UT
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:nnzL, nnzU)
+    for (magma_int_t i=0; i < n; i++) {
+        magma_int_t out = L->start[i];
+        for (magma_int_t e = L->start[i]; e < L->start[i] + L->len[i]; e++) {
+            if (L->col[e] == i || MAGMA_Z_ABS(L->val[e]) > thrsL) {
+                L->col[out] = L->col[e];
+                L->val[out] = L->val[e];
+                out++;
+            }
+        }
+        L->len[i] = out - L->start[i];
+        nnzL += L->len[i];
+
+        out = U->start[i];
+        for (magma_int_t e = U->start[i]; e < U->start[i] + U->len[i]; e++) {
+            if (U->col[e] == i || MAGMA_Z_ABS(U->val[e]) > thrsU) {
+                U->col[out] = U->col[e];
+                U->val[out] = U->val[e];
+                U->pos[out] = U->pos[e];
+                UT->pos[ U->pos[out] ] = out;
+                out++;
+            } else {
+                UT->pos[ U->pos[e] ] = -1;
+            }
+        }
+        U->len[i] = out - U->start[i];
+        nnzU += U->len[i];
+    }
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (magma_int_t i=0; i < n; i++) {
+        magma_int_t out = UT->start[i];
+        for (magma_int_t q = UT->start[i]; q < UT->start[i] + UT->len[i]; q++) {
+            if (UT->pos[q] >= 0) {
+                UT->col[out] = UT->col[q];
+                UT->pos[out] = UT->pos[q];
+                U->pos[ UT->pos[out] ] = out;
+                out++;
+            }
+        }
+        UT->len[i] = out - UT->start[i];
+    }
+
+    L->nnz = nnzL;
+    U->nnz = nnzU;
+    UT->nnz = nnzU;
+
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Copies the factors of the incremental ParILUT into L and U in sorted
+    CSR. The values of U are taken from its columns through the positions
+    of UT.
+
+    Arguments
+    ---------
+
+    @param[in]
+    F           magma_z_parilut_factors*
+                Factors, see magma_zparilut_inc_init.
+
+    @param[out]
+    L           magma_z_matrix*
+                Lower triangular factor in CSR; may be NULL.
+
+    @param[out]
+    U           magma_z_matrix*
+                Upper triangular factor in CSR; may be NULL.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparilut_inc_get(
+    magma_z_parilut_factors *F,
+    magma_z_matrix *L,
+    magma_z_matrix *U,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_int_t n = F->n;
+    magma_z_parilut_factor *X[2] = { &F->L, &F->UT };
+    magma_z_matrix *Y[2] = { L, U };
+
+    for (int k=0; k < 2; k++) {
+        magma_z_parilut_factor *Xk = X[k];
+        magma_z_matrix *B = Y[k];
+        if (B == NULL) {
+            continue;
+        }
+        magma_zmfree( B, queue );
+        B->num_rows = n;
+        B->num_cols = n;
+        B->nnz = Xk->nnz;
+        B->true_nnz = Xk->nnz;
+        B->storage_type = Magma_CSR;
+        B->memory_location = Magma_CPU;
+        CHECK( magma_index_malloc_cpu( &B->row, n+1 ));
+        CHECK( magma_index_malloc_cpu( &B->col, max( B->nnz, (magma_int_t) 1 )));
+        CHECK( magma_zmalloc_cpu( &B->val, max( B->nnz, (magma_int_t) 1 )));
+        B->row[0] = 0;
+        #pragma omp parallel for
+        for (magma_int_t i=0; i < n; i++) {
+            B->row[i+1] = Xk->len[i];
+        }
+        CHECK( magma_zmatrix_createrowptr( n, B->row, queue ));
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (magma_int_t i=0; i < n; i++) {
+            for (magma_int_t e=0; e < Xk->len[i]; e++) {
+                magma_int_t from = Xk->start[i] + e;
+                B->col[ B->row[i] + e ] = Xk->col[ from ];
+                B->val[ B->row[i] + e ] = ( k == 0 ) ? Xk->val[ from ]
+                                                     : F->U.val[ Xk->pos[ from ]];
+            }
+        }
+    }
+
+cleanup:
+    return info;
+}
+
+
+// frees the arrays of one factor
+static void
+magma_zparilut_inc_free_factor( magma_z_parilut_factor *X )
+{
+    magma_free_cpu( X->start );
+    magma_free_cpu( X->len );
+    magma_free_cpu( X->col );
+    magma_free_cpu( X->val );
+    magma_free_cpu( X->work );
+    magma_free_cpu( X->pos );
+    memset( X, 0, sizeof(magma_z_parilut_factor) );
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Frees the factors and the workspace of the incremental ParILUT.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    F           magma_z_parilut_factors*
+                Factors to free.
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+*******************************************************************************/
+
+extern "C" magma_int_t
+magma_zparilut_inc_free(
+    magma_z_parilut_factors *F,
+    magma_queue_t queue )
+{
+    magma_zparilut_inc_free_factor( &F->L );
+    magma_zparilut_inc_free_factor( &F->U );
+    magma_zparilut_inc_free_factor( &F->UT );
+    magma_zparilut_inc_free_factor( &F->C );
+    magma_zparilut_inc_free_factor( &F->CU );
+    magma_free_cpu( F->cnt );
+    magma_free_cpu( F->buf );
+    memset( F, 0, sizeof(magma_z_parilut_factors) );
+    return MAGMA_SUCCESS;
+}
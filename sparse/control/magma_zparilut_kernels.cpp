@@ -65,6 +65,11 @@ magma_zparilut_sweep(
     magma_queue_t queue)
 {
     magma_int_t info = 0;
+
+    // the values are rewritten, drop the reduced-precision copies
+    magma_zmlowprec_free( L, queue );
+    magma_zmlowprec_free( U, queue );
+
     #pragma omp parallel for
     for (magma_int_t e=0; e<L->nnz; e++) {
 
@@ -211,6 +216,11 @@ magma_zparilut_sweep_sync(
     magma_queue_t queue)
 {
     magma_int_t info = 0;
+
+    // the values are rewritten, drop the reduced-precision copies
+    magma_zmlowprec_free( L, queue );
+    magma_zmlowprec_free( U, queue );
+
     magmaDoubleComplex *L_new_val = NULL, *U_new_val = NULL, *val_swap = NULL;
     CHECK(magma_zmalloc_cpu(&L_new_val, L->nnz));
     CHECK(magma_zmalloc_cpu(&U_new_val, U->nnz));
@@ -21,6 +21,11 @@
 #define AVOID_DUPLICATES
 //#define NANCHECK
 
+// threshold selection: fixed seed for reproducible thresholds, the approximate
+// variants accept a rank error of num_rm/PARILUT_SELECT_TOL
+#define PARILUT_SELECT_SEED 352302
+#define PARILUT_SELECT_TOL  100
+
 // this file is marked as deprecated, and will be removed in future.
 
 
@@ -4446,6 +4451,8 @@ cleanup:
     Purpose
     -------
     This routine approximates the threshold for removing num_rm elements.
+    The rank of the threshold is accurate up to num_rm/PARILUT_SELECT_TOL
+    elements, see magma_zsampleselect_cpu.
 
     Arguments
     ---------
@@ -4483,55 +4490,12 @@ magma_zparilut_set_approx_thrs(
 {
     magma_int_t info = 0;
     
-    magma_int_t sample_size =  8192;
-    
-    magmaDoubleComplex element;
-    magmaDoubleComplex *val=NULL;
-    const magma_int_t incy = 1;
-    const magma_int_t incx = (int) (LU->nnz)/(sample_size);
-    magma_int_t loc_nnz;
-    double ratio;
-    magma_int_t loc_num_rm;
-    magma_int_t num_threads=1;
-    magmaDoubleComplex *elements = NULL;
-    magma_int_t lsize;
-    magma_int_t lnum_rm;
-    magmaDoubleComplex *lval;
-
-#ifdef _OPENMP
-    #pragma omp parallel
-    {
-        num_threads = omp_get_max_threads();
-    }
-#else
-    num_threads = 1;
-#endif
-     num_threads = 1;
-    loc_nnz = (int) LU->nnz/incx;
-    ratio = ((double)num_rm)/((double)LU->nnz);
-    loc_num_rm = (int) ((double)ratio*(double)loc_nnz);
-    CHECK( magma_zmalloc_cpu( &val, loc_nnz ));
-    blasf77_zcopy(&loc_nnz, LU->val, &incx, val, &incy );
-       
-    lsize = loc_nnz/num_threads;
-    lnum_rm = loc_num_rm/num_threads;
-
-    lval = val;
-    // compare with random select
-    if( order == 0 ){
-        magma_zselectrandom( lval, lsize, lnum_rm, queue );
-        element = (lval[lnum_rm]);
-    } else {
-         magma_zselectrandom( lval, lsize, lsize-lnum_rm, queue );
-        element = (lval[lsize-lnum_rm]);  
-    }
-               
-
-    *thrs = MAGMA_Z_ABS(element);
+    assert( LU->nnz > num_rm );
+    CHECK( magma_zsampleselect_cpu( LU->nnz, LU->val, 
+                ( order == 0 ) ? num_rm : LU->nnz-num_rm, 
+                num_rm/PARILUT_SELECT_TOL, PARILUT_SELECT_SEED, thrs, NULL, queue ));
 
 cleanup:
-    magma_free_cpu( val );
-    magma_free_cpu( elements );
     return info;
 }
 
@@ -4540,7 +4504,8 @@ cleanup:
 /***************************************************************************//**
     Purpose
     -------
-    This routine approximates the threshold for removing num_rm elements.
+    This routine computes the threshold for removing num_rm elements.
+    The selection is exact, see magma_zsampleselect_cpu.
 
     Arguments
     ---------
@@ -4578,23 +4543,12 @@ magma_zparilut_set_thrs_randomselect(
 {
     magma_int_t info = 0;
     
-    magma_int_t size =  LU->nnz;
-    const magma_int_t incx = 1;
-    // copy as we may change the elements
-    magmaDoubleComplex *val=NULL;
-    CHECK( magma_zmalloc_cpu( &val, size ));
-    assert( size > num_rm );
-    blasf77_zcopy(&size, LU->val, &incx, val, &incx );
-    if( order == 0 ){
-        magma_zselectrandom( val, size, num_rm, queue );
-        *thrs = MAGMA_Z_ABS(val[num_rm]);
-    } else {
-         magma_zselectrandom( val, size, size-num_rm, queue );
-        *thrs = MAGMA_Z_ABS(val[size-num_rm]);  
-    }
+    assert( LU->nnz > num_rm );
+    CHECK( magma_zsampleselect_cpu( LU->nnz, LU->val, 
+                ( order == 0 ) ? num_rm : LU->nnz-num_rm, 
+                0, PARILUT_SELECT_SEED, thrs, NULL, queue ));
 
 cleanup:
-    magma_free_cpu( val );
     return info;
 }
 
@@ -4602,7 +4556,8 @@ cleanup:
 /***************************************************************************//**
     Purpose
     -------
-    This routine approximates the threshold for removing num_rm elements.
+    This routine computes the threshold for removing num_rm elements.
+    The selection is exact, see magma_zsampleselect_cpu.
     It takes into account the scaling with the diagonal.
 
     Arguments
@@ -4646,23 +4601,12 @@ magma_zparilut_set_thrs_L_scaled(
 {
     magma_int_t info = 0;
     
-    magma_int_t size =  L->nnz;
-    const magma_int_t incx = 1;
-    // copy as we may change the elements
-    magmaDoubleComplex *val=NULL;
-    CHECK( magma_zmalloc_cpu( &val, size ));
-    assert( size > num_rm );
-    blasf77_zcopy(&size, L->val, &incx, val, &incx );
-    if( order == 0 ){
-        magma_zselectrandom( val, size, num_rm, queue );
-        *thrs = MAGMA_Z_ABS(val[num_rm]);
-    } else {
-         magma_zselectrandom( val, size, size-num_rm, queue );
-        *thrs = MAGMA_Z_ABS(val[size-num_rm]);  
-    }
+    assert( L->nnz > num_rm );
+    CHECK( magma_zsampleselect_cpu( L->nnz, L->val, 
+                ( order == 0 ) ? num_rm : L->nnz-num_rm, 
+                0, PARILUT_SELECT_SEED, thrs, NULL, queue ));
 
 cleanup:
-    magma_free_cpu( val );
     return info;
 }
 
@@ -4673,6 +4617,8 @@ cleanup:
     Purpose
     -------
     This routine approximates the threshold for removing num_rm elements.
+    The rank of the threshold is accurate up to num_rm/PARILUT_SELECT_TOL
+    elements, see magma_zsampleselect_cpu.
 
     Arguments
     ---------
@@ -4710,42 +4656,12 @@ magma_zparilut_set_thrs_randomselect_approx2(
 {
     magma_int_t info = 0;
     
-    magma_int_t size =  LU->nnz;
-    const magma_int_t incx = 1;
-    magma_int_t incy = 1;
-    // magma_int_t nz_copy = LU->nnz;
-    // copy as we may change the elements
-    magmaDoubleComplex *val=NULL;
-    magma_int_t subset = num_rm *10;
-    if(LU->nnz <=subset){
-        CHECK( magma_zmalloc_cpu( &val, size ));
-        assert( size > num_rm );
-        blasf77_zcopy(&size, LU->val, &incx, val, &incx );
-        if( order == 0 ){
-            magma_zselectrandom( val, size, num_rm, queue );
-            *thrs = MAGMA_Z_ABS(val[num_rm]);
-        } else {
-             magma_zselectrandom( val, size, size-num_rm, queue );
-            *thrs = MAGMA_Z_ABS(val[size-num_rm]);  
-        }
-    } else {
-        incy = LU->nnz/subset;
-        size = subset;
-        magma_int_t num_rm_loc = 10;
-        assert( size > num_rm_loc );
-        CHECK( magma_zmalloc_cpu( &val, size ));
-        blasf77_zcopy(&size, LU->val, &incy, val, &incx );
-        if( order == 0 ){
-            magma_zselectrandom( val, size, num_rm_loc, queue );
-            *thrs = MAGMA_Z_ABS(val[num_rm_loc]);
-        } else {
-             magma_zselectrandom( val, size, size-num_rm_loc, queue );
-            *thrs = MAGMA_Z_ABS(val[size-num_rm_loc]);  
-        }
-    }
+    assert( LU->nnz > num_rm );
+    CHECK( magma_zsampleselect_cpu( LU->nnz, LU->val, 
+                ( order == 0 ) ? num_rm : LU->nnz-num_rm, 
+                num_rm/PARILUT_SELECT_TOL, PARILUT_SELECT_SEED, thrs, NULL, queue ));
 
 cleanup:
-    magma_free_cpu( val );
     return info;
 }
 
@@ -4753,6 +4669,8 @@ cleanup:
     Purpose
     -------
     This routine approximates the threshold for removing num_rm elements.
+    The rank of the threshold is accurate up to num_rm/PARILUT_SELECT_TOL
+    elements, see magma_zsampleselect_cpu.
 
     Arguments
     ---------
@@ -4790,71 +4708,12 @@ magma_zparilut_set_thrs_randomselect_approx(
 {
     magma_int_t info = 0;
     
-    magma_int_t size =  LU->nnz;
-    const magma_int_t incx = 1;
-    //magma_int_t incy = 1;
-    //magma_int_t nz_copy = LU->nnz;
-    magma_int_t num_threads = 1;
-    magma_int_t el_per_block;
-    //magma_int_t num_rm_loc;
-    magmaDoubleComplex *dthrs;
-    magmaDoubleComplex *val;
-    
-
-    if( LU->nnz <= 680){
-       CHECK( magma_zparilut_set_thrs_randomselect(
-           num_rm,
-           LU,
-           order,
-           thrs,
-           queue ) );
-    } else {
-        CHECK( magma_zmalloc_cpu( &val, size ));
-        blasf77_zcopy(&size, LU->val, &incx, val, &incx );
-        assert( size > num_rm );
-#ifdef _OPENMP
-    #pragma omp parallel
-    {
-        num_threads = omp_get_max_threads();
-    }
-#else
-    num_threads = 1;
-#endif
-        num_threads = 272;
-        CHECK( magma_zmalloc_cpu( &dthrs, num_threads ));
-        
-        
-        el_per_block = magma_ceildiv( LU->nnz, num_threads );
-        
-        #pragma omp parallel for
-        for( magma_int_t i=0; i<num_threads; i++ ){
-            magma_int_t start = min(i*el_per_block, size);
-            magma_int_t end = min((i+1)*el_per_block,LU->nnz);
-            magma_int_t loc_nz = end-start;
-            magma_int_t loc_rm = (int) (num_rm)/num_threads;
-            if( i == num_threads-1){
-                loc_rm = (int) (loc_nz * num_rm)/size;
-            }
-            if( loc_nz > loc_rm ){
-            if( order == 0 ){
-                magma_zselectrandom( val+start, loc_nz, loc_rm, queue );
-                dthrs[i] = val[start+loc_rm];
-            } else {
-                 magma_zselectrandom( val+start, loc_nz, loc_nz-loc_rm, queue );
-                dthrs[i] = val[start+loc_nz-loc_rm];  
-            }
-        }
-            
-        }
-        
-        // compute the median
-        magma_zselectrandom( dthrs, num_threads, (num_threads+1)/2, queue);
-        
-        *thrs = MAGMA_Z_ABS(dthrs[(num_threads+1)/2]);
-    }
+    assert( LU->nnz > num_rm );
+    CHECK( magma_zsampleselect_cpu( LU->nnz, LU->val, 
+                ( order == 0 ) ? num_rm : LU->nnz-num_rm, 
+                num_rm/PARILUT_SELECT_TOL, PARILUT_SELECT_SEED, thrs, NULL, queue ));
+
 cleanup:
-    magma_free_cpu( val );
-    magma_free_cpu( dthrs );
     return info;
 }
 
@@ -4862,7 +4721,9 @@ cleanup:
 /***************************************************************************//**
     Purpose
     -------
-    This routine approximates the threshold for removing num_rm elements.
+    This routine computes the threshold for removing num_rm elements of
+    the factors L and U together. The selection is exact, see
+    magma_zsampleselect2_cpu.
 
     Arguments
     ---------
@@ -4872,8 +4733,12 @@ cleanup:
                 Number of Elements that are replaced.
 
     @param[in]
-    LU          magma_z_matrix*
-                Current ILU approximation.
+    L           magma_z_matrix*
+                Current L approximation.
+
+    @param[in]
+    U           magma_z_matrix*
+                Current U approximation.
 
     @param[in]
     order       magma_int_t
@@ -4902,23 +4767,12 @@ magma_zparilut_set_thrs_randomselect_factors(
     magma_int_t info = 0;
     
     magma_int_t size =  L->nnz+U->nnz;
-    const magma_int_t incx = 1;
-    // copy as we may change the elements
-    magmaDoubleComplex *val=NULL;
-    CHECK( magma_zmalloc_cpu( &val, size ));
     assert( size > num_rm );
-    blasf77_zcopy(&L->nnz, L->val, &incx, val, &incx );
-    blasf77_zcopy(&U->nnz, U->val, &incx, val+L->nnz, &incx );
-    if( order == 0 ){
-        magma_zselectrandom( val, size, num_rm, queue );
-        *thrs = MAGMA_Z_ABS(val[num_rm]);
-    } else {
-         magma_zselectrandom( val, size, size-num_rm, queue );
-        *thrs = MAGMA_Z_ABS(val[size-num_rm]);  
-    }
+    CHECK( magma_zsampleselect2_cpu( L->nnz, L->val, U->nnz, U->val, 
+                ( order == 0 ) ? num_rm : size-num_rm, 
+                0, PARILUT_SELECT_SEED, thrs, NULL, queue ));
 
 cleanup:
-    magma_free_cpu( val );
     return info;
 }
 
@@ -4964,67 +4818,15 @@ magma_zparilut_set_exact_thrs(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
-    magmaDoubleComplex element;
-    magmaDoubleComplex *val=NULL;
-    const magma_int_t incy = 1;
-    const magma_int_t incx = 1;
-    magma_int_t loc_nnz;
-    double ratio;
-    magma_int_t loc_num_rm;
-    magma_int_t num_threads=1;
-    magmaDoubleComplex *elements = NULL;
-
-#ifdef _OPENMP
-    #pragma omp parallel
-    {
-        num_threads = omp_get_max_threads();
-    }
-#else
-    num_threads = 1;
-#endif
-    // two options: either there are enough candidates such that we can use
-    // a parallel first step of order-statistics, or not...
-    
-    ratio = ((double)num_rm)/((double)LU->nnz);
-    loc_num_rm = (int) ((double)ratio*(double)loc_nnz);
-    loc_num_rm = num_rm;
-    CHECK( magma_zmalloc_cpu( &val, loc_nnz ));
-    CHECK( magma_zmalloc_cpu( &elements, num_threads ));
-    
-    blasf77_zcopy(&loc_nnz, LU->val, &incx, val, &incy );
-    // first step: every thread sorts a chunk of the array
-    // extract the num_rm elements in this chunk
-    // this only works if num_rm > loc_nnz / num_threads
-    if( loc_nnz / num_threads > loc_num_rm ){
-        #pragma omp parallel
-        {
-    #ifdef _OPENMP
-    magma_int_t id = omp_get_thread_num();
-#else
-    magma_int_t id = 0;
-#endif
-            if(id<num_threads){
-                magma_zorderstatistics(
-                    val + id*loc_nnz/num_threads, loc_nnz/num_threads, loc_num_rm, order, &elements[id], queue );
-            }
-        }
-        // Now copy the num_rm left-most elements of every chunk to the beginning of the array.
-        for( magma_int_t i=1; i<num_threads; i++){
-            blasf77_zcopy(&loc_num_rm, val+i*loc_nnz/num_threads, &incy, val+i*loc_num_rm, &incy );
-        }
-        // now we only look at the left num_threads*num_rm elements and use order stats
-        magma_zorderstatistics(
-                    val, num_threads*loc_num_rm, loc_num_rm, order, &element, queue );
-    } else {
-        magma_zorderstatistics(
-                    val, loc_nnz, loc_num_rm, order, &element, queue );
-    }
-
-    *thrs = element;
+    double element = 0.0;
+    
+    assert( LU->nnz > num_rm );
+    CHECK( magma_zsampleselect_cpu( LU->nnz, LU->val, 
+                ( order == 0 ) ? num_rm : LU->nnz-num_rm, 
+                0, PARILUT_SELECT_SEED, &element, NULL, queue ));
+    *thrs = MAGMA_Z_MAKE( element, 0.0 );
 
 cleanup:
-    magma_free_cpu( val );
-    magma_free_cpu( elements );
     return info;
 }
 
@@ -5034,7 +4836,9 @@ cleanup:
 /***************************************************************************//**
     Purpose
     -------
-    This routine provides the exact threshold for removing num_rm elements.
+    This routine approximates the threshold for removing num_rm elements.
+    The rank of the threshold is accurate up to num_rm/PARILUT_SELECT_TOL
+    elements, see magma_zsampleselect_cpu.
 
     Arguments
     ---------
@@ -5071,43 +4875,15 @@ magma_zparilut_set_approx_thrs_inc(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
-    magmaDoubleComplex element;
-    magmaDoubleComplex *val=NULL;
-    const magma_int_t incy = 1;
-    const magma_int_t incx = (int) (LU->nnz)/(1024);
-    magma_int_t loc_nnz;
-    magma_int_t inc = 100;
-    magma_int_t offset = 10;
-    double ratio;
-    magma_int_t loc_num_rm = num_rm;
-    // magma_int_t num_threads=1;
-    magmaDoubleComplex *elements = NULL;
-    magma_int_t avg_count = 100;
-    loc_nnz = (int) LU->nnz/incx;
-    ratio = ((double)num_rm)/((double)LU->nnz);
-    loc_num_rm = (int) ((double)ratio*(double)loc_nnz);
-    
-    
-    CHECK( magma_zmalloc_cpu( &elements, avg_count ));
-    
-    CHECK( magma_zmalloc_cpu( &val, loc_nnz ));
-    blasf77_zcopy(&loc_nnz, LU->val, &incx, val, &incy );
-    for( magma_int_t i=1; i<avg_count; i++){
-        magma_zorderstatistics_inc(
-                    val + offset*i, loc_nnz - offset*i, loc_num_rm/inc, inc, order, &elements[i], queue );
-    }
-    
-    
-    element = MAGMA_Z_ZERO;
-    for( int z=0; z < avg_count; z++){
-        element = element+MAGMA_Z_MAKE(MAGMA_Z_ABS(elements[z]), 0.0);
-    }
-    element = element/MAGMA_Z_MAKE((double)avg_count, 0.0);
+    double element = 0.0;
     
-    *thrs = element;
+    assert( LU->nnz > num_rm );
+    CHECK( magma_zsampleselect_cpu( LU->nnz, LU->val, 
+                ( order == 0 ) ? num_rm : LU->nnz-num_rm, 
+                num_rm/PARILUT_SELECT_TOL, PARILUT_SELECT_SEED, &element, NULL, queue ));
+    *thrs = MAGMA_Z_MAKE( element, 0.0 );
+
 cleanup:
-    magma_free_cpu( val );
-    magma_free_cpu( elements );
     return info;
 }
 
@@ -182,6 +182,92 @@ cleanup:
     return info;
 }
 
+/**
+    Purpose
+    -------
+
+    Estimates the nonlinear residual || A - LU ||_F restricted to the sparsity
+    pattern of A without forming the product LU. Only every stride-th nonzero
+    of A is evaluated, the sampled sum of squares is extrapolated to nnz(A).
+    For stride = 1 the result is exact. The factors are expected in the
+    layout used by the ParILU sweeps (L in CSR, U in CSC), A in CSRCOO.
+
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input sparse matrix in CSRCOO
+
+    @param[in]
+    L           magma_z_matrix
+                lower triangular factor in CSR, unit diagonal stored
+
+    @param[in]
+    U           magma_z_matrix
+                upper triangular factor in CSC (U^T in CSR)
+
+    @param[in]
+    stride      magma_int_t
+                sampling distance in the nonzero array of A
+
+    @param[out]
+    res         real_Double_t*
+                estimated Frobenius norm of A - LU on the pattern of A
+                
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+magma_int_t
+magma_zparilu_sampledres(
+    magma_z_matrix A,
+    magma_z_matrix L,
+    magma_z_matrix U,
+    magma_int_t stride,
+    real_Double_t *res,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    real_Double_t sum = 0.0;
+    magma_int_t num_samples;
+    
+    stride = ( stride < 1 ) ? 1 : stride;
+    num_samples = magma_ceildiv( A.nnz, stride );
+
+    #pragma omp parallel for reduction(+:sum)
+    for (magma_int_t s=0; s < num_samples; s++) {
+        magma_int_t k = s * stride;
+        magma_index_t i = A.rowidx[k];
+        magma_index_t j = A.col[k];
+        magma_index_t il = L.row[i];
+        magma_index_t iu = U.row[j];
+        magmaDoubleComplex r = A.val[k];
+        
+        while (il < L.row[i+1] && iu < U.row[j+1]) {
+            magma_index_t jl = L.col[il];
+            magma_index_t ju = U.col[iu];
+            if (jl == ju) {
+                r = r - L.val[il] * U.val[iu];
+            }
+            il = ( jl <= ju ) ? il+1 : il;
+            iu = ( jl >= ju ) ? iu+1 : iu;
+        }
+        real_Double_t tmp = MAGMA_Z_ABS( r );
+        sum += tmp * tmp;
+    }
+    
+    *res = ( num_samples > 0 ) ?
+        sqrt( sum * (real_Double_t) A.nnz / (real_Double_t) num_samples ) : 0.0;
+    
+    return info;
+}
+
+
 /**
     Purpose
     -------
@@ -0,0 +1,529 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include <algorithm>
+#include <new>
+#include <vector>
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// default levels of overlap
+#define SCHWARZ_OVERLAP 1
+// default bound for subdomains factorized as dense LU, larger ones use ILU(0)
+#define SCHWARZ_DENSE_MAX 512
+
+
+/*
+    Host restricted additive Schwarz (RAS) preconditioner.
+
+    The rows are partitioned into subdomains of balanced nonzero count,
+    either contiguously in the natural order (Magma_NOREORDER) or along a
+    reverse Cuthill-McKee ordering (Magma_RCM), which gives connected
+    subdomains for any numbering of the unknowns. Every subdomain is
+    extended by precond->overlap levels of neighbors in the graph of A, the
+    local matrix is extracted and factorized: dense LU for subdomains of up
+    to precond->bsize rows (default 512), ILU(0) otherwise. Setup and
+    application are parallel over the subdomains, by default one per
+    thread. The application is
+
+        x = sum_i R~_i^T A_i^{-1} R_i b,
+
+    where R_i restricts to the overlapping rows of subdomain i and R~_i to
+    the rows it owns, i.e. every subdomain solves on its overlapping rows but
+    writes only the rows it owns, so no synchronization between the
+    subdomains is needed.
+*/
+
+
+// ILU(0) factorization in place of the local CSR matrix A with ascending
+// column indices; zero pivots are replaced by one. Returns their number.
+static magma_int_t
+magma_zschwarz_ilu0(
+    magma_z_matrix A,
+    magma_index_t *diag,
+    magma_index_t *pos )
+{
+    magma_int_t n = A.num_rows, num_zero = 0;
+
+    for( magma_int_t j=0; j<n; j++ ){
+        pos[j] = -1;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            pos[ A.col[k] ] = k;
+        }
+        for( magma_int_t k=A.row[i]; k<A.row[i+1] && A.col[k] < i; k++ ){
+            magma_index_t c = A.col[k];
+            A.val[k] = A.val[k] / A.val[ diag[c] ];
+            for( magma_int_t l=diag[c]+1; l<A.row[c+1]; l++ ){
+                if( pos[ A.col[l] ] >= 0 ){
+                    A.val[ pos[ A.col[l] ] ] = A.val[ pos[ A.col[l] ] ]
+                                                - A.val[k] * A.val[l];
+                }
+            }
+        }
+        if( MAGMA_Z_ABS( A.val[ diag[i] ] ) == 0.0 ){
+            A.val[ diag[i] ] = MAGMA_Z_ONE;
+            num_zero++;
+        }
+        for( magma_int_t k=A.row[i]; k<A.row[i+1]; k++ ){
+            pos[ A.col[k] ] = -1;
+        }
+    }
+    return num_zero;
+}
+
+
+// x = (LU)^{-1} x with the ILU(0) factors stored in A
+static void
+magma_zschwarz_ilu0_solve(
+    magma_z_matrix A,
+    const magma_index_t *diag,
+    magmaDoubleComplex *x )
+{
+    magma_int_t n = A.num_rows;
+
+    for( magma_int_t i=0; i<n; i++ ){
+        magmaDoubleComplex s = x[i];
+        for( magma_int_t k=A.row[i]; k<diag[i]; k++ ){
+            s = s - A.val[k] * x[ A.col[k] ];
+        }
+        x[i] = s;
+    }
+    for( magma_int_t i=n-1; i>=0; i-- ){
+        magmaDoubleComplex s = x[i];
+        for( magma_int_t k=diag[i]+1; k<A.row[i+1]; k++ ){
+            s = s - A.val[k] * x[ A.col[k] ];
+        }
+        x[i] = s / A.val[ diag[i] ];
+    }
+}
+
+
+// subdomain d: rows rows[0..num_rows) (ascending) extended by overlap levels,
+// local matrix and its factorization. Returns nonzero on allocation failure;
+// num_zero counts zero pivots replaced in the factorization.
+static magma_int_t
+magma_zschwarz_domain_setup(
+    magma_z_matrix A,
+    const magma_index_t *rows,
+    magma_int_t num_rows,
+    magma_int_t overlap,
+    magma_int_t dense_max,
+    magma_z_schwarz_domain *dom,
+    magma_int_t *num_zero )
+{
+    magma_int_t info = 0;
+    magma_int_t n, nnz = 0, linfo = 0;
+    magma_index_t *pos = NULL;
+
+    try {
+        // overlap: add the neighbors of the last level, one level at a time
+        std::vector<magma_index_t> cur( rows, rows+num_rows ), front( cur ), next, merged;
+        for( magma_int_t lev=0; lev<overlap && !front.empty(); lev++ ){
+            next.clear();
+            for( size_t k=0; k<front.size(); k++ ){
+                for( magma_int_t j=A.row[ front[k] ]; j<A.row[ front[k]+1 ]; j++ ){
+                    next.push_back( A.col[j] );
+                }
+            }
+            std::sort( next.begin(), next.end() );
+            next.erase( std::unique( next.begin(), next.end() ), next.end() );
+            front.clear();
+            std::set_difference( next.begin(), next.end(), cur.begin(), cur.end(),
+                                 std::back_inserter( front ));
+            merged.clear();
+            std::merge( cur.begin(), cur.end(), front.begin(), front.end(),
+                        std::back_inserter( merged ));
+            cur.swap( merged );
+        }
+        n = cur.size();
+        dom->n = n;
+        dom->num_owned = num_rows;
+        CHECK( magma_index_malloc_cpu( &dom->idx, n+1 ));
+        CHECK( magma_index_malloc_cpu( &dom->owned, num_rows+1 ));
+        CHECK( magma_zmalloc_cpu( &dom->x, n+1 ));
+        for( magma_int_t i=0; i<n; i++ ){
+            dom->idx[i] = cur[i];
+        }
+        for( magma_int_t i=0; i<num_rows; i++ ){
+            dom->owned[i] = std::lower_bound( cur.begin(), cur.end(), rows[i] )
+                            - cur.begin();
+        }
+    }
+    catch( std::bad_alloc& ){
+        info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+
+    // local matrix: the entries of the subdomain rows within the subdomain,
+    // plus an explicit zero diagonal entry where A stores none
+    dom->A.storage_type = Magma_CSR;
+    dom->A.memory_location = Magma_CPU;
+    dom->A.num_rows = n;
+    dom->A.num_cols = n;
+    dom->A.ownership = MagmaTrue;
+    CHECK( magma_index_malloc_cpu( &dom->A.row, n+1 ));
+    CHECK( magma_index_malloc_cpu( &pos, n+1 ));
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_index_t g = dom->idx[i];
+        bool has_diag = false;
+        dom->A.row[i] = nnz;
+        for( magma_int_t j=A.row[g]; j<A.row[g+1]; j++ ){
+            magma_index_t *p = std::lower_bound( dom->idx, dom->idx+n, A.col[j] );
+            if( p != dom->idx+n && *p == A.col[j] ){
+                nnz++;
+                has_diag = has_diag || A.col[j] == g;
+            }
+        }
+        if( ! has_diag ){
+            nnz++;
+        }
+    }
+    dom->A.row[n] = nnz;
+    dom->A.nnz = nnz;
+    CHECK( magma_index_malloc_cpu( &dom->A.col, nnz+1 ));
+    CHECK( magma_zmalloc_cpu( &dom->A.val, nnz+1 ));
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_index_t g = dom->idx[i], k = dom->A.row[i];
+        for( magma_int_t j=A.row[g]; j<A.row[g+1]; j++ ){
+            magma_index_t *p = std::lower_bound( dom->idx, dom->idx+n, A.col[j] );
+            if( p != dom->idx+n && *p == A.col[j] ){
+                dom->A.col[k] = p - dom->idx;
+                dom->A.val[k] = A.val[j];
+                k++;
+            }
+        }
+        if( k < dom->A.row[i+1] ){
+            dom->A.col[k] = i;
+            dom->A.val[k] = MAGMA_Z_ZERO;
+        }
+        // ascending local column indices (insertion sort, rows are short)
+        for( magma_int_t j=dom->A.row[i]+1; j<dom->A.row[i+1]; j++ ){
+            magma_index_t c = dom->A.col[j];
+            magmaDoubleComplex v = dom->A.val[j];
+            magma_int_t l = j-1;
+            while( l >= dom->A.row[i] && dom->A.col[l] > c ){
+                dom->A.col[l+1] = dom->A.col[l];
+                dom->A.val[l+1] = dom->A.val[l];
+                l--;
+            }
+            dom->A.col[l+1] = c;
+            dom->A.val[l+1] = v;
+        }
+    }
+
+    // dense LU for small subdomains
+    if( n <= dense_max ){
+        CHECK( magma_zmalloc_cpu( &dom->lu, n*n ));
+        CHECK( magma_imalloc_cpu( &dom->ipiv, n ));
+        for( magma_int_t e=0; e<n*n; e++ ){
+            dom->lu[e] = MAGMA_Z_ZERO;
+        }
+        for( magma_int_t i=0; i<n; i++ ){
+            for( magma_int_t k=dom->A.row[i]; k<dom->A.row[i+1]; k++ ){
+                dom->lu[ i + dom->A.col[k]*n ] = dom->A.val[k];
+            }
+        }
+        lapackf77_zgetrf( &n, &n, dom->lu, &n, dom->ipiv, &linfo );
+        if( linfo == 0 ){
+            magma_zmfree( &dom->A, NULL );
+            goto cleanup;
+        }
+        // singular subdomain matrix: use ILU(0) instead
+        magma_free_cpu( dom->lu );
+        magma_free_cpu( dom->ipiv );
+        dom->lu = NULL;
+        dom->ipiv = NULL;
+    }
+
+    // ILU(0), every row has a diagonal entry
+    CHECK( magma_index_malloc_cpu( &dom->diag, n+1 ));
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t k=dom->A.row[i]; k<dom->A.row[i+1]; k++ ){
+            if( dom->A.col[k] == i ){
+                dom->diag[i] = k;
+            }
+        }
+    }
+    *num_zero += magma_zschwarz_ilu0( dom->A, dom->diag, pos );
+
+cleanup:
+    magma_free_cpu( pos );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Releases the subdomains of the host restricted additive Schwarz
+    preconditioner.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zschwarzfree_cpu(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    if( precond->schwarz_domains != NULL ){
+        for( magma_int_t d=0; d<precond->schwarz_num_domains; d++ ){
+            magma_z_schwarz_domain *dom = precond->schwarz_domains + d;
+            magma_zmfree( &dom->A, queue );
+            magma_free_cpu( dom->idx );
+            magma_free_cpu( dom->owned );
+            magma_free_cpu( dom->diag );
+            magma_free_cpu( dom->lu );
+            magma_free_cpu( dom->ipiv );
+            magma_free_cpu( dom->x );
+        }
+        magma_free_cpu( precond->schwarz_domains );
+    }
+    precond->schwarz_domains = NULL;
+    precond->schwarz_num_domains = 0;
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Prepares the host restricted additive Schwarz preconditioner. The rows
+    are split into precond->subdomains subdomains (default: one per thread)
+    of balanced nonzero count, contiguously (precond->partition =
+    Magma_NOREORDER) or along a reverse Cuthill-McKee ordering (Magma_RCM).
+    Each subdomain is extended by precond->overlap levels of neighbors
+    (default 1) and factorized in parallel, by dense LU if it has at most
+    precond->bsize rows (default 512), by ILU(0) otherwise.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zschwarzsetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hA={Magma_CSR}, hACSR={Magma_CSR};
+    magma_index_t *perm = NULL, *start = NULL;
+    magma_int_t n, nd, overlap, dense_max, num_zero = 0, num_failed = 0;
+
+    overlap = ( precond->overlap >= 0 ) ? precond->overlap : SCHWARZ_OVERLAP;
+    dense_max = ( precond->bsize > 0 ) ? precond->bsize : SCHWARZ_DENSE_MAX;
+
+    CHECK( magma_zschwarzfree_cpu( precond, queue ));
+    CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmconvert( hA, &hACSR, hA.storage_type, Magma_CSR, queue ));
+    n = hACSR.num_rows;
+
+    nd = precond->subdomains;
+    if( nd <= 0 ){
+        nd = 1;
+        #ifdef _OPENMP
+        nd = omp_get_max_threads();
+        #endif
+    }
+    nd = max( 1, min( nd, n ));
+
+    // partition: consecutive pieces of the (reordered) rows with balanced
+    // nonzero count, every subdomain gets at least one row
+    if( precond->partition == Magma_RCM ){
+        CHECK( magma_zmreorder_rcm( hACSR, &perm, queue ));
+    } else {
+        CHECK( magma_index_malloc_cpu( &perm, n+1 ));
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<n; i++ ){
+            perm[i] = i;
+        }
+    }
+    CHECK( magma_index_malloc_cpu( &start, nd+1 ));
+    {
+        magma_int_t d = 1, nnz = 0;
+        start[0] = 0;
+        for( magma_int_t k=0; k<n && d<nd; k++ ){
+            nnz += hACSR.row[ perm[k]+1 ] - hACSR.row[ perm[k] ];
+            if( (int64_t) nnz * nd >= (int64_t) hACSR.nnz * d || n-(k+1) == nd-d ){
+                start[ d++ ] = k+1;
+            }
+        }
+        start[nd] = n;
+    }
+    // the owned rows of each subdomain in ascending order
+    #pragma omp parallel for schedule(dynamic,1)
+    for( magma_int_t d=0; d<nd; d++ ){
+        std::sort( perm+start[d], perm+start[d+1] );
+    }
+
+    CHECK( magma_malloc_cpu( (void**) &precond->schwarz_domains,
+                             nd * sizeof(magma_z_schwarz_domain) ));
+    precond->schwarz_num_domains = nd;
+    for( magma_int_t d=0; d<nd; d++ ){
+        magma_z_schwarz_domain *dom = precond->schwarz_domains + d;
+        magma_z_matrix empty={Magma_CSR};
+        dom->n = 0;
+        dom->num_owned = 0;
+        dom->idx = NULL;
+        dom->owned = NULL;
+        dom->A = empty;
+        dom->diag = NULL;
+        dom->lu = NULL;
+        dom->ipiv = NULL;
+        dom->x = NULL;
+    }
+
+    #pragma omp parallel for schedule(dynamic,1) reduction(+:num_zero,num_failed)
+    for( magma_int_t d=0; d<nd; d++ ){
+        magma_int_t dzero = 0;
+        if( magma_zschwarz_domain_setup( hACSR, perm+start[d], start[d+1]-start[d],
+                overlap, dense_max, precond->schwarz_domains + d, &dzero ) != 0 ){
+            num_failed++;
+        }
+        num_zero += dzero;
+    }
+    if( num_failed > 0 ){
+        info = MAGMA_ERR_HOST_ALLOC;
+        goto cleanup;
+    }
+    if( num_zero > 0 ){
+        printf("%% warning: %lld zero pivots in the subdomain ILU(0), replaced by one.\n",
+               (long long) num_zero );
+    }
+
+    // host work vectors for staging device vectors
+    magma_zmfree( &precond->work1, queue );
+    magma_zmfree( &precond->work2, queue );
+    CHECK( magma_zvinit( &precond->work1, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+    CHECK( magma_zvinit( &precond->work2, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+
+cleanup:
+    if( info != 0 ){
+        magma_zschwarzfree_cpu( precond, queue );
+    }
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &hACSR, queue );
+    magma_free_cpu( perm );
+    magma_free_cpu( start );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Applies the host restricted additive Schwarz preconditioner,
+    x = sum_i R~_i^T A_i^{-1} R_i b. The subdomains are solved
+    concurrently. Vectors on the device are staged through the host work
+    vectors of the preconditioner. x and b must be different vectors.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[out]
+    x           magma_z_matrix*
+                preconditioned vector
+
+    @param[in]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplyschwarz_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    const magmaDoubleComplex *bv = b.val;
+    magmaDoubleComplex *xv = x->val;
+
+    if( precond->schwarz_domains == NULL ){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if( b.memory_location != Magma_CPU ){
+        magma_zgetvector( b.num_rows, b.dval, 1, precond->work1.val, 1, queue );
+        bv = precond->work1.val;
+        xv = precond->work2.val;
+    }
+
+    #pragma omp parallel for schedule(dynamic,1)
+    for( magma_int_t d=0; d<precond->schwarz_num_domains; d++ ){
+        magma_z_schwarz_domain *dom = precond->schwarz_domains + d;
+        magma_int_t n = dom->n, ione = 1, linfo = 0;
+        for( magma_int_t i=0; i<n; i++ ){
+            dom->x[i] = bv[ dom->idx[i] ];
+        }
+        if( dom->lu != NULL ){
+            lapackf77_zgetrs( MagmaNoTransStr, &n, &ione, dom->lu, &n, dom->ipiv,
+                              dom->x, &n, &linfo );
+        } else {
+            magma_zschwarz_ilu0_solve( dom->A, dom->diag, dom->x );
+        }
+        for( magma_int_t i=0; i<dom->num_owned; i++ ){
+            magma_index_t o = dom->owned[i];
+            xv[ dom->idx[o] ] = dom->x[o];
+        }
+    }
+
+    if( b.memory_location != Magma_CPU ){
+        magma_zsetvector( b.num_rows, precond->work2.val, 1, x->dval, 1, queue );
+    }
+
+cleanup:
+    return info;
+}
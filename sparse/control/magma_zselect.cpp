@@ -12,9 +12,19 @@
 //  in this file, many routines are taken from
 //  the IO functions provided by MatrixMarket
 
+#include <algorithm>
 #include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define SWAP(a, b)  { tmp = a; a = b; b = tmp; }
 
+// sample-select parameters
+#define SAMPLESELECT_BUCKETS  256     // buckets per level
+#define SAMPLESELECT_SAMPLES  4096    // sample size per level
+#define SAMPLESELECT_BASE     4096    // switch to direct selection below
+
 
 magma_int_t
 magma_zpartition( 
@@ -227,3 +237,319 @@ magma_zselectrandom(
     }
     return info;
 }
+
+
+
+// magnitude of element i of the concatenation of val1 (size1 elements) and val2
+static inline double
+sampleselect_abs(
+    magma_int_t size1,
+    const magmaDoubleComplex *val1,
+    const magmaDoubleComplex *val2,
+    magma_int_t i )
+{
+    return MAGMA_Z_ABS( ( i < size1 ) ? val1[i] : val2[i-size1] );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Threshold selection engine of magma_zsampleselect_cpu for values stored
+    in two arrays, e.g., the factors L and U: selects from the union of
+    val1 and val2 without copying them.
+
+    Arguments
+    ---------
+
+    @param[in]
+    size1       magma_int_t
+                number of elements in val1
+
+    @param[in]
+    val1        const magmaDoubleComplex*
+                first part of the values, unchanged on exit
+
+    @param[in]
+    size2       magma_int_t
+                number of elements in val2
+
+    @param[in]
+    val2        const magmaDoubleComplex*
+                second part of the values, unchanged on exit
+
+    @param[in]
+    k           magma_int_t
+                rank of the selected element, 0 <= k < size1+size2
+
+    @param[in]
+    max_err     magma_int_t
+                accepted rank error, 0 gives the exact k-th element
+
+    @param[in]
+    seed        magma_int_t
+                seed for the sampling
+
+    @param[out]
+    thrs        double*
+                magnitude of the selected element
+
+    @param[out]
+    rank_err    magma_int_t*
+                bound on the rank error of thrs, may be NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zsampleselect2_cpu(
+    magma_int_t size1,
+    const magmaDoubleComplex *val1,
+    magma_int_t size2,
+    const magmaDoubleComplex *val2,
+    magma_int_t k,
+    magma_int_t max_err,
+    magma_int_t seed,
+    double *thrs,
+    magma_int_t *rank_err,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    
+    const magma_int_t nb = SAMPLESELECT_BUCKETS;
+    magma_int_t num_chunks = 1;    // of the candidates, one per thread
+    magma_int_t size = size1 + size2;
+    magma_int_t n = size;
+    magma_int_t err = 0;
+    magma_int_t exact = 0;
+    unsigned long long state = 2862933555777941757ULL * (unsigned long long) seed 
+                               + 3037000493ULL;
+    
+    double *cand = NULL;        // current candidates, NULL: all of |val|
+    double *next = NULL;
+    double *sample = NULL;
+    double *splitter = NULL;
+    double *lowest = NULL;      // per-chunk minimum of the candidates
+    magma_int_t *count = NULL;
+    
+    if ( size <= 0 || k < 0 || k >= size ) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    
+    // the candidates are split into one chunk per thread; the chunks are
+    // distributed by omp for, so all are covered by a team of any size
+#ifdef _OPENMP
+    num_chunks = omp_get_max_threads();
+#endif
+    CHECK( magma_dmalloc_cpu( &sample, SAMPLESELECT_SAMPLES ));
+    CHECK( magma_dmalloc_cpu( &splitter, nb-1 ));
+    CHECK( magma_imalloc_cpu( &count, num_chunks*nb ));
+    CHECK( magma_dmalloc_cpu( &lowest, num_chunks ));
+    
+    while ( true ) {
+        magma_int_t el_per_block = magma_ceildiv( n, num_chunks );
+        magma_int_t bucket = 0, base = 0, num_in_bucket = 0;
+        
+        if ( n <= SAMPLESELECT_BASE || exact == 1 ) {
+            // direct selection on the remaining candidates
+            if ( cand == NULL ) {
+                CHECK( magma_dmalloc_cpu( &cand, n ));
+                #pragma omp parallel for
+                for (magma_int_t i=0; i < n; i++) {
+                    cand[i] = sampleselect_abs( size1, val1, val2, i );
+                }
+            }
+            std::nth_element( cand, cand+k, cand+n );
+            *thrs = cand[k];
+            err = 0;
+            break;
+        }
+        
+        // splitters from a sorted sample of the candidates
+        for (magma_int_t i=0; i < SAMPLESELECT_SAMPLES; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            magma_int_t idx = (magma_int_t) ( (state >> 33) % (unsigned long long) n );
+            sample[i] = ( cand == NULL ) ? sampleselect_abs( size1, val1, val2, idx ) : cand[idx];
+        }
+        std::sort( sample, sample+SAMPLESELECT_SAMPLES );
+        for (magma_int_t b=0; b < nb-1; b++) {
+            splitter[b] = sample[ (b+1)*(SAMPLESELECT_SAMPLES/nb) ];
+        }
+        
+        // per-chunk bucket counts
+        #pragma omp parallel for schedule(static)
+        for (magma_int_t id=0; id < num_chunks; id++) {
+            magma_int_t *loc_count = count + id*nb;
+            magma_int_t start = min( id*el_per_block, n );
+            magma_int_t end = min( (id+1)*el_per_block, n );
+            double loc_lowest = splitter[0];
+            for (magma_int_t b=0; b < nb; b++) {
+                loc_count[b] = 0;
+            }
+            for (magma_int_t i=start; i < end; i++) {
+                double x = ( cand == NULL ) ? sampleselect_abs( size1, val1, val2, i ) : cand[i];
+                loc_count[ std::upper_bound( splitter, splitter+nb-1, x ) - splitter ]++;
+                loc_lowest = min( loc_lowest, x );
+            }
+            lowest[id] = loc_lowest;
+        }
+        
+        // bucket containing rank k
+        for (bucket=0; bucket < nb; bucket++) {
+            num_in_bucket = 0;
+            for (magma_int_t t=0; t < num_chunks; t++) {
+                num_in_bucket += count[ t*nb+bucket ];
+            }
+            if ( k < base + num_in_bucket ) {
+                break;
+            }
+            base += num_in_bucket;
+        }
+        
+        if ( max_err > 0 && num_in_bucket <= max_err ) {
+            // the lower bound of the bucket is its smallest element: a 
+            // splitter, or the smallest candidate for the first bucket
+            if ( bucket > 0 ) {
+                *thrs = splitter[bucket-1];
+            }
+            else {
+                *thrs = lowest[0];
+                for (magma_int_t t=1; t < num_chunks; t++) {
+                    *thrs = min( *thrs, lowest[t] );
+                }
+            }
+            err = num_in_bucket;
+            break;
+        }
+        if ( num_in_bucket == n ) {
+            // no progress (many equal magnitudes): finish directly
+            exact = 1;
+            continue;
+        }
+        
+        // extract the bucket; chunk t writes behind the elements of 
+        // chunks 0..t-1, which keeps the order deterministic
+        CHECK( magma_dmalloc_cpu( &next, num_in_bucket ));
+        #pragma omp parallel for schedule(static)
+        for (magma_int_t id=0; id < num_chunks; id++) {
+            magma_int_t start = min( id*el_per_block, n );
+            magma_int_t end = min( (id+1)*el_per_block, n );
+            magma_int_t offset = 0;
+            double lower = ( bucket > 0 ) ? splitter[bucket-1] : 0.0;
+            for (magma_int_t t=0; t < id; t++) {
+                offset += count[ t*nb+bucket ];
+            }
+            for (magma_int_t i=start; i < end; i++) {
+                double x = ( cand == NULL ) ? sampleselect_abs( size1, val1, val2, i ) : cand[i];
+                if ( x >= lower && ( bucket == nb-1 || x < splitter[bucket] ) ) {
+                    next[offset++] = x;
+                }
+            }
+        }
+        magma_free_cpu( cand );
+        cand = next;
+        next = NULL;
+        n = num_in_bucket;
+        k = k - base;
+    }
+    
+    if ( rank_err != NULL ) {
+        *rank_err = err;
+    }
+
+cleanup:
+    magma_free_cpu( cand );
+    magma_free_cpu( next );
+    magma_free_cpu( sample );
+    magma_free_cpu( splitter );
+    magma_free_cpu( lowest );
+    magma_free_cpu( count );
+    return info;
+}
+
+
+
+/**
+    Purpose
+    -------
+
+    Threshold selection engine for the CPU ParILUT/ParICT algorithms, the
+    host counterpart of magma_zsampleselect.
+    Returns the magnitude of the element with (0-based) rank k when the
+    entries of val are ordered by increasing magnitude.
+
+    The algorithm is a parallel multi-way sample-select: splitters drawn
+    from a random sample partition the magnitudes into buckets, every thread
+    counts the bucket sizes of its chunk, and the search continues in the
+    bucket containing rank k. Only the elements of this bucket (about
+    size/SAMPLESELECT_BUCKETS) are extracted, so val is neither copied nor
+    modified. The expected cost is O(size).
+
+    In approximate mode (max_err > 0) the search stops as soon as the bucket
+    containing rank k holds at most max_err elements. The returned value is
+    then the smallest element of that bucket, whose rank is at most k and
+    differs from k by at most rank_err.
+
+    The sample is drawn from a generator initialized with seed, so the
+    result is reproducible and independent of the number of threads.
+
+    Arguments
+    ---------
+
+    @param[in]
+    size        magma_int_t
+                number of elements in val
+
+    @param[in]
+    val         const magmaDoubleComplex*
+                values to select from, unchanged on exit
+
+    @param[in]
+    k           magma_int_t
+                rank of the selected element, 0 <= k < size
+
+    @param[in]
+    max_err     magma_int_t
+                accepted rank error, 0 gives the exact k-th element
+
+    @param[in]
+    seed        magma_int_t
+                seed for the sampling
+
+    @param[out]
+    thrs        double*
+                magnitude of the selected element
+
+    @param[out]
+    rank_err    magma_int_t*
+                bound on the rank error of thrs, may be NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zsampleselect_cpu(
+    magma_int_t size,
+    const magmaDoubleComplex *val,
+    magma_int_t k,
+    magma_int_t max_err,
+    magma_int_t seed,
+    double *thrs,
+    magma_int_t *rank_err,
+    magma_queue_t queue )
+{
+    return magma_zsampleselect2_cpu( size, val, 0, NULL, k, max_err, seed,
+                                     thrs, rank_err, queue );
+}
@@ -416,6 +416,9 @@ magma_zsolverinfo(
     }
     printf("%%    initial residual: %e\n", solver_par->init_res );
     printf("%%    preconditioner setup: %.4f sec\n", precond_par->setuptime );
+    if ( precond_par->sweeptol > 0.0 ) {
+        printf("%%    preconditioner sweeps: %4lld\n", (long long) precond_par->sweeps_used );
+    }
     printf("%%    iterations: %4lld\n", (long long) solver_par->numiter );
     printf("%%    SpMV-count: %4lld\n", (long long) solver_par->spmv_count );
     printf("%%    exact final residual: %e\n"
@@ -518,6 +521,7 @@ magma_zsolverinfo_init(
     solver_par->numiter = 0;
     solver_par->spmv_count = 0;
     precond_par->numiter = 0;
+    precond_par->sweeps_used = 0;
     precond_par->spmv_count = 0;
     precond_par->runtime       = 0.;
     precond_par->setuptime  = 0.;
@@ -554,46 +558,82 @@ magma_zsolverinfo_init(
     precond_par->M.col = NULL;
     precond_par->M.row = NULL;
     precond_par->M.blockinfo = NULL;
+    precond_par->M.val_low = NULL;
+    precond_par->M.col_low = NULL;
+    precond_par->M.col_base = NULL;
+    precond_par->M.storage_precision = Magma_DCOMPLEX;
 
     precond_par->L.val = NULL;
     precond_par->L.col = NULL;
     precond_par->L.row = NULL;
     precond_par->L.blockinfo = NULL;
+    precond_par->L.val_low = NULL;
+    precond_par->L.col_low = NULL;
+    precond_par->L.col_base = NULL;
+    precond_par->L.storage_precision = Magma_DCOMPLEX;
 
     precond_par->U.val = NULL;
     precond_par->U.col = NULL;
     precond_par->U.row = NULL;
     precond_par->U.blockinfo = NULL;
+    precond_par->U.val_low = NULL;
+    precond_par->U.col_low = NULL;
+    precond_par->U.col_base = NULL;
+    precond_par->U.storage_precision = Magma_DCOMPLEX;
     
     precond_par->LT.val = NULL;
     precond_par->LT.col = NULL;
     precond_par->LT.row = NULL;
     precond_par->LT.blockinfo = NULL;
+    precond_par->LT.val_low = NULL;
+    precond_par->LT.col_low = NULL;
+    precond_par->LT.col_base = NULL;
+    precond_par->LT.storage_precision = Magma_DCOMPLEX;
 
     precond_par->UT.val = NULL;
     precond_par->UT.col = NULL;
     precond_par->UT.row = NULL;
     precond_par->UT.blockinfo = NULL;
+    precond_par->UT.val_low = NULL;
+    precond_par->UT.col_low = NULL;
+    precond_par->UT.col_base = NULL;
+    precond_par->UT.storage_precision = Magma_DCOMPLEX;
 
     precond_par->LD.val = NULL;
     precond_par->LD.col = NULL;
     precond_par->LD.row = NULL;
     precond_par->LD.blockinfo = NULL;
+    precond_par->LD.val_low = NULL;
+    precond_par->LD.col_low = NULL;
+    precond_par->LD.col_base = NULL;
+    precond_par->LD.storage_precision = Magma_DCOMPLEX;
 
     precond_par->UD.val = NULL;
     precond_par->UD.col = NULL;
     precond_par->UD.row = NULL;
     precond_par->UD.blockinfo = NULL;
+    precond_par->UD.val_low = NULL;
+    precond_par->UD.col_low = NULL;
+    precond_par->UD.col_base = NULL;
+    precond_par->UD.storage_precision = Magma_DCOMPLEX;
     
     precond_par->LDT.val = NULL;
     precond_par->LDT.col = NULL;
     precond_par->LDT.row = NULL;
     precond_par->LDT.blockinfo = NULL;
+    precond_par->LDT.val_low = NULL;
+    precond_par->LDT.col_low = NULL;
+    precond_par->LDT.col_base = NULL;
+    precond_par->LDT.storage_precision = Magma_DCOMPLEX;
 
     precond_par->UDT.val = NULL;
     precond_par->UDT.col = NULL;
     precond_par->UDT.row = NULL;
     precond_par->UDT.blockinfo = NULL;
+    precond_par->UDT.val_low = NULL;
+    precond_par->UDT.col_low = NULL;
+    precond_par->UDT.col_base = NULL;
+    precond_par->UDT.storage_precision = Magma_DCOMPLEX;
     
     // todo: error: invalid conversion from ‘long int’ to ‘cusparseSolvePolicy_t’
     //precond_par->cuinfoL = NULL;
@@ -605,6 +645,22 @@ magma_zsolverinfo_init(
     precond_par->U_dgraphindegree = NULL;
     precond_par->L_dgraphindegree_bak = NULL;
     precond_par->U_dgraphindegree_bak = NULL;
+    precond_par->Lsched = NULL;
+    precond_par->Usched = NULL;
+    precond_par->num_blocks = 0;
+    precond_par->block_ptr = NULL;
+    precond_par->block_val_ptr = NULL;
+    precond_par->block_val = NULL;
+    precond_par->block_val_low = NULL;
+    precond_par->num_colors = 0;
+    precond_par->color_ptr = NULL;
+    precond_par->color_perm = NULL;
+    precond_par->color_dinv = NULL;
+    precond_par->color_work = NULL;
+    precond_par->amg_num_levels = 0;
+    precond_par->amg_levels = NULL;
+    precond_par->schwarz_num_domains = 0;
+    precond_par->schwarz_domains = NULL;
 
 cleanup:
     if( info != 0 ){
@@ -0,0 +1,546 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include <algorithm>
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+    Host SpGEMM.
+
+    C = op(A) * B is formed in two phases, a symbolic phase counting the
+    nonzeros of every row of C and a numeric phase filling them, so C is
+    allocated exactly once.
+
+    For op(A) = A the rows of C are accumulated independently (Gustavson)
+    in a per-thread hash table sized to the number of products of the row,
+    or in a dense accumulator if the largest row has more products than B
+    has columns.
+
+    For op(A) = A^T or A^H the rows of A scatter into the rows of C. The
+    products are expanded, sorted and compressed (ESC) without forming the
+    transpose; the rows of C are processed in chunks so that at most
+    max_products intermediate products are held at a time.
+
+    If a mask M is given, only the entries of the product that lie in the
+    pattern of M are computed.
+*/
+
+#define SPGEMM_EMPTY  -1
+// column admitted by the mask that has not been hit yet
+#define SPGEMM_ADMIT( c )  ( -2 - (c) )
+#define SPGEMM_HASH( c, m ) ( ( (magma_int_t) (c) * 107 ) & (m) )
+
+
+typedef struct {
+    unsigned long long key;     // column << 32 | row of A it stems from
+    magmaDoubleComplex val;
+} magma_zspgemm_product;
+
+
+static bool
+magma_zspgemm_product_less(
+    const magma_zspgemm_product &a,
+    const magma_zspgemm_product &b )
+{
+    return a.key < b.key;
+}
+
+
+// hash table size for a row with the given number of products
+static inline magma_int_t
+magma_zspgemm_tsize( magma_int_t products )
+{
+    magma_int_t tsize = 1;
+    while( tsize < 2*products ){
+        tsize *= 2;
+    }
+    return tsize;
+}
+
+
+// slot of column c in the accumulator
+static inline magma_int_t
+magma_zspgemm_slot(
+    const magma_index_t *keys,
+    magma_int_t tmask,
+    magma_int_t dense,
+    magma_index_t c )
+{
+    if( dense ){
+        return c;
+    }
+    magma_int_t h = SPGEMM_HASH( c, tmask );
+    while( keys[h] != SPGEMM_EMPTY && keys[h] != c && keys[h] != SPGEMM_ADMIT( c ) ){
+        h = ( h+1 ) & tmask;
+    }
+    return h;
+}
+
+
+// row i of A*B (restricted to the mask M) in the accumulator keys/vals with
+// tsize slots; writes the columns to col, the values to val if val != NULL
+// (numeric phase, columns sorted) and returns the number of nonzeros
+static magma_int_t
+magma_zspgemm_hashrow(
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *M,
+    magma_int_t i,
+    magma_int_t tsize,
+    magma_int_t dense,
+    magma_index_t *keys,
+    magmaDoubleComplex *vals,
+    magma_index_t *col,
+    magmaDoubleComplex *val )
+{
+    magma_int_t nz = 0, tmask = tsize-1;
+
+    if( M != NULL ){
+        for( magma_int_t j=M->row[i]; j<M->row[i+1]; j++ ){
+            magma_index_t c = M->col[j];
+            keys[ magma_zspgemm_slot( keys, tmask, dense, c ) ] = SPGEMM_ADMIT( c );
+        }
+    }
+    for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+        magma_index_t k = A.col[j];
+        magmaDoubleComplex a = A.val[j];
+        for( magma_int_t l=B.row[k]; l<B.row[k+1]; l++ ){
+            magma_index_t c = B.col[l];
+            magma_int_t h = magma_zspgemm_slot( keys, tmask, dense, c );
+            if( keys[h] == c ){
+                if( val != NULL ){
+                    vals[h] = vals[h] + a * B.val[l];
+                }
+            } else if( ( keys[h] == SPGEMM_EMPTY && M == NULL ) ||
+                         keys[h] == SPGEMM_ADMIT( c ) ){
+                keys[h] = c;
+                if( val != NULL ){
+                    vals[h] = a * B.val[l];
+                }
+                col[nz++] = c;
+            }
+        }
+    }
+
+    if( val != NULL ){
+        std::sort( col, col+nz );
+        for( magma_int_t j=0; j<nz; j++ ){
+            val[j] = vals[ magma_zspgemm_slot( keys, tmask, dense, col[j] ) ];
+        }
+    }
+    // reset the accumulator
+    if( dense ){
+        for( magma_int_t j=0; j<nz; j++ ){
+            keys[ col[j] ] = SPGEMM_EMPTY;
+        }
+        if( M != NULL ){
+            for( magma_int_t j=M->row[i]; j<M->row[i+1]; j++ ){
+                keys[ M->col[j] ] = SPGEMM_EMPTY;
+            }
+        }
+    } else {
+        for( magma_int_t h=0; h<tsize; h++ ){
+            keys[h] = SPGEMM_EMPTY;
+        }
+    }
+    return nz;
+}
+
+
+// C = A * B (masked) with hash accumulators, bound[i] is the number of
+// products of row i of C or the size of its mask
+static magma_int_t
+magma_zspgemm_hash(
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *M,
+    magma_index_t *bound,
+    magma_int_t num_threads,
+    magma_z_matrix *C,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_index_t *keys = NULL, *list = NULL;
+    magmaDoubleComplex *vals = NULL;
+    magma_int_t m = C->num_rows, n = C->num_cols;
+    magma_int_t maxbound = 0, tsize, dense = 0;
+
+    for( magma_int_t i=0; i<m; i++ ){
+        maxbound = max( maxbound, (magma_int_t) bound[i] );
+    }
+    tsize = magma_zspgemm_tsize( maxbound );
+    if( tsize >= n ){
+        dense = 1;
+        tsize = n;
+    }
+    maxbound = min( maxbound, n );
+    CHECK( magma_index_malloc_cpu( &keys, num_threads * (tsize+1) ));
+    CHECK( magma_zmalloc_cpu( &vals, num_threads * (tsize+1) ));
+    CHECK( magma_index_malloc_cpu( &list, num_threads * (maxbound+1) ));
+    for( magma_int_t i=0; i<num_threads * (tsize+1); i++ ){
+        keys[i] = SPGEMM_EMPTY;
+    }
+
+    // symbolic
+    #pragma omp parallel
+    {
+        magma_int_t id = 0;
+        #ifdef _OPENMP
+        id = omp_get_thread_num();
+        #endif
+        #pragma omp for schedule(dynamic,64)
+        for( magma_int_t i=0; i<m; i++ ){
+            magma_int_t rsize = dense ? tsize : magma_zspgemm_tsize( bound[i] );
+            C->row[i+1] = magma_zspgemm_hashrow( A, B, M, i, rsize, dense,
+                                keys + id*(tsize+1), vals + id*(tsize+1),
+                                list + id*(maxbound+1), NULL );
+        }
+    }
+    C->row[0] = 0;
+    for( magma_int_t i=0; i<m; i++ ){
+        C->row[i+1] += C->row[i];
+    }
+    C->nnz = C->row[m];
+    C->true_nnz = C->nnz;
+    CHECK( magma_index_malloc_cpu( &C->col, C->nnz+1 ));
+    CHECK( magma_zmalloc_cpu( &C->val, C->nnz+1 ));
+
+    // numeric
+    #pragma omp parallel
+    {
+        magma_int_t id = 0;
+        #ifdef _OPENMP
+        id = omp_get_thread_num();
+        #endif
+        #pragma omp for schedule(dynamic,64)
+        for( magma_int_t i=0; i<m; i++ ){
+            magma_int_t rsize = dense ? tsize : magma_zspgemm_tsize( bound[i] );
+            magma_zspgemm_hashrow( A, B, M, i, rsize, dense,
+                                   keys + id*(tsize+1), vals + id*(tsize+1),
+                                   C->col + C->row[i], C->val + C->row[i] );
+        }
+    }
+
+cleanup:
+    magma_free_cpu( keys );
+    magma_free_cpu( vals );
+    magma_free_cpu( list );
+    return info;
+}
+
+
+// C = op(A) * B (masked) with op(A) = A^T or A^H, expand-sort-compress over
+// chunks of rows of C holding at most max_products products; bound[i] is
+// the number of products of row i of C
+static magma_int_t
+magma_zspgemm_esc(
+    magma_trans_t transA,
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *M,
+    magma_index_t *bound,
+    magma_int_t max_products,
+    magma_int_t num_threads,
+    magma_z_matrix *C,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_zspgemm_product *prod = NULL;
+    magma_index_t *off = NULL, *marker = NULL;
+    magma_int_t m = C->num_rows, n = C->num_cols, maxchunk = 0;
+
+    for( magma_int_t r0=0, r1=0; r0<m; r0=r1 ){
+        magma_int_t total = 0;
+        while( r1 < m && ( r1 == r0 || max_products <= 0 ||
+                           total + bound[r1] <= max_products )){
+            total += bound[r1++];
+        }
+        maxchunk = max( maxchunk, total );
+    }
+    CHECK( magma_malloc_cpu( (void**) &prod,
+                             (maxchunk+1) * sizeof(magma_zspgemm_product) ));
+    CHECK( magma_index_malloc_cpu( &off, m+1 ));
+    if( M != NULL ){
+        CHECK( magma_index_malloc_cpu( &marker, num_threads * (n+1) ));
+        for( magma_int_t i=0; i<num_threads * (n+1); i++ ){
+            marker[i] = -1;
+        }
+    }
+
+    // phase 0 counts the nonzeros of C, phase 1 fills them
+    for( magma_int_t phase=0; phase<2; phase++ ){
+        for( magma_int_t r0=0, r1=0; r0<m; r0=r1 ){
+            magma_int_t total = 0;
+            while( r1 < m && ( r1 == r0 || max_products <= 0 ||
+                               total + bound[r1] <= max_products )){
+                off[r1] = total;
+                total += bound[r1++];
+            }
+
+            // expand, off[i] advances to the end of row i
+            #pragma omp parallel for schedule(dynamic,64)
+            for( magma_int_t k=0; k<A.num_rows; k++ ){
+                magma_int_t bnz = B.row[k+1] - B.row[k];
+                for( magma_int_t j=A.row[k]; j<A.row[k+1]; j++ ){
+                    magma_index_t i = A.col[j], p;
+                    if( i < r0 || i >= r1 || bnz == 0 ){
+                        continue;
+                    }
+                    magmaDoubleComplex a = ( transA == MagmaConjTrans )
+                                         ? MAGMA_Z_CONJ( A.val[j] ) : A.val[j];
+                    #pragma omp atomic capture
+                    { p = off[i]; off[i] += bnz; }
+                    for( magma_int_t l=B.row[k]; l<B.row[k+1]; l++ ){
+                        prod[p].key = ( (unsigned long long) B.col[l] << 32 )
+                                    | (unsigned long long) k;
+                        prod[p].val = a * B.val[l];
+                        p++;
+                    }
+                }
+            }
+
+            // sort by column and source row, then compress
+            #pragma omp parallel
+            {
+                magma_int_t id = 0;
+                #ifdef _OPENMP
+                id = omp_get_thread_num();
+                #endif
+                magma_index_t *mark = ( M != NULL ) ? marker + id*(n+1) : NULL;
+                #pragma omp for schedule(dynamic,16)
+                for( magma_int_t i=r0; i<r1; i++ ){
+                    magma_int_t start = off[i] - bound[i], end = off[i], nz = 0;
+                    magma_index_t *col = ( phase == 1 ) ? C->col + C->row[i] : NULL;
+                    magmaDoubleComplex *val = ( phase == 1 ) ? C->val + C->row[i] : NULL;
+                    if( M != NULL ){
+                        for( magma_int_t j=M->row[i]; j<M->row[i+1]; j++ ){
+                            mark[ M->col[j] ] = i;
+                        }
+                    }
+                    std::sort( prod+start, prod+end, magma_zspgemm_product_less );
+                    for( magma_int_t j=start; j<end; ){
+                        magma_index_t c = (magma_index_t) ( prod[j].key >> 32 );
+                        magmaDoubleComplex s = prod[j].val;
+                        for( j++; j<end && (magma_index_t) ( prod[j].key >> 32 ) == c; j++ ){
+                            s = s + prod[j].val;
+                        }
+                        if( M == NULL || mark[c] == i ){
+                            if( col != NULL ){
+                                col[nz] = c;
+                                val[nz] = s;
+                            }
+                            nz++;
+                        }
+                    }
+                    if( phase == 0 ){
+                        C->row[i+1] = nz;
+                    }
+                }
+            }
+        }
+
+        if( phase == 0 ){
+            C->row[0] = 0;
+            for( magma_int_t i=0; i<m; i++ ){
+                C->row[i+1] += C->row[i];
+            }
+            C->nnz = C->row[m];
+            C->true_nnz = C->nnz;
+            CHECK( magma_index_malloc_cpu( &C->col, C->nnz+1 ));
+            CHECK( magma_zmalloc_cpu( &C->val, C->nnz+1 ));
+        }
+    }
+
+cleanup:
+    magma_free_cpu( prod );
+    magma_free_cpu( off );
+    magma_free_cpu( marker );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes the sparse matrix-matrix product C = op(A) * B on the CPU for
+    CSR matrices, op(A) = A, A^T or A^H. The transpose of A is never formed.
+    If a mask M is given, C contains only those entries of the product that
+    lie in the pattern of M (the values of M are not used).
+
+    The product is formed in a symbolic and a numeric phase with per-thread
+    accumulators; the column indices of every row of C are sorted. For
+    op(A) = A^T or A^H the intermediate products are expanded and sorted;
+    if max_products > 0, the rows of C are processed in chunks holding at
+    most max_products products at a time (a single row exceeding the bound
+    forms its own chunk).
+
+    Arguments
+    ---------
+
+    @param[in]
+    transA      magma_trans_t
+                MagmaNoTrans, MagmaTrans or MagmaConjTrans
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A (CSR, CPU)
+
+    @param[in]
+    B           magma_z_matrix
+                input matrix B (CSR, CPU)
+
+    @param[in]
+    M           magma_z_matrix*
+                mask pattern of C (CSR, CPU) or NULL
+
+    @param[in]
+    max_products    magma_int_t
+                bound on the intermediate products held at a time,
+                0 for no bound
+
+    @param[out]
+    C           magma_z_matrix*
+                output matrix C = op(A) * B (CSR, CPU)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zspgemm_ex_cpu(
+    magma_trans_t transA,
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *M,
+    magma_int_t max_products,
+    magma_z_matrix *C,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_index_t *bound = NULL;
+    magma_int_t num_threads = 1, m, inner;
+
+    m = ( transA == MagmaNoTrans ) ? A.num_rows : A.num_cols;
+    inner = ( transA == MagmaNoTrans ) ? A.num_cols : A.num_rows;
+    if( inner != B.num_rows ||
+        A.memory_location != Magma_CPU || B.memory_location != Magma_CPU ||
+        A.storage_type != Magma_CSR || B.storage_type != Magma_CSR ||
+        ( M != NULL && ( M->memory_location != Magma_CPU ||
+                         M->storage_type != Magma_CSR ||
+                         M->num_rows != m || M->num_cols != B.num_cols ))){
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    C->storage_type = Magma_CSR;
+    C->memory_location = Magma_CPU;
+    C->ownership = MagmaTrue;
+    C->num_rows = m;
+    C->num_cols = B.num_cols;
+    C->row = NULL;
+    C->rowidx = NULL;
+    C->col = NULL;
+    C->val = NULL;
+    CHECK( magma_index_malloc_cpu( &C->row, m+1 ));
+    CHECK( magma_index_malloc_cpu( &bound, m+1 ));
+
+    if( transA == MagmaNoTrans ){
+        // products of every row, the accumulator of a masked row holds
+        // the pattern of the mask
+        #pragma omp parallel for schedule(dynamic,256)
+        for( magma_int_t i=0; i<m; i++ ){
+            magma_int_t fl = 0;
+            if( M != NULL ){
+                fl = M->row[i+1] - M->row[i];
+            } else {
+                for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+                    fl += B.row[ A.col[j]+1 ] - B.row[ A.col[j] ];
+                }
+            }
+            bound[i] = fl;
+        }
+        CHECK( magma_zspgemm_hash( A, B, M, bound, num_threads, C, queue ));
+    } else {
+        // products of every row, the mask is applied after the expansion
+        #pragma omp parallel for
+        for( magma_int_t i=0; i<m; i++ ){
+            bound[i] = 0;
+        }
+        #pragma omp parallel for schedule(dynamic,256)
+        for( magma_int_t k=0; k<A.num_rows; k++ ){
+            magma_index_t bnz = B.row[k+1] - B.row[k];
+            for( magma_int_t j=A.row[k]; j<A.row[k+1]; j++ ){
+                #pragma omp atomic
+                bound[ A.col[j] ] += bnz;
+            }
+        }
+        CHECK( magma_zspgemm_esc( transA, A, B, M, bound, max_products,
+                                  num_threads, C, queue ));
+    }
+
+cleanup:
+    if( info != 0 && info != MAGMA_ERR_NOT_SUPPORTED ){
+        magma_zmfree( C, queue );
+    }
+    magma_free_cpu( bound );
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Computes the sparse matrix-matrix product C = A * B on the CPU for CSR
+    matrices, see magma_zspgemm_ex_cpu.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A (CSR, CPU)
+
+    @param[in]
+    B           magma_z_matrix
+                input matrix B (CSR, CPU)
+
+    @param[out]
+    C           magma_z_matrix*
+                output matrix C = A * B (CSR, CPU)
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zspgemm_cpu(
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue )
+{
+    return magma_zspgemm_ex_cpu( MagmaNoTrans, A, B, NULL, 0, C, queue );
+}
@@ -0,0 +1,644 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+
+*/
+
+#include <string.h>
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define COMPLEX
+
+// a level with fewer rows per thread is "thin" for Magma_BLOCKLEVELSOLVE
+#define MAGMA_LEVELSCHED_THIN 16
+// chunk size of the static round-robin row distribution in the sync-free solve
+#define MAGMA_SYNCFREE_CHUNK 16
+
+
+/*
+    Host sparse triangular solves for CSR factors (Magma_CSRL / Magma_CSRU).
+
+    The analysis computes the level of each row (the length of the longest
+    dependency path ending in it) and orders the rows by level. The solve
+    then runs in one of three modes:
+        Magma_LEVELSOLVE        one parallel loop per level, barrier in between;
+        Magma_BLOCKLEVELSOLVE   like the above, but runs of consecutive thin
+                                levels are merged into one step that a single
+                                thread processes sequentially, which saves the
+                                barriers in the long tails of narrow levels;
+        Magma_CPUSYNCFREESOLVE  no barriers at all: every row has a counter of
+                                unresolved dependencies, a thread spins until
+                                the counter of its row drops to zero, solves the
+                                row and decrements the counters of the rows
+                                depending on it.
+    All modes process the rows in level order. In the sync-free mode each
+    thread handles its rows in increasing order and every dependency of a row
+    comes earlier in that order, so the spinning can not deadlock.
+*/
+
+
+// bfloat16 values of factors stored with magma_zmlowprec_cpu
+static inline float
+magma_zbf162float(unsigned short h)
+{
+    unsigned int u = (unsigned int) h << 16;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+
+// value j of factor values stored in precision P, in working precision
+// (Magma_DCOMPLEX: the working precision itself)
+template< magma_precision P >
+static inline magmaDoubleComplex
+magma_zlowprec_val(const void *v, magma_int_t j);
+
+template<>
+inline magmaDoubleComplex
+magma_zlowprec_val<Magma_DCOMPLEX>(const void *v, magma_int_t j)
+{
+    return ((const magmaDoubleComplex*) v)[j];
+}
+
+template<>
+inline magmaDoubleComplex
+magma_zlowprec_val<Magma_FLOAT>(const void *v, magma_int_t j)
+{
+    const float *sv = (const float*) v;
+    #ifdef COMPLEX
+    return MAGMA_Z_MAKE((double) sv[2*j], (double) sv[2*j+1]);
+    #else
+    return (double) sv[j];
+    #endif
+}
+
+template<>
+inline magmaDoubleComplex
+magma_zlowprec_val<Magma_BFLOAT16>(const void *v, magma_int_t j)
+{
+    const unsigned short *hv = (const unsigned short*) v;
+    #ifdef COMPLEX
+    return MAGMA_Z_MAKE((double) magma_zbf162float(hv[2*j]),
+                        (double) magma_zbf162float(hv[2*j+1]));
+    #else
+    return (double) magma_zbf162float(hv[j]);
+    #endif
+}
+
+
+// x[i] = ( b[i] - sum_{j != i} T(i,j) x[j] ) / T(i,i)
+template< magma_precision P >
+static inline void
+magma_ztrisolve_cpu_row(
+    magma_int_t i,
+    magma_z_matrix T,
+    const void *v,
+    const magma_index_t *diag,
+    const magmaDoubleComplex *b,
+    magmaDoubleComplex *x )
+{
+    magmaDoubleComplex sum = b[i];
+    for (magma_int_t j = T.row[i]; j < T.row[i+1]; j++) {
+        if (j != diag[i]) {
+            sum = sum - magma_zlowprec_val<P>(v, j) * x[T.col[j]];
+        }
+    }
+    x[i] = (diag[i] < 0) ? sum : sum / magma_zlowprec_val<P>(v, diag[i]);
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Analyzes a triangular CSR matrix located on the host for the
+    level-scheduled and sync-free CPU trisolves. Whether T is lower or upper
+    triangular is detected from the pattern. Rows without diagonal element
+    are treated as having a unit diagonal.
+
+    Arguments
+    ---------
+
+    @param[in]
+    T           magma_z_matrix
+                triangular matrix in CSR on the host
+
+    @param[in]
+    mode        magma_solver_type
+                Magma_LEVELSOLVE, Magma_BLOCKLEVELSOLVE or
+                Magma_CPUSYNCFREESOLVE
+
+    @param[out]
+    sched       magma_levelsched_t**
+                analysis, free with magma_ztrisolve_cpu_free
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_ztrisolve_cpu_analysis(
+    magma_z_matrix T,
+    magma_solver_type mode,
+    magma_levelsched_t **sched,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_levelsched_t *S = NULL;
+    magma_index_t *level = NULL;
+    magma_int_t n = T.num_rows;
+    magma_int_t lower = 1, upper = 1, num_threads = 1;
+
+    if (T.memory_location != Magma_CPU ||
+        (T.storage_type != Magma_CSR && T.storage_type != Magma_CSRL &&
+         T.storage_type != Magma_CSRU) ||
+        (mode != Magma_LEVELSOLVE && mode != Magma_BLOCKLEVELSOLVE &&
+         mode != Magma_CPUSYNCFREESOLVE)) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    CHECK(magma_malloc_cpu((void**)&S, sizeof(magma_levelsched_t)));
+    S->level_ptr = NULL;
+    S->perm = NULL;
+    S->block_ptr = NULL;
+    S->diag = NULL;
+    S->indegree = NULL;
+    S->counter = NULL;
+    S->dep_ptr = NULL;
+    S->dep_idx = NULL;
+    S->mode = mode;
+    S->num_rows = n;
+
+    CHECK(magma_index_malloc_cpu(&S->diag, n));
+    CHECK(magma_index_malloc_cpu(&S->perm, n));
+    CHECK(magma_index_malloc_cpu(&level, n));
+
+    #pragma omp parallel for reduction(&&:lower,upper)
+    for (magma_int_t i = 0; i < n; i++) {
+        S->diag[i] = -1;
+        for (magma_int_t j = T.row[i]; j < T.row[i+1]; j++) {
+            lower = lower && T.col[j] <= i;
+            upper = upper && T.col[j] >= i;
+            if (T.col[j] == i) {
+                S->diag[i] = j;
+            }
+        }
+    }
+    if (lower) {
+        S->uplo = MagmaLower;
+    } else if (upper) {
+        S->uplo = MagmaUpper;
+    } else {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    // levels, one pass in dependency order
+    S->num_levels = 0;
+    for (magma_int_t k = 0; k < n; k++) {
+        magma_int_t i = (S->uplo == MagmaLower) ? k : n-1-k;
+        magma_int_t lev = 0;
+        for (magma_int_t j = T.row[i]; j < T.row[i+1]; j++) {
+            if (j != S->diag[i]) {
+                lev = max(lev, level[T.col[j]] + 1);
+            }
+        }
+        level[i] = lev;
+        S->num_levels = max(S->num_levels, lev + 1);
+    }
+
+    // order the rows by level (stable, so rows within a level stay in
+    // dependency order for the serial steps)
+    CHECK(magma_index_malloc_cpu(&S->level_ptr, S->num_levels+1));
+    for (magma_int_t l = 0; l < S->num_levels+1; l++) {
+        S->level_ptr[l] = 0;
+    }
+    for (magma_int_t i = 0; i < n; i++) {
+        S->level_ptr[level[i]+1]++;
+    }
+    for (magma_int_t l = 0; l < S->num_levels; l++) {
+        S->level_ptr[l+1] += S->level_ptr[l];
+    }
+    for (magma_int_t k = 0; k < n; k++) {
+        magma_int_t i = (S->uplo == MagmaLower) ? k : n-1-k;
+        S->perm[S->level_ptr[level[i]]++] = i;
+    }
+    for (magma_int_t l = S->num_levels; l > 0; l--) {
+        S->level_ptr[l] = S->level_ptr[l-1];
+    }
+    S->level_ptr[0] = 0;
+
+    // scheduling steps: merge runs of thin levels
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    S->thin = (mode == Magma_BLOCKLEVELSOLVE) ?
+                            num_threads * MAGMA_LEVELSCHED_THIN : 0;
+    CHECK(magma_index_malloc_cpu(&S->block_ptr, S->num_levels+1));
+    S->num_blocks = 0;
+    for (magma_int_t l = 0; l < S->num_levels; l++) {
+        magma_int_t thin = S->level_ptr[l+1] - S->level_ptr[l] < S->thin;
+        magma_int_t thin_prev = l > 0 &&
+                            S->level_ptr[l] - S->level_ptr[l-1] < S->thin;
+        if (!(thin && thin_prev)) {
+            S->block_ptr[S->num_blocks++] = l;
+        }
+    }
+    S->block_ptr[S->num_blocks] = S->num_levels;
+
+    // dependency graph for the sync-free mode
+    if (mode == Magma_CPUSYNCFREESOLVE) {
+        CHECK(magma_index_malloc_cpu(&S->indegree, n));
+        CHECK(magma_index_malloc_cpu(&S->counter, n));
+        CHECK(magma_index_malloc_cpu(&S->dep_ptr, n+1));
+        CHECK(magma_index_malloc_cpu(&S->dep_idx,
+                                     max(T.row[n] - T.row[0], 1)));
+        for (magma_int_t i = 0; i < n+1; i++) {
+            S->dep_ptr[i] = 0;
+        }
+        for (magma_int_t i = 0; i < n; i++) {
+            S->indegree[i] = T.row[i+1] - T.row[i] - (S->diag[i] < 0 ? 0 : 1);
+            for (magma_int_t j = T.row[i]; j < T.row[i+1]; j++) {
+                if (j != S->diag[i]) {
+                    S->dep_ptr[T.col[j]+1]++;
+                }
+            }
+        }
+        for (magma_int_t i = 0; i < n; i++) {
+            S->dep_ptr[i+1] += S->dep_ptr[i];
+        }
+        for (magma_int_t i = 0; i < n; i++) {
+            for (magma_int_t j = T.row[i]; j < T.row[i+1]; j++) {
+                if (j != S->diag[i]) {
+                    S->dep_idx[S->dep_ptr[T.col[j]]++] = i;
+                }
+            }
+        }
+        for (magma_int_t i = n; i > 0; i--) {
+            S->dep_ptr[i] = S->dep_ptr[i-1];
+        }
+        S->dep_ptr[0] = 0;
+    }
+
+    *sched = S;
+    S = NULL;
+
+cleanup:
+    magma_free_cpu(level);
+    magma_ztrisolve_cpu_free(&S, queue);
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Frees the analysis of magma_ztrisolve_cpu_analysis.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    sched       magma_levelsched_t**
+                analysis, set to NULL
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_ztrisolve_cpu_free(
+    magma_levelsched_t **sched,
+    magma_queue_t queue )
+{
+    magma_levelsched_t *S = *sched;
+    if (S != NULL) {
+        magma_free_cpu(S->level_ptr);
+        magma_free_cpu(S->perm);
+        magma_free_cpu(S->block_ptr);
+        magma_free_cpu(S->diag);
+        magma_free_cpu(S->indegree);
+        magma_free_cpu(S->counter);
+        magma_free_cpu(S->dep_ptr);
+        magma_free_cpu(S->dep_idx);
+        magma_free_cpu(S);
+        *sched = NULL;
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+// level-scheduled / sync-free solve with the factor values v
+template< magma_precision P >
+static void
+magma_ztrisolve_cpu_kernel(
+    magma_z_matrix T,
+    const void *v,
+    magma_levelsched_t *S,
+    const magmaDoubleComplex *bv,
+    magmaDoubleComplex *xv )
+{
+    if (S->mode == Magma_CPUSYNCFREESOLVE) {
+        #pragma omp parallel for
+        for (magma_int_t i = 0; i < S->num_rows; i++) {
+            S->counter[i] = S->indegree[i];
+        }
+        #pragma omp parallel for schedule(static, MAGMA_SYNCFREE_CHUNK)
+        for (magma_int_t k = 0; k < S->num_rows; k++) {
+            magma_int_t i = S->perm[k];
+            magma_index_t left;
+            do {
+                #pragma omp atomic read
+                left = S->counter[i];
+            } while (left > 0);
+            #pragma omp flush
+            magma_ztrisolve_cpu_row<P>(i, T, v, S->diag, bv, xv);
+            #pragma omp flush
+            for (magma_int_t d = S->dep_ptr[i]; d < S->dep_ptr[i+1]; d++) {
+                #pragma omp atomic
+                S->counter[S->dep_idx[d]]--;
+            }
+        }
+    } else {
+        #pragma omp parallel
+        for (magma_int_t s = 0; s < S->num_blocks; s++) {
+            magma_int_t start = S->level_ptr[S->block_ptr[s]];
+            magma_int_t end = S->level_ptr[S->block_ptr[s+1]];
+            // merged thin levels: one thread, rows in dependency order
+            if (S->block_ptr[s+1] - S->block_ptr[s] > 1 ||
+                end - start < S->thin) {
+                #pragma omp single
+                for (magma_int_t k = start; k < end; k++) {
+                    magma_ztrisolve_cpu_row<P>(S->perm[k], T, v, S->diag, bv, xv);
+                }
+            } else {
+                #pragma omp for schedule(static)
+                for (magma_int_t k = start; k < end; k++) {
+                    magma_ztrisolve_cpu_row<P>(S->perm[k], T, v, S->diag, bv, xv);
+                }
+            }
+        }
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Solves T x = b on the host for a triangular CSR matrix T analyzed by
+    magma_ztrisolve_cpu_analysis. x and b may be the same vector. If T
+    carries a reduced-precision copy of its values (magma_zmlowprec_cpu),
+    that copy is used.
+
+    Arguments
+    ---------
+
+    @param[in]
+    T           magma_z_matrix
+                triangular matrix in CSR on the host
+
+    @param[in,out]
+    sched       magma_levelsched_t*
+                analysis of T (the sync-free counters are reused)
+
+    @param[in]
+    b           magma_z_matrix
+                right-hand side on the host
+
+    @param[out]
+    x           magma_z_matrix*
+                solution on the host
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_ztrisolve_cpu(
+    magma_z_matrix T,
+    magma_levelsched_t *sched,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_levelsched_t *S = sched;
+    const magmaDoubleComplex *bv = b.val;
+    magmaDoubleComplex *xv = x->val;
+
+    if (S == NULL || S->num_rows != T.num_rows ||
+        b.memory_location != Magma_CPU || x->memory_location != Magma_CPU) {
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    if (T.val_low != NULL && (T.storage_precision == Magma_FLOAT ||
+                              T.storage_precision == Magma_FCOMPLEX)) {
+        magma_ztrisolve_cpu_kernel<Magma_FLOAT>(T, T.val_low, S, bv, xv);
+    } else if (T.val_low != NULL && T.storage_precision == Magma_BFLOAT16) {
+        magma_ztrisolve_cpu_kernel<Magma_BFLOAT16>(T, T.val_low, S, bv, xv);
+    } else {
+        magma_ztrisolve_cpu_kernel<Magma_DCOMPLEX>(T, T.val, S, bv, xv);
+    }
+
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Prepares an ILU preconditioner for the host trisolves selected by
+    precond->trisolver: moves the factors L and U to the host, analyzes them
+    and allocates the host work vectors used when applying the
+    preconditioner to vectors located on the device. With precond->format
+    Magma_FLOAT or Magma_BFLOAT16 the factor values are additionally stored
+    in that precision and the solves read them from there.
+
+    Arguments
+    ---------
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner with factors L and U in CSR
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_ztrisolve_cpu_setup(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    magma_z_matrix hL={Magma_CSR}, hU={Magma_CSR};
+
+    if (precond->L.memory_location != Magma_CPU) {
+        CHECK(magma_zmtransfer(precond->L, &hL, Magma_DEV, Magma_CPU, queue));
+        magma_zmfree(&precond->L, queue);
+        CHECK(magma_zmtransfer(hL, &precond->L, Magma_CPU, Magma_CPU, queue));
+    }
+    if (precond->U.memory_location != Magma_CPU) {
+        CHECK(magma_zmtransfer(precond->U, &hU, Magma_DEV, Magma_CPU, queue));
+        magma_zmfree(&precond->U, queue);
+        CHECK(magma_zmtransfer(hU, &precond->U, Magma_CPU, Magma_CPU, queue));
+    }
+
+    magma_ztrisolve_cpu_free(&precond->Lsched, queue);
+    magma_ztrisolve_cpu_free(&precond->Usched, queue);
+    CHECK(magma_ztrisolve_cpu_analysis(precond->L, precond->trisolver,
+                                       &precond->Lsched, queue));
+    CHECK(magma_ztrisolve_cpu_analysis(precond->U, precond->trisolver,
+                                       &precond->Usched, queue));
+    // factors in reduced precision for precond->format FLOAT / BFLOAT16
+    if (precond->format == Magma_FLOAT || precond->format == Magma_FCOMPLEX ||
+        precond->format == Magma_BFLOAT16) {
+        CHECK(magma_zmlowprec_cpu(precond->format, &precond->L, queue));
+        CHECK(magma_zmlowprec_cpu(precond->format, &precond->U, queue));
+    }
+
+    magma_zmfree(&precond->work1, queue);
+    magma_zmfree(&precond->work2, queue);
+    CHECK(magma_zvinit(&precond->work1, Magma_CPU, precond->L.num_rows, 1,
+                       MAGMA_Z_ZERO, queue));
+    CHECK(magma_zvinit(&precond->work2, Magma_CPU, precond->L.num_rows, 1,
+                       MAGMA_Z_ZERO, queue));
+
+cleanup:
+    magma_zmfree(&hL, queue);
+    magma_zmfree(&hU, queue);
+    return info;
+}
+
+
+// applies the host trisolve with T to b, staging device vectors through
+// the host work vectors of the preconditioner
+static magma_int_t
+magma_zapplytrisolve_cpu(
+    magma_z_matrix T,
+    magma_levelsched_t *sched,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    if (b.memory_location == Magma_CPU) {
+        CHECK(magma_ztrisolve_cpu(T, sched, b, x, queue));
+    } else {
+        magma_zgetvector(b.num_rows, b.dval, 1, precond->work1.val, 1, queue);
+        CHECK(magma_ztrisolve_cpu(T, sched, precond->work1, &precond->work2,
+                                  queue));
+        magma_zsetvector(b.num_rows, precond->work2.val, 1, x->dval, 1, queue);
+    }
+
+cleanup:
+    return info;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Performs the left triangular solve of an ILU preconditioner prepared by
+    magma_ztrisolve_cpu_setup.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[in,out]
+    x           magma_z_matrix*
+                vector to precondition
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplytrisolve_cpu_l(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return magma_zapplytrisolve_cpu(precond->L, precond->Lsched, b, x,
+                                    precond, queue);
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Performs the right triangular solve of an ILU preconditioner prepared by
+    magma_ztrisolve_cpu_setup.
+
+    Arguments
+    ---------
+
+    @param[in]
+    b           magma_z_matrix
+                RHS
+
+    @param[in,out]
+    x           magma_z_matrix*
+                vector to precondition
+
+    @param[in,out]
+    precond     magma_z_preconditioner*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgepr
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zapplytrisolve_cpu_r(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue )
+{
+    return magma_zapplytrisolve_cpu(precond->U, precond->Usched, b, x,
+                                    precond, queue);
+}
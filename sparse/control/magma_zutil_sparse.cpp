@@ -42,10 +42,19 @@ static const char *usage_sparse =
 " --mscale      Possibility to scale the original matrix:\n"
 "               NOSCALE   no scaling\n"
 "               UNITDIAG   symmetric scaling to unit diagonal\n"
+"               MAXNORM    row and column max-norm equilibration\n"
+"               RUIZ       iterative Ruiz row and column equilibration\n"
+"               (MAXNORM and RUIZ: testing_zsolver_rhs_scaling only)\n"
+" --mreorder    Possibility to reorder the original matrix:\n"
+"               NOREORDER  natural order\n"
+"               RCM        reverse Cuthill-McKee (bandwidth, locality)\n"
+"               AMD        approximate minimum degree (ILU fill)\n"
+"               MULTICOLOR multicolor ordering (parallel smoothers)\n"
 " --precond x   Possibility to choose a preconditioner:\n"
 "               CG, BICGSTAB, GMRES, LOBPCG, JACOBI,\n"
 "               BAITER, IDR, CGS, TFQMR, QMR, BICG\n"
-"               BOMBARDMENT, ITERREF, ILU, PARILU, PARILUT, NONE.\n"
+"               BOMBARDMENT, ITERREF, ILU, PARILU, PARILUT, BLOCKJACOBI,\n"
+"               GS, SSOR, AMG, RAS, NONE.\n"
 "                   --patol atol  Absolute residual stopping criterion for preconditioner.\n"
 "                   --prtol rtol  Relative residual stopping criterion for preconditioner.\n"
 "                   --piters k    Iteration count for iterative preconditioner.\n"
@@ -53,8 +62,20 @@ static const char *usage_sparse =
 "                   --triolver k  Solver for triangular ILU factors: e.g. CUSOLVE, JACOBI, ISAI.\n"
 "                   --ppattern k  Pattern used for ISAI preconditioner.\n"
 "                   --psweeps x   Number of iterative ParILU sweeps.\n"
+"                   --psweeptol x Stop ParILU sweeps once the factors change less than x (default 0: fixed sweeps).\n"
+"                   --pbsize k    Maximal block size for BLOCKJACOBI (default 32).\n"
+"                   --pomega x    Relaxation weight for GS and SSOR (default 1.0).\n"
+"                   AMG: --plevels k maximal number of levels (default 10), --piters k\n"
+"                   smoothing steps, --trisolver JACOBI for a Jacobi instead of Chebyshev smoother.\n"
+"                   RAS: --pdomains k number of subdomains (default: number of threads),\n"
+"                   --poverlap k levels of overlap (default 1), --ppartition CONTIGUOUS or RCM\n"
+"                   (default CONTIGUOUS), --pbsize k largest subdomain solved by dense LU\n"
+"                   (default 512, ILU(0) for larger ones).\n"
+"                   --pformat x   Storage precision of the BLOCKJACOBI blocks: DOUBLE, FLOAT;\n"
+"                                 of the host trisolve factors: DOUBLE, FLOAT, BF16.\n"
 " --trisolver   Possibility to choose a triangular solver for ILU preconditioning: \n"
 "               e.g. CUSOLVE, ISPTRSV, JACOBI, VBJACOBI, ISAI.\n"
+"               Host trisolves: LEVELSOLVE, BLOCKLEVELSOLVE, CPUSYNCFREESOLVE.\n"
 " --ppattern k  Possibility to choose a pattern for the trisolver: ISAI(k) or Block Jacobi.\n"
 " --piters k    Number of preconditioner relaxation steps, e.g. for ISAI or (Block) Jacobi trisolver.\n"
 " --patol x     Set an absolute residual stopping criterion for the preconditioner.\n"
@@ -114,6 +135,7 @@ magma_zparse_opts(
     opts->input_location = Magma_CPU;
     opts->output_location = Magma_CPU;
     opts->scaling = Magma_NOSCALE;
+    opts->reordering = Magma_NOREORDER;
     #if defined(PRECISION_z) | defined(PRECISION_d)
         opts->solver_par.atol = 1e-16;
         opts->solver_par.rtol = 1e-10;
@@ -139,8 +161,16 @@ magma_zparse_opts(
     opts->precond_par.restart = 10;
     opts->precond_par.levels = 0;
     opts->precond_par.sweeps = 5;
+    magma_tune_get( "parilu_sweeps", '*', -1, -1, &opts->precond_par.sweeps );
+    opts->precond_par.sweeptol = 0.0;
     opts->precond_par.maxiter = 1;
     opts->precond_par.pattern = 1;
+    opts->precond_par.bsize = 0;
+    opts->precond_par.format = Magma_DOUBLE;
+    opts->precond_par.omega = 1.0;
+    opts->precond_par.overlap = 1;
+    opts->precond_par.subdomains = 0;
+    opts->precond_par.partition = Magma_NOREORDER;
     opts->solver_par.solver = Magma_CGMERGE;
     
     printf( usage_sparse_short, argv[0] );
@@ -186,9 +216,32 @@ magma_zparse_opts(
             else if ( strcmp("UNITROWCOL", argv[i]) == 0 ) {
                 opts->scaling = Magma_UNITROWCOL;
             }
+            else if ( strcmp("MAXNORM", argv[i]) == 0 ) {
+                opts->scaling = Magma_MAXNORM;
+            }
+            else if ( strcmp("RUIZ", argv[i]) == 0 ) {
+                opts->scaling = Magma_RUIZ;
+            }
             else {
                 printf( "%%error: invalid scaling, use default.\n" );
             }
+        } else if ( strcmp("--mreorder", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            if ( strcmp("NOREORDER", argv[i]) == 0 ) {
+                opts->reordering = Magma_NOREORDER;
+            }
+            else if ( strcmp("RCM", argv[i]) == 0 ) {
+                opts->reordering = Magma_RCM;
+            }
+            else if ( strcmp("AMD", argv[i]) == 0 ) {
+                opts->reordering = Magma_AMD;
+            }
+            else if ( strcmp("MULTICOLOR", argv[i]) == 0 ) {
+                opts->reordering = Magma_MULTICOLOR;
+            }
+            else {
+                printf( "%%error: invalid reordering, use default.\n" );
+            }
         } else if ( strcmp("--solver", argv[i]) == 0 && i+1 < argc ) {
             i++;
             if ( strcmp("CG", argv[i]) == 0 ) {
@@ -236,6 +289,12 @@ magma_zparse_opts(
             else if ( strcmp("JACOBI", argv[i]) == 0 ) {
                 opts->solver_par.solver = Magma_JACOBI;
             }
+            else if ( strcmp("GS", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_GS;
+            }
+            else if ( strcmp("SSOR", argv[i]) == 0 ) {
+                opts->solver_par.solver = Magma_SSOR;
+            }
             else if ( strcmp("BA", argv[i]) == 0 ) {
                 opts->solver_par.solver = Magma_BAITER;
             }
@@ -300,6 +359,21 @@ magma_zparse_opts(
             else if ( strcmp("JACOBI", argv[i]) == 0 ) {
                 opts->precond_par.solver = Magma_JACOBI;
             }
+            else if ( strcmp("BLOCKJACOBI", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_BLOCKJACOBI;
+            }
+            else if ( strcmp("GS", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_GS;
+            }
+            else if ( strcmp("SSOR", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_SSOR;
+            }
+            else if ( strcmp("AMG", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_AMG;
+            }
+            else if ( strcmp("RAS", argv[i]) == 0 ) {
+                opts->precond_par.solver = Magma_RAS;
+            }
             else if ( strcmp("BA", argv[i]) == 0 ) {
                 opts->precond_par.solver = Magma_BAITER;
             }
@@ -401,6 +475,15 @@ magma_zparse_opts(
             else if ( strcmp("ISAI", argv[i]) == 0 ) {
                 opts->precond_par.trisolver = Magma_ISAI;
             }
+            else if ( strcmp("LEVELSOLVE", argv[i]) == 0 ) {
+                opts->precond_par.trisolver = Magma_LEVELSOLVE;
+            }
+            else if ( strcmp("BLOCKLEVELSOLVE", argv[i]) == 0 ) {
+                opts->precond_par.trisolver = Magma_BLOCKLEVELSOLVE;
+            }
+            else if ( strcmp("CPUSYNCFREESOLVE", argv[i]) == 0 ) {
+                opts->precond_par.trisolver = Magma_CPUSYNCFREESOLVE;
+            }
             else if ( strcmp("NONE", argv[i]) == 0 ) {
                 opts->precond_par.trisolver = Magma_NONE;
             }
@@ -421,8 +504,43 @@ magma_zparse_opts(
             opts->precond_par.pattern = atoi( argv[++i] );
         } else if ( strcmp("--psweeps", argv[i]) == 0 && i+1 < argc ) {
             opts->precond_par.sweeps = atoi( argv[++i] );
+        } else if ( strcmp("--psweeptol", argv[i]) == 0 && i+1 < argc ) {
+            sscanf( argv[++i], "%lf", &opts->precond_par.sweeptol );
         } else if ( strcmp("--plevels", argv[i]) == 0 && i+1 < argc ) {
             opts->precond_par.levels = atoi( argv[++i] );
+        } else if ( strcmp("--pomega", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.omega = atof( argv[++i] );
+        } else if ( strcmp("--pbsize", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.bsize = atoi( argv[++i] );
+        } else if ( strcmp("--poverlap", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.overlap = atoi( argv[++i] );
+        } else if ( strcmp("--pdomains", argv[i]) == 0 && i+1 < argc ) {
+            opts->precond_par.subdomains = atoi( argv[++i] );
+        } else if ( strcmp("--ppartition", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            if ( strcmp("CONTIGUOUS", argv[i]) == 0 ) {
+                opts->precond_par.partition = Magma_NOREORDER;
+            }
+            else if ( strcmp("RCM", argv[i]) == 0 ) {
+                opts->precond_par.partition = Magma_RCM;
+            }
+            else {
+                printf( "%%error: invalid partition, use default.\n" );
+            }
+        } else if ( strcmp("--pformat", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            if ( strcmp("FLOAT", argv[i]) == 0 ) {
+                opts->precond_par.format = Magma_FLOAT;
+            }
+            else if ( strcmp("DOUBLE", argv[i]) == 0 ) {
+                opts->precond_par.format = Magma_DOUBLE;
+            }
+            else if ( strcmp("BF16", argv[i]) == 0 ) {
+                opts->precond_par.format = Magma_BFLOAT16;
+            }
+            else {
+                printf( "%%error: invalid precond format, use default.\n" );
+            }
         } else if ( strcmp("--blocksize", argv[i]) == 0 && i+1 < argc ) {
             opts->blocksize = atoi( argv[++i] );
         } else if ( strcmp("--alignment", argv[i]) == 0 && i+1 < argc ) {
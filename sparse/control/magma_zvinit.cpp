@@ -70,6 +70,10 @@ magma_zvinit(
     x->col = NULL;
     x->list = NULL;
     x->blockinfo = NULL;
+    x->val_low = NULL;
+    x->col_low = NULL;
+    x->col_base = NULL;
+    x->storage_precision = Magma_DCOMPLEX;
     x->dval = NULL;
     x->ddiag = NULL;
     x->drow = NULL;
@@ -164,6 +168,10 @@ magma_zvinit_rand(
     x->col = NULL;
     x->list = NULL;
     x->blockinfo = NULL;
+    x->val_low = NULL;
+    x->col_low = NULL;
+    x->col_base = NULL;
+    x->storage_precision = Magma_DCOMPLEX;
     x->dval = NULL;
     x->ddiag = NULL;
     x->drow = NULL;
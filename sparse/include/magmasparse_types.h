@@ -150,6 +150,10 @@ typedef struct magma_z_matrix
     magma_index_t      csr5_tail_tile_start;    // opt: info for CSR5
     magma_order_t      major;                   // opt: row/col major for dense matrices
     magma_int_t        ld;                      // opt: leading dimension for dense
+    magma_precision    storage_precision;       // opt: precision of the host SpMV copy
+    void               *val_low;                // opt: values in storage_precision (CPU)
+    unsigned short     *col_low;                // opt: 16-bit column offsets in row blocks (CPU)
+    magma_index_t      *col_base;               // opt: column base of row blocks, -1: 32-bit (CPU)
 } magma_z_matrix;
 
 typedef struct magma_c_matrix
@@ -223,6 +227,10 @@ typedef struct magma_c_matrix
     magma_index_t      csr5_tail_tile_start;    // opt: info for CSR5
     magma_order_t      major;                   // opt: row/col major for dense matrices
     magma_int_t        ld;                      // opt: leading dimension for dense
+    magma_precision    storage_precision;       // opt: precision of the host SpMV copy
+    void               *val_low;                // opt: values in storage_precision (CPU)
+    unsigned short     *col_low;                // opt: 16-bit column offsets in row blocks (CPU)
+    magma_index_t      *col_base;               // opt: column base of row blocks, -1: 32-bit (CPU)
 } magma_c_matrix;
 
 
@@ -297,6 +305,10 @@ typedef struct magma_d_matrix
     magma_index_t      csr5_tail_tile_start;    // opt: info for CSR5
     magma_order_t      major;                   // opt: row/col major for dense matrices
     magma_int_t        ld;                      // opt: leading dimension for dense
+    magma_precision    storage_precision;       // opt: precision of the host SpMV copy
+    void               *val_low;                // opt: values in storage_precision (CPU)
+    unsigned short     *col_low;                // opt: 16-bit column offsets in row blocks (CPU)
+    magma_index_t      *col_base;               // opt: column base of row blocks, -1: 32-bit (CPU)
 } magma_d_matrix;
 
 
@@ -371,6 +383,10 @@ typedef struct magma_s_matrix
     magma_index_t      csr5_tail_tile_start;    // opt: info for CSR5
     magma_order_t      major;                   // opt: row/col major for dense matrices
     magma_int_t        ld;                      // opt: leading dimension for dense
+    magma_precision    storage_precision;       // opt: precision of the host SpMV copy
+    void               *val_low;                // opt: values in storage_precision (CPU)
+    unsigned short     *col_low;                // opt: 16-bit column offsets in row blocks (CPU)
+    magma_index_t      *col_base;               // opt: column base of row blocks, -1: 32-bit (CPU)
 } magma_s_matrix;
 
 
@@ -613,12 +629,282 @@ typedef struct magma_s_solver_par
     #define hipsparseSolveAnalysisInfo_t csrsm2Info_t
 #endif
 
+// analysis of a host CSR triangular factor for the level-scheduled and
+// sync-free CPU trisolves, see magma_ztrisolve_cpu_analysis
+typedef struct magma_levelsched_t
+{
+    magma_solver_type       mode;       // LEVELSOLVE, BLOCKLEVELSOLVE or CPUSYNCFREESOLVE
+    magma_uplo_t            uplo;       // MagmaLower: forward, MagmaUpper: backward substitution
+    magma_int_t             num_rows;
+    magma_int_t             num_levels;
+    magma_int_t             num_blocks; // scheduling steps after merging thin levels
+    magma_int_t             thin;       // steps with fewer rows run on a single thread
+    magma_index_t          *level_ptr;  // level l holds perm[ level_ptr[l] : level_ptr[l+1] ]
+    magma_index_t          *perm;       // rows ordered by level
+    magma_index_t          *block_ptr;  // step b covers levels block_ptr[b] : block_ptr[b+1]
+    magma_index_t          *diag;       // position of the diagonal, -1 for implicit unit
+    magma_index_t          *indegree;   // sync-free: number of dependencies of each row
+    magma_index_t          *counter;    // sync-free: dependencies left during a solve
+    magma_index_t          *dep_ptr;    // sync-free: rows depending on row i are
+    magma_index_t          *dep_idx;    //   dep_idx[ dep_ptr[i] : dep_ptr[i+1] ]
+} magma_levelsched_t;
+
+// one level of the host smoothed-aggregation AMG hierarchy, see
+// magma_zamgsetup_cpu
+typedef struct magma_z_amg_level
+{
+    magma_z_matrix          A;          // level operator (CSR, CPU)
+    magma_z_matrix          P;          // prolongation from the next coarser level
+    magma_z_matrix          R;          // restriction, conjugate transpose of P
+    magmaDoubleComplex     *dinv;       // inverse diagonal of A
+    double                  lambda;     // estimate of the largest eigenvalue of D^{-1} A
+    magmaDoubleComplex     *x;          // level vectors
+    magmaDoubleComplex     *b;
+    magmaDoubleComplex     *r;
+    magmaDoubleComplex     *lu;         // coarsest level: dense LU factorization of A
+    magma_int_t            *ipiv;
+    magma_int_t             hermitian;  // finest level: A is Hermitian
+} magma_z_amg_level;
+
+// one level of the host smoothed-aggregation AMG hierarchy, see
+// magma_camgsetup_cpu
+typedef struct magma_c_amg_level
+{
+    magma_c_matrix          A;          // level operator (CSR, CPU)
+    magma_c_matrix          P;          // prolongation from the next coarser level
+    magma_c_matrix          R;          // restriction, conjugate transpose of P
+    magmaFloatComplex      *dinv;       // inverse diagonal of A
+    float                   lambda;     // estimate of the largest eigenvalue of D^{-1} A
+    magmaFloatComplex      *x;          // level vectors
+    magmaFloatComplex      *b;
+    magmaFloatComplex      *r;
+    magmaFloatComplex      *lu;         // coarsest level: dense LU factorization of A
+    magma_int_t            *ipiv;
+    magma_int_t             hermitian;  // finest level: A is Hermitian
+} magma_c_amg_level;
+
+// one level of the host smoothed-aggregation AMG hierarchy, see
+// magma_damgsetup_cpu
+typedef struct magma_d_amg_level
+{
+    magma_d_matrix          A;          // level operator (CSR, CPU)
+    magma_d_matrix          P;          // prolongation from the next coarser level
+    magma_d_matrix          R;          // restriction, conjugate transpose of P
+    double                 *dinv;       // inverse diagonal of A
+    double                  lambda;     // estimate of the largest eigenvalue of D^{-1} A
+    double                 *x;          // level vectors
+    double                 *b;
+    double                 *r;
+    double                 *lu;         // coarsest level: dense LU factorization of A
+    magma_int_t            *ipiv;
+    magma_int_t             symmetric;  // finest level: A is symmetric
+} magma_d_amg_level;
+
+// one level of the host smoothed-aggregation AMG hierarchy, see
+// magma_samgsetup_cpu
+typedef struct magma_s_amg_level
+{
+    magma_s_matrix          A;          // level operator (CSR, CPU)
+    magma_s_matrix          P;          // prolongation from the next coarser level
+    magma_s_matrix          R;          // restriction, conjugate transpose of P
+    float                  *dinv;       // inverse diagonal of A
+    float                   lambda;     // estimate of the largest eigenvalue of D^{-1} A
+    float                  *x;          // level vectors
+    float                  *b;
+    float                  *r;
+    float                  *lu;         // coarsest level: dense LU factorization of A
+    magma_int_t            *ipiv;
+    magma_int_t             symmetric;  // finest level: A is symmetric
+} magma_s_amg_level;
+
+// one subdomain of the host restricted additive Schwarz preconditioner, see
+// magma_zschwarzsetup_cpu
+typedef struct magma_z_schwarz_domain
+{
+    magma_int_t             n;          // rows of the subdomain including the overlap
+    magma_int_t             num_owned;  // rows owned by the subdomain
+    magma_index_t          *idx;        // global indices of the rows, ascending
+    magma_index_t          *owned;      // local indices of the owned rows
+    magma_z_matrix          A;          // local matrix (CSR, CPU), ILU(0) factors in place
+    magma_index_t          *diag;       // ILU(0): position of the diagonal in each row
+    magmaDoubleComplex     *lu;         // dense LU factorization of the local matrix
+    magma_int_t            *ipiv;
+    magmaDoubleComplex     *x;          // local vector
+} magma_z_schwarz_domain;
+
+// one subdomain of the host restricted additive Schwarz preconditioner, see
+// magma_cschwarzsetup_cpu
+typedef struct magma_c_schwarz_domain
+{
+    magma_int_t             n;          // rows of the subdomain including the overlap
+    magma_int_t             num_owned;  // rows owned by the subdomain
+    magma_index_t          *idx;        // global indices of the rows, ascending
+    magma_index_t          *owned;      // local indices of the owned rows
+    magma_c_matrix          A;          // local matrix (CSR, CPU), ILU(0) factors in place
+    magma_index_t          *diag;       // ILU(0): position of the diagonal in each row
+    magmaFloatComplex      *lu;         // dense LU factorization of the local matrix
+    magma_int_t            *ipiv;
+    magmaFloatComplex      *x;          // local vector
+} magma_c_schwarz_domain;
+
+// one subdomain of the host restricted additive Schwarz preconditioner, see
+// magma_dschwarzsetup_cpu
+typedef struct magma_d_schwarz_domain
+{
+    magma_int_t             n;          // rows of the subdomain including the overlap
+    magma_int_t             num_owned;  // rows owned by the subdomain
+    magma_index_t          *idx;        // global indices of the rows, ascending
+    magma_index_t          *owned;      // local indices of the owned rows
+    magma_d_matrix          A;          // local matrix (CSR, CPU), ILU(0) factors in place
+    magma_index_t          *diag;       // ILU(0): position of the diagonal in each row
+    double                 *lu;         // dense LU factorization of the local matrix
+    magma_int_t            *ipiv;
+    double                 *x;          // local vector
+} magma_d_schwarz_domain;
+
+// one subdomain of the host restricted additive Schwarz preconditioner, see
+// magma_sschwarzsetup_cpu
+typedef struct magma_s_schwarz_domain
+{
+    magma_int_t             n;          // rows of the subdomain including the overlap
+    magma_int_t             num_owned;  // rows owned by the subdomain
+    magma_index_t          *idx;        // global indices of the rows, ascending
+    magma_index_t          *owned;      // local indices of the owned rows
+    magma_s_matrix          A;          // local matrix (CSR, CPU), ILU(0) factors in place
+    magma_index_t          *diag;       // ILU(0): position of the diagonal in each row
+    float                  *lu;         // dense LU factorization of the local matrix
+    magma_int_t            *ipiv;
+    float                  *x;          // local vector
+} magma_s_schwarz_domain;
+
+// one factor of the incremental host ParILUT, see magma_zparilut_inc_init.
+// Row i holds its entries, sorted, in col[ start[i] ... start[i]+len[i]-1 ];
+// the slack up to start[i+1] takes new entries in place.
+typedef struct magma_z_parilut_factor
+{
+    magma_int_t             num_rows;   // rows, or columns for U
+    magma_int_t             nnz;        // entries in use
+    magma_int_t             capacity;   // length of col, val, work, pos
+    magma_index_t          *start;      // first position of every row, and capacity
+    magma_index_t          *len;        // entries in use of every row
+    magma_index_t          *col;        // column indices, or row indices for U
+    magmaDoubleComplex     *val;
+    magmaDoubleComplex     *work;       // values of the next sweep
+    magma_index_t          *pos;        // U, UT: position of the entry in UT, U
+} magma_z_parilut_factor;
+
+// factors of the incremental host ParILUT, see magma_zparilut_inc_init
+typedef struct magma_z_parilut_factors
+{
+    magma_int_t             n;
+    magma_z_parilut_factor  L;          // L by rows
+    magma_z_parilut_factor  U;          // U by columns
+    magma_z_parilut_factor  UT;         // pattern of U by rows
+    magma_z_parilut_factor  C;          // workspace: candidates by rows
+    magma_z_parilut_factor  CU;         // workspace: U candidates by columns
+    magma_index_t          *cnt;        // workspace: a count for every row
+    magma_index_t          *buf;        // workspace: candidate columns, per thread
+    magma_int_t             buf_size;
+} magma_z_parilut_factors;
+
+// one factor of the incremental host ParILUT, see magma_cparilut_inc_init.
+// Row i holds its entries, sorted, in col[ start[i] ... start[i]+len[i]-1 ];
+// the slack up to start[i+1] takes new entries in place.
+typedef struct magma_c_parilut_factor
+{
+    magma_int_t             num_rows;   // rows, or columns for U
+    magma_int_t             nnz;        // entries in use
+    magma_int_t             capacity;   // length of col, val, work, pos
+    magma_index_t          *start;      // first position of every row, and capacity
+    magma_index_t          *len;        // entries in use of every row
+    magma_index_t          *col;        // column indices, or row indices for U
+    magmaFloatComplex     *val;
+    magmaFloatComplex     *work;       // values of the next sweep
+    magma_index_t          *pos;        // U, UT: position of the entry in UT, U
+} magma_c_parilut_factor;
+
+// factors of the incremental host ParILUT, see magma_cparilut_inc_init
+typedef struct magma_c_parilut_factors
+{
+    magma_int_t             n;
+    magma_c_parilut_factor  L;          // L by rows
+    magma_c_parilut_factor  U;          // U by columns
+    magma_c_parilut_factor  UT;         // pattern of U by rows
+    magma_c_parilut_factor  C;          // workspace: candidates by rows
+    magma_c_parilut_factor  CU;         // workspace: U candidates by columns
+    magma_index_t          *cnt;        // workspace: a count for every row
+    magma_index_t          *buf;        // workspace: candidate columns, per thread
+    magma_int_t             buf_size;
+} magma_c_parilut_factors;
+
+// one factor of the incremental host ParILUT, see magma_dparilut_inc_init.
+// Row i holds its entries, sorted, in col[ start[i] ... start[i]+len[i]-1 ];
+// the slack up to start[i+1] takes new entries in place.
+typedef struct magma_d_parilut_factor
+{
+    magma_int_t             num_rows;   // rows, or columns for U
+    magma_int_t             nnz;        // entries in use
+    magma_int_t             capacity;   // length of col, val, work, pos
+    magma_index_t          *start;      // first position of every row, and capacity
+    magma_index_t          *len;        // entries in use of every row
+    magma_index_t          *col;        // column indices, or row indices for U
+    double                *val;
+    double                *work;       // values of the next sweep
+    magma_index_t          *pos;        // U, UT: position of the entry in UT, U
+} magma_d_parilut_factor;
+
+// factors of the incremental host ParILUT, see magma_dparilut_inc_init
+typedef struct magma_d_parilut_factors
+{
+    magma_int_t             n;
+    magma_d_parilut_factor  L;          // L by rows
+    magma_d_parilut_factor  U;          // U by columns
+    magma_d_parilut_factor  UT;         // pattern of U by rows
+    magma_d_parilut_factor  C;          // workspace: candidates by rows
+    magma_d_parilut_factor  CU;         // workspace: U candidates by columns
+    magma_index_t          *cnt;        // workspace: a count for every row
+    magma_index_t          *buf;        // workspace: candidate columns, per thread
+    magma_int_t             buf_size;
+} magma_d_parilut_factors;
+
+// one factor of the incremental host ParILUT, see magma_sparilut_inc_init.
+// Row i holds its entries, sorted, in col[ start[i] ... start[i]+len[i]-1 ];
+// the slack up to start[i+1] takes new entries in place.
+typedef struct magma_s_parilut_factor
+{
+    magma_int_t             num_rows;   // rows, or columns for U
+    magma_int_t             nnz;        // entries in use
+    magma_int_t             capacity;   // length of col, val, work, pos
+    magma_index_t          *start;      // first position of every row, and capacity
+    magma_index_t          *len;        // entries in use of every row
+    magma_index_t          *col;        // column indices, or row indices for U
+    float                 *val;
+    float                 *work;       // values of the next sweep
+    magma_index_t          *pos;        // U, UT: position of the entry in UT, U
+} magma_s_parilut_factor;
+
+// factors of the incremental host ParILUT, see magma_sparilut_inc_init
+typedef struct magma_s_parilut_factors
+{
+    magma_int_t             n;
+    magma_s_parilut_factor  L;          // L by rows
+    magma_s_parilut_factor  U;          // U by columns
+    magma_s_parilut_factor  UT;         // pattern of U by rows
+    magma_s_parilut_factor  C;          // workspace: candidates by rows
+    magma_s_parilut_factor  CU;         // workspace: U candidates by columns
+    magma_index_t          *cnt;        // workspace: a count for every row
+    magma_index_t          *buf;        // workspace: candidate columns, per thread
+    magma_int_t             buf_size;
+} magma_s_parilut_factors;
+
 typedef struct magma_z_preconditioner
 {
     magma_solver_type       solver;
     magma_solver_type       trisolver;
     magma_int_t             levels;
     magma_int_t             sweeps;
+    magma_int_t             sweeps_used;             // feedback: sweeps done by adaptive ParILU
+    double                  sweeptol;                // opt: ParILU factor-change tolerance (0 = fixed sweeps)
     magma_int_t             pattern;
     magma_int_t             bsize;
     magma_int_t             offset;
@@ -658,6 +944,26 @@ typedef struct magma_z_preconditioner
     magma_index_t*            L_dgraphindegree_bak; // for sync-free trisolve
     magma_index_t*            U_dgraphindegree;     // for sync-free trisolve
     magma_index_t*            U_dgraphindegree_bak; // for sync-free trisolve
+    magma_levelsched_t*       Lsched;               // for CPU level-scheduled trisolve
+    magma_levelsched_t*       Usched;               // for CPU level-scheduled trisolve
+    magma_int_t               num_blocks;           // for CPU block-Jacobi
+    magma_index_t*            block_ptr;            // for CPU block-Jacobi
+    magma_index_t*            block_val_ptr;        // for CPU block-Jacobi
+    magmaDoubleComplex*       block_val;            // for CPU block-Jacobi
+    float*                    block_val_low;        // for CPU block-Jacobi
+    double                    omega;                // relaxation weight for CPU GS/SSOR
+    magma_int_t               num_colors;           // for CPU multicolor GS/SSOR
+    magma_index_t*            color_ptr;            // for CPU multicolor GS/SSOR
+    magma_index_t*            color_perm;           // for CPU multicolor GS/SSOR
+    magmaDoubleComplex*       color_dinv;           // for CPU multicolor GS/SSOR
+    magmaDoubleComplex*       color_work;           // for CPU multicolor GS/SSOR
+    magma_int_t               amg_num_levels;       // for CPU smoothed-aggregation AMG
+    magma_z_amg_level*       amg_levels;           // for CPU smoothed-aggregation AMG
+    magma_int_t               overlap;              // for CPU Schwarz: levels of overlap
+    magma_int_t               subdomains;           // for CPU Schwarz: requested subdomains
+    magma_reorder_t           partition;            // for CPU Schwarz: Magma_NOREORDER or Magma_RCM
+    magma_int_t               schwarz_num_domains;  // for CPU Schwarz
+    magma_z_schwarz_domain*  schwarz_domains;      // for CPU Schwarz
     
     /* was merge conflict, assume master */
     magma_solve_info_t cuinfo;
@@ -680,6 +986,8 @@ typedef struct magma_c_preconditioner
     magma_solver_type       trisolver;
     magma_int_t             levels;
     magma_int_t             sweeps;
+    magma_int_t             sweeps_used;             // feedback: sweeps done by adaptive ParILU
+    float                   sweeptol;                // opt: ParILU factor-change tolerance (0 = fixed sweeps)
     magma_int_t             pattern;
     magma_int_t             bsize;
     magma_int_t             offset;
@@ -719,6 +1027,26 @@ typedef struct magma_c_preconditioner
     magma_index_t*            L_dgraphindegree_bak; // for sync-free trisolve
     magma_index_t*            U_dgraphindegree;     // for sync-free trisolve
     magma_index_t*            U_dgraphindegree_bak; // for sync-free trisolve
+    magma_levelsched_t*       Lsched;               // for CPU level-scheduled trisolve
+    magma_levelsched_t*       Usched;               // for CPU level-scheduled trisolve
+    magma_int_t               num_blocks;           // for CPU block-Jacobi
+    magma_index_t*            block_ptr;            // for CPU block-Jacobi
+    magma_index_t*            block_val_ptr;        // for CPU block-Jacobi
+    magmaFloatComplex*        block_val;            // for CPU block-Jacobi
+    float*                    block_val_low;        // for CPU block-Jacobi
+    float                     omega;                // relaxation weight for CPU GS/SSOR
+    magma_int_t               num_colors;           // for CPU multicolor GS/SSOR
+    magma_index_t*            color_ptr;            // for CPU multicolor GS/SSOR
+    magma_index_t*            color_perm;           // for CPU multicolor GS/SSOR
+    magmaFloatComplex*        color_dinv;           // for CPU multicolor GS/SSOR
+    magmaFloatComplex*        color_work;           // for CPU multicolor GS/SSOR
+    magma_int_t               amg_num_levels;       // for CPU smoothed-aggregation AMG
+    magma_c_amg_level*       amg_levels;           // for CPU smoothed-aggregation AMG
+    magma_int_t               overlap;              // for CPU Schwarz: levels of overlap
+    magma_int_t               subdomains;           // for CPU Schwarz: requested subdomains
+    magma_reorder_t           partition;            // for CPU Schwarz: Magma_NOREORDER or Magma_RCM
+    magma_int_t               schwarz_num_domains;  // for CPU Schwarz
+    magma_c_schwarz_domain*  schwarz_domains;      // for CPU Schwarz
     
 
     magma_solve_info_t cuinfo;
@@ -743,6 +1071,8 @@ typedef struct magma_d_preconditioner
     magma_solver_type       trisolver;
     magma_int_t             levels;
     magma_int_t             sweeps;
+    magma_int_t             sweeps_used;             // feedback: sweeps done by adaptive ParILU
+    double                  sweeptol;                // opt: ParILU factor-change tolerance (0 = fixed sweeps)
     magma_int_t             pattern;
     magma_int_t             bsize;
     magma_int_t             offset;
@@ -782,6 +1112,26 @@ typedef struct magma_d_preconditioner
     magma_index_t*            L_dgraphindegree_bak; // for sync-free trisolve
     magma_index_t*            U_dgraphindegree;     // for sync-free trisolve
     magma_index_t*            U_dgraphindegree_bak; // for sync-free trisolve
+    magma_levelsched_t*       Lsched;               // for CPU level-scheduled trisolve
+    magma_levelsched_t*       Usched;               // for CPU level-scheduled trisolve
+    magma_int_t               num_blocks;           // for CPU block-Jacobi
+    magma_index_t*            block_ptr;            // for CPU block-Jacobi
+    magma_index_t*            block_val_ptr;        // for CPU block-Jacobi
+    double*                   block_val;            // for CPU block-Jacobi
+    float*                    block_val_low;        // for CPU block-Jacobi
+    double                    omega;                // relaxation weight for CPU GS/SSOR
+    magma_int_t               num_colors;           // for CPU multicolor GS/SSOR
+    magma_index_t*            color_ptr;            // for CPU multicolor GS/SSOR
+    magma_index_t*            color_perm;           // for CPU multicolor GS/SSOR
+    double*                   color_dinv;           // for CPU multicolor GS/SSOR
+    double*                   color_work;           // for CPU multicolor GS/SSOR
+    magma_int_t               amg_num_levels;       // for CPU smoothed-aggregation AMG
+    magma_d_amg_level*       amg_levels;           // for CPU smoothed-aggregation AMG
+    magma_int_t               overlap;              // for CPU Schwarz: levels of overlap
+    magma_int_t               subdomains;           // for CPU Schwarz: requested subdomains
+    magma_reorder_t           partition;            // for CPU Schwarz: Magma_NOREORDER or Magma_RCM
+    magma_int_t               schwarz_num_domains;  // for CPU Schwarz
+    magma_d_schwarz_domain*  schwarz_domains;      // for CPU Schwarz
 
     magma_solve_info_t cuinfo;
     magma_solve_info_t cuinfoL;
@@ -804,6 +1154,8 @@ typedef struct magma_s_preconditioner
     magma_solver_type       trisolver;
     magma_int_t             levels;
     magma_int_t             sweeps;
+    magma_int_t             sweeps_used;             // feedback: sweeps done by adaptive ParILU
+    float                   sweeptol;                // opt: ParILU factor-change tolerance (0 = fixed sweeps)
     magma_int_t             pattern;
     magma_int_t             bsize;
     magma_int_t             offset;
@@ -843,6 +1195,26 @@ typedef struct magma_s_preconditioner
     magma_index_t*            L_dgraphindegree_bak; // for sync-free trisolve
     magma_index_t*            U_dgraphindegree;     // for sync-free trisolve
     magma_index_t*            U_dgraphindegree_bak; // for sync-free trisolve
+    magma_levelsched_t*       Lsched;               // for CPU level-scheduled trisolve
+    magma_levelsched_t*       Usched;               // for CPU level-scheduled trisolve
+    magma_int_t               num_blocks;           // for CPU block-Jacobi
+    magma_index_t*            block_ptr;            // for CPU block-Jacobi
+    magma_index_t*            block_val_ptr;        // for CPU block-Jacobi
+    float*                    block_val;            // for CPU block-Jacobi
+    float*                    block_val_low;        // for CPU block-Jacobi
+    float                     omega;                // relaxation weight for CPU GS/SSOR
+    magma_int_t               num_colors;           // for CPU multicolor GS/SSOR
+    magma_index_t*            color_ptr;            // for CPU multicolor GS/SSOR
+    magma_index_t*            color_perm;           // for CPU multicolor GS/SSOR
+    float*                    color_dinv;           // for CPU multicolor GS/SSOR
+    float*                    color_work;           // for CPU multicolor GS/SSOR
+    magma_int_t               amg_num_levels;       // for CPU smoothed-aggregation AMG
+    magma_s_amg_level*       amg_levels;           // for CPU smoothed-aggregation AMG
+    magma_int_t               overlap;              // for CPU Schwarz: levels of overlap
+    magma_int_t               subdomains;           // for CPU Schwarz: requested subdomains
+    magma_reorder_t           partition;            // for CPU Schwarz: Magma_NOREORDER or Magma_RCM
+    magma_int_t               schwarz_num_domains;  // for CPU Schwarz
+    magma_s_schwarz_domain*  schwarz_domains;      // for CPU Schwarz
     
     magma_solve_info_t cuinfo;
     magma_solve_info_t cuinfoL;
@@ -879,6 +1251,7 @@ typedef struct magma_zopts
     magma_location_t        input_location;
     magma_location_t        output_location;
     magma_scale_t           scaling;
+    magma_reorder_t         reordering;
 } magma_zopts;
 
 typedef struct magma_copts
@@ -895,6 +1268,7 @@ typedef struct magma_copts
     magma_location_t        input_location;
     magma_location_t        output_location;
     magma_scale_t           scaling;
+    magma_reorder_t         reordering;
 } magma_copts;
 
 typedef struct magma_dopts
@@ -911,6 +1285,7 @@ typedef struct magma_dopts
     magma_location_t        input_location;
     magma_location_t        output_location;
     magma_scale_t           scaling;
+    magma_reorder_t         reordering;
 } magma_dopts;
 
 typedef struct magma_sopts
@@ -927,6 +1302,7 @@ typedef struct magma_sopts
     magma_location_t        input_location;
     magma_location_t        output_location;
     magma_scale_t           scaling;
+    magma_reorder_t         reordering;
 } magma_sopts;
 
 #ifdef __cplusplus
@@ -254,6 +254,51 @@ magma_zmscale(
     magma_scale_t scaling,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmreorder(
+    magma_z_matrix *A,
+    magma_reorder_t reordering,
+    magma_index_t **perm,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmreorder_rcm(
+    magma_z_matrix A,
+    magma_index_t **perm,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmreorder_amd(
+    magma_z_matrix A,
+    magma_index_t **perm,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmreorder_multicolor(
+    magma_z_matrix A,
+    magma_int_t *num_colors,
+    magma_index_t **color_ptr,
+    magma_index_t **perm,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmpermute(
+    magma_index_t *perm,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zvpermute(
+    magma_index_t *perm,
+    magma_z_matrix *x,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zvunpermute(
+    magma_index_t *perm,
+    magma_z_matrix *x,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zmscale_matrix_rhs(
     magma_z_matrix *A,
@@ -279,6 +324,21 @@ magma_zmscale_apply(
       magma_z_matrix* A,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmequilibrate(
+    magma_scale_t scaling,
+    magma_int_t maxiter,
+    magma_z_matrix *A,
+    magma_z_matrix *dr,
+    magma_z_matrix *dc,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmequilibrate_vector(
+    magma_z_matrix d,
+    magma_z_matrix *x,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zdimv( 
   magma_z_matrix* vecA, 
@@ -424,6 +484,30 @@ magma_zselectrandom(
     magma_int_t k,
     magma_queue_t queue );
 
+magma_int_t
+magma_zsampleselect_cpu(
+    magma_int_t size,
+    const magmaDoubleComplex *val,
+    magma_int_t k,
+    magma_int_t max_err,
+    magma_int_t seed,
+    double *thrs,
+    magma_int_t *rank_err,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zsampleselect2_cpu(
+    magma_int_t size1,
+    const magmaDoubleComplex *val1,
+    magma_int_t size2,
+    const magmaDoubleComplex *val2,
+    magma_int_t k,
+    magma_int_t max_err,
+    magma_int_t seed,
+    double *thrs,
+    magma_int_t *rank_err,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zdomainoverlap(
     magma_index_t num_rows,
@@ -441,6 +525,33 @@ magma_zsymbilu(
     magma_z_matrix *U,
     magma_queue_t queue );
 
+magma_int_t
+magma_zsymbolic_ilu(
+    const magma_int_t levfill,
+    const magma_int_t n,
+    magma_int_t *nzl,
+    magma_int_t *nzu,
+    const magma_index_t *ia,
+    const magma_index_t *ja,
+    magma_index_t *ial,
+    magma_index_t *jal,
+    magma_index_t *iau,
+    magma_index_t *jau );
+
+magma_int_t
+magma_zsymbolic_ilu_mt(
+    const magma_int_t levfill,
+    const magma_int_t n,
+    magma_int_t *nzl,
+    magma_int_t *nzu,
+    const magma_index_t *ia,
+    const magma_index_t *ja,
+    magma_index_t *ial,
+    magma_index_t **jal,
+    magma_index_t *iau,
+    magma_index_t **jau,
+    magma_queue_t queue );
+
 
 magma_int_t 
 magma_zwrite_csr_mtx( 
@@ -791,6 +902,15 @@ magma_zilures(
     real_Double_t *nonlinres,
     magma_queue_t queue );
 
+magma_int_t 
+magma_zparilu_sampledres(
+    magma_z_matrix A, 
+    magma_z_matrix L,
+    magma_z_matrix U, 
+    magma_int_t stride,
+    real_Double_t *res,
+    magma_queue_t queue );
+
 magma_int_t 
 magma_zicres(       
     magma_z_matrix A, 
@@ -1079,6 +1199,14 @@ magma_zparilu_sweep_sync(
     magma_z_matrix *U,
     magma_queue_t queue );
 
+magma_int_t
+magma_zparilu_sweep_monitor(
+    magma_z_matrix A,
+    magma_z_matrix *L,
+    magma_z_matrix *U,
+    double *change,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zparic_sweep(
     magma_z_matrix A,
@@ -1104,6 +1232,56 @@ magma_zparilut_sweep_sync(
     magma_z_matrix *U,
     magma_queue_t queue );
 
+magma_int_t
+magma_zparilut_inc_init(
+    magma_z_matrix L,
+    magma_z_matrix U,
+    magma_z_parilut_factors *F,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparilut_inc_add(
+    magma_z_matrix *A,
+    magma_z_matrix *L0,
+    magma_z_matrix *U0,
+    magma_z_parilut_factors *F,
+    double *sum,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparilut_inc_sweep(
+    magma_z_matrix *A,
+    magma_z_parilut_factors *F,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparilut_inc_thrs(
+    magma_int_t num_rmL,
+    magma_int_t num_rmU,
+    magma_z_parilut_factors *F,
+    double *thrsL,
+    double *thrsU,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparilut_inc_rm(
+    double thrsL,
+    double thrsU,
+    magma_z_parilut_factors *F,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparilut_inc_get(
+    magma_z_parilut_factors *F,
+    magma_z_matrix *L,
+    magma_z_matrix *U,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zparilut_inc_free(
+    magma_z_parilut_factors *F,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zparilut_sweep_gpu( 
     magma_z_matrix *A,
@@ -1593,6 +1771,31 @@ magma_zisai_generator_regs(
     magma_z_matrix *M,
     magma_queue_t queue );
 
+magma_int_t
+magma_zisai_generator_cpu(
+    magma_uplo_t uplotype,
+    magma_trans_t transtype,
+    magma_diag_t diagtype,
+    magma_z_matrix L,
+    magma_z_matrix *M,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zisai_pattern_cpu(
+    magma_z_matrix L,
+    magma_int_t k,
+    magma_z_matrix *S,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zisaisetup_cpu(
+    magma_uplo_t uplotype,
+    magma_z_matrix L,
+    magma_z_matrix S,
+    magma_int_t k,
+    magma_z_matrix *ISAI,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zcsr_sort(
     magma_z_matrix *A,
@@ -1883,6 +2086,13 @@ magma_zjacobi(
     magma_z_matrix *x, magma_z_solver_par *solver_par,
     magma_queue_t queue );
 
+magma_int_t
+magma_zmcgs(
+    magma_z_matrix A, magma_z_matrix b,
+    magma_z_matrix *x, magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
 magma_int_t
 magma_zjacobidomainoverlap(
     magma_z_matrix A, 
@@ -2006,6 +2216,13 @@ magma_zlobpcg(
     magma_z_preconditioner *precond_par, 
     magma_queue_t queue );
 
+magma_int_t
+magma_zlobpcg_cpu(
+    magma_z_matrix A,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue );
+
 /*/////////////////////////////////////////////////////////////////////////////
  -- MAGMA_SPARSE LSQR (Data on GPU)
 */
@@ -2210,6 +2427,169 @@ magma_zapplycumilu_r_transpose(
     magma_z_preconditioner *precond,
     magma_queue_t queue );
 
+magma_int_t
+magma_ztrisolve_cpu_analysis(
+    magma_z_matrix T,
+    magma_solver_type mode,
+    magma_levelsched_t **sched,
+    magma_queue_t queue );
+
+magma_int_t
+magma_ztrisolve_cpu_free(
+    magma_levelsched_t **sched,
+    magma_queue_t queue );
+
+magma_int_t
+magma_ztrisolve_cpu(
+    magma_z_matrix T,
+    magma_levelsched_t *sched,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_queue_t queue );
+
+magma_int_t
+magma_ztrisolve_cpu_setup(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplytrisolve_cpu_l(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplytrisolve_cpu_r(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zbjacobisetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplybjacobi_cpu(
+    magma_trans_t trans,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmcgssetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmcgs_sweeps_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_int_t sweeps,
+    magma_int_t zero_init,
+    double *res,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplymcgs_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplymcgs_transpose_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zspgemm_cpu(
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *C,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zspgemm_ex_cpu(
+    magma_trans_t transA,
+    magma_z_matrix A,
+    magma_z_matrix B,
+    magma_z_matrix *M,
+    magma_int_t max_products,
+    magma_z_matrix *C,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zamgsetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyamg_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyamg_transpose_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zamgfree_cpu(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zschwarzsetup_cpu(
+    magma_z_matrix A,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zapplyschwarz_cpu(
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zschwarzfree_cpu(
+    magma_z_preconditioner *precond,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmlowprec_cpu(
+    magma_precision precision,
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zmlowprec_free(
+    magma_z_matrix *A,
+    magma_queue_t queue );
+
+magma_int_t
+magma_zspmv_lowprec_cpu(
+    magmaDoubleComplex alpha,
+    magma_z_matrix A,
+    magma_z_matrix x,
+    magmaDoubleComplex beta,
+    magma_z_matrix y,
+    magma_queue_t queue );
+
 
 
 magma_int_t
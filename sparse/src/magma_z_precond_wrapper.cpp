@@ -156,6 +156,19 @@ magma_z_precondsetup(
     if ( precond->solver == Magma_JACOBI ) {
         info = magma_zjacobisetup_diagscal( A, &(precond->d), queue );
     }
+    else if ( precond->solver == Magma_BLOCKJACOBI ) {
+        info = magma_zbjacobisetup_cpu( A, precond, queue );
+    }
+    else if ( precond->solver == Magma_GS ||
+              precond->solver == Magma_SSOR ) {
+        info = magma_zmcgssetup_cpu( A, precond, queue );
+    }
+    else if ( precond->solver == Magma_AMG ) {
+        info = magma_zamgsetup_cpu( A, precond, queue );
+    }
+    else if ( precond->solver == Magma_RAS ) {
+        info = magma_zschwarzsetup_cpu( A, precond, queue );
+    }
     else if ( precond->solver == Magma_PASTIX ) {
         //info = magma_zpastixsetup( A, b, precond, queue );
         info = MAGMA_ERR_NOT_SUPPORTED;
@@ -281,6 +294,17 @@ magma_z_precondsetup(
         }
     }
     
+    // host trisolves: move the factors to the CPU and analyze them, the
+    // transposed factors above stay with cuSPARSE
+    if ( info == 0 &&
+         ( precond->solver == Magma_ILU ||
+           precond->solver == Magma_PARILU ) &&
+         ( precond->trisolver == Magma_LEVELSOLVE ||
+           precond->trisolver == Magma_BLOCKLEVELSOLVE ||
+           precond->trisolver == Magma_CPUSYNCFREESOLVE ) ) {
+        info = magma_ztrisolve_cpu_setup( precond, queue );
+    }
+    
     tempo2 = magma_sync_wtime( queue );
     precond->setuptime = tempo2-tempo1;
     
@@ -339,6 +363,16 @@ magma_z_applyprecond(
     if ( precond->solver == Magma_JACOBI ) {
         CHECK( magma_zjacobi_diagscal( b.num_rows, precond->d, b, x, queue ));
     }
+    else if ( precond->solver == Magma_GS ||
+              precond->solver == Magma_SSOR ) {
+        CHECK( magma_zapplymcgs_cpu( b, x, precond, queue ));
+    }
+    else if ( precond->solver == Magma_AMG ) {
+        CHECK( magma_zapplyamg_cpu( b, x, precond, queue ));
+    }
+    else if ( precond->solver == Magma_RAS ) {
+        CHECK( magma_zapplyschwarz_cpu( b, x, precond, queue ));
+    }
     else if ( precond->solver == Magma_PASTIX ) {
         //CHECK( magma_zapplypastix( b, x, precond, queue ));
         info = MAGMA_ERR_NOT_SUPPORTED;
@@ -426,11 +460,26 @@ magma_z_applyprecond_left(
     zopts.solver_par.restart = 50;
     zopts.solver_par.atol = 1e-16;
     zopts.solver_par.rtol = 1e-10;
+    zopts.precond_par.solver = Magma_NONE;
+    CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
     
     if( trans == MagmaNoTrans ) {
         if ( precond->solver == Magma_JACOBI ) {
             CHECK( magma_zjacobi_diagscal( b.num_rows, precond->d, b, x, queue ));
         }
+        else if ( precond->solver == Magma_BLOCKJACOBI ) {
+            CHECK( magma_zapplybjacobi_cpu( trans, b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_GS ||
+                  precond->solver == Magma_SSOR ) {
+            CHECK( magma_zapplymcgs_cpu( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_AMG ) {
+            CHECK( magma_zapplyamg_cpu( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_RAS ) {
+            CHECK( magma_zapplyschwarz_cpu( b, x, precond, queue ));
+        }
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
@@ -442,6 +491,13 @@ magma_z_applyprecond_left(
                   ( precond->trisolver == Magma_SYNCFREESOLVE ) ){
             CHECK( magma_zapplycumilu_l( b, x, precond, queue ));
         }
+        else if ( ( precond->solver == Magma_ILU ||
+                    precond->solver == Magma_PARILU ) && 
+                  ( precond->trisolver == Magma_LEVELSOLVE ||
+                    precond->trisolver == Magma_BLOCKLEVELSOLVE ||
+                    precond->trisolver == Magma_CPUSYNCFREESOLVE ) ){
+            CHECK( magma_zapplytrisolve_cpu_l( b, x, precond, queue ));
+        }
         else if (precond->solver == Magma_ILUT) {
             printf( "error: preconditioner requires OpenMP.\n" );
             info = MAGMA_ERR_NOT_SUPPORTED;
@@ -487,9 +543,22 @@ magma_z_applyprecond_left(
         if ( precond->solver == Magma_JACOBI ) {
             CHECK( magma_zjacobi_diagscal( b.num_rows, precond->d, b, x, queue ));
         }
+        else if ( precond->solver == Magma_BLOCKJACOBI ) {
+            CHECK( magma_zapplybjacobi_cpu( trans, b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_GS ||
+                  precond->solver == Magma_SSOR ) {
+            CHECK( magma_zapplymcgs_transpose_cpu( b, x, precond, queue ));
+        }
+        else if ( precond->solver == Magma_AMG ) {
+            CHECK( magma_zapplyamg_transpose_cpu( b, x, precond, queue ));
+        }
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
+                    precond->trisolver == Magma_LEVELSOLVE ||
+                    precond->trisolver == Magma_BLOCKLEVELSOLVE ||
+                    precond->trisolver == Magma_CPUSYNCFREESOLVE ||
                     precond->trisolver == 0 ) ){
             CHECK( magma_zapplycumilu_l_transpose( b, x, precond, queue ));
         }
@@ -596,11 +665,25 @@ magma_z_applyprecond_right(
     zopts.solver_par.restart = 50;
     zopts.solver_par.atol = 1e-16;
     zopts.solver_par.rtol = 1e-10;
+    zopts.precond_par.solver = Magma_NONE;
+    CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
     
     if( trans == MagmaNoTrans ) {
         if ( precond->solver == Magma_JACOBI ) {
             magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
         }
+        else if ( precond->solver == Magma_BLOCKJACOBI ||
+                  precond->solver == Magma_GS ||
+                  precond->solver == Magma_SSOR ||
+                  precond->solver == Magma_AMG ||
+                  precond->solver == Magma_RAS ) {
+            if ( b.memory_location == Magma_CPU ) {
+                magma_int_t num = b.num_rows*b.num_cols, ione = 1;
+                blasf77_zcopy( &num, b.val, &ione, x->val, &ione );     // x = b
+            } else {
+                magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
+            }
+        }
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
@@ -612,6 +695,13 @@ magma_z_applyprecond_right(
                   ( precond->trisolver == Magma_SYNCFREESOLVE ) ){
             CHECK( magma_zapplycumilu_r( b, x, precond, queue ));
         }
+        else if ( ( precond->solver == Magma_ILU ||
+                    precond->solver == Magma_PARILU ) && 
+                  ( precond->trisolver == Magma_LEVELSOLVE ||
+                    precond->trisolver == Magma_BLOCKLEVELSOLVE ||
+                    precond->trisolver == Magma_CPUSYNCFREESOLVE ) ){
+            CHECK( magma_zapplytrisolve_cpu_r( b, x, precond, queue ));
+        }
         else if (precond->solver == Magma_ILUT) {
             printf( "error: preconditioner requires OpenMP.\n" );
             info = MAGMA_ERR_NOT_SUPPORTED;
@@ -661,9 +751,24 @@ magma_z_applyprecond_right(
         if ( precond->solver == Magma_JACOBI ) {
             magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
         }
+        else if ( precond->solver == Magma_BLOCKJACOBI ||
+                  precond->solver == Magma_GS ||
+                  precond->solver == Magma_SSOR ||
+                  precond->solver == Magma_AMG ||
+                  precond->solver == Magma_RAS ) {
+            if ( b.memory_location == Magma_CPU ) {
+                magma_int_t num = b.num_rows*b.num_cols, ione = 1;
+                blasf77_zcopy( &num, b.val, &ione, x->val, &ione );     // x = b
+            } else {
+                magma_zcopy( b.num_rows*b.num_cols, b.dval, 1, x->dval, 1, queue );    // x = b
+            }
+        }
         else if ( ( precond->solver == Magma_ILU ||
                     precond->solver == Magma_PARILU ) && 
                   ( precond->trisolver == Magma_CUSOLVE ||
+                    precond->trisolver == Magma_LEVELSOLVE ||
+                    precond->trisolver == Magma_BLOCKLEVELSOLVE ||
+                    precond->trisolver == Magma_CPUSYNCFREESOLVE ||
                     precond->trisolver == 0 ) ){
             CHECK( magma_zapplycumilu_r_transpose( b, x, precond, queue ));
         }
@@ -134,6 +134,10 @@ magma_z_solver(
                     CHECK( magma_ziterref( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_JACOBI:
                     CHECK( magma_zjacobi( A, b, x, &zopts->solver_par, queue )); break;
+            case  Magma_GS:
+                    CHECK( magma_zmcgs( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
+            case  Magma_SSOR:
+                    CHECK( magma_zmcgs( A, b, x, &zopts->solver_par, &zopts->precond_par, queue )); break;
             case  Magma_BAITER:
                     CHECK( magma_zbaiter( A, b, x, &zopts->solver_par, &zopts->precond_par, queue ) ); break;
             case  Magma_BAITERO:
@@ -0,0 +1,156 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> s d c
+*/
+
+#include "magmasparse_internal.h"
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    with the multicolor Gauss-Seidel (solver_par->solver = Magma_GS) or
+    symmetric SOR (Magma_SSOR) iteration on the CPU. The relaxation weight
+    is taken from precond_par->omega (1.0 if unset). The iteration stops once
+    the relative residual drops below solver_par->rtol.
+
+    Arguments
+    ---------
+
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in]
+    b           magma_z_matrix
+                RHS b
+
+    @param[in,out]
+    x           magma_z_matrix*
+                solution approximation
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in]
+    precond_par magma_z_preconditioner*
+                relaxation parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zmcgs(
+    magma_z_matrix A,
+    magma_z_matrix b,
+    magma_z_matrix *x,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = MAGMA_NOTCONVERGED;
+
+    real_Double_t tempo1, tempo2;
+    double nom0, nomb, res, r0;
+    magma_int_t dofs = A.num_rows;
+    magma_location_t x_location = x->memory_location;
+
+    magma_z_matrix hb={Magma_CSR}, hx={Magma_CSR};
+    magma_z_preconditioner gs_par={Magma_GS};
+
+    // prepare solver feedback
+    if( solver_par->solver != Magma_SSOR ){
+        solver_par->solver = Magma_GS;
+    }
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+    solver_par->info = MAGMA_SUCCESS;
+
+    // multicolor setup, the iteration runs on host copies of b and x
+    gs_par.solver = solver_par->solver;
+    gs_par.omega = precond_par->omega;
+    CHECK( magma_zmcgssetup_cpu( A, &gs_par, queue ));
+    CHECK( magma_zmtransfer( b, &hb, b.memory_location, Magma_CPU, queue ));
+    CHECK( magma_zmtransfer( *x, &hx, x->memory_location, Magma_CPU, queue ));
+
+    CHECK( magma_zmcgs_sweeps_cpu( hb, &hx, 0, 0, &nom0, &gs_par, queue ));
+    nomb = magma_cblas_dznrm2( dofs, hb.val, 1 );
+    if ( nomb == 0.0 ){
+        nomb=1.0;
+    }
+    if ( (r0 = nomb * solver_par->rtol) < ATOLERANCE ){
+        r0 = ATOLERANCE;
+    }
+    solver_par->init_res = nom0;
+    solver_par->final_res = nom0;
+    solver_par->iter_res = nom0;
+    res = nom0;
+    if ( solver_par->verbose > 0 ) {
+        solver_par->res_vec[0] = (real_Double_t)nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    if ( nom0 < r0 ) {
+        info = MAGMA_SUCCESS;
+        goto cleanup;
+    }
+
+    tempo1 = magma_sync_wtime( queue );
+    do
+    {
+        solver_par->numiter++;
+        CHECK( magma_zmcgs_sweeps_cpu( hb, &hx, 1, 0, &res, &gs_par, queue ));
+        solver_par->spmv_count++;
+        if ( solver_par->verbose > 0 ) {
+            tempo2 = magma_sync_wtime( queue );
+            if ( (solver_par->numiter)%solver_par->verbose == 0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ){
+            break;
+        }
+    }
+    while ( solver_par->numiter+1 <= solver_par->maxiter );
+
+    tempo2 = magma_sync_wtime( queue );
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    solver_par->iter_res = res;
+    solver_par->final_res = res;
+
+    magma_zmfree( x, queue );
+    CHECK( magma_zmtransfer( hx, x, Magma_CPU, x_location, queue ));
+
+    if ( res/nomb <= solver_par->rtol || res <= solver_par->atol ) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res ) {
+        info = MAGMA_SLOW_CONVERGENCE;
+    } else {
+        info = MAGMA_DIVERGENCE;
+    }
+
+cleanup:
+    magma_zmfree( &hb, queue );
+    magma_zmfree( &hx, queue );
+    magma_zprecondfree( &gs_par, queue );
+    solver_par->info = info;
+    return info;
+}   /* magma_zmcgs */
@@ -24,8 +24,8 @@
     instead of sparse triangular solves.
     
     This routine only handles the upper triangular part. The return value is 0
-    in case of success, and Magma_CUSOLVE if the pattern is too large to be 
-    handled.
+    in case of success. Patterns too large for the GPU register kernels are
+    handled on the host, and so are factors stored on the host.
 
     Arguments
     ---------
@@ -60,10 +60,15 @@ magma_ziluisaisetup_upper(
 
     magma_index_t *sizes_h = NULL;
     magma_int_t maxsize, nnzloc;
-    magma_z_matrix MT={Magma_CSR};
+    magma_z_matrix MT={Magma_CSR}, hL={Magma_CSR}, hMT={Magma_CSR};
 
     int warpsize=32;
 
+    if( U.memory_location == Magma_CPU ){
+        CHECK( magma_zisaisetup_cpu( MagmaUpper, U, S, 1, ISAIU, queue ) );
+        goto cleanup;
+    }
+
     // we need this in any case as the ISAI matrix is generated in transpose fashion
     CHECK( magma_zmtranspose( S, &MT, queue ) );
 
@@ -79,12 +84,19 @@ magma_ziluisaisetup_upper(
         if( nnzloc > maxsize ){
             maxsize = sizes_h[i+1]-sizes_h[i];
         }
-        if( maxsize > warpsize ){
-            printf("%% error for ISAI U: size of system %d is too large by %d\n", (int) i, (int) (maxsize-32));
-            printf("%% fallback: use exact triangular solve (cuSOLVE)\n");
-            info = Magma_CUSOLVE;
-            goto cleanup;
-        }
+    }
+
+    if( maxsize > warpsize ){
+        // too large for the register kernels: generate on the host, the
+        // workspace there is sized by the actual pattern
+        CHECK( magma_zmtransfer( U, &hL, U.memory_location, Magma_CPU, queue ) );
+        CHECK( magma_zmtransfer( MT, &hMT, Magma_DEV, Magma_CPU, queue ) );
+        CHECK( magma_zisai_generator_cpu( MagmaUpper, MagmaNoTrans, MagmaNonUnit,
+                    hL, &hMT, queue ) );
+        magma_zmfree( &MT, queue );
+        CHECK( magma_zmtransfer( hMT, &MT, Magma_CPU, Magma_DEV, queue ) );
+        CHECK( magma_zmtranspose( MT, ISAIU, queue ) );
+        goto cleanup;
     }
 
     // printf("%% nnz in ISAI factor U (total max/row): %d %d\n", (int) S.nnz, (int) maxsize);
@@ -97,6 +109,8 @@ magma_ziluisaisetup_upper(
 cleanup:
     magma_free_cpu( sizes_h );
     magma_zmfree( &MT, queue );
+    magma_zmfree( &hL, queue );
+    magma_zmfree( &hMT, queue );
     return info;
 }
 
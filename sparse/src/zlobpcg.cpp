@@ -30,7 +30,8 @@
     where A is a complex sparse matrix stored in the GPU memory.
     X and B are complex vectors stored on the GPU memory.
 
-    This is a GPU implementation of the LOBPCG method.
+    This is a GPU implementation of the LOBPCG method. For a matrix A
+    located on the CPU, the host implementation magma_zlobpcg_cpu is used.
     
     This method allocates all required memory space inside the routine.
     Also, the memory is not allocated as one big chunk, but seperatly for
@@ -65,6 +66,11 @@ magma_zlobpcg(
     magma_queue_t queue )
 {
     magma_int_t info = 0;
+
+    // host execution mode
+    if ( A.memory_location == Magma_CPU ) {
+        return magma_zlobpcg_cpu( A, solver_par, precond_par, queue );
+    }
         
     #define  residualNorms(i,iter)  ( residualNorms + (i) + (iter)*n )
     #define SWAP(x, y)    { pointer = x; x = y; y = pointer; }
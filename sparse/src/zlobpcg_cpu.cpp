@@ -0,0 +1,689 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+
+       @date
+
+       @precisions normal z -> s d c
+*/
+#include "magmasparse_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define PRECISION_z
+#define COMPLEX
+
+// columns of the block SpMM handled together per row
+#define LOBPCG_CPU_SPMM_COLS 4
+// CholQR falls back to Householder QR below this relative Cholesky pivot
+#define LOBPCG_CPU_CHOLTOL sqrt( lapackf77_dlamch( "E" ) )
+
+
+/*
+    Host LOBPCG.
+
+    All block vectors are kept in host memory. The bases [X R P] and
+    [AX AR AP] are stored contiguously, so that the Gram matrices of the
+    Rayleigh-Ritz step are formed by one GEMM (GramA) and one HERK (GramB)
+    each. The blocks are allocated here and first touched by the same static
+    row partitioning as the block SpMM and the residual kernel, so on NUMA
+    systems every thread works on rows in its local memory.
+
+    R and P are orthonormalized by CholQR (applied twice); when the Cholesky
+    factorization breaks down or is too ill-conditioned, Householder QR is
+    used instead. AP is updated with the triangular factor, so no SpMM with
+    P is needed.
+
+    Converged eigenpairs at the lower end of the spectrum are locked: they
+    are removed from the Rayleigh-Ritz step and only used to project the new
+    search directions.
+*/
+
+
+// first touch of a block of k vectors by the row partitioning of the kernels
+static void
+magma_zlobpcg_cpu_touch(
+    magma_int_t m,
+    magma_int_t k,
+    magmaDoubleComplex *V )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<m; i++ ){
+        for( magma_int_t j=0; j<k; j++ ){
+            V[ i + j*m ] = MAGMA_Z_ZERO;
+        }
+    }
+}
+
+
+// B(:,j) = A(:,idx[j]) for j < k (idx == NULL: B(:,j) = A(:,j))
+static void
+magma_zlobpcg_cpu_copy(
+    magma_int_t m,
+    magma_int_t k,
+    const magma_int_t *idx,
+    const magmaDoubleComplex *A,
+    magmaDoubleComplex *B )
+{
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<m; i++ ){
+        for( magma_int_t j=0; j<k; j++ ){
+            magma_int_t l = ( idx != NULL ) ? idx[j] : j;
+            B[ i + j*m ] = A[ i + l*m ];
+        }
+    }
+}
+
+
+// Y = A X for a block of k vectors
+static void
+magma_zlobpcg_cpu_spmm(
+    magma_z_matrix A,
+    magma_int_t k,
+    const magmaDoubleComplex *X,
+    magmaDoubleComplex *Y )
+{
+    magma_int_t m = A.num_rows;
+
+    #pragma omp parallel for schedule(static)
+    for( magma_int_t i=0; i<m; i++ ){
+        for( magma_int_t j0=0; j0<k; j0+=LOBPCG_CPU_SPMM_COLS ){
+            magma_int_t jb = min( LOBPCG_CPU_SPMM_COLS, k-j0 );
+            magmaDoubleComplex s[ LOBPCG_CPU_SPMM_COLS ];
+            for( magma_int_t j=0; j<jb; j++ ){
+                s[j] = MAGMA_Z_ZERO;
+            }
+            for( magma_int_t l=A.row[i]; l<A.row[i+1]; l++ ){
+                magmaDoubleComplex a = A.val[l];
+                const magmaDoubleComplex *x = X + A.col[l] + j0*m;
+                for( magma_int_t j=0; j<jb; j++ ){
+                    s[j] = s[j] + a * x[ j*m ];
+                }
+            }
+            for( magma_int_t j=0; j<jb; j++ ){
+                Y[ i + (j0+j)*m ] = s[j];
+            }
+        }
+    }
+}
+
+
+// R = AX - X diag(evalues) and the column norms of R
+static void
+magma_zlobpcg_cpu_res(
+    magma_int_t m,
+    magma_int_t k,
+    const double *evalues,
+    const magmaDoubleComplex *X,
+    const magmaDoubleComplex *AX,
+    magmaDoubleComplex *R,
+    double *norms )
+{
+    for( magma_int_t j=0; j<k; j++ ){
+        norms[j] = 0.0;
+    }
+    #pragma omp parallel for schedule(static) reduction(+:norms[:k])
+    for( magma_int_t i=0; i<m; i++ ){
+        for( magma_int_t j=0; j<k; j++ ){
+            magmaDoubleComplex r = AX[ i + j*m ]
+                    - MAGMA_Z_MAKE( evalues[j], 0.0 ) * X[ i + j*m ];
+            R[ i + j*m ] = r;
+            norms[j] += MAGMA_Z_REAL( r ) * MAGMA_Z_REAL( r )
+                      + MAGMA_Z_IMAG( r ) * MAGMA_Z_IMAG( r );
+        }
+    }
+    for( magma_int_t j=0; j<k; j++ ){
+        norms[j] = sqrt( norms[j] );
+    }
+}
+
+
+// V = V - Q (Q^H V) for the k vectors V and the orthonormal q vectors Q,
+// AV = AV - AQ (Q^H V) if AV is given
+static void
+magma_zlobpcg_cpu_project(
+    magma_int_t m,
+    magma_int_t q,
+    const magmaDoubleComplex *Q,
+    const magmaDoubleComplex *AQ,
+    magma_int_t k,
+    magmaDoubleComplex *V,
+    magmaDoubleComplex *AV,
+    magmaDoubleComplex *G )
+{
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    magmaDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+    if( q == 0 || k == 0 ){
+        return;
+    }
+    blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &q, &k, &m,
+                   &c_one, Q, &m, V, &m, &c_zero, G, &q );
+    blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &k, &q,
+                   &c_neg_one, Q, &m, G, &q, &c_one, V, &m );
+    if( AV != NULL ){
+        blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &k, &q,
+                       &c_neg_one, AQ, &m, G, &q, &c_one, AV, &m );
+    }
+}
+
+
+/*
+    Orthonormalizes the k vectors V in place, V = Q T with T upper
+    triangular, and updates AV = AV T^{-1} if AV is given, so that it stays
+    A V. Two passes of CholQR; Householder QR if the Cholesky factorization
+    of V^H V breaks down. Returns 1 if V is numerically rank deficient (AV is
+    not updated then), 0 otherwise.
+*/
+static magma_int_t
+magma_zlobpcg_cpu_orth(
+    magma_int_t m,
+    magma_int_t k,
+    magmaDoubleComplex *V,
+    magmaDoubleComplex *AV,
+    magmaDoubleComplex *T,
+    magmaDoubleComplex *tau,
+    magmaDoubleComplex *work,
+    magma_int_t lwork )
+{
+    magmaDoubleComplex c_one = MAGMA_Z_ONE;
+    double d_one = 1.0, d_zero = 0.0;
+    magma_int_t info = 0;
+
+    if( k == 0 ){
+        return 0;
+    }
+    for( magma_int_t pass=0; pass<2; pass++ ){
+        double dmin, dmax;
+        blasf77_zherk( MagmaUpperStr, MagmaConjTransStr, &k, &m,
+                       &d_one, V, &m, &d_zero, T, &k );
+        lapackf77_zpotrf( MagmaUpperStr, &k, T, &k, &info );
+        if( info == 0 ){
+            dmin = dmax = MAGMA_Z_REAL( T[0] );
+            for( magma_int_t j=1; j<k; j++ ){
+                dmin = min( dmin, MAGMA_Z_REAL( T[ j + j*k ] ));
+                dmax = max( dmax, MAGMA_Z_REAL( T[ j + j*k ] ));
+            }
+            if( dmin < LOBPCG_CPU_CHOLTOL * dmax ){
+                info = 1;
+            }
+        }
+        if( info != 0 ){
+            break;
+        }
+        blasf77_ztrsm( MagmaRightStr, MagmaUpperStr, MagmaNoTransStr,
+                       MagmaNonUnitStr, &m, &k, &c_one, T, &k, V, &m );
+        if( AV != NULL ){
+            blasf77_ztrsm( MagmaRightStr, MagmaUpperStr, MagmaNoTransStr,
+                           MagmaNonUnitStr, &m, &k, &c_one, T, &k, AV, &m );
+        }
+    }
+    if( info == 0 ){
+        return 0;
+    }
+
+    // fallback: Householder QR of what CholQR left
+    double dmin, dmax;
+    lapackf77_zgeqrf( &m, &k, V, &m, tau, work, &lwork, &info );
+    lapackf77_zlacpy( MagmaUpperStr, &k, &k, V, &m, T, &k );
+    lapackf77_zungqr( &m, &k, &k, V, &m, tau, work, &lwork, &info );
+    dmin = dmax = MAGMA_Z_ABS( T[0] );
+    for( magma_int_t j=1; j<k; j++ ){
+        dmin = min( dmin, MAGMA_Z_ABS( T[ j + j*k ] ));
+        dmax = max( dmax, MAGMA_Z_ABS( T[ j + j*k ] ));
+    }
+    if( dmin <= lapackf77_dlamch( "E" ) * dmax ){
+        return 1;
+    }
+    if( AV != NULL ){
+        blasf77_ztrsm( MagmaRightStr, MagmaUpperStr, MagmaNoTransStr,
+                       MagmaNonUnitStr, &m, &k, &c_one, T, &k, AV, &m );
+    }
+    return 0;
+}
+
+
+/**
+    Purpose
+    -------
+    Solves an eigenvalue problem
+
+       A * X = evalues X
+
+    for the num_eigenvalues smallest eigenvalues, where A is a hermitian
+    sparse matrix. This is a host implementation of the LOBPCG method: A is
+    used as CSR matrix on the CPU (converted if necessary), and all block
+    vectors, Gram matrices and orthogonalizations are kept on the host.
+    magma_zlobpcg calls this routine for matrices located on the CPU.
+
+    The initial guess is taken from solver_par->eigenvectors and the
+    eigenvectors are returned there; this array may be located on the host
+    or on the device (as set up by magma_zeigensolverinfo_init). An
+    eigenpair is considered converged once its residual norm is below
+    max( atol, rtol * |evalue| ); converged pairs at the lower end of the
+    spectrum are locked.
+
+    Host preconditioners (Jacobi, block-Jacobi, Gauss-Seidel, SSOR, AMG and
+    ILU with the CPU triangular solves) are applied to the residuals.
+
+    Arguments
+    ---------
+    @param[in]
+    A           magma_z_matrix
+                input matrix A
+
+    @param[in,out]
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param[in,out]
+    precond_par magma_z_precond_par*
+                preconditioner parameters
+
+    @param[in]
+    queue       magma_queue_t
+                Queue to execute in.
+
+    @ingroup magmasparse_zheev
+    ********************************************************************/
+
+extern "C" magma_int_t
+magma_zlobpcg_cpu(
+    magma_z_matrix A,
+    magma_z_solver_par *solver_par,
+    magma_z_preconditioner *precond_par,
+    magma_queue_t queue )
+{
+    magma_int_t info = 0;
+
+    #define blockS(  i, j)          (blockS  + (i) + (j)*m)
+    #define blockAS( i, j)          (blockAS + (i) + (j)*m)
+    #define blockR(  i, j)          (blockR  + (i) + (j)*m)
+    #define blockP(  i, j)          (blockP  + (i) + (j)*m)
+    #define blockAP( i, j)          (blockAP + (i) + (j)*m)
+    #define gramA(   i, j)          (gramA   + (i) + (j)*ldgram)
+    #define residualNorms(i,iter)   (residualNorms + (i) + (iter)*n )
+
+    solver_par->solver = Magma_LOBPCG;
+    magma_int_t m = A.num_rows;
+    magma_int_t n = solver_par->num_eigenvalues;
+    double *evalues = solver_par->eigenvalues;
+    solver_par->numiter = 0;
+    solver_par->spmv_count = 0;
+
+    magma_z_matrix hA={Magma_CSR}, CSRA={Magma_CSR}, B={Magma_CSR};
+    magma_z_matrix rv={Magma_CSR}, wv={Magma_CSR};
+
+    // blockS = [ X R P ], blockAS = [ AX AR AP ]
+    magmaDoubleComplex *blockS=NULL, *blockAS=NULL, *blockR=NULL;
+    magmaDoubleComplex *blockP=NULL, *blockAP=NULL, *blockW=NULL;
+    magmaDoubleComplex *gramA=NULL, *gramB=NULL, *gramT=NULL;
+    magmaDoubleComplex *hwork=NULL, *tau=NULL, *dinv=NULL;
+    double *gevalues=NULL, *residualNorms=NULL, *rwork=NULL;
+    magma_int_t *iwork=NULL, *active=NULL;
+
+    magma_int_t iterationNumber = 1, cBlockSize = 0, nlock = 0, restart = 1;
+    magma_int_t na, gramDim, ldgram = 3*n, itype = 1, lapack_info = 0;
+    magma_int_t lwork = max( 1 + 6*ldgram + 2*ldgram*ldgram, 64*n );
+    magma_int_t liwork = 3 + 5*ldgram;
+    #ifdef COMPLEX
+    magma_int_t lrwork = 1 + 5*ldgram + 2*ldgram*ldgram;
+    #endif
+
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
+    double d_one = 1.0, d_zero = 0.0;
+
+    double residualTolerance = solver_par->rtol;
+    double absoluteTolerance = solver_par->atol;
+    magma_int_t maxIterations = solver_par->maxiter;
+    magma_int_t precond = ( precond_par != NULL &&
+                            precond_par->solver != Magma_NONE &&
+                            precond_par->solver != 0 );
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+
+    // === Check some parameters for possible quick exit ===
+    if( evalues == NULL || solver_par->eigenvectors == NULL ){
+        printf("%% error: eigensolver not initialized.\n");
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+    if( m < 2 || n < 1 || 3*n > m ){
+        printf("%% error: LOBPCG for %lld eigenpairs of a matrix of size %lld.\n",
+               (long long) n, (long long) m );
+        info = MAGMA_ERR_NOT_SUPPORTED;
+        goto cleanup;
+    }
+
+    // === host CSR copy of A ===
+    if( A.memory_location != Magma_CPU || A.storage_type != Magma_CSR ){
+        CHECK( magma_zmtransfer( A, &hA, A.memory_location, Magma_CPU, queue ));
+        CHECK( magma_zmconvert( hA, &CSRA, hA.storage_type, Magma_CSR, queue ));
+        B = CSRA;
+    } else {
+        B = A;
+    }
+
+    // === Allocate and first-touch the block vectors ===
+    CHECK( magma_zmalloc_cpu( &blockS,  m*3*n ));
+    CHECK( magma_zmalloc_cpu( &blockAS, m*3*n ));
+    CHECK( magma_zmalloc_cpu( &blockR,  m*n ));
+    CHECK( magma_zmalloc_cpu( &blockP,  m*n ));
+    CHECK( magma_zmalloc_cpu( &blockAP, m*n ));
+    CHECK( magma_zmalloc_cpu( &blockW,  m*n ));
+    magma_zlobpcg_cpu_touch( m, 3*n, blockS );
+    magma_zlobpcg_cpu_touch( m, 3*n, blockAS );
+    magma_zlobpcg_cpu_touch( m, n, blockR );
+    magma_zlobpcg_cpu_touch( m, n, blockP );
+    magma_zlobpcg_cpu_touch( m, n, blockAP );
+    magma_zlobpcg_cpu_touch( m, n, blockW );
+
+    // === Allocate the Gram matrices and LAPACK workspace ===
+    CHECK( magma_zmalloc_cpu( &gramA, ldgram*ldgram ));
+    CHECK( magma_zmalloc_cpu( &gramB, ldgram*ldgram ));
+    CHECK( magma_zmalloc_cpu( &gramT, ldgram*ldgram ));
+    CHECK( magma_zmalloc_cpu( &hwork, lwork ));
+    CHECK( magma_zmalloc_cpu( &tau, n ));
+    CHECK( magma_dmalloc_cpu( &gevalues, ldgram ));
+    CHECK( magma_dmalloc_cpu( &residualNorms, (maxIterations+1) * n ));
+    CHECK( magma_imalloc_cpu( &iwork, liwork ));
+    CHECK( magma_imalloc_cpu( &active, n ));
+    #ifdef COMPLEX
+    CHECK( magma_dmalloc_cpu( &rwork, lrwork ));
+    #endif
+
+    // === inverse diagonal for the Jacobi preconditioner ===
+    if( precond && precond_par->solver == Magma_JACOBI ){
+        CHECK( magma_zmalloc_cpu( &dinv, m ));
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<m; i++ ){
+            dinv[i] = MAGMA_Z_ONE;
+            for( magma_int_t l=B.row[i]; l<B.row[i+1]; l++ ){
+                if( B.col[l] == i && MAGMA_Z_ABS( B.val[l] ) > 0.0 ){
+                    dinv[i] = MAGMA_Z_ONE / B.val[l];
+                }
+            }
+        }
+    }
+    rv.memory_location = Magma_CPU; rv.storage_type = Magma_DENSE;
+    rv.num_rows = m; rv.num_cols = 1; rv.nnz = m; rv.major = MagmaColMajor;
+    wv = rv;
+    wv.val = blockW;
+
+    // === initial guess ===
+    if( magma_is_devptr( solver_par->eigenvectors ) == 1 ){
+        magma_zgetmatrix( m, n, solver_par->eigenvectors, m, blockS, m, queue );
+    } else {
+        magma_zlobpcg_cpu_copy( m, n, NULL, solver_par->eigenvectors, blockS );
+    }
+
+    tempo1 = magma_sync_wtime( queue );
+
+    // === Make the initial vectors orthonormal ===
+    magma_zlobpcg_cpu_orth( m, n, blockS, NULL, gramT, tau, hwork, lwork );
+
+    magma_zlobpcg_cpu_spmm( B, n, blockS, blockAS );
+    solver_par->spmv_count++;
+
+    // === Compute the Gram matrix = (X, AX) & its eigenstates ===
+    blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &n, &n, &m,
+                   &c_one, blockS, &m, blockAS, &m, &c_zero, gramA, &ldgram );
+    lapackf77_zheevd( "V", MagmaUpperStr, &n, gramA, &ldgram, evalues,
+                      hwork, &lwork,
+                      #ifdef COMPLEX
+                      rwork, &lrwork,
+                      #endif
+                      iwork, &liwork, &lapack_info );
+    if( lapack_info != 0 ){
+        info = MAGMA_ERR;
+        goto cleanup;
+    }
+
+    // === Update X = X * evectors, AX = AX * evectors ===
+    blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &n, &n,
+                   &c_one, blockS, &m, gramA, &ldgram, &c_zero, blockW, &m );
+    magma_zlobpcg_cpu_copy( m, n, NULL, blockW, blockS );
+    blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &n, &n,
+                   &c_one, blockAS, &m, gramA, &ldgram, &c_zero, blockW, &m );
+    magma_zlobpcg_cpu_copy( m, n, NULL, blockW, blockAS );
+
+    // === Main LOBPCG loop ============================================================
+    for( iterationNumber = 1; iterationNumber < maxIterations; iterationNumber++ ){
+        double resmax = 0.0;
+
+        // === compute the residuals of the unlocked vectors (R = AX - X evalues)
+        magma_zlobpcg_cpu_res( m, n-nlock, evalues+nlock,
+                               blockS(0,nlock), blockAS(0,nlock), blockR(0,nlock),
+                               residualNorms(nlock, iterationNumber) );
+        for( magma_int_t k=0; k<nlock; k++ ){
+            *residualNorms(k, iterationNumber) = *residualNorms(k, iterationNumber-1);
+        }
+        for( magma_int_t k=0; k<n; k++ ){
+            resmax = max( resmax, *residualNorms(k, iterationNumber) );
+        }
+        if( iterationNumber == 1 ){
+            solver_par->init_res = resmax;
+        }
+        solver_par->final_res = resmax;
+
+        // === lock the converged vectors at the lower end, collect the active ones
+        #define CONVERGED(k)  ( *residualNorms(k, iterationNumber) <= \
+                    max( absoluteTolerance, residualTolerance * fabs( evalues[k] )))
+        while( nlock < n && CONVERGED(nlock) ){
+            nlock++;
+        }
+        cBlockSize = 0;
+        for( magma_int_t k=nlock; k<n; k++ ){
+            if( ! CONVERGED(k) ){
+                active[ cBlockSize++ ] = k;
+            }
+        }
+        #undef CONVERGED
+
+        if ( solver_par->verbose != 0 && iterationNumber%solver_par->verbose == 0 ) {
+            printf("%4d-%2d-%2d ", int(iterationNumber), int(nlock), int(cBlockSize));
+            magma_dprint( 1, n, residualNorms(0, iterationNumber), 1 );
+        }
+        if (cBlockSize == 0)
+            break;
+        na = n - nlock;
+
+        // === R = the active residuals, preconditioned
+        magma_zlobpcg_cpu_copy( m, cBlockSize, active, blockR, blockS(0,n) );
+        if( precond && dinv != NULL ){
+            #pragma omp parallel for schedule(static)
+            for( magma_int_t i=0; i<m; i++ ){
+                for( magma_int_t j=0; j<cBlockSize; j++ ){
+                    *blockS(i,n+j) = dinv[i] * *blockS(i,n+j);
+                }
+            }
+        }
+        else if( precond ){
+            for( magma_int_t j=0; j<cBlockSize; j++ ){
+                rv.val = blockS(0,n+j);
+                CHECK( magma_z_applyprecond_left( MagmaNoTrans, B, rv, &wv, precond_par, queue ));
+                CHECK( magma_z_applyprecond_right( MagmaNoTrans, B, wv, &rv, precond_par, queue ));
+            }
+        }
+
+        // === make R orthogonal to X and orthonormal; AR = A R
+        magma_zlobpcg_cpu_project( m, n, blockS, NULL, cBlockSize, blockS(0,n),
+                                   NULL, gramT );
+        magma_zlobpcg_cpu_orth( m, cBlockSize, blockS(0,n), NULL,
+                                gramT, tau, hwork, lwork );
+        magma_zlobpcg_cpu_spmm( B, cBlockSize, blockS(0,n), blockAS(0,n) );
+        solver_par->spmv_count++;
+
+        // === active part of P & AP, orthonormal; AP updated without SpMM
+        if( ! restart ){
+            magma_zlobpcg_cpu_copy( m, cBlockSize, active, blockP,  blockS(0,n+cBlockSize) );
+            magma_zlobpcg_cpu_copy( m, cBlockSize, active, blockAP, blockAS(0,n+cBlockSize) );
+            if( nlock > 0 ){
+                magma_zlobpcg_cpu_project( m, nlock, blockS, blockAS, cBlockSize,
+                                           blockS(0,n+cBlockSize),
+                                           blockAS(0,n+cBlockSize), gramT );
+            }
+            restart = magma_zlobpcg_cpu_orth( m, cBlockSize, blockS(0,n+cBlockSize),
+                                blockAS(0,n+cBlockSize), gramT, tau, hwork, lwork );
+        }
+
+        /* --- The Rayleigh-Ritz method for [Xa R P], Xa the unlocked vectors --
+           Both Gram matrices are formed by one product each of the contiguous
+           bases [Xa R P] and [AXa AR AP].
+                  GramA = [Xa R P]' [AXa AR AP],   GramB = [Xa R P]' [Xa R P]
+           A restart (steepest descent step without P) is done if GramB is
+           not numerically positive definite.
+           -----------------------------------------------------------------   */
+        for( ;; ){
+            gramDim = na + ( restart ? cBlockSize : 2*cBlockSize );
+            blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &gramDim, &gramDim, &m,
+                           &c_one, blockS(0,nlock), &m, blockAS(0,nlock), &m,
+                           &c_zero, gramA, &ldgram );
+            blasf77_zherk( MagmaLowerStr, MagmaConjTransStr, &gramDim, &m,
+                           &d_one, blockS(0,nlock), &m, &d_zero, gramB, &ldgram );
+            lapackf77_zhegvd( &itype, "V", MagmaLowerStr, &gramDim,
+                              gramA, &ldgram, gramB, &ldgram,
+                              gevalues, hwork, &lwork,
+                              #ifdef COMPLEX
+                              rwork, &lrwork,
+                              #endif
+                              iwork, &liwork, &lapack_info );
+            if( lapack_info == 0 ){
+                break;
+            }
+            if( restart ){
+                info = MAGMA_ERR;
+                goto cleanup;
+            }
+            // Steepest descent restart for stability
+            restart = 1;
+            if ( solver_par->verbose != 0 ) {
+                printf("restart at step #%d\n", int(iterationNumber));
+            }
+        }
+        for( magma_int_t k=0; k<na; k++ ){
+            evalues[nlock+k] = gevalues[k];
+        }
+
+        // === new P = [R P] Y_RP and AP = [AR AP] Y_RP (aligned with X)
+        magma_int_t nrp = gramDim - na;
+        blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &na, &nrp,
+                       &c_one, blockS(0,n), &m, gramA(na,0), &ldgram,
+                       &c_zero, blockP(0,nlock), &m );
+        blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &na, &nrp,
+                       &c_one, blockAS(0,n), &m, gramA(na,0), &ldgram,
+                       &c_zero, blockAP(0,nlock), &m );
+
+        // === new X = Xa Y_X + P and AX = AXa Y_X + AP
+        blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &na, &na,
+                       &c_one, blockS(0,nlock), &m, gramA, &ldgram,
+                       &c_zero, blockW, &m );
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<m; i++ ){
+            for( magma_int_t j=0; j<na; j++ ){
+                *blockS(i,nlock+j) = blockW[ i + j*m ] + *blockP(i,nlock+j);
+            }
+        }
+        blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &na, &na,
+                       &c_one, blockAS(0,nlock), &m, gramA, &ldgram,
+                       &c_zero, blockW, &m );
+        #pragma omp parallel for schedule(static)
+        for( magma_int_t i=0; i<m; i++ ){
+            for( magma_int_t j=0; j<na; j++ ){
+                *blockAS(i,nlock+j) = blockW[ i + j*m ] + *blockAP(i,nlock+j);
+            }
+        }
+
+        restart = 0;
+    }   // === end for iterationNumber = 1,maxIterations =======================
+
+    // fill solver info
+    tempo2 = magma_sync_wtime( queue );
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    solver_par->numiter = iterationNumber;
+    solver_par->iter_res = solver_par->final_res;
+    if ( solver_par->numiter < solver_par->maxiter) {
+        info = MAGMA_SUCCESS;
+    } else if ( solver_par->init_res > solver_par->final_res )
+        info = MAGMA_SLOW_CONVERGENCE;
+    else
+        info = MAGMA_DIVERGENCE;
+
+    // =============================================================================
+    // === postprocessing: Rayleigh-Ritz for all of X with the true AX
+    // =============================================================================
+    magma_zlobpcg_cpu_spmm( B, n, blockS, blockAS );
+    solver_par->spmv_count++;
+    blasf77_zgemm( MagmaConjTransStr, MagmaNoTransStr, &n, &n, &m,
+                   &c_one, blockS, &m, blockAS, &m, &c_zero, gramA, &ldgram );
+    lapackf77_zheevd( "V", MagmaUpperStr, &n, gramA, &ldgram, gevalues,
+                      hwork, &lwork,
+                      #ifdef COMPLEX
+                      rwork, &lrwork,
+                      #endif
+                      iwork, &liwork, &lapack_info );
+    if( lapack_info != 0 ){
+        info = MAGMA_ERR;
+        goto cleanup;
+    }
+    for( magma_int_t k=0; k<n; k++ ){
+        evalues[k] = gevalues[k];
+    }
+    blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &n, &n,
+                   &c_one, blockS, &m, gramA, &ldgram, &c_zero, blockW, &m );
+    magma_zlobpcg_cpu_copy( m, n, NULL, blockW, blockS );
+    blasf77_zgemm( MagmaNoTransStr, MagmaNoTransStr, &m, &n, &n,
+                   &c_one, blockAS, &m, gramA, &ldgram, &c_zero, blockW, &m );
+    magma_zlobpcg_cpu_copy( m, n, NULL, blockW, blockAS );
+
+    // === residualNorms[iterationNumber] = || R ||
+    magma_zlobpcg_cpu_res( m, n, evalues, blockS, blockAS, blockR,
+                           residualNorms(0, iterationNumber) );
+    solver_par->final_res = 0.0;
+    for( magma_int_t k=0; k<n; k++ ){
+        solver_par->final_res = max( solver_par->final_res,
+                                     *residualNorms(k, iterationNumber) );
+    }
+
+    // === return the eigenvectors
+    if( magma_is_devptr( solver_par->eigenvectors ) == 1 ){
+        magma_zsetmatrix( m, n, blockS, m, solver_par->eigenvectors, m, queue );
+    } else {
+        magma_zlobpcg_cpu_copy( m, n, NULL, blockS, solver_par->eigenvectors );
+    }
+
+    printf("Eigenvalues:\n");
+    for(magma_int_t i =0; i<n; i++)
+        printf("%e  ", evalues[i]);
+    printf("\n\n");
+
+    printf("Final residuals:\n");
+    magma_dprint( 1, n, residualNorms(0, iterationNumber), 1 );
+    printf("\n\n");
+
+cleanup:
+    magma_zmfree( &hA, queue );
+    magma_zmfree( &CSRA, queue );
+    magma_free_cpu( blockS );
+    magma_free_cpu( blockAS );
+    magma_free_cpu( blockR );
+    magma_free_cpu( blockP );
+    magma_free_cpu( blockAP );
+    magma_free_cpu( blockW );
+    magma_free_cpu( gramA );
+    magma_free_cpu( gramB );
+    magma_free_cpu( gramT );
+    magma_free_cpu( hwork );
+    magma_free_cpu( tau );
+    magma_free_cpu( dinv );
+    magma_free_cpu( gevalues );
+    magma_free_cpu( residualNorms );
+    magma_free_cpu( rwork );
+    magma_free_cpu( iwork );
+    magma_free_cpu( active );
+    return info;
+}
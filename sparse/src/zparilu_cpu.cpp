@@ -17,6 +17,10 @@
 
 #define PRECISION_z
 
+// in adaptive mode, the residual estimate samples every PARILU_RES_STRIDE-th
+// nonzero of A
+#define PARILU_RES_STRIDE 16
+
 
 /***************************************************************************//**
     Purpose
@@ -28,6 +32,13 @@
     SIAM Journal on Scientific Computing, 37, C169-C193 (2015). 
     
     This is the CPU implementation of the ParILU
+    
+    If precond->sweeptol > 0, the sweeps are stopped as soon as the relative
+    change of the factors in one sweep drops below precond->sweeptol, with
+    precond->sweeps as upper bound. The number of sweeps done is returned in
+    precond->sweeps_used, a sampled estimate of the nonlinear residual
+    || A - LU || on the pattern of A before and after the sweeps in
+    precond->init_res and precond->final_res.
 
     Arguments
     ---------
@@ -66,6 +77,8 @@ magma_zparilu_cpu(
 
     magma_z_matrix hAT={Magma_CSR}, hA={Magma_CSR}, hAL={Magma_CSR}, 
     hAU={Magma_CSR}, hAUT={Magma_CSR}, hAtmp={Magma_CSR}, hACOO={Magma_CSR};
+    double change = 0.0;
+    real_Double_t res = 0.0;
 
     // copy original matrix as COO to device
     if (A.memory_location != Magma_CPU || A.storage_type != Magma_CSR) {
@@ -104,8 +117,27 @@ magma_zparilu_cpu(
     // - hAU is the upper triangular in CSC on the CPU (U transpose in CSR)
     // The kernel is located in sparse/control/magma_zparilu_kernels.cpp
     //
-    for (int i=0; i<precond->sweeps; i++) {
-        CHECK(magma_zparilu_sweep(hACOO, &hAL, &hAU, queue));
+    if (precond->sweeptol > 0.0) {
+        CHECK(magma_zparilu_sampledres(hACOO, hAL, hAU, 
+            PARILU_RES_STRIDE, &res, queue));
+        precond->init_res = res;
+        precond->sweeps_used = 0;
+        for (int i=0; i<precond->sweeps; i++) {
+            CHECK(magma_zparilu_sweep_monitor(hACOO, &hAL, &hAU, 
+                &change, queue));
+            precond->sweeps_used = i+1;
+            if (change < precond->sweeptol) {
+                break;
+            }
+        }
+        CHECK(magma_zparilu_sampledres(hACOO, hAL, hAU, 
+            PARILU_RES_STRIDE, &res, queue));
+        precond->final_res = res;
+    } else {
+        for (int i=0; i<precond->sweeps; i++) {
+            CHECK(magma_zparilu_sweep(hACOO, &hAL, &hAU, queue));
+        }
+        precond->sweeps_used = precond->sweeps;
     }
     CHECK(magma_z_cucsrtranspose(hAU, &hAUT, queue));
 
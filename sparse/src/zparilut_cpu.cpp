@@ -11,6 +11,7 @@
 */
 
 #include "magmasparse_internal.h"
+#include "trace.h"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -34,7 +35,8 @@
     submitted to SIAM SISC in 2017.
     
     This version uses the default setting which adds all candidates to the
-    sparsity pattern.
+    sparsity pattern. The factors are updated in place, with slack space
+    behind every row, see magma_zparilut_inc_init.
 
     This function requires OpenMP, and is only available if OpenMP is activated.
     
@@ -78,16 +80,15 @@ magma_zparilut_cpu(
 #ifdef _OPENMP
 
     real_Double_t start, end;
-    real_Double_t t_rm=0.0, t_add=0.0, t_res=0.0, t_sweep1=0.0, t_sweep2=0.0, 
-        t_cand=0.0, t_sort=0.0, t_transpose1=0.0, t_transpose2=0.0, t_selectrm=0.0,
-        t_nrm=0.0, t_total = 0.0, accum=0.0;
+    real_Double_t t_rm=0.0, t_cand=0.0, t_sweep1=0.0, t_sweep2=0.0, 
+        t_selectrm=0.0, t_total = 0.0, accum=0.0;
                     
-    double sum, sumL, sumU;
+    double sum;
 
     magma_z_matrix hA={Magma_CSR}, hAT={Magma_CSR}, hL={Magma_CSR}, 
-        hU={Magma_CSR}, oneL={Magma_CSR}, oneU={Magma_CSR},
-        L={Magma_CSR}, U={Magma_CSR}, L_new={Magma_CSR}, U_new={Magma_CSR}, 
-        UT={Magma_CSR}, L0={Magma_CSR}, U0={Magma_CSR};
+        hU={Magma_CSR}, L={Magma_CSR}, U={Magma_CSR}, 
+        L0={Magma_CSR}, U0={Magma_CSR};
+    magma_z_parilut_factors F;
     magma_int_t num_rmL, num_rmU;
     double thrsL = 0.0;
     double thrsU = 0.0;
@@ -95,6 +96,7 @@ magma_zparilut_cpu(
     magma_int_t num_threads = 1, timing = 1; // print timing
     magma_int_t L0nnz, U0nnz;
 
+    memset(&F, 0, sizeof(F));
     #pragma omp parallel
     {
         num_threads = omp_get_max_threads();
@@ -115,130 +117,80 @@ magma_zparilut_cpu(
     CHECK(magma_zmatrix_tril(hA, &L, queue));
     CHECK(magma_zmtranspose(hA, &hAT, queue));
     CHECK(magma_zmatrix_tril(hAT, &U, queue));
-    CHECK(magma_zmatrix_addrowindex(&L, queue)); 
-    CHECK(magma_zmatrix_addrowindex(&U, queue)); 
     L0nnz=L.nnz;
     U0nnz=U.nnz;
-    oneL.memory_location = Magma_CPU;
-    oneU.memory_location = Magma_CPU;
+    // L by rows, U by columns and U by rows, kept in sync in place
+    CHECK(magma_zparilut_inc_init(L, U, &F, queue));
+    magma_zmfree(&L, queue);
+    magma_zmfree(&U, queue);
         
     if (timing == 1) {
         printf("ilut_fill_ratio = %.6f;\n\n", precond->atol);  
-        printf("performance_%d = [\n%%iter      L.nnz      U.nnz    ILU-Norm    transp    candidat  resid     sort    transcand    add      sweep1   selectrm    remove    sweep2     total       accum\n", 
+        printf("performance_%d = [\n%%iter      L.nnz      U.nnz    ILU-Norm    candidat  sweep1   selectrm    remove    sweep2     total       accum\n", 
             (int) num_threads);
     }
 
     //##########################################################################
 
     for (magma_int_t iters =0; iters<precond->sweeps; iters++) {
-        t_rm=0.0; t_add=0.0; t_res=0.0; t_sweep1=0.0; t_sweep2=0.0; t_cand=0.0;
-        t_transpose1=0.0; t_transpose2=0.0;  t_selectrm=0.0; t_sort = 0;
-        t_sort=0.0; t_nrm=0.0; t_total = 0.0;
+        t_rm=0.0; t_cand=0.0; t_sweep1=0.0; t_sweep2=0.0; t_selectrm=0.0;
+        t_total = 0.0;
      
-        // step 1: transpose U
-        start = magma_sync_wtime(queue);
-        magma_zmfree(&UT, queue);
-        CHECK(magma_zcsrcoo_transpose(U, &UT, queue));
-        end = magma_sync_wtime(queue); t_transpose1+=end-start;
-        
-        
-        // step 2: find candidates
+        // step 1: find candidates, compute their residuals, and add them
+        // to the factors; the candidates of every row are merged in place
+        magma_trace_begin( "parilut", "candidates" );
         start = magma_sync_wtime(queue);
-        CHECK(magma_zparilut_candidates(L0, U0, L, UT, &hL, &hU, queue));
+        CHECK(magma_zparilut_inc_add(&hA, &L0, &U0, &F, &sum, queue));
         end = magma_sync_wtime(queue); t_cand=+end-start;
-        
-        
-        // step 3: compute residuals (optional when adding all candidates)
-        start = magma_sync_wtime(queue);
-        CHECK(magma_zparilut_residuals(hA, L, U, &hL, queue));
-        CHECK(magma_zparilut_residuals(hA, L, U, &hU, queue));
-        end = magma_sync_wtime(queue); t_res=+end-start;
-        start = magma_sync_wtime(queue);
-        CHECK(magma_zmatrix_abssum(hL, &sumL, queue));
-        CHECK(magma_zmatrix_abssum(hU, &sumU, queue));
-        sum = sumL + sumU;
-        end = magma_sync_wtime(queue); t_nrm+=end-start;
-        CHECK(magma_zmatrix_swap(&hL, &oneL, queue));
-        magma_zmfree(&hL, queue);
-        
-        
-        // step 4: sort candidates
-        start = magma_sync_wtime(queue);
-        CHECK(magma_zcsr_sort(&hL, queue));
-        CHECK(magma_zcsr_sort(&hU, queue));
-        end = magma_sync_wtime(queue); t_sort+=end-start;
-        
-        
-        // step 5: transpose candidates
-        start = magma_sync_wtime(queue);
-        magma_zcsrcoo_transpose(hU, &oneU, queue);
-        end = magma_sync_wtime(queue); t_transpose2+=end-start;
-        
-        
-        // step 6: add candidates
-        start = magma_sync_wtime(queue);
-        CHECK(magma_zmatrix_cup(L, oneL, &L_new, queue));   
-        CHECK(magma_zmatrix_cup(U, oneU, &U_new, queue));
-        end = magma_sync_wtime(queue); t_add=+end-start;
-        magma_zmfree(&oneL, queue);
-        magma_zmfree(&oneU, queue);
+        magma_trace_end();
        
         
-        // step 7: sweep
+        // step 2: sweep
+        magma_trace_begin( "sweep", "sweep" );
         start = magma_sync_wtime(queue);
-        CHECK(magma_zparilut_sweep_sync(&hA, &L_new, &U_new, queue));
+        CHECK(magma_zparilut_inc_sweep(&hA, &F, queue));
         end = magma_sync_wtime(queue); t_sweep1+=end-start;
+        magma_trace_end();
         
         
-        // step 8: select threshold to remove elements
+        // step 3: select threshold to remove elements
+        magma_trace_begin( "select", "select threshold" );
         start = magma_sync_wtime(queue);
-        num_rmL = max((L_new.nnz-L0nnz*(1+(precond->atol-1.)
+        num_rmL = max((F.L.nnz-L0nnz*(1+(precond->atol-1.)
             *(iters+1)/precond->sweeps)), 0);
-        num_rmU = max((U_new.nnz-U0nnz*(1+(precond->atol-1.)
+        num_rmU = max((F.U.nnz-U0nnz*(1+(precond->atol-1.)
             *(iters+1)/precond->sweeps)), 0);
-        // pre-select: ignore the diagonal entries
-        CHECK(magma_zparilut_preselect(0, &L_new, &oneL, queue));
-        CHECK(magma_zparilut_preselect(0, &U_new, &oneU, queue));
-        if (num_rmL>0) {
-            CHECK(magma_zparilut_set_thrs_randomselect_approx(num_rmL, 
-                &oneL, 0, &thrsL, queue));
-        } else {
-            thrsL = 0.0;
-        }
-        if (num_rmU>0) {
-            CHECK(magma_zparilut_set_thrs_randomselect_approx(num_rmU, 
-                &oneU, 0, &thrsU, queue));
-        } else {
-            thrsU = 0.0;
-        }
-        magma_zmfree(&oneL, queue);
-        magma_zmfree(&oneU, queue);
+        // the diagonal entries are ignored
+        CHECK(magma_zparilut_inc_thrs(num_rmL, num_rmU, &F, &thrsL, &thrsU, 
+            queue));
         end = magma_sync_wtime(queue); t_selectrm=end-start;
+        magma_trace_end();
 
         
-        // step 9: remove elements
+        // step 4: remove elements in place
+        magma_trace_begin( "remove", "remove" );
         start = magma_sync_wtime(queue);
-        CHECK(magma_zparilut_thrsrm(1, &L_new, &thrsL, queue));
-        CHECK(magma_zparilut_thrsrm(1, &U_new, &thrsU, queue));
-        CHECK(magma_zmatrix_swap(&L_new, &L, queue));
-        CHECK(magma_zmatrix_swap(&U_new, &U, queue));
-        magma_zmfree(&L_new, queue);
-        magma_zmfree(&U_new, queue);
+        CHECK(magma_zparilut_inc_rm(thrsL, thrsU, &F, queue));
         end = magma_sync_wtime(queue); t_rm=end-start;
+        magma_trace_end();
         
         
-        // step 10: sweep
+        // step 5: sweep
+        magma_trace_begin( "sweep", "sweep" );
         start = magma_sync_wtime(queue);
-        CHECK(magma_zparilut_sweep_sync(&hA, &L, &U, queue));
+        CHECK(magma_zparilut_inc_sweep(&hA, &F, queue));
         end = magma_sync_wtime(queue); t_sweep2+=end-start;
+        magma_trace_end();
+        magma_trace_counter( "nnz(L)", F.L.nnz );
+        magma_trace_counter( "nnz(U)", F.U.nnz );
         
         if (timing == 1) {
-            t_total = t_transpose1+ t_cand+ t_res+ t_sort+ t_transpose2+ t_add+ t_sweep1+ t_selectrm+ t_rm+ t_sweep2;
+            t_total = t_cand+ t_sweep1+ t_selectrm+ t_rm+ t_sweep2;
             accum = accum + t_total;
-            printf("%5lld %10lld %10lld  %.4e   %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e  %.2e      %.2e\n",
-                (long long) iters, (long long) L.nnz, (long long) U.nnz, 
+            printf("%5lld %10lld %10lld  %.4e   %.2e  %.2e  %.2e  %.2e  %.2e  %.2e      %.2e\n",
+                (long long) iters, (long long) F.L.nnz, (long long) F.U.nnz, 
                 (double) sum, 
-                t_transpose1, t_cand, t_res, t_sort, t_transpose2, t_add, t_sweep1, t_selectrm, t_rm, t_sweep2, t_total, accum);
+                t_cand, t_sweep1, t_selectrm, t_rm, t_sweep2, t_total, accum);
             fflush(stdout);
         }
     }
@@ -249,11 +201,10 @@ magma_zparilut_cpu(
     }
     //##########################################################################
 
-    // for CUSPARSE
+    // for CUSPARSE, both factors in CSR
+    CHECK(magma_zparilut_inc_get(&F, &L, &U, queue));
     CHECK(magma_zmtransfer(L, &precond->L, Magma_CPU, Magma_DEV , queue));
-    CHECK(magma_zcsrcoo_transpose(U, &UT, queue));
-    //magma_zmtranspose(U, &UT, queue);
-    CHECK(magma_zmtransfer(UT, &precond->U, Magma_CPU, Magma_DEV , queue));
+    CHECK(magma_zmtransfer(U, &precond->U, Magma_CPU, Magma_DEV , queue));
     
     if (precond->trisolver == 0 || precond->trisolver == Magma_CUSOLVE) {
         CHECK(magma_zcumilugeneratesolverinfo(precond, queue));
@@ -274,11 +225,9 @@ cleanup:
     magma_zmfree(&hAT, queue);
     magma_zmfree(&L, queue);
     magma_zmfree(&U, queue);
-    magma_zmfree(&UT, queue);
     magma_zmfree(&L0, queue);
     magma_zmfree(&U0, queue);
-    magma_zmfree(&L_new, queue);
-    magma_zmfree(&U_new, queue);
+    magma_zparilut_inc_free(&F, queue);
     magma_zmfree(&hL, queue);
     magma_zmfree(&hU, queue);
 #endif
@@ -0,0 +1,130 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// sum_i x_i y_i, without conjugation
+static magmaDoubleComplex
+bilinear( magma_int_t n, const magmaDoubleComplex *x, const magmaDoubleComplex *y )
+{
+    magmaDoubleComplex s = MAGMA_Z_ZERO;
+    for( magma_int_t i=0; i<n; i++ ){
+        s = s + x[i] * y[i];
+    }
+    return s;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the transposed application of the host AMG preconditioner
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, u={Magma_CSR}, v={Magma_CSR};
+    magma_z_matrix y1={Magma_CSR}, y2={Magma_CSR};
+    double tol = 1000 * lapackf77_dlamch( "E" );
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    magma_z_preconditioner *precond = &zopts.precond_par;
+    precond->solver = Magma_AMG;
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        magma_int_t n = A.num_rows;
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        TESTING_CHECK( magma_zvinit( &u,  Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &v,  Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &y1, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &y2, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        for( magma_int_t k=0; k<n; k++ ){
+            u.val[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 7) / 7.0, (double) (k % 3) / 3.0 );
+            v.val[k] = MAGMA_Z_MAKE( (double) (k % 5) / 5.0 - 0.5, 1.0 - (double) (k % 11) / 11.0 );
+        }
+
+        // first a Hermitian A, with a skew-symmetric imaginary part, then a
+        // real nonsymmetric A
+        for( int sym=1; sym >= 0; sym-- ){
+            for( magma_int_t r=0; r<n; r++ ){
+                for( magma_int_t j=A.row[r]; j<A.row[r+1]; j++ ){
+                    magma_index_t c = A.col[j];
+                    double a = MAGMA_Z_REAL( A.val[j] );
+                    if( c == r ){
+                        A.val[j] = MAGMA_Z_MAKE( a, 0.0 );
+                    } else if( sym ){
+                        A.val[j] = MAGMA_Z_MAKE( a, (c > r) ? 0.25 : -0.25 );
+                    } else {
+                        A.val[j] = MAGMA_Z_MAKE( a + ((c > r) ? 0.25 : -0.25), 0.0 );
+                    }
+                }
+            }
+            TESTING_CHECK( magma_zamgsetup_cpu( A, precond, queue ));
+
+            // v^T M^{-T} u = u^T M^{-1} v
+            magma_int_t info1 = magma_z_applyprecond_left( MagmaTrans,   A, u, &y1, precond, queue );
+            magma_int_t info2 = magma_z_applyprecond_left( MagmaNoTrans, A, v, &y2, precond, queue );
+            bool okay;
+            if( sym ){
+                magmaDoubleComplex s1 = bilinear( n, v.val, y1.val );
+                magmaDoubleComplex s2 = bilinear( n, u.val, y2.val );
+                double error = MAGMA_Z_ABS( s1 - s2 ) / MAGMA_Z_ABS( s2 );
+                okay = ( info1 == 0 && info2 == 0 && error < tol );
+                printf( "%% Hermitian A:     |v^T M^-T u - u^T M^-1 v| / |u^T M^-1 v| = %.2e   %s\n",
+                        error, (okay ? "ok" : "failed") );
+            } else {
+                okay = ( info1 == MAGMA_ERR_NOT_SUPPORTED && info2 == 0 );
+                printf( "%% nonsymmetric A:  transposed apply returns %lld   %s\n",
+                        (long long) info1, (okay ? "ok" : "failed") );
+            }
+            status += ! okay;
+        }
+
+        magma_zamgfree_cpu( precond, queue );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &u, queue );
+        magma_zmfree( &v, queue );
+        magma_zmfree( &y1, queue );
+        magma_zmfree( &y2, queue );
+        i++;
+    }
+
+    magma_zprecondfree( &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
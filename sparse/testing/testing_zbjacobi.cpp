@@ -0,0 +1,331 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// CSR matrix on the host whose rows form supernodes of the given sizes:
+// all rows of a group have the columns of the previous, the same and the
+// next group. The diagonal block of group `singular` (if >= 0) is all ones.
+static void
+supernodal( magma_int_t num_groups, const magma_int_t *sizes, magma_int_t singular,
+            magma_z_matrix *A, magma_queue_t queue )
+{
+    magma_int_t n = 0, nnz = 0;
+    magma_int_t *first = (magma_int_t*) malloc( (num_groups+1) * sizeof(magma_int_t) );
+    for( magma_int_t g=0; g<num_groups; g++ ){
+        first[g] = n;
+        n += sizes[g];
+    }
+    first[ num_groups ] = n;
+    A->storage_type = Magma_CSR;
+    A->memory_location = Magma_CPU;
+    A->ownership = MagmaTrue;
+    A->num_rows = n;
+    A->num_cols = n;
+    TESTING_CHECK( magma_index_malloc_cpu( &A->row, n+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &A->col, 3*n*n ));
+    TESTING_CHECK( magma_zmalloc_cpu( &A->val, 3*n*n ));
+    A->row[0] = 0;
+    for( magma_int_t g=0; g<num_groups; g++ ){
+        magma_int_t c0 = first[ max( g-1, 0 ) ], c1 = first[ min( g+2, num_groups ) ];
+        for( magma_int_t i=first[g]; i<first[g+1]; i++ ){
+            for( magma_int_t j=c0; j<c1; j++ ){
+                bool inblock = ( j >= first[g] && j < first[g+1] );
+                A->col[nnz] = j;
+                if( g == singular && inblock ){
+                    A->val[nnz] = MAGMA_Z_ONE;
+                } else if( i == j ){
+                    A->val[nnz] = MAGMA_Z_MAKE( 10.0 + i % 3, 1.0 );
+                } else if( inblock ){
+                    A->val[nnz] = MAGMA_Z_MAKE( 1.0 / (1 + labs( (long) (i-j) )), 0.5 * ((i+j) % 2) );
+                } else {
+                    A->val[nnz] = MAGMA_Z_MAKE( -0.5, 0.0 );
+                }
+                nnz++;
+            }
+            A->row[i+1] = nnz;
+        }
+    }
+    A->nnz = nnz;
+    A->true_nnz = nnz;
+    free( first );
+}
+
+
+// applies op(D^{-1}) to a test vector b and returns max |op(D) x - b| / max |b|,
+// with D the block diagonal of A on the blocks of the preconditioner
+static double
+apply_error( magma_trans_t trans, magma_z_matrix A, magma_z_preconditioner *precond,
+             magma_queue_t queue )
+{
+    magma_int_t n = A.num_rows;
+    magma_z_matrix b={Magma_CSR}, x={Magma_CSR};
+    TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+    TESTING_CHECK( magma_zvinit( &x, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+    for( magma_int_t k=0; k<n; k++ ){
+        b.val[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 7) / 7.0, (double) (k % 3) / 3.0 - 0.5 );
+    }
+    if( magma_zapplybjacobi_cpu( trans, b, &x, precond, queue ) != 0 ){
+        magma_zmfree( &b, queue );
+        magma_zmfree( &x, queue );
+        return -1.0;
+    }
+    magmaDoubleComplex *r = (magmaDoubleComplex*) malloc( n * sizeof(magmaDoubleComplex) );
+    magma_index_t *blk = (magma_index_t*) malloc( n * sizeof(magma_index_t) );
+    for( magma_int_t k=0; k<precond->num_blocks; k++ ){
+        for( magma_int_t i=precond->block_ptr[k]; i<precond->block_ptr[k+1]; i++ ){
+            blk[i] = k;
+        }
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        r[i] = MAGMA_Z_NEG_ONE * b.val[i];
+    }
+    // r += op(D) x: entry (i,j) of A contributes to row i, or to row j
+    // for the transposes
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            magma_index_t c = A.col[j];
+            if( blk[c] == blk[i] ){
+                if( trans == MagmaNoTrans ){
+                    r[i] = r[i] + A.val[j] * x.val[c];
+                } else if( trans == MagmaTrans ){
+                    r[c] = r[c] + A.val[j] * x.val[i];
+                } else {
+                    r[c] = r[c] + MAGMA_Z_CONJ( A.val[j] ) * x.val[i];
+                }
+            }
+        }
+    }
+    double error = 0.0, scale = 0.0;
+    for( magma_int_t i=0; i<n; i++ ){
+        error = max( error, MAGMA_Z_ABS( r[i] ));
+        scale = max( scale, MAGMA_Z_ABS( b.val[i] ));
+    }
+    free( r );
+    free( blk );
+    magma_zmfree( &b, queue );
+    magma_zmfree( &x, queue );
+    return error / scale;
+}
+
+
+// true if the blocks of the preconditioner are exactly `expected`
+static bool
+same_blocks( magma_z_preconditioner *precond, magma_int_t num_expected,
+             const magma_index_t *expected )
+{
+    if( precond->num_blocks != num_expected ){
+        return false;
+    }
+    for( magma_int_t k=0; k<=num_expected; k++ ){
+        if( precond->block_ptr[k] != expected[k] ){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the host block-Jacobi preconditioner: block detection, the
+      inverted blocks in double and single precision storage, the fallback
+      for singular blocks, and the rejection of blocks of vectors
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR};
+    double tol = 1000 * lapackf77_dlamch( "E" );
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    magma_z_preconditioner *precond = &zopts.precond_par;
+    precond->solver = Magma_BLOCKJACOBI;
+
+    magma_trans_t trans[3] = { MagmaNoTrans, MagmaTrans, MagmaConjTrans };
+    const char *trans_name[3] = { "D", "D^T", "D^H" };
+
+    // supernodes of 3, 5, 2, 2, 7, 1 and 4 rows: merged up to 8 rows, and
+    // split and merged up to 4 rows
+    {
+        magma_int_t sizes[7] = { 3, 5, 2, 2, 7, 1, 4 };
+        magma_index_t blocks8[5] = { 0, 8, 12, 20, 24 };
+        magma_index_t blocks4[8] = { 0, 3, 7, 10, 12, 16, 20, 24 };
+        supernodal( 7, sizes, -1, &A, queue );
+        for( int t=0; t<2; t++ ){
+            precond->bsize = ( t == 0 ) ? 8 : 4;
+            precond->format = Magma_DOUBLE;
+            TESTING_CHECK( magma_z_precondsetup( A, A, &zopts.solver_par, precond, queue ));
+            bool okay = ( t == 0 ) ? same_blocks( precond, 4, blocks8 )
+                                   : same_blocks( precond, 7, blocks4 );
+            double error = 0.0;
+            for( int o=0; o<3; o++ ){
+                double e = apply_error( trans[o], A, precond, queue );
+                okay = okay && e >= 0 && e < tol;
+                error = max( error, e );
+            }
+            status += ! okay;
+            printf( "%% supernodes 3 5 2 2 7 1 4, block size %lld: %lld blocks,"
+                    " max |op(D) x - b| / |b| %.2e   %s\n",
+                    (long long) precond->bsize, (long long) precond->num_blocks, error,
+                    (okay ? "ok" : "failed") );
+        }
+        magma_zmfree( &A, queue );
+    }
+
+    // a singular diagonal block is replaced by its diagonal, here the
+    // identity, the other blocks are inverted
+    {
+        magma_int_t sizes[3] = { 4, 4, 4 };
+        magma_index_t blocks[4] = { 0, 4, 8, 12 };
+        supernodal( 3, sizes, 1, &A, queue );
+        precond->bsize = 4;
+        precond->format = Magma_DOUBLE;
+        TESTING_CHECK( magma_z_precondsetup( A, A, &zopts.solver_par, precond, queue ));
+        magma_z_matrix b={Magma_CSR}, x={Magma_CSR};
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, 12, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &x, Magma_CPU, 12, 1, MAGMA_Z_ZERO, queue ));
+        for( magma_int_t k=0; k<12; k++ ){
+            b.val[k] = MAGMA_Z_MAKE( 1.0 + k, 0.5 );
+        }
+        TESTING_CHECK( magma_zapplybjacobi_cpu( MagmaNoTrans, b, &x, precond, queue ));
+        bool okay = same_blocks( precond, 3, blocks );
+        for( magma_int_t k=4; k<8; k++ ){
+            okay = okay && MAGMA_Z_ABS( x.val[k] - b.val[k] ) == 0.0;
+        }
+        // the other blocks are inverted
+        double error = 0.0;
+        for( magma_int_t k=0; k<12; k++ ){
+            magmaDoubleComplex r = MAGMA_Z_NEG_ONE * b.val[k];
+            for( magma_int_t j=A.row[k]; j<A.row[k+1]; j++ ){
+                if( A.col[j] / 4 == k / 4 ){
+                    r = r + A.val[j] * x.val[ A.col[j] ];
+                }
+            }
+            error = ( k / 4 == 1 ) ? error : max( error, MAGMA_Z_ABS( r ) / MAGMA_Z_ABS( b.val[k] ));
+        }
+        okay = okay && error < tol;
+        status += ! okay;
+        printf( "%% singular block: diagonal fallback, error of the other blocks %.2e   %s\n",
+                error, (okay ? "ok" : "failed") );
+        magma_zmfree( &b, queue );
+        magma_zmfree( &x, queue );
+        magma_zmfree( &A, queue );
+    }
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        magma_int_t n = A.num_rows;
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        // the Gauss-Jordan kernels, the generic kernel, and LAPACK; blocks
+        // cover all rows and respect the bound
+        magma_int_t bsizes[4] = { 1, 8, 20, 40 };
+        for( int s=0; s<4; s++ ){
+            precond->bsize = bsizes[s];
+            precond->format = Magma_DOUBLE;
+            TESTING_CHECK( magma_z_precondsetup( A, A, &zopts.solver_par, precond, queue ));
+            bool okay = precond->block_ptr[0] == 0
+                        && precond->block_ptr[ precond->num_blocks ] == n;
+            for( magma_int_t k=0; k<precond->num_blocks && okay; k++ ){
+                magma_int_t bs = precond->block_ptr[k+1] - precond->block_ptr[k];
+                okay = bs > 0 && bs <= bsizes[s];
+            }
+            double error = 0.0;
+            for( int o=0; o<3; o++ ){
+                double e = apply_error( trans[o], A, precond, queue );
+                okay = okay && e >= 0 && e < tol;
+                error = max( error, e );
+                printf( "%% block size %2lld: %6lld blocks, max |%-3s x - b| / |b| %.2e   %s\n",
+                        (long long) bsizes[s], (long long) precond->num_blocks,
+                        trans_name[o], e, (okay ? "ok" : "failed") );
+            }
+            status += ! okay;
+        }
+
+        // single precision storage: the result agrees with the double
+        // precision blocks to single precision accuracy
+        {
+            magma_z_matrix b={Magma_CSR}, x={Magma_CSR}, x_low={Magma_CSR};
+            TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+            TESTING_CHECK( magma_zvinit( &x, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+            TESTING_CHECK( magma_zvinit( &x_low, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+            for( magma_int_t k=0; k<n; k++ ){
+                b.val[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 5), (double) (k % 2) );
+            }
+            precond->bsize = 20;
+            precond->format = Magma_DOUBLE;
+            TESTING_CHECK( magma_z_precondsetup( A, A, &zopts.solver_par, precond, queue ));
+            TESTING_CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, b, &x, precond, queue ));
+            precond->format = Magma_FLOAT;
+            TESTING_CHECK( magma_z_precondsetup( A, A, &zopts.solver_par, precond, queue ));
+            bool okay = precond->block_val == NULL && precond->block_val_low != NULL;
+            TESTING_CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, b, &x_low, precond, queue ));
+            double diff = 0.0, nrm = 0.0;
+            for( magma_int_t k=0; k<n; k++ ){
+                diff = max( diff, MAGMA_Z_ABS( x.val[k] - x_low.val[k] ));
+                nrm  = max( nrm,  MAGMA_Z_ABS( x.val[k] ));
+            }
+            okay = okay && diff / nrm < 1e-5;
+            status += ! okay;
+            printf( "%% single precision blocks: max |x - x_low| / |x| %.2e   %s\n",
+                    diff / nrm, (okay ? "ok" : "failed") );
+
+            // blocks of vectors are rejected
+            magma_z_matrix B={Magma_CSR}, X={Magma_CSR};
+            TESTING_CHECK( magma_zvinit( &B, Magma_CPU, n, 2, MAGMA_Z_ONE, queue ));
+            TESTING_CHECK( magma_zvinit( &X, Magma_CPU, n, 2, MAGMA_Z_ZERO, queue ));
+            magma_int_t info = magma_zapplybjacobi_cpu( MagmaNoTrans, B, &X, precond, queue );
+            okay = ( info == MAGMA_ERR_NOT_SUPPORTED );
+            status += ! okay;
+            printf( "%% two right-hand sides: info %lld   %s\n",
+                    (long long) info, (okay ? "ok" : "failed") );
+            magma_zmfree( &B, queue );
+            magma_zmfree( &X, queue );
+            magma_zmfree( &b, queue );
+            magma_zmfree( &x, queue );
+            magma_zmfree( &x_low, queue );
+        }
+
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_zprecondfree( &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
@@ -19,6 +19,7 @@
 #include "magma_v2.h"
 #include "magmasparse.h"
 #include "magma_lapack.h"
+#include "magma_operators.h"
 #include "testings.h"
 
 
@@ -27,7 +28,7 @@
 */
 int main(  int argc, char** argv )
 {
-    magma_int_t info = 0;
+    int status = 0;
     TESTING_CHECK( magma_init() );
     magma_print_environment();
     magma_queue_t queue=NULL;
@@ -35,11 +36,13 @@ int main(  int argc, char** argv )
     
     magmaDoubleComplex one = MAGMA_Z_MAKE(1.0, 0.0);
     magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
+    magmaDoubleComplex mone = MAGMA_Z_MAKE(-1.0, 0.0);
     magma_z_matrix A={Magma_CSR}, dB={Magma_CSR};
     magma_c_matrix cA={Magma_CSR}, dcB={Magma_CSR};
     magma_z_matrix diag={Magma_CSR}, ddiag={Magma_CSR};
     magma_z_matrix x={Magma_CSR}, b={Magma_CSR};
     real_Double_t start, end;
+    magma_int_t ione = 1;
 
     int i=1;
     while( i < argc ) {
@@ -134,10 +137,75 @@ int main(  int argc, char** argv )
         magma_zmfree(&x, queue );
         magma_zmfree(&b, queue );
 
+        
+        // host SpMV with reduced-precision storage of A
+        printf("\n\nhost SpMV with reduced-precision storage:\n");
+        
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, A.num_rows, 1, zero, queue ));
+        TESTING_CHECK( magma_zvinit( &x, Magma_CPU, A.num_cols, 1, one, queue ));
+        magma_zmfree(&diag, queue );
+        TESTING_CHECK( magma_zvinit( &diag, Magma_CPU, A.num_rows, 1, zero, queue ));
+        for (magma_int_t k=0; k<A.num_cols; k++) {
+            x.val[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 7) / 7.0, 0.0 );
+        }
+        
+        // working precision reference
+        start = magma_wtime();
+        for (int z=0; z<10; z++) {
+            #pragma omp parallel for
+            for (magma_int_t k=0; k<A.num_rows; k++) {
+                magmaDoubleComplex s = zero;
+                for (magma_int_t j=A.row[k]; j<A.row[k+1]; j++) {
+                    s = s + A.val[j] * x.val[ A.col[j] ];
+                }
+                diag.val[k] = s;
+            }
+        }
+        end = magma_wtime();
+        printf( " > host CSR SpMV : %.2e seconds %.2e GFLOP/s.\n",
+                                        (end-start)/10, FLOPS*10/(end-start) );
+        
+        // the error of each storage mode is bounded by its unit roundoff
+        // relative to |A| |x|
+        double absnrm = 0.0;
+        for (magma_int_t k=0; k<A.num_rows; k++) {
+            double s = 0.0;
+            for (magma_int_t j=A.row[k]; j<A.row[k+1]; j++) {
+                s += MAGMA_Z_ABS( A.val[j] ) * MAGMA_Z_ABS( x.val[ A.col[j] ] );
+            }
+            absnrm += s*s;
+        }
+        absnrm = sqrt( absnrm );
+        
+        magma_precision storage[3] = { Magma_DOUBLE, Magma_FLOAT, Magma_BFLOAT16 };
+        const char *storage_name[3] = { "working precision, 16-bit indices", "float", "bfloat16" };
+        double tol[3] = { 10 * lapackf77_dlamch("E"), 10 * lapackf77_slamch("E"), 10 * 0.00390625 };
+        for (int p=0; p<3; p++) {
+            TESTING_CHECK( magma_zmlowprec_cpu( storage[p], &A, queue ));
+            TESTING_CHECK( magma_z_spmv( one, A, x, zero, b, queue ));  // warmup
+            start = magma_wtime();
+            for (int z=0; z<10; z++) {
+                TESTING_CHECK( magma_z_spmv( one, A, x, zero, b, queue ));
+            }
+            end = magma_wtime();
+            blasf77_zaxpy( &n, &mone, diag.val, &ione, b.val, &ione );
+            double error = lapackf77_zlange( "F", &n, &ione, b.val, &n, NULL ) / absnrm;
+            bool okay = (error < tol[p]);
+            status += ! okay;
+            printf( " > host SpMV (%s) : %.2e seconds %.2e GFLOP/s, error %.2e   %s\n",
+                    storage_name[p], (end-start)/10, FLOPS*10/(end-start),
+                    error, (okay ? "ok" : "failed") );
+        }
+        TESTING_CHECK( magma_zmlowprec_free( &A, queue ));
+        
+        magma_zmfree(&diag, queue );
+        magma_zmfree(&x, queue );
+        magma_zmfree(&b, queue );
+
         i++;
     }
 
     magma_queue_destroy( queue );
     magma_finalize();
-    return info;
+    return status;
 }
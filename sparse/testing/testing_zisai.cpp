@@ -0,0 +1,179 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// lower (or upper) triangle of A, including the diagonal, on the host
+static void
+triangle( magma_uplo_t uplo, magma_z_matrix A, magma_z_matrix *T, magma_queue_t queue )
+{
+    magma_int_t nnz = 0;
+    for( magma_int_t r=0; r<A.num_rows; r++ ){
+        for( magma_int_t j=A.row[r]; j<A.row[r+1]; j++ ){
+            nnz += ( uplo == MagmaLower ) ? ( A.col[j] <= r ) : ( A.col[j] >= r );
+        }
+    }
+    T->storage_type = Magma_CSR;
+    T->memory_location = Magma_CPU;
+    T->ownership = MagmaTrue;
+    T->num_rows = A.num_rows;
+    T->num_cols = A.num_cols;
+    T->nnz = nnz;
+    TESTING_CHECK( magma_index_malloc_cpu( &T->row, A.num_rows+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &T->col, nnz ));
+    TESTING_CHECK( magma_zmalloc_cpu( &T->val, nnz ));
+    nnz = 0;
+    for( magma_int_t r=0; r<A.num_rows; r++ ){
+        T->row[r] = nnz;
+        for( magma_int_t j=A.row[r]; j<A.row[r+1]; j++ ){
+            if( ( uplo == MagmaLower ) ? ( A.col[j] <= r ) : ( A.col[j] >= r ) ){
+                T->col[nnz] = A.col[j];
+                T->val[nnz] = A.val[j];
+                nnz++;
+            }
+        }
+    }
+    T->row[A.num_rows] = nnz;
+}
+
+
+// |I - M T|_F / sqrt(n), and the largest |(I - M T)_ij| on the pattern of M
+static void
+isai_error( magma_z_matrix M, magma_z_matrix T, double *frob, double *onpattern )
+{
+    magma_int_t n = T.num_rows;
+    magmaDoubleComplex *w = (magmaDoubleComplex*) calloc( n, sizeof(magmaDoubleComplex) );
+    char *used = (char*) calloc( n, 1 );
+    magma_index_t *list = (magma_index_t*) malloc( n * sizeof(magma_index_t) );
+    double sum = 0.0, maxp = 0.0;
+    for( magma_int_t i=0; i<n; i++ ){
+        magma_int_t cnt = 0;
+        for( magma_int_t j=M.row[i]; j<M.row[i+1]; j++ ){
+            magma_index_t k = M.col[j];
+            for( magma_int_t l=T.row[k]; l<T.row[k+1]; l++ ){
+                magma_index_t c = T.col[l];
+                if( ! used[c] ){
+                    used[c] = 1;
+                    list[cnt++] = c;
+                }
+                w[c] = w[c] + M.val[j] * T.val[l];
+            }
+        }
+        if( ! used[i] ){
+            used[i] = 1;
+            list[cnt++] = i;
+        }
+        w[i] = w[i] - MAGMA_Z_ONE;
+        for( magma_int_t j=M.row[i]; j<M.row[i+1]; j++ ){
+            maxp = max( maxp, MAGMA_Z_ABS( w[ M.col[j] ] ));
+        }
+        for( magma_int_t l=0; l<cnt; l++ ){
+            magma_index_t c = list[l];
+            sum += MAGMA_Z_ABS( w[c] ) * MAGMA_Z_ABS( w[c] );
+            w[c] = MAGMA_Z_ZERO;
+            used[c] = 0;
+        }
+    }
+    *frob = sqrt( sum / n );
+    *onpattern = maxp;
+    free( w );
+    free( used );
+    free( list );
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the host ISAI of triangular factors: M T = I on the pattern of
+      M, and |I - M T| decreasing with the pattern power
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, T={Magma_CSR}, M={Magma_CSR};
+    double tol = 1000 * lapackf77_dlamch( "E" );
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        magma_uplo_t uplo[2] = { MagmaLower, MagmaUpper };
+        const char *uplo_name[2] = { "lower", "upper" };
+        for( int u=0; u<2; u++ ){
+            triangle( uplo[u], A, &T, queue );
+            double last = 0.0;
+            for( magma_int_t k=1; k<=3; k++ ){
+                double frob, onpattern;
+                TESTING_CHECK( magma_zisaisetup_cpu( uplo[u], T, T, k, &M, queue ));
+                isai_error( M, T, &frob, &onpattern );
+                bool okay = ( onpattern < tol && ( k == 1 || frob < last ));
+                status += ! okay;
+                printf( "%% %s, pattern power %lld: nnz(M) %8lld, |I - M T|_F / sqrt(n) %.2e,"
+                        " max on pattern %.2e   %s\n",
+                        uplo_name[u], (long long) k, (long long) M.nnz, frob, onpattern,
+                        (okay ? "ok" : "failed") );
+                last = frob;
+                magma_zmfree( &M, queue );
+            }
+
+            // the ILU setup uses the host generator for host factors
+            if( uplo[u] == MagmaLower ){
+                TESTING_CHECK( magma_ziluisaisetup_lower( T, T, &M, queue ));
+            } else {
+                TESTING_CHECK( magma_ziluisaisetup_upper( T, T, &M, queue ));
+            }
+            {
+                double frob, onpattern;
+                isai_error( M, T, &frob, &onpattern );
+                bool okay = ( M.memory_location == Magma_CPU && M.nnz == T.nnz
+                              && onpattern < tol );
+                status += ! okay;
+                printf( "%% %s, ILU ISAI setup on the host: max on pattern %.2e   %s\n",
+                        uplo_name[u], onpattern, (okay ? "ok" : "failed") );
+            }
+            magma_zmfree( &M, queue );
+            magma_zmfree( &T, queue );
+        }
+
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
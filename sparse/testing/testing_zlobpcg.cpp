@@ -0,0 +1,197 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>  // before testings.h, which defines max, min
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// the k smallest eigenvalues of the 2D Laplacian on an N-by-N grid,
+// 4 - 2 cos( i pi / (N+1) ) - 2 cos( j pi / (N+1) )
+static void
+laplace_spectrum( magma_int_t N, magma_int_t k, double *ev )
+{
+    double *all = (double*) malloc( N*N * sizeof(double) );
+    for( magma_int_t i=1; i<=N; i++ ){
+        for( magma_int_t j=1; j<=N; j++ ){
+            all[ (i-1)*N + (j-1) ] = 4.0 - 2.0 * cos( i * M_PI / (N+1) )
+                                         - 2.0 * cos( j * M_PI / (N+1) );
+        }
+    }
+    std::sort( all, all + N*N );
+    for( magma_int_t l=0; l<k; l++ ){
+        ev[l] = all[l];
+    }
+    free( all );
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the host LOBPCG: the smallest eigenvalues of the 2D Laplacian
+      against its known spectrum, and the residuals and orthonormality of
+      the eigenvectors, without preconditioner and with Jacobi, also for a
+      diagonally scaled matrix
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR};
+    magmaDoubleComplex *X = NULL;
+    double *exact = NULL;
+    magma_int_t k = 8;
+    // the eigenvalue error is about the square of the residual
+    double rtol = 10 * sqrt( lapackf77_dlamch( "E" ));
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    if( zopts.solver_par.num_eigenvalues > 0 ){
+        k = zopts.solver_par.num_eigenvalues;
+    }
+
+    magma_solver_type precond_type[2] = { Magma_NONE, Magma_JACOBI };
+    const char *precond_name[2] = { "none", "Jacobi" };
+
+    while( i < argc ) {
+        magma_int_t laplace_size = 0;
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+            // the complex stencil is (1+i) times the Laplacian, which is
+            // not hermitian
+            for( magma_int_t j=0; j<A.nnz; j++ ){
+                A.val[j] = MAGMA_Z_MAKE( MAGMA_Z_REAL( A.val[j] ), 0.0 );
+            }
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        magma_int_t m = A.num_rows;
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros, %lld eigenpairs\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz,
+                (long long) k );
+
+        TESTING_CHECK( magma_zmalloc_cpu( &X, m*k ));
+        TESTING_CHECK( magma_dmalloc_cpu( &exact, k ));
+
+        // the matrix as given, and D A D with a varying diagonal D, where
+        // Jacobi changes the iteration; the reference eigenvalues are the
+        // known spectrum for the Laplacian, and else those of the run
+        // without preconditioner
+        for( int v=0; v<2; v++ ){
+            if( v == 1 ){
+                for( magma_int_t r=0; r<m; r++ ){
+                    for( magma_int_t j=A.row[r]; j<A.row[r+1]; j++ ){
+                        double d = ( 1.0 + (r % 5) / 2.0 ) * ( 1.0 + (A.col[j] % 5) / 2.0 );
+                        A.val[j] = MAGMA_Z_MAKE( d, 0.0 ) * A.val[j];
+                    }
+                }
+            }
+            bool known = ( v == 0 && laplace_size > 0 );
+            if( known ){
+                laplace_spectrum( laplace_size, k, exact );
+            }
+
+            for( int p=0; p<2; p++ ){
+                magma_z_solver_par solver_par = zopts.solver_par;
+                magma_z_preconditioner *precond = &zopts.precond_par;
+                solver_par.solver = Magma_LOBPCG;
+                solver_par.num_eigenvalues = k;
+                solver_par.ev_length = m;
+                solver_par.rtol = rtol;
+                solver_par.atol = 0.0;
+                solver_par.maxiter = 1000;
+                solver_par.verbose = 0;
+                precond->solver = precond_type[p];
+                TESTING_CHECK( magma_zeigensolverinfo_init( &solver_par, queue ));
+
+                magma_int_t info = magma_zlobpcg_cpu( A, &solver_par, precond, queue );
+                magma_zgetmatrix( m, k, solver_par.eigenvectors, m, X, m, queue );
+
+                // eigenvalues against the reference
+                double everr = 0.0;
+                for( magma_int_t l=0; l<k; l++ ){
+                    if( known || p > 0 ){
+                        everr = max( everr, fabs( solver_par.eigenvalues[l] - exact[l] ) / fabs( exact[l] ));
+                    } else {
+                        exact[l] = solver_par.eigenvalues[l];
+                    }
+                }
+
+                // residuals | A x - lambda x | / | lambda |
+                double res = 0.0;
+                for( magma_int_t l=0; l<k; l++ ){
+                    double nrm = 0.0;
+                    for( magma_int_t r=0; r<m; r++ ){
+                        magmaDoubleComplex s = MAGMA_Z_ZERO;
+                        for( magma_int_t j=A.row[r]; j<A.row[r+1]; j++ ){
+                            s = s + A.val[j] * X[ A.col[j] + l*m ];
+                        }
+                        s = s - MAGMA_Z_MAKE( solver_par.eigenvalues[l], 0.0 ) * X[ r + l*m ];
+                        nrm += MAGMA_Z_ABS( s ) * MAGMA_Z_ABS( s );
+                    }
+                    res = max( res, sqrt( nrm ) / fabs( solver_par.eigenvalues[l] ));
+                }
+
+                // | X^H X - I |
+                double orth = 0.0;
+                for( magma_int_t l1=0; l1<k; l1++ ){
+                    for( magma_int_t l2=0; l2<k; l2++ ){
+                        magmaDoubleComplex s = MAGMA_Z_ZERO;
+                        for( magma_int_t r=0; r<m; r++ ){
+                            s = s + MAGMA_Z_CONJ( X[ r + l1*m ] ) * X[ r + l2*m ];
+                        }
+                        s = ( l1 == l2 ) ? s - MAGMA_Z_ONE : s;
+                        orth = max( orth, MAGMA_Z_ABS( s ));
+                    }
+                }
+
+                bool okay = ( info == 0 && res < 2 * rtol && orth < 100 * rtol * rtol
+                              && everr < rtol );
+                status += ! okay;
+                printf( "%% %-5s precond %-6s: %4lld iterations, max |A x - l x| / |l| %.2e,"
+                        " |X^H X - I| %.2e, eigenvalue error %.2e   %s\n",
+                        (v == 0 ? "A" : "D A D"), precond_name[p], (long long) solver_par.numiter,
+                        res, orth, everr, (okay ? "ok" : "failed") );
+
+                magma_free( solver_par.eigenvectors );
+                magma_free_cpu( solver_par.eigenvalues );
+            }
+        }
+
+        magma_free_cpu( X );
+        magma_free_cpu( exact );
+        X = NULL;
+        exact = NULL;
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_zprecondfree( &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
@@ -0,0 +1,167 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// sum_i x_i y_i, without conjugation
+static magmaDoubleComplex
+bilinear( magma_int_t n, const magmaDoubleComplex *x, const magmaDoubleComplex *y )
+{
+    magmaDoubleComplex s = MAGMA_Z_ZERO;
+    for( magma_int_t i=0; i<n; i++ ){
+        s = s + x[i] * y[i];
+    }
+    return s;
+}
+
+
+// |b - A x| on the host
+static double
+residual( magma_z_matrix A, const magmaDoubleComplex *b, const magmaDoubleComplex *x )
+{
+    double nrm = 0.0;
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magmaDoubleComplex s = b[i];
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            s = s - A.val[j] * x[ A.col[j] ];
+        }
+        nrm += MAGMA_Z_ABS( s ) * MAGMA_Z_ABS( s );
+    }
+    return sqrt( nrm );
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the host multicolor Gauss-Seidel / SSOR solver and
+      preconditioner
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, b={Magma_CSR}, x={Magma_CSR};
+    magma_z_matrix u={Magma_CSR}, v={Magma_CSR}, y1={Magma_CSR}, y2={Magma_CSR};
+    double tol = 1000 * lapackf77_dlamch( "E" ), rtol = 1e-8;
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    magma_z_preconditioner *precond = &zopts.precond_par;
+
+    magma_solver_type type[2] = { Magma_GS, Magma_SSOR };
+    const char *name[2] = { "GS", "SSOR" };
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        magma_int_t n = A.num_rows;
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        TESTING_CHECK( magma_zvinit( &b,  Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &u,  Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &v,  Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &y1, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &y2, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        for( magma_int_t k=0; k<n; k++ ){
+            b.val[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 13) / 13.0, 0.0 );
+            u.val[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 7) / 7.0, (double) (k % 3) / 3.0 );
+            v.val[k] = MAGMA_Z_MAKE( (double) (k % 5) / 5.0 - 0.5, 1.0 - (double) (k % 11) / 11.0 );
+        }
+        double bnrm = residual( A, b.val, y1.val );   // y1 = 0
+
+        for( int t=0; t<2; t++ ){
+            // solver: converges to rtol, and the reported residual is the
+            // true one
+            {
+                magma_z_solver_par solver_par = zopts.solver_par;
+                solver_par.solver = type[t];
+                solver_par.rtol = rtol;
+                solver_par.maxiter = 10000;
+                solver_par.verbose = 0;
+                precond->omega = 1.0;
+                TESTING_CHECK( magma_zvinit( &x, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+                magma_int_t info = magma_zmcgs( A, b, &x, &solver_par, precond, queue );
+                double res = residual( A, b.val, x.val );
+                bool okay = ( info == 0 && res <= rtol * bnrm * 1.01
+                              && fabs( res - solver_par.final_res ) <= 1e-3 * res );
+                status += ! okay;
+                printf( "%% %-4s solver: %5lld iterations, |b - A x| / |b| = %.2e (reported %.2e)   %s\n",
+                        name[t], (long long) solver_par.numiter, res / bnrm,
+                        solver_par.final_res / bnrm, (okay ? "ok" : "failed") );
+                magma_zmfree( &x, queue );
+            }
+
+            // preconditioner, two sweeps, with over-relaxation: for A = A^T
+            // the transposed application satisfies v^T M^{-T} u = u^T M^{-1} v
+            {
+                precond->solver = type[t];
+                precond->maxiter = 2;
+                precond->omega = 1.2;
+                TESTING_CHECK( magma_zmcgssetup_cpu( A, precond, queue ));
+                magma_int_t info1 = magma_z_applyprecond_left( MagmaTrans,   A, u, &y1, precond, queue );
+                magma_int_t info2 = magma_z_applyprecond_left( MagmaNoTrans, A, v, &y2, precond, queue );
+                magmaDoubleComplex s1 = bilinear( n, v.val, y1.val );
+                magmaDoubleComplex s2 = bilinear( n, u.val, y2.val );
+                double error = MAGMA_Z_ABS( s1 - s2 ) / MAGMA_Z_ABS( s2 );
+
+                // Gauss-Seidel is not symmetric: M^{-T} u differs from M^{-1} u
+                magma_int_t info3 = magma_z_applyprecond_left( MagmaNoTrans, A, u, &y2, precond, queue );
+                double diff = 0.0, nrm = 0.0;
+                for( magma_int_t k=0; k<n; k++ ){
+                    diff += MAGMA_Z_ABS( y1.val[k] - y2.val[k] ) * MAGMA_Z_ABS( y1.val[k] - y2.val[k] );
+                    nrm  += MAGMA_Z_ABS( y2.val[k] ) * MAGMA_Z_ABS( y2.val[k] );
+                }
+                diff = sqrt( diff / nrm );
+                bool okay = ( info1 == 0 && info2 == 0 && info3 == 0 && error < tol
+                              && ( type[t] == Magma_SSOR ? diff < tol : diff > 1e-3 ));
+                status += ! okay;
+                printf( "%% %-4s preconditioner: |v^T M^-T u - u^T M^-1 v| / |u^T M^-1 v| = %.2e,"
+                        " |M^-T u - M^-1 u| / |M^-1 u| = %.2e   %s\n",
+                        name[t], error, diff, (okay ? "ok" : "failed") );
+            }
+        }
+
+        magma_zmfree( &A, queue );
+        magma_zmfree( &b, queue );
+        magma_zmfree( &u, queue );
+        magma_zmfree( &v, queue );
+        magma_zmfree( &y1, queue );
+        magma_zmfree( &y2, queue );
+        i++;
+    }
+
+    magma_zprecondfree( &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
@@ -0,0 +1,214 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// solves A x = b by dense LU; x is overwritten by the solution
+static magma_int_t
+dense_solve( magma_z_matrix A, magmaDoubleComplex *x )
+{
+    magma_int_t n = A.num_rows, ione = 1, info = 0;
+    magmaDoubleComplex *dA = NULL;
+    magma_int_t *ipiv = NULL;
+    TESTING_CHECK( magma_zmalloc_cpu( &dA, n*n ));
+    TESTING_CHECK( magma_imalloc_cpu( &ipiv, n ));
+    for( magma_int_t k=0; k<n*n; k++ ){
+        dA[k] = MAGMA_Z_ZERO;
+    }
+    for( magma_int_t i=0; i<n; i++ ){
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            dA[ i + A.col[j]*n ] = A.val[j];
+        }
+    }
+    lapackf77_zgesv( &n, &ione, dA, &n, ipiv, x, &n, &info );
+    magma_free_cpu( dA );
+    magma_free_cpu( ipiv );
+    return info;
+}
+
+
+// |x - y| / |y|
+static double
+error( magma_int_t n, const magmaDoubleComplex *x, const magmaDoubleComplex *y )
+{
+    double enrm = 0.0, ynrm = 0.0;
+    for( magma_int_t k=0; k<n; k++ ){
+        enrm += MAGMA_Z_ABS( x[k] - y[k] ) * MAGMA_Z_ABS( x[k] - y[k] );
+        ynrm += MAGMA_Z_ABS( y[k] ) * MAGMA_Z_ABS( y[k] );
+    }
+    return sqrt( enrm / ynrm );
+}
+
+
+// max_i |b - A x|_i / (|A| |x| + |b|)_i, the row-wise backward error of x;
+// it does not change when the rows and columns of A are scaled
+static double
+backward_error( magma_z_matrix A, const magmaDoubleComplex *b,
+                const magmaDoubleComplex *x )
+{
+    double berr = 0.0;
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magmaDoubleComplex r = b[i];
+        double scale = MAGMA_Z_ABS( b[i] );
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            r = r - A.val[j] * x[ A.col[j] ];
+            scale += MAGMA_Z_ABS( A.val[j] ) * MAGMA_Z_ABS( x[ A.col[j] ] );
+        }
+        berr = max( berr, MAGMA_Z_ABS( r ) / scale );
+    }
+    return berr;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing row and column equilibration: solves the equilibrated system of
+      a badly scaled matrix and recovers the solution of the original system
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, E={Magma_CSR}, b={Magma_CSR}, y={Magma_CSR},
+                   dr={Magma_CSR}, dc={Magma_CSR};
+    magmaDoubleComplex *x=NULL;
+    double eps = lapackf77_dlamch( "E" );
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        magma_int_t n = A.num_rows;
+        if ( n != A.num_cols || n > 4000 ) {
+            printf( "%% skipping %lld-by-%lld matrix: square, at most 4000 rows\n",
+                    (long long) A.num_rows, (long long) A.num_cols );
+            magma_zmfree( &A, queue );
+            i++;
+            continue;
+        }
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        // rows and columns scaled over 6 and 4 orders of magnitude
+        for( magma_int_t r=0; r<n; r++ ){
+            for( magma_int_t j=A.row[r]; j<A.row[r+1]; j++ ){
+                double sr = pow( 10.0, (double) (r % 7 - 3) );
+                double sc = pow( 10.0, (double) ((3*A.col[j]) % 5 - 2) );
+                A.val[j] = A.val[j] * MAGMA_Z_MAKE( sr * sc, 0.0 );
+            }
+        }
+
+        // b = A x for a known x
+        TESTING_CHECK( magma_zmalloc_cpu( &x, n ));
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        for( magma_int_t k=0; k<n; k++ ){
+            x[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 13) / 13.0, 0.0 );
+        }
+        for( magma_int_t r=0; r<n; r++ ){
+            for( magma_int_t j=A.row[r]; j<A.row[r+1]; j++ ){
+                b.val[r] = b.val[r] + A.val[j] * x[ A.col[j] ];
+            }
+        }
+
+        // magma_zmscale cannot return the row and column factors
+        {
+            TESTING_CHECK( magma_zmtransfer( A, &E, Magma_CPU, Magma_CPU, queue ));
+            magma_int_t info = magma_zmscale( &E, Magma_MAXNORM, queue );
+            bool okay = ( info == MAGMA_ERR_NOT_SUPPORTED );
+            for( magma_int_t j=0; j<A.nnz; j++ ){
+                okay = okay && MAGMA_Z_EQUAL( E.val[j], A.val[j] );
+            }
+            status += ! okay;
+            printf( "%% magma_zmscale rejects MAXNORM, matrix unchanged:   %s\n",
+                    (okay ? "ok" : "failed") );
+            magma_zmfree( &E, queue );
+        }
+
+        magma_scale_t scaling[4] = { Magma_NOSCALE, Magma_UNITDIAG, Magma_MAXNORM, Magma_RUIZ };
+        const char *scaling_name[4] = { "NOSCALE", "UNITDIAG", "MAXNORM", "RUIZ" };
+        for( int s=0; s<4; s++ ){
+            // (Dr A Dc) y = Dr b, x = Dc y
+            TESTING_CHECK( magma_zmtransfer( A, &E, Magma_CPU, Magma_CPU, queue ));
+            TESTING_CHECK( magma_zmtransfer( b, &y, Magma_CPU, Magma_CPU, queue ));
+            if ( scaling[s] != Magma_NOSCALE ) {
+                TESTING_CHECK( magma_zmequilibrate( scaling[s], 0, &E, &dr, &dc, queue ));
+                TESTING_CHECK( magma_zmequilibrate_vector( dr, &y, queue ));
+            }
+            magma_int_t info = dense_solve( E, y.val );
+            if ( scaling[s] != Magma_NOSCALE ) {
+                TESTING_CHECK( magma_zmequilibrate_vector( dc, &y, queue ));
+            }
+            double err  = ( info == 0 ) ? error( n, y.val, x ) : INFINITY;
+            double berr = ( info == 0 ) ? backward_error( A, b.val, y.val ) : INFINITY;
+
+            // max-norm of every row of the equilibrated matrix
+            double rmin = INFINITY, rmax = 0.0;
+            for( magma_int_t r=0; r<n; r++ ){
+                double rnrm = 0.0;
+                for( magma_int_t j=E.row[r]; j<E.row[r+1]; j++ ){
+                    rnrm = max( rnrm, MAGMA_Z_ABS( E.val[j] ));
+                }
+                rmin = min( rmin, rnrm );
+                rmax = max( rmax, rnrm );
+            }
+
+            printf( "%% %-8s  row max-norms in [%.2e, %.2e], |x - x_true| / |x_true| = %.2e,"
+                    " backward error %.2e",
+                    scaling_name[s], rmin, rmax, err, berr );
+            if ( scaling[s] == Magma_MAXNORM || scaling[s] == Magma_RUIZ ) {
+                // balanced rows, and x recovered from the equilibrated
+                // system solves the original one to the accuracy of LU;
+                // without scaling partial pivoting picks poor pivots here
+                bool okay = ( rmin > 0.5 && rmax < 2.0 && berr < 10 * n * eps );
+                status += ! okay;
+                printf( "   %s", (okay ? "ok" : "failed") );
+            }
+            printf( "\n" );
+            magma_zmfree( &E, queue );
+            magma_zmfree( &y, queue );
+        }
+
+        magma_zmfree( &dr, queue );
+        magma_zmfree( &dc, queue );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &b, queue );
+        magma_free_cpu( x );
+        x = NULL;
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
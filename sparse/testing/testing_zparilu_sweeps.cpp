@@ -0,0 +1,254 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+#include "../../control/magma_threadsetting.h"  // internal header
+
+
+// || A - LU ||_F on the pattern of A, with L in CSR and U in CSC as used by
+// the ParILU sweeps, by scattering one row of L at a time
+static double
+exact_residual( magma_z_matrix ACOO, magma_z_matrix L, magma_z_matrix U )
+{
+    magmaDoubleComplex *w = (magmaDoubleComplex*) calloc( L.num_cols, sizeof(magmaDoubleComplex) );
+    double sum = 0.0;
+    for( magma_int_t i=0; i<ACOO.num_rows; i++ ){
+        for( magma_int_t k=L.row[i]; k<L.row[i+1]; k++ ){
+            w[ L.col[k] ] = L.val[k];
+        }
+        for( magma_int_t k=ACOO.row[i]; k<ACOO.row[i+1]; k++ ){
+            magma_index_t j = ACOO.col[k];
+            magmaDoubleComplex r = ACOO.val[k];
+            for( magma_int_t l=U.row[j]; l<U.row[j+1]; l++ ){
+                r = r - w[ U.col[l] ] * U.val[l];
+            }
+            sum += MAGMA_Z_ABS( r ) * MAGMA_Z_ABS( r );
+        }
+        for( magma_int_t k=L.row[i]; k<L.row[i+1]; k++ ){
+            w[ L.col[k] ] = MAGMA_Z_ZERO;
+        }
+    }
+    free( w );
+    return sqrt( sum );
+}
+
+
+// || new - old ||_F / || new ||_F over the entries a sweep writes: the
+// strictly lower part of L and all of U
+static double
+relative_change( magma_z_matrix L, const magmaDoubleComplex *Lold,
+                 magma_z_matrix U, const magmaDoubleComplex *Uold )
+{
+    double diff = 0.0, nrm = 0.0;
+    for( magma_int_t i=0; i<L.num_rows; i++ ){
+        for( magma_int_t k=L.row[i]; k<L.row[i+1]; k++ ){
+            if( L.col[k] < i ){
+                diff += MAGMA_Z_ABS( L.val[k] - Lold[k] ) * MAGMA_Z_ABS( L.val[k] - Lold[k] );
+                nrm  += MAGMA_Z_ABS( L.val[k] ) * MAGMA_Z_ABS( L.val[k] );
+            }
+        }
+    }
+    for( magma_int_t k=0; k<U.nnz; k++ ){
+        diff += MAGMA_Z_ABS( U.val[k] - Uold[k] ) * MAGMA_Z_ABS( U.val[k] - Uold[k] );
+        nrm  += MAGMA_Z_ABS( U.val[k] ) * MAGMA_Z_ABS( U.val[k] );
+    }
+    return sqrt( diff / nrm );
+}
+
+
+// initial guess as in magma_zparilu_cpu: L = tril(A) with unit diagonal,
+// U = tril(A^T), and A in CSRCOO unless ACOO is NULL
+static void
+parilu_init( magma_z_matrix A, magma_z_matrix *ACOO, magma_z_matrix *L, magma_z_matrix *U,
+             magma_queue_t queue )
+{
+    magma_z_matrix AT={Magma_CSR};
+    if( ACOO != NULL ){
+        TESTING_CHECK( magma_zmconvert( A, ACOO, Magma_CSR, Magma_CSRCOO, queue ));
+    }
+    TESTING_CHECK( magma_zmatrix_tril( A, L, queue ));
+    for( magma_int_t k=0; k<L->num_rows; k++ ){
+        L->val[ L->row[k+1]-1 ] = MAGMA_Z_ONE;
+    }
+    TESTING_CHECK( magma_zmtranspose( A, &AT, queue ));
+    TESTING_CHECK( magma_zmatrix_tril( AT, U, queue ));
+    magma_zmfree( &AT, queue );
+}
+
+
+// reverses the order of the COO entries; a sequential sweep in row order
+// gives the exact ILU at once, in reverse order it needs many sweeps
+static void
+reverse_entries( magma_z_matrix *ACOO )
+{
+    for( magma_int_t k=0, l=ACOO->nnz-1; k<l; k++, l-- ){
+        magma_index_t ti = ACOO->rowidx[k];
+        magma_index_t tj = ACOO->col[k];
+        magmaDoubleComplex tv = ACOO->val[k];
+        ACOO->rowidx[k] = ACOO->rowidx[l];
+        ACOO->col[k] = ACOO->col[l];
+        ACOO->val[k] = ACOO->val[l];
+        ACOO->rowidx[l] = ti;
+        ACOO->col[l] = tj;
+        ACOO->val[l] = tv;
+    }
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the convergence monitor of the host ParILU sweeps: the reported
+      change of the factors, the sampled residual estimate, and the sweep
+      count at which the adaptive loop stops
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, ACOO={Magma_CSR}, L={Magma_CSR}, U={Magma_CSR};
+    magma_z_matrix L2={Magma_CSR}, U2={Magma_CSR};
+    double tol = 1000 * lapackf77_dlamch( "E" );
+    magma_int_t omp_threads = magma_get_omp_numthreads();
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        // the estimate with stride 1 is the exact residual, and sampling
+        // every 16th nonzero stays close to it
+        {
+            real_Double_t res1, res16;
+            parilu_init( A, &ACOO, &L, &U, queue );
+            double exact = exact_residual( ACOO, L, U );
+            TESTING_CHECK( magma_zparilu_sampledres( ACOO, L, U, 1,  &res1,  queue ));
+            TESTING_CHECK( magma_zparilu_sampledres( ACOO, L, U, 16, &res16, queue ));
+            bool okay = ( fabs( res1 - exact ) <= tol * exact
+                          && res16 >= 0.5 * exact && res16 <= 2.0 * exact );
+            status += ! okay;
+            printf( "%% residual of the initial guess %.4e, estimate stride 1 %.4e,"
+                    " stride 16 %.4e   %s\n", exact, res1, res16, (okay ? "ok" : "failed") );
+            magma_zmfree( &ACOO, queue );
+            magma_zmfree( &L, queue );
+            magma_zmfree( &U, queue );
+        }
+
+        // with one thread the sweeps are deterministic: the monitored sweep
+        // writes the same factors as the plain one, and reports exactly the
+        // change of the values; the entries are swept in reverse order
+        {
+            magma_set_omp_numthreads( 1 );
+            parilu_init( A, &ACOO, &L, &U, queue );
+            parilu_init( A, NULL, &L2, &U2, queue );
+            reverse_entries( &ACOO );
+            magmaDoubleComplex *Lold = NULL, *Uold = NULL;
+            TESTING_CHECK( magma_zmalloc_cpu( &Lold, L.nnz ));
+            TESTING_CHECK( magma_zmalloc_cpu( &Uold, U.nnz ));
+            double error = 0.0, first = 0.0, change = 0.0;
+            bool same = true;
+            magma_int_t sweeps = 0;
+            for( ; sweeps < 200; sweeps++ ){
+                memcpy( Lold, L.val, L.nnz * sizeof(magmaDoubleComplex) );
+                memcpy( Uold, U.val, U.nnz * sizeof(magmaDoubleComplex) );
+                TESTING_CHECK( magma_zparilu_sweep_monitor( ACOO, &L, &U, &change, queue ));
+                TESTING_CHECK( magma_zparilu_sweep( ACOO, &L2, &U2, queue ));
+                double actual = relative_change( L, Lold, U, Uold );
+                error = max( error, fabs( change - actual ) / max( actual, tol ));
+                first = ( sweeps == 0 ) ? change : first;
+                same = same && memcmp( L.val, L2.val, L.nnz * sizeof(magmaDoubleComplex) ) == 0
+                            && memcmp( U.val, U2.val, U.nnz * sizeof(magmaDoubleComplex) ) == 0;
+                if( change < tol ){
+                    break;
+                }
+            }
+            // a converged fixed point solves A = LU on the pattern of A
+            real_Double_t res0, res;
+            magma_z_matrix L0={Magma_CSR}, U0={Magma_CSR};
+            parilu_init( A, NULL, &L0, &U0, queue );
+            TESTING_CHECK( magma_zparilu_sampledres( ACOO, L0, U0, 1, &res0, queue ));
+            TESTING_CHECK( magma_zparilu_sampledres( ACOO, L,  U,  1, &res,  queue ));
+            bool okay = ( same && error < 1e-6 && change < tol && res < 1e-8 * res0 );
+            status += ! okay;
+            printf( "%% monitored sweeps: change %.2e after 1 sweep, %.2e after %lld sweeps,"
+                    " error of the reported change %.2e, residual %.2e -> %.2e   %s\n",
+                    first, change, (long long) sweeps+1, error, res0, res,
+                    (okay ? "ok" : "failed") );
+            magma_free_cpu( Lold );
+            magma_free_cpu( Uold );
+            magma_zmfree( &L0, queue );
+            magma_zmfree( &U0, queue );
+            magma_zmfree( &L2, queue );
+            magma_zmfree( &U2, queue );
+            magma_zmfree( &ACOO, queue );
+            magma_zmfree( &L, queue );
+            magma_zmfree( &U, queue );
+            magma_set_omp_numthreads( omp_threads );
+        }
+
+        // asynchronous sweeps with all threads, again in reverse order: the
+        // loop of magma_zparilu_cpu stops earlier for a looser tolerance, and
+        // the residual is smaller for a tighter one
+        {
+            double sweeptol[3] = { 1e-2, 1e-4, 1e-8 };
+            magma_int_t used[3];
+            real_Double_t res[3];
+            for( int t=0; t<3; t++ ){
+                double change = 1.0;
+                parilu_init( A, &ACOO, &L, &U, queue );
+                reverse_entries( &ACOO );
+                used[t] = 0;
+                while( used[t] < 200 && change >= sweeptol[t] ){
+                    TESTING_CHECK( magma_zparilu_sweep_monitor( ACOO, &L, &U, &change, queue ));
+                    used[t]++;
+                }
+                TESTING_CHECK( magma_zparilu_sampledres( ACOO, L, U, 1, &res[t], queue ));
+                bool okay = ( change < sweeptol[t]
+                              && ( t == 0 || ( used[t] >= used[t-1] && res[t] <= res[t-1] )));
+                status += ! okay;
+                printf( "%% sweep tolerance %.0e: %3lld sweeps, change %.2e, residual %.2e   %s\n",
+                        sweeptol[t], (long long) used[t], change, res[t], (okay ? "ok" : "failed") );
+                magma_zmfree( &ACOO, queue );
+                magma_zmfree( &L, queue );
+                magma_zmfree( &U, queue );
+            }
+        }
+
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
@@ -0,0 +1,283 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// exact ILU residual a_ij - sum_{k<min(i,j)} l_ik u_kj for the COO
+// candidates in R
+static void
+residuals( magma_z_matrix A, magma_z_matrix L, magma_z_matrix U,
+           magma_z_matrix *R, double *sum )
+{
+    *sum = 0.0;
+    for( magma_int_t e=0; e<R->nnz; e++ ){
+        magma_index_t row = R->rowidx[e], col = R->col[e];
+        magmaDoubleComplex s = MAGMA_Z_ZERO;
+        for( magma_int_t i=A.row[row]; i<A.row[row+1]; i++ ){
+            if( A.col[i] == col ){
+                s = A.val[i];
+            }
+        }
+        magma_int_t i = L.row[row], j = U.row[col];
+        while( i < L.row[row+1] && j < U.row[col+1] ){
+            if( L.col[i] == U.col[j] ){
+                s = s - L.val[i] * U.val[j];
+                i++;
+                j++;
+            } else if( L.col[i] < U.col[j] ){
+                i++;
+            } else {
+                j++;
+            }
+        }
+        R->val[e] = s;
+        *sum += MAGMA_Z_ABS( s );
+    }
+}
+
+
+// sorts the columns of every row of the candidate matrix R together with
+// the values; magma_zcsr_sort only permutes the column indices
+static void
+sort_rows( magma_z_matrix *R )
+{
+    for( magma_int_t i=0; i<R->num_rows; i++ ){
+        for( magma_int_t j=R->row[i]+1; j<R->row[i+1]; j++ ){
+            magma_index_t col = R->col[j];
+            magmaDoubleComplex val = R->val[j];
+            magma_int_t k = j;
+            for( ; k > R->row[i] && R->col[k-1] > col; k-- ){
+                R->col[k] = R->col[k-1];
+                R->val[k] = R->val[k-1];
+            }
+            R->col[k] = col;
+            R->val[k] = val;
+        }
+    }
+}
+
+
+// checks that A and B have the same pattern; returns the largest value
+// difference relative to the largest value of B, or -1 for a pattern mismatch
+static double
+compare( magma_z_matrix A, magma_z_matrix B )
+{
+    double diff = 0.0, nrm = 0.0;
+    if( A.num_rows != B.num_rows || A.nnz != B.nnz ){
+        return -1;
+    }
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        if( A.row[i+1] - A.row[i] != B.row[i+1] - B.row[i] ){
+            return -1;
+        }
+        for( magma_int_t k=0; k<A.row[i+1]-A.row[i]; k++ ){
+            magma_int_t a = A.row[i] + k, b = B.row[i] + k;
+            if( A.col[a] != B.col[b] ){
+                return -1;
+            }
+            diff = max( diff, MAGMA_Z_ABS( A.val[a] - B.val[b] ));
+            nrm = max( nrm, MAGMA_Z_ABS( B.val[b] ));
+        }
+    }
+    return diff / nrm;
+}
+
+
+// gets the factors in CSR; U is compared by rows to the transpose of the
+// reference, which holds U by columns
+static magma_int_t
+get_factors( magma_z_parilut_factors *F, magma_z_matrix *L, magma_z_matrix *U,
+             magma_z_matrix Ur, magma_z_matrix *UrT, magma_queue_t queue )
+{
+    magma_int_t info = 0;
+    magma_zmfree( UrT, queue );
+    info = magma_zparilut_inc_get( F, L, U, queue );
+    if( info == 0 ){
+        // the CPU transpose replaces the row indices of its input
+        Ur.rowidx = NULL;
+        info = magma_zmtranspose( Ur, UrT, queue );
+    }
+    return info;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the incremental CPU ParILUT factor update against the ParILUT
+      steps that rebuild the factors
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix hA={Magma_CSR}, hAT={Magma_CSR}, L0={Magma_CSR}, U0={Magma_CSR};
+    // incremental update, and its factors in CSR
+    magma_z_parilut_factors F;
+    magma_z_matrix L={Magma_CSR}, U={Magma_CSR};
+    // reference
+    magma_z_matrix Lr={Magma_CSR}, Ur={Magma_CSR}, URT={Magma_CSR}, UrT={Magma_CSR};
+    magma_z_matrix Lr_new={Magma_CSR}, Ur_new={Magma_CSR};
+    magma_z_matrix hL={Magma_CSR}, hU={Magma_CSR}, oneL={Magma_CSR}, oneU={Magma_CSR};
+    double eps = lapackf77_dlamch( "E" ), tol = 1000 * eps;
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    magma_z_preconditioner *precond = &zopts.precond_par;
+    magma_int_t sweeps = ( precond->sweeps > 0 ) ? precond->sweeps : 5;
+    double fill = ( precond->atol > 0 ) ? precond->atol : 2.0;
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &hA, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &hA,  argv[i], queue ));
+        }
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros, %lld steps, fill %.2f\n\n",
+                (long long) hA.num_rows, (long long) hA.num_cols, (long long) hA.nnz,
+                (long long) sweeps, fill );
+
+        TESTING_CHECK( magma_zmatrix_tril( hA, &L0, queue ));
+        TESTING_CHECK( magma_zmatrix_triu( hA, &U0, queue ));
+        TESTING_CHECK( magma_zmtranspose( hA, &hAT, queue ));
+        TESTING_CHECK( magma_zmatrix_tril( hA, &Lr, queue ));
+        TESTING_CHECK( magma_zmatrix_tril( hAT, &Ur, queue ));
+        TESTING_CHECK( magma_zparilut_inc_init( Lr, Ur, &F, queue ));
+        TESTING_CHECK( magma_zmatrix_addrowindex( &Lr, queue ));
+        TESTING_CHECK( magma_zmatrix_addrowindex( &Ur, queue ));
+        magma_int_t L0nnz = Lr.nnz, U0nnz = Ur.nnz;
+        magma_int_t repacked = 0;
+        oneL.memory_location = Magma_CPU;
+        oneU.memory_location = Magma_CPU;
+
+        printf( "%%step    L.nnz    U.nnz   add L    add U  sweep L  sweep U     rm L     rm U  sweep L  sweep U\n" );
+        for( magma_int_t iters=0; iters<sweeps; iters++ ){
+            double err[8], sum, sumL, sumU, thrsL = 0.0, thrsU = 0.0;
+            magma_index_t *Lcol = F.L.col, *Ucol = F.U.col, *UTcol = F.UT.col;
+
+            // add the candidates
+            TESTING_CHECK( magma_zparilut_inc_add( &hA, &L0, &U0, &F, &sum, queue ));
+            magma_zmfree( &URT, queue );
+            TESTING_CHECK( magma_zcsrcoo_transpose( Ur, &URT, queue ));
+            TESTING_CHECK( magma_zparilut_candidates( L0, U0, Lr, URT, &hL, &hU, queue ));
+            residuals( hA, Lr, Ur, &hL, &sumL );
+            residuals( hA, Lr, Ur, &hU, &sumU );
+            TESTING_CHECK( magma_zmatrix_swap( &hL, &oneL, queue ));
+            magma_zmfree( &hL, queue );
+            sort_rows( &oneL );
+            sort_rows( &hU );
+            TESTING_CHECK( magma_zcsrcoo_transpose( hU, &oneU, queue ));
+            TESTING_CHECK( magma_zmatrix_cup( Lr, oneL, &Lr_new, queue ));
+            TESTING_CHECK( magma_zmatrix_cup( Ur, oneU, &Ur_new, queue ));
+            magma_zmfree( &oneL, queue );
+            magma_zmfree( &oneU, queue );
+            magma_zmfree( &hU, queue );
+            TESTING_CHECK( get_factors( &F, &L, &U, Ur_new, &UrT, queue ));
+            err[0] = compare( L, Lr_new );
+            err[1] = compare( U, UrT );
+            // summed in another order
+            if( fabs( sum - (sumL + sumU) ) > hA.nnz * eps * (sumL + sumU) ){
+                err[0] = -1;
+            }
+            // entries are added in the slack unless a row overflows
+            repacked += ( F.L.col != Lcol ) + ( F.U.col != Ucol ) + ( F.UT.col != UTcol );
+
+            // sweep
+            TESTING_CHECK( magma_zparilut_inc_sweep( &hA, &F, queue ));
+            TESTING_CHECK( magma_zparilut_sweep_sync( &hA, &Lr_new, &Ur_new, queue ));
+            TESTING_CHECK( get_factors( &F, &L, &U, Ur_new, &UrT, queue ));
+            err[2] = compare( L, Lr_new );
+            err[3] = compare( U, UrT );
+
+            // remove the smallest elements, both with the same thresholds
+            magma_int_t num_rmL = max( (magma_int_t) (F.L.nnz - L0nnz*(1+(fill-1.)*(iters+1)/sweeps)), 0 );
+            magma_int_t num_rmU = max( (magma_int_t) (F.U.nnz - U0nnz*(1+(fill-1.)*(iters+1)/sweeps)), 0 );
+            TESTING_CHECK( magma_zparilut_inc_thrs( num_rmL, num_rmU, &F, &thrsL, &thrsU, queue ));
+            Lcol = F.L.col;
+            Ucol = F.U.col;
+            UTcol = F.UT.col;
+            magma_int_t nnzL = F.L.nnz, nnzU = F.U.nnz;
+            TESTING_CHECK( magma_zparilut_inc_rm( thrsL, thrsU, &F, queue ));
+            TESTING_CHECK( magma_zparilut_thrsrm( 1, &Lr_new, &thrsL, queue ));
+            TESTING_CHECK( magma_zparilut_thrsrm( 1, &Ur_new, &thrsU, queue ));
+            TESTING_CHECK( magma_zmatrix_swap( &Lr_new, &Lr, queue ));
+            TESTING_CHECK( magma_zmatrix_swap( &Ur_new, &Ur, queue ));
+            magma_zmfree( &Lr_new, queue );
+            magma_zmfree( &Ur_new, queue );
+            TESTING_CHECK( get_factors( &F, &L, &U, Ur, &UrT, queue ));
+            err[4] = compare( L, Lr );
+            err[5] = compare( U, UrT );
+            // the removal never moves a factor
+            if( F.L.col != Lcol || F.U.col != Ucol || F.UT.col != UTcol ){
+                err[4] = -1;
+            }
+            // the rank of the approximate thresholds is accurate up to
+            // num_rm/100; ties below the threshold are removed as well
+            if( nnzL - F.L.nnz < num_rmL - num_rmL/100 ){
+                err[4] = -1;
+            }
+            if( nnzU - F.U.nnz < num_rmU - num_rmU/100 ){
+                err[5] = -1;
+            }
+
+            // sweep
+            TESTING_CHECK( magma_zparilut_inc_sweep( &hA, &F, queue ));
+            TESTING_CHECK( magma_zparilut_sweep_sync( &hA, &Lr, &Ur, queue ));
+            TESTING_CHECK( get_factors( &F, &L, &U, Ur, &UrT, queue ));
+            err[6] = compare( L, Lr );
+            err[7] = compare( U, UrT );
+
+            bool okay = true;
+            printf( "%5lld %8lld %8lld", (long long) iters, (long long) F.L.nnz, (long long) F.U.nnz );
+            for( int k=0; k<8; k++ ){
+                okay = okay && err[k] >= 0 && err[k] < tol;
+                printf( " %8.1e", err[k] );
+            }
+            status += ! okay;
+            printf( "   %s\n", (okay ? "ok" : "failed") );
+        }
+        printf( "%% factors repacked %lld times in %lld steps\n",
+                (long long) repacked, (long long) sweeps );
+
+        magma_zmfree( &hA, queue );
+        magma_zmfree( &hAT, queue );
+        magma_zmfree( &L0, queue );
+        magma_zmfree( &U0, queue );
+        magma_zparilut_inc_free( &F, queue );
+        magma_zmfree( &L, queue );
+        magma_zmfree( &U, queue );
+        magma_zmfree( &Lr, queue );
+        magma_zmfree( &Ur, queue );
+        magma_zmfree( &URT, queue );
+        magma_zmfree( &UrT, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
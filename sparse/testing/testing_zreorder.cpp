@@ -0,0 +1,255 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// true if perm contains every index 0..n-1 exactly once
+static bool
+valid_permutation( magma_int_t n, const magma_index_t *perm )
+{
+    if( perm == NULL ){
+        return false;
+    }
+    char *seen = (char*) calloc( n, 1 );
+    bool okay = true;
+    for( magma_int_t i=0; i<n && okay; i++ ){
+        okay = perm[i] >= 0 && perm[i] < n && ! seen[ perm[i] ];
+        if( okay ){
+            seen[ perm[i] ] = 1;
+        }
+    }
+    free( seen );
+    return okay;
+}
+
+
+// max |i - j| over the nonzeros A( i, j )
+static magma_int_t
+bandwidth( magma_z_matrix A )
+{
+    magma_int_t bw = 0;
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            bw = max( bw, (magma_int_t) labs( (long) A.col[j] - (long) i ));
+        }
+    }
+    return bw;
+}
+
+
+// y = A x on the host
+static void
+spmv( magma_z_matrix A, const magmaDoubleComplex *x, magmaDoubleComplex *y )
+{
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magmaDoubleComplex s = MAGMA_Z_ZERO;
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            s = s + A.val[j] * x[ A.col[j] ];
+        }
+        y[i] = s;
+    }
+}
+
+
+// true if A and B have the same rows, column indices, and values
+static bool
+same_matrix( magma_z_matrix A, magma_z_matrix B )
+{
+    if( A.num_rows != B.num_rows || A.nnz != B.nnz ){
+        return false;
+    }
+    for( magma_int_t i=0; i<=A.num_rows; i++ ){
+        if( A.row[i] != B.row[i] ){
+            return false;
+        }
+    }
+    for( magma_int_t j=0; j<A.nnz; j++ ){
+        if( A.col[j] != B.col[j] || ! ( A.val[j] == B.val[j] )){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the reorderings: valid permutations, RCM bandwidth reduction,
+      multicolor independent sets, and permute/unpermute round trips
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, S={Magma_CSR}, B={Magma_CSR}, x={Magma_CSR};
+    magma_index_t *scramble = NULL, *perm = NULL, *iperm = NULL, *color_ptr = NULL;
+    double tol = 100 * lapackf77_dlamch( "E" );
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        magma_int_t n = A.num_rows;
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros, bandwidth %lld\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz,
+                (long long) bandwidth( A ) );
+
+        // S = A in a random order, with a large bandwidth
+        TESTING_CHECK( magma_index_malloc_cpu( &scramble, n ));
+        TESTING_CHECK( magma_index_malloc_cpu( &iperm, n ));
+        for( magma_int_t k=0; k<n; k++ ){
+            scramble[k] = k;
+        }
+        srand( 2023 );
+        for( magma_int_t k=n-1; k>0; k-- ){
+            magma_int_t r = rand() % (k+1);
+            magma_index_t t = scramble[k];
+            scramble[k] = scramble[r];
+            scramble[r] = t;
+        }
+        TESTING_CHECK( magma_zmtransfer( A, &S, Magma_CPU, Magma_CPU, queue ));
+        TESTING_CHECK( magma_zmpermute( scramble, &S, queue ));
+        magma_int_t bw_scrambled = bandwidth( S );
+
+        // every reordering gives a permutation, and B = P S P^T
+        // satisfies P (S x) = B (P x)
+        magma_reorder_t reordering[3] = { Magma_RCM, Magma_AMD, Magma_MULTICOLOR };
+        const char *name[3] = { "RCM", "AMD", "multicolor" };
+        magmaDoubleComplex *y = NULL, *z = NULL;
+        TESTING_CHECK( magma_zmalloc_cpu( &y, n ));
+        TESTING_CHECK( magma_zmalloc_cpu( &z, n ));
+        for( int r=0; r<3; r++ ){
+            TESTING_CHECK( magma_zmtransfer( S, &B, Magma_CPU, Magma_CPU, queue ));
+            TESTING_CHECK( magma_zmreorder( &B, reordering[r], &perm, queue ));
+            bool okay = valid_permutation( n, perm ) && B.nnz == S.nnz;
+
+            TESTING_CHECK( magma_zvinit( &x, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+            for( magma_int_t k=0; k<n; k++ ){
+                x.val[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 7), (double) (k % 3) );
+            }
+            spmv( S, x.val, y );
+            TESTING_CHECK( magma_zvpermute( perm, &x, queue ));
+            spmv( B, x.val, z );
+            double error = 0.0, scale = 0.0;
+            for( magma_int_t k=0; k<n; k++ ){
+                error = max( error, MAGMA_Z_ABS( y[ perm[k] ] - z[k] ));
+                scale = max( scale, MAGMA_Z_ABS( y[k] ));
+            }
+            error /= scale;
+            // round trip: unpermuting x gives the original vector
+            TESTING_CHECK( magma_zvunpermute( perm, &x, queue ));
+            for( magma_int_t k=0; k<n; k++ ){
+                okay = okay && ( x.val[k] == MAGMA_Z_MAKE( 1.0 + (double) (k % 7), (double) (k % 3) ));
+            }
+            okay = okay && error < tol;
+
+            magma_int_t bw = bandwidth( B );
+            if( reordering[r] == Magma_RCM ){
+                okay = okay && bw < bw_scrambled;
+            }
+            status += ! okay;
+            printf( "%% %-10s valid permutation, P (S x) = (P S P^T)(P x) to %.2e, "
+                    "bandwidth %lld (scrambled %lld)   %s\n",
+                    name[r], error, (long long) bw, (long long) bw_scrambled,
+                    (okay ? "ok" : "failed") );
+            magma_free_cpu( perm );
+            perm = NULL;
+            magma_zmfree( &B, queue );
+            magma_zmfree( &x, queue );
+        }
+        magma_free_cpu( y );
+        magma_free_cpu( z );
+
+        // multicolor: no edge between two nodes of the same color
+        {
+            magma_int_t num_colors = 0;
+            TESTING_CHECK( magma_zmreorder_multicolor( S, &num_colors, &color_ptr, &perm, queue ));
+            bool okay = valid_permutation( n, perm ) && color_ptr[0] == 0
+                        && color_ptr[ num_colors ] == n;
+            magma_index_t *color = NULL;
+            TESTING_CHECK( magma_index_malloc_cpu( &color, n ));
+            for( magma_int_t c=0; c<num_colors && okay; c++ ){
+                okay = color_ptr[c] < color_ptr[c+1];
+                for( magma_int_t k=color_ptr[c]; k<color_ptr[c+1]; k++ ){
+                    color[ perm[k] ] = c;
+                }
+            }
+            magma_int_t conflicts = 0;
+            for( magma_int_t r=0; r<n && okay; r++ ){
+                for( magma_int_t j=S.row[r]; j<S.row[r+1]; j++ ){
+                    conflicts += ( S.col[j] != r && color[ S.col[j] ] == color[r] );
+                }
+            }
+            okay = okay && conflicts == 0;
+            status += ! okay;
+            printf( "%% multicolor: %lld colors, %lld conflicts   %s\n",
+                    (long long) num_colors, (long long) conflicts, (okay ? "ok" : "failed") );
+            magma_free_cpu( color );
+            magma_free_cpu( color_ptr );
+            magma_free_cpu( perm );
+            color_ptr = NULL;
+            perm = NULL;
+        }
+
+        // round trip: permuting S with the inverse of scramble restores A;
+        // arrays passed with magma_zcsrset are overwritten, not freed
+        {
+            for( magma_int_t k=0; k<n; k++ ){
+                iperm[ scramble[k] ] = k;
+            }
+            TESTING_CHECK( magma_zmtransfer( S, &B, Magma_CPU, Magma_CPU, queue ));
+            magma_z_matrix C={Magma_CSR};
+            TESTING_CHECK( magma_zcsrset( n, n, B.row, B.col, B.val, &C, queue ));
+            TESTING_CHECK( magma_zmpermute( iperm, &C, queue ));
+            bool okay = C.row == B.row && C.col == B.col && C.val == B.val
+                        && same_matrix( B, A );
+            status += ! okay;
+            printf( "%% permute/unpermute round trip, caller's arrays:   %s\n",
+                    (okay ? "ok" : "failed") );
+            magma_zmfree( &C, queue );   // does not free B's arrays
+            magma_zmfree( &B, queue );
+        }
+
+        magma_free_cpu( scramble );
+        magma_free_cpu( iperm );
+        scramble = NULL;
+        iperm = NULL;
+        magma_zmfree( &S, queue );
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
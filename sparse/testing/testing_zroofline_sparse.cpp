@@ -0,0 +1,274 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+
+       Roofline of the sparse host kernels: SpMV for each host storage of
+       CSR, the ParILU sweep, CSR transpose, and sort / select of values.
+       Dense host kernels are in testing/testing_zroofline.cpp.
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <string>  // before testings.h, which defines max, min
+#include <vector>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+#include "../../control/magma_threadsetting.h"  // internal header
+
+#define COMPLEX
+
+// real flops per multiply-add
+#ifdef COMPLEX
+const double fma_flops = 8;
+#else
+const double fma_flops = 2;
+#endif
+
+const double elem_bytes  = sizeof(magmaDoubleComplex);
+const double index_bytes = sizeof(magma_index_t);
+const double components  = elem_bytes / sizeof(double);  // 2 if complex
+
+// rows per block of the 16-bit column offsets, LOWPREC_ROWS in
+// magma_zmlowprec_cpu.cpp
+const magma_int_t lowprec_rows = 32;
+
+
+/******************************************************************************/
+// bytes of a CSR matrix: values, column indices, and row pointers
+static double csr_bytes( const magma_z_matrix& A, double val_bytes )
+{
+    return A.nnz * (val_bytes + index_bytes) + (A.num_rows + 1) * index_bytes;
+}
+
+
+/******************************************************************************/
+// bytes of the reduced-precision copy of A read by magma_zspmv_lowprec_cpu:
+// values, 16-bit offsets in blocks with a column base, else 32-bit indices
+static double lowprec_bytes( const magma_z_matrix& A, double val_bytes )
+{
+    double bytes = (A.num_rows + 1) * index_bytes;
+    magma_int_t num_blocks = magma_ceildiv( A.num_rows, lowprec_rows );
+    for( magma_int_t b = 0; b < num_blocks; ++b ) {
+        magma_int_t nnz_b = A.row[ min( (b+1)*lowprec_rows, A.num_rows ) ]
+                          - A.row[ b*lowprec_rows ];
+        bytes += nnz_b * (val_bytes + (A.col_base[b] >= 0 ? 2 : index_bytes)) + index_bytes;
+    }
+    return bytes;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing roofline of sparse host kernels.
+      Matrices are given as LAPLACE2D n, LAPLACE3D n, or Matrix Market files;
+      the default is LAPLACE2D 100, 300, 1000 and LAPLACE3D 60.
+      Kernels are timed with 1, 2, 4, ... threads, up to $OMP_NUM_THREADS.
+*/
+int main(  int argc, char** argv )
+{
+    magma_int_t info = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magmaDoubleComplex one  = MAGMA_Z_ONE;
+    magmaDoubleComplex zero = MAGMA_Z_ZERO;
+    magma_int_t ione = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+
+    // rates are the median of several runs, with data left in cache
+    // from the previous run, as in the solvers
+    magma_opts opts;
+    opts.bench = true;
+    opts.flush = 0;
+
+    // generate or read the matrices
+    std::vector< magma_z_matrix > matrices;
+    const char* default_argv[] = { "", "LAPLACE2D", "100", "LAPLACE2D", "300",
+                                   "LAPLACE2D", "1000", "LAPLACE3D", "60" };
+    if ( argc < 2 ) {
+        argc = sizeof(default_argv) / sizeof(default_argv[0]);
+        argv = (char**) default_argv;
+    }
+    for( int i = 1; i < argc; ++i ) {
+        magma_z_matrix A={Magma_CSR};
+        std::string name = argv[i];
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            TESTING_CHECK( magma_zm_5stencil( atoi( argv[i] ), &A, queue ));
+            name += std::string( " " ) + argv[i];
+        }
+        else if ( strcmp("LAPLACE3D", argv[i]) == 0 && i+1 < argc ) {
+            i++;
+            TESTING_CHECK( magma_zm_27stencil( atoi( argv[i] ), &A, queue ));
+            name += std::string( " " ) + argv[i];
+        }
+        else {
+            TESTING_CHECK( magma_z_csr_mtx( &A, argv[i], queue ));
+        }
+        printf( "%% matrix %lld: %s, %lld-by-%lld with %lld nonzeros\n",
+                (long long) matrices.size(), name.c_str(),
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+        matrices.push_back( A );
+    }
+
+    magma_int_t omp_threads = magma_get_omp_numthreads();
+    std::vector< magma_int_t > thread_counts = magma_thread_counts( omp_threads );
+    char size[ 64 ];
+
+    for( size_t ip = 0; ip < thread_counts.size(); ++ip ) {
+        magma_int_t p = thread_counts[ip];
+        magma_roofline_peak peak = magma_roofline_measure( p );
+        printf( "\n%% %lld threads: STREAM triad %.2f GB/s, dgemm %.2f Gflop/s\n",
+                (long long) p, peak.stream, peak.gemm );
+        magma_roofline_header();
+        magma_set_omp_numthreads( p );
+
+        for( size_t im = 0; im < matrices.size(); ++im ) {
+            magma_z_matrix& A = matrices[im];
+            magma_z_matrix x={Magma_CSR}, y={Magma_CSR};
+            magma_z_matrix ACOO={Magma_CSR}, AT={Magma_CSR}, L={Magma_CSR}, U={Magma_CSR};
+            magma_bench_stats stats;
+            double gflop, gbyte;
+            snprintf( size, sizeof(size), "matrix %lld", (long long) im );
+
+            // =================================================================
+            // SpMV, y = A x: CSR with 32-bit indices (reference loop, as in
+            // testing_zcspmv_mixed), then each reduced-precision storage
+            TESTING_CHECK( magma_zvinit( &x, Magma_CPU, A.num_cols, 1, one,  queue ));
+            TESTING_CHECK( magma_zvinit( &y, Magma_CPU, A.num_rows, 1, zero, queue ));
+            double vec_bytes = (A.num_cols + A.num_rows) * elem_bytes;
+            gflop = fma_flops * A.nnz / 1e9;
+
+            stats = magma_bench( opts, NULL, [&]{},
+                [&]{
+                    #pragma omp parallel for
+                    for (magma_int_t k=0; k<A.num_rows; k++) {
+                        magmaDoubleComplex s = zero;
+                        for (magma_int_t j=A.row[k]; j<A.row[k+1]; j++) {
+                            s = s + A.val[j] * x.val[ A.col[j] ];
+                        }
+                        y.val[k] = s;
+                    }
+                });
+            magma_roofline_print( "spmv csr (loop)", size, peak, stats.median,
+                                  gflop, (csr_bytes( A, elem_bytes ) + vec_bytes) / 1e9 );
+
+            magma_precision storage[3] = { Magma_DCOMPLEX, Magma_FLOAT, Magma_BFLOAT16 };
+            const char *storage_name[3] = { "spmv lowprec (working)", "spmv lowprec (single)",
+                                            "spmv lowprec (bf16)" };
+            double storage_bytes[3] = { elem_bytes, 4*components, 2*components };
+            for( int s = 0; s < 3; ++s ) {
+                TESTING_CHECK( magma_zmlowprec_cpu( storage[s], &A, queue ));
+                stats = magma_bench( opts, NULL, [&]{},
+                    [&]{
+                        TESTING_CHECK( magma_zspmv_lowprec_cpu( one, A, x, zero, y, queue ));
+                    });
+                magma_roofline_print( storage_name[s], size, peak, stats.median,
+                                      gflop, (lowprec_bytes( A, storage_bytes[s] ) + vec_bytes) / 1e9 );
+            }
+            TESTING_CHECK( magma_zmlowprec_free( &A, queue ));
+            magma_zmfree( &x, queue );
+            magma_zmfree( &y, queue );
+
+            // =================================================================
+            // CSR transpose: reads and writes the matrix
+            stats = magma_bench( opts, NULL,
+                [&]{ magma_zmfree( &AT, queue ); },
+                [&]{ TESTING_CHECK( magma_zmtranspose_cpu( A, &AT, queue )); });
+            magma_roofline_print( "csr transpose", size, peak, stats.median,
+                                  0, 2*csr_bytes( A, elem_bytes ) / 1e9 );
+            magma_zmfree( &AT, queue );
+
+            // =================================================================
+            // ParILU sweep, set up as in magma_zparilu_cpu.
+            // Flops are counted by a pass over the same merge as the sweep;
+            // bytes are A in COO, L and U in CSR, and the updated values.
+            TESTING_CHECK( magma_zmconvert( A, &ACOO, Magma_CSR, Magma_CSRCOO, queue ));
+            TESTING_CHECK( magma_zmatrix_tril( A, &L, queue ));
+            for (magma_int_t k=0; k < L.num_rows; k++) {
+                L.val[L.row[k+1]-1] = MAGMA_Z_ONE;
+            }
+            TESTING_CHECK( magma_zmtranspose( A, &AT, queue ));
+            TESTING_CHECK( magma_zmatrix_tril( AT, &U, queue ));
+            magma_zmfree( &AT, queue );
+
+            double fmas = 0;
+            for (magma_int_t k=0; k < ACOO.nnz; k++) {
+                magma_index_t il = L.row[ ACOO.rowidx[k] ], il_end = L.row[ ACOO.rowidx[k]+1 ];
+                magma_index_t iu = U.row[ ACOO.col[k]    ], iu_end = U.row[ ACOO.col[k]+1    ];
+                while (il < il_end && iu < iu_end) {
+                    magma_index_t jl = L.col[il], ju = U.col[iu];
+                    fmas += (jl == ju);
+                    il += (jl <= ju);
+                    iu += (jl >= ju);
+                }
+            }
+            gflop = fma_flops * (fmas + ACOO.nnz) / 1e9;
+            gbyte = (ACOO.nnz * (elem_bytes + 2*index_bytes)
+                     + csr_bytes( L, elem_bytes ) + csr_bytes( U, elem_bytes )
+                     + ACOO.nnz * elem_bytes) / 1e9;
+            stats = magma_bench( opts, NULL, [&]{},
+                [&]{ TESTING_CHECK( magma_zparilu_sweep( ACOO, &L, &U, queue )); });
+            magma_roofline_print( "parilu sweep", size, peak, stats.median, gflop, gbyte );
+            magma_zmfree( &ACOO, queue );
+            magma_zmfree( &L, queue );
+            magma_zmfree( &U, queue );
+
+            // =================================================================
+            // sort and select of nnz random values, as for ParILUT thresholds;
+            // sort and select read and write the array, sample select reads it
+            magma_int_t n = A.nnz;
+            magmaDoubleComplex *val, *work;
+            TESTING_CHECK( magma_zmalloc_cpu( &val,  n ));
+            TESTING_CHECK( magma_zmalloc_cpu( &work, n ));
+            lapackf77_zlarnv( &ione, ISEED, &n, val );
+            gbyte = 2 * n * elem_bytes / 1e9;
+
+            stats = magma_bench( opts, NULL,
+                [&]{ memcpy( work, val, n*sizeof(magmaDoubleComplex) ); },
+                [&]{ TESTING_CHECK( magma_zsort( work, 0, n-1, queue )); });
+            magma_roofline_print( "sort", size, peak, stats.median, 0, gbyte );
+
+            stats = magma_bench( opts, NULL,
+                [&]{ memcpy( work, val, n*sizeof(magmaDoubleComplex) ); },
+                [&]{ TESTING_CHECK( magma_zselect( work, n, n/2, queue )); });
+            magma_roofline_print( "select", size, peak, stats.median, 0, gbyte );
+
+            double thrs;
+            stats = magma_bench( opts, NULL, [&]{},
+                [&]{
+                    TESTING_CHECK( magma_zsampleselect_cpu( n, val, n/2, 0, 1,
+                                                            &thrs, NULL, queue ));
+                });
+            magma_roofline_print( "sampleselect", size, peak, stats.median, 0, gbyte/2 );
+
+            magma_free_cpu( val );
+            magma_free_cpu( work );
+            fflush( stdout );
+        }
+    }
+    magma_set_omp_numthreads( omp_threads );
+
+    for( size_t im = 0; im < matrices.size(); ++im ) {
+        magma_zmfree( &matrices[im], queue );
+    }
+    magma_queue_destroy( queue );
+    TESTING_CHECK( magma_finalize() );
+    return info;
+}
@@ -0,0 +1,237 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// r = b - A x on the host, returns |r| / |b|
+static double
+residual( magma_z_matrix A, const magmaDoubleComplex *b,
+          const magmaDoubleComplex *x, magmaDoubleComplex *r )
+{
+    double rnrm = 0.0, bnrm = 0.0;
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        magmaDoubleComplex s = b[i];
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            s = s - A.val[j] * x[ A.col[j] ];
+        }
+        r[i] = s;
+        rnrm += MAGMA_Z_ABS( s ) * MAGMA_Z_ABS( s );
+        bnrm += MAGMA_Z_ABS( b[i] ) * MAGMA_Z_ABS( b[i] );
+    }
+    return sqrt( rnrm / bnrm );
+}
+
+
+// preconditioned Richardson iteration x += M^{-1} (b - A x) from x = 0;
+// returns the number of iterations to reach rtol, or maxiter+1
+static magma_int_t
+richardson( magma_z_matrix A, magma_z_matrix b, bool schwarz,
+            magma_z_preconditioner *precond, double rtol, magma_int_t maxiter,
+            magma_queue_t queue )
+{
+    magma_z_matrix x={Magma_CSR}, r={Magma_CSR}, c={Magma_CSR};
+    magma_int_t n = A.num_rows, iter;
+    TESTING_CHECK( magma_zvinit( &x, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+    TESTING_CHECK( magma_zvinit( &r, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+    TESTING_CHECK( magma_zvinit( &c, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+    for( iter=0; iter <= maxiter; iter++ ){
+        double res = residual( A, b.val, x.val, r.val );
+        if( res < rtol || isnan( res ) ){
+            break;
+        }
+        if( schwarz ){
+            TESTING_CHECK( magma_zapplyschwarz_cpu( r, &c, precond, queue ));
+        } else {
+            TESTING_CHECK( magma_zapplybjacobi_cpu( MagmaNoTrans, r, &c, precond, queue ));
+        }
+        for( magma_int_t i=0; i<n; i++ ){
+            x.val[i] = x.val[i] + c.val[i];
+        }
+    }
+    magma_zmfree( &x, queue );
+    magma_zmfree( &r, queue );
+    magma_zmfree( &c, queue );
+    return iter;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the host restricted additive Schwarz preconditioner against
+      block-Jacobi
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, Z={Magma_CSR}, b={Magma_CSR}, x={Magma_CSR};
+    double rtol = 1e-6, tol = 100 * lapackf77_dlamch( "E" );
+    magma_int_t maxiter = 2000;
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+    TESTING_CHECK( magma_zsolverinfo_init( &zopts.solver_par, &zopts.precond_par, queue ));
+    magma_z_preconditioner *precond = &zopts.precond_par;
+    magma_int_t domains = ( precond->subdomains > 0 ) ? precond->subdomains : 4;
+    magma_int_t dense_max = precond->bsize;
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        magma_int_t n = A.num_rows;
+
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros, %lld subdomains\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz,
+                (long long) domains );
+
+        TESTING_CHECK( magma_zvinit( &b, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        TESTING_CHECK( magma_zvinit( &x, Magma_CPU, n, 1, MAGMA_Z_ZERO, queue ));
+        for( magma_int_t k=0; k<n; k++ ){
+            b.val[k] = MAGMA_Z_MAKE( 1.0 + (double) (k % 13) / 13.0, 0.0 );
+        }
+
+        // block-Jacobi reference
+        precond->bsize = 0;
+        TESTING_CHECK( magma_zbjacobisetup_cpu( A, precond, queue ));
+        magma_int_t iter_bj = richardson( A, b, false, precond, rtol, maxiter, queue );
+        printf( "%% block-Jacobi (%lld blocks): %lld iterations\n",
+                (long long) precond->num_blocks, (long long) iter_bj );
+
+        precond->bsize = dense_max;
+        precond->subdomains = domains;
+        magma_reorder_t partition[2] = { Magma_NOREORDER, Magma_RCM };
+        const char *partition_name[2] = { "contiguous", "RCM" };
+        for( int p=0; p<2; p++ ){
+            magma_int_t iter[2];
+            precond->partition = partition[p];
+            for( magma_int_t overlap=0; overlap<2; overlap++ ){
+                precond->overlap = overlap;
+                TESTING_CHECK( magma_zschwarzsetup_cpu( A, precond, queue ));
+                TESTING_CHECK( magma_zapplyschwarz_cpu( b, &x, precond, queue ));
+
+                // without overlap the subdomains are disjoint and RAS is
+                // block-Jacobi with the subdomains as blocks: with dense LU
+                // subdomain solves x solves the block diagonal system exactly
+                double error = 0.0;
+                if( overlap == 0 ){
+                    for( magma_int_t d=0; d<precond->schwarz_num_domains; d++ ){
+                        magma_z_schwarz_domain *dom = precond->schwarz_domains + d;
+                        for( magma_int_t k=0; k<dom->n && dom->lu != NULL; k++ ){
+                            magma_index_t g = dom->idx[k];
+                            magmaDoubleComplex s = b.val[g];
+                            double scale = MAGMA_Z_ABS( b.val[g] );
+                            for( magma_int_t j=A.row[g]; j<A.row[g+1]; j++ ){
+                                magma_index_t c = A.col[j];
+                                magma_int_t lo = 0, hi = dom->n;  // idx is ascending
+                                while( lo < hi ){
+                                    magma_int_t mid = (lo + hi) / 2;
+                                    if( dom->idx[mid] < c ) lo = mid+1; else hi = mid;
+                                }
+                                if( lo < dom->n && dom->idx[lo] == c ){
+                                    s = s - A.val[j] * x.val[c];
+                                    scale += MAGMA_Z_ABS( A.val[j] ) * MAGMA_Z_ABS( x.val[c] );
+                                }
+                            }
+                            error = max( error, MAGMA_Z_ABS( s ) / scale );
+                        }
+                    }
+                }
+                iter[overlap] = richardson( A, b, true, precond, rtol, maxiter, queue );
+                bool okay = ( error < tol && iter[overlap] <= maxiter );
+                if( overlap == 0 ){
+                    okay = okay && ( iter[0] <= iter_bj );
+                } else {
+                    okay = okay && ( iter[1] <= iter[0] );
+                }
+                status += ! okay;
+                printf( "%% RAS %-10s overlap %lld: block error %.2e, %lld iterations   %s\n",
+                        partition_name[p], (long long) overlap, error,
+                        (long long) iter[overlap], (okay ? "ok" : "failed") );
+            }
+        }
+
+        // a row without a stored diagonal entry: the subdomain ILU(0) gets
+        // an explicit zero diagonal, replaced by one as a zero pivot
+        TESTING_CHECK( magma_zmtransfer( A, &Z, Magma_CPU, Magma_CPU, queue ));
+        {
+            magma_index_t r = n / 2, k = Z.row[r];
+            for( magma_int_t j=Z.row[r]; j<Z.row[r+1]; j++ ){
+                if( Z.col[j] != r ){
+                    Z.col[k] = Z.col[j];
+                    Z.val[k] = Z.val[j];
+                    k++;
+                }
+            }
+            for( magma_int_t j=Z.row[r+1]; j<Z.nnz; j++ ){
+                Z.col[ j-1 ] = Z.col[j];
+                Z.val[ j-1 ] = Z.val[j];
+            }
+            for( magma_int_t j=r+1; j<=n; j++ ){
+                Z.row[j]--;
+            }
+            Z.nnz--;
+        }
+        precond->partition = Magma_NOREORDER;
+        precond->overlap = 1;
+        precond->bsize = 1;    // ILU(0) for every subdomain
+        TESTING_CHECK( magma_zschwarzsetup_cpu( Z, precond, queue ));
+        TESTING_CHECK( magma_zapplyschwarz_cpu( b, &x, precond, queue ));
+        {
+            bool okay = true;
+            for( magma_int_t k=0; k<n; k++ ){
+                okay = okay && ! isnan( MAGMA_Z_ABS( x.val[k] )) && ! isinf( MAGMA_Z_ABS( x.val[k] ));
+            }
+            // every local row has its diagonal entry at diag[i]
+            for( magma_int_t d=0; d<precond->schwarz_num_domains; d++ ){
+                magma_z_schwarz_domain *dom = precond->schwarz_domains + d;
+                for( magma_int_t k=0; k<dom->n && dom->diag != NULL; k++ ){
+                    okay = okay && dom->A.col[ dom->diag[k] ] == k;
+                }
+            }
+            status += ! okay;
+            printf( "%% RAS with a missing diagonal entry, ILU(0) subdomains:   %s\n",
+                    (okay ? "ok" : "failed") );
+        }
+        precond->bsize = dense_max;
+
+        TESTING_CHECK( magma_zschwarzfree_cpu( precond, queue ));
+        magma_zmfree( &Z, queue );
+        magma_zmfree( &A, queue );
+        magma_zmfree( &b, queue );
+        magma_zmfree( &x, queue );
+        i++;
+    }
+
+    magma_zprecondfree( &zopts.precond_par, queue );
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
@@ -20,6 +20,7 @@
 #include "magmasparse.h"
 #include "magma_operators.h"
 #include "testings.h"
+#include "../../control/magma_threadsetting.h"  // internal header
 
 
 const int SEED = 352302;
@@ -32,7 +33,8 @@ void makeRandomArray(magmaDoubleComplex* a, int size) {
 }
 
 /* ////////////////////////////////////////////////////////////////////////////
-   -- testing for the magma_zselect magma_zselectrandom magma_zselectsort functions
+   -- testing for the magma_zselect magma_zselectrandom magma_zselectsort
+      magma_zsampleselect_cpu functions
 */
 int main(  int argc, char** argv )
 {
@@ -43,7 +45,13 @@ int main(  int argc, char** argv )
     magma_queue_t queue=NULL;
     magma_queue_create( 0, &queue );
     // using std::swap;
-    real_Double_t start, end, t_select, t_selectrandom, t_selectbitonic;
+    real_Double_t t_select, t_selectrandom, t_selectbitonic, t_sampleselect;
+    magma_bench_stats s_select, s_selectrandom, s_selectbitonic, s_sampleselect;
+    double sampleResult = 0.0;
+    
+    // times are the median of the timed runs with --bench; see magma_bench
+    magma_opts opts;
+    opts.parse_bench_opts( &argc, argv );
     
     int size = atoi(argv[1]);
     int selectset = atoi(argv[2]);
@@ -57,20 +65,19 @@ int main(  int argc, char** argv )
     for(int i=0; i<size; i++)
         printf("%.2f\t", a[i] );
 #endif
-    start = magma_sync_wtime( queue );
-    magma_zselect(a, size, selectset, queue);
-    end = magma_sync_wtime( queue );
-    t_select = end-start;
+    s_select = magma_bench( opts, queue,
+        [&]{ makeRandomArray(a, size); },
+        [&]{ magma_zselect(a, size, selectset, queue); });
+    t_select = s_select.median;
     magmaDoubleComplex selectResult = a[selectset];
 //#if defined(DEBUG)
     printf("\n selected by select: %.2f\n\n", MAGMA_Z_ABS(selectResult) );
 //#endif
 
-    makeRandomArray(a, size);
-    start = magma_sync_wtime( queue );
-    magma_zselectrandom(a, size, selectset, queue);
-    end = magma_sync_wtime( queue );
-    t_selectrandom = end-start;
+    s_selectrandom = magma_bench( opts, queue,
+        [&]{ makeRandomArray(a, size); },
+        [&]{ magma_zselectrandom(a, size, selectset, queue); });
+    t_selectrandom = s_selectrandom.median;
     magmaDoubleComplex selectRandomResult = a[selectset];
 //#if defined(DEBUG)
     printf("\n selected by ranomized select: %.2f\n\n", MAGMA_Z_ABS(selectResult) );
@@ -87,36 +94,97 @@ int main(  int argc, char** argv )
 */
     if (!(selectResult == selectRandomResult) ){
         printf(" Inconsistent result.\n");
+        info += 1;
     }
     
-    makeRandomArray(a, size);
-    start = magma_sync_wtime( queue );
+    // magma_zbitonic_sort only performs the bitonic split steps down to one
+    // subsequence per thread, it does not sort a random array: it is timed,
+    // but its result is not compared
     magma_int_t flag =0;
-    magma_zbitonic_sort(0, size, a, flag, queue);
-    end = magma_sync_wtime( queue );
-    t_selectbitonic = end-start;
-    magmaDoubleComplex BitonicResult = a[selectset];
-//#if defined(DEBUG)
-    printf("\n selected by bitonic sort: %.2f\n\n", MAGMA_Z_ABS(selectResult) );
-//#endif
-/*
+    s_selectbitonic = magma_bench( opts, queue,
+        [&]{ makeRandomArray(a, size); },
+        [&]{ magma_zbitonic_sort(0, size, a, flag, queue); });
+    t_selectbitonic = s_selectbitonic.median;
+    
+    
+    // the sample-select engine does not modify the array
     makeRandomArray(a, size);
-    clock_t sortBegin = clock();
-    std::sort(a, a+size);
-    clock_t sortEnd = clock();
-    double sortResult = a[selectset];
-#if defined(DEBUG)
-    printf("\n selected: %.2f\n\n", sortResult );
-#endif
-*/
-    if (!(BitonicResult == selectRandomResult) ){
+    s_sampleselect = magma_bench( opts, queue, []{},
+        [&]{
+            TESTING_CHECK( magma_zsampleselect_cpu( size, a, selectset, 0, SEED, 
+                                                    &sampleResult, NULL, queue ));
+        });
+    t_sampleselect = s_sampleselect.median;
+    printf("\n selected by sample select: %.2f\n\n", sampleResult );
+    if (!(sampleResult == MAGMA_Z_ABS(selectRandomResult)) ){
         printf(" Inconsistent result.\n");
+        info += 1;
     }
     
+    // split into two arrays, as for the factors L and U
+    {
+        double splitResult = 0.0;
+        TESTING_CHECK( magma_zsampleselect2_cpu( size/3, a, size - size/3, a + size/3,
+                                                 selectset, 0, SEED, &splitResult, NULL, queue ));
+        printf(" selected by sample select on two arrays: %.2f\n\n", splitResult );
+        if (!(splitResult == sampleResult) ){
+            printf(" Inconsistent result.\n");
+            info += 1;
+        }
+    }
+    
+    // from inside a parallel region, where the nested regions of the
+    // engine get a smaller team than omp_get_max_threads reports
+    {
+        double nestedResult = 0.0;
+        magma_int_t nested_info = 0;
+        magma_int_t omp_threads = magma_get_omp_numthreads();
+        magma_set_omp_numthreads( 4 );
+        #pragma omp parallel num_threads(2)
+        {
+            #pragma omp single
+            nested_info = magma_zsampleselect2_cpu( size/3, a, size - size/3, a + size/3,
+                                                    selectset, 0, SEED, &nestedResult,
+                                                    NULL, queue );
+        }
+        magma_set_omp_numthreads( omp_threads );
+        printf(" selected by sample select in a parallel region: %.2f\n\n", nestedResult );
+        if ( nested_info != 0 || !(nestedResult == sampleResult) ){
+            printf(" Inconsistent result.\n");
+            info += 1;
+        }
+    }
     
+    // approximate mode: the result is an element of a, the smallest one of
+    // its bucket, so its rank, the number of smaller elements, is at most
+    // the requested rank and within rank_err of it; rank 0 lies in the
+    // first bucket, whose lower bound is the minimum
+    magma_int_t ranks[4] = { 0, 1, selectset, size-1 };
+    for (int r=0; r < 4; r++) {
+        magma_int_t k = ranks[r], rank_err = -1, rank = 0;
+        bool member = false;
+        TESTING_CHECK( magma_zsampleselect_cpu( size, a, k, size/100 + 1, SEED, 
+                                                &sampleResult, &rank_err, queue ));
+        for (int i=0; i < size; i++) {
+            rank += ( MAGMA_Z_ABS(a[i]) < sampleResult );
+            member = member || ( MAGMA_Z_ABS(a[i]) == sampleResult );
+        }
+        bool okay = member && rank_err >= 0 && rank <= k && k - rank <= rank_err;
+        printf(" approximate sample select, rank %lld: rank %lld, error bound %lld   %s\n",
+               (long long) k, (long long) rank, (long long) rank_err, 
+               (okay ? "ok" : "failed") );
+        info += ! okay;
+    }
+    printf("\n");
+
     printf(" Select time (ms): %.4f\n", double(t_select)*1000 );
     printf(" Randomized select time (ms): %.4f\n", double(t_selectrandom)*1000 );
     printf(" Bitonicsort time (ms): %.4f\n", double(t_selectbitonic)*1000 );
+    printf(" Sample select time (ms): %.4f\n", double(t_sampleselect)*1000 );
+    magma_bench_record( opts, "zselect",           size, selectset, 0, 0, s_select,        -1 );
+    magma_bench_record( opts, "zselectrandom",     size, selectset, 0, 0, s_selectrandom,  -1 );
+    magma_bench_record( opts, "zbitonic_sort",     size, 0,         0, 0, s_selectbitonic, -1 );
+    magma_bench_record( opts, "zsampleselect_cpu", size, selectset, 0, 0, s_sampleselect,  -1 );
 
     // magma_free_cpu( &a );
     
@@ -37,6 +37,7 @@ int main(  int argc, char** argv )
     // magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
     magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, dB={Magma_CSR};
     magma_z_matrix x={Magma_CSR}, b={Magma_CSR};
+    magma_index_t *perm = NULL;
     
     int i=1;
     TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
@@ -60,6 +61,9 @@ int main(  int argc, char** argv )
 
         // scale matrix
         TESTING_CHECK( magma_zmscale( &A, zopts.scaling, queue ));
+
+        // reorder matrix
+        TESTING_CHECK( magma_zmreorder( &A, zopts.reordering, &perm, queue ));
         
         // preconditioner
         if ( zopts.solver_par.solver != Magma_ITERREF ) {
@@ -113,6 +117,8 @@ int main(  int argc, char** argv )
         magma_zmfree(&A, queue );
         magma_zmfree(&x, queue );
         magma_zmfree(&b, queue );
+        magma_free_cpu( perm );
+        perm = NULL;
         i++;
     }
 
@@ -45,6 +45,7 @@ int main(  int argc, char** argv )
     magma_z_matrix A_org={Magma_CSR};
     magma_z_matrix b_org={Magma_DENSE};
     magma_z_matrix scaling_factors={Magma_DENSE};
+    magma_z_matrix col_factors={Magma_DENSE}, dcol_factors={Magma_DENSE};
     magma_z_matrix y_check={Magma_DENSE};
     double residual = 0.0;
     
@@ -122,7 +123,15 @@ int main(  int argc, char** argv )
         TESTING_CHECK( magma_zmtransfer( b_h, &b_org, Magma_CPU, Magma_DEV, queue ));
         
         // scale matrix
-        if ( zopts.scaling != Magma_NOSCALE ) {
+        if ( zopts.scaling == Magma_MAXNORM || zopts.scaling == Magma_RUIZ ) {
+            // equilibration with separate row and column factors
+            TESTING_CHECK( magma_zmequilibrate( zopts.scaling, 0, &A,
+              &scaling_factors, &col_factors, queue ) );
+            TESTING_CHECK( magma_zmequilibrate_vector( scaling_factors, &b_h, queue ) );
+            TESTING_CHECK( magma_zmtransfer( col_factors, &dcol_factors,
+              Magma_CPU, Magma_DEV, queue ) );
+        }
+        else if ( zopts.scaling != Magma_NOSCALE ) {
             TESTING_CHECK( magma_zvinit( &scaling_factors, Magma_CPU, A.num_rows, 1, zero, queue ));
             
             // magma_zmscale_matrix_rhs to be deprecated
@@ -174,7 +183,17 @@ int main(  int argc, char** argv )
         residual = magma_dznrm2( A_org.num_rows, y_check.val, 1, queue ); 
         printf("%% original system residual check = %e\n", residual);
         
-        if ( ( zopts.scaling != Magma_NOSCALE ) && 
+        if ( zopts.scaling == Magma_MAXNORM || zopts.scaling == Magma_RUIZ ) {
+            printf("%% rescaling computed solution for scaling %d\n", zopts.scaling);
+            TESTING_CHECK( magma_zmequilibrate_vector( dcol_factors, &x, queue ) );
+            
+            TESTING_CHECK( magma_zvinit( &y_check, Magma_DEV, A.num_rows, 1, zero, queue ));
+            TESTING_CHECK( magma_z_spmv( one, A_org, x, zero, y_check, queue ) );
+            magma_zaxpy( A_org.num_rows, negone, b_org.val, 1, y_check.val, 1, queue );
+            residual = magma_dznrm2( A_org.num_rows, y_check.val, 1, queue ); 
+            printf("%% original system residual check = %e\n", residual);
+        }
+        else if ( ( zopts.scaling != Magma_NOSCALE ) && 
             ( ( side == MagmaRight ) // Magma_UNITROWCOL and Magma_UNITDIAGCOL to be deprecated 
             || ( side == MagmaBothSides )
             || ( zopts.scaling == Magma_UNITROWCOL ) 
@@ -229,6 +248,8 @@ int main(  int argc, char** argv )
         magma_zmfree(&A_org, queue );
         magma_zmfree(&b_org, queue );
         magma_zmfree(&scaling_factors, queue );
+        magma_zmfree(&col_factors, queue );
+        magma_zmfree(&dcol_factors, queue );
         magma_zmfree(&y_check, queue );
         i++;
     }
@@ -0,0 +1,253 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+
+
+// random m-by-n CSR matrix on the host with about density*m*n nonzeros
+static void
+random_csr( magma_int_t m, magma_int_t n, double density, magma_z_matrix *A,
+            magma_queue_t queue )
+{
+    magma_int_t nnz = 0, cap = (magma_int_t) ( density * m * n * 1.5 ) + m + 1;
+    A->storage_type = Magma_CSR;
+    A->memory_location = Magma_CPU;
+    A->ownership = MagmaTrue;
+    A->num_rows = m;
+    A->num_cols = n;
+    TESTING_CHECK( magma_index_malloc_cpu( &A->row, m+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &A->col, cap ));
+    TESTING_CHECK( magma_zmalloc_cpu( &A->val, cap ));
+    A->row[0] = 0;
+    for( magma_int_t i=0; i<m; i++ ){
+        for( magma_int_t j=0; j<n && nnz < cap; j++ ){
+            if( rand() < density * RAND_MAX ){
+                A->col[nnz] = j;
+                A->val[nnz] = MAGMA_Z_MAKE( rand() % 7 - 3, rand() % 5 - 2 );
+                nnz++;
+            }
+        }
+        A->row[i+1] = nnz;
+    }
+    A->nnz = nnz;
+    A->true_nnz = nnz;
+}
+
+
+// explicit op(A) in CSR by a counting sort; magma_zmtranspose_cpu is
+// limited to square matrices
+static void
+explicit_op( magma_trans_t trans, magma_z_matrix A, magma_z_matrix *At,
+             magma_queue_t queue )
+{
+    if( trans == MagmaNoTrans ){
+        TESTING_CHECK( magma_zmtransfer( A, At, Magma_CPU, Magma_CPU, queue ));
+        return;
+    }
+    magma_int_t m = A.num_cols;
+    At->storage_type = Magma_CSR;
+    At->memory_location = Magma_CPU;
+    At->ownership = MagmaTrue;
+    At->num_rows = m;
+    At->num_cols = A.num_rows;
+    At->nnz = A.nnz;
+    At->true_nnz = A.nnz;
+    TESTING_CHECK( magma_index_malloc_cpu( &At->row, m+2 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &At->col, A.nnz+1 ));
+    TESTING_CHECK( magma_zmalloc_cpu( &At->val, A.nnz+1 ));
+    for( magma_int_t i=0; i<m+2; i++ ){
+        At->row[i] = 0;
+    }
+    for( magma_int_t j=0; j<A.nnz; j++ ){
+        At->row[ A.col[j]+2 ]++;
+    }
+    for( magma_int_t i=2; i<m+2; i++ ){
+        At->row[i] += At->row[i-1];
+    }
+    // rows of A in ascending order keep the columns of At sorted
+    for( magma_int_t i=0; i<A.num_rows; i++ ){
+        for( magma_int_t j=A.row[i]; j<A.row[i+1]; j++ ){
+            magma_int_t dst = At->row[ A.col[j]+1 ]++;
+            At->col[dst] = i;
+            At->val[dst] = ( trans == MagmaConjTrans ) ? MAGMA_Z_CONJ( A.val[j] ) : A.val[j];
+        }
+    }
+}
+
+
+// compares C with the product of the explicit op(A) and B, restricted to
+// the pattern of M if given; returns the largest difference relative to
+// the largest |op(A)| |B| entry, or -1 if C is not sorted or has entries
+// outside the mask
+static double
+check_product( magma_trans_t trans, magma_z_matrix A, magma_z_matrix B,
+               magma_z_matrix *M, magma_z_matrix C, magma_queue_t queue )
+{
+    magma_z_matrix At={Magma_CSR};
+    explicit_op( trans, A, &At, queue );
+    magma_int_t m = At.num_rows, n = B.num_cols;
+    magmaDoubleComplex *w = (magmaDoubleComplex*) calloc( n, sizeof(magmaDoubleComplex) );
+    double *scale = (double*) calloc( n, sizeof(double) );
+    char *mask = (char*) calloc( n, 1 );
+    double error = 0.0, maxscale = 0.0;
+    bool okay = ( C.num_rows == m && C.num_cols == n );
+
+    for( magma_int_t i=0; i<m && okay; i++ ){
+        for( magma_int_t j=At.row[i]; j<At.row[i+1]; j++ ){
+            magma_index_t k = At.col[j];
+            for( magma_int_t l=B.row[k]; l<B.row[k+1]; l++ ){
+                w[ B.col[l] ] = w[ B.col[l] ] + At.val[j] * B.val[l];
+                scale[ B.col[l] ] += MAGMA_Z_ABS( At.val[j] ) * MAGMA_Z_ABS( B.val[l] );
+            }
+        }
+        if( M != NULL ){
+            for( magma_int_t j=M->row[i]; j<M->row[i+1]; j++ ){
+                mask[ M->col[j] ] = 1;
+            }
+        }
+        for( magma_int_t j=C.row[i]; j<C.row[i+1]; j++ ){
+            magma_index_t c = C.col[j];
+            okay = okay && ( j == C.row[i] || C.col[j-1] < c ) && ( M == NULL || mask[c] );
+            w[c] = w[c] - C.val[j];
+        }
+        for( magma_int_t c=0; c<n; c++ ){
+            if( M == NULL || mask[c] ){
+                error = max( error, MAGMA_Z_ABS( w[c] ));
+            }
+            maxscale = max( maxscale, scale[c] );
+            w[c] = MAGMA_Z_ZERO;
+            scale[c] = 0.0;
+            mask[c] = 0;
+        }
+    }
+    free( w );
+    free( scale );
+    free( mask );
+    magma_zmfree( &At, queue );
+    return okay ? error / max( maxscale, 1.0 ) : -1.0;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the host sparse matrix-matrix product C = op(A) B against an
+      explicit transpose and product, for every op, with and without mask,
+      and with and without chunking of the intermediate products
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR}, B={Magma_CSR}, M={Magma_CSR}, C={Magma_CSR};
+    double tol = 10 * lapackf77_dlamch( "E" );
+
+    magma_trans_t trans[3] = { MagmaNoTrans, MagmaTrans, MagmaConjTrans };
+    const char *trans_name[3] = { "A", "A^T", "A^H" };
+    magma_int_t chunks[3] = { 0, 1, 37 };   // no bound, one product, a few rows
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+
+    // random rectangular matrices, sparse and fairly dense
+    magma_int_t fails = 0, tests = 0;
+    srand( 352302 );
+    for( int t=0; t<20; t++ ){
+        magma_int_t m = 1 + rand() % 60, k = 1 + rand() % 60, n = 1 + rand() % 60;
+        double density = ( t % 4 == 0 ) ? 0.6 : 0.08;
+        for( int o=0; o<3; o++ ){
+            if( trans[o] == MagmaNoTrans ){
+                random_csr( m, k, density, &A, queue );
+            } else {
+                random_csr( k, m, density, &A, queue );
+            }
+            random_csr( k, n, density, &B, queue );
+            random_csr( m, n, 0.3, &M, queue );
+            for( int mask=0; mask<2; mask++ ){
+                for( int c=0; c<3; c++ ){
+                    magma_int_t info = magma_zspgemm_ex_cpu( trans[o], A, B, mask ? &M : NULL,
+                                                             chunks[c], &C, queue );
+                    double error = ( info == 0 )
+                                   ? check_product( trans[o], A, B, mask ? &M : NULL, C, queue )
+                                   : -1.0;
+                    bool okay = ( error >= 0 && error < tol );
+                    if( ! okay ){
+                        printf( "%% C = %s B, %lld-by-%lld-by-%lld, mask %d, max_products %lld:"
+                                " info %lld, error %.2e   failed\n",
+                                trans_name[o], (long long) m, (long long) k, (long long) n,
+                                mask, (long long) chunks[c], (long long) info, error );
+                    }
+                    fails += ! okay;
+                    tests++;
+                    magma_zmfree( &C, queue );
+                }
+            }
+            magma_zmfree( &A, queue );
+            magma_zmfree( &B, queue );
+            magma_zmfree( &M, queue );
+        }
+    }
+    status += ( fails > 0 );
+    printf( "%% random matrices: %lld of %lld products correct   %s\n",
+            (long long) (tests - fails), (long long) tests, (fails == 0 ? "ok" : "failed") );
+
+    // given matrices: op(A) A, and op(A) A on the pattern of A
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+
+        for( int o=0; o<3; o++ ){
+            for( int mask=0; mask<2; mask++ ){
+                for( int c=0; c<3; c++ ){
+                    magma_int_t max_products = ( chunks[c] == 37 ) ? A.nnz : chunks[c];
+                    magma_int_t info = magma_zspgemm_ex_cpu( trans[o], A, A, mask ? &A : NULL,
+                                                             max_products, &C, queue );
+                    double error = ( info == 0 )
+                                   ? check_product( trans[o], A, A, mask ? &A : NULL, C, queue )
+                                   : -1.0;
+                    bool okay = ( error >= 0 && error < tol );
+                    status += ! okay;
+                    printf( "%% C = %-3s A%s, max_products %8lld: nnz(C) %8lld, error %.2e   %s\n",
+                            trans_name[o], (mask ? " on the pattern of A" : "                    "),
+                            (long long) max_products, (long long) C.nnz, error,
+                            (okay ? "ok" : "failed") );
+                    magma_zmfree( &C, queue );
+                }
+            }
+        }
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
@@ -39,7 +39,9 @@ int main(  int argc, char** argv )
     magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
     magmaDoubleComplex mone = MAGMA_Z_MAKE(-1.0, 0.0);
     magma_z_matrix A={Magma_CSR}, a={Magma_CSR}, b={Magma_CSR};
-    magma_z_matrix c={Magma_CSR}, d={Magma_CSR};
+    magma_z_matrix c={Magma_CSR}, d={Magma_CSR}, dT={Magma_CSR};
+    magma_solver_type host_trisolver[3] = { Magma_LEVELSOLVE,
+        Magma_BLOCKLEVELSOLVE, Magma_CPUSYNCFREESOLVE };
     magma_int_t dofs;
     double res;
     
@@ -79,7 +81,7 @@ int main(  int argc, char** argv )
         
         if(debug)printf("%% --- debug mode ---");
         else { printf("prec_info = [\n");
-               printf("%% row-wise: cuSOLVE, sync-free, BJ(1)-3, BJ(1)-5, BJ(12)-3, BJ(12)-5, BJ(24)-3, BJ(24)-5, ISAI(1)-0, ISAI(2)-0, ISAI(3)-0\n");
+               printf("%% row-wise: cuSOLVE, sync-free, BJ(1)-3, BJ(1)-5, BJ(12)-3, BJ(12)-5, BJ(24)-3, BJ(24)-5, ISAI(1)-0, ISAI(2)-0, ISAI(3)-0, level, block-level, CPU sync-free\n");
                printf("%% col-wise: prec-setup res_L time_L res_U time_U\n");
         }
         // preconditioner with cusparse trisolve
@@ -734,6 +736,65 @@ int main(  int argc, char** argv )
         magma_zmfree(&d, queue );
         magma_zprecondfree( &zopts.precond_par , queue );
 
+        // preconditioner with host trisolves, the factors are moved to the CPU
+        for( int t=0; t<3; t++ ){
+        printf("\n%% --- Now use host trisolve ---\n");
+        zopts.precond_par.solver = Magma_ILU;
+        zopts.precond_par.trisolver = host_trisolver[t];
+        tempo1 = magma_sync_wtime( queue );
+        TESTING_CHECK( magma_z_precondsetup( A, b, &zopts.solver_par, &zopts.precond_par, queue ) );
+        tempo2 = magma_sync_wtime( queue );
+        if(debug)printf("%% time_magma_z_precondsetup = %.6e\n",tempo2-tempo1 );
+        else printf("%.6e\t",tempo2-tempo1 );
+
+        // vectors and initial guess
+        TESTING_CHECK( magma_zvinit( &a, Magma_DEV, A.num_rows, 1, one, queue ));
+        TESTING_CHECK( magma_zvinit( &b, Magma_DEV, A.num_rows, 1, zero, queue ));
+        TESTING_CHECK( magma_zvinit( &c, Magma_DEV, A.num_rows, 1, zero, queue ));
+        TESTING_CHECK( magma_zvinit( &d, Magma_DEV, A.num_rows, 1, zero, queue ));
+        
+        // b = sptrsv(L,a)
+        // c = L*b
+        // d = a-c
+        // res = norm(d)
+        tempo1 = magma_sync_wtime( queue );
+        TESTING_CHECK( magma_z_applyprecond_left( MagmaNoTrans, A, a, &b, &zopts.precond_par, queue ));
+        tempo2 = magma_sync_wtime( queue );
+        TESTING_CHECK( magma_zmtransfer( zopts.precond_par.L, &dT, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_z_spmv( one, dT, b, zero, c, queue ));   
+        magma_zmfree(&dT, queue );
+        magma_zcopy( dofs, a.dval, 1 , d.dval, 1, queue );
+        magma_zaxpy( dofs, mone, c.dval, 1 , d.dval, 1, queue );
+        res = magma_dznrm2( dofs, d.dval, 1, queue );
+        if(debug)printf("%% residual_L = %.6e\n", res );
+        else printf("%.6e\t", res );
+        if(debug)printf("%% time_L = %.6e\n",tempo2-tempo1 );
+        else printf("%.6e\t",tempo2-tempo1 );
+        
+        // b = sptrsv(U,a)
+        // c = U*b
+        // d = a-c
+        // res = norm(d)
+        tempo1 = magma_sync_wtime( queue );
+        TESTING_CHECK( magma_z_applyprecond_right( MagmaNoTrans, A, a, &b, &zopts.precond_par, queue ));
+        tempo2 = magma_sync_wtime( queue );
+        TESTING_CHECK( magma_zmtransfer( zopts.precond_par.U, &dT, Magma_CPU, Magma_DEV, queue ));
+        TESTING_CHECK( magma_z_spmv( one, dT, b, zero, c, queue ));   
+        magma_zmfree(&dT, queue );
+        magma_zcopy( dofs, a.dval, 1 , d.dval, 1, queue );
+        magma_zaxpy( dofs, mone, c.dval, 1 , d.dval, 1, queue );
+        res = magma_dznrm2( dofs, d.dval, 1, queue );
+        if(debug)printf("%% residual_U = %.6e\n", res );
+        else printf("%.6e\t", res );
+        if(debug)printf("%% time_U = %.6e\n",tempo2-tempo1 );
+        else printf("%.6e\n",tempo2-tempo1 );
+        magma_zmfree(&a, queue );
+        magma_zmfree(&b, queue );
+        magma_zmfree(&c, queue );
+        magma_zmfree(&d, queue );
+        magma_zprecondfree( &zopts.precond_par , queue );
+        }
+
         
         if(debug)printf("%% --- completed ---");
         else printf("];\n");
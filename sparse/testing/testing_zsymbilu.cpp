@@ -0,0 +1,187 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "magma_v2.h"
+#include "magmasparse.h"
+#include "magma_operators.h"
+#include "testings.h"
+#include "../../control/magma_threadsetting.h"  // internal header
+
+
+// random n-by-n nonsymmetric CSR pattern on the host with a full diagonal
+// and about nnz_row further entries per row
+static void
+random_pattern( magma_int_t n, magma_int_t nnz_row, magma_z_matrix *A, magma_queue_t queue )
+{
+    A->storage_type = Magma_CSR;
+    A->memory_location = Magma_CPU;
+    A->ownership = MagmaTrue;
+    A->num_rows = n;
+    A->num_cols = n;
+    TESTING_CHECK( magma_index_malloc_cpu( &A->row, n+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &A->col, n*(nnz_row+1) ));
+    TESTING_CHECK( magma_zmalloc_cpu( &A->val, n*(nnz_row+1) ));
+    magma_int_t nnz = 0;
+    A->row[0] = 0;
+    for( magma_int_t i=0; i<n; i++ ){
+        A->col[nnz++] = i;
+        for( magma_int_t k=0; k<nnz_row; k++ ){
+            magma_index_t c = rand() % n;
+            bool dup = false;
+            for( magma_int_t j=A->row[i]; j<nnz; j++ ){
+                dup = dup || A->col[j] == c;
+            }
+            if( ! dup ){
+                A->col[nnz++] = c;
+            }
+        }
+        A->row[i+1] = nnz;
+    }
+    for( magma_int_t j=0; j<nnz; j++ ){
+        A->val[j] = MAGMA_Z_ONE;
+    }
+    A->nnz = nnz;
+    A->true_nnz = nnz;
+}
+
+
+// true if the first n+1 row pointers and the column indices agree
+static bool
+same_structure( magma_int_t n, const magma_index_t *ia, const magma_index_t *ja,
+                const magma_index_t *ib, const magma_index_t *jb )
+{
+    for( magma_int_t i=0; i<=n; i++ ){
+        if( ia[i] != ib[i] ){
+            return false;
+        }
+    }
+    for( magma_int_t j=0; j<ia[n]; j++ ){
+        if( ja[j] != jb[j] ){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// compares magma_zsymbolic_ilu_mt with the serial magma_zsymbolic_ilu for
+// several levels of fill and thread counts; returns the number of failures
+static int
+check_symbolic( magma_z_matrix A, magma_queue_t queue )
+{
+    int status = 0;
+    magma_int_t n = A.num_rows;
+    magma_int_t levels[5] = { 0, 1, 2, 3, 5 };
+    magma_int_t threads[4] = { 1, 2, 4, 7 };
+    magma_int_t omp_threads = magma_get_omp_numthreads();
+    magma_index_t *ial = NULL, *iau = NULL, *jal = NULL, *jau = NULL;
+    magma_index_t *ial_mt = NULL, *iau_mt = NULL, *jal_mt = NULL, *jau_mt = NULL;
+
+    TESTING_CHECK( magma_index_malloc_cpu( &ial, n+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &iau, n+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &ial_mt, n+1 ));
+    TESTING_CHECK( magma_index_malloc_cpu( &iau_mt, n+1 ));
+
+    for( int l=0; l<5; l++ ){
+        // reference: the serial routine needs the storage in advance; a
+        // generous bound from the parallel count still exposes undercounts
+        magma_int_t nzl_mt, nzu_mt;
+        magma_set_omp_numthreads( 1 );
+        TESTING_CHECK( magma_zsymbolic_ilu_mt( levels[l], n, &nzl_mt, &nzu_mt, A.row, A.col,
+                                               ial_mt, &jal_mt, iau_mt, &jau_mt, queue ));
+        magma_int_t nzl = nzl_mt + n, nzu = nzu_mt + n;
+        TESTING_CHECK( magma_index_malloc_cpu( &jal, nzl ));
+        TESTING_CHECK( magma_index_malloc_cpu( &jau, nzu ));
+        magma_int_t info = magma_zsymbolic_ilu( levels[l], n, &nzl, &nzu, A.row, A.col,
+                                                ial, jal, iau, jau );
+        magma_free_cpu( jal_mt );
+        magma_free_cpu( jau_mt );
+
+        for( int t=0; t<4; t++ ){
+            magma_set_omp_numthreads( threads[t] );
+            TESTING_CHECK( magma_zsymbolic_ilu_mt( levels[l], n, &nzl_mt, &nzu_mt, A.row, A.col,
+                                                   ial_mt, &jal_mt, iau_mt, &jau_mt, queue ));
+            bool okay = ( info == 0 && nzl_mt == nzl && nzu_mt == nzu
+                          && same_structure( n, ial, jal, ial_mt, jal_mt )
+                          && same_structure( n, iau, jau, iau_mt, jau_mt ));
+            status += ! okay;
+            printf( "%% ILU(%lld), %lld threads: nnz(L) %8lld (serial %8lld),"
+                    " nnz(U) %8lld (serial %8lld)   %s\n",
+                    (long long) levels[l], (long long) threads[t],
+                    (long long) nzl_mt, (long long) nzl, (long long) nzu_mt, (long long) nzu,
+                    (okay ? "ok" : "failed") );
+            magma_free_cpu( jal_mt );
+            magma_free_cpu( jau_mt );
+        }
+        magma_free_cpu( jal );
+        magma_free_cpu( jau );
+    }
+    magma_set_omp_numthreads( omp_threads );
+
+    magma_free_cpu( ial );
+    magma_free_cpu( iau );
+    magma_free_cpu( ial_mt );
+    magma_free_cpu( iau_mt );
+    return status;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- testing the parallel symbolic ILU(k) against the serial reference
+*/
+int main(  int argc, char** argv )
+{
+    int status = 0;
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_zopts zopts;
+    magma_queue_t queue=NULL;
+    magma_queue_create( 0, &queue );
+
+    magma_z_matrix A={Magma_CSR};
+
+    int i=1;
+    TESTING_CHECK( magma_zparse_opts( argc, argv, &zopts, &i, queue ));
+
+    // nonsymmetric random pattern
+    srand( 1042 );
+    random_pattern( 300, 3, &A, queue );
+    printf( "\n%% random pattern: %lld-by-%lld with %lld nonzeros\n\n",
+            (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+    status += check_symbolic( A, queue );
+    magma_zmfree( &A, queue );
+
+    while( i < argc ) {
+        if ( strcmp("LAPLACE2D", argv[i]) == 0 && i+1 < argc ) {   // Laplace test
+            i++;
+            magma_int_t laplace_size = atoi( argv[i] );
+            TESTING_CHECK( magma_zm_5stencil(  laplace_size, &A, queue ));
+        } else {                        // file-matrix test
+            TESTING_CHECK( magma_z_csr_mtx( &A,  argv[i], queue ));
+        }
+        printf( "\n%% matrix info: %lld-by-%lld with %lld nonzeros\n\n",
+                (long long) A.num_rows, (long long) A.num_cols, (long long) A.nnz );
+        status += check_symbolic( A, queue );
+        magma_zmfree( &A, queue );
+        i++;
+    }
+
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return status;
+}
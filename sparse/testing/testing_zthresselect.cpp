@@ -34,7 +34,15 @@ int main(  int argc, char** argv )
     magma_queue_create( 0, &queue );
     
     magma_z_matrix A={Magma_CSR};
-    real_Double_t start, end, t_gpu=0.0, t_cpu=0.0;
+    real_Double_t t_gpu=0.0, t_cpu=0.0;
+    magma_bench_stats s_gpu, s_cpu;
+    
+    // the median of 10 timed runs unless set by --bench-reps, --bench-warmup
+    magma_opts opts;
+    opts.bench = true;
+    opts.bench_warmup = 0;
+    opts.bench_reps = 10;
+    opts.parse_bench_opts( &argc, argv );
     magma_int_t sampling = 16;
     double thrs;
     for( int m = 1000; m<10000001; m=m*2) {
@@ -42,8 +50,9 @@ int main(  int argc, char** argv )
         int count = 0;
         sampling = m/327680+1;
         sampling = 1;
-        magmaDoubleComplex *val, *d_val;
+        magmaDoubleComplex *val, *work, *d_val;
         TESTING_CHECK(magma_zmalloc_cpu(&val, m));
+        TESTING_CHECK(magma_zmalloc_cpu(&work, m));
         TESTING_CHECK(magma_zmalloc(&d_val, m));
         // fill the values with random numbers
         for (int z=0; z<m; z++){
@@ -53,11 +62,9 @@ int main(  int argc, char** argv )
         // copy over
         magma_zsetvector( m, val, 1, d_val, 1, queue );
         
-        start = magma_sync_wtime( queue );
-        for(int i=0; i<10; i++)
-            TESTING_CHECK(magma_zthrsholdselect(sampling, m, n, d_val, &thrs, queue));
-        end = magma_sync_wtime( queue );
-        t_gpu = (end-start) / 10.0;
+        s_gpu = magma_bench( opts, queue, []{},
+            [&]{ TESTING_CHECK(magma_zthrsholdselect(sampling, m, n, d_val, &thrs, queue)); });
+        t_gpu = s_gpu.median;
         count = 0;
         for(int z=0; z<m; z++) {
             if (MAGMA_Z_ABS(val[z])<thrs) {
@@ -68,14 +75,13 @@ int main(  int argc, char** argv )
 
         printf( " %10d  %10d  %.8e  %10d %.4e %.4e\t\t %.3e", m, n, thrs, count, fabs(1.0-(float)count/(float)n), fabs((float)(n-count)/(float)m), t_gpu );
         
-        // cpu reference for comparison
+        // cpu reference for comparison, on a copy as it reorders the values
         A.nnz = m;
-        A.val = val;
-        start = magma_sync_wtime( queue );
-        for(int i=0; i<10; i++)
-            magma_zselectrandom( A.val, m, n, queue );
-        end = magma_sync_wtime( queue );
-        t_cpu = (end-start) / 10.0;
+        A.val = work;
+        s_cpu = magma_bench( opts, queue,
+            [&]{ memcpy( work, val, m*sizeof(magmaDoubleComplex) ); },
+            [&]{ magma_zselectrandom( A.val, m, n, queue ); });
+        t_cpu = s_cpu.median;
         thrs = MAGMA_Z_ABS(A.val[n]);
         count = 0;
         for(int z=0; z<m; z++) {
@@ -86,8 +92,11 @@ int main(  int argc, char** argv )
                 
         magma_free(d_val);
         magma_free_cpu(val);
+        magma_free_cpu(work);
 
         printf( " %10d  %10d  %.8e  %10d %.4e %.4e\t\t %.3e\n", m, n, thrs, count, fabs(1.0-(float)count/(float)n), fabs((float)(n-count)/(float)m), t_cpu );
+        magma_bench_record( opts, "zthrsholdselect", m, n, 0, 0, s_gpu, -1 );
+        magma_bench_record( opts, "zselectrandom",   m, n, 0, 0, s_cpu, -1 );
     }
     }
     
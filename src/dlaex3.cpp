@@ -16,6 +16,7 @@
 
 #include "magma_internal.h"
 #include "magma_timer.h"
+#include "trace.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -328,6 +329,7 @@ magma_dlaex3(
         magma_int_t iend   = ((tid+1) * k) / nthread; // end   index of local loop
         magma_int_t ik     = iend - ibegin;           // number of local indices
 
+        magma_trace_begin( "laed4", "secular equation" );
         for (i = ibegin; i < iend; ++i)
             dlamda[i] = lapackf77_dlamc3(&dlamda[i], &dlamda[i]) - dlamda[i];
 
@@ -342,6 +344,7 @@ magma_dlaex3(
                 break;
             }
         }
+        magma_trace_end();
 
         #pragma omp barrier
 
@@ -382,6 +385,7 @@ magma_dlaex3(
             }
             else if (k != 1) {
                 // Compute updated W.
+                magma_trace_begin( "laex3", "update w" );
                 blasf77_dcopy( &ik, &w[ibegin], &ione, &s[ibegin], &ione);
 
                 // Initialize W(I) = Q(I,I)
@@ -399,6 +403,7 @@ magma_dlaex3(
 
                 for (i = ibegin; i < iend; ++i)
                     w[i] = copysign( sqrt( -w[i] ), s[i]);
+                magma_trace_end();
 
                 #pragma omp barrier
 
@@ -417,6 +422,7 @@ magma_dlaex3(
                 }
 
                 // Compute eigenvectors of the modified rank-1 modification.
+                magma_trace_begin( "laex3", "eigenvectors" );
                 for (j = ibegin; j < iend; ++j) {
                     for (i = 0; i < k; ++i)
                         s[tid*k + i] = w[i] / *Q(i,j);
@@ -426,6 +432,7 @@ magma_dlaex3(
                         *Q(i,j) = s[tid*k + iii] / temp;
                     }
                 }
+                magma_trace_end();
             }
         }
     }  // end omp parallel
@@ -15,6 +15,8 @@
 #include "magma_internal.h"
 #include "magma_bulge.h"
 #include "magma_zbulge.h"
+#include "magma_thread_budget.h"
+#include "trace.h"
 
 #define COMPLEX
 
@@ -46,6 +48,7 @@ typedef struct magma_zapplyQ_data_s {
     magmaDoubleComplex* dE;
     magma_int_t ldde;
     pthread_barrier_t barrier;
+    const magma_thread_region* region;
 } magma_zapplyQ_data;
 
 
@@ -123,9 +126,9 @@ magma_zbulge_back(
     magmaDoubleComplex *T, magma_int_t ldt,
     magma_int_t* info)
 {
-    magma_int_t threads = magma_get_parallel_numthreads();
-    magma_int_t mklth   = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
+    // reserves CPUs for the threads applying Q, which use single-threaded BLAS
+    magma_thread_region region( "bulge_back", magma_get_parallel_numthreads() );
+    magma_int_t threads = region.num_threads();
 
     real_Double_t timeaplQ2=0.0;
     double f= 1.;
@@ -174,6 +177,7 @@ magma_zbulge_back(
         #endif
         magma_zapplyQ_data data_applyQ;
         magma_zapplyQ_data_init(&data_applyQ, threads, n, ne, n_gpu, nb, Vblksiz, Z, ldz, V, ldv, TAU, T, ldt, dZ, lddz);
+        data_applyQ.region = &region;
 
         magma_zapplyQ_id_data* arg;
         magma_malloc_cpu((void**) &arg, threads*sizeof(magma_zapplyQ_id_data));
@@ -223,7 +227,6 @@ magma_zbulge_back(
     timeaplQ2 = magma_wtime()-timeaplQ2;
 
     magma_queue_destroy( queue );
-    magma_set_lapack_numthreads(mklth);
     return MAGMA_SUCCESS;
 }
 
@@ -259,30 +262,8 @@ static void *magma_zapplyQ_parallel_section(void *arg)
 
     magma_int_t n_cpu = ne - n_gpu;
 
-    // with MKL and when using omp_set_num_threads instead of mkl_set_num_threads
-    // it need that all threads setting it to 1.
-    magma_set_lapack_numthreads(1);
-
-#ifndef MAGMA_NOAFFINITY
-    //#define PRINTAFFINITY
-#ifdef PRINTAFFINITY
-    affinity_set print_set;
-    print_set.print_affinity(my_core_id, "starting affinity");
-#endif
-    cpu_set_t old_set, new_set;
-
-    //store current affinity
-    CPU_ZERO(&old_set);
-    sched_getaffinity( 0, sizeof(old_set), &old_set);
-    //set new affinity
-    // bind threads
-    CPU_ZERO(&new_set);
-    CPU_SET(my_core_id, &new_set);
-    sched_setaffinity( 0, sizeof(new_set), &new_set);
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "set affinity");
-#endif
-#endif
+    // bind thread to its CPU, with single-threaded BLAS, until return
+    magma_thread_worker worker( *data->region, my_core_id );
 
     if (my_core_id == 0) {
         //=============================================
@@ -297,8 +278,10 @@ static void *magma_zapplyQ_parallel_section(void *arg)
         magma_getdevice( &cdev );
         magma_queue_create( cdev, &queue );
 
+        magma_trace_begin( "applyQ", "apply Q2 on GPU" );
         magma_zsetmatrix( n, n_gpu, E, lde, dE, ldde, queue );
         magma_zbulge_applyQ_v2(MagmaLeft, n_gpu, n, nb, Vblksiz, dE, ldde, V, ldv, T, ldt, &info);
+        magma_trace_end();
 
         magma_queue_destroy( queue );
         
@@ -320,8 +303,12 @@ static void *magma_zapplyQ_parallel_section(void *arg)
         magmaDoubleComplex* E_loc = E + (n_gpu+ n_loc * (my_core_id-1))*lde;
         n_loc = min(n_loc,n_cpu - n_loc * (my_core_id-1));
 
+        magma_trace_begin( "applyQ", "apply Q2 on CPU" );
         magma_ztile_bulge_applyQ(my_core_id, MagmaLeft, n_loc, n, nb, Vblksiz, E_loc, lde, V, ldv, TAU, T, ldt);
+        magma_trace_end();
+        magma_trace_begin( "wait", "barrier" );
         pthread_barrier_wait(barrier);
+        magma_trace_end();
 
         #ifdef ENABLE_TIMER
         if (my_core_id == 1) {
@@ -331,14 +318,6 @@ static void *magma_zapplyQ_parallel_section(void *arg)
         #endif
     } // END if my_core_id
 
-#ifndef MAGMA_NOAFFINITY
-    //restore old affinity
-    sched_setaffinity(0, sizeof(old_set), &old_set);
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "restored_affinity");
-#endif
-#endif
-
     return 0;
 }
 
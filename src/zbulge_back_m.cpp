@@ -15,10 +15,7 @@
 #include "magma_internal.h"
 #include "magma_bulge.h"
 #include "magma_zbulge.h"
-
-#ifndef MAGMA_NOAFFINITY
-#include "affinity.h"
-#endif
+#include "magma_thread_budget.h"
 
 
 #define COMPLEX
@@ -59,7 +56,8 @@ public:
     ldv(ldv_),
     TAU(TAU_),
     T(T_),
-    ldt(ldt_)
+    ldt(ldt_),
+    region(NULL)
     {
         magma_int_t count = threads_num;
 
@@ -88,6 +86,7 @@ public:
     magmaDoubleComplex* const T;
     const magma_int_t ldt;
     pthread_barrier_t barrier;
+    const magma_thread_region* region;
 
 private:
 
@@ -126,9 +125,9 @@ magma_zbulge_back_m(
     magmaDoubleComplex *T, magma_int_t ldt,
     magma_int_t* info)
 {
-    magma_int_t threads = magma_get_parallel_numthreads();
-    magma_int_t mklth   = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(1);
+    // reserves CPUs for the threads applying Q, which use single-threaded BLAS
+    magma_thread_region region( "bulge_back_m", magma_get_parallel_numthreads() );
+    magma_int_t threads = region.num_threads();
 
     real_Double_t timeaplQ2=0.0;
     double f= 1.;
@@ -166,6 +165,7 @@ magma_zbulge_back_m(
         printf("---> calling GPU + CPU(if N_CPU > 0) to apply V2 to Z with NE %lld     N_GPU %lld   N_CPU %lld\n",ne, n_gpu, ne-n_gpu);
         #endif
         magma_zapplyQ_m_data data_applyQ(ngpu, threads, n, ne, n_gpu, nb, Vblksiz, Z, ldz, V, ldv, TAU, T, ldt);
+        data_applyQ.region = &region;
 
         magma_zapplyQ_m_id_data* arg;
         magma_malloc_cpu((void**) &arg, threads*sizeof(magma_zapplyQ_m_id_data));
@@ -209,7 +209,6 @@ magma_zbulge_back_m(
 
     timeaplQ2 = magma_wtime()-timeaplQ2;
 
-    magma_set_lapack_numthreads(mklth);
     return MAGMA_SUCCESS;
 }
 
@@ -244,34 +243,8 @@ static void *magma_zapplyQ_m_parallel_section(void *arg)
 
     magma_int_t n_cpu = ne - n_gpu;
 
-    // with MKL and when using omp_set_num_threads instead of mkl_set_num_threads
-    // it need that all threads setting it to 1.
-    magma_set_lapack_numthreads(1);
-
-#ifndef MAGMA_NOAFFINITY
-    //#define PRINTAFFINITY
-#ifdef PRINTAFFINITY
-    affinity_set print_set;
-    print_set.print_affinity(my_core_id, "starting affinity");
-#endif
-    affinity_set original_set;
-    affinity_set new_set(my_core_id);
-    magma_int_t check  = 0;
-    magma_int_t check2 = 0;
-    // bind threads
-    check = original_set.get_affinity();
-    if (check == 0) {
-        check2 = new_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (single cpu)\n");
-    }
-    else {
-        printf("Error in sched_getaffinity\n");
-    }
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "set affinity");
-#endif
-#endif
+    // bind thread to its CPU, with single-threaded BLAS, until return
+    magma_thread_worker worker( *data->region, my_core_id );
 
     if (my_core_id == 0) {
         //=============================================
@@ -313,18 +286,6 @@ static void *magma_zapplyQ_m_parallel_section(void *arg)
         #endif
     } // END if my_core_id
 
-#ifndef MAGMA_NOAFFINITY
-    // unbind threads
-    if (check == 0) {
-        check2 = original_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (restore cpu list)\n");
-    }
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "restored_affinity");
-#endif
-#endif
-
     return 0;
 }
 
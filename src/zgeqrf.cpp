@@ -10,6 +10,7 @@
 
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 /***************************************************************************//**
     Purpose
@@ -99,6 +100,7 @@ magma_zgeqrf(
     magmaDoubleComplex *work, magma_int_t lwork,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zgeqrf", (lwork == -1 ? 0 : FLOPS_ZGEQRF( m, n )) );
     #define  A(i_,j_)  (A + (i_) + (j_)*lda)
     
     #ifdef HAVE_clBLAS
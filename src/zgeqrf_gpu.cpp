@@ -11,6 +11,7 @@
        @precisions normal z -> s d c
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 /***************************************************************************//**
     Auxiliary function: "A" is pointer to the current panel holding the
@@ -128,6 +129,7 @@ magma_zgeqrf_gpu(
     magmaDoubleComplex_ptr dT,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zgeqrf_gpu", FLOPS_ZGEQRF( m, n ) );
     #ifdef HAVE_clBLAS
     #define dA(i_, j_)  dA, (dA_offset + (i_) + (j_)*(ldda))
     #define dT(i_)      dT, (dT_offset + (i_)*nb)
@@ -9,6 +9,7 @@
 
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 /***************************************************************************//**
     Purpose
@@ -73,6 +74,7 @@ magma_zgesv(
     magmaDoubleComplex *B, magma_int_t ldb,
     magma_int_t *info)
 {
+    MAGMA_METRICS( "magma_zgesv", FLOPS_ZGETRF( n, n ) + FLOPS_ZGETRS( n, nrhs ) );
     #ifdef HAVE_clBLAS
     #define  dA(i_, j_)  dA, ((i_) + (j_)*ldda)
     #define  dB(i_, j_)  dB, ((i_) + (j_)*lddb)
@@ -8,6 +8,7 @@
        @precisions normal z -> s d c
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 /***************************************************************************//**
     Purpose
@@ -71,6 +72,7 @@ magma_zgesv_gpu(
     magmaDoubleComplex_ptr dB, magma_int_t lddb,
     magma_int_t *info)
 {
+    MAGMA_METRICS( "magma_zgesv_gpu", FLOPS_ZGETRF( n, n ) + FLOPS_ZGETRS( n, nrhs ) );
     *info = 0;
     if (n < 0) {
         *info = -1;
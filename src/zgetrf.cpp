@@ -11,6 +11,7 @@
        @precisions normal z -> s d c
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 
 /***************************************************************************//**
@@ -78,6 +79,7 @@ magma_zgetrf(
     magma_int_t *ipiv,
     magma_int_t *info)
 {
+    MAGMA_METRICS( "magma_zgetrf", FLOPS_ZGETRF( m, n ) );
     #ifdef HAVE_clBLAS
     #define  dA(i_, j_)     dA, ((i_)*nb  + (j_)*nb*ldda + dA_offset)
     #define dAT(i_, j_)    dAT, ((i_)*nb*lddat + (j_)*nb + dAT_offset)
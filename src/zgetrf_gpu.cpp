@@ -12,6 +12,7 @@
 
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 /***************************************************************************//**
     Purpose
@@ -362,6 +363,7 @@ magma_zgetrf_gpu(
     magma_int_t *ipiv,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zgetrf_gpu", FLOPS_ZGETRF( m, n ) );
     magma_zgetrf_gpu_expert(m, n, dA, ldda, ipiv, info, MagmaHybrid);
     return *info;
 } /* magma_zgetrf_gpu */
@@ -379,6 +381,7 @@ magma_zgetrf_native(
     magma_int_t *ipiv,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zgetrf_native", FLOPS_ZGETRF( m, n ) );
     magma_zgetrf_gpu_expert(m, n, dA, ldda, ipiv, info, MagmaNative);
     return *info;
 } /* magma_zgetrf_native */
@@ -14,6 +14,7 @@
 
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 #include "magma_timer.h"
 
 #define COMPLEX
@@ -166,6 +167,7 @@ magma_zheevd_gpu(
     magma_int_t *iwork, magma_int_t liwork,
     magma_int_t *info)
 {
+    MAGMA_METRICS( "magma_zheevd_gpu", 0 );
     const char* uplo_ = lapack_uplo_const( uplo );
     const char* jobz_ = lapack_vec_const( jobz );
     magma_int_t ione = 1;
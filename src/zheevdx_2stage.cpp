@@ -434,6 +434,7 @@ magma_zheevdx_2stage(
 
 
     magma_timer_t time=0, time_total=0;
+    magma_perfctr_t ctr;
     timer_start( time_total );
     timer_start( time );
 
@@ -466,12 +467,15 @@ magma_zheevdx_2stage(
     timer_stop( time );
     timer_printf( "  N= %10lld  nb= %5lld time zhetrd_convert = %6.2f\n", (long long) n, (long long) nb, time );
     timer_start( time );
+    perfctr_start( ctr );
 
     magma_zhetrd_hb2st(uplo, n, nb, Vblksiz, A2, lda2, W, E, V2, ldv, TAU2, wantz, T2, ldt);
 
+    perfctr_stop( ctr );
     timer_stop( time );
     timer_stop( time_total );
     timer_printf( "  N= %10lld  nb= %5lld time zhetrd_hb2st= %6.2f\n", (long long) n, (long long) nb, time );
+    perfctr_printf( "zhetrd_hb2st", ctr, time );
     timer_printf( "  N= %10lld  nb= %5lld time zhetrd= %6.2f\n", (long long) n, (long long) nb, time_total );
 
     /* For eigenvalues only, call DSTERF.  For eigenvectors, first call
@@ -519,12 +523,15 @@ magma_zheevdx_2stage(
         }
 
         timer_start( time );
+        perfctr_start( ctr );
 
         magma_zbulge_back(uplo, n, nb, *m, Vblksiz, Z +ldz*(il-1), ldz, dZ, lddz,
                           V2, ldv, TAU2, T2, ldt, info);
 
+        perfctr_stop( ctr );
         timer_stop( time );
         timer_printf( "  N= %10lld  nb= %5lld time zbulge_back = %6.2f\n", (long long) n, (long long) nb, time );
+        perfctr_printf( "zbulge_back", ctr, time );
 
         magmaDoubleComplex *dA;
         magma_int_t ldda = n;
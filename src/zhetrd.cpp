@@ -13,6 +13,7 @@
 
 */
 #include "magma_internal.h"
+#include "magma_thread_budget.h"
 
 #define FAST_HEMV
 
@@ -223,8 +224,8 @@ magma_zhetrd(
     #endif
 
     #ifdef MAGMA_DISABLE_MKL_THREADING_ISSUE_BLAS1
-    magma_int_t lapack_nthread = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(lapack_nthread > 1 ? 2 : 1);
+    // in this thread only; restored on return
+    magma_blas_threads_scope blas_threads( magma_get_lapack_numthreads() > 1 ? 2 : 1 );
     #endif
 
     // nx <= n is required
@@ -345,8 +346,5 @@ magma_zhetrd(
     
     work[0] = magma_zmake_lwork( lwkopt );
 
-    #ifdef MAGMA_DISABLE_MKL_THREADING_ISSUE_BLAS1
-    magma_set_lapack_numthreads(lapack_nthread);
-    #endif
     return *info;
 } /* magma_zhetrd */
@@ -15,10 +15,8 @@
 #include "magma_internal.h"
 #include "magma_bulge.h"
 #include "magma_zbulge.h"
-
-#ifndef MAGMA_NOAFFINITY
-#include "affinity.h"
-#endif
+#include "magma_thread_budget.h"
+#include "trace.h"
 
 #define COMPLEX
 
@@ -57,6 +55,7 @@ typedef struct magma_zbulge_data_s {
     magma_int_t ldt;
     volatile magma_int_t *prog;
     pthread_barrier_t myptbarrier;
+    const magma_thread_region* region;
 } magma_zbulge_data;
 
 
@@ -196,12 +195,9 @@ magma_zhetrd_hb2st(
     real_Double_t timeblg=0.0;
     #endif
 
-    magma_int_t parallel_threads = magma_get_parallel_numthreads();
-    magma_int_t mklth   = magma_get_lapack_numthreads();
-    magma_int_t ompth   = magma_get_omp_numthreads();
-
-    //magma_set_omp_numthreads(1);
-    //magma_set_lapack_numthreads(1);
+    // reserves CPUs for the bulge-chasing threads, which use single-threaded BLAS
+    magma_thread_region region( "hetrd_hb2st", magma_get_parallel_numthreads() );
+    magma_int_t parallel_threads = region.num_threads();
 
     magma_int_t blkcnt, sizTAU2, sizT2, sizV2;
     magma_zbulge_getstg2size(n, nb, wantz, 
@@ -211,7 +207,7 @@ magma_zhetrd_hb2st(
     memset(TAU, 0, sizTAU2*sizeof(magmaDoubleComplex));
     memset(V,   0, sizV2*sizeof(magmaDoubleComplex));
 
-    magma_int_t INgrsiz=1;
+    magma_int_t INgrsiz = magma_get_zbulge_grsiz( n, nb, parallel_threads );
     magma_int_t nbtiles = magma_ceildiv(n, nb);
     volatile magma_int_t* prog;
     magma_malloc_cpu((void**) &prog, (2*nbtiles+parallel_threads+10)*sizeof(magma_int_t));
@@ -227,6 +223,7 @@ magma_zhetrd_hb2st(
     magma_zbulge_data data_bulge;
     magma_zbulge_data_init(&data_bulge, parallel_threads, n, nb, nbtiles, INgrsiz, Vblksiz, wantz,
                                  A, lda, V, ldv, TAU, T, ldt, prog);
+    data_bulge.region = &region;
 
     // Set one thread per core
     pthread_attr_init(&thread_attr);
@@ -263,8 +260,6 @@ magma_zhetrd_hb2st(
     magma_free_cpu((void *) prog);
     magma_zbulge_data_destroy(&data_bulge);
 
-    magma_set_omp_numthreads(ompth);
-    magma_set_lapack_numthreads(mklth);
     /*================================================
      *  store resulting diag and lower diag d and e
      *  note that d and e are always real
@@ -346,49 +341,8 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
     real_Double_t timeB=0.0, timeT=0.0;
     #endif
 
-    // with MKL and when using omp_set_num_threads instead of mkl_set_num_threads
-    // it need that all threads setting it to 1.
-    magma_set_omp_numthreads(1);
-    //magma_set_lapack_numthreads(1);
-
-/*
-#ifndef MAGMA_NOAFFINITY
-    // bind threads 
-    cpu_set_t set;
-    // bind threads 
-    CPU_ZERO( &set );
-    CPU_SET( my_core_id, &set );
-    sched_setaffinity( 0, sizeof(set), &set);
-#endif
-    magma_set_lapack_numthreads(1);
-    magma_set_omp_numthreads(1);
-
-*/
-
-#ifndef MAGMA_NOAFFINITY
-//#define PRINTAFFINITY
-#ifdef PRINTAFFINITY
-    affinity_set print_set;
-    print_set.print_affinity(my_core_id, "starting affinity");
-#endif
-    affinity_set original_set;
-    affinity_set new_set(my_core_id);
-    magma_int_t check  = 0;
-    magma_int_t check2 = 0;
-    // bind threads
-    check = original_set.get_affinity();
-    if (check == 0) {
-        check2 = new_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (single cpu)\n");
-    }
-    else {
-        printf("Error in sched_getaffinity\n");
-    }
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "set affinity");
-#endif
-#endif
+    // bind thread to its CPU, with single-threaded BLAS, until return
+    magma_thread_worker worker( *data->region, my_core_id );
 
     /* compute the Q1 overlapped with the bulge chasing+T.
     * if all_cores_num=1 it call Q1 on GPU and then bulgechasing.
@@ -403,8 +357,12 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
         timeB = magma_wtime();
     #endif
 
+    magma_trace_begin( "bulge", "bulge chasing" );
     magma_ztile_bulge_parallel(my_core_id, allcores_num, A, lda, V, ldv, TAU, n, nb, nbtiles, grsiz, Vblksiz, wantz, prog, myptbarrier);
+    magma_trace_end();
+    magma_trace_begin( "wait", "barrier" );
     if (allcores_num > 1) pthread_barrier_wait(myptbarrier);
+    magma_trace_end();
 
     #ifdef ENABLE_TIMER
     if (my_core_id == 0) {
@@ -422,8 +380,12 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
             timeT = magma_wtime();
         #endif
        
+        magma_trace_begin( "larft", "compute T" );
         magma_ztile_bulge_computeT_parallel(my_core_id, allcores_num, V, ldv, TAU, T, ldt, n, nb, Vblksiz);
+        magma_trace_end();
+        magma_trace_begin( "wait", "barrier" );
         if (allcores_num > 1) pthread_barrier_wait(myptbarrier);
+        magma_trace_end();
        
         #ifdef ENABLE_TIMER
         if (my_core_id == 0) {
@@ -433,18 +395,6 @@ static void *magma_zhetrd_hb2st_parallel_section(void *arg)
         #endif
     }
 
-#ifndef MAGMA_NOAFFINITY
-    // unbind threads
-    if (check == 0) {
-        check2 = original_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (restore cpu list)\n");
-    }
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "restored_affinity");
-#endif
-#endif
-
     return 0;
 }
 
@@ -498,11 +448,16 @@ do { \
     prog[(m)] = (val); \
 } while(0)
 
+// only actual waits are traced
 #define myss_cond_wait(m, n, val) \
 do { \
-    while (prog[(m)] != (val)) \
-    { \
-        magma_yield(); \
+    if (prog[(m)] != (val)) { \
+        magma_trace_begin( "wait", "dependency" ); \
+        while (prog[(m)] != (val)) \
+        { \
+            magma_yield(); \
+        } \
+        magma_trace_end(); \
     } \
 } while(0)
 
@@ -13,6 +13,7 @@
 */
 
 #include "magma_internal.h"
+#include "magma_thread_budget.h"
 #include "trace.h"
 
 
@@ -212,9 +213,8 @@ magma_zhetrd_he2hb(
         return *info;
     }
 
-    // limit to 16 threads
-    magma_int_t orig_threads = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads( min(orig_threads,16) );
+    // limit to 16 threads, in this thread only; restored on return
+    magma_blas_threads_scope blas_threads( min( magma_get_lapack_numthreads(), 16 ));
 
     /* Use the first panel of dA as work space */
     magmaDoubleComplex *dwork = dA + n*ldda;
@@ -436,7 +436,5 @@ magma_zhetrd_he2hb(
     magma_queue_destroy( queues[1] );
     magma_free( dA );
 
-    magma_set_lapack_numthreads( orig_threads );
-
     return *info;
 } /* magma_zhetrd_he2hb */
@@ -13,6 +13,7 @@
 
 */
 #include "magma_internal.h"
+#include "magma_thread_budget.h"
 #include "trace.h"
 
 /***************************************************************************//**
@@ -222,8 +223,8 @@ magma_zhetrd_mgpu(
     }
 
     #ifdef MAGMA_DISABLE_MKL_THREADING_ISSUE_BLAS1
-    magma_int_t lapack_nthread = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads(lapack_nthread > 1 ? 2 : 1);
+    // in this thread only; restored on return
+    magma_blas_threads_scope blas_threads( magma_get_lapack_numthreads() > 1 ? 2 : 1 );
     #endif
 
     magma_device_t orig_dev;
@@ -490,9 +491,6 @@ CLEANUP:
     
     work[0] = magma_zmake_lwork( lwkopt );
     
-    #ifdef MAGMA_DISABLE_MKL_THREADING_ISSUE_BLAS1
-    magma_set_lapack_numthreads(lapack_nthread);
-    #endif
 
     return *info;
 } /* magma_zhetrd */
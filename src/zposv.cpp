@@ -9,6 +9,7 @@
 
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 /***************************************************************************//**
     Purpose
@@ -80,6 +81,7 @@ magma_zposv(
     magmaDoubleComplex *B, magma_int_t ldb,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zposv", FLOPS_ZPOTRF( n ) + FLOPS_ZPOTRS( n, nrhs ) );
     #ifdef HAVE_clBLAS
     #define  dA(i_, j_)  dA, ((i_) + (j_)*ldda)
     #define  dB(i_, j_)  dB, ((i_) + (j_)*lddb)
@@ -8,6 +8,7 @@
        @precisions normal z -> s d c
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 /***************************************************************************//**
     Purpose
@@ -79,6 +80,7 @@ magma_zposv_gpu(
     magmaDoubleComplex_ptr dB, magma_int_t lddb,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zposv_gpu", FLOPS_ZPOTRF( n ) + FLOPS_ZPOTRS( n, nrhs ) );
     *info = 0;
     if ( uplo != MagmaUpper && uplo != MagmaLower )
         *info = -1;
@@ -9,6 +9,7 @@
        @precisions normal z -> s d c
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 // === Define what BLAS to use ============================================
     #undef  magma_ztrsm
@@ -80,6 +81,7 @@ magma_zpotrf(
     magmaDoubleComplex *A, magma_int_t lda,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zpotrf", FLOPS_ZPOTRF( n ) );
     #define  A(i_, j_)  (A + (i_) + (j_)*lda)
     
     #ifdef HAVE_clBLAS
@@ -13,6 +13,7 @@
        @precisions normal z -> s d c
 */
 #include "magma_internal.h"
+#include "magma_metrics.h"
 
 // === Define what BLAS to use ============================================
     #undef  magma_ztrsm
@@ -290,6 +291,7 @@ magma_zpotrf_gpu(
     magmaDoubleComplex_ptr dA, magma_int_t ldda,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zpotrf_gpu", FLOPS_ZPOTRF( n ) );
     magma_mode_t mode = MagmaHybrid;
     magma_zpotrf_LL_expert_gpu(uplo, n, dA, ldda, info, mode);
     return *info;
@@ -307,6 +309,7 @@ magma_zpotrf_native(
     magmaDoubleComplex_ptr dA, magma_int_t ldda,
     magma_int_t *info )
 {
+    MAGMA_METRICS( "magma_zpotrf_native", FLOPS_ZPOTRF( n ) );
     magma_mode_t mode = MagmaNative;
     magma_zpotrf_LL_expert_gpu(uplo, n, dA, ldda, info, mode);
     return *info;
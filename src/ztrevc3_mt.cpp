@@ -386,13 +386,11 @@ magma_int_t magma_ztrevc3_mt(
         rwork[j] = magma_cblas_dzasum( j, T(0,j), ione );
     }
 
-    // launch threads -- each single-threaded MKL
-    magma_int_t nthread = magma_get_parallel_numthreads();
-    magma_int_t lapack_nthread = magma_get_lapack_numthreads();
-    magma_set_lapack_numthreads( 1 );
+    // launch threads -- each single-threaded MKL, as is this thread
+    magma_blas_threads_scope blas_threads( 1 );
     magma_thread_queue queue;
-    queue.launch( nthread );
-    //printf( "nthread %lld, %lld\n", (long long) nthread, (long long) lapack_nthread );
+    queue.launch( magma_get_parallel_numthreads() );
+    magma_int_t nthread = queue.num_threads();  // may be fewer than requested
     
     // gemm_nb = N/thread, rounded up to multiple of 16,
     // but avoid multiples of page size, e.g., 512*8 bytes = 4096.
@@ -647,7 +645,6 @@ magma_int_t magma_ztrevc3_mt(
     
     // close down threads
     queue.quit();
-    magma_set_lapack_numthreads( lapack_nthread );
     
     return *info;
 }  // End of ZTREVC
@@ -13,11 +13,20 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#include <algorithm>  // before testings.h, which defines max, min
+
 #include "magma_v2.h"
 #include "testings.h"
 
@@ -37,6 +46,9 @@
 #elif defined(HAVE_HIP)
     const char* g_platform_str = "HIP";
 
+#elif defined(HAVE_HOST)
+    const char* g_platform_str = "host";
+
 #else
     #error "unknown platform"
 #endif
@@ -99,6 +111,18 @@ const char *usage =
 "  --align n        Round up LDDA on GPU to multiple of align, default 32.\n"
 "  --verbose        Verbose output.\n"
 "\n"
+"Benchmark mode applies to testers that use magma_bench, e.g., zgemm, zgetrf_gpu, zpotrf_gpu,\n"
+"zgesvd, zheevd; other testers reject these options, except --bind, and --[no]flush in testers\n"
+"that flush the cache, e.g., zgemv.\n"
+"  --bench          Benchmark: time each test bench-reps times, after bench-warmup untimed runs,\n"
+"                   and report the median time. Implies --flush.\n"
+"  --bench-warmup x Untimed runs before timing, default 1.\n"
+"  --bench-reps x   Timed runs, default 5.\n"
+"  --bench-output f Append a record per test, with min, median, mean, stddev, max times,\n"
+"                   and host and build metadata, to file f: CSV if f ends in .csv, else JSON Lines.\n"
+"  --[no]flush      Whether to flush the cache (see --cache) before each timed run.\n"
+"  --bind cpus      Bind all threads to CPU list, e.g., 0-15,32-47 (Linux only).\n"
+"\n"
 "The following options apply to only some routines.\n"
 "  --batch x        number of matrices for the batched routines, default 1000.\n"
 "  --cache x        cache size to flush, in MiB, default 2 MiB * NUM_THREADS.\n"
@@ -162,6 +186,7 @@ magma_opts::magma_opts( magma_opts_t flag )
     this->batchcount = 300;
     this->device   = 0;
     this->cache    = 2*1024*1024 * nt;  // assume 2 MiB per core
+    this->flush    = -1;  // set by parse_opts, unless a tester set it first
     this->align    = 32;
     this->nb       = 0;  // auto
     this->nrhs     = 1;
@@ -188,6 +213,11 @@ magma_opts::magma_opts( magma_opts_t flag )
     this->lapack    = (getenv("MAGMA_RUN_LAPACK")     != NULL);
     this->warmup    = (getenv("MAGMA_WARMUP")         != NULL);
 
+    this->bench_supported = false;
+    this->bench        = false;
+    this->bench_warmup = 1;
+    this->bench_reps   = 5;
+
     this->uplo      = MagmaLower;      // potrf, etc.
     this->transA    = MagmaNoTrans;    // gemm, etc.
     this->transB    = MagmaNoTrans;    // gemm
@@ -271,15 +301,154 @@ bool scan_range( char** handle, int* start, int* end, int* step )
 }
 
 
+// -----------------------------------------------------------------------------
+// Binds all threads of the process, including BLAS and OpenMP threads
+// already created, to the CPUs in list, e.g., "0-15,32-47".
+// Returns 0 on success, else an errno.
+static int bind_process( const char* list )
+{
+    #if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO( &mask );
+    const char* p = list;
+    while ( *p != '\0' ) {
+        char* end;
+        long first = strtol( p, &end, 10 );
+        long last  = first;
+        if ( end == p || first < 0 ) {
+            return EINVAL;
+        }
+        p = end;
+        if ( *p == '-' ) {
+            last = strtol( p+1, &end, 10 );
+            if ( end == p+1 || last < first ) {
+                return EINVAL;
+            }
+            p = end;
+        }
+        for( long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu ) {
+            CPU_SET( cpu, &mask );
+        }
+        if ( *p == ',' ) {
+            ++p;
+        }
+        else if ( *p != '\0' ) {
+            return EINVAL;
+        }
+    }
+    // each thread is a task of the process
+    DIR* dir = opendir( "/proc/self/task" );
+    if ( dir == NULL ) {
+        return (sched_setaffinity( 0, sizeof(mask), &mask ) == 0 ? 0 : errno);
+    }
+    int err = 0;
+    struct dirent* entry;
+    while ( (entry = readdir( dir )) != NULL ) {
+        pid_t tid = atoi( entry->d_name );
+        if ( tid > 0 && sched_setaffinity( tid, sizeof(mask), &mask ) != 0 ) {
+            err = errno;
+        }
+    }
+    closedir( dir );
+    return err;
+    #else
+    return ENOSYS;
+    #endif
+}
+
+
+// -----------------------------------------------------------------------------
+// If argv[*i] is a benchmark option, --[no]flush, or --bind, parses it and
+// its value, advancing *i past the value, sets *bench_arg or *flush_arg to
+// the option, and returns true; else returns false.
+bool magma_opts::parse_bench_arg(
+    int argc, char** argv, int* i,
+    const char** bench_arg, const char** flush_arg )
+{
+    const char* arg = argv[*i];
+    if      ( strcmp("--flush",    arg) == 0 ) { this->flush = 1; *flush_arg = arg; }
+    else if ( strcmp("--noflush",  arg) == 0 ) { this->flush = 0; *flush_arg = arg; }
+    else if ( strcmp("--bench",    arg) == 0 ) { this->bench = true; *bench_arg = arg; }
+    else if ( strcmp("--bench-warmup", arg) == 0 && *i+1 < argc ) {
+        *bench_arg = arg;
+        this->bench_warmup = atoi( argv[++*i] );
+        magma_assert( this->bench_warmup >= 0,
+                      "error: --bench-warmup %s is invalid; ensure bench-warmup >= 0.\n", argv[*i] );
+    }
+    else if ( strcmp("--bench-reps", arg) == 0 && *i+1 < argc ) {
+        *bench_arg = arg;
+        this->bench_reps = atoi( argv[++*i] );
+        magma_assert( this->bench_reps > 0,
+                      "error: --bench-reps %s is invalid; ensure bench-reps > 0.\n", argv[*i] );
+    }
+    else if ( strcmp("--bench-output", arg) == 0 && *i+1 < argc ) {
+        *bench_arg = arg;
+        this->bench_output = argv[++*i];
+    }
+    else if ( strcmp("--bind", arg) == 0 && *i+1 < argc ) {
+        this->bind = argv[++*i];
+        int err = bind_process( this->bind.c_str() );
+        magma_assert( err == 0, "error: --bind %s failed: %s.\n",
+                      argv[*i], strerror( err ));
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------
+// For testers with their own option parser, e.g., the sparse testers:
+// parses the benchmark options, --[no]flush, and --bind, and removes them
+// from argv, leaving the other arguments in order. Such testers use
+// magma_bench, so this sets bench_supported.
+void magma_opts::parse_bench_opts( int* argc, char** argv )
+{
+    const char* bench_arg = NULL;
+    const char* flush_arg = NULL;
+
+    this->bench_supported = true;
+    this->command = argv[0];
+    for( int i = 1; i < *argc; ++i ) {
+        this->command += " ";
+        this->command += argv[i];
+    }
+
+    int n = 1;
+    for( int i = 1; i < *argc; ++i ) {
+        if ( ! this->parse_bench_arg( *argc, argv, &i, &bench_arg, &flush_arg )) {
+            argv[ n++ ] = argv[i];
+        }
+    }
+    argv[ n ] = NULL;
+    *argc = n;
+
+    if ( this->flush < 0 ) {
+        this->flush = this->bench;
+    }
+}
+
+
+// -----------------------------------------------------------------------------
 // parse values from command line
 void magma_opts::parse_opts( int argc, char** argv )
 {
     printf( usage_short, argv[0] );
 
+    this->command = argv[0];
+    for( int i = 1; i < argc; ++i ) {
+        this->command += " ";
+        this->command += argv[i];
+    }
+
     magma_int_t ndevices;
     magma_device_t devices[ MagmaMaxGPUs ];
     magma_getdevices( devices, MagmaMaxGPUs, &ndevices );
 
+    const char* bench_arg = NULL;  // last benchmark option, see bench_supported
+    const char* flush_arg = NULL;  // last --[no]flush
+    bool flush_preset = (this->flush >= 0);
     this->ntest = 0;
     for( int i = 1; i < argc; ++i ) {
         // ----- problem size
@@ -487,6 +656,9 @@ void magma_opts::parse_opts( int argc, char** argv )
         else if ( strcmp("--warmup",   argv[i]) == 0 ) { this->warmup = true;  }
         else if ( strcmp("--nowarmup", argv[i]) == 0 ) { this->warmup = false; }
 
+        // ----- benchmark mode, --[no]flush, --bind
+        else if ( this->parse_bench_arg( argc, argv, &i, &bench_arg, &flush_arg )) {}
+
         //else if ( strcmp("--all",      argv[i]) == 0 ) { this->all    = true;  }
         //else if ( strcmp("--notall",   argv[i]) == 0 ) { this->all    = false; }
 
@@ -608,7 +780,22 @@ void magma_opts::parse_opts( int argc, char** argv )
         }
     }
 
+    if ( bench_arg != NULL && ! this->bench_supported ) {
+        fprintf( stderr, "error: %s is not supported by this tester, which does not use magma_bench\n",
+                 bench_arg );
+        exit(1);
+    }
+    // testers that flush the cache themselves preset opts.flush
+    if ( flush_arg != NULL && ! this->bench_supported && ! flush_preset ) {
+        fprintf( stderr, "error: %s is not supported by this tester, which does not flush the cache\n",
+                 flush_arg );
+        exit(1);
+    }
+
     // default values
+    if ( this->flush < 0 ) {
+        this->flush = this->bench;
+    }
     if ( this->svd_work.size() == 0 ) {
         this->svd_work.push_back( MagmaSVD_query );
     }
@@ -632,7 +819,7 @@ void magma_opts::parse_opts( int argc, char** argv )
     }
     assert( this->ntest <= MAX_NTEST );
 
-    #if defined(HAVE_CUBLAS) || defined(HAVE_HIP)
+    #if defined(HAVE_CUBLAS) || defined(HAVE_HIP) || defined(HAVE_HOST)
     magma_setdevice( this->device );
     #endif
 
@@ -650,6 +837,8 @@ void magma_opts::parse_opts( int argc, char** argv )
     #elif defined(HAVE_CUBLAS)
         // handle for directly calling cublas
         this->handle = magma_queue_get_cublas_handle( this->queue );
+    #elif defined(HAVE_HOST)
+        // host-emulated devices have no vendor BLAS handle
     #else
         #error "unknown platform"
     #endif
@@ -807,3 +996,375 @@ void magma_flush_cache( size_t cache_size )
 
     free( buf );
 }
+
+
+// -----------------------------------------------------------------------------
+// Sorts times, and returns their min, max, median, mean, and sample
+// standard deviation (0 for one time).
+magma_bench_stats magma_bench_summarize( std::vector< double >& times )
+{
+    magma_bench_stats stats;
+    memset( &stats, 0, sizeof(stats) );
+    size_t n = times.size();
+    stats.reps = n;
+    if ( n == 0 ) {
+        return stats;
+    }
+    std::sort( times.begin(), times.end() );
+    stats.min    = times[ 0 ];
+    stats.max    = times[ n-1 ];
+    stats.median = (n % 2 == 1 ? times[ n/2 ] : 0.5*(times[ n/2 - 1 ] + times[ n/2 ]));
+    double sum = 0;
+    for( size_t i = 0; i < n; ++i ) {
+        sum += times[i];
+    }
+    stats.mean = sum / n;
+    if ( n > 1 ) {
+        double sum2 = 0;
+        for( size_t i = 0; i < n; ++i ) {
+            sum2 += (times[i] - stats.mean) * (times[i] - stats.mean);
+        }
+        stats.stddev = sqrt( sum2 / (n - 1) );
+    }
+    return stats;
+}
+
+
+// -----------------------------------------------------------------------------
+// Appends s to out, quoted and escaped as a JSON string, or as a CSV field.
+static void bench_quote( std::string& out, const std::string& s, bool csv )
+{
+    out += '"';
+    for( size_t i = 0; i < s.size(); ++i ) {
+        char c = s[i];
+        if ( csv ) {
+            if ( c == '"' ) {
+                out += '"';
+            }
+            out += c;
+        }
+        else if ( c == '"' || c == '\\' ) {
+            out += '\\';
+            out += c;
+        }
+        else if ( (unsigned char) c < 0x20 ) {
+            char buf[ 8 ];
+            snprintf( buf, sizeof(buf), "\\u%04x", c );
+            out += buf;
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+
+// -----------------------------------------------------------------------------
+// Host and build metadata of benchmark records, as (name, value) pairs;
+// values are already quoted if strings.
+typedef std::vector< std::pair< std::string, std::string > > bench_fields;
+
+static void bench_add( bench_fields& fields, const char* name, const std::string& value, bool csv )
+{
+    std::string quoted;
+    bench_quote( quoted, value, csv );
+    fields.push_back( std::make_pair( std::string( name ), quoted ));
+}
+
+static void bench_add( bench_fields& fields, const char* name, double value, const char* format="%.6g" )
+{
+    char buf[ 64 ];
+    snprintf( buf, sizeof(buf), format, value );
+    fields.push_back( std::make_pair( std::string( name ), std::string( buf )));
+}
+
+static void bench_metadata( bench_fields& fields, const magma_opts& opts, bool csv )
+{
+    char buf[ 1024 ];
+
+    buf[0] = '\0';
+    #if defined(__linux__)
+    gethostname( buf, sizeof(buf) );
+    buf[ sizeof(buf)-1 ] = '\0';
+    #endif
+    bench_add( fields, "host", buf, csv );
+
+    // CPU model
+    std::string cpu;
+    FILE* file = fopen( "/proc/cpuinfo", "r" );
+    if ( file != NULL ) {
+        while ( fgets( buf, sizeof(buf), file ) != NULL ) {
+            if ( strncmp( buf, "model name", 10 ) == 0 ) {
+                const char* p = strchr( buf, ':' );
+                if ( p != NULL ) {
+                    p += strspn( p+1, " \t" ) + 1;
+                    cpu.assign( p, strcspn( p, "\n" ));
+                }
+                break;
+            }
+        }
+        fclose( file );
+    }
+    bench_add( fields, "cpu", cpu, csv );
+
+    // CPUs the process may run on, as a list, e.g., 0-15,32-47
+    std::string cpus;
+    int ncpus = 1;
+    #if defined(__linux__)
+    cpu_set_t mask;
+    if ( sched_getaffinity( 0, sizeof(mask), &mask ) == 0 ) {
+        ncpus = CPU_COUNT( &mask );
+        for( int i = 0; i < CPU_SETSIZE; ++i ) {
+            if ( CPU_ISSET( i, &mask )) {
+                int j = i;
+                while ( j+1 < CPU_SETSIZE && CPU_ISSET( j+1, &mask )) {
+                    ++j;
+                }
+                if ( ! cpus.empty() ) {
+                    cpus += ",";
+                }
+                if ( j > i )
+                    snprintf( buf, sizeof(buf), "%d-%d", i, j );
+                else
+                    snprintf( buf, sizeof(buf), "%d", i );
+                cpus += buf;
+                i = j;
+            }
+        }
+    }
+    #endif
+    bench_add( fields, "ncpus", ncpus, "%.0f" );
+    bench_add( fields, "cpus", cpus, csv );
+
+    int nthread = 1;
+    #ifdef _OPENMP
+    nthread = omp_get_max_threads();
+    #endif
+    bench_add( fields, "threads", nthread, "%.0f" );
+    bench_add( fields, "lapack_threads", magma_get_lapack_numthreads(), "%.0f" );
+
+    magma_int_t major, minor, micro;
+    magma_version( &major, &minor, &micro );
+    snprintf( buf, sizeof(buf), "%lld.%lld.%lld",
+              (long long) major, (long long) minor, (long long) micro );
+    bench_add( fields, "magma_version", buf, csv );
+    bench_add( fields, "platform", g_platform_str, csv );
+    bench_add( fields, "device", opts.device, "%.0f" );
+    bench_add( fields, "device_arch", magma_getdevice_arch(), "%.0f" );
+    bench_add( fields, "int_bits", 8*sizeof(magma_int_t), "%.0f" );
+    #if defined(__VERSION__)
+    bench_add( fields, "compiler", __VERSION__, csv );
+    #else
+    bench_add( fields, "compiler", "", csv );
+    #endif
+    #if defined(MAGMA_WITH_MKL)
+    bench_add( fields, "blas", "MKL", csv );
+    #else
+    bench_add( fields, "blas", "", csv );
+    #endif
+    bench_add( fields, "command", opts.command, csv );
+}
+
+
+// -----------------------------------------------------------------------------
+// Appends a record of a benchmark to opts.bench_output, if set: a JSON object
+// per line, or a CSV row, with a header if the file is new.
+// Host and build metadata are gathered once.
+void magma_bench_record(
+    magma_opts& opts, const char* routine,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    double gflop, const magma_bench_stats& stats, double error )
+{
+    if ( opts.bench_output.empty() ) {
+        return;
+    }
+    const std::string& path = opts.bench_output;
+    bool csv = (path.size() >= 4 && path.compare( path.size() - 4, 4, ".csv" ) == 0);
+
+    static bench_fields metadata;
+    if ( metadata.empty() ) {
+        bench_metadata( metadata, opts, csv );
+    }
+
+    char buf[ 64 ];
+    time_t now = time( NULL );
+    strftime( buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", localtime( &now ));
+
+    bench_fields fields;
+    bench_add( fields, "routine", routine, csv );
+    bench_add( fields, "m", m, "%.0f" );
+    bench_add( fields, "n", n, "%.0f" );
+    bench_add( fields, "k", k, "%.0f" );
+    bench_add( fields, "nb", opts.nb, "%.0f" );
+    bench_add( fields, "version", opts.version, "%.0f" );
+    bench_add( fields, "gflop", gflop );
+    bench_add( fields, "warmup", (opts.bench ? opts.bench_warmup : 0), "%.0f" );
+    bench_add( fields, "reps", stats.reps, "%.0f" );
+    bench_add( fields, "flush", opts.flush, "%.0f" );
+    bench_add( fields, "time_min",    stats.min    );
+    bench_add( fields, "time_median", stats.median );
+    bench_add( fields, "time_mean",   stats.mean   );
+    bench_add( fields, "time_stddev", stats.stddev );
+    bench_add( fields, "time_max",    stats.max    );
+    bench_add( fields, "gflops", (stats.median > 0 ? gflop / stats.median : 0) );
+    bench_add( fields, "error", error, "%.2e" );
+    bench_add( fields, "date", buf, csv );
+    fields.insert( fields.end(), metadata.begin(), metadata.end() );
+
+    FILE* file = fopen( path.c_str(), "a" );
+    if ( file == NULL ) {
+        fprintf( stderr, "Error: can't open benchmark output %s: %s\n",
+                 path.c_str(), strerror( errno ));
+        return;
+    }
+    std::string line;
+    if ( csv ) {
+        fseek( file, 0, SEEK_END );
+        if ( ftell( file ) == 0 ) {
+            for( size_t i = 0; i < fields.size(); ++i ) {
+                line += (i > 0 ? "," : "") + fields[i].first;
+            }
+            line += "\n";
+        }
+        for( size_t i = 0; i < fields.size(); ++i ) {
+            line += (i > 0 ? "," : "") + fields[i].second;
+        }
+    }
+    else {
+        line = "{";
+        for( size_t i = 0; i < fields.size(); ++i ) {
+            line += (i > 0 ? ", \"" : "\"") + fields[i].first + "\": " + fields[i].second;
+        }
+        line += "}";
+    }
+    fprintf( file, "%s\n", line.c_str() );
+    fclose( file );
+}
+
+
+// -----------------------------------------------------------------------------
+// Measures the roofline of the CPU with nthreads threads: the bandwidth of a
+// STREAM triad, a[i] = b[i] + s*c[i], on arrays 4x the last-level cache,
+// counting 24 bytes per element as STREAM does; and the rate of a dgemm.
+// Each is the best of several runs.
+magma_roofline_peak magma_roofline_measure( magma_int_t nthreads )
+{
+    magma_roofline_peak peak;
+    peak.nthreads = nthreads;
+    peak.stream   = 0;
+    peak.gemm     = 0;
+
+    long cache = 0;
+    #if defined(_SC_LEVEL3_CACHE_SIZE)
+    cache = sysconf( _SC_LEVEL3_CACHE_SIZE );
+    #endif
+    if ( cache <= 0 ) {
+        cache = 32*1024*1024;
+    }
+    size_t n = max( 4*cache / sizeof(double), size_t(1) << 21 );
+    double *a, *b, *c;
+    TESTING_CHECK( magma_dmalloc_cpu( &a, n ));
+    TESTING_CHECK( magma_dmalloc_cpu( &b, n ));
+    TESTING_CHECK( magma_dmalloc_cpu( &c, n ));
+
+    // first touch with the same schedule, so pages are local to threads
+    #pragma omp parallel for num_threads(nthreads) schedule(static)
+    for( size_t i = 0; i < n; ++i ) {
+        a[i] = 0;
+        b[i] = 1;
+        c[i] = 2;
+    }
+    const double scalar = 3;
+    for( int iter = 0; iter < 6; ++iter ) {
+        double time = magma_wtime();
+        #pragma omp parallel for num_threads(nthreads) schedule(static)
+        for( size_t i = 0; i < n; ++i ) {
+            a[i] = b[i] + scalar*c[i];
+        }
+        time = magma_wtime() - time;
+        if ( iter > 0 ) {  // first is warmup
+            peak.stream = max( peak.stream, 3*sizeof(double)*n / time / 1e9 );
+        }
+    }
+    magma_free_cpu( a );
+    magma_free_cpu( b );
+    magma_free_cpu( c );
+
+    // dgemm, with BLAS on nthreads threads
+    magma_int_t threads_save = magma_get_lapack_numthreads();
+    magma_set_lapack_numthreads( nthreads );
+    magma_int_t m = 1536;
+    double *A, *B, *C;
+    TESTING_CHECK( magma_dmalloc_cpu( &A, m*m ));
+    TESTING_CHECK( magma_dmalloc_cpu( &B, m*m ));
+    TESTING_CHECK( magma_dmalloc_cpu( &C, m*m ));
+    magma_int_t ione = 1, mm = m*m;
+    magma_int_t iseed[4] = { 0, 0, 0, 1 };
+    lapackf77_dlarnv( &ione, iseed, &mm, A );
+    lapackf77_dlarnv( &ione, iseed, &mm, B );
+    lapackf77_dlarnv( &ione, iseed, &mm, C );
+    const double one = 1;
+    for( int iter = 0; iter < 3; ++iter ) {
+        double time = magma_wtime();
+        blasf77_dgemm( "N", "N", &m, &m, &m, &one, A, &m, B, &m, &one, C, &m );
+        time = magma_wtime() - time;
+        peak.gemm = max( peak.gemm, 2.*m*m*m / time / 1e9 );
+    }
+    magma_free_cpu( A );
+    magma_free_cpu( B );
+    magma_free_cpu( C );
+    magma_set_lapack_numthreads( threads_save );
+    return peak;
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< magma_int_t > magma_thread_counts( magma_int_t max_threads )
+{
+    std::vector< magma_int_t > counts;
+    for( magma_int_t p = 1; p < max_threads; p *= 2 ) {
+        counts.push_back( p );
+    }
+    counts.push_back( max( 1, max_threads ));
+    return counts;
+}
+
+
+// -----------------------------------------------------------------------------
+void magma_roofline_header()
+{
+    printf( "%% roof is min( dgemm Gflop/s, flop/byte * STREAM GB/s ) for kernels with known flops,\n"
+            "%% else STREAM GB/s; bound is which term of the roof is smaller.\n"
+            "%%kernel                   size             threads     time (ms)   Gflop/s      GB/s  flop/byte  %% roof  bound\n"
+            "%%===============================================================================================================\n" );
+}
+
+
+// -----------------------------------------------------------------------------
+void magma_roofline_print(
+    const char* kernel, const char* size, const magma_roofline_peak& peak,
+    double time, double gflop, double gbyte )
+{
+    double gflops = (time > 0 ? gflop / time : 0);
+    double gbytes = (time > 0 ? gbyte / time : 0);
+    double intensity = (gbyte > 0 ? gflop / gbyte : 0);
+    double percent;
+    const char* bound;
+    if ( gflop > 0 && gbyte > 0 ) {
+        double mem_roof = intensity * peak.stream;
+        bound   = (mem_roof < peak.gemm ? "mem" : "flop");
+        percent = 100 * gflops / min( mem_roof, peak.gemm );
+    }
+    else if ( gflop > 0 ) {
+        bound   = "flop";
+        percent = 100 * gflops / peak.gemm;
+    }
+    else {
+        bound   = "mem";
+        percent = 100 * gbytes / peak.stream;
+    }
+    printf( " %-24s %-16s %7lld   %11.4f  %8.2f  %8.2f  %9.3f  %6.1f  %s\n",
+            kernel, size, (long long) peak.nthreads, 1000*time,
+            gflops, gbytes, intensity, percent, bound );
+}
@@ -0,0 +1,468 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "magma_v2.h"
+#include "magma_lapack.h"
+
+
+/******************************************************************************/
+// warn( condition ) is like assert, but doesn't abort. Also counts number of failures.
+magma_int_t gFailures = 0;
+
+void warn_helper( int cond, const char* str, const char* file, int line )
+{
+    if ( ! cond ) {
+        printf( "*** testing_cpu_queue error: %s:%d: assertion %s failed\n", file, line, str );
+        gFailures += 1;
+    }
+}
+
+#define warn(x) warn_helper( (x), #x, __FILE__, __LINE__ )
+
+
+/******************************************************************************/
+// Tasks in one queue run in submission order, one at a time, even if earlier
+// tasks take longer.
+struct order_arg
+{
+    int               index;
+    std::vector<int>* order;
+    std::atomic<int>* running;
+    bool              overlap;
+};
+
+magma_int_t order_task( void* arg )
+{
+    order_arg* a = (order_arg*) arg;
+    a->overlap = (a->running->fetch_add( 1 ) != 0);
+    std::this_thread::sleep_for( std::chrono::microseconds( (a->index % 3 == 0) ? 2000 : 10 ));
+    a->order->push_back( a->index );
+    a->running->fetch_sub( 1 );
+    return 0;
+}
+
+void test_order()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    const int ntasks = 100;
+    std::vector<int> order;
+    std::atomic<int> running( 0 );
+    std::vector< order_arg > args( ntasks );
+    magma_cpu_task_t first = NULL, last = NULL;
+
+    magma_cpu_queue_t queue;
+    warn( magma_cpu_queue_create( 1, &queue ) == MAGMA_SUCCESS );
+    for( int i = 0; i < ntasks; ++i ) {
+        args[i].index   = i;
+        args[i].order   = &order;
+        args[i].running = &running;
+        args[i].overlap = false;
+        warn( magma_cpu_task_submit( queue, order_task, &args[i], 0, NULL,
+                                     (i == 0 ? &first : i == ntasks-1 ? &last : NULL) )
+              == MAGMA_SUCCESS );
+    }
+    warn( magma_cpu_task_wait( first ) == 0 );
+    warn( magma_cpu_task_query( first ) == 1 );
+    magma_cpu_queue_sync( queue );
+    warn( magma_cpu_task_query( last ) == 1 );
+
+    bool in_order = ((int) order.size() == ntasks);
+    bool overlap  = false;
+    for( int i = 0; i < ntasks && in_order; ++i ) {
+        in_order = (order[i] == i);
+        overlap  = overlap || args[i].overlap;
+    }
+    printf( "%d tasks: %s, %s\n", ntasks, (in_order ? "in order" : "out of order"),
+            (overlap ? "overlapped" : "one at a time") );
+    warn( in_order );
+    warn( ! overlap );
+
+    magma_cpu_task_destroy( first );
+    magma_cpu_task_destroy( last );
+    magma_cpu_queue_destroy( queue );
+}
+
+
+/******************************************************************************/
+// Tasks in different queues run concurrently; a dependency on a task in
+// another queue delays only the dependent task.
+struct notice
+{
+    std::mutex              mutex;
+    std::condition_variable cv;
+    bool                    set;
+
+    notice(): set( false ) {}
+
+    void post()
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        set = true;
+        cv.notify_all();
+    }
+
+    // returns false on timeout, e.g., if the poster can't run concurrently
+    bool wait()
+    {
+        std::unique_lock< std::mutex > lock( mutex );
+        return cv.wait_for( lock, std::chrono::seconds( 10 ), [this] { return set; });
+    }
+};
+
+struct deps_arg
+{
+    notice*           started;  // posted by the task in the other queue
+    std::atomic<int>* stage;
+    int               seen;
+};
+
+// waits for the task in the other queue to start, so both must run at once
+magma_int_t deps_producer( void* arg )
+{
+    deps_arg* a = (deps_arg*) arg;
+    bool concurrent = a->started->wait();
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ));
+    a->stage->store( 1 );
+    return (concurrent ? 0 : -1);
+}
+
+magma_int_t deps_independent( void* arg )
+{
+    deps_arg* a = (deps_arg*) arg;
+    a->started->post();
+    a->seen = a->stage->load();
+    return 0;
+}
+
+magma_int_t deps_consumer( void* arg )
+{
+    deps_arg* a = (deps_arg*) arg;
+    a->seen = a->stage->load();
+    a->stage->store( 2 );
+    return 0;
+}
+
+void test_deps()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    notice started;
+    std::atomic<int> stage( 0 );
+    deps_arg producer    = { &started, &stage, -1 };
+    deps_arg independent = { &started, &stage, -1 };
+    deps_arg consumer    = { &started, &stage, -1 };
+
+    magma_cpu_queue_t q1, q2;
+    magma_cpu_task_t tp, ti, tc;
+    warn( magma_cpu_queue_create( 0, &q1 ) == MAGMA_SUCCESS );
+    warn( magma_cpu_queue_create( 0, &q2 ) == MAGMA_SUCCESS );
+    warn( magma_cpu_task_submit( q1, deps_producer,    &producer,    0, NULL, &tp ) == 0 );
+    warn( magma_cpu_task_submit( q2, deps_independent, &independent, 0, NULL, &ti ) == 0 );
+    warn( magma_cpu_task_submit( q2, deps_consumer,    &consumer,    1, &tp,  &tc ) == 0 );
+
+    // the handle of a dependency may be destroyed before it runs
+    magma_cpu_task_destroy( tp );
+
+    warn( magma_cpu_task_wait( tc ) == 0 );
+    printf( "independent task saw stage %d, dependent task saw stage %d\n",
+            independent.seen, consumer.seen );
+    warn( independent.seen == 0 );  // ran while producer waited for it
+    warn( consumer.seen == 1 );     // ran after producer
+    warn( stage.load() == 2 );
+    warn( magma_cpu_task_wait( ti ) == 0 );
+
+    magma_cpu_task_destroy( ti );
+    magma_cpu_task_destroy( tc );
+    magma_cpu_queue_destroy( q1 );
+    magma_cpu_queue_destroy( q2 );
+}
+
+
+/******************************************************************************/
+// magma_cpu_task_wait returns the info of the task's function; a dependent
+// task still runs, and can get the info of its dependency.
+struct info_arg
+{
+    magma_int_t      info;
+    magma_cpu_task_t dep;
+};
+
+magma_int_t info_task( void* arg )
+{
+    info_arg* a = (info_arg*) arg;
+    if ( a->dep != NULL ) {
+        // dependency finished before this started, so this doesn't block
+        warn( magma_cpu_task_query( a->dep ) == 1 );
+        return a->info + magma_cpu_task_wait( a->dep );
+    }
+    return a->info;
+}
+
+void test_info()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_cpu_queue_t q1, q2;
+    magma_cpu_task_t t1, t2, t3;
+    info_arg a1 = { -7,  NULL };
+    info_arg a2 = { 100, NULL };
+    info_arg a3 = { 0,   NULL };
+    warn( magma_cpu_queue_create( 0, &q1 ) == MAGMA_SUCCESS );
+    warn( magma_cpu_queue_create( 0, &q2 ) == MAGMA_SUCCESS );
+    warn( magma_cpu_task_submit( q1, info_task, &a1, 0, NULL, &t1 ) == 0 );
+    a2.dep = t1;
+    warn( magma_cpu_task_submit( q2, info_task, &a2, 1, &t1, &t2 ) == 0 );
+    warn( magma_cpu_task_submit( q1, info_task, &a3, 0, NULL, &t3 ) == 0 );
+
+    magma_int_t info1 = magma_cpu_task_wait( t1 );
+    magma_int_t info2 = magma_cpu_task_wait( t2 );
+    magma_int_t info3 = magma_cpu_task_wait( t3 );
+    printf( "info %lld, dependent %lld, next in queue %lld\n",
+            (long long) info1, (long long) info2, (long long) info3 );
+    warn( info1 == -7 );
+    warn( info2 == 93 );
+    warn( info3 == 0 );
+    warn( magma_cpu_task_wait( t1 ) == -7 );  // again
+
+    // invalid arguments are reported, and nothing is queued
+    magma_cpu_task_t bad = t1;
+    printf( "expect 2 errors from magma_cpu_task_submit:\n" );
+    warn( magma_cpu_task_submit( q1, NULL, NULL, 0, NULL, &bad ) == -2 );
+    warn( magma_cpu_task_submit( q1, info_task, &a3, -1, NULL, &bad ) == -4 );
+    warn( bad == t1 );
+
+    magma_cpu_task_destroy( t1 );
+    magma_cpu_task_destroy( t2 );
+    magma_cpu_task_destroy( t3 );
+    magma_cpu_queue_destroy( q1 );
+    magma_cpu_queue_destroy( q2 );
+}
+
+
+/******************************************************************************/
+// A task queued after magma_cpu_queue_wait_event runs after the device work
+// recorded before the event.
+struct event_arg
+{
+    magma_int_t     n;
+    magmaDouble_ptr dx;
+    double*         y;
+    magma_queue_t   queue;
+};
+
+magma_int_t event_task( void* arg )
+{
+    event_arg* a = (event_arg*) arg;
+    magma_dgetvector( a->n, a->dx, 1, a->y, 1, a->queue );
+    return 0;
+}
+
+void test_event()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    const magma_int_t n = 4*1024*1024;
+    const int ncopies = 16;
+    double *x, *y;
+    magmaDouble_ptr dx;
+    magma_dmalloc_cpu( &x, n );
+    magma_dmalloc_cpu( &y, n );
+    magma_dmalloc( &dx, n );
+
+    magma_device_t cdev;
+    magma_queue_t dqueue, dqueue2;
+    magma_event_t event;
+    magma_getdevice( &cdev );
+    magma_queue_create( cdev, &dqueue );
+    magma_queue_create( cdev, &dqueue2 );
+    magma_event_create( &event );
+
+    magma_cpu_queue_t queue;
+    magma_cpu_task_t task;
+    event_arg arg = { n, dx, y, dqueue2 };
+    warn( magma_cpu_queue_create( 0, &queue ) == MAGMA_SUCCESS );
+
+    // device work long enough that without waiting, the task would see the
+    // values of dx before the last copy
+    double *x0;
+    magma_dmalloc_cpu( &x0, n );
+    for( magma_int_t i = 0; i < n; ++i ) {
+        x0[i] = 0;
+        x[i]  = i;
+    }
+    magma_dsetvector( n, x0, 1, dx, 1, dqueue );
+    for( int k = 0; k < ncopies; ++k ) {
+        magma_dsetvector_async( n, x0, 1, dx, 1, dqueue );
+    }
+    magma_dsetvector_async( n, x, 1, dx, 1, dqueue );
+    magma_event_record( event, dqueue );
+    warn( magma_cpu_queue_wait_event( queue, event ) == MAGMA_SUCCESS );
+    warn( magma_cpu_task_submit( queue, event_task, &arg, 0, NULL, &task ) == 0 );
+    warn( magma_cpu_task_wait( task ) == 0 );
+
+    magma_int_t errors = 0;
+    for( magma_int_t i = 0; i < n; ++i ) {
+        errors += (y[i] != x[i]);
+    }
+    printf( "%lld of %lld entries differ\n", (long long) errors, (long long) n );
+    warn( errors == 0 );
+
+    magma_cpu_task_destroy( task );
+    magma_cpu_queue_destroy( queue );
+    magma_event_destroy( event );
+    magma_queue_destroy( dqueue );
+    magma_queue_destroy( dqueue2 );
+    magma_free( dx );
+    magma_free_cpu( x0 );
+    magma_free_cpu( x );
+    magma_free_cpu( y );
+}
+
+
+/******************************************************************************/
+// Two eigenvalue problems of symmetric tridiagonal matrices, solved by
+// dsterf in two queues, and checked by a task depending on both. Each queue
+// reserves CPUs, which its tasks see as their budget.
+struct tridiag_arg
+{
+    magma_int_t n;
+    double      shift;
+    double*     d;
+    double*     e;
+    magma_int_t budget;
+};
+
+magma_int_t sterf_task( void* arg )
+{
+    tridiag_arg* a = (tridiag_arg*) arg;
+    magma_int_t info;
+    a->budget = magma_thread_budget_available();
+    for( magma_int_t i = 0; i < a->n; ++i ) {
+        a->d[i] = 2 + a->shift;
+        a->e[i] = -1;
+    }
+    lapackf77_dsterf( &a->n, a->d, a->e, &info );
+    return info;
+}
+
+// the eigenvalues of tridiag( -1, 2 + shift, -1 ) are
+// 2 + shift - 2 cos( k pi / (n+1) ), k = 1, ..., n, in ascending order
+struct check_arg
+{
+    tridiag_arg* problems;
+    int          nproblems;
+    double       error;
+};
+
+magma_int_t check_task( void* arg )
+{
+    check_arg* a = (check_arg*) arg;
+    a->error = 0;
+    for( int p = 0; p < a->nproblems; ++p ) {
+        tridiag_arg& t = a->problems[p];
+        for( magma_int_t k = 1; k <= t.n; ++k ) {
+            double exact = 2 + t.shift - 2*cos( k * 3.14159265358979323846 / (t.n + 1) );
+            a->error = std::max( a->error, fabs( t.d[k-1] - exact ));
+        }
+    }
+    return 0;
+}
+
+void test_stages()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    const magma_int_t n = 2000;
+    magma_int_t available = magma_thread_budget_available();
+    magma_int_t half = std::max( magma_int_t(1), available / 2 );
+
+    tridiag_arg problems[2];
+    for( int p = 0; p < 2; ++p ) {
+        problems[p].n      = n;
+        problems[p].shift  = p;
+        problems[p].budget = 0;
+        magma_dmalloc_cpu( &problems[p].d, n );
+        magma_dmalloc_cpu( &problems[p].e, n );
+    }
+    check_arg check = { problems, 2, -1 };
+
+    magma_cpu_queue_t q1, q2;
+    magma_cpu_task_t t1, t2, t3;
+    warn( magma_cpu_queue_create( half, &q1 ) == MAGMA_SUCCESS );
+    warn( magma_cpu_queue_create( half, &q2 ) == MAGMA_SUCCESS );
+    magma_int_t left = magma_thread_budget_available();
+    warn( magma_cpu_task_submit( q1, sterf_task, &problems[0], 0, NULL, &t1 ) == 0 );
+    warn( magma_cpu_task_submit( q2, sterf_task, &problems[1], 0, NULL, &t2 ) == 0 );
+    magma_cpu_task_t deps[2] = { t1, t2 };
+    warn( magma_cpu_task_submit( q1, check_task, &check, 2, deps, &t3 ) == 0 );
+
+    warn( magma_cpu_task_wait( t3 ) == 0 );
+    warn( magma_cpu_task_wait( t1 ) == 0 );
+    warn( magma_cpu_task_wait( t2 ) == 0 );
+    printf( "%lld CPUs available; queues of %lld CPUs see budgets %lld and %lld,"
+            " %lld left; eigenvalue error %.2e\n",
+            (long long) available, (long long) half,
+            (long long) problems[0].budget, (long long) problems[1].budget,
+            (long long) left, check.error );
+    warn( check.error >= 0 && check.error < 1e-12 );
+    // disjoint reservations: each queue gets up to half, the rest is left
+    warn( problems[0].budget >= 1 && problems[0].budget <= half );
+    warn( problems[1].budget >= 1 && problems[1].budget <= half );
+    if ( available >= 2 ) {
+        warn( problems[0].budget == half && problems[1].budget == half );
+        warn( left == std::max( magma_int_t(1), available - 2*half ));
+    }
+
+    magma_cpu_task_destroy( t1 );
+    magma_cpu_task_destroy( t2 );
+    magma_cpu_task_destroy( t3 );
+    magma_cpu_queue_destroy( q1 );
+    magma_cpu_queue_destroy( q2 );
+    warn( magma_thread_budget_available() == available );  // released
+
+    for( int p = 0; p < 2; ++p ) {
+        magma_free_cpu( problems[p].d );
+        magma_free_cpu( problems[p].e );
+    }
+}
+
+
+/******************************************************************************/
+int main( int argc, char** argv )
+{
+    magma_init();
+
+    test_order();
+    test_deps();
+    test_info();
+    test_event();
+    test_stages();
+
+    if ( gFailures > 0 ) {
+        printf( "\n*** %lld tests failed.\n", (long long) gFailures );
+    }
+    else {
+        printf( "\nAll tests passed.\n" );
+    }
+
+    magma_finalize();
+    return (gFailures > 0);
+}
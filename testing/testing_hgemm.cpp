@@ -230,6 +230,7 @@ int main( int argc, char** argv)
     const magmaHalf h_beta  = approx_float_to_half(beta);
     #endif
     magma_opts opts;
+    opts.flush = 1;  // always flush cache before timing, unless --noflush
     opts.parse_opts( argc, argv );
     
     // Allow 3*eps; real needs 2*sqrt(2) factor; see Higham, 2002, sec. 3.6.
@@ -308,7 +309,9 @@ int main( int argc, char** argv)
                =================================================================== */
             #if defined(HAVE_CUBLAS)
                 /* TODO: add support for HIP platform */
-                magma_flush_cache( opts.cache );
+                if ( opts.flush ) {
+                    magma_flush_cache( opts.cache );
+                }
                 dev_time = magma_sync_wtime( opts.queue );
 
                 magma_hgemm( opts.transA, opts.transB, M, N, K,
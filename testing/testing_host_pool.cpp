@@ -0,0 +1,343 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#include "magma_v2.h"
+
+
+/******************************************************************************/
+// warn( condition ) is like assert, but doesn't abort. Also counts number of failures.
+magma_int_t gFailures = 0;
+
+void warn_helper( int cond, const char* str, const char* file, int line )
+{
+    if ( ! cond ) {
+        printf( "*** testing_host_pool error: %s:%d: assertion %s failed\n", file, line, str );
+        gFailures += 1;
+    }
+}
+
+#define warn(x) warn_helper( (x), #x, __FILE__, __LINE__ )
+
+
+/******************************************************************************/
+const size_t KiB = 1024;
+const size_t MiB = 1024*1024;
+
+size_t live_bytes()
+{
+    size_t live;
+    magma_host_pool_stats( &live, NULL, NULL );
+    return live;
+}
+
+size_t mapped_bytes()
+{
+    size_t mapped;
+    magma_host_pool_stats( NULL, NULL, &mapped );
+    return mapped;
+}
+
+// fills size bytes of ptr with a pattern depending on tag
+void fill( void* ptr, size_t size, int tag )
+{
+    unsigned char* p = (unsigned char*) ptr;
+    for( size_t i = 0; i < size; ++i ) {
+        p[i] = (unsigned char) (tag + i/64);
+    }
+}
+
+// checks the pattern written by fill
+bool check( const void* ptr, size_t size, int tag )
+{
+    const unsigned char* p = (const unsigned char*) ptr;
+    for( size_t i = 0; i < size; ++i ) {
+        if ( p[i] != (unsigned char) (tag + i/64) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/******************************************************************************/
+// Statistics: live grows by the class size of each block, peak bounds live,
+// and freeing restores live. A freed small block is reused by the next
+// request of its class from the same thread.
+void test_stats()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    const size_t sizes[] = { 1, 64, 65, 500, 513, 3000, 100*KiB, 256*KiB, 300*KiB, 5*MiB };
+    const int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    void* ptrs[ nsizes ];
+
+    size_t live0 = live_bytes();
+    size_t total = 0;
+    for( int i = 0; i < nsizes; ++i ) {
+        size_t before = live_bytes();
+        warn( magma_malloc_cpu( &ptrs[i], sizes[i] ) == MAGMA_SUCCESS );
+        size_t delta = live_bytes() - before;
+        total += delta;
+        printf( "size %8lld: block %8lld, aligned %d\n",
+                (long long) sizes[i], (long long) delta, (uintptr_t( ptrs[i] ) % 64 == 0) );
+        warn( uintptr_t( ptrs[i] ) % 64 == 0 );
+        if ( sizes[i] <= 256*KiB ) {
+            // size classes are at most 25% apart
+            warn( delta >= sizes[i] && delta <= sizes[i] + sizes[i]/4 + 64 );
+        }
+        else {
+            // own mapping of whole 2 MiB chunks
+            warn( delta > sizes[i] && delta % (2*MiB) == 0 && delta - sizes[i] <= 2*MiB );
+        }
+        fill( ptrs[i], sizes[i], i );
+    }
+
+    size_t live, peak;
+    magma_host_pool_stats( &live, &peak, NULL );
+    warn( live == live0 + total );
+    warn( peak >= live );
+    for( int i = 0; i < nsizes; ++i ) {
+        warn( check( ptrs[i], sizes[i], i ) );
+        magma_free_cpu( ptrs[i] );
+    }
+    magma_host_pool_stats( &live, &peak, NULL );
+    warn( live == live0 );
+    warn( peak >= live0 + total );
+
+    void* p1;
+    void* p2;
+    magma_malloc_cpu( &p1, 3000 );
+    magma_free_cpu( p1 );
+    magma_malloc_cpu( &p2, 2900 );  // same class
+    warn( p1 == p2 );
+    magma_free_cpu( p2 );
+}
+
+
+/******************************************************************************/
+// Large blocks: a freed mapping is reused for a request needing at least half
+// of it, without mapping more memory, and returned by magma_host_pool_trim.
+void test_large()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_host_pool_trim();
+    size_t mapped0 = mapped_bytes();
+
+    void* p1;
+    warn( magma_malloc_cpu( &p1, 5*MiB ) == MAGMA_SUCCESS );
+    size_t mapped1 = mapped_bytes();
+    warn( mapped1 > mapped0 );
+    fill( p1, 5*MiB, 1 );
+    magma_free_cpu( p1 );
+    warn( mapped_bytes() == mapped1 );  // cached
+
+    void* p2;
+    warn( magma_malloc_cpu( &p2, 3*MiB ) == MAGMA_SUCCESS );
+    printf( "5 MiB block %p, 3 MiB block %p; mapped %.1f MiB -> %.1f MiB\n",
+            p1, p2, mapped1 / double(MiB), mapped_bytes() / double(MiB) );
+    warn( p2 == p1 );
+    warn( mapped_bytes() == mapped1 );
+    fill( p2, 3*MiB, 2 );
+    warn( check( p2, 3*MiB, 2 ) );
+    magma_free_cpu( p2 );
+
+    // too small to reuse a 6 MiB mapping
+    void* p3;
+    warn( magma_malloc_cpu( &p3, 1*MiB ) == MAGMA_SUCCESS );
+    warn( p3 != p1 );
+    warn( mapped_bytes() > mapped1 );
+    magma_free_cpu( p3 );
+
+    magma_host_pool_trim();
+    printf( "after trim: mapped %.1f MiB\n", mapped_bytes() / double(MiB) );
+    warn( mapped_bytes() == mapped0 );
+}
+
+
+/******************************************************************************/
+// Each thread allocates and frees blocks of varying sizes, checking no block
+// is overwritten by another, and hands half of its blocks to the main thread,
+// which frees them after the thread has exited.
+void worker( int id, int iters, std::vector< void* >* keep )
+{
+    const int nlive = 32;
+    void*  ptrs [ nlive ] = { NULL };
+    size_t sizes[ nlive ] = { 0 };
+    unsigned seed = 1 + id;
+    for( int it = 0; it < iters; ++it ) {
+        int k = it % nlive;
+        if ( ptrs[k] != NULL ) {
+            warn( check( ptrs[k], sizes[k], id*nlive + k ) );
+            magma_free_cpu( ptrs[k] );
+        }
+        seed = seed*1103515245 + 12345;
+        sizes[k] = 1 + (seed >> 8) % (it % 97 == 0 ? 400*KiB : 16*KiB);
+        warn( magma_malloc_cpu( &ptrs[k], sizes[k] ) == MAGMA_SUCCESS );
+        fill( ptrs[k], sizes[k], id*nlive + k );
+    }
+    for( int k = 0; k < nlive; ++k ) {
+        warn( check( ptrs[k], sizes[k], id*nlive + k ) );
+        if ( k % 2 == 0 ) {
+            magma_free_cpu( ptrs[k] );
+        }
+        else {
+            keep->push_back( ptrs[k] );
+            keep->push_back( (void*) sizes[k] );
+        }
+    }
+}
+
+void test_threads( int nthreads, int iters )
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    size_t live0 = live_bytes();
+    std::vector< std::vector< void* > > keep( nthreads );
+    std::vector< std::thread > threads;
+    for( int t = 0; t < nthreads; ++t ) {
+        threads.push_back( std::thread( worker, t, iters, &keep[t] ));
+    }
+    for( int t = 0; t < nthreads; ++t ) {
+        threads[t].join();
+    }
+    // blocks freed by another thread than the one allocating them
+    const int nlive = 32;
+    for( int t = 0; t < nthreads; ++t ) {
+        for( size_t i = 0; i < keep[t].size(); i += 2 ) {
+            int k = 2*int(i/2) + 1;
+            warn( check( keep[t][i], (size_t) keep[t][i+1], t*nlive + k ) );
+            magma_free_cpu( keep[t][i] );
+        }
+    }
+    size_t live, peak;
+    magma_host_pool_stats( &live, &peak, NULL );
+    printf( "%d threads, %d allocations each: live %lld bytes, peak %.1f MiB\n",
+            nthreads, iters, (long long) (live - live0), peak / double(MiB) );
+    warn( live == live0 );
+}
+
+
+/******************************************************************************/
+// Memory allocated from the pool is freed correctly after the pool is
+// disabled, and memory allocated while it is disabled after it is enabled.
+void test_disable()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    size_t live0 = live_bytes();
+    void* small;
+    void* large;
+    magma_malloc_cpu( &small, 1000 );
+    magma_malloc_cpu( &large, 1*MiB );
+    fill( small, 1000, 3 );
+    fill( large, 1*MiB, 4 );
+    warn( live_bytes() > live0 );
+
+    magma_host_pool_enable( 0, 0 );
+    void* plain;
+    warn( magma_malloc_cpu( &plain, 1000 ) == MAGMA_SUCCESS );
+    warn( live_bytes() > live0 );
+    fill( plain, 1000, 5 );
+    warn( check( small, 1000, 3 ) );
+    warn( check( large, 1*MiB, 4 ) );
+    magma_free_cpu( small );
+    magma_free_cpu( large );
+    warn( live_bytes() == live0 );
+
+    magma_host_pool_enable( MagmaHostPoolEnable, 0 );
+    warn( check( plain, 1000, 5 ) );
+    magma_free_cpu( plain );
+    warn( live_bytes() == live0 );
+}
+
+
+/******************************************************************************/
+// Time of an alloc, touch, free loop resembling a solver iteration: a few
+// vectors and small workspaces per iteration, with and without the pool.
+// Only reports the times; the ratio depends on the system.
+double time_loop( int iters, size_t n )
+{
+    double time = magma_wtime();
+    for( int it = 0; it < iters; ++it ) {
+        double* v[4];
+        double* w[8];
+        for( int i = 0; i < 4; ++i ) {
+            magma_dmalloc_cpu( &v[i], n );
+            for( size_t j = 0; j < n; j += 512 ) {
+                v[i][j] = j;
+            }
+        }
+        for( int i = 0; i < 8; ++i ) {
+            magma_dmalloc_cpu( &w[i], 64*(i + 1) );
+            w[i][0] = i;
+        }
+        for( int i = 0; i < 8; ++i ) {
+            magma_free_cpu( w[i] );
+        }
+        for( int i = 0; i < 4; ++i ) {
+            magma_free_cpu( v[i] );
+        }
+    }
+    return magma_wtime() - time;
+}
+
+void test_speed( int iters )
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    const size_t ns[] = { 1000, 100000, 1000000 };
+    printf( "%9s   %12s   %12s   %7s\n", "n", "malloc (ms)", "pool (ms)", "speedup" );
+    for( int i = 0; i < 3; ++i ) {
+        magma_host_pool_enable( 0, 0 );
+        time_loop( 1, ns[i] );
+        double t_malloc = time_loop( iters, ns[i] );
+        magma_host_pool_enable( MagmaHostPoolEnable, 0 );
+        time_loop( 1, ns[i] );
+        double t_pool = time_loop( iters, ns[i] );
+        printf( "%9lld   %12.2f   %12.2f   %7.1f\n",
+                (long long) ns[i], t_malloc*1e3, t_pool*1e3, t_malloc / t_pool );
+    }
+}
+
+
+/******************************************************************************/
+int main( int argc, char** argv )
+{
+    magma_init();
+
+    if ( magma_host_pool_enable( MagmaHostPoolEnable, 0 ) != MAGMA_SUCCESS ) {
+        printf( "host pool not supported; skipping tests.\n" );
+        magma_finalize();
+        return 0;
+    }
+
+    test_stats();
+    test_large();
+    test_threads( 8, 2000 );
+    test_disable();
+    test_speed( 200 );
+    magma_host_pool_print();
+
+    if ( gFailures > 0 ) {
+        printf( "\n*** %lld tests failed.\n", (long long) gFailures );
+    }
+    else {
+        printf( "\nAll tests passed.\n" );
+    }
+
+    magma_finalize();
+    return (gFailures > 0);
+}
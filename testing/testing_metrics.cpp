@@ -0,0 +1,375 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "flops.h"
+
+
+/******************************************************************************/
+// warn( condition ) is like assert, but doesn't abort. Also counts number of failures.
+magma_int_t gFailures = 0;
+
+void warn_helper( int cond, const char* str, const char* file, int line )
+{
+    if ( ! cond ) {
+        printf( "*** testing_metrics error: %s:%d: assertion %s failed\n", file, line, str );
+        gFailures += 1;
+    }
+}
+
+#define warn(x) warn_helper( (x), #x, __FILE__, __LINE__ )
+
+
+/******************************************************************************/
+std::string snapshot( bool json )
+{
+    magma_int_t len = magma_metrics_snapshot( NULL, 0, json );
+    std::vector< char > buf( len + 1 );
+    warn( magma_metrics_snapshot( &buf[0], buf.size(), json ) == len );
+    warn( buf[ len ] == '\0' && strlen( &buf[0] ) == size_t( len ));
+    return std::string( &buf[0] );
+}
+
+std::string read_file( const char* filename )
+{
+    std::string text;
+    FILE* file = fopen( filename, "r" );
+    if ( file != NULL ) {
+        char chunk[ 4096 ];
+        size_t len;
+        while ( (len = fread( chunk, 1, sizeof(chunk), file )) > 0 ) {
+            text.append( chunk, len );
+        }
+        fclose( file );
+    }
+    return text;
+}
+
+// "key": value in the JSON object of routine name; -1 if the routine isn't listed
+long long json_routine( const std::string& snap, const char* name, const char* key )
+{
+    std::string pattern = std::string( "\"name\": \"" ) + name + "\"";
+    size_t pos = snap.find( pattern );
+    if ( pos == std::string::npos ) {
+        return -1;
+    }
+    size_t end = snap.find( '}', pos );
+    pos = snap.find( std::string( "\"" ) + key + "\": ", pos );
+    if ( pos == std::string::npos || pos > end ) {
+        return -1;
+    }
+    long long value = -1;
+    sscanf( snap.c_str() + pos + strlen( key ) + 4, "%lld", &value );
+    return value;
+}
+
+// count and bytes of a kind of copy or alloc, e.g., "host_to_device", in JSON
+bool json_kind( const std::string& snap, const char* kind,
+                long long* count, long long* bytes )
+{
+    std::string pattern = std::string( "\"" ) + kind + "\": ";
+    size_t pos = snap.find( pattern );
+    return pos != std::string::npos
+        && sscanf( snap.c_str() + pos + pattern.size(),
+                   "{\"count\": %lld, \"bytes\": %lld}", count, bytes ) == 2;
+}
+
+// calls of routine name in text; -1 if the routine isn't listed
+long long text_routine( const std::string& snap, const char* name )
+{
+    std::string pattern = std::string( "  " ) + name + " ";
+    size_t pos = snap.find( pattern );
+    long long calls = -1;
+    if ( pos != std::string::npos ) {
+        sscanf( snap.c_str() + pos + pattern.size(), "%lld", &calls );
+    }
+    return calls;
+}
+
+// count and bytes of a kind of copy, e.g., "host_to_device", in text
+bool text_copy( const std::string& snap, const char* kind,
+                long long* count, long long* bytes )
+{
+    std::string pattern = std::string( "% copy  " ) + kind + " ";
+    size_t pos = snap.find( pattern );
+    return pos != std::string::npos
+        && sscanf( snap.c_str() + pos + pattern.size(),
+                   "%lld calls %lld bytes", count, bytes ) == 2;
+}
+
+// snap without its lines starting with one of the prefixes, e.g., the uptime
+std::string drop_lines( const std::string& snap, const char* prefix1, const char* prefix2 )
+{
+    std::string result;
+    size_t pos = 0;
+    while ( pos < snap.size() ) {
+        size_t end = snap.find( '\n', pos );
+        end = (end == std::string::npos ? snap.size() : end + 1);
+        std::string line = snap.substr( pos, end - pos );
+        if ( line.compare( 0, strlen( prefix1 ), prefix1 ) != 0
+             && line.compare( 0, strlen( prefix2 ), prefix2 ) != 0 )
+        {
+            result += line;
+        }
+        pos = end;
+    }
+    return result;
+}
+
+
+/******************************************************************************/
+// Known call sequence: Cholesky in double and LU in single, on matrices
+// copied to and from the device.
+const magma_int_t n = 100;
+
+void run_sequence( magma_queue_t queue, int npotrf, int ngetrf )
+{
+    magma_int_t ione = 1, size = n*n, info, iseed[4] = { 0, 0, 0, 1 };
+    magma_int_t *ipiv;
+    double *hA, *dA;
+    float  *hB, *dB;
+    magma_imalloc_cpu( &ipiv, n );
+    magma_dmalloc_cpu( &hA, n*n );
+    magma_smalloc_cpu( &hB, n*n );
+    magma_dmalloc( &dA, n*n );
+    magma_smalloc( &dB, n*n );
+
+    for( int k = 0; k < npotrf; ++k ) {
+        lapackf77_dlarnv( &ione, iseed, &size, hA );
+        for( magma_int_t i = 0; i < n; ++i ) {
+            hA[ i + i*n ] += n;  // diagonally dominant, so SPD
+        }
+        magma_dsetmatrix( n, n, hA, n, dA, n, queue );
+        magma_dpotrf_gpu( MagmaLower, n, dA, n, &info );
+        warn( info == 0 );
+    }
+    for( int k = 0; k < ngetrf; ++k ) {
+        lapackf77_slarnv( &ione, iseed, &size, hB );
+        magma_ssetmatrix( n, n, hB, n, dB, n, queue );
+        magma_sgetrf_gpu( n, n, dB, n, ipiv, &info );
+        warn( info == 0 );
+    }
+
+    magma_free_cpu( ipiv );
+    magma_free_cpu( hA );
+    magma_free_cpu( hB );
+    magma_free( dA );
+    magma_free( dB );
+}
+
+
+/******************************************************************************/
+// Per routine calls and flops, in the JSON and text snapshots.
+void test_routines( magma_queue_t queue )
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_metrics_enable( 1 );
+    magma_metrics_reset();
+    run_sequence( queue, 2, 3 );
+
+    std::string json = snapshot( true );
+    std::string text = snapshot( false );
+    printf( "%s", text.c_str() );
+
+    long long potrf_flops = 2 * (long long) FLOPS_DPOTRF( n );
+    long long getrf_flops = 3 * (long long) FLOPS_SGETRF( n, n );
+    warn( json_routine( json, "magma_dpotrf_gpu", "calls" ) == 2 );
+    warn( json_routine( json, "magma_dpotrf_gpu", "flops" ) == potrf_flops );
+    warn( json_routine( json, "magma_sgetrf_gpu", "calls" ) == 3 );
+    warn( json_routine( json, "magma_sgetrf_gpu", "flops" ) == getrf_flops );
+    warn( json.find( "\"name\": \"magma_dpotrf_gpu\", \"precision\": \"d\"" ) != std::string::npos );
+    warn( json.find( "\"name\": \"magma_sgetrf_gpu\", \"precision\": \"s\"" ) != std::string::npos );
+    warn( json_routine( json, "magma_zpotrf_gpu", "calls" ) == -1 );  // not called
+    warn( text_routine( text, "magma_dpotrf_gpu" ) == 2 );
+    warn( text_routine( text, "magma_sgetrf_gpu" ) == 3 );
+    warn( text_routine( text, "magma_zpotrf_gpu" ) == -1 );
+
+    // device allocations: 1 double and 1 float matrix, at least
+    long long count, bytes;
+    warn( json_kind( json, "device", &count, &bytes ));
+    warn( count >= 2 && bytes >= n*n*(8 + 4) );
+
+    // reset clears everything
+    magma_metrics_reset();
+    json = snapshot( true );
+    warn( json_routine( json, "magma_dpotrf_gpu", "calls" ) == -1 );
+    warn( json_kind( json, "host_to_device", &count, &bytes ) && count == 0 && bytes == 0 );
+    warn( json_kind( json, "device", &count, &bytes ) && count == 0 && bytes == 0 );
+
+    magma_metrics_enable( 0 );
+}
+
+
+/******************************************************************************/
+// Bytes copied each way, by several threads at once, are exact.
+void copy_thread( magma_queue_t queue, double* hA, double* dA, double* dB, int ncopies )
+{
+    for( int k = 0; k < ncopies; ++k ) {
+        magma_dsetmatrix( n, n, hA, n, dA, n, queue );
+        magma_dcopymatrix( n, n, dA, n, dB, n, queue );
+        magma_dgetmatrix( n, n, dB, n, hA, n, queue );
+        magma_dsetvector( n, hA, 1, dA, 1, queue );
+    }
+}
+
+void test_transfers( magma_queue_t queue, int nthreads, int ncopies )
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    std::vector< double* > hA( nthreads ), dA( nthreads ), dB( nthreads );
+    for( int t = 0; t < nthreads; ++t ) {
+        magma_dmalloc_cpu( &hA[t], n*n );
+        magma_dmalloc( &dA[t], n*n );
+        magma_dmalloc( &dB[t], n*n );
+        memset( hA[t], 0, n*n*sizeof(double) );
+    }
+
+    magma_metrics_enable( 1 );
+    magma_metrics_reset();
+    std::vector< std::thread > threads;
+    for( int t = 0; t < nthreads; ++t ) {
+        threads.push_back( std::thread( copy_thread, queue, hA[t], dA[t], dB[t], ncopies ));
+    }
+    for( int t = 0; t < nthreads; ++t ) {
+        threads[t].join();
+    }
+    magma_metrics_enable( 0 );
+
+    std::string json = snapshot( true );
+    std::string text = snapshot( false );
+    printf( "%s", text.c_str() );
+
+    long long calls  = nthreads * ncopies;
+    long long matrix = n*n*sizeof(double);
+    long long vector = n*sizeof(double);
+    long long count, bytes;
+    warn( json_kind( json, "host_to_device", &count, &bytes ));
+    warn( count == 2*calls && bytes == calls*(matrix + vector) );
+    warn( json_kind( json, "device_to_host", &count, &bytes ));
+    warn( count == calls && bytes == calls*matrix );
+    warn( json_kind( json, "device_to_device", &count, &bytes ));
+    warn( count == calls && bytes == calls*matrix );
+
+    warn( text_copy( text, "host_to_device", &count, &bytes ));
+    warn( count == 2*calls && bytes == calls*(matrix + vector) );
+    warn( text_copy( text, "device_to_host", &count, &bytes ));
+    warn( count == calls && bytes == calls*matrix );
+
+    // no allocations while counting
+    warn( json_kind( json, "device", &count, &bytes ) && count == 0 );
+
+    for( int t = 0; t < nthreads; ++t ) {
+        magma_free_cpu( hA[t] );
+        magma_free( dA[t] );
+        magma_free( dB[t] );
+    }
+}
+
+
+/******************************************************************************/
+// Nothing is counted while disabled, and the text says so.
+void test_disabled( magma_queue_t queue )
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_metrics_enable( 0 );
+    warn( magma_metrics_enabled() == 0 );
+    magma_metrics_reset();
+    run_sequence( queue, 1, 1 );
+
+    std::string json = snapshot( true );
+    std::string text = snapshot( false );
+    long long count, bytes;
+    warn( json.find( "\"enabled\": false" ) != std::string::npos );
+    warn( text.find( "(disabled)" ) != std::string::npos );
+    warn( json_routine( json, "magma_dpotrf_gpu", "calls" ) == -1 );
+    warn( json_kind( json, "host_to_device", &count, &bytes ) && count == 0 );
+
+    magma_metrics_enable( 1 );
+    warn( magma_metrics_enabled() != 0 );
+    json = snapshot( true );
+    warn( json.find( "\"enabled\": true" ) != std::string::npos );
+    magma_metrics_enable( 0 );
+}
+
+
+/******************************************************************************/
+// Truncated snapshots return the full length; dumps match snapshots, except
+// for the time since the reset.
+void test_dump( magma_queue_t queue )
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_metrics_enable( 1 );
+    magma_metrics_reset();
+    run_sequence( queue, 1, 2 );
+    magma_metrics_enable( 0 );
+
+    std::string json = snapshot( true );
+    char buf[ 16 ];
+    magma_int_t len = magma_metrics_snapshot( buf, sizeof(buf), true );
+    warn( len == magma_int_t( json.size() ));
+    warn( strlen( buf ) == sizeof(buf) - 1 );
+    warn( json.compare( 0, sizeof(buf) - 1, buf ) == 0 );
+
+    const char* filename = "testing_metrics.json";
+    warn( magma_metrics_dump( filename, true ) == MAGMA_SUCCESS );
+    std::string file = read_file( filename );
+    remove( filename );
+    warn( drop_lines( file, "\"time\":", "\"time\":" ) == drop_lines( json, "\"time\":", "\"time\":" ));
+    warn( json_routine( file, "magma_sgetrf_gpu", "calls" ) == 2 );
+
+    std::string text = snapshot( false );
+    filename = "testing_metrics.txt";
+    warn( magma_metrics_dump( filename, false ) == MAGMA_SUCCESS );
+    file = read_file( filename );
+    remove( filename );
+    warn( drop_lines( file, "% MAGMA metrics", "% thread pool" )
+          == drop_lines( text, "% MAGMA metrics", "% thread pool" ));
+    warn( text_routine( file, "magma_dpotrf_gpu" ) == 1 );
+
+    warn( magma_metrics_dump( "no-such-dir/testing_metrics.txt", false ) == MAGMA_ERR );
+}
+
+
+/******************************************************************************/
+int main( int argc, char** argv )
+{
+    magma_init();
+    magma_queue_t queue;
+    magma_queue_create( 0, &queue );
+    magma_int_t save = magma_metrics_enabled();
+
+    test_routines( queue );
+    test_transfers( queue, 4, 25 );
+    test_disabled( queue );
+    test_dump( queue );
+
+    magma_metrics_reset();
+    magma_metrics_enable( save );
+
+    if ( gFailures > 0 ) {
+        printf( "\n*** %lld tests failed.\n", (long long) gFailures );
+    }
+    else {
+        printf( "\nAll tests passed.\n" );
+    }
+
+    magma_queue_destroy( queue );
+    magma_finalize();
+    return (gFailures > 0);
+}
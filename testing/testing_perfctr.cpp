@@ -0,0 +1,377 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// tests internal routines: magma_perfctr_diff, _sum_add, magma_thread_worker,
+// magma_blas_threads_scope, magma_trace_*, so include their headers
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "../control/magma_perfctr.h"        // internal header
+#include "../control/magma_thread_budget.h"  // internal header
+#include "../control/trace.h"                // internal header
+
+
+/******************************************************************************/
+// warn( condition ) is like assert, but doesn't abort. Also counts number of failures.
+magma_int_t gFailures = 0;
+
+void warn_helper( int cond, const char* str, const char* file, int line )
+{
+    if ( ! cond ) {
+        printf( "*** testing_perfctr error: %s:%d: assertion %s failed\n", file, line, str );
+        gFailures += 1;
+    }
+}
+
+#define warn(x) warn_helper( (x), #x, __FILE__, __LINE__ )
+
+
+/******************************************************************************/
+// at least one instruction and one FP add per iteration; volatile keeps the
+// compiler from removing or vectorizing the loop
+double loop( long long n )
+{
+    volatile double x = 0;
+    for( long long i = 0; i < n; ++i ) {
+        x = x + 1.0;
+    }
+    return x;
+}
+
+// counts of loop( n ) in the calling thread
+magma_perfctr_t count_loop( long long n )
+{
+    magma_perfctr_t start, end, c;
+    magma_perfctr_read( &start );
+    loop( n );
+    magma_perfctr_read( &end );
+    magma_perfctr_diff( start, end, c );
+    return c;
+}
+
+void print_counters( const char* label, const magma_perfctr_t& c )
+{
+    printf( "%-24s cycles %12lld, instructions %12lld, LLC misses %9lld, "
+            "mem bytes %11lld, FP ops %12lld\n",
+            label, c.cycles, c.instructions, c.llc_misses, c.mem_bytes, c.fp_ops );
+}
+
+// each counter is -1 or a count; bytes are estimated from LLC misses
+void check_valid( const magma_perfctr_t& c )
+{
+    warn( c.cycles       >= -1 );
+    warn( c.instructions >= -1 );
+    warn( c.llc_misses   >= -1 );
+    warn( c.mem_bytes    >= -1 );
+    warn( c.fp_ops       >= -1 );
+    warn( (c.mem_bytes < 0) == (c.llc_misses < 0) );
+}
+
+// whether the calling thread can read instructions and cycles
+bool have_counters()
+{
+    magma_perfctr_t c;
+    magma_perfctr_read( &c );
+    return c.cycles >= 0 && c.instructions >= 0;
+}
+
+
+/******************************************************************************/
+// Disabled counters read as -1, whatever the hardware; enabling opens them.
+void test_enable()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_int_t save = magma_perfctr_enabled();
+
+    magma_perfctr_enable( 0 );
+    warn( magma_perfctr_enabled() == 0 );
+    magma_perfctr_t c = count_loop( 1000 );
+    print_counters( "disabled", c );
+    warn( c.cycles == -1 && c.instructions == -1 && c.llc_misses == -1
+          && c.mem_bytes == -1 && c.fp_ops == -1 );
+
+    magma_perfctr_enable( 1 );
+    warn( magma_perfctr_enabled() != 0 );
+    c = count_loop( 1000 );
+    print_counters( "enabled", c );
+    check_valid( c );
+
+    magma_perfctr_enable( save );
+}
+
+
+/******************************************************************************/
+// Counters that can't be read stay -1 through differences and sums of
+// workers, rather than being taken as 0. The sum of a thread is poisoned on
+// purpose, so it is done in a thread of its own.
+void degrade_thread( magma_perfctr_t* before, magma_perfctr_t* after )
+{
+    magma_perfctr_read( before );
+    magma_perfctr_t c;
+    c.cycles       = -1;  // e.g., a worker that couldn't open cycles
+    c.instructions = 0;
+    c.llc_misses   = 0;
+    c.mem_bytes    = 0;
+    c.fp_ops       = 0;
+    magma_perfctr_sum_add( magma_perfctr_sum_current(), c );
+    magma_perfctr_read( after );
+}
+
+void test_degrade()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_perfctr_t a, b, c;
+    a.cycles = 100;  a.instructions = -1;  a.llc_misses = 5;  a.mem_bytes = 320;  a.fp_ops = -1;
+    b.cycles = 300;  b.instructions = 50;  b.llc_misses = -1; b.mem_bytes = -1;   b.fp_ops = -1;
+    magma_perfctr_diff( a, b, c );
+    warn( c.cycles == 200 );
+    warn( c.instructions == -1 && c.llc_misses == -1 && c.mem_bytes == -1 && c.fp_ops == -1 );
+
+    magma_perfctr_t before, after;
+    std::thread thread( degrade_thread, &before, &after );
+    thread.join();
+    print_counters( "before", before );
+    print_counters( "after poisoned sum", after );
+    check_valid( before );
+    check_valid( after );
+    warn( after.cycles == -1 );
+    warn( (after.instructions >= 0) == (before.instructions >= 0) );
+    warn( (after.fp_ops       >= 0) == (before.fp_ops       >= 0) );
+
+    if ( ! have_counters() ) {
+        printf( "hardware counters unavailable; they read as -1\n" );
+    }
+}
+
+
+/******************************************************************************/
+// Over a loop of n iterations, instructions are at least n, and both
+// cycles and instructions grow with n.
+void test_loop()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+    if ( ! have_counters() ) {
+        printf( "hardware counters unavailable; skipping\n" );
+        return;
+    }
+
+    const long long n = 1000000;
+    loop( n );  // warmup
+    magma_perfctr_t c1 = count_loop( n );
+    magma_perfctr_t c4 = count_loop( 4*n );
+    print_counters( "loop( n )", c1 );
+    print_counters( "loop( 4n )", c4 );
+    check_valid( c1 );
+    check_valid( c4 );
+    warn( c1.instructions >= n );
+    warn( c4.instructions >= 4*n );
+    warn( c4.instructions > 2*c1.instructions );
+    warn( c1.cycles > 0 );
+    warn( c4.cycles > c1.cycles );
+    if ( c1.fp_ops >= 0 ) {
+        warn( c1.fp_ops >= n );
+    }
+
+    // reads never go backwards
+    magma_perfctr_t prev, next;
+    magma_perfctr_read( &prev );
+    for( int i = 0; i < 100; ++i ) {
+        loop( 1000 );
+        magma_perfctr_read( &next );
+        warn( next.cycles       >= prev.cycles );
+        warn( next.instructions >= prev.instructions );
+        prev = next;
+    }
+}
+
+
+/******************************************************************************/
+// Counts of the workers of a region are added to the thread creating it;
+// counts of other threads are not.
+void worker_thread( const magma_thread_region* region, magma_int_t id, long long n )
+{
+    magma_thread_worker worker( *region, id );
+    loop( n );
+}
+
+void test_workers()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+    if ( ! have_counters() ) {
+        printf( "hardware counters unavailable; skipping\n" );
+        return;
+    }
+
+    const long long n = 2000000;
+    magma_perfctr_t start, end, c;
+
+    // workers beyond the region's CPUs are unbound, but still counted
+    const magma_int_t nthreads = 4;
+    magma_perfctr_read( &start );
+    {
+        magma_thread_region region( "perfctr", nthreads );
+        std::vector< std::thread > threads;
+        for( magma_int_t id = 1; id < nthreads; ++id ) {
+            threads.push_back( std::thread( worker_thread, &region, id, n ));
+        }
+        worker_thread( &region, 0, n );
+        for( size_t t = 0; t < threads.size(); ++t ) {
+            threads[t].join();
+        }
+    }
+    magma_perfctr_read( &end );
+    magma_perfctr_diff( start, end, c );
+    printf( "%lld workers\n", (long long) nthreads );
+    print_counters( "region", c );
+    warn( c.instructions >= nthreads*n );
+
+    // a thread that isn't a worker isn't counted
+    magma_perfctr_read( &start );
+    std::thread other( loop, 10*n );
+    other.join();
+    magma_perfctr_read( &end );
+    magma_perfctr_diff( start, end, c );
+    print_counters( "other thread", c );
+    warn( c.instructions < 10*n );
+}
+
+
+/******************************************************************************/
+// FP ops of dgemm, in one thread, are 2 n^3, give or take the edges of
+// blocks. Only where the FP_ARITH events exist.
+void test_dgemm()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+    magma_perfctr_t c;
+    magma_perfctr_read( &c );
+    if ( c.fp_ops < 0 ) {
+        printf( "FP ops unavailable; skipping\n" );
+        return;
+    }
+
+    const magma_int_t n = 500;
+    const double one = 1;
+    std::vector< double > A( n*n ), B( n*n ), C( n*n );
+    magma_int_t ione = 1, size = n*n, iseed[4] = { 0, 0, 0, 1 };
+    lapackf77_dlarnv( &ione, iseed, &size, &A[0] );
+    lapackf77_dlarnv( &ione, iseed, &size, &B[0] );
+    lapackf77_dlarnv( &ione, iseed, &size, &C[0] );
+
+    magma_perfctr_t start, end;
+    {
+        magma_blas_threads_scope blas( 1 );
+        magma_perfctr_read( &start );
+        blasf77_dgemm( "N", "N", &n, &n, &n, &one, &A[0], &n, &B[0], &n, &one, &C[0], &n );
+        magma_perfctr_read( &end );
+    }
+
+    magma_perfctr_diff( start, end, c );
+    double flops = 2.*n*n*n;
+    print_counters( "dgemm", c );
+    printf( "FP ops / 2n^3 = %.3f\n", c.fp_ops / flops );
+    warn( c.fp_ops >= 0.95*flops && c.fp_ops <= 1.2*flops );
+}
+
+
+/******************************************************************************/
+// Trace regions record their counters as the args of their JSON events:
+// the counters available, and none when counters are disabled.
+std::string event_line( const char* filename, const char* label )
+{
+    std::string name = std::string( "\"name\": \"" ) + label + "\"";
+    FILE* file = fopen( filename, "r" );
+    if ( file == NULL ) {
+        return "";
+    }
+    char buf[ 4096 ];
+    std::string found;
+    while ( fgets( buf, sizeof(buf), file ) != NULL ) {
+        if ( strstr( buf, name.c_str() ) != NULL ) {
+            found = buf;
+            break;
+        }
+    }
+    fclose( file );
+    return found;
+}
+
+void test_trace()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_int_t save = magma_perfctr_enabled();
+    magma_perfctr_t c;
+    magma_perfctr_read( &c );
+
+    magma_trace_on = 1;
+    magma_trace_clear();
+    magma_perfctr_enable( 1 );
+    magma_trace_begin( "test", "counted" );
+    loop( 100000 );
+    magma_trace_end();
+    magma_perfctr_enable( 0 );
+    magma_trace_begin( "test", "not-counted" );
+    loop( 100000 );
+    magma_trace_end();
+    magma_perfctr_enable( save );
+
+    const char* filename = "testing_perfctr.json";
+    warn( magma_trace_write_json( filename ) == 0 );
+    magma_trace_on = 0;
+    std::string counted     = event_line( filename, "counted" );
+    std::string not_counted = event_line( filename, "not-counted" );
+    remove( filename );
+    printf( "%s", counted.c_str() );
+    printf( "%s", not_counted.c_str() );
+    warn( ! counted.empty() && ! not_counted.empty() );
+
+    const char* names [] = { "cycles", "instructions", "llc_misses", "mem_bytes", "fp_ops" };
+    long long   values[] = { c.cycles, c.instructions, c.llc_misses, c.mem_bytes, c.fp_ops };
+    bool any = false;
+    for( int i = 0; i < 5; ++i ) {
+        std::string key = std::string( "\"" ) + names[i] + "\": ";
+        bool has = (counted.find( key ) != std::string::npos);
+        warn( has == (values[i] >= 0) );
+        any = any || has;
+    }
+    warn( (counted.find( "\"args\"" ) != std::string::npos) == any );
+    warn( not_counted.find( "\"args\"" ) == std::string::npos );
+}
+
+
+/******************************************************************************/
+int main( int argc, char** argv )
+{
+    magma_init();
+    magma_perfctr_enable( 1 );
+
+    test_enable();
+    test_degrade();
+    test_loop();
+    test_workers();
+    test_dgemm();
+    test_trace();
+
+    if ( gFailures > 0 ) {
+        printf( "\n*** %lld tests failed.\n", (long long) gFailures );
+    }
+    else {
+        printf( "\nAll tests passed.\n" );
+    }
+
+    magma_finalize();
+    return (gFailures > 0);
+}
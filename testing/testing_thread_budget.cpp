@@ -0,0 +1,264 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// tests internal routines: magma_thread_region, _worker, _owner, so include magma_thread_budget.h
+#include "magma_v2.h"
+#include "../control/magma_thread_budget.h"  // internal header
+#include "../control/magma_threadsetting.h"  // internal header
+
+
+/******************************************************************************/
+// warn( condition ) is like assert, but doesn't abort. Also counts number of failures.
+magma_int_t gFailures = 0;
+std::mutex  gFailures_mutex;
+
+void warn_helper( int cond, const char* str, const char* file, int line )
+{
+    if ( ! cond ) {
+        std::lock_guard< std::mutex > lock( gFailures_mutex );
+        printf( "*** testing_thread_budget error: %s:%d: assertion %s failed\n", file, line, str );
+        gFailures += 1;
+    }
+}
+
+#define warn(x) warn_helper( (x), #x, __FILE__, __LINE__ )
+
+
+/******************************************************************************/
+// Blocks until count threads have arrived, so their regions overlap in time.
+struct barrier
+{
+    std::mutex              mutex;
+    std::condition_variable cv;
+    int                     count;
+
+    explicit barrier( int n ): count( n ) {}
+
+    void arrive_and_wait()
+    {
+        std::unique_lock< std::mutex > lock( mutex );
+        if ( --count == 0 ) {
+            cv.notify_all();
+        }
+        cv.wait( lock, [this] { return count <= 0; });
+    }
+};
+
+// CPUs a region is bound to; -1 for an unbound thread
+std::vector< int > region_cpus( const magma_thread_region& region )
+{
+    std::vector< int > cpus;
+    for( magma_int_t id = 0; id < region.num_threads(); ++id ) {
+        cpus.push_back( region.cpu( id ));
+    }
+    return cpus;
+}
+
+
+/******************************************************************************/
+// Regions of concurrent application threads reserve disjoint CPUs, together
+// at most the CPUs available; threads that find no free CPU get 1 unbound
+// thread. All CPUs are free again when the regions end.
+void concurrent_thread( magma_int_t want, barrier* reserved, std::vector< int >* cpus )
+{
+    magma_thread_region region( "concurrent", want );
+    *cpus = region_cpus( region );
+    reserved->arrive_and_wait();  // all regions exist at once
+}
+
+void test_concurrent( int nthreads )
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_int_t available = magma_thread_budget_available();
+    magma_int_t want = std::max( magma_int_t(1), available / 2 );
+
+    barrier reserved( nthreads );
+    std::vector< std::vector< int > > cpus( nthreads );
+    std::vector< std::thread > threads;
+    for( int t = 0; t < nthreads; ++t ) {
+        threads.push_back( std::thread( concurrent_thread, want, &reserved, &cpus[t] ));
+    }
+    for( int t = 0; t < nthreads; ++t ) {
+        threads[t].join();
+    }
+
+    std::set< int > all;
+    magma_int_t nbound = 0;
+    for( int t = 0; t < nthreads; ++t ) {
+        printf( "thread %d wants %lld CPUs, gets", t, (long long) want );
+        for( size_t i = 0; i < cpus[t].size(); ++i ) {
+            printf( " %d", cpus[t][i] );
+        }
+        printf( "\n" );
+        warn( cpus[t].size() >= 1 && magma_int_t( cpus[t].size() ) <= want );
+        if ( cpus[t][0] < 0 ) {
+            warn( cpus[t].size() == 1 );  // unbound
+        }
+        else {
+            for( size_t i = 0; i < cpus[t].size(); ++i ) {
+                warn( all.count( cpus[t][i] ) == 0 );  // disjoint
+                all.insert( cpus[t][i] );
+                nbound += 1;
+            }
+        }
+    }
+    printf( "%lld CPUs available, %lld reserved by %d concurrent regions\n",
+            (long long) available, (long long) nbound, nthreads );
+    warn( nbound <= available );
+    // CPUs are reserved greedily, so only the last regions go short
+    warn( nbound == std::min( available, want*nthreads ));
+    warn( magma_thread_budget_available() == available );
+}
+
+
+/******************************************************************************/
+// A worker's budget is the one CPU it is bound to: nested regions and
+// parallel sections in it get 1 thread, on that CPU, and a second nested
+// region in the same worker finds no free CPU.
+void nested_worker( const magma_thread_region* outer, magma_int_t id )
+{
+    magma_thread_worker worker( *outer, id );
+    int cpu = outer->cpu( id );
+
+    warn( magma_thread_budget_available() == 1 );
+    warn( magma_thread_budget_size() == 1 );
+    warn( magma_get_parallel_numthreads() == 1 );
+
+    magma_thread_region inner( "inner", 8 );
+    warn( inner.num_threads() == 1 );
+    warn( inner.cpu( 0 ) == cpu );
+    {
+        magma_thread_region inner2( "inner2", 8 );
+        warn( inner2.num_threads() == 1 );
+        warn( inner2.cpu( 0 ) == -1 );
+    }
+}
+
+void test_nested()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_int_t available = magma_thread_budget_available();
+    {
+        magma_thread_region outer( "outer", available );
+        magma_int_t n = outer.num_threads();
+        printf( "%lld CPUs available, outer region gets %lld threads\n",
+                (long long) available, (long long) n );
+        warn( n == available );
+        warn( magma_thread_budget_available() == 1 );  // none left, but at least 1
+
+        std::vector< std::thread > threads;
+        for( magma_int_t id = 1; id < n; ++id ) {
+            threads.push_back( std::thread( nested_worker, &outer, id ));
+        }
+        nested_worker( &outer, 0 );
+        for( size_t t = 0; t < threads.size(); ++t ) {
+            threads[t].join();
+        }
+        // the worker in the caller restored its budget
+        warn( magma_thread_budget_available() == 1 );
+    }
+    warn( magma_thread_budget_available() == available );
+}
+
+
+/******************************************************************************/
+// An owner's budget is all of its region's CPUs, e.g., for the thread of a
+// CPU queue; nested regions divide them.
+void owner_thread( const magma_thread_region* region, std::vector< int >* cpus )
+{
+    magma_thread_owner owner( *region );
+    warn( magma_thread_budget_size() == region->num_threads() );
+    warn( magma_thread_budget_available() == region->num_threads() );
+
+    magma_thread_region stage( "stage", 100 );
+    *cpus = region_cpus( stage );
+}
+
+void test_owner()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_int_t available = magma_thread_budget_available();
+    magma_thread_region region( "owner", std::max( magma_int_t(1), available / 2 ));
+    std::vector< int > owned = region_cpus( region );
+    std::vector< int > cpus;
+    std::thread thread( owner_thread, &region, &cpus );
+    thread.join();
+
+    printf( "owner has %lld CPUs, nested region gets %lld\n",
+            (long long) owned.size(), (long long) cpus.size() );
+    warn( cpus.size() == owned.size() );
+    std::sort( owned.begin(), owned.end() );
+    std::sort( cpus.begin(), cpus.end() );
+    warn( cpus == owned );
+}
+
+
+/******************************************************************************/
+// Decisions are reported to the log callback.
+void log_callback( const char* message, void* user_data )
+{
+    std::vector< std::string >* log = (std::vector< std::string >*) user_data;
+    log->push_back( message );
+}
+
+void test_log()
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    std::vector< std::string > log;
+    magma_thread_budget_set_log( log_callback, &log );
+    {
+        magma_thread_region region( "logged", 2 );
+    }
+    magma_thread_budget_set_log( NULL, NULL );
+    {
+        magma_thread_region region( "not logged", 2 );
+    }
+
+    for( size_t i = 0; i < log.size(); ++i ) {
+        printf( "log: %s\n", log[i].c_str() );
+    }
+    warn( log.size() >= 1 && log.size() <= 2 );  // release only if CPUs reserved
+    warn( log.size() >= 1 && log[0].compare( 0, 7, "logged:" ) == 0 );
+}
+
+
+/******************************************************************************/
+int main( int argc, char** argv )
+{
+    magma_init();
+
+    test_concurrent( 4 );
+    test_nested();
+    test_owner();
+    test_log();
+
+    if ( gFailures > 0 ) {
+        printf( "\n*** %lld tests failed.\n", (long long) gFailures );
+    }
+    else {
+        printf( "\nAll tests passed.\n" );
+    }
+
+    magma_finalize();
+    return (gFailures > 0);
+}
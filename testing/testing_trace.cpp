@@ -0,0 +1,335 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// tests internal routines: magma_trace_*, so include trace.h
+#include "magma_v2.h"
+#include "../control/trace.h"  // internal header
+
+
+/******************************************************************************/
+// warn( condition ) is like assert, but doesn't abort. Also counts number of failures.
+magma_int_t gFailures = 0;
+
+void warn_helper( int cond, const char* str, const char* file, int line )
+{
+    if ( ! cond ) {
+        printf( "*** testing_trace error: %s:%d: assertion %s failed\n", file, line, str );
+        gFailures += 1;
+    }
+}
+
+#define warn(x) warn_helper( (x), #x, __FILE__, __LINE__ )
+
+
+/******************************************************************************/
+// Minimal JSON parser, enough to check the trace file is valid JSON and to
+// read its events. Objects keep their members in a map.
+struct json_value
+{
+    enum { Null, Bool, Number, String, Array, Object } type;
+    double                              number;
+    std::string                         str;
+    std::vector< json_value >           array;
+    std::map< std::string, json_value > object;
+
+    json_value(): type( Null ), number( 0 ) {}
+
+    bool has( const char* key ) const
+    {
+        return type == Object && object.count( key ) > 0;
+    }
+
+    const json_value& operator[]( const char* key ) const
+    {
+        static const json_value null;
+        std::map< std::string, json_value >::const_iterator it = object.find( key );
+        return (it != object.end() ? it->second : null);
+    }
+};
+
+struct json_parser
+{
+    const char* p;
+    bool        ok;
+
+    void skip()
+    {
+        while ( *p == ' ' || *p == '\n' || *p == '\r' || *p == '\t' ) {
+            ++p;
+        }
+    }
+
+    bool expect( char c )
+    {
+        skip();
+        if ( *p != c ) {
+            ok = false;
+            return false;
+        }
+        ++p;
+        return true;
+    }
+
+    std::string string()
+    {
+        std::string str;
+        if ( ! expect( '"' )) {
+            return str;
+        }
+        while ( *p != '"' && *p != '\0' ) {
+            if ( *p == '\\' ) {
+                ++p;
+                switch ( *p ) {
+                    case 'n': str += '\n'; break;
+                    case 't': str += '\t'; break;
+                    case 'r': str += '\r'; break;
+                    case 'b': str += '\b'; break;
+                    case 'f': str += '\f'; break;
+                    case 'u':
+                        for( int i = 1; i <= 4; ++i ) {
+                            if ( ! isxdigit( p[i] )) {
+                                ok = false;
+                            }
+                        }
+                        str += '?';
+                        p += 4;
+                        break;
+                    case '"': case '\\': case '/': str += *p; break;
+                    default: ok = false; break;
+                }
+                ++p;
+            }
+            else if ( (unsigned char) *p < 0x20 ) {
+                ok = false;
+                ++p;
+            }
+            else {
+                str += *p++;
+            }
+        }
+        expect( '"' );
+        return str;
+    }
+
+    json_value value()
+    {
+        json_value val;
+        skip();
+        if ( *p == '{' ) {
+            ++p;
+            val.type = json_value::Object;
+            skip();
+            if ( *p == '}' ) {
+                ++p;
+                return val;
+            }
+            do {
+                std::string key = string();
+                expect( ':' );
+                val.object[ key ] = value();
+                skip();
+            } while ( ok && *p++ == ',' );
+            if ( p[-1] != '}' ) {
+                ok = false;
+            }
+        }
+        else if ( *p == '[' ) {
+            ++p;
+            val.type = json_value::Array;
+            skip();
+            if ( *p == ']' ) {
+                ++p;
+                return val;
+            }
+            do {
+                val.array.push_back( value() );
+                skip();
+            } while ( ok && *p++ == ',' );
+            if ( p[-1] != ']' ) {
+                ok = false;
+            }
+        }
+        else if ( *p == '"' ) {
+            val.type = json_value::String;
+            val.str = string();
+        }
+        else if ( strncmp( p, "true", 4 ) == 0 || strncmp( p, "false", 5 ) == 0 ) {
+            val.type = json_value::Bool;
+            val.number = (*p == 't');
+            p += (*p == 't' ? 4 : 5);
+        }
+        else if ( strncmp( p, "null", 4 ) == 0 ) {
+            p += 4;
+        }
+        else {
+            char* end;
+            val.type = json_value::Number;
+            val.number = strtod( p, &end );
+            if ( end == p ) {
+                ok = false;
+            }
+            p = end;
+        }
+        return val;
+    }
+};
+
+// parses the whole file; returns false if it is not valid JSON
+bool json_parse_file( const char* filename, json_value& root )
+{
+    FILE* file = fopen( filename, "r" );
+    if ( file == NULL ) {
+        return false;
+    }
+    std::string text;
+    char chunk[ 4096 ];
+    size_t len;
+    while ( (len = fread( chunk, 1, sizeof(chunk), file )) > 0 ) {
+        text.append( chunk, len );
+    }
+    fclose( file );
+
+    json_parser parser;
+    parser.p  = text.c_str();
+    parser.ok = true;
+    root = parser.value();
+    parser.skip();
+    return parser.ok && *parser.p == '\0';
+}
+
+
+/******************************************************************************/
+const int nested = 3;  // regions per thread, each inside the previous one
+
+void record_nested( int id )
+{
+    char label[ 32 ];
+    for( int d = 0; d < nested; ++d ) {
+        snprintf( label, sizeof(label), "t%d-d%d", id, d );
+        magma_trace_begin( "test", label );
+    }
+    magma_trace_counter( "test-counter", id );
+    for( int d = 0; d < nested; ++d ) {
+        magma_trace_end();
+    }
+}
+
+
+/******************************************************************************/
+// Nested regions from several batches of concurrent threads, written as JSON
+// and read back. Threads of later batches reuse the buffers of exited ones,
+// so the number of tracks is bounded by the threads alive at once.
+void test_json( int nthreads, int nbatches )
+{
+    printf( "%%=====================================================================\n%s\n", __func__ );
+
+    magma_trace_on = 1;
+    magma_trace_clear();
+
+    record_nested( 0 );
+    for( int b = 0; b < nbatches; ++b ) {
+        std::vector< std::thread > threads;
+        for( int t = 1; t <= nthreads; ++t ) {
+            threads.push_back( std::thread( record_nested, b*nthreads + t ));
+        }
+        for( int t = 0; t < nthreads; ++t ) {
+            threads[t].join();
+        }
+    }
+
+    const char* filename = "testing_trace.json";
+    warn( magma_trace_write_json( filename ) == 0 );
+    magma_trace_on = 0;
+
+    json_value root;
+    bool valid = json_parse_file( filename, root );
+    warn( valid );
+    remove( filename );
+    if ( ! valid ) {
+        return;
+    }
+    warn( root.has( "traceEvents" ));
+    const json_value& events = root[ "traceEvents" ];
+    warn( events.type == json_value::Array );
+
+    // collect regions by label; count tracks and counters
+    std::map< std::string, json_value > regions;
+    int ntracks = 0, ncounters = 0;
+    for( size_t i = 0; i < events.array.size(); ++i ) {
+        const json_value& ev = events.array[i];
+        const std::string& ph   = ev[ "ph" ].str;
+        const std::string& name = ev[ "name" ].str;
+        if ( ph == "M" && name == "thread_name" && ev[ "pid" ].number == 0 ) {
+            ntracks += 1;
+        }
+        else if ( ph == "C" && name == "test-counter" ) {
+            ncounters += 1;
+        }
+        else if ( ph == "X" && ev[ "cat" ].str == "test" ) {
+            warn( ev.has( "ts" ) && ev.has( "dur" ) && ev.has( "tid" ));
+            warn( ev[ "dur" ].number >= 0 );
+            warn( regions.count( name ) == 0 );
+            regions[ name ] = ev;
+        }
+    }
+
+    int nid = 1 + nthreads*nbatches;
+    printf( "%d threads in %d batches: %d tracks, %d regions, %d counters\n",
+            1 + nthreads*nbatches, nbatches, ntracks, (int) regions.size(), ncounters );
+    warn( ntracks >= 1 && ntracks <= 1 + nthreads );
+    warn( (int) regions.size() == nid*nested );
+    warn( ncounters == nid );
+
+    // each region is on its parent's track, within the parent's interval
+    // (timestamps are printed with 3 digits in microseconds)
+    char label[ 32 ], parent[ 32 ];
+    for( int id = 0; id < nid; ++id ) {
+        for( int d = 1; d < nested; ++d ) {
+            snprintf( parent, sizeof(parent), "t%d-d%d", id, d-1 );
+            snprintf( label,  sizeof(label),  "t%d-d%d", id, d   );
+            if ( regions.count( parent ) == 0 || regions.count( label ) == 0 ) {
+                continue;
+            }
+            const json_value& outer = regions[ parent ];
+            const json_value& inner = regions[ label  ];
+            double eps = 2e-3;
+            warn( outer[ "tid" ].number == inner[ "tid" ].number );
+            warn( outer[ "ts" ].number <= inner[ "ts" ].number + eps );
+            warn( inner[ "ts" ].number + inner[ "dur" ].number
+                  <= outer[ "ts" ].number + outer[ "dur" ].number + eps );
+        }
+    }
+}
+
+
+/******************************************************************************/
+int main( int argc, char** argv )
+{
+    magma_init();
+
+    test_json( 4, 3 );
+
+    if ( gFailures > 0 ) {
+        printf( "\n*** %lld tests failed.\n", (long long) gFailures );
+    }
+    else {
+        printf( "\nAll tests passed.\n" );
+    }
+
+    magma_finalize();
+    return (gFailures > 0);
+}
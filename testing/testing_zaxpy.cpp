@@ -49,6 +49,7 @@ int main(int argc, char **argv)
     int status = 0;
     
     magma_opts opts;
+    opts.flush = 1;  // always flush cache before timing, unless --noflush
     opts.parse_opts( argc, argv );
     
     // Allow 3*eps; complex needs 2*sqrt(2) factor; see Higham, 2002, sec. 3.6.
@@ -91,7 +92,9 @@ int main(int argc, char **argv)
             magma_zsetmatrix( M, N, X, lda, dX, ldda, opts.queue );
             magma_zsetmatrix( M, N, Y, lda, dY, ldda, opts.queue );
             
-            magma_flush_cache( opts.cache );
+            if ( opts.flush ) {
+                magma_flush_cache( opts.cache );
+            }
             dev_time = magma_sync_wtime( opts.queue );
             for (int j = 0; j < N; ++j) {
                 magma_zaxpy( M, alpha, dX(0,j), incx, dY(0,j), incy, opts.queue );
@@ -104,7 +107,9 @@ int main(int argc, char **argv)
             /* =====================================================================
                Performs operation using CPU BLAS
                =================================================================== */
-            magma_flush_cache( opts.cache );
+            if ( opts.flush ) {
+                magma_flush_cache( opts.cache );
+            }
             cpu_time = magma_wtime();
             for (int j = 0; j < N; ++j) {
                 blasf77_zaxpy( &M, &alpha, X(0,j), &incx, Y(0,j), &incy );
@@ -61,6 +61,8 @@ int main( int argc, char** argv)
     MAGMA_UNUSED( magma_error );
     
     magma_opts opts;
+    opts.bench_supported = true;
+    opts.flush = 1;  // always flush cache before timing, unless --noflush
     opts.parse_opts( argc, argv );
     
     // Allow 3*eps; complex needs 2*sqrt(2) factor; see Higham, 2002, sec. 3.6.
@@ -145,17 +147,21 @@ int main( int argc, char** argv)
             /* =====================================================================
                Performs operation using MAGMABLAS (currently only with CUDA)
                =================================================================== */
+            // in benchmark mode, setup and run are repeated; see --bench
+            magma_error = dev_error = -1;
             #if defined(HAVE_CUBLAS) || defined(HAVE_HIP)
-                magma_zsetmatrix( M, N, hC, ldc, dC, lddc, opts.queue );
-                
-                magma_flush_cache( opts.cache );
-                magma_time = magma_sync_wtime( opts.queue );
-                magmablas_zgemm( opts.transA, opts.transB, M, N, K,
-                                 alpha, dA, ldda,
-                                        dB, lddb,
-                                 beta,  dC, lddc,
-                                 opts.queue );
-                magma_time = magma_sync_wtime( opts.queue ) - magma_time;
+                magma_bench_stats magma_stats = magma_bench( opts, opts.queue,
+                    [&]{
+                        magma_zsetmatrix( M, N, hC, ldc, dC, lddc, opts.queue );
+                    },
+                    [&]{
+                        magmablas_zgemm( opts.transA, opts.transB, M, N, K,
+                                         alpha, dA, ldda,
+                                                dB, lddb,
+                                         beta,  dC, lddc,
+                                         opts.queue );
+                    });
+                magma_time = magma_stats.median;
                 magma_perf = gflops / magma_time;
                 
                 magma_zgetmatrix( M, N, dC, lddc, hCmagma, ldc, opts.queue );
@@ -164,15 +170,17 @@ int main( int argc, char** argv)
             /* =====================================================================
                Performs operation using CUBLAS / clBLAS / Xeon Phi MKL
                =================================================================== */
-            magma_zsetmatrix( M, N, hC, ldc, dC(0,0), lddc, opts.queue );
-            
-            magma_flush_cache( opts.cache );
-            dev_time = magma_sync_wtime( opts.queue );
-            magma_zgemm( opts.transA, opts.transB, M, N, K,
-                         alpha, dA(0,0), ldda,
-                                dB(0,0), lddb,
-                         beta,  dC(0,0), lddc, opts.queue );
-            dev_time = magma_sync_wtime( opts.queue ) - dev_time;
+            magma_bench_stats dev_stats = magma_bench( opts, opts.queue,
+                [&]{
+                    magma_zsetmatrix( M, N, hC, ldc, dC(0,0), lddc, opts.queue );
+                },
+                [&]{
+                    magma_zgemm( opts.transA, opts.transB, M, N, K,
+                                 alpha, dA(0,0), ldda,
+                                        dB(0,0), lddb,
+                                 beta,  dC(0,0), lddc, opts.queue );
+                });
+            dev_time = dev_stats.median;
             dev_perf = gflops / dev_time;
             
             magma_zgetmatrix( M, N, dC(0,0), lddc, hCdev, ldc, opts.queue );
@@ -181,7 +189,9 @@ int main( int argc, char** argv)
                Performs operation using CPU BLAS
                =================================================================== */
             if ( opts.lapack ) {
-                magma_flush_cache( opts.cache );
+                if ( opts.flush ) {
+                    magma_flush_cache( opts.cache );
+                }
                 cpu_time = magma_wtime();
                 blasf77_zgemm( lapack_trans_const(opts.transA), lapack_trans_const(opts.transB), &M, &N, &K,
                                &alpha, hA, &lda,
@@ -256,6 +266,10 @@ int main( int argc, char** argv)
                            dev_perf,    1000.*dev_time );
                 #endif
             }
+            #if defined(HAVE_CUBLAS) || defined(HAVE_HIP)
+                magma_bench_record( opts, "magmablas_zgemm", M, N, K, gflops, magma_stats, magma_error );
+            #endif
+            magma_bench_record( opts, "zgemm", M, N, K, gflops, dev_stats, dev_error );
             
             magma_free_cpu( hA );
             magma_free_cpu( hB );
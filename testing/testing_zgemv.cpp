@@ -59,6 +59,7 @@ int main(int argc, char **argv)
     MAGMA_UNUSED( magma_error );
     
     magma_opts opts;
+    opts.flush = 1;  // always flush cache before timing, unless --noflush
     opts.parse_opts( argc, argv );
     
     // Allow 3*eps; complex needs 2*sqrt(2) factor; see Higham, 2002, sec. 3.6.
@@ -121,7 +122,9 @@ int main(int argc, char **argv)
             magma_zsetvector( Xm, X, incx, dX(0), incx, opts.queue );
             magma_zsetvector( Ym, Y, incy, dY(0), incy, opts.queue );
             
-            magma_flush_cache( opts.cache );
+            if ( opts.flush ) {
+                magma_flush_cache( opts.cache );
+            }
             dev_time = magma_sync_wtime( opts.queue );
             magma_zgemv( opts.transA, M, N,
                          alpha, dA(0,0), ldda,
@@ -138,7 +141,9 @@ int main(int argc, char **argv)
             #if defined(HAVE_CUBLAS) || defined(HAVE_HIP)
                 magma_zsetvector( Ym, Y, incy, dY(0), incy, opts.queue );
                 
-                magma_flush_cache( opts.cache );
+                if ( opts.flush ) {
+                    magma_flush_cache( opts.cache );
+                }
                 magma_time = magma_sync_wtime( opts.queue );
                 magmablas_zgemv( opts.transA, M, N,
                                  alpha, dA(0,0), ldda,
@@ -153,7 +158,9 @@ int main(int argc, char **argv)
             /* =====================================================================
                Performs operation using CPU BLAS
                =================================================================== */
-            magma_flush_cache( opts.cache );
+            if ( opts.flush ) {
+                magma_flush_cache( opts.cache );
+            }
             cpu_time = magma_wtime();
             blasf77_zgemv( lapack_trans_const(opts.transA), &M, &N,
                            &alpha, A, &lda,
@@ -399,6 +399,8 @@ int main( int argc, char** argv)
     int status = 0;
     
     magma_opts opts;
+    opts.bench_supported = true;
+    opts.flush = 1;  // always flush cache before timing, unless --noflush
     opts.parse_opts( argc, argv );
     
     double tol = opts.tolerance * lapackf77_dlamch("E");
@@ -597,6 +599,7 @@ int main( int argc, char** argv)
             // force check to fail if gesdd returns info error
             double result[5]        = { nan, nan, nan, nan, nan };
             double result_lapack[5] = { nan, nan, nan, nan, nan };
+            magma_bench_stats magma_stats, lapack_stats;
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, M, N, hA, lda, Sref );
@@ -612,15 +615,18 @@ int main( int argc, char** argv)
                 /* ====================================================================
                    Performs operation using MAGMA
                    =================================================================== */
-                magma_flush_cache( opts.cache );
-                gpu_time = magma_wtime();
-                magma_zgesdd( *jobz, M, N,
-                              hR, lda, S, U, ldu, VT, ldv, hwork, lwork_magma.value,
-                              #ifdef COMPLEX
-                              rwork,
-                              #endif
-                              iwork, &info );
-                gpu_time = magma_wtime() - gpu_time;
+                // in benchmark mode, setup and run are repeated; see --bench
+                magma_stats = magma_bench( opts, NULL,
+                    [&]{ lapackf77_zlacpy( MagmaFullStr, &M, &N, hA, &lda, hR, &lda ); },
+                    [&]{
+                        magma_zgesdd( *jobz, M, N,
+                                      hR, lda, S, U, ldu, VT, ldv, hwork, lwork_magma.value,
+                                      #ifdef COMPLEX
+                                      rwork,
+                                      #endif
+                                      iwork, &info );
+                    });
+                gpu_time = magma_stats.median;
                 
                 const char *func = "magma_zgesdd";
                 if ( *svd_work == MagmaSVD_min_1 || *svd_work == MagmaSVD_min_old_1 ) {
@@ -655,16 +661,17 @@ int main( int argc, char** argv)
                 /* =====================================================================
                    Performs operation using LAPACK
                    =================================================================== */
-                lapackf77_zlacpy( MagmaFullStr, &M, &N, hA, &lda, hR, &lda );
-                magma_flush_cache( opts.cache );
-                cpu_time = magma_wtime();
-                lapackf77_zgesdd( lapack_vec_const(*jobz), &M, &N,
-                                  hR, &lda, Sref, U, &ldu, VT, &ldv, hwork, &lwork_lapack.value,
-                                  #ifdef COMPLEX
-                                  rwork,
-                                  #endif
-                                  iwork, &info);
-                cpu_time = magma_wtime() - cpu_time;
+                lapack_stats = magma_bench( opts, NULL,
+                    [&]{ lapackf77_zlacpy( MagmaFullStr, &M, &N, hA, &lda, hR, &lda ); },
+                    [&]{
+                        lapackf77_zgesdd( lapack_vec_const(*jobz), &M, &N,
+                                          hR, &lda, Sref, U, &ldu, VT, &ldv, hwork, &lwork_lapack.value,
+                                          #ifdef COMPLEX
+                                          rwork,
+                                          #endif
+                                          iwork, &info);
+                    });
+                cpu_time = lapack_stats.median;
                 
                 const char *func = "lapackf77_zgesdd";
                 if ( *svd_work == MagmaSVD_min_1 || *svd_work == MagmaSVD_min_old_1 ) {
@@ -742,6 +749,18 @@ int main( int argc, char** argv)
             status += ! okay;
             printf( "   %-3s   %-6s", (sorted ? "yes" : "no"), (okay ? "ok" : "failed") );
             
+            // A - USV' is the error of the records
+            char routine[ 32 ];
+            snprintf( routine, sizeof(routine), "zgesdd_%c", lapacke_vec_const(*jobz) );
+            if ( opts.magma ) {
+                magma_bench_record( opts, routine, M, N, 0, 0, magma_stats, result[0] );
+            }
+            if ( opts.lapack ) {
+                snprintf( routine, sizeof(routine), "lapack_zgesdd_%c", lapacke_vec_const(*jobz) );
+                magma_bench_record( opts, routine, M, N, 0, 0, lapack_stats,
+                                    (opts.check == 2 ? result_lapack[0] : -1) );
+            }
+            
             /* =====================================================================
                Print lwork sizes
                =================================================================== */
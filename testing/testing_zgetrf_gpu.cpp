@@ -176,6 +176,7 @@ int main( int argc, char** argv)
     int status = 0;
 
     magma_opts opts;
+    opts.bench_supported = true;
     opts.parse_opts( argc, argv );
 
     double tol = opts.tolerance * lapackf77_dlamch("E");
@@ -221,26 +222,30 @@ int main( int argc, char** argv)
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            init_matrix( opts, M, N, h_A, lda );
-            if ( opts.version == 2 ) {
-                // no pivoting versions, so set ipiv to identity
-                for (magma_int_t i=0; i < min_mn; ++i ) {
-                    ipiv[i] = i+1;
-                }
-            }
-            magma_zsetmatrix( M, N, h_A, lda, d_A, ldda, opts.queue );
-            
-            gpu_time = magma_wtime();
-            if ( opts.version == 1 ) {
-                magma_zgetrf_gpu( M, N, d_A, ldda, ipiv, &info);
-            }
-            else if ( opts.version == 2 ) {
-                magma_zgetrf_nopiv_gpu( M, N, d_A, ldda, &info);
-            }
-            else if ( opts.version == 3 ) {
-                magma_zgetrf_native( M, N, d_A, ldda, ipiv, &info);
-            }
-            gpu_time = magma_wtime() - gpu_time;
+            // in benchmark mode, setup and run are repeated; see --bench
+            magma_bench_stats stats = magma_bench( opts, NULL,
+                [&]{
+                    init_matrix( opts, M, N, h_A, lda );
+                    if ( opts.version == 2 ) {
+                        // no pivoting versions, so set ipiv to identity
+                        for (magma_int_t i=0; i < min_mn; ++i ) {
+                            ipiv[i] = i+1;
+                        }
+                    }
+                    magma_zsetmatrix( M, N, h_A, lda, d_A, ldda, opts.queue );
+                },
+                [&]{
+                    if ( opts.version == 1 ) {
+                        magma_zgetrf_gpu( M, N, d_A, ldda, ipiv, &info);
+                    }
+                    else if ( opts.version == 2 ) {
+                        magma_zgetrf_nopiv_gpu( M, N, d_A, ldda, &info);
+                    }
+                    else if ( opts.version == 3 ) {
+                        magma_zgetrf_native( M, N, d_A, ldda, ipiv, &info);
+                    }
+                });
+            gpu_time = stats.median;
             gpu_perf = gflops / gpu_time;
             if (info != 0) {
                 printf("magma_zgetrf_gpu returned error %lld: %s.\n",
@@ -271,8 +276,10 @@ int main( int argc, char** argv)
                 status += ! (error < tol);
             }
             else {
+                error = -1;
                 printf("     ---  \n");
             }
+            magma_bench_record( opts, "zgetrf_gpu", M, N, 0, gflops, stats, error );
             
             magma_free_cpu( ipiv );
             magma_free_cpu( h_A );
@@ -53,6 +53,7 @@ int main( int argc, char** argv)
     int status = 0;
 
     magma_opts opts;
+    opts.bench_supported = true;
     opts.parse_opts( argc, argv );
 
     // checking NoVec requires LAPACK
@@ -174,99 +175,102 @@ int main( int argc, char** argv)
             
             /* Initialize the matrix */
             magma_generate_matrix( opts, N, N, h_A, lda );
-            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            if (opts.version == 1) {
-                if (opts.ngpu == 1) {
-                    magma_zheevd( opts.jobz, opts.uplo,
-                                  N, h_R, lda, w1,
-                                  h_work, lwork,
-                                  #ifdef COMPLEX
-                                  rwork, lrwork,
-                                  #endif
-                                  iwork, liwork,
-                                  &info );
-                }
-                else {
-                    //printf( "magma_zheevd_m, ngpu %lld (%lld)\n", (long long) opts.ngpu, (long long) abs_ngpu );
-                    magma_zheevd_m( abs_ngpu, opts.jobz, opts.uplo,
-                                    N, h_R, lda, w1,
-                                    h_work, lwork,
-                                    #ifdef COMPLEX
-                                    rwork, lrwork,
-                                    #endif
-                                    iwork, liwork,
-                                    &info );
-                }
-            }
-            else if ( opts.version == 2 ) {  // version 2: zheevdx computes selected eigenvalues/vectors
-                if (opts.ngpu == 1) {
-                    magma_zheevdx( opts.jobz, range, opts.uplo,
-                                   N, h_R, lda,
-                                   vl, vu, il, iu,
-                                   &Nfound, w1,
-                                   h_work, lwork,
-                                   #ifdef COMPLEX
-                                   rwork, lrwork,
-                                   #endif
-                                   iwork, liwork,
-                                   &info );
-                }
-                else {
-                    //printf( "magma_zheevdx_m, ngpu %lld (%lld)\n", (long long) opts.ngpu, (long long) abs_ngpu );
-                    magma_zheevdx_m( abs_ngpu, opts.jobz, range, opts.uplo,
-                                     N, h_R, lda,
-                                     vl, vu, il, iu,
-                                     &Nfound, w1,
-                                     h_work, lwork,
-                                     #ifdef COMPLEX
-                                     rwork, lrwork,
-                                     #endif
-                                     iwork, liwork,
-                                     &info );
-                }
-                //printf( "il %lld, iu %lld, Nfound %lld\n", (long long) il, (long long) iu, (long long) Nfound );
-            }
-            else if ( opts.version == 3 ) {  // version 3: MRRR, computes selected eigenvalues/vectors
-                // only complex version available
-                #ifdef COMPLEX
-                magma_zheevr( opts.jobz, range, opts.uplo,
-                              N, h_R, lda,
-                              vl, vu, il, iu, abstol,
-                              &Nfound, w1,
-                              h_Z, lda, isuppz,
-                              h_work, lwork,
-                              #ifdef COMPLEX
-                              rwork, lrwork,
-                              #endif
-                              iwork, liwork,
-                              &info );
-                lapackf77_zlacpy( "Full", &N, &N, h_Z, &lda, h_R, &lda );
-                #endif
-            }
-            else if ( opts.version == 4 ) {  // version 3: zheevx (QR iteration), computes selected eigenvalues/vectors
-                // only complex version available
-                #ifdef COMPLEX
-                magma_zheevx( opts.jobz, range, opts.uplo,
-                              N, h_R, lda,
-                              vl, vu, il, iu, abstol,
-                              &Nfound, w1,
-                              h_Z, lda,
-                              h_work, lwork,
-                              #ifdef COMPLEX
-                              rwork, /*lrwork,*/
-                              #endif
-                              iwork, /*liwork,*/
-                              ifail,
-                              &info );
-                lapackf77_zlacpy( "Full", &N, &N, h_Z, &lda, h_R, &lda );
-                #endif
-            }
-            gpu_time = magma_wtime() - gpu_time;
+            // in benchmark mode, setup and run are repeated; see --bench
+            magma_bench_stats magma_stats = magma_bench( opts, NULL,
+                [&]{ lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda ); },
+                [&]{
+                    if (opts.version == 1) {
+                        if (opts.ngpu == 1) {
+                            magma_zheevd( opts.jobz, opts.uplo,
+                                          N, h_R, lda, w1,
+                                          h_work, lwork,
+                                          #ifdef COMPLEX
+                                          rwork, lrwork,
+                                          #endif
+                                          iwork, liwork,
+                                          &info );
+                        }
+                        else {
+                            //printf( "magma_zheevd_m, ngpu %lld (%lld)\n", (long long) opts.ngpu, (long long) abs_ngpu );
+                            magma_zheevd_m( abs_ngpu, opts.jobz, opts.uplo,
+                                            N, h_R, lda, w1,
+                                            h_work, lwork,
+                                            #ifdef COMPLEX
+                                            rwork, lrwork,
+                                            #endif
+                                            iwork, liwork,
+                                            &info );
+                        }
+                    }
+                    else if ( opts.version == 2 ) {  // version 2: zheevdx computes selected eigenvalues/vectors
+                        if (opts.ngpu == 1) {
+                            magma_zheevdx( opts.jobz, range, opts.uplo,
+                                           N, h_R, lda,
+                                           vl, vu, il, iu,
+                                           &Nfound, w1,
+                                           h_work, lwork,
+                                           #ifdef COMPLEX
+                                           rwork, lrwork,
+                                           #endif
+                                           iwork, liwork,
+                                           &info );
+                        }
+                        else {
+                            //printf( "magma_zheevdx_m, ngpu %lld (%lld)\n", (long long) opts.ngpu, (long long) abs_ngpu );
+                            magma_zheevdx_m( abs_ngpu, opts.jobz, range, opts.uplo,
+                                             N, h_R, lda,
+                                             vl, vu, il, iu,
+                                             &Nfound, w1,
+                                             h_work, lwork,
+                                             #ifdef COMPLEX
+                                             rwork, lrwork,
+                                             #endif
+                                             iwork, liwork,
+                                             &info );
+                        }
+                        //printf( "il %lld, iu %lld, Nfound %lld\n", (long long) il, (long long) iu, (long long) Nfound );
+                    }
+                    else if ( opts.version == 3 ) {  // version 3: MRRR, computes selected eigenvalues/vectors
+                        // only complex version available
+                        #ifdef COMPLEX
+                        magma_zheevr( opts.jobz, range, opts.uplo,
+                                      N, h_R, lda,
+                                      vl, vu, il, iu, abstol,
+                                      &Nfound, w1,
+                                      h_Z, lda, isuppz,
+                                      h_work, lwork,
+                                      #ifdef COMPLEX
+                                      rwork, lrwork,
+                                      #endif
+                                      iwork, liwork,
+                                      &info );
+                        lapackf77_zlacpy( "Full", &N, &N, h_Z, &lda, h_R, &lda );
+                        #endif
+                    }
+                    else if ( opts.version == 4 ) {  // version 3: zheevx (QR iteration), computes selected eigenvalues/vectors
+                        // only complex version available
+                        #ifdef COMPLEX
+                        magma_zheevx( opts.jobz, range, opts.uplo,
+                                      N, h_R, lda,
+                                      vl, vu, il, iu, abstol,
+                                      &Nfound, w1,
+                                      h_Z, lda,
+                                      h_work, lwork,
+                                      #ifdef COMPLEX
+                                      rwork, /*lrwork,*/
+                                      #endif
+                                      iwork, /*liwork,*/
+                                      ifail,
+                                      &info );
+                        lapackf77_zlacpy( "Full", &N, &N, h_Z, &lda, h_R, &lda );
+                        #endif
+                    }
+                });
+            gpu_time = magma_stats.median;
             if (info != 0) {
                 printf("magma_zheevd returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -344,52 +348,57 @@ int main( int argc, char** argv)
             /* =====================================================================
                Performs operation using LAPACK
                =================================================================== */
+            magma_bench_stats lapack_stats;
             if ( opts.lapack ) {
-                cpu_time = magma_wtime();
-                if ( opts.version == 1 ) {
-                    lapackf77_zheevd( lapack_vec_const(opts.jobz), lapack_uplo_const(opts.uplo),
-                                      &N, h_A, &lda, w2,
-                                      h_work, &lwork,
-                                      #ifdef COMPLEX
-                                      rwork, &lrwork,
-                                      #endif
-                                      iwork, &liwork,
-                                      &info );
-                }
-                else if ( opts.version == 2 || opts.version == 4 ) {
-                    lapackf77_zheevx( lapack_vec_const(opts.jobz),
-                                      lapack_range_const(range),
-                                      lapack_uplo_const(opts.uplo),
-                                      &N, h_A, &lda,
-                                      &vl, &vu, &il, &iu, &abstol,
-                                      &Nfound, w2,
-                                      h_Z, &lda,
-                                      h_work, &lwork,
-                                      #ifdef COMPLEX
-                                      rwork,
-                                      #endif
-                                      iwork,
-                                      ifail,
-                                      &info );
-                    lapackf77_zlacpy( "Full", &N, &N, h_Z, &lda, h_A, &lda );
-                }
-                else if ( opts.version == 3 ) {
-                    lapackf77_zheevr( lapack_vec_const(opts.jobz),
-                                      lapack_range_const(range),
-                                      lapack_uplo_const(opts.uplo),
-                                      &N, h_A, &lda,
-                                      &vl, &vu, &il, &iu, &abstol,
-                                      &Nfound, w2,
-                                      h_Z, &lda, isuppz,
-                                      h_work, &lwork,
-                                      #ifdef COMPLEX
-                                      rwork, &lrwork,
-                                      #endif
-                                      iwork, &liwork,
-                                      &info );
-                    lapackf77_zlacpy( "Full", &N, &N, h_Z, &lda, h_A, &lda );
-                }
-                cpu_time = magma_wtime() - cpu_time;
+                // on a copy of A, which the setup restores
+                lapack_stats = magma_bench( opts, NULL,
+                    [&]{ lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda ); },
+                    [&]{
+                        if ( opts.version == 1 ) {
+                            lapackf77_zheevd( lapack_vec_const(opts.jobz), lapack_uplo_const(opts.uplo),
+                                              &N, h_R, &lda, w2,
+                                              h_work, &lwork,
+                                              #ifdef COMPLEX
+                                              rwork, &lrwork,
+                                              #endif
+                                              iwork, &liwork,
+                                              &info );
+                        }
+                        else if ( opts.version == 2 || opts.version == 4 ) {
+                            lapackf77_zheevx( lapack_vec_const(opts.jobz),
+                                              lapack_range_const(range),
+                                              lapack_uplo_const(opts.uplo),
+                                              &N, h_R, &lda,
+                                              &vl, &vu, &il, &iu, &abstol,
+                                              &Nfound, w2,
+                                              h_Z, &lda,
+                                              h_work, &lwork,
+                                              #ifdef COMPLEX
+                                              rwork,
+                                              #endif
+                                              iwork,
+                                              ifail,
+                                              &info );
+                            lapackf77_zlacpy( "Full", &N, &N, h_Z, &lda, h_R, &lda );
+                        }
+                        else if ( opts.version == 3 ) {
+                            lapackf77_zheevr( lapack_vec_const(opts.jobz),
+                                              lapack_range_const(range),
+                                              lapack_uplo_const(opts.uplo),
+                                              &N, h_R, &lda,
+                                              &vl, &vu, &il, &iu, &abstol,
+                                              &Nfound, w2,
+                                              h_Z, &lda, isuppz,
+                                              h_work, &lwork,
+                                              #ifdef COMPLEX
+                                              rwork, &lrwork,
+                                              #endif
+                                              iwork, &liwork,
+                                              &info );
+                            lapackf77_zlacpy( "Full", &N, &N, h_Z, &lda, h_R, &lda );
+                        }
+                    });
+                cpu_time = lapack_stats.median;
                 if (info != 0) {
                     printf("lapackf77_zheevd returned error %lld: %s.\n",
                            (long long) info, magma_strerror( info ));
@@ -424,6 +433,13 @@ int main( int argc, char** argv)
             printf("   %s\n", (okay ? "ok" : "failed"));
             status += ! okay;
             
+            // the eigenvalue difference to LAPACK is the error of the records
+            magma_bench_record( opts, "zheevd", N, N, 0, 0, magma_stats,
+                                (opts.lapack ? result[3] : -1) );
+            if ( opts.lapack ) {
+                magma_bench_record( opts, "lapack_zheevd", N, N, 0, 0, lapack_stats, -1 );
+            }
+            
             magma_free_cpu( h_A   );
             magma_free_cpu( w1    );
             magma_free_cpu( w2    );
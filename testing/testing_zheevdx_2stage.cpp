@@ -60,6 +60,7 @@ int main( int argc, char** argv)
     int status = 0;
 
     magma_opts opts;
+    opts.bench_supported = true;
     opts.parse_opts( argc, argv );
 
     double tol    = opts.tolerance * lapackf77_dlamch("E");
@@ -151,34 +152,37 @@ int main( int argc, char** argv)
             // ===================================================================
             // Performs operation using MAGMA
             // ===================================================================
-            lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
-            gpu_time = magma_wtime();
-            if (opts.ngpu == 1) {
-                //printf("calling zheevdx_2stage 1 GPU\n");
-                magma_zheevdx_2stage( opts.jobz, range, opts.uplo, N, 
-                                      h_R, lda, 
-                                      vl, vu, il, iu, 
-                                      &Nfound, w1, 
-                                      h_work, lwork, 
-                                      #ifdef COMPLEX
-                                      rwork, lrwork, 
-                                      #endif
-                                      iwork, liwork, 
-                                      &info );
-            } else {
-                //printf("calling zheevdx_2stage_m %lld GPU\n", (long long) opts.ngpu);
-                magma_zheevdx_2stage_m( abs_ngpu, opts.jobz, range, opts.uplo, N, 
-                                        h_R, lda, 
-                                        vl, vu, il, iu, 
-                                        &Nfound, w1, 
-                                        h_work, lwork, 
-                                        #ifdef COMPLEX
-                                        rwork, lrwork, 
-                                        #endif
-                                        iwork, liwork, 
-                                        &info );
-            }
-            gpu_time = magma_wtime() - gpu_time;
+            // in benchmark mode, setup and run are repeated; see --bench
+            magma_bench_stats stats = magma_bench( opts, NULL,
+                [&]{ lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda ); },
+                [&]{
+                    if (opts.ngpu == 1) {
+                        //printf("calling zheevdx_2stage 1 GPU\n");
+                        magma_zheevdx_2stage( opts.jobz, range, opts.uplo, N, 
+                                              h_R, lda, 
+                                              vl, vu, il, iu, 
+                                              &Nfound, w1, 
+                                              h_work, lwork, 
+                                              #ifdef COMPLEX
+                                              rwork, lrwork, 
+                                              #endif
+                                              iwork, liwork, 
+                                              &info );
+                    } else {
+                        //printf("calling zheevdx_2stage_m %lld GPU\n", (long long) opts.ngpu);
+                        magma_zheevdx_2stage_m( abs_ngpu, opts.jobz, range, opts.uplo, N, 
+                                                h_R, lda, 
+                                                vl, vu, il, iu, 
+                                                &Nfound, w1, 
+                                                h_work, lwork, 
+                                                #ifdef COMPLEX
+                                                rwork, lrwork, 
+                                                #endif
+                                                iwork, liwork, 
+                                                &info );
+                    }
+                });
+            gpu_time = stats.median;
             if (info != 0) {
                 printf("magma_zheevdx_2stage returned error %lld: %s.\n",
                        (long long) info, magma_strerror( info ));
@@ -275,6 +279,8 @@ int main( int argc, char** argv)
                 printf("  %s", (okay ? "ok" : "failed"));
             }
             printf("\n");
+            magma_bench_record( opts, "zheevdx_2stage", N, Nfound, 0, 0, stats,
+                                (opts.check && opts.jobz == MagmaVec ? result[0] : -1) );
 
             magma_free_cpu( h_A   );
             magma_free_cpu( w1    );
@@ -41,6 +41,7 @@ int main( int argc, char** argv)
 
     magma_opts opts;
     opts.matrix = "rand_dominant";  // default
+    opts.bench_supported = true;
     opts.parse_opts( argc, argv );
     opts.lapack |= opts.check;  // check (-c) implies lapack (-l)
     
@@ -65,19 +66,24 @@ int main( int argc, char** argv)
             /* Initialize the matrix */
             magma_generate_matrix( opts, N, N, h_A, lda, sigma );
             lapackf77_zlacpy( MagmaFullStr, &N, &N, h_A, &lda, h_R, &lda );
-            magma_zsetmatrix( N, N, h_A, lda, d_A, ldda, opts.queue );
             
             /* ====================================================================
                Performs operation using MAGMA
                =================================================================== */
-            gpu_time = magma_wtime();
-            if(opts.version == 1){
-                magma_zpotrf_gpu( opts.uplo, N, d_A, ldda, &info );
-            }
-            else if(opts.version == 2){
-                magma_zpotrf_native(opts.uplo, N, d_A, ldda, &info );
-            }
-            gpu_time = magma_wtime() - gpu_time;
+            // in benchmark mode, setup and run are repeated; see --bench
+            magma_bench_stats stats = magma_bench( opts, NULL,
+                [&]{
+                    magma_zsetmatrix( N, N, h_A, lda, d_A, ldda, opts.queue );
+                },
+                [&]{
+                    if(opts.version == 1){
+                        magma_zpotrf_gpu( opts.uplo, N, d_A, ldda, &info );
+                    }
+                    else if(opts.version == 2){
+                        magma_zpotrf_native(opts.uplo, N, d_A, ldda, &info );
+                    }
+                });
+            gpu_time = stats.median;
             gpu_perf = gflops / gpu_time;
             if (info != 0) {
                 printf("magma_zpotrf_gpu returned error %lld: %s.\n",
@@ -119,9 +125,11 @@ int main( int argc, char** argv)
                 status += ! (error < tol);
             }
             else {
+                error = -1;
                 printf("%5lld     ---   (  ---  )   %7.2f (%7.2f)     ---  \n",
                        (long long) N, gpu_perf, gpu_time );
             }
+            magma_bench_record( opts, "zpotrf_gpu", N, N, 0, gflops, stats, error );
             magma_free_cpu( h_A );
             magma_free_cpu( sigma );
             magma_free_pinned( h_R );
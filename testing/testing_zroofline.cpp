@@ -0,0 +1,337 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+
+       Roofline of the host kernels of the two-stage eigensolvers:
+       the bulge-chasing kernels (zhbtype1cb, 2cb, 3cb, built on zlarfy and
+       zlarfx), the secular equation solves of dlaex3 (dlaed4), and the
+       overhead of the thread queue and CPU queue that schedule them.
+       Sparse host kernels are in sparse/testing/testing_zroofline_sparse.cpp.
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <queue>  // before testings.h, which defines max, min
+#include <vector>
+
+// includes, project
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#include "../control/thread_queue.hpp"  // internal header
+
+#define COMPLEX
+
+// lower band storage, as in zhetrd_hb2st
+#define A(i_, j_)  (A + lda*(j_) + ((i_) - (j_)))
+
+// real flops per multiply-add
+#ifdef COMPLEX
+const double fma_flops = 8;
+#else
+const double fma_flops = 2;
+#endif
+
+const double elem_bytes = sizeof(magmaDoubleComplex);
+
+enum { TYPE1 = 0, TYPE2 = 1, TYPE3 = 2 };
+
+// time, Gflop, and Gbyte of each kernel type, accumulated over a bulge chase
+struct bulge_counts
+{
+    double time [3];
+    double gflop[3];
+    double gbyte[3];
+};
+
+
+/******************************************************************************/
+// Reduces band matrix A, of bandwidth nb, to tridiagonal, one sweep after
+// another, as zhetrd_hb2st does with one thread and wantz = 0.
+// Flops and bytes of each kernel are counted assuming its block is read
+// from and written back to memory once: zlarfy updates the lower triangle
+// of a len-by-len block with 2 len^2 multiply-adds; zhbtype2cb applies
+// reflectors from the right and left to a lem-by-len block.
+static void bulge_chase(
+    magma_int_t n, magma_int_t nb,
+    magmaDoubleComplex *A, magma_int_t lda,
+    magmaDoubleComplex *V, magmaDoubleComplex *TAU,
+    magmaDoubleComplex *work, bulge_counts& counts )
+{
+    for( int t = 0; t < 3; ++t ) {
+        counts.time[t] = counts.gflop[t] = counts.gbyte[t] = 0;
+    }
+    for( magma_int_t sweepid = 1; sweepid <= n-1; ++sweepid ) {
+        for( magma_int_t myid = 1; ; ++myid ) {
+            magma_int_t colpt, stind, edind, blklastind;
+            if ( myid % 2 == 0 ) {
+                colpt      = (myid/2)*nb + sweepid;
+                stind      = colpt - nb + 1;
+                edind      = min( colpt, n );
+                blklastind = colpt;
+            }
+            else {
+                colpt      = ((myid+1)/2)*nb + sweepid;
+                stind      = colpt - nb + 1;
+                edind      = min( colpt, n );
+                blklastind = ((stind >= edind-1 && edind == n) ? n : 0);
+            }
+            magma_int_t st  = stind - 1;
+            magma_int_t ed  = edind - 1;
+            magma_int_t len = ed - st + 1;
+            int type;
+            double fmas, elems;
+            double time = magma_wtime();
+            if ( myid == 1 ) {
+                type = TYPE1;
+                magma_zhbtype1cb( n, nb, A, lda, V, 0, TAU, st, ed, sweepid-1, 0, 0, work );
+                fmas  = 2.*len*len;
+                elems = 1.*len*len;
+            }
+            else if ( myid % 2 == 0 ) {
+                type = TYPE2;
+                magma_zhbtype2cb( n, nb, A, lda, V, 0, TAU, st, ed, sweepid-1, 0, 0, work );
+                magma_int_t lem = min( ed+nb, n-1 ) - ed;
+                fmas  = (lem > 0 ? 2.*lem*len     : 0)
+                      + (lem > 1 ? 2.*lem*(len-1) : 0);
+                elems = (lem > 0 ? 2.*lem*len     : 0);
+            }
+            else {
+                type = TYPE3;
+                magma_zhbtype3cb( n, nb, A, lda, V, 0, TAU, st, ed, sweepid-1, 0, 0, work );
+                fmas  = 2.*len*len;
+                elems = 1.*len*len;
+            }
+            counts.time [type] += magma_wtime() - time;
+            counts.gflop[type] += fma_flops  * fmas  / 1e9;
+            counts.gbyte[type] += elem_bytes * elems / 1e9;
+
+            if ( blklastind >= n-1 ) {
+                break;
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+class empty_task: public magma_task
+{
+public:
+    virtual void run() {}
+};
+
+static magma_int_t empty_func( void* arg )
+{
+    return 0;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing roofline of host kernels
+*/
+int main( int argc, char** argv )
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    magma_opts opts;
+    opts.bench_supported = true;
+    opts.bench = true;  // rates are the median of several runs
+    opts.flush = 0;     // setup leaves data in cache, as in the solvers
+    opts.parse_opts( argc, argv );
+
+    magma_int_t nb = (opts.nb > 0 ? opts.nb : 64);
+    magma_int_t max_threads = (opts.nthread > 1 ? opts.nthread
+                                                : magma_get_parallel_numthreads());
+    magma_int_t lapack_threads = magma_get_lapack_numthreads();
+    magma_int_t ione = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    const char* type_names[3] = { "magma_zhbtype1cb", "magma_zhbtype2cb",
+                                  "magma_zhbtype3cb" };
+    char size[ 64 ];
+
+    std::vector< magma_int_t > thread_counts = magma_thread_counts( max_threads );
+    for( size_t ip = 0; ip < thread_counts.size(); ++ip ) {
+        magma_int_t p = thread_counts[ip];
+        magma_roofline_peak peak = magma_roofline_measure( p );
+        printf( "\n%% %lld threads: STREAM triad %.2f GB/s, dgemm %.2f Gflop/s\n",
+                (long long) p, peak.stream, peak.gemm );
+        magma_roofline_header();
+
+        // kernels run single-threaded, one band matrix per thread
+        magma_set_lapack_numthreads( 1 );
+
+        for( int itest = 0; itest < opts.ntest; ++itest ) {
+            magma_int_t N   = opts.nsize[itest];
+            magma_int_t lda = 2*nb;
+            magma_int_t sizeA = lda*N;
+            snprintf( size, sizeof(size), "n=%lld nb=%lld", (long long) N, (long long) nb );
+            if ( N <= nb ) {
+                printf( "%% skipping n=%lld <= nb=%lld\n", (long long) N, (long long) nb );
+                continue;
+            }
+
+            // =================================================================
+            // bulge chasing: p independent bulge chases
+            magmaDoubleComplex *hA, *hAband, *hV, *hTAU, *hwork;
+            TESTING_CHECK( magma_zmalloc_cpu( &hA,     sizeA     ));
+            TESTING_CHECK( magma_zmalloc_cpu( &hAband, sizeA*p   ));
+            TESTING_CHECK( magma_zmalloc_cpu( &hV,     2*N*p     ));
+            TESTING_CHECK( magma_zmalloc_cpu( &hTAU,   2*N*p     ));
+            TESTING_CHECK( magma_zmalloc_cpu( &hwork,  nb*p      ));
+
+            // random Hermitian band, with the bulge rows nb+1:2nb zero
+            lapackf77_zlarnv( &ione, ISEED, &sizeA, hA );
+            for( magma_int_t j = 0; j < N; ++j ) {
+                magmaDoubleComplex *A = hA;
+                *A(j,j) = MAGMA_Z_MAKE( MAGMA_Z_REAL( *A(j,j) ) + 2*nb, 0. );
+                for( magma_int_t i = j + nb + 1; i < j + lda; ++i ) {
+                    *A(i,j) = MAGMA_Z_ZERO;
+                }
+                for( magma_int_t i = N; i < j + lda; ++i ) {
+                    *A(i,j) = MAGMA_Z_ZERO;
+                }
+            }
+
+            std::vector< bulge_counts > counts( p );
+            magma_bench_stats stats = magma_bench( opts, NULL,
+                [&]{
+                    #pragma omp parallel for num_threads(p) schedule(static)
+                    for( magma_int_t t = 0; t < p; ++t ) {
+                        memcpy( hAband + t*sizeA, hA, sizeA*sizeof(magmaDoubleComplex) );
+                    }
+                },
+                [&]{
+                    #pragma omp parallel for num_threads(p) schedule(static)
+                    for( magma_int_t t = 0; t < p; ++t ) {
+                        bulge_chase( N, nb, hAband + t*sizeA, lda, hV + t*2*N,
+                                     hTAU + t*2*N, hwork + t*nb, counts[t] );
+                    }
+                });
+
+            // per kernel type: average time of the threads,
+            // work of all threads (from the last run)
+            double gflop = 0, gbyte = 0;
+            for( int type = 0; type < 3; ++type ) {
+                double time = 0;
+                for( magma_int_t t = 0; t < p; ++t ) {
+                    time += counts[t].time[type] / p;
+                }
+                magma_roofline_print( type_names[type], size, peak, time,
+                                      p*counts[0].gflop[type], p*counts[0].gbyte[type] );
+                gflop += p*counts[0].gflop[type];
+                gbyte += p*counts[0].gbyte[type];
+            }
+            magma_roofline_print( "bulge chase (total)", size, peak, stats.median,
+                                  gflop, gbyte );
+            magma_bench_record( opts, "magma_zhbtype_bulge", N, N, nb, gflop, stats, -1 );
+
+            magma_free_cpu( hA     );
+            magma_free_cpu( hAband );
+            magma_free_cpu( hV     );
+            magma_free_cpu( hTAU   );
+            magma_free_cpu( hwork  );
+
+            // =================================================================
+            // secular equation: N roots, in parallel as in dlaex3.
+            // Flops are estimated: dlaed4 evaluates the secular function,
+            // 6 flops per term, about 4 times per root.
+            double *dlamda, *w, *delta, *d;
+            TESTING_CHECK( magma_dmalloc_cpu( &dlamda, N   ));
+            TESTING_CHECK( magma_dmalloc_cpu( &w,      N   ));
+            TESTING_CHECK( magma_dmalloc_cpu( &delta,  N*p ));
+            TESTING_CHECK( magma_dmalloc_cpu( &d,      N   ));
+            // distinct sorted poles, normalized weights
+            lapackf77_dlarnv( &ione, ISEED, &N, w );
+            double wnorm = 0;
+            for( magma_int_t j = 0; j < N; ++j ) {
+                dlamda[j] = j + 0.5*w[j];
+                w[j] = 0.1 + fabs( w[j] );
+                wnorm += w[j]*w[j];
+            }
+            wnorm = sqrt( wnorm );
+            for( magma_int_t j = 0; j < N; ++j ) {
+                w[j] /= wnorm;
+            }
+            double rho = 1;
+            stats = magma_bench( opts, NULL,
+                [&]{},
+                [&]{
+                    #pragma omp parallel for num_threads(p) schedule(static)
+                    for( magma_int_t t = 0; t < p; ++t ) {
+                        magma_int_t jb = magma_ceildiv( N, p );
+                        for( magma_int_t j = t*jb; j < min( (t+1)*jb, N ); ++j ) {
+                            magma_int_t tmpp = j+1, iinfo = 0;
+                            lapackf77_dlaed4( &N, &tmpp, dlamda, w, delta + t*N,
+                                              &rho, &d[j], &iinfo );
+                        }
+                    }
+                });
+            gflop = 4 * 6. * N * N / 1e9;
+            magma_roofline_print( "dlaed4 (est. flops)", size, peak, stats.median,
+                                  gflop, 0 );
+            magma_bench_record( opts, "dlaed4", N, N, 0, gflop, stats, -1 );
+
+            magma_free_cpu( dlamda );
+            magma_free_cpu( w      );
+            magma_free_cpu( delta  );
+            magma_free_cpu( d      );
+            fflush( stdout );
+        }
+
+        // =====================================================================
+        // scheduling overhead, per task: thread queue, with p threads;
+        // CPU queue, for throughput (submit all, then sync) and
+        // latency (submit and wait for each)
+        const magma_int_t ntasks = 10000;
+        magma_thread_queue tqueue;
+        double launch = magma_wtime();
+        tqueue.launch( p );
+        launch = magma_wtime() - launch;
+        double ttask = magma_wtime();
+        for( magma_int_t i = 0; i < ntasks; ++i ) {
+            tqueue.push_task( new empty_task() );
+        }
+        tqueue.sync();
+        ttask = (magma_wtime() - ttask) / ntasks;
+        tqueue.quit();
+
+        magma_cpu_queue_t cqueue;
+        magma_cpu_task_t task;
+        TESTING_CHECK( magma_cpu_queue_create( p, &cqueue ));
+        double tput = magma_wtime();
+        for( magma_int_t i = 0; i < ntasks; ++i ) {
+            TESTING_CHECK( magma_cpu_task_submit( cqueue, empty_func, NULL, 0, NULL, NULL ));
+        }
+        magma_cpu_queue_sync( cqueue );
+        tput = (magma_wtime() - tput) / ntasks;
+        double latency = magma_wtime();
+        for( magma_int_t i = 0; i < ntasks/10; ++i ) {
+            TESTING_CHECK( magma_cpu_task_submit( cqueue, empty_func, NULL, 0, NULL, &task ));
+            magma_cpu_task_wait( task );
+            magma_cpu_task_destroy( task );
+        }
+        latency = (magma_wtime() - latency) / (ntasks/10);
+        magma_cpu_queue_destroy( cqueue );
+
+        printf( "%% overhead: thread queue launch %.3f ms, %.2f us per task;"
+                " CPU queue %.2f us per task, %.2f us round trip\n",
+                1e3*launch, 1e6*ttask, 1e6*tput, 1e6*latency );
+
+        magma_set_lapack_numthreads( lapack_threads );
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return 0;
+}
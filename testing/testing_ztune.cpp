@@ -0,0 +1,180 @@
+/*
+    -- MAGMA (version 2.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date
+
+       @precisions normal z -> c d s
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma_v2.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+#define PRECISION_z
+
+#if defined(PRECISION_z)
+    #define PREC 'z'
+#elif defined(PRECISION_c)
+    #define PREC 'c'
+#elif defined(PRECISION_d)
+    #define PREC 'd'
+#else
+    #define PREC 's'
+#endif
+
+// routines tuned; params are the getters' names, e.g., "getrf_nb" for
+// magma_get_zgetrf_nb
+enum { TUNE_GETRF, TUNE_POTRF, TUNE_GEQRF, TUNE_HETRD, TUNE_NROUTINES };
+
+static const char* g_params[ TUNE_NROUTINES ] = {
+    "getrf_nb",
+    "potrf_nb",
+    "geqrf_nb",
+    #if defined(PRECISION_z) || defined(PRECISION_c)
+    "hetrd_nb",
+    #else
+    "sytrd_nb",
+    #endif
+};
+
+static const magma_int_t g_nbs[] = { 32, 64, 96, 128, 192, 256, 384, 512 };
+static const int g_nnbs = sizeof(g_nbs) / sizeof(g_nbs[0]);
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Tunes block sizes of zgetrf_gpu, zpotrf_gpu, zgeqrf2_gpu, and zhetrd_gpu
+      for the sizes given, and writes the tuning database to $MAGMA_TUNE_FILE,
+      or stdout if it is unset. For each size, each nb is set in the tuning
+      database, then the routine is timed; the fastest of niter runs counts.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_CHECK( magma_init() );
+    magma_print_environment();
+
+    real_Double_t   gflops, gpu_perf, gpu_time, best_time;
+    magmaDoubleComplex *h_A, *h_R, *h_work, *tau;
+    magmaDoubleComplex_ptr d_A;
+    double *diag, *offdiag;
+    magma_int_t N, n2, lda, ldda, lwork, info, nb, best_nb;
+    magma_int_t *ipiv;
+    int status = 0;
+
+    magma_opts opts;
+    opts.matrix = "rand_dominant";  // default, so potrf succeeds
+    opts.parse_opts( argc, argv );
+
+    const char* filename = getenv( "MAGMA_TUNE_FILE" );
+
+    printf("%% routine      N     nb   GPU Gflop/s (sec)\n");
+    printf("%%==========================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        N     = opts.nsize[itest];
+        lda   = N;
+        n2    = lda*N;
+        ldda  = magma_roundup( N, opts.align );  // multiple of 32 by default
+        lwork = N*g_nbs[ g_nnbs-1 ];
+
+        TESTING_CHECK( magma_zmalloc_cpu( &h_A,     n2 ));
+        TESTING_CHECK( magma_zmalloc_cpu( &tau,     N  ));
+        TESTING_CHECK( magma_dmalloc_cpu( &diag,    N  ));
+        TESTING_CHECK( magma_dmalloc_cpu( &offdiag, N  ));
+        TESTING_CHECK( magma_imalloc_cpu( &ipiv,    N  ));
+        TESTING_CHECK( magma_zmalloc_pinned( &h_R,    n2    ));
+        TESTING_CHECK( magma_zmalloc_pinned( &h_work, lwork ));
+        TESTING_CHECK( magma_zmalloc( &d_A, ldda*N ));
+
+        magma_generate_matrix( opts, N, N, h_A, lda );
+
+        for( int routine = 0; routine < TUNE_NROUTINES; ++routine ) {
+            switch (routine) {
+                case TUNE_GETRF: gflops = FLOPS_ZGETRF( N, N ) / 1e9; break;
+                case TUNE_POTRF: gflops = FLOPS_ZPOTRF( N    ) / 1e9; break;
+                case TUNE_GEQRF: gflops = FLOPS_ZGEQRF( N, N ) / 1e9; break;
+                default:         gflops = FLOPS_ZHETRD( N    ) / 1e9; break;
+            }
+            best_nb   = 0;
+            best_time = 0;
+            for( int inb = 0; inb < g_nnbs; ++inb ) {
+                nb = g_nbs[ inb ];
+                if ( nb > N && inb > 0 ) {
+                    break;
+                }
+                magma_tune_set( g_params[ routine ], PREC, N, N, nb );
+
+                gpu_time = 0;
+                for( int iter = 0; iter < opts.niter; ++iter ) {
+                    magma_zsetmatrix( N, N, h_A, lda, d_A, ldda, opts.queue );
+                    real_Double_t time = magma_wtime();
+                    switch (routine) {
+                        case TUNE_GETRF:
+                            magma_zgetrf_gpu( N, N, d_A, ldda, ipiv, &info );
+                            break;
+                        case TUNE_POTRF:
+                            magma_zpotrf_gpu( opts.uplo, N, d_A, ldda, &info );
+                            break;
+                        case TUNE_GEQRF:
+                            magma_zgeqrf2_gpu( N, N, d_A, ldda, tau, &info );
+                            break;
+                        default:
+                            magma_zhetrd_gpu( opts.uplo, N, d_A, ldda, diag, offdiag,
+                                              tau, h_R, lda, h_work, lwork, &info );
+                            break;
+                    }
+                    time = magma_wtime() - time;
+                    if (info != 0) {
+                        printf("%s returned error %lld: %s.\n",
+                               g_params[ routine ], (long long) info, magma_strerror( info ));
+                        status = 1;
+                    }
+                    if ( iter == 0 || time < gpu_time ) {
+                        gpu_time = time;
+                    }
+                }
+                gpu_perf = gflops / gpu_time;
+                printf("  %-10s %5lld  %5lld   %7.2f (%7.2f)\n",
+                       g_params[ routine ], (long long) N, (long long) nb,
+                       gpu_perf, gpu_time );
+                if ( best_nb == 0 || gpu_time < best_time ) {
+                    best_nb   = nb;
+                    best_time = gpu_time;
+                }
+            }
+            magma_tune_set( g_params[ routine ], PREC, N, N, best_nb );
+            printf("%% %-10s %5lld  best nb %lld\n",
+                   g_params[ routine ], (long long) N, (long long) best_nb );
+            fflush( stdout );
+        }
+
+        magma_free_cpu( h_A );
+        magma_free_cpu( tau );
+        magma_free_cpu( diag );
+        magma_free_cpu( offdiag );
+        magma_free_cpu( ipiv );
+        magma_free_pinned( h_R );
+        magma_free_pinned( h_work );
+        magma_free( d_A );
+        printf( "\n" );
+    }
+
+    if ( filename != NULL && filename[0] != '\0' ) {
+        printf( "%% writing tuning database to %s\n", filename );
+        TESTING_CHECK( magma_tune_save( filename ));
+    }
+    else {
+        TESTING_CHECK( magma_tune_save( NULL ));
+    }
+
+    opts.cleanup();
+    TESTING_CHECK( magma_finalize() );
+    return status;
+}
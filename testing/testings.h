@@ -172,6 +172,9 @@ public:
     // parse command line
     void parse_opts( int argc, char** argv );
     
+    // parse and remove the benchmark options, for testers with their own parser
+    void parse_bench_opts( int* argc, char** argv );
+    
     // set range, vl, vu, il, iu for eigen/singular value problems (gesvdx, syevdx, ...)
     void get_range( magma_int_t n, magma_range_t* range,
                     double* vl, double* vu,
@@ -198,6 +201,7 @@ public:
     // scalars
     magma_int_t device;
     magma_int_t cache;
+    magma_int_t flush;      // flush cache before timed runs; -1 until parsed
     magma_int_t align;
     magma_int_t nb;
     magma_int_t nrhs;
@@ -227,6 +231,17 @@ public:
     bool lapack;
     bool warmup;
     
+    // benchmark mode, see magma_bench; testers that use magma_bench set
+    // bench_supported before parse_opts, which rejects the benchmark
+    // options otherwise
+    bool        bench_supported;
+    bool        bench;
+    magma_int_t bench_warmup;
+    magma_int_t bench_reps;
+    std::string bench_output;  // JSON Lines, or CSV if it ends in .csv
+    std::string bind;          // CPU list the process is bound to, e.g., 0-15
+    std::string command;       // command line, for benchmark records
+    
     // lapack options
     magma_uplo_t    uplo;
     magma_trans_t   transA;
@@ -258,10 +273,97 @@ public:
     #elif defined(HAVE_HIP)
     hipblasHandle_t handle;
     #endif
+
+private:
+    // parse one benchmark option, see parse_bench_opts
+    bool parse_bench_arg( int argc, char** argv, int* i,
+                          const char** bench_arg, const char** flush_arg );
 };
 
 extern const char* g_platform_str;
 
+
+// -----------------------------------------------------------------------------
+// statistics of the timed runs of a benchmark, in seconds
+struct magma_bench_stats
+{
+    magma_int_t reps;
+    double      min;
+    double      max;
+    double      median;
+    double      mean;
+    double      stddev;
+};
+
+magma_bench_stats magma_bench_summarize( std::vector< double >& times );
+
+// appends a record of a benchmark to opts.bench_output, if set;
+// gflop is the operation count in Gflop; error < 0 if not checked
+void magma_bench_record(
+    magma_opts& opts, const char* routine,
+    magma_int_t m, magma_int_t n, magma_int_t k,
+    double gflop, const magma_bench_stats& stats, double error );
+
+/***************************************************************************//**
+    Times a routine consistently across testers. Calls setup() (untimed,
+    e.g., to copy the input matrix to the device), flushes the cache if
+    opts.flush, then times run(), syncing queue (if not NULL) before and
+    after. Without --bench, does this once; with --bench, does it
+    opts.bench_warmup times untimed, then opts.bench_reps times timed.
+    Example:
+    
+        magma_bench_stats t = magma_bench( opts, NULL,
+            [&]{ magma_zsetmatrix( M, N, h_A, lda, d_A, ldda, opts.queue ); },
+            [&]{ magma_zgetrf_gpu( M, N, d_A, ldda, ipiv, &info ); } );
+        gpu_time = t.median;
+        ...check results...
+        magma_bench_record( opts, "zgetrf_gpu", M, N, 0, gflops, t, error );
+*******************************************************************************/
+template< typename Setup, typename Run >
+magma_bench_stats magma_bench(
+    magma_opts& opts, magma_queue_t queue, Setup setup, Run run )
+{
+    magma_int_t warmup = (opts.bench ? opts.bench_warmup : 0);
+    magma_int_t reps   = (opts.bench ? opts.bench_reps   : 1);
+    std::vector< double > times;
+    for( magma_int_t i = 0; i < warmup + reps; ++i ) {
+        setup();
+        if ( opts.flush ) {
+            magma_flush_cache( opts.cache );
+        }
+        double time = (queue != NULL ? magma_sync_wtime( queue ) : magma_wtime());
+        run();
+        time = (queue != NULL ? magma_sync_wtime( queue ) : magma_wtime()) - time;
+        if ( i >= warmup ) {
+            times.push_back( time );
+        }
+    }
+    return magma_bench_summarize( times );
+}
+
+
+// -----------------------------------------------------------------------------
+// Roofline of the CPU, measured at a given number of threads: memory
+// bandwidth of a STREAM triad, and flop rate of a large dgemm.
+struct magma_roofline_peak
+{
+    magma_int_t nthreads;
+    double      stream;  // GB/s
+    double      gemm;    // Gflop/s
+};
+
+magma_roofline_peak magma_roofline_measure( magma_int_t nthreads );
+
+// 1, 2, 4, ..., up to and including max_threads
+std::vector< magma_int_t > magma_thread_counts( magma_int_t max_threads );
+
+// prints a kernel's achieved rates relative to the roofline;
+// gflop and gbyte are the kernel's work and memory traffic (0 if unknown)
+void magma_roofline_header();
+void magma_roofline_print(
+    const char* kernel, const char* size, const magma_roofline_peak& peak,
+    double time, double gflop, double gbyte );
+
 // -----------------------------------------------------------------------------
 template< typename FloatT >
 void magma_generate_matrix(